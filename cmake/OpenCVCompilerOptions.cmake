@@ -232,6 +232,33 @@ if(MSVC)
   endif()
 endif()
 
+# Instruction sets for the runtime-dispatched kernels (modules/core/src/simd_*.cpp).
+# Only those files are built with these flags, the choice is made on the target CPU.
+if(ENABLE_CPU_DISPATCH)
+  if(CMAKE_COMPILER_IS_GNUCXX AND NOT MINGW)
+    ocv_check_flag_support(CXX "-mavx2" _varname)
+    if(${_varname})
+      set(HAVE_AVX2_DISPATCH 1)
+      set(CPU_DISPATCH_AVX2_FLAGS "-mavx2")
+    endif()
+    # no floating-point contraction: the results must match the SSE2 code
+    ocv_check_flag_support(CXX "-mavx512f -mavx512bw -ffp-contract=off" _varname)
+    if(${_varname})
+      set(HAVE_AVX512_DISPATCH 1)
+      set(CPU_DISPATCH_AVX512_FLAGS "-mavx512f -mavx512bw -ffp-contract=off")
+    endif()
+  elseif(MSVC)
+    if(NOT MSVC_VERSION LESS 1800)
+      set(HAVE_AVX2_DISPATCH 1)
+      set(CPU_DISPATCH_AVX2_FLAGS "/arch:AVX2")
+    endif()
+    if(NOT MSVC_VERSION LESS 1911)
+      set(HAVE_AVX512_DISPATCH 1)
+      set(CPU_DISPATCH_AVX512_FLAGS "/arch:AVX512")
+    endif()
+  endif()
+endif()
+
 # Extra link libs if the user selects building static libs:
 if(NOT BUILD_SHARED_LIBS AND CMAKE_COMPILER_IS_GNUCXX AND NOT ANDROID)
   # Android does not need these settings because they are already set by toolchain file
@@ -111,3 +111,10 @@ if(MSVC AND NOT HAVE_TBB AND NOT HAVE_CSTRIPES AND NOT HAVE_OPENMP)
 else()
   set(HAVE_CONCURRENCY 0)
 endif()
+
+# --- pthreads-based parallel_for ---
+if(WITH_PTHREADS_PF AND HAVE_LIBPTHREAD AND NOT HAVE_TBB AND NOT HAVE_CSTRIPES AND NOT HAVE_OPENMP AND NOT HAVE_GCD AND NOT HAVE_CONCURRENCY)
+  set(HAVE_PTHREADS_PF 1)
+else()
+  set(HAVE_PTHREADS_PF 0)
+endif()
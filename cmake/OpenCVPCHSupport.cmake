@@ -192,7 +192,8 @@ MACRO(ADD_PRECOMPILED_HEADER_TO_TARGET _targetName _input _pch_output_to_use )
 
     GET_TARGET_PROPERTY(_sources ${_targetName} SOURCES)
     FOREACH(src ${_sources})
-      if(NOT "${src}" MATCHES "\\.mm$")
+      get_source_file_property(_skip "${src}" SKIP_PRECOMPILED_HEADERS)
+      if(NOT "${src}" MATCHES "\\.mm$" AND NOT _skip)
         get_source_file_property(_flags "${src}" COMPILE_FLAGS)
         if(_flags)
           set(_flags "${_flags} ${_target_cflags}")
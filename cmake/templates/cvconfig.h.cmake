@@ -175,6 +175,13 @@
 /* C= */
 #cmakedefine  HAVE_CSTRIPES
 
+/* PThreads-based parallel_for_ thread pool */
+#cmakedefine  HAVE_PTHREADS_PF
+
+/* AVX2/AVX-512 kernels built for the runtime dispatch */
+#cmakedefine  HAVE_AVX2_DISPATCH
+#cmakedefine  HAVE_AVX512_DISPATCH
+
 /* Eigen Matrix & Linear Algebra Library */
 #cmakedefine  HAVE_EIGEN
 
@@ -225,3 +232,6 @@
 
 /* Clp support */
 #cmakedefine HAVE_CLP
+
+/* Hot-path tracing and instrumentation */
+#cmakedefine HAVE_TRACE
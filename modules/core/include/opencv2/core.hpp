@@ -243,6 +243,16 @@ CV_EXPORTS_W void insertChannel(InputArray src, InputOutputArray dst, int coi);
 //! reverses the order of the rows, columns or both in a matrix
 CV_EXPORTS_W void flip(InputArray src, OutputArray dst, int flipCode);
 
+enum
+{
+    ROTATE_90_CLOCKWISE        = 0, // dst(i, j) = src(src.rows - 1 - j, i)
+    ROTATE_180                 = 1, // the same as flip(src, dst, -1)
+    ROTATE_90_COUNTERCLOCKWISE = 2  // dst(i, j) = src(j, src.cols - 1 - i)
+};
+
+//! rotates the matrix by 90, 180 or 270 degrees without an intermediate transposed copy
+CV_EXPORTS_W void rotate(InputArray src, OutputArray dst, int rotateCode);
+
 //! replicates the input matrix the specified number of times in the horizontal and/or vertical direction
 CV_EXPORTS_W void repeat(InputArray src, int ny, int nx, OutputArray dst);
 
@@ -376,7 +386,8 @@ enum
     SORT_EVERY_ROW    = 0,
     SORT_EVERY_COLUMN = 1,
     SORT_ASCENDING    = 0,
-    SORT_DESCENDING   = 16
+    SORT_DESCENDING   = 16,
+    SORT_STABLE       = 32  // sortIdx keeps the equal elements in their original order
 };
 
 //! sorts independently each matrix row or each matrix column
@@ -395,6 +406,10 @@ CV_EXPORTS_W double solvePoly(InputArray coeffs, OutputArray roots, int maxIters
 CV_EXPORTS_W bool eigen(InputArray src, OutputArray eigenvalues,
                         OutputArray eigenvectors = noArray());
 
+//! finds only the maxCount largest eigenvalues and the corresponding eigenvectors of a symmetric matrix
+CV_EXPORTS bool eigen(InputArray src, OutputArray eigenvalues,
+                      OutputArray eigenvectors, int maxCount);
+
 enum
 {
     COVAR_SCRAMBLED = 0,
@@ -454,6 +469,14 @@ CV_EXPORTS_W void mulSpectrums(InputArray a, InputArray b, OutputArray c,
 //! computes the minimal vector size vecsize1 >= vecsize so that the dft() of the vector of length vecsize1 can be computed efficiently
 CV_EXPORTS_W int getOptimalDFTSize(int vecsize);
 
+//! sets the maximum number of the DFT plans (factorization, twiddle factors and permutation table
+//! of a 1D transform) kept by dft() between the calls; 0 releases the cached plans and disables caching.
+//! Independently of the number, the cached plans take at most 4 MB
+CV_EXPORTS void setDFTPlanCacheSize(int maxPlans);
+
+//! returns the maximum number of the cached DFT plans (16 by default)
+CV_EXPORTS int getDFTPlanCacheSize();
+
 /*!
  k-Means flags
 */
@@ -478,9 +501,18 @@ CV_EXPORTS_W void randu(InputOutputArray dst, InputArray low, InputArray high);
 //! fills array with normally-distributed random numbers with the specified mean and the standard deviation
 CV_EXPORTS_W void randn(InputOutputArray dst, InputArray mean, InputArray stddev);
 
+//! fills array with uniformly-distributed random numbers using the counter-based generator; the result does not depend on the number of threads
+CV_EXPORTS void randu(InputOutputArray dst, InputArray low, InputArray high, RNG_Philox& rng);
+
+//! fills array with normally-distributed random numbers using the counter-based generator; the result does not depend on the number of threads
+CV_EXPORTS void randn(InputOutputArray dst, InputArray mean, InputArray stddev, RNG_Philox& rng);
+
 //! shuffles the input array elements
 CV_EXPORTS_W void randShuffle(InputOutputArray dst, double iterFactor = 1., RNG* rng = 0);
 
+//! shuffles the input array elements using the counter-based generator
+CV_EXPORTS void randShuffle(InputOutputArray dst, double iterFactor, RNG_Philox& rng);
+
 enum { FILLED  = -1,
        LINE_4  = 4,
        LINE_8  = 8,
@@ -586,6 +618,111 @@ CV_EXPORTS_W Size getTextSize(const String& text, int fontFace,
                             double fontScale, int thickness,
                             CV_OUT int* baseLine);
 
+/*!
+ Batch of drawing primitives
+
+ The primitives are recorded by the methods mirroring the respective drawing functions
+ and rendered at once by draw(). The image is split into horizontal bands that are rasterized
+ in parallel; within a band the primitives are drawn in the order they were added, and each
+ primitive is clipped by the whole image, so the result is the same as if the drawing functions
+ were called one by one. This is handy for the overlays consisting of thousands of boxes,
+ polylines and labels.
+*/
+class CV_EXPORTS DrawingBatch
+{
+public:
+    DrawingBatch();
+    //! adds the line segment (see cv::line)
+    void line(Point pt1, Point pt2, const Scalar& color,
+              int thickness = 1, int lineType = LINE_8, int shift = 0);
+    //! adds the rectangle outline or the solid rectangle covering rec (see cv::rectangle)
+    void rectangle(Rect rec, const Scalar& color,
+                   int thickness = 1, int lineType = LINE_8, int shift = 0);
+    //! adds the circle outline or the solid circle (see cv::circle)
+    void circle(Point center, int radius, const Scalar& color,
+                int thickness = 1, int lineType = LINE_8, int shift = 0);
+    //! adds the polygonal curve (see cv::polylines)
+    void polylines(InputArray pts, bool isClosed, const Scalar& color,
+                   int thickness = 1, int lineType = LINE_8, int shift = 0);
+    //! adds the filled polygon (see cv::fillPoly)
+    void fillPoly(InputArray pts, const Scalar& color, int lineType = LINE_8, int shift = 0);
+    //! adds the text string (see cv::putText)
+    void putText(const String& text, Point org, int fontFace, double fontScale, Scalar color,
+                 int thickness = 1, int lineType = LINE_8, bool bottomLeftOrigin = false);
+
+    //! removes all the primitives
+    void clear();
+    //! returns the number of primitives (each text stroke counts as a separate primitive)
+    size_t size() const;
+    /*!
+     renders the primitives into the image. When alpha < 1, the rendered primitives
+     are blended with the original image content: img = alpha*rendered + (1 - alpha)*img.
+    */
+    void draw(InputOutputArray img, double alpha = 1) const;
+
+protected:
+    struct Primitive
+    {
+        int kind, ofs, count, radius;
+        int thickness, lineType, shift;
+        bool closed;
+        Range rows;
+        Scalar color;
+    };
+
+    void addPrimitive(int kind, const Point* pts, int count, int radius, bool closed,
+                      const Scalar& color, int thickness, int lineType, int shift);
+    void drawRows(Mat& img, const Range& rows, const double* colors) const;
+
+    std::vector<Primitive> prims;
+    std::vector<Point> pts;
+
+    friend class DrawingBatchInvoker;
+};
+
+/*!
+ Pipeline of 8-bit point operations
+
+ Each operation added to the pipeline is composed with the previous ones into a single
+ 256-entry table per channel, so a chain of operations (e.g. a color grading stage consisting
+ of contrast, gamma and threshold steps) is applied to an 8-bit image with one LUT pass.
+ The result is the same as if the operations were applied one by one, with the intermediate
+ results stored as 8-bit images. The channel argument selects the channel the operation applies to;
+ -1 means all the channels.
+*/
+class CV_EXPORTS LUTPipeline
+{
+public:
+    //! the threshold() modes; the values are the same as of the imgproc THRESH_* constants
+    enum { THRESH_BINARY = 0, THRESH_BINARY_INV = 1, THRESH_TRUNC = 2, THRESH_TOZERO = 3, THRESH_TOZERO_INV = 4 };
+
+    //! creates the identity pipeline for images with the specified number of channels
+    LUTPipeline(int channels = 1);
+
+    //! dst = saturate_cast<uchar>(255*pow(src/255, gamma))
+    LUTPipeline& gamma(double gamma, int channel = -1);
+    //! dst = saturate_cast<uchar>(src*alpha + beta), as in Mat::convertTo
+    LUTPipeline& contrast(double alpha, double beta = 0, int channel = -1);
+    //! dst = saturate_cast<uchar>(|src*alpha + beta|), as in convertScaleAbs
+    LUTPipeline& scaleAbs(double alpha, double beta = 0, int channel = -1);
+    //! the 8-bit thresholding, as in threshold(); type is one of LUTPipeline::THRESH_BINARY ... THRESH_TOZERO_INV
+    LUTPipeline& threshold(double thresh, double maxval, int type, int channel = -1);
+    //! an arbitrary 8-bit lookup table with 1 or channels() channels
+    LUTPipeline& lut(InputArray lut);
+
+    //! resets the pipeline to the identity transformation
+    void reset();
+    //! returns the number of channels
+    int channels() const;
+    //! returns the composed 1x256 table of type CV_8UC(channels())
+    const Mat& table() const;
+    //! applies the pipeline to the 8-bit image (equivalent to LUT(src, table(), dst))
+    void apply(InputArray src, OutputArray dst) const;
+
+protected:
+    Mat tab;
+};
+
 /*!
     Principal Component Analysis
 
@@ -922,6 +1059,63 @@ private:
     int mti;
 };
 
+/*!
+   Counter-based Random Number Generator
+
+   The class implements the Philox4x32-10 generator. Each 32-bit output is a function
+   of (key, stream, counter) only, so the generator can be moved to any position in O(1)
+   and different streams of the same key can be given to different threads.
+   RNG_Philox::fill() runs in parallel and gives the same result for any number of threads.
+*/
+class CV_EXPORTS RNG_Philox
+{
+public:
+    RNG_Philox();
+    RNG_Philox(uint64 seed, uint64 stream = 0);
+    //! resets the generator to the beginning of the specified stream
+    void seed(uint64 seed, uint64 stream = 0);
+    //! advances the generator by n 32-bit outputs
+    void skip(uint64 n);
+    //! moves the generator to the specified 32-bit output within the current stream
+    void setCounter(uint64 counter);
+    //! returns the index of the next 32-bit output within the stream
+    uint64 getCounter() const;
+    //! returns a generator with the same key, positioned at the beginning of another (independent) stream
+    RNG_Philox split(uint64 stream) const;
+
+    //! returns the next 32-bit unsigned integer random number
+    unsigned next();
+
+    operator int();
+    operator unsigned();
+    operator float();
+    operator double();
+
+    //! returns a random integer sampled uniformly from [0, N).
+    unsigned operator ()(unsigned N);
+    unsigned operator ()();
+
+    //! returns uniformly distributed integer random number from [a,b) range
+    int uniform(int a, int b);
+    //! returns uniformly distributed floating-point random number from [a,b) range
+    float uniform(float a, float b);
+    //! returns uniformly distributed double-precision floating-point random number from [a,b) range
+    double uniform(double a, double b);
+    //! returns Gaussian random variate with mean zero.
+    double gaussian(double sigma);
+    //! fills the array with random numbers; distType is RNG::UNIFORM or RNG::NORMAL
+    void fill( InputOutputArray mat, int distType, InputArray a, InputArray b, bool saturateRange = false );
+
+    uint64 key; //!< the seed
+    uint64 stream; //!< the stream (subsequence) index
+
+private:
+    // the index of the next 32-bit output within the stream; buf holds the block it belongs to
+    // when it is not a multiple of 4, so it is only changed by the methods that refresh buf
+    uint64 counter;
+    unsigned buf[4];
+};
+
 
 
 /////////////////////////////// Formatted output of cv::Mat ///////////////////////////
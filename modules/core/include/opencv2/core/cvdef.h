@@ -109,6 +109,9 @@
 #define CV_CPU_POPCNT  8
 #define CV_CPU_AVX    10
 #define CV_CPU_NEON   11
+#define CV_CPU_AVX2   12
+#define CV_CPU_AVX_512F  13
+#define CV_CPU_AVX_512BW 14
 #define CV_HARDWARE_MAX_FEATURE 255
 
 // do not include SSE/AVX/NEON headers for NVCC compiler
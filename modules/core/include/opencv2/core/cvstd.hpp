@@ -124,6 +124,30 @@ CV_EXPORTS void* fastMalloc(size_t bufSize);
 */
 CV_EXPORTS void fastFree(void* ptr);
 
+/*!
+  Allocates memory from the scratch arena of the calling thread
+
+  The arena works as a stack, the blocks are expected to be released in the reverse order.
+  The memory of a block released out of order is reclaimed when all the blocks of the thread
+  are released. Once the arena has grown to the size needed by the processing, it does not call
+  the system allocator anymore. Use cv::ScratchBuffer rather than calling this function directly.
+
+  \param bufSize buffer size in bytes
+  \return the allocated memory buffer, aligned the same way as the cv::fastMalloc() result.
+*/
+CV_EXPORTS void* scratchMalloc(size_t bufSize);
+
+/*!
+  Releases the memory allocated with cv::scratchMalloc in the same thread
+
+  When ptr==NULL, the function has no effect.
+*/
+CV_EXPORTS void scratchFree(void* ptr);
+
+//! returns the number of cv::fastMalloc calls made by all the threads so far; lets the tests check
+//! that the warmed up code does not allocate memory anymore
+CV_EXPORTS int getFastMallocCount();
+
 /*!
   The STL-compilant memory Allocator based on cv::fastMalloc() and cv::fastFree()
 */
@@ -208,6 +208,58 @@ public:
 
 
 
+/*!
+   Caching allocator for short-lived matrices
+
+   Freed buffers are kept in per-thread free lists, one per size class (8 classes per
+   power of two), and are reused by the subsequent allocations of the same size class
+   without going to the system allocator. The total amount of cached memory is bounded
+   by the cache limit; when a freed block does not fit, the blocks cached the longest
+   in the shared depot are released first and then the freed block itself.
+
+   The allocator can be assigned to the particular matrices before create() is called
+   or made the default one for all the matrices with Mat::setDefaultAllocator().
+*/
+class CV_EXPORTS PoolMatAllocator : public MatAllocator
+{
+public:
+    struct CV_EXPORTS Stats
+    {
+        Stats();
+        //! the number of allocations served from the cache
+        size_t hits;
+        //! the number of allocations that required a new block
+        size_t misses;
+        //! the amount of memory currently kept in the cache, in bytes; every block is counted
+        //! in whole kilobytes, the same way as against the cache limit
+        size_t cachedBytes;
+        //! the amount of memory released by the trim policy, in bytes
+        size_t trimmedBytes;
+    };
+
+    //! returns the process-wide instance of the allocator
+    static PoolMatAllocator* getInstance();
+
+    void allocate(int dims, const int* sizes, int type, int*& refcount,
+                  uchar*& datastart, uchar*& data, size_t* step);
+    void deallocate(int* refcount, uchar* datastart, uchar* data);
+
+    //! sets the upper bound of the cached memory, in bytes; 0 disables caching.
+    // the blocks already cached by the other threads leave the cache as they get reused
+    void setCacheLimit(size_t bytes);
+    size_t getCacheLimit() const;
+    //! releases the blocks cached by the calling thread and the shared depot
+    void trim();
+    //! returns the statistics accumulated by all the threads
+    Stats getStats() const;
+    void resetStats();
+
+protected:
+    PoolMatAllocator();
+};
+
+
+
 //////////////////////////////// MatCommaInitializer //////////////////////////////////
 
 /*!
@@ -586,6 +638,11 @@ public:
 
     //! deallocates the matrix data
     void deallocate();
+
+    //! returns the allocator used by create() when the matrix has no custom allocator (NULL means fastMalloc)
+    static MatAllocator* getDefaultAllocator();
+    //! sets the allocator used by create() when the matrix has no custom allocator
+    static void setDefaultAllocator(MatAllocator* allocator);
     //! internal use function; properly re-allocates _size, _step arrays
     void copySize(const Mat& m);
 
@@ -1105,8 +1162,12 @@ public:
         size_t nodeSize;
         size_t nodeCount;
         size_t freeList;
+        size_t deletedCount;
         std::vector<uchar> pool;
+        //! open-addressing hash table: node offsets in the pool, 0 for the empty slots
         std::vector<size_t> hashtab;
+        //! per-slot 8-bit tags, probed 16 at a time (0 - empty, 1 - deleted, >= 0x80 - occupied)
+        std::vector<uchar> hashtags;
         int size[MAX_DIM];
     };
 
@@ -1115,7 +1176,7 @@ public:
     {
         //! hash value
         size_t hashval;
-        //! index of the next node in the same hash table entry
+        //! index of the next node in the free list
         size_t next;
         //! index of the matrix element
         int idx[MAX_DIM];
@@ -1291,6 +1352,20 @@ public:
     //! returns pointer to the specified element (nD case)
     template<typename _Tp> const _Tp* find(const int* idx, size_t* hashval=0) const;
 
+    /*!
+     batch version of ptr(): looks up count elements, which indices are stored contiguously
+     in idx (count*dims() integers), and writes the element pointers to ptrs.
+     When createMissing=true, the missing elements are inserted and the storage is reserved
+     in advance, so all the returned pointers stay valid until the next insertion.
+    */
+    void ptr(const int* idx, int count, uchar** ptrs, bool createMissing);
+    /*!
+     adds values to the elements with the specified indices (count*dims() integers), creating the missing
+     elements. values contains count*channels() numbers of the matrix depth; if it is NULL, every
+     channel of the referenced elements is incremented by 1 (e.g. for histogram computation).
+    */
+    void accumulate(const int* idx, const void* values, int count);
+
     //! erases the specified element (2D case)
     void erase(int i0, int i1, size_t* hashval=0);
     //! erases the specified element (3D case)
@@ -1333,7 +1408,7 @@ public:
     const Node* node(size_t nidx) const;
 
     uchar* newNode(const int* idx, size_t hashval);
-    void removeNode(size_t hidx, size_t nidx, size_t previdx);
+    void removeNode(size_t hidx, size_t nidx);
     void resizeHashTab(size_t newsize);
 
     int flags;
@@ -1970,26 +2045,56 @@ CV_EXPORTS MatExpr operator / (const MatExpr& e1, const MatExpr& e2);
 CV_EXPORTS MatExpr operator < (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator < (const Mat& a, double s);
 CV_EXPORTS MatExpr operator < (double s, const Mat& a);
+CV_EXPORTS MatExpr operator < (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator < (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator < (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator < (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator < (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator <= (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator <= (const Mat& a, double s);
 CV_EXPORTS MatExpr operator <= (double s, const Mat& a);
+CV_EXPORTS MatExpr operator <= (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator <= (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator <= (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator <= (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator <= (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator == (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator == (const Mat& a, double s);
 CV_EXPORTS MatExpr operator == (double s, const Mat& a);
+CV_EXPORTS MatExpr operator == (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator == (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator == (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator == (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator == (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator != (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator != (const Mat& a, double s);
 CV_EXPORTS MatExpr operator != (double s, const Mat& a);
+CV_EXPORTS MatExpr operator != (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator != (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator != (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator != (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator != (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator >= (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator >= (const Mat& a, double s);
 CV_EXPORTS MatExpr operator >= (double s, const Mat& a);
+CV_EXPORTS MatExpr operator >= (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator >= (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator >= (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator >= (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator >= (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator > (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator > (const Mat& a, double s);
 CV_EXPORTS MatExpr operator > (double s, const Mat& a);
+CV_EXPORTS MatExpr operator > (const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr operator > (const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr operator > (const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr operator > (const MatExpr& e, double s);
+CV_EXPORTS MatExpr operator > (double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr operator & (const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr operator & (const Mat& a, const Scalar& s);
@@ -2008,10 +2113,20 @@ CV_EXPORTS MatExpr operator ~(const Mat& m);
 CV_EXPORTS MatExpr min(const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr min(const Mat& a, double s);
 CV_EXPORTS MatExpr min(double s, const Mat& a);
+CV_EXPORTS MatExpr min(const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr min(const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr min(const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr min(const MatExpr& e, double s);
+CV_EXPORTS MatExpr min(double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr max(const Mat& a, const Mat& b);
 CV_EXPORTS MatExpr max(const Mat& a, double s);
 CV_EXPORTS MatExpr max(double s, const Mat& a);
+CV_EXPORTS MatExpr max(const MatExpr& e, const Mat& m);
+CV_EXPORTS MatExpr max(const Mat& m, const MatExpr& e);
+CV_EXPORTS MatExpr max(const MatExpr& e1, const MatExpr& e2);
+CV_EXPORTS MatExpr max(const MatExpr& e, double s);
+CV_EXPORTS MatExpr max(double s, const MatExpr& e);
 
 CV_EXPORTS MatExpr abs(const Mat& m);
 CV_EXPORTS MatExpr abs(const MatExpr& e);
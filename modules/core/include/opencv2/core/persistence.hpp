@@ -158,6 +158,13 @@ class CV_EXPORTS FileNodeIterator;
  for(int k = 0; k < 8; k++, ++it)
     lbp_val |= ((int)*it) << k;
  \endcode
+
+ Besides XML and YAML, the storage can be written in a binary format (FileStorage::FORMAT_BINARY
+ must be passed to the constructor explicitly, the file extension does not matter). It is read back with
+ the same FileNode/FileNodeIterator API, the format is recognized by the file signature. The binary files
+ are memory-mapped when opened for reading and the matrices stored there are not copied:
+ the Mat read from such a storage references the mapped pages directly (copy-on-write, shared between the
+ processes mapping the same file) and keeps them alive after the storage is released.
 */
 class CV_EXPORTS_W FileStorage
 {
@@ -172,7 +179,8 @@ public:
         FORMAT_MASK = (7<<3),
         FORMAT_AUTO = 0,
         FORMAT_XML  = (1<<3),
-        FORMAT_YAML = (2<<3)
+        FORMAT_YAML = (2<<3),
+        FORMAT_BINARY = (3<<3)
     };
     enum
     {
@@ -181,6 +189,16 @@ public:
         NAME_EXPECTED  = 2,
         INSIDE_MAP     = 4
     };
+
+    //! the receiver of the data written to the storage opened with FileStorage::open(sink, ...)
+    class CV_EXPORTS Sink
+    {
+    public:
+        virtual ~Sink();
+        //! receives the next chunk of the output
+        virtual void write(const char* data, size_t len) = 0;
+    };
+
     //! the default constructor
     CV_WRAP FileStorage();
     //! the full constructor that opens file storage for reading or writing
@@ -192,6 +210,14 @@ public:
 
     //! opens file storage for reading or writing. The previous storage is closed with release()
     CV_WRAP virtual bool open(const String& filename, int flags, const String& encoding=String());
+    /*!
+     opens file storage for writing to the sink. The output is accumulated in memory and passed to the sink
+     when a top-level collection has been written completely or when more than bufferSize bytes are accumulated.
+     The format is determined by the flags or by the name, as with FileStorage::MEMORY;
+     the name with ".gz" extension (e.g. "data.yml.gz") turns on gzip compression of the output.
+    */
+    bool open(const Ptr<Sink>& sink, const String& name, int flags=WRITE,
+              size_t bufferSize=1<<16, const String& encoding=String());
     //! returns true if the object is associated with currently opened file.
     CV_WRAP virtual bool isOpened() const;
     //! closes the file and releases all the memory buffers
@@ -220,6 +246,7 @@ public:
     //! returns the normalized object name for the specified file name
     static String getDefaultObjectName(const String& filename);
 
+    Ptr<Sink> sink; //!< the receiver of the output, if any
     Ptr<CvFileStorage> fs; //!< the underlying C FileStorage structure
     String elname; //!< the currently written element
     std::vector<char> structs; //!< the stack of written structures
@@ -363,6 +390,9 @@ public:
     FileNodeIterator& readRaw( const String& fmt, uchar* vec,
                                size_t maxCount=(size_t)INT_MAX );
 
+    //! returns the element of a raw array that has not been expanded into the nodes yet (binary storages)
+    FileNode blobElem() const;
+
     struct SeqReader
     {
       int          header_size;
@@ -808,8 +838,8 @@ inline FileNode::operator String() const { String value; read(*this, value, valu
 inline FileNodeIterator FileNode::begin() const { return FileNodeIterator(fs, node); }
 inline FileNodeIterator FileNode::end() const   { return FileNodeIterator(fs, node, size()); }
 inline void FileNode::readRaw( const String& fmt, uchar* vec, size_t len ) const { begin().readRaw( fmt, vec, len ); }
-inline FileNode FileNodeIterator::operator *() const  { return FileNode(fs, (const CvFileNode*)reader.ptr); }
-inline FileNode FileNodeIterator::operator ->() const { return FileNode(fs, (const CvFileNode*)reader.ptr); }
+inline FileNode FileNodeIterator::operator *() const  { return reader.seq && !reader.block ? blobElem() : FileNode(fs, (const CvFileNode*)reader.ptr); }
+inline FileNode FileNodeIterator::operator ->() const { return reader.seq && !reader.block ? blobElem() : FileNode(fs, (const CvFileNode*)reader.ptr); }
 inline String::String(const FileNode& fn): cstr_(0), len_(0) { read(fn, *this, *this); }
 
 } // cv
@@ -195,6 +195,22 @@ namespace cv
 CV_EXPORTS void scalarToRawData(const cv::Scalar& s, void* buf, int type, int unroll_to = 0);
 }
 
+/* the instrumentation of the library code, see cv::setTraceEnabled() */
+#ifdef HAVE_TRACE
+#  include "opencv2/core/utility.hpp"
+#  define CV_TRACE_REGION(name) ::cv::TraceRegion CVAUX_CONCAT(__cv_trace_region_, __LINE__)(name)
+#  ifdef __GNUC__
+#    define CV_TRACE_FUNCTION() CV_TRACE_REGION(__func__)
+#  else
+#    define CV_TRACE_FUNCTION() CV_TRACE_REGION(__FUNCTION__)
+#  endif
+#  define CV_TRACE_COUNTER(name, value) ::cv::traceCounter(name, (int64)(value))
+#else
+#  define CV_TRACE_REGION(name)
+#  define CV_TRACE_FUNCTION()
+#  define CV_TRACE_COUNTER(name, value)
+#endif
+
 
 /****************************************************************************************\
 *                     Structures and macros for integration with IPP                     *
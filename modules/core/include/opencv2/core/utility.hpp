@@ -120,6 +120,53 @@ protected:
     _Tp buf[fixed_size];
 };
 
+/*!
+ Scratch Buffer Class
+
+ The class is used for large temporary buffers (rows, tiles, cost arrays) in the processing
+ functions. The memory is taken from the scratch arena of the calling thread (see cv::scratchMalloc)
+ instead of the heap, and it is given back in the destructor. Since the arena is a stack, the buffers
+ should be local variables, then they are released in the reverse order of creation.
+ When the processing function returns, the arena is empty again, and the next call with the same
+ data size is served without calling the system allocator.
+
+ Unlike AutoBuffer, the elements are not initialized, so _Tp must be a POD type.
+*/
+template<typename _Tp> class ScratchBuffer
+{
+public:
+    typedef _Tp value_type;
+
+    //! the default contructor
+    ScratchBuffer();
+    //! constructor taking the real buffer size
+    ScratchBuffer(size_t _size);
+
+    //! destructor. calls deallocate()
+    ~ScratchBuffer();
+
+    //! allocates the new buffer of size _size, the previous content is lost
+    void allocate(size_t _size);
+    //! gives the buffer back to the arena
+    void deallocate();
+    //! returns the current buffer size
+    size_t size() const;
+    //! returns pointer to the buffer
+    operator _Tp* ();
+    //! returns read-only pointer to the buffer
+    operator const _Tp* () const;
+
+protected:
+    //! pointer to the buffer
+    _Tp* ptr;
+    //! size of the buffer
+    size_t sz;
+
+private:
+    ScratchBuffer(const ScratchBuffer&);
+    ScratchBuffer& operator = (const ScratchBuffer&);
+};
+
 //! Sets/resets the break-on-error mode.
 
 /*!
@@ -204,6 +251,9 @@ CV_EXPORTS_W int64 getCPUTickCount();
   - CV_CPU_SSE4_2 - SSE 4.2
   - CV_CPU_POPCNT - POPCOUNT
   - CV_CPU_AVX - AVX
+  - CV_CPU_AVX2 - AVX 2
+  - CV_CPU_AVX_512F - AVX-512 Foundation
+  - CV_CPU_AVX_512BW - AVX-512 Byte and Word instructions
 
   \note {Note that the function output is not static. Once you called cv::useOptimized(false),
   most of the hardware acceleration is disabled and thus the function will returns false,
@@ -296,6 +346,59 @@ protected:
     Mutex* mutex;
 };
 
+/////////////////////////////////////// Tracing //////////////////////////////////////
+
+/*!
+  Hot-path tracing of the library internals
+
+  When OpenCV is built with ENABLE_INSTRUMENTATION, the major processing functions, the
+  parallel_for_ stripes and the memory allocations record timed regions and counters into
+  per-thread buffers. The collection is off until cv::setTraceEnabled(true) is called or
+  the OPENCV_TRACE environment variable is set to a non-zero value; if OPENCV_TRACE_FILE
+  is set, the collection is enabled as well and the trace is written there at exit.
+  In the regular build the instrumentation compiles to nothing, but the functions below
+  still collect the regions and counters recorded by the user code.
+*/
+enum { TRACE_FORMAT_AUTO = 0, TRACE_FORMAT_CHROME = 1, TRACE_FORMAT_FLAT = 2 };
+
+//! returns true if the library has been built with the instrumentation
+CV_EXPORTS bool haveTraceSupport();
+
+//! starts or stops collecting the trace events
+CV_EXPORTS void setTraceEnabled(bool enabled);
+
+//! returns true if the trace events are being collected
+CV_EXPORTS bool traceEnabled();
+
+//! discards all the collected events
+CV_EXPORTS void resetTrace();
+
+/*!
+  Writes the collected events to a file
+
+  TRACE_FORMAT_CHROME produces the JSON accepted by chrome://tracing, TRACE_FORMAT_FLAT
+  a text table with the number of calls and the total, average and maximum time of every
+  region and the sum of every counter. TRACE_FORMAT_AUTO selects the former for *.json
+  files. Returns false if the file can not be written. The other threads may keep
+  recording events meanwhile.
+*/
+CV_EXPORTS bool writeTrace(const String& filename, int format = TRACE_FORMAT_AUTO);
+
+//! the timed region; the region name must be a string that outlives the trace
+class CV_EXPORTS TraceRegion
+{
+public:
+    explicit TraceRegion(const char* name);
+    ~TraceRegion();
+
+protected:
+    const char* name;
+    int64 start;
+};
+
+//! records the current value of a counter, e.g. a number of bytes or iterations
+CV_EXPORTS void traceCounter(const char* name, int64 value);
+
 // The CommandLineParser class is designed for command line arguments parsing
 
 class CV_EXPORTS CommandLineParser
@@ -447,6 +550,63 @@ template<typename _Tp, size_t fixed_size> inline
 AutoBuffer<_Tp, fixed_size>::operator const _Tp* () const
 { return ptr; }
 
+/////////////////////////////// ScratchBuffer implementation ////////////////////////////////////////
+
+template<typename _Tp> inline
+ScratchBuffer<_Tp>::ScratchBuffer()
+{
+    ptr = 0;
+    sz = 0;
+}
+
+template<typename _Tp> inline
+ScratchBuffer<_Tp>::ScratchBuffer(size_t _size)
+{
+    ptr = 0;
+    sz = 0;
+    allocate(_size);
+}
+
+template<typename _Tp> inline
+ScratchBuffer<_Tp>::~ScratchBuffer()
+{ deallocate(); }
+
+template<typename _Tp> inline void
+ScratchBuffer<_Tp>::allocate(size_t _size)
+{
+    if(_size <= sz)
+    {
+        sz = _size;
+        return;
+    }
+    deallocate();
+    ptr = (_Tp*)scratchMalloc(_size*sizeof(_Tp));
+    sz = _size;
+}
+
+template<typename _Tp> inline void
+ScratchBuffer<_Tp>::deallocate()
+{
+    if( ptr )
+    {
+        scratchFree(ptr);
+        ptr = 0;
+        sz = 0;
+    }
+}
+
+template<typename _Tp> inline size_t
+ScratchBuffer<_Tp>::size() const
+{ return sz; }
+
+template<typename _Tp> inline
+ScratchBuffer<_Tp>::operator _Tp* ()
+{ return ptr; }
+
+template<typename _Tp> inline
+ScratchBuffer<_Tp>::operator const _Tp* () const
+{ return ptr; }
+
 #ifndef OPENCV_NOSTL
 template<> inline std::string CommandLineParser::get<std::string>(int index, bool space_delete) const
 {
@@ -24,3 +24,33 @@ PERF_TEST_P(Size_MatType, dft, TEST_MATS_DFT)
 
     SANITY_CHECK(dst, 1e-5);
 }
+
+typedef tr1::tuple<Size, MatType, bool> Size_MatType_WarmPlan_t;
+typedef TestBaseWithParam<Size_MatType_WarmPlan_t> Size_MatType_WarmPlan;
+
+PERF_TEST_P(Size_MatType_WarmPlan, dft_plan,
+            testing::Combine(
+                testing::Values(Size(256, 1), Size(1024, 1), Size(4096, 1), Size(64, 64), sz1080p),
+                testing::Values(CV_32FC1, CV_32FC2, CV_64FC2),
+                testing::Bool()
+                ))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    bool warm = get<2>(GetParam());
+
+    Mat src(sz, type);
+    Mat dst(sz, type);
+
+    declare.in(src, WARMUP_RNG).out(dst).time(60);
+
+    // with the plan cache disabled every call builds the twiddle factors and the permutation table
+    int prevCacheSize = getDFTPlanCacheSize();
+    setDFTPlanCacheSize(warm ? std::max(prevCacheSize, 16) : 0);
+
+    TEST_CYCLE() dft(src, dst);
+
+    setDFTPlanCacheSize(prevCacheSize);
+
+    SANITY_CHECK(dst, 1e-5, ERROR_RELATIVE);
+}
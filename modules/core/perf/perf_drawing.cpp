@@ -0,0 +1,79 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+typedef std::tr1::tuple<Size, int, bool> Size_LineType_Batched_t;
+typedef perf::TestBaseWithParam<Size_LineType_Batched_t> Size_LineType_Batched;
+
+// annotation overlay: labelled boxes, tracks and a few filled markers
+PERF_TEST_P( Size_LineType_Batched, drawOverlay,
+             testing::Combine
+             (
+                 testing::Values(sz1080p, Size(3840, 2160)),
+                 testing::Values((int)LINE_8, (int)LINE_AA),
+                 testing::Bool()
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int lineType = get<1>(GetParam());
+    bool batched = get<2>(GetParam());
+    const int nboxes = 2000;
+
+    Mat img(sz, CV_8UC3);
+    declare.in(img, WARMUP_RNG).out(img);
+
+    RNG rng(12345);
+    vector<Rect> boxes(nboxes);
+    vector<vector<Point> > tracks(nboxes/4);
+    for( int i = 0; i < nboxes; i++ )
+        boxes[i] = Rect(rng.uniform(0, sz.width - 50), rng.uniform(0, sz.height - 50),
+                        rng.uniform(10, 200), rng.uniform(10, 200));
+    for( size_t i = 0; i < tracks.size(); i++ )
+    {
+        Point p = boxes[i].tl();
+        for( int j = 0; j < 10; j++ )
+            tracks[i].push_back(p += Point(rng.uniform(-20, 20), rng.uniform(-20, 20)));
+    }
+
+    DrawingBatch batch;
+    TEST_CYCLE()
+    {
+        for( int i = 0; i < nboxes; i++ )
+        {
+            Scalar color(i*7 % 256, i*13 % 256, i*23 % 256);
+            if( batched )
+            {
+                batch.rectangle(boxes[i], color, 2, lineType);
+                batch.putText("obj", boxes[i].tl(), FONT_HERSHEY_SIMPLEX, 0.5, color, 1, lineType);
+                if( i % 10 == 0 )
+                    batch.circle(boxes[i].br(), 5, color, -1, lineType);
+            }
+            else
+            {
+                rectangle(img, boxes[i], color, 2, lineType);
+                putText(img, "obj", boxes[i].tl(), FONT_HERSHEY_SIMPLEX, 0.5, color, 1, lineType);
+                if( i % 10 == 0 )
+                    circle(img, boxes[i].br(), 5, color, -1, lineType);
+            }
+        }
+        for( size_t i = 0; i < tracks.size(); i++ )
+        {
+            if( batched )
+                batch.polylines(tracks[i], false, Scalar(0, 255, 0), 1, lineType);
+            else
+                polylines(img, tracks[i], false, Scalar(0, 255, 0), 1, lineType);
+        }
+        if( batched )
+        {
+            batch.draw(img);
+            batch.clear();
+        }
+    }
+
+    SANITY_CHECK(img, 1);
+}
@@ -0,0 +1,58 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+CV_FLAGS(GemmFlag, 0, GEMM_1_T, GEMM_2_T)
+
+typedef tr1::tuple<MatType, int, GemmFlag> MatType_Length_Flags_t;
+typedef TestBaseWithParam<MatType_Length_Flags_t> MatType_Length_Flags;
+
+PERF_TEST_P( MatType_Length_Flags, gemm,
+             testing::Combine(
+                 testing::Values( CV_32FC1, CV_64FC1 ),
+                 testing::Values( 16, 64, 256, 1024, 4096 ),
+                 testing::Values( 0, (int)GEMM_1_T, (int)GEMM_2_T )
+                 ))
+{
+    int type = get<0>(GetParam());
+    int size = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+    Mat a(size, size, type), b(size, size, type), c(size, size, type), dst(size, size, type);
+
+    declare.in(a, b, c, WARMUP_RNG).out(dst);
+    declare.time(size >= 1024 ? 600 : 100);
+
+    TEST_CYCLE() gemm(a, b, 1.0, c, 0.5, dst, flags);
+
+    SANITY_CHECK(dst, size*1e-4, ERROR_RELATIVE);
+}
+
+// the reference blocked implementation; 4096 is left out since a single run takes minutes
+PERF_TEST_P( MatType_Length_Flags, gemm_reference,
+             testing::Combine(
+                 testing::Values( CV_32FC1, CV_64FC1 ),
+                 testing::Values( 16, 64, 256, 1024 ),
+                 testing::Values( 0, (int)GEMM_1_T, (int)GEMM_2_T )
+                 ))
+{
+    int type = get<0>(GetParam());
+    int size = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+    Mat a(size, size, type), b(size, size, type), c(size, size, type), dst(size, size, type);
+
+    declare.in(a, b, c, WARMUP_RNG).out(dst);
+    declare.time(size >= 1024 ? 600 : 100);
+
+    bool prevOptimized = useOptimized();
+    setUseOptimized(false);
+
+    TEST_CYCLE() gemm(a, b, 1.0, c, 0.5, dst, flags);
+
+    setUseOptimized(prevOptimized);
+
+    SANITY_CHECK(dst, size*1e-4, ERROR_RELATIVE);
+}
@@ -0,0 +1,73 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+typedef std::tr1::tuple<int, MatType> N_MatType_t;
+typedef perf::TestBaseWithParam<N_MatType_t> N_MatType;
+
+PERF_TEST_P( N_MatType, eigen,
+             testing::Combine
+             (
+                 testing::Values(16, 64, 256, 512),
+                 testing::Values(CV_32FC1, CV_64FC1)
+             )
+           )
+{
+    int n = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat a(n, n, type), src, evals, evects;
+    declare.in(a, WARMUP_RNG);
+    mulTransposed(a, src, true);
+    if( n >= 256 )
+        declare.time(60);
+
+    TEST_CYCLE() eigen(src, evals, evects);
+
+    SANITY_CHECK(evals, 1e-3, ERROR_RELATIVE);
+}
+
+PERF_TEST_P( N_MatType, eigen_top16,
+             testing::Combine
+             (
+                 testing::Values(64, 256, 512),
+                 testing::Values(CV_32FC1, CV_64FC1)
+             )
+           )
+{
+    int n = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat a(n, n, type), src, evals, evects;
+    declare.in(a, WARMUP_RNG);
+    mulTransposed(a, src, true);
+
+    TEST_CYCLE() eigen(src, evals, evects, 16);
+
+    SANITY_CHECK(evals, 1e-3, ERROR_RELATIVE);
+}
+
+PERF_TEST_P( N_MatType, SVDecomp,
+             testing::Combine
+             (
+                 testing::Values(16, 64, 256, 512),
+                 testing::Values(CV_32FC1, CV_64FC1)
+             )
+           )
+{
+    int n = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat src(n + n/2, n, type), w, u, vt;
+    declare.in(src, WARMUP_RNG);
+    if( n >= 256 )
+        declare.time(60);
+
+    TEST_CYCLE() SVDecomp(src, w, u, vt);
+
+    SANITY_CHECK(w, 1e-3, ERROR_RELATIVE);
+}
@@ -0,0 +1,52 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+typedef std::tr1::tuple<Size, MatType, int> Size_MatType_LutCn_t;
+typedef perf::TestBaseWithParam<Size_MatType_LutCn_t> Size_MatType_LutCn;
+
+PERF_TEST_P(Size_MatType_LutCn, LUT,
+            testing::Combine(
+                testing::Values(szVGA, sz1080p),
+                testing::Values(CV_8UC1, CV_8UC3, CV_8UC4),
+                testing::Values(1, 0)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int lutcn = get<2>(GetParam()) == 1 ? 1 : CV_MAT_CN(type);
+
+    Mat src(sz, type), lut(1, 256, CV_8UC(lutcn)), dst(sz, type);
+
+    declare.in(src, lut, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() cv::LUT(src, lut, dst);
+
+    SANITY_CHECK(dst);
+}
+
+PERF_TEST_P(Size_MatType, LUTPipeline_apply,
+            testing::Combine(
+                testing::Values(szVGA, sz1080p),
+                testing::Values(CV_8UC1, CV_8UC3)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat src(sz, type), dst(sz, type);
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    LUTPipeline pipeline(CV_MAT_CN(type));
+    pipeline.contrast(1.2, -10).gamma(0.8).threshold(200, 255, LUTPipeline::THRESH_TRUNC);
+
+    TEST_CYCLE() pipeline.apply(src, dst);
+
+    SANITY_CHECK(dst);
+}
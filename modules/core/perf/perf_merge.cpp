@@ -34,4 +34,41 @@ PERF_TEST_P( Size_SrcDepth_DstChannels, merge,
     TEST_CYCLE_MULTIRUN(runs) merge( (vector<Mat> &)mv, dst );
 
     SANITY_CHECK(dst, 1e-12);
-}
\ No newline at end of file
+}
+
+typedef std::tr1::tuple<Size, MatType, int, bool> Size_SrcDepth_DstChannels_Optimized_t;
+typedef perf::TestBaseWithParam<Size_SrcDepth_DstChannels_Optimized_t> Size_SrcDepth_DstChannels_Optimized;
+
+PERF_TEST_P( Size_SrcDepth_DstChannels_Optimized, merge_simd,
+             testing::Combine
+             (
+                 testing::Values(szVGA, sz1080p),
+                 testing::Values(CV_8U, CV_16U, CV_32F),
+                 testing::Values(2, 3, 4),
+                 testing::Bool()
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int srcDepth = get<1>(GetParam());
+    int dstChannels = get<2>(GetParam());
+    bool optimized = get<3>(GetParam());
+
+    vector<Mat> mv(dstChannels);
+    for( int i = 0; i < dstChannels; ++i )
+    {
+        mv[i].create(sz, CV_MAKETYPE(srcDepth, 1));
+        declare.in(mv[i], WARMUP_RNG);
+    }
+
+    // the non-optimized run measures the scalar loops
+    bool prevOptimized = useOptimized();
+    setUseOptimized(optimized);
+
+    Mat dst;
+    TEST_CYCLE() merge(mv, dst);
+
+    setUseOptimized(prevOptimized);
+
+    SANITY_CHECK(dst, 1e-12);
+}
@@ -103,6 +103,51 @@ PERF_TEST_P(Size_MatType_NormType, norm2_mask,
     SANITY_CHECK(n, 1e-5, ERROR_RELATIVE);
 }
 
+PERF_TEST_P(Size_MatType_NormType, norm_large,
+            testing::Combine(
+                testing::Values(::perf::sz1080p, ::perf::sz2160p),
+                testing::Values(CV_8UC1, CV_16UC1, CV_16SC1, CV_16UC3, CV_32FC1),
+                testing::Values((int)NORM_INF, (int)NORM_L1, (int)NORM_L2)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int normType = get<2>(GetParam());
+
+    Mat src(sz, matType);
+    double n;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() n = norm(src, normType);
+
+    SANITY_CHECK(n, 1e-6, ERROR_RELATIVE);
+}
+
+PERF_TEST_P(Size_MatType_NormType, norm2_large,
+            testing::Combine(
+                testing::Values(::perf::sz1080p, ::perf::sz2160p),
+                testing::Values(CV_8UC1, CV_16UC1, CV_16SC1, CV_32FC1),
+                testing::Values((int)NORM_INF, (int)NORM_L1, (int)NORM_L2)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+    int normType = get<2>(GetParam());
+
+    Mat src1(sz, matType);
+    Mat src2(sz, matType);
+    double n;
+
+    declare.in(src1, src2, WARMUP_RNG);
+
+    TEST_CYCLE() n = norm(src1, src2, normType);
+
+    SANITY_CHECK(n, 1e-5, ERROR_RELATIVE);
+}
+
 PERF_TEST_P(Size_MatType_NormType, normalize,
             testing::Combine(
                 testing::Values(TYPICAL_MAT_SIZES),
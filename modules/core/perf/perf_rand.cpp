@@ -0,0 +1,50 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+enum { RNG_MWC, RNG_PHILOX };
+CV_ENUM(RNGEngine, RNG_MWC, RNG_PHILOX)
+CV_ENUM(RandDist, RNG::UNIFORM, RNG::NORMAL)
+
+typedef std::tr1::tuple<Size, MatType, RandDist, RNGEngine> Size_MatType_RandDist_RNGEngine_t;
+typedef perf::TestBaseWithParam<Size_MatType_RandDist_RNGEngine_t> Size_MatType_RandDist_RNGEngine;
+
+PERF_TEST_P( Size_MatType_RandDist_RNGEngine, RNG_fill,
+             testing::Combine
+             (
+                 testing::Values(szVGA, sz1080p),
+                 testing::Values(CV_8UC3, CV_32FC1, CV_64FC1),
+                 testing::ValuesIn(RandDist::all()),
+                 testing::ValuesIn(RNGEngine::all())
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int dist = get<2>(GetParam());
+    int engine = get<3>(GetParam());
+
+    Mat dst(sz, type);
+    declare.out(dst);
+
+    TEST_CYCLE()
+    {
+        // the generators are re-seeded on every iteration, so the output is reproducible
+        if( engine == RNG_MWC )
+        {
+            RNG rng(12345);
+            rng.fill(dst, dist, Scalar::all(0), Scalar::all(100));
+        }
+        else
+        {
+            RNG_Philox rng(12345);
+            rng.fill(dst, dist, Scalar::all(0), Scalar::all(100));
+        }
+    }
+
+    SANITY_CHECK(dst, 1e-5);
+}
@@ -0,0 +1,59 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+CV_ENUM(SortFlag, SORT_EVERY_ROW, SORT_EVERY_COLUMN, SORT_EVERY_ROW | SORT_DESCENDING)
+
+typedef std::tr1::tuple<Size, MatType, SortFlag> Size_MatType_SortFlag_t;
+typedef perf::TestBaseWithParam<Size_MatType_SortFlag_t> Size_MatType_SortFlag;
+
+PERF_TEST_P( Size_MatType_SortFlag, sort,
+             testing::Combine
+             (
+                 testing::Values(Size(64, 1000), szVGA, Size(2000, 2000)),
+                 testing::Values(CV_8UC1, CV_16SC1, CV_32SC1, CV_32FC1, CV_64FC1),
+                 testing::ValuesIn(SortFlag::all())
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+
+    Mat src(sz, type), dst(sz, type);
+    declare.in(src, WARMUP_RNG).out(dst);
+    if( sz.area() >= 2000*2000 )
+        declare.time(100);
+
+    TEST_CYCLE() cv::sort(src, dst, flags);
+
+    SANITY_CHECK(dst);
+}
+
+PERF_TEST_P( Size_MatType_SortFlag, sortIdx,
+             testing::Combine
+             (
+                 testing::Values(Size(64, 1000), szVGA, Size(2000, 2000)),
+                 testing::Values(CV_8UC1, CV_16SC1, CV_32SC1, CV_32FC1, CV_64FC1),
+                 testing::ValuesIn(SortFlag::all())
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flags = get<2>(GetParam());
+
+    Mat src(sz, type), dst(sz, CV_32SC1);
+    declare.in(src, WARMUP_RNG).out(dst);
+    if( sz.area() >= 2000*2000 )
+        declare.time(100);
+
+    // the stable order makes the result independent of the implementation
+    TEST_CYCLE() sortIdx(src, dst, flags | SORT_STABLE);
+
+    SANITY_CHECK(dst);
+}
@@ -0,0 +1,67 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+enum { SPARSE_REF, SPARSE_FIND, SPARSE_BATCH_FIND, SPARSE_ACCUMULATE };
+CV_ENUM(SparseOp, SPARSE_REF, SPARSE_FIND, SPARSE_BATCH_FIND, SPARSE_ACCUMULATE)
+
+typedef std::tr1::tuple<int, SparseOp> NNZ_SparseOp_t;
+typedef perf::TestBaseWithParam<NNZ_SparseOp_t> NNZ_SparseOp;
+
+PERF_TEST_P( NNZ_SparseOp, SparseMat_access,
+             testing::Combine
+             (
+                 testing::Values(1000, 100000, 1000000),
+                 testing::ValuesIn(SparseOp::all())
+             )
+           )
+{
+    int nnz = get<0>(GetParam());
+    int op = get<1>(GetParam());
+    const int sz[] = { 256, 256, 256 }, count = 100000;
+
+    RNG rng(12345);
+    SparseMat m(3, sz, CV_32F);
+    for( int k = 0; k < nnz; k++ )
+    {
+        int idx[] = { rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256) };
+        m.ref<float>(idx) = 1.f;
+    }
+    // every other query hits an existing element
+    std::vector<int> idx(count*3);
+    RNG rng2(12345);
+    for( int k = 0; k < count*3; k++ )
+        idx[k] = (k/3) % 2 == 0 ? rng2.uniform(0, 256) : rng.uniform(0, 256);
+    std::vector<uchar*> ptrs(count);
+    double s = 0;
+
+    TEST_CYCLE()
+    {
+        s = 0;
+        switch( op )
+        {
+        case SPARSE_REF:
+            for( int k = 0; k < count; k++ )
+                s += m.ref<float>(&idx[k*3]);
+            break;
+        case SPARSE_FIND:
+            for( int k = 0; k < count; k++ )
+                s += m.value<float>(&idx[k*3]);
+            break;
+        case SPARSE_BATCH_FIND:
+            m.ptr(&idx[0], count, &ptrs[0], false);
+            for( int k = 0; k < count; k++ )
+                s += ptrs[k] ? *(float*)ptrs[k] : 0.f;
+            break;
+        default:
+            m.accumulate(&idx[0], 0, count);
+            s = (double)m.nzcount();
+        }
+    }
+
+    SANITY_CHECK(s);
+}
@@ -31,3 +31,36 @@ PERF_TEST_P( Size_Depth_Channels, split,
 
     SANITY_CHECK(mv, 1e-12);
 }
+
+typedef std::tr1::tuple<Size, MatType, int, bool> Size_Depth_Channels_Optimized_t;
+typedef perf::TestBaseWithParam<Size_Depth_Channels_Optimized_t> Size_Depth_Channels_Optimized;
+
+PERF_TEST_P( Size_Depth_Channels_Optimized, split_simd,
+             testing::Combine
+             (
+                 testing::Values(szVGA, sz1080p),
+                 testing::Values(CV_8U, CV_16U, CV_32F),
+                 testing::Values(2, 3, 4),
+                 testing::Bool()
+             )
+           )
+{
+    Size sz = get<0>(GetParam());
+    int depth = get<1>(GetParam());
+    int channels = get<2>(GetParam());
+    bool optimized = get<3>(GetParam());
+
+    Mat m(sz, CV_MAKETYPE(depth, channels));
+    declare.in(m, WARMUP_RNG);
+
+    // the non-optimized run measures the scalar loops
+    bool prevOptimized = useOptimized();
+    setUseOptimized(optimized);
+
+    vector<Mat> mv;
+    TEST_CYCLE() split(m, mv);
+
+    setUseOptimized(prevOptimized);
+
+    SANITY_CHECK(mv, 1e-12);
+}
@@ -6,6 +6,10 @@ using namespace perf;
 using std::tr1::make_tuple;
 using std::tr1::get;
 
+#define LARGE_MAT_SIZES ::perf::sz1080p, ::perf::sz2160p
+#define LARGE_MAT_TYPES CV_8UC1, CV_16UC1, CV_16SC1, CV_16UC3, CV_32FC1, CV_32FC4
+#define LARGE_MATS testing::Combine( testing::Values( LARGE_MAT_SIZES ), testing::Values( LARGE_MAT_TYPES ) )
+
 PERF_TEST_P(Size_MatType, sum, TYPICAL_MATS)
 {
     Size sz = get<0>(GetParam());
@@ -102,3 +106,83 @@ PERF_TEST_P(Size_MatType, countNonZero, testing::Combine( testing::Values( TYPIC
 
     SANITY_CHECK(cnt);
 }
+
+PERF_TEST_P(Size_MatType, sum_large, LARGE_MATS)
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat arr(sz, type);
+    Scalar s;
+
+    declare.in(arr, WARMUP_RNG).out(s);
+
+    TEST_CYCLE() s = sum(arr);
+
+    SANITY_CHECK(s, 1e-6, ERROR_RELATIVE);
+}
+
+PERF_TEST_P(Size_MatType, mean_mask_large, LARGE_MATS)
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+
+    Mat src(sz, type);
+    Mat mask = Mat::ones(src.size(), CV_8U);
+    Scalar s;
+
+    declare.in(src, WARMUP_RNG).in(mask).out(s);
+
+    TEST_CYCLE() s = mean(src, mask);
+
+    SANITY_CHECK(s, 1e-6, ERROR_RELATIVE);
+}
+
+PERF_TEST_P(Size_MatType, meanStdDev_large, LARGE_MATS)
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    Scalar mean;
+    Scalar dev;
+
+    declare.in(src, WARMUP_RNG).out(mean, dev);
+
+    TEST_CYCLE() meanStdDev(src, mean, dev);
+
+    SANITY_CHECK(mean, 1e-6, ERROR_RELATIVE);
+    SANITY_CHECK(dev, 1e-6, ERROR_RELATIVE);
+}
+
+PERF_TEST_P(Size_MatType, countNonZero_large, testing::Combine( testing::Values( LARGE_MAT_SIZES ), testing::Values( CV_8UC1, CV_16UC1, CV_32SC1, CV_32FC1, CV_64FC1 ) ))
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    int cnt = 0;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() cnt = countNonZero(src);
+
+    SANITY_CHECK(cnt);
+}
+
+PERF_TEST_P(Size_MatType, minMaxLoc_large, testing::Combine( testing::Values( LARGE_MAT_SIZES ), testing::Values( CV_8UC1, CV_16UC1, CV_16SC1, CV_32FC1, CV_64FC1 ) ))
+{
+    Size sz = get<0>(GetParam());
+    int matType = get<1>(GetParam());
+
+    Mat src(sz, matType);
+    double minVal, maxVal;
+    Point minLoc, maxLoc;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() minMaxLoc(src, &minVal, &maxVal, &minLoc, &maxLoc);
+
+    SANITY_CHECK(minVal, 1e-12);
+    SANITY_CHECK(maxVal, 1e-12);
+}
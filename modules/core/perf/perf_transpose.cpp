@@ -0,0 +1,82 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+#define TYPES_TRANSPOSE  CV_8UC1, CV_8UC3, CV_16UC1, CV_32FC1, CV_64FC1
+#define SIZES_TRANSPOSE  szVGA, sz1080p, sz2160p
+
+CV_ENUM(RotateCode, ROTATE_90_CLOCKWISE, ROTATE_180, ROTATE_90_COUNTERCLOCKWISE)
+CV_ENUM(FlipCode, -1, 0, 1)
+
+typedef tr1::tuple<Size, MatType, RotateCode> Size_MatType_RotateCode_t;
+typedef TestBaseWithParam<Size_MatType_RotateCode_t> Size_MatType_RotateCode;
+
+typedef tr1::tuple<Size, MatType, FlipCode> Size_MatType_FlipCode_t;
+typedef TestBaseWithParam<Size_MatType_FlipCode_t> Size_MatType_FlipCode;
+
+PERF_TEST_P(Size_MatType, transpose,
+            testing::Combine(testing::Values(SIZES_TRANSPOSE), testing::Values(TYPES_TRANSPOSE)))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    Mat src(sz, type), dst(sz.width, sz.height, type);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() transpose(src, dst);
+
+    SANITY_CHECK(dst);
+}
+
+PERF_TEST_P(Size_MatType, transpose_inplace,
+            testing::Combine(testing::Values(Size(512, 512), Size(2048, 2048)), testing::Values(TYPES_TRANSPOSE)))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    Mat src(sz, type), m;
+
+    declare.in(src, WARMUP_RNG);
+
+    // a symmetric matrix stays the same whatever the number of iterations is
+    m = src + src.t();
+
+    TEST_CYCLE() transpose(m, m);
+
+    SANITY_CHECK(m);
+}
+
+PERF_TEST_P(Size_MatType_RotateCode, rotate,
+            testing::Combine(testing::Values(SIZES_TRANSPOSE), testing::Values(TYPES_TRANSPOSE),
+                             testing::ValuesIn(RotateCode::all())))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int rotateCode = get<2>(GetParam());
+    Mat src(sz, type), dst;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() rotate(src, dst, rotateCode);
+
+    SANITY_CHECK(dst);
+}
+
+PERF_TEST_P(Size_MatType_FlipCode, flip,
+            testing::Combine(testing::Values(SIZES_TRANSPOSE), testing::Values(TYPES_TRANSPOSE),
+                             testing::ValuesIn(FlipCode::all())))
+{
+    Size sz = get<0>(GetParam());
+    int type = get<1>(GetParam());
+    int flipCode = get<2>(GetParam());
+    Mat src(sz, type), dst(sz, type);
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() flip(src, dst, flipCode);
+
+    SANITY_CHECK(dst);
+}
@@ -42,6 +42,19 @@
 
 #include "precomp.hpp"
 
+#if defined WIN32 || defined _WIN32 || defined WINCE
+    #include <windows.h>
+    #undef small
+    #undef min
+    #undef max
+    #undef abs
+    #ifdef WINCE
+        #define TLS_OUT_OF_INDEXES ((DWORD)0xFFFFFFFF)
+    #endif
+#else
+    #include <pthread.h>
+#endif
+
 #define CV_USE_SYSTEM_MALLOC 1
 
 namespace cv
@@ -53,6 +66,9 @@ static void* OutOfMemoryError(size_t size)
     return 0;
 }
 
+// the number of fastMalloc calls, see getFastMallocCount()
+static int fastMallocCount = 0;
+
 #if CV_USE_SYSTEM_MALLOC
 
 #if defined WIN32 || defined _WIN32
@@ -61,6 +77,9 @@ void deleteThreadAllocData() {}
 
 void* fastMalloc( size_t size )
 {
+    CV_TRACE_REGION("fastMalloc");
+    CV_TRACE_COUNTER("fastMalloc.bytes", size);
+    CV_XADD(&fastMallocCount, 1);
     uchar* udata = (uchar*)malloc(size + sizeof(void*) + CV_MALLOC_ALIGN);
     if(!udata)
         return OutOfMemoryError(size);
@@ -473,6 +492,9 @@ static void checkList(ThreadData* tls, int idx)
 
 void* fastMalloc( size_t size )
 {
+    CV_TRACE_REGION("fastMalloc");
+    CV_TRACE_COUNTER("fastMalloc.bytes", size);
+    CV_XADD(&fastMallocCount, 1);
     if( size > MAX_BLOCK_SIZE )
     {
         size_t size1 = size + sizeof(uchar*)*2 + MEM_BLOCK_SIZE;
@@ -681,6 +703,615 @@ void fastFree( void* ptr )
 
 #endif //CV_USE_SYSTEM_MALLOC
 
+/****************************************************************************************\
+*                                  Pooled Mat allocator                                  *
+\****************************************************************************************/
+
+enum
+{
+    POOL_MIN_SHIFT = 6,     // the smallest size class is 64 bytes
+    POOL_MAX_SHIFT = 31,    // the larger blocks are never cached
+    POOL_CLASS_SHIFT = 3,   // 8 size classes per power of two, i.e. <= 12.5% overhead
+    POOL_NCLASSES = (POOL_MAX_SHIFT - POOL_MIN_SHIFT) << POOL_CLASS_SHIFT,
+    POOL_THREAD_BLOCKS = 4  // blocks of one size class kept by a thread, the rest go to the depot
+};
+
+static const size_t POOL_DEFAULT_LIMIT = (size_t)128 << 20;
+
+// returns the smallest size class that can hold the block or -1 if the block is too big
+static inline int poolSizeClass(size_t size)
+{
+    if( size <= ((size_t)1 << POOL_MIN_SHIFT) )
+        return 0;
+    size_t s = size - 1;
+#if defined __GNUC__
+    int shift = 63 - __builtin_clzll((unsigned long long)s) - POOL_CLASS_SHIFT;
+#else
+    int shift = POOL_MIN_SHIFT - POOL_CLASS_SHIFT;
+    while( (s >> shift) >= (2 << POOL_CLASS_SHIFT) )
+        shift++;
+#endif
+    int idx = ((shift + POOL_CLASS_SHIFT - POOL_MIN_SHIFT) << POOL_CLASS_SHIFT) +
+              (int)(s >> shift) - (1 << POOL_CLASS_SHIFT) + 1;
+    return idx < POOL_NCLASSES ? idx : -1;
+}
+
+static inline size_t poolClassSize(int idx)
+{
+    return (size_t)((1 << POOL_CLASS_SHIFT) + (idx & ((1 << POOL_CLASS_SHIFT) - 1))) <<
+           ((idx >> POOL_CLASS_SHIFT) + POOL_MIN_SHIFT - POOL_CLASS_SHIFT);
+}
+
+// the cached memory is accounted in kilobytes to fit the atomic int counter
+static inline int poolClassKB(int idx)
+{
+    return (int)((poolClassSize(idx) + 1023) >> 10);
+}
+
+struct PoolBlock
+{
+    PoolBlock* next;
+};
+
+// the counters are updated by the owner thread and read by getStats() from other threads,
+// so all of them are accessed with CV_XADD
+struct PoolThreadCache
+{
+    PoolThreadCache() : cachedKB(0), hits(0), misses(0), prev(0), next(0)
+    {
+        memset(lists, 0, sizeof(lists));
+        memset(counts, 0, sizeof(counts));
+    }
+
+    PoolBlock* lists[POOL_NCLASSES];
+    int counts[POOL_NCLASSES];
+    int cachedKB, hits, misses;
+    PoolThreadCache *prev, *next;
+};
+
+static void deletePoolThreadCache(void* data);
+
+// the state shared by all threads: the depot of blocks that do not fit
+// into the thread caches, the list of thread caches and the statistics
+struct PoolState
+{
+    PoolState() : cachedKB(0), limitKB((int)(POOL_DEFAULT_LIMIT >> 10)), depotKB(0),
+                  caches(0), retiredHits(0), retiredMisses(0), trimmedBytes(0)
+    {
+        memset(depot, 0, sizeof(depot));
+#if defined WIN32 || defined _WIN32
+        tlsKey = TlsAlloc();
+        CV_Assert(tlsKey != TLS_OUT_OF_INDEXES);
+#else
+        int errcode = pthread_key_create(&tlsKey, deletePoolThreadCache);
+        CV_Assert(errcode == 0);
+#endif
+    }
+
+    PoolThreadCache* threadCache()
+    {
+#if defined WIN32 || defined _WIN32
+        PoolThreadCache* tc = (PoolThreadCache*)TlsGetValue(tlsKey);
+#else
+        PoolThreadCache* tc = (PoolThreadCache*)pthread_getspecific(tlsKey);
+#endif
+        if( !tc )
+        {
+            tc = new PoolThreadCache;
+            {
+                AutoLock lock(mutex);
+                tc->next = caches;
+                if( caches )
+                    caches->prev = tc;
+                caches = tc;
+            }
+#if defined WIN32 || defined _WIN32
+            TlsSetValue(tlsKey, tc);
+#else
+            pthread_setspecific(tlsKey, tc);
+#endif
+        }
+        return tc;
+    }
+
+    // accounts the block in the cached memory unless the limit is exceeded
+    bool reserve(int kb)
+    {
+        if( CV_XADD(&cachedKB, kb) + kb <= limitKB )
+            return true;
+        CV_XADD(&cachedKB, -kb);
+        return false;
+    }
+
+    // releases the largest block of the depot; the caller holds the mutex
+    bool evictLargest()
+    {
+        for( int idx = POOL_NCLASSES - 1; idx >= 0; idx-- )
+        {
+            PoolBlock* b = depot[idx];
+            if( b )
+            {
+                depot[idx] = b->next;
+                depotKB -= poolClassKB(idx);
+                trimmedBytes += poolClassSize(idx);
+                CV_XADD(&cachedKB, -poolClassKB(idx));
+                fastFree(b);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void releaseList(PoolBlock*& list, int idx)
+    {
+        while( list )
+        {
+            PoolBlock* b = list;
+            list = b->next;
+            CV_XADD(&cachedKB, -poolClassKB(idx));
+            fastFree(b);
+        }
+    }
+
+    Mutex mutex;
+    int cachedKB;
+    int limitKB;
+
+    // every block is accounted as poolClassKB() here, in the thread caches and in cachedKB
+    PoolBlock* depot[POOL_NCLASSES];
+    int depotKB;
+
+    PoolThreadCache* caches;
+    size_t retiredHits, retiredMisses, trimmedBytes;
+
+#if defined WIN32 || defined _WIN32
+    DWORD tlsKey;
+#else
+    pthread_key_t tlsKey;
+#endif
+};
+
+static PoolState& getPoolState()
+{
+    // never destroyed, matrices may be released by the static destructors of other modules
+    static PoolState* state = new PoolState;
+    return *state;
+}
+
+// called on the thread exit; the cached blocks are handed over to the depot
+static void deletePoolThreadCache(void* data)
+{
+    PoolThreadCache* tc = (PoolThreadCache*)data;
+    if( !tc )
+        return;
+
+    PoolState& pool = getPoolState();
+    AutoLock lock(pool.mutex);
+    for( int idx = 0; idx < POOL_NCLASSES; idx++ )
+    {
+        while( tc->lists[idx] )
+        {
+            PoolBlock* b = tc->lists[idx];
+            tc->lists[idx] = b->next;
+            b->next = pool.depot[idx];
+            pool.depot[idx] = b;
+            pool.depotKB += poolClassKB(idx);
+        }
+    }
+    pool.retiredHits += (unsigned)CV_XADD(&tc->hits, 0);
+    pool.retiredMisses += (unsigned)CV_XADD(&tc->misses, 0);
+
+    if( tc->prev )
+        tc->prev->next = tc->next;
+    else
+        pool.caches = tc->next;
+    if( tc->next )
+        tc->next->prev = tc->prev;
+    delete tc;
+}
+
+#if defined WIN32 || defined _WIN32
+void deleteThreadPoolData()
+{
+    PoolState& pool = getPoolState();
+    deletePoolThreadCache(TlsGetValue(pool.tlsKey));
+    TlsSetValue(pool.tlsKey, 0);
+}
+#endif
+
+PoolMatAllocator::Stats::Stats() : hits(0), misses(0), cachedBytes(0), trimmedBytes(0) {}
+
+PoolMatAllocator::PoolMatAllocator() {}
+
+PoolMatAllocator* PoolMatAllocator::getInstance()
+{
+    static PoolMatAllocator* instance = new PoolMatAllocator;
+    return instance;
+}
+
+void PoolMatAllocator::allocate(int dims, const int* sizes, int type, int*& refcount,
+                                uchar*& datastart, uchar*& data, size_t* step)
+{
+    size_t total = CV_ELEM_SIZE(type);
+    for( int i = dims-1; i >= 0; i-- )
+    {
+        step[i] = total;
+        total *= sizes[i];
+    }
+    size_t totalsize = alignSize(total, (int)sizeof(*refcount));
+    size_t blocksize = totalsize + sizeof(*refcount);
+
+    PoolState& pool = getPoolState();
+    PoolThreadCache* tc = pool.threadCache();
+    int idx = poolSizeClass(blocksize);
+    uchar* ptr = 0;
+
+    if( idx >= 0 )
+    {
+        PoolBlock* b = tc->lists[idx];
+        if( b )
+        {
+            tc->lists[idx] = b->next;
+            tc->counts[idx]--;
+            CV_XADD(&tc->cachedKB, -poolClassKB(idx));
+            CV_XADD(&pool.cachedKB, -poolClassKB(idx));
+        }
+        else if( pool.depot[idx] )
+        {
+            AutoLock lock(pool.mutex);
+            b = pool.depot[idx];
+            if( b )
+            {
+                pool.depot[idx] = b->next;
+                pool.depotKB -= poolClassKB(idx);
+                CV_XADD(&pool.cachedKB, -poolClassKB(idx));
+            }
+        }
+        ptr = (uchar*)b;
+    }
+
+    if( ptr )
+        CV_XADD(&tc->hits, 1);
+    else
+    {
+        CV_XADD(&tc->misses, 1);
+        ptr = (uchar*)fastMalloc(idx >= 0 ? poolClassSize(idx) : blocksize);
+    }
+
+    data = datastart = ptr;
+    refcount = (int*)(ptr + totalsize);
+    *refcount = 1;
+}
+
+void PoolMatAllocator::deallocate(int* refcount, uchar* datastart, uchar*)
+{
+    if( !datastart )
+        return;
+
+    // the reference counter is placed right after the matrix data, see allocate()
+    size_t blocksize = (uchar*)refcount - datastart + sizeof(*refcount);
+    int idx = poolSizeClass(blocksize);
+    if( idx < 0 )
+    {
+        fastFree(datastart);
+        return;
+    }
+
+    PoolState& pool = getPoolState();
+    int kb = poolClassKB(idx);
+    if( !pool.reserve(kb) )
+    {
+        AutoLock lock(pool.mutex);
+        // evict only when it can make room: the blocks of the thread caches stay,
+        // and a block larger than the limit is never cached
+        bool reserved = false;
+        if( kb <= pool.limitKB - (pool.cachedKB - pool.depotKB) )
+            while( !(reserved = pool.reserve(kb)) && pool.evictLargest() )
+                ;
+        if( !reserved )
+        {
+            pool.trimmedBytes += poolClassSize(idx);
+            fastFree(datastart);
+            return;
+        }
+    }
+
+    PoolBlock* b = (PoolBlock*)datastart;
+    PoolThreadCache* tc = pool.threadCache();
+    if( tc->counts[idx] < POOL_THREAD_BLOCKS )
+    {
+        b->next = tc->lists[idx];
+        tc->lists[idx] = b;
+        tc->counts[idx]++;
+        CV_XADD(&tc->cachedKB, kb);
+    }
+    else
+    {
+        AutoLock lock(pool.mutex);
+        b->next = pool.depot[idx];
+        pool.depot[idx] = b;
+        pool.depotKB += kb;
+    }
+}
+
+void PoolMatAllocator::setCacheLimit(size_t bytes)
+{
+    PoolState& pool = getPoolState();
+    PoolThreadCache* tc = pool.threadCache();
+    AutoLock lock(pool.mutex);
+
+    pool.limitKB = (int)std::min(bytes >> 10, (size_t)INT_MAX);
+    while( pool.cachedKB > pool.limitKB && pool.evictLargest() )
+        ;
+
+    // the caches of other threads shrink as their blocks are reused
+    for( int idx = POOL_NCLASSES - 1; idx >= 0 && pool.cachedKB > pool.limitKB; idx-- )
+    {
+        pool.trimmedBytes += poolClassSize(idx)*tc->counts[idx];
+        CV_XADD(&tc->cachedKB, -poolClassKB(idx)*tc->counts[idx]);
+        pool.releaseList(tc->lists[idx], idx);
+        tc->counts[idx] = 0;
+    }
+}
+
+size_t PoolMatAllocator::getCacheLimit() const
+{
+    return (size_t)getPoolState().limitKB << 10;
+}
+
+void PoolMatAllocator::trim()
+{
+    PoolState& pool = getPoolState();
+    PoolThreadCache* tc = pool.threadCache();
+    AutoLock lock(pool.mutex);
+
+    for( int idx = 0; idx < POOL_NCLASSES; idx++ )
+    {
+        pool.trimmedBytes += poolClassSize(idx)*tc->counts[idx];
+        pool.releaseList(tc->lists[idx], idx);
+        tc->counts[idx] = 0;
+    }
+    CV_XADD(&tc->cachedKB, -CV_XADD(&tc->cachedKB, 0));
+
+    for( int idx = 0; idx < POOL_NCLASSES; idx++ )
+    {
+        for( PoolBlock* b = pool.depot[idx]; b != 0; b = b->next )
+            pool.trimmedBytes += poolClassSize(idx);
+        pool.releaseList(pool.depot[idx], idx);
+    }
+    pool.depotKB = 0;
+}
+
+PoolMatAllocator::Stats PoolMatAllocator::getStats() const
+{
+    PoolState& pool = getPoolState();
+    AutoLock lock(pool.mutex);
+
+    Stats stats;
+    stats.hits = pool.retiredHits;
+    stats.misses = pool.retiredMisses;
+    stats.trimmedBytes = pool.trimmedBytes;
+    size_t cachedKB = pool.depotKB;
+    for( PoolThreadCache* tc = pool.caches; tc != 0; tc = tc->next )
+    {
+        stats.hits += (unsigned)CV_XADD(&tc->hits, 0);
+        stats.misses += (unsigned)CV_XADD(&tc->misses, 0);
+        cachedKB += CV_XADD(&tc->cachedKB, 0);
+    }
+    stats.cachedBytes = cachedKB << 10;
+    return stats;
+}
+
+void PoolMatAllocator::resetStats()
+{
+    PoolState& pool = getPoolState();
+    AutoLock lock(pool.mutex);
+
+    pool.retiredHits = pool.retiredMisses = pool.trimmedBytes = 0;
+    for( PoolThreadCache* tc = pool.caches; tc != 0; tc = tc->next )
+    {
+        CV_XADD(&tc->hits, -CV_XADD(&tc->hits, 0));
+        CV_XADD(&tc->misses, -CV_XADD(&tc->misses, 0));
+    }
+}
+
+/****************************************************************************************\
+*                                 Per-thread scratch arena                               *
+\****************************************************************************************/
+
+static const size_t SCRATCH_MIN_CHUNK = (size_t)64 << 10;
+// the blocks that do not fit into this limit are allocated directly with fastMalloc
+static const size_t SCRATCH_MAX_CAPACITY = (size_t)64 << 20;
+
+// placed in front of every scratch block
+struct ScratchHeader
+{
+    enum { FREED = 1, HEAP = 2 };
+
+    ScratchHeader* prev;
+    int prevChunk;
+    int flags;
+    size_t prevOfs;
+};
+
+static const size_t SCRATCH_HDR_SIZE = alignSize(sizeof(ScratchHeader), CV_MALLOC_ALIGN);
+
+struct ScratchArena
+{
+    ScratchArena() : cur(0), ofs(0), capacity(0), last(0), live(0) {}
+
+    ~ScratchArena()
+    {
+        for( size_t i = 0; i < chunks.size(); i++ )
+            fastFree(chunks[i]);
+    }
+
+    void* allocate(size_t size)
+    {
+        size_t blocksize = SCRATCH_HDR_SIZE + alignSize(size, CV_MALLOC_ALIGN);
+        int nchunks = (int)chunks.size();
+        int chunk = cur;
+        size_t pos = ofs;
+
+        if( nchunks == 0 || pos + blocksize > sizes[chunk] )
+        {
+            if( chunk + 1 < nchunks && blocksize <= sizes[chunk + 1] )
+                chunk++;
+            else
+            {
+                // the chunks above the top are free, replace them with a bigger one
+                size_t newsize = std::max(std::max(blocksize, SCRATCH_MIN_CHUNK), capacity);
+                for( int i = nchunks - 1; i > chunk || (i == chunk && ofs == 0); i-- )
+                {
+                    capacity -= sizes[i];
+                    fastFree(chunks[i]);
+                    chunks.pop_back();
+                    sizes.pop_back();
+                }
+                if( capacity + newsize > SCRATCH_MAX_CAPACITY )
+                    newsize = std::max(blocksize, SCRATCH_MAX_CAPACITY - std::min(capacity, SCRATCH_MAX_CAPACITY));
+                if( capacity + newsize > SCRATCH_MAX_CAPACITY )
+                {
+                    ScratchHeader* hdr = (ScratchHeader*)fastMalloc(blocksize);
+                    hdr->flags = ScratchHeader::HEAP;
+                    return (uchar*)hdr + SCRATCH_HDR_SIZE;
+                }
+                chunks.push_back((uchar*)fastMalloc(newsize));
+                sizes.push_back(newsize);
+                capacity += newsize;
+                chunk = (int)chunks.size() - 1;
+            }
+            pos = 0;
+        }
+
+        ScratchHeader* hdr = (ScratchHeader*)(chunks[chunk] + pos);
+        hdr->prev = last;
+        hdr->prevChunk = cur;
+        hdr->prevOfs = ofs;
+        hdr->flags = 0;
+
+        last = hdr;
+        cur = chunk;
+        ofs = pos + blocksize;
+        live++;
+        return (uchar*)hdr + SCRATCH_HDR_SIZE;
+    }
+
+    void release(void* ptr)
+    {
+        ScratchHeader* hdr = (ScratchHeader*)((uchar*)ptr - SCRATCH_HDR_SIZE);
+        if( hdr->flags & ScratchHeader::HEAP )
+        {
+            fastFree(hdr);
+            return;
+        }
+
+        // pop the released blocks from the top of the stack
+        hdr->flags |= ScratchHeader::FREED;
+        while( last && (last->flags & ScratchHeader::FREED) )
+        {
+            cur = last->prevChunk;
+            ofs = last->prevOfs;
+            last = last->prev;
+        }
+
+        if( --live == 0 && chunks.size() > 1 )
+        {
+            // the arena had to grow during this call; merge the chunks,
+            // so that the next call of the same size fits into one
+            for( size_t i = 0; i < chunks.size(); i++ )
+                fastFree(chunks[i]);
+            chunks.assign(1, (uchar*)fastMalloc(capacity));
+            sizes.assign(1, capacity);
+            cur = 0;
+            ofs = 0;
+        }
+    }
+
+    std::vector<uchar*> chunks;
+    std::vector<size_t> sizes;
+    int cur;
+    size_t ofs;
+    size_t capacity;
+    ScratchHeader* last;
+    int live;
+};
+
+#if defined WIN32 || defined _WIN32
+
+static DWORD tlsScratchKey = TLS_OUT_OF_INDEXES;
+
+void deleteThreadScratchData()
+{
+    if( tlsScratchKey != TLS_OUT_OF_INDEXES )
+    {
+        delete (ScratchArena*)TlsGetValue(tlsScratchKey);
+        TlsSetValue(tlsScratchKey, 0);
+    }
+}
+
+static ScratchArena& getScratchArena()
+{
+    if( tlsScratchKey == TLS_OUT_OF_INDEXES )
+    {
+        tlsScratchKey = TlsAlloc();
+        CV_Assert(tlsScratchKey != TLS_OUT_OF_INDEXES);
+    }
+    ScratchArena* arena = (ScratchArena*)TlsGetValue(tlsScratchKey);
+    if( !arena )
+    {
+        arena = new ScratchArena;
+        TlsSetValue(tlsScratchKey, arena);
+    }
+    return *arena;
+}
+
+#else
+
+static pthread_key_t tlsScratchKey = 0;
+static pthread_once_t tlsScratchKeyOnce = PTHREAD_ONCE_INIT;
+
+static void deleteScratchArena(void* data)
+{
+    delete (ScratchArena*)data;
+}
+
+static void makeScratchKey()
+{
+    int errcode = pthread_key_create(&tlsScratchKey, deleteScratchArena);
+    CV_Assert(errcode == 0);
+}
+
+static ScratchArena& getScratchArena()
+{
+    pthread_once(&tlsScratchKeyOnce, makeScratchKey);
+    ScratchArena* arena = (ScratchArena*)pthread_getspecific(tlsScratchKey);
+    if( !arena )
+    {
+        arena = new ScratchArena;
+        pthread_setspecific(tlsScratchKey, arena);
+    }
+    return *arena;
+}
+
+#endif
+
+void* scratchMalloc(size_t size)
+{
+    return getScratchArena().allocate(size);
+}
+
+void scratchFree(void* ptr)
+{
+    if( ptr )
+        getScratchArena().release(ptr);
+}
+
+int getFastMallocCount()
+{
+    return CV_XADD(&fastMallocCount, 0);
+}
+
 }
 
 CV_IMPL void* cvAlloc( size_t size )
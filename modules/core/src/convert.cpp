@@ -49,11 +49,203 @@ namespace cv
 *                                       split & merge                                    *
 \****************************************************************************************/
 
+#if CV_SSE2
+
+/*
+  SSE2 has no general byte shuffle, so the channels are (de)interleaved with perfect
+  shuffles. The 2*cn registers holding a block of pixels are treated as one array of
+  N elements: a "zip" round (unpacklo/hi of the registers j and j+cn) moves the element
+  at position x to 2*x mod (N-1), and an "unzip" round (the even and the odd elements
+  of the registers 2*j and 2*j+1) moves it to x/2 mod (N-1). Splitting has to move
+  x to x/cn, which takes one unzip for cn == 2, two unzips for cn == 4 and
+  log2(16/sizeof(T)) + 1 zips for cn == 3; merging is the inverse.
+*/
+struct SplitMergeVec8u
+{
+    typedef uchar T;
+    enum { ROUNDS = 5 };
+    static void zip( __m128i& a, __m128i& b )
+    {
+        __m128i t = _mm_unpacklo_epi8(a, b);
+        b = _mm_unpackhi_epi8(a, b); a = t;
+    }
+    static void unzip( __m128i& a, __m128i& b )
+    {
+        __m128i mask = _mm_set1_epi16(0xff);
+        __m128i t = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        b = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)); a = t;
+    }
+};
+
+struct SplitMergeVec16u
+{
+    typedef ushort T;
+    enum { ROUNDS = 4 };
+    static void zip( __m128i& a, __m128i& b )
+    {
+        __m128i t = _mm_unpacklo_epi16(a, b);
+        b = _mm_unpackhi_epi16(a, b); a = t;
+    }
+    static void unzip( __m128i& a, __m128i& b )
+    {
+        // sign-extended halves are packed back without saturation
+        __m128i t = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                    _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        b = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16)); a = t;
+    }
+};
+
+struct SplitMergeVec32s
+{
+    typedef int T;
+    enum { ROUNDS = 3 };
+    static void zip( __m128i& a, __m128i& b )
+    {
+        __m128i t = _mm_unpacklo_epi32(a, b);
+        b = _mm_unpackhi_epi32(a, b); a = t;
+    }
+    static void unzip( __m128i& a, __m128i& b )
+    {
+        __m128 fa = _mm_castsi128_ps(a), fb = _mm_castsi128_ps(b);
+        a = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2, 0, 2, 0)));
+        b = _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+};
+
+template<class VOp, int cn> static inline void zipRound( __m128i* v )
+{
+    __m128i t[cn*2];
+    for( int j = 0; j < cn; j++ )
+    {
+        t[j*2] = v[j]; t[j*2+1] = v[j+cn];
+        VOp::zip(t[j*2], t[j*2+1]);
+    }
+    for( int j = 0; j < cn*2; j++ )
+        v[j] = t[j];
+}
+
+template<class VOp, int cn> static inline void unzipRound( __m128i* v )
+{
+    __m128i t[cn*2];
+    for( int j = 0; j < cn; j++ )
+    {
+        t[j] = v[j*2]; t[j+cn] = v[j*2+1];
+        VOp::unzip(t[j], t[j+cn]);
+    }
+    for( int j = 0; j < cn*2; j++ )
+        v[j] = t[j];
+}
+
+template<class VOp, int cn> static int
+splitSSE2_( const typename VOp::T* src, typename VOp::T** dst, int len )
+{
+    typedef typename VOp::T T;
+    const int VECSZ = (int)(16/sizeof(T));
+    int i = 0, k;
+
+    for( ; i <= len - VECSZ*2; i += VECSZ*2 )
+    {
+        __m128i v[cn*2];
+        const T* s = src + i*cn;
+        for( k = 0; k < cn*2; k++ )
+            v[k] = _mm_loadu_si128((const __m128i*)(s + k*VECSZ));
+
+        if( cn == 3 )
+            for( k = 0; k < VOp::ROUNDS; k++ )
+                zipRound<VOp, cn>(v);
+        else
+            for( k = 1; k < cn; k *= 2 )
+                unzipRound<VOp, cn>(v);
+
+        for( k = 0; k < cn; k++ )
+        {
+            _mm_storeu_si128((__m128i*)(dst[k] + i), v[k*2]);
+            _mm_storeu_si128((__m128i*)(dst[k] + i + VECSZ), v[k*2+1]);
+        }
+    }
+    return i;
+}
+
+template<class VOp, int cn> static int
+mergeSSE2_( const typename VOp::T** src, typename VOp::T* dst, int len )
+{
+    typedef typename VOp::T T;
+    const int VECSZ = (int)(16/sizeof(T));
+    int i = 0, k;
+
+    for( ; i <= len - VECSZ*2; i += VECSZ*2 )
+    {
+        __m128i v[cn*2];
+        for( k = 0; k < cn; k++ )
+        {
+            v[k*2] = _mm_loadu_si128((const __m128i*)(src[k] + i));
+            v[k*2+1] = _mm_loadu_si128((const __m128i*)(src[k] + i + VECSZ));
+        }
+
+        if( cn == 3 )
+            for( k = 0; k < VOp::ROUNDS; k++ )
+                unzipRound<VOp, cn>(v);
+        else
+            for( k = 1; k < cn; k *= 2 )
+                zipRound<VOp, cn>(v);
+
+        T* d = dst + i*cn;
+        for( k = 0; k < cn*2; k++ )
+            _mm_storeu_si128((__m128i*)(d + k*VECSZ), v[k]);
+    }
+    return i;
+}
+
+#endif
+
+// returns the number of leading pixels processed with SIMD; cn is 2, 3 or 4
+template<typename T> struct VSplit
+{
+    int operator()( const T*, T**, int, int ) const { return 0; }
+};
+
+template<typename T> struct VMerge
+{
+    int operator()( const T**, T*, int, int ) const { return 0; }
+};
+
+#if CV_SSE2
+
+#define DEF_SPLIT_MERGE_VEC(T, VOp) \
+template<> struct VSplit<T> \
+{ \
+    int operator()( const T* src, T** dst, int len, int cn ) const \
+    { \
+        if( !USE_SSE2 ) \
+            return 0; \
+        return cn == 2 ? splitSSE2_<VOp, 2>(src, dst, len) : \
+               cn == 3 ? splitSSE2_<VOp, 3>(src, dst, len) : \
+                         splitSSE2_<VOp, 4>(src, dst, len); \
+    } \
+}; \
+template<> struct VMerge<T> \
+{ \
+    int operator()( const T** src, T* dst, int len, int cn ) const \
+    { \
+        if( !USE_SSE2 ) \
+            return 0; \
+        return cn == 2 ? mergeSSE2_<VOp, 2>(src, dst, len) : \
+               cn == 3 ? mergeSSE2_<VOp, 3>(src, dst, len) : \
+                         mergeSSE2_<VOp, 4>(src, dst, len); \
+    } \
+}
+
+DEF_SPLIT_MERGE_VEC(uchar, SplitMergeVec8u);
+DEF_SPLIT_MERGE_VEC(ushort, SplitMergeVec16u);
+DEF_SPLIT_MERGE_VEC(int, SplitMergeVec32s);
+
+#endif
+
 template<typename T> static void
 split_( const T* src, T** dst, int len, int cn )
 {
     int k = cn % 4 ? cn % 4 : 4;
-    int i, j;
+    int i, j, i0 = k == cn && k > 1 ? VSplit<T>()(src, dst, len, cn) : 0;
     if( k == 1 )
     {
         T* dst0 = dst[0];
@@ -63,7 +255,7 @@ split_( const T* src, T** dst, int len, int cn )
     else if( k == 2 )
     {
         T *dst0 = dst[0], *dst1 = dst[1];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst0[i] = src[j];
             dst1[i] = src[j+1];
@@ -72,7 +264,7 @@ split_( const T* src, T** dst, int len, int cn )
     else if( k == 3 )
     {
         T *dst0 = dst[0], *dst1 = dst[1], *dst2 = dst[2];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst0[i] = src[j];
             dst1[i] = src[j+1];
@@ -82,7 +274,7 @@ split_( const T* src, T** dst, int len, int cn )
     else
     {
         T *dst0 = dst[0], *dst1 = dst[1], *dst2 = dst[2], *dst3 = dst[3];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst0[i] = src[j]; dst1[i] = src[j+1];
             dst2[i] = src[j+2]; dst3[i] = src[j+3];
@@ -104,7 +296,7 @@ template<typename T> static void
 merge_( const T** src, T* dst, int len, int cn )
 {
     int k = cn % 4 ? cn % 4 : 4;
-    int i, j;
+    int i, j, i0 = k == cn && k > 1 ? VMerge<T>()(src, dst, len, cn) : 0;
     if( k == 1 )
     {
         const T* src0 = src[0];
@@ -114,7 +306,7 @@ merge_( const T** src, T* dst, int len, int cn )
     else if( k == 2 )
     {
         const T *src0 = src[0], *src1 = src[1];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst[j] = src0[i];
             dst[j+1] = src1[i];
@@ -123,7 +315,7 @@ merge_( const T** src, T* dst, int len, int cn )
     else if( k == 3 )
     {
         const T *src0 = src[0], *src1 = src[1], *src2 = src[2];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst[j] = src0[i];
             dst[j+1] = src1[i];
@@ -133,7 +325,7 @@ merge_( const T** src, T* dst, int len, int cn )
     else
     {
         const T *src0 = src[0], *src1 = src[1], *src2 = src[2], *src3 = src[3];
-        for( i = j = 0; i < len; i++, j += cn )
+        for( i = i0, j = i0*cn; i < len; i++, j += cn )
         {
             dst[j] = src0[i]; dst[j+1] = src1[i];
             dst[j+2] = src2[i]; dst[j+3] = src3[i];
@@ -206,6 +398,66 @@ static MergeFunc mergeTab[] =
     (MergeFunc)GET_OPTIMIZED(merge32s), (MergeFunc)GET_OPTIMIZED(merge32s), (MergeFunc)GET_OPTIMIZED(merge64s), 0
 };
 
+// large 2D arrays are split and merged in parallel horizontal stripes
+enum { SPLIT_MERGE_PARALLEL_SIZE = 1 << 20 };
+
+static bool splitMergeParallel( const Mat& m )
+{
+    return m.dims == 2 && m.rows > 1 && m.total()*m.elemSize() >= (size_t)SPLIT_MERGE_PARALLEL_SIZE;
+}
+
+class SplitInvoker : public ParallelLoopBody
+{
+public:
+    SplitInvoker( const Mat& _src, Mat* _dst, SplitFunc _func )
+        : src(&_src), dst(_dst), func(_func) {}
+
+    void operator()( const Range& range ) const
+    {
+        int k, cn = src->channels();
+        AutoBuffer<uchar*> _ptrs(cn);
+        uchar** ptrs = _ptrs;
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            for( k = 0; k < cn; k++ )
+                ptrs[k] = dst[k].ptr(y);
+            func( src->ptr(y), ptrs, src->cols, cn );
+        }
+    }
+
+protected:
+    const Mat* src;
+    Mat* dst;
+    SplitFunc func;
+};
+
+class MergeInvoker : public ParallelLoopBody
+{
+public:
+    MergeInvoker( const Mat* _src, Mat& _dst, MergeFunc _func )
+        : src(_src), dst(&_dst), func(_func) {}
+
+    void operator()( const Range& range ) const
+    {
+        int k, cn = dst->channels();
+        AutoBuffer<const uchar*> _ptrs(cn);
+        const uchar** ptrs = _ptrs;
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            for( k = 0; k < cn; k++ )
+                ptrs[k] = src[k].ptr(y);
+            func( ptrs, dst->ptr(y), dst->cols, cn );
+        }
+    }
+
+protected:
+    const Mat* src;
+    Mat* dst;
+    MergeFunc func;
+};
+
 }
 
 void cv::split(const Mat& src, Mat* mv)
@@ -233,6 +485,12 @@ void cv::split(const Mat& src, Mat* mv)
         arrays[k+1] = &mv[k];
     }
 
+    if( splitMergeParallel(src) )
+    {
+        parallel_for_(Range(0, src.rows), SplitInvoker(src, mv, func));
+        return;
+    }
+
     NAryMatIterator it(arrays, ptrs, cn+1);
     int total = (int)it.size, blocksize = cn <= 4 ? total : std::min(total, blocksize0);
 
@@ -321,9 +579,15 @@ void cv::merge(const Mat* mv, size_t n, OutputArray _dst)
     for( k = 0; k < cn; k++ )
         arrays[k+1] = &mv[k];
 
+    MergeFunc func = mergeTab[depth];
+    if( splitMergeParallel(dst) )
+    {
+        parallel_for_(Range(0, dst.rows), MergeInvoker(mv, dst, func));
+        return;
+    }
+
     NAryMatIterator it(arrays, ptrs, cn+1);
     int total = (int)it.size, blocksize = cn <= 4 ? total : std::min(total, blocksize0);
-    MergeFunc func = mergeTab[depth];
 
     for( i = 0; i < it.nplanes; i++, ++it )
     {
@@ -419,6 +683,20 @@ static void mixChannels64s( const int64** src, const int* sdelta,
 typedef void (*MixChannelsFunc)( const uchar** src, const int* sdelta,
         uchar** dst, const int* ddelta, int len, int npairs );
 
+// checks that the channel k of the multi-channel array m is paired with the
+// single-channel array planes[k] of the same size and depth, and with nothing else
+static bool isSplitOrMergePattern( const Mat& m, const Mat* planes, size_t n, const int* fromTo )
+{
+    if( n < 2 || n > 4 || m.depth() > CV_32F )
+        return false;
+    for( size_t k = 0; k < n; k++ )
+        if( fromTo[k*2] != (int)k || fromTo[k*2+1] != (int)k ||
+            planes[k].type() != m.depth() || planes[k].size != m.size ||
+            planes[k].data == m.data )
+            return false;
+    return true;
+}
+
 static MixChannelsFunc mixchTab[] =
 {
     (MixChannelsFunc)mixChannels8u, (MixChannelsFunc)mixChannels8u, (MixChannelsFunc)mixChannels16u,
@@ -437,6 +715,20 @@ void cv::mixChannels( const Mat* src, size_t nsrcs, Mat* dst, size_t ndsts, cons
     size_t i, j, k, esz1 = dst[0].elemSize1();
     int depth = dst[0].depth();
 
+    // pass the plain de-interleaving and interleaving cases to the vectorized split & merge
+    if( nsrcs == 1 && ndsts == npairs && ndsts == (size_t)src[0].channels() &&
+        isSplitOrMergePattern(src[0], dst, ndsts, fromTo) )
+    {
+        split(src[0], dst);
+        return;
+    }
+    if( ndsts == 1 && nsrcs == npairs && nsrcs == (size_t)dst[0].channels() &&
+        isSplitOrMergePattern(dst[0], src, nsrcs, fromTo) )
+    {
+        merge(src, nsrcs, dst[0]);
+        return;
+    }
+
     AutoBuffer<uchar> buf((nsrcs + ndsts + 1)*(sizeof(Mat*) + sizeof(uchar*)) + npairs*(sizeof(uchar*)*2 + sizeof(int)*6));
     const Mat** arrays = (const Mat**)(uchar*)buf;
     uchar** ptrs = (uchar**)(arrays + nsrcs + ndsts);
@@ -822,6 +1114,29 @@ static void cvt##suffix( const stype* src, size_t sstep, const uchar*, size_t, \
     cvt_(src, sstep, dst, dstep, size); \
 }
 
+// the variants that go to the AVX2/AVX-512 kernels when those were selected for the CPU
+#define DEF_CVT_SCALE_FUNC_DISPATCH(suffix, stype, dtype, wtype) \
+static void cvtScale##suffix( const stype* src, size_t sstep, const uchar*, size_t, \
+dtype* dst, size_t dstep, Size size, double* scale) \
+{ \
+    const SIMDKernels* simd = currentSIMDKernels; \
+    if( simd ) \
+        simd->cvtScale##suffix(src, sstep, dst, dstep, size, (float)scale[0], (float)scale[1]); \
+    else \
+        cvtScale_(src, sstep, dst, dstep, size, (wtype)scale[0], (wtype)scale[1]); \
+}
+
+#define DEF_CVT_FUNC_DISPATCH(suffix, stype, dtype) \
+static void cvt##suffix( const stype* src, size_t sstep, const uchar*, size_t, \
+                         dtype* dst, size_t dstep, Size size, double*) \
+{ \
+    const SIMDKernels* simd = currentSIMDKernels; \
+    if( simd ) \
+        simd->cvt##suffix(src, sstep, dst, dstep, size); \
+    else \
+        cvt_(src, sstep, dst, dstep, size); \
+}
+
 #define DEF_CPY_FUNC(suffix, stype) \
 static void cvt##suffix( const stype* src, size_t sstep, const uchar*, size_t, \
 stype* dst, size_t dstep, Size size, double*) \
@@ -843,7 +1158,7 @@ DEF_CVT_SCALE_FUNC(8s8u,   schar, uchar, float);
 DEF_CVT_SCALE_FUNC(16u8u,  ushort, uchar, float);
 DEF_CVT_SCALE_FUNC(16s8u,  short, uchar, float);
 DEF_CVT_SCALE_FUNC(32s8u,  int, uchar, float);
-DEF_CVT_SCALE_FUNC(32f8u,  float, uchar, float);
+DEF_CVT_SCALE_FUNC_DISPATCH(32f8u, float, uchar, float);
 DEF_CVT_SCALE_FUNC(64f8u,  double, uchar, float);
 
 DEF_CVT_SCALE_FUNC(8u8s,   uchar, schar, float);
@@ -878,7 +1193,7 @@ DEF_CVT_SCALE_FUNC(32s,    int, int, double);
 DEF_CVT_SCALE_FUNC(32f32s, float, int, float);
 DEF_CVT_SCALE_FUNC(64f32s, double, int, double);
 
-DEF_CVT_SCALE_FUNC(8u32f,  uchar, float, float);
+DEF_CVT_SCALE_FUNC_DISPATCH(8u32f, uchar, float, float);
 DEF_CVT_SCALE_FUNC(8s32f,  schar, float, float);
 DEF_CVT_SCALE_FUNC(16u32f, ushort, float, float);
 DEF_CVT_SCALE_FUNC(16s32f, short, float, float);
@@ -899,7 +1214,7 @@ DEF_CVT_FUNC(8s8u,   schar, uchar);
 DEF_CVT_FUNC(16u8u,  ushort, uchar);
 DEF_CVT_FUNC(16s8u,  short, uchar);
 DEF_CVT_FUNC(32s8u,  int, uchar);
-DEF_CVT_FUNC(32f8u,  float, uchar);
+DEF_CVT_FUNC_DISPATCH(32f8u, float, uchar);
 DEF_CVT_FUNC(64f8u,  double, uchar);
 
 DEF_CVT_FUNC(8u8s,   uchar, schar);
@@ -914,14 +1229,14 @@ DEF_CVT_FUNC(8s16u,  schar, ushort);
 DEF_CPY_FUNC(16u,    ushort);
 DEF_CVT_FUNC(16s16u, short, ushort);
 DEF_CVT_FUNC(32s16u, int, ushort);
-DEF_CVT_FUNC(32f16u, float, ushort);
+DEF_CVT_FUNC_DISPATCH(32f16u, float, ushort);
 DEF_CVT_FUNC(64f16u, double, ushort);
 
 DEF_CVT_FUNC(8u16s,  uchar, short);
 DEF_CVT_FUNC(8s16s,  schar, short);
 DEF_CVT_FUNC(16u16s, ushort, short);
 DEF_CVT_FUNC(32s16s, int, short);
-DEF_CVT_FUNC(32f16s, float, short);
+DEF_CVT_FUNC_DISPATCH(32f16s, float, short);
 DEF_CVT_FUNC(64f16s, double, short);
 
 DEF_CVT_FUNC(8u32s,  uchar, int);
@@ -932,10 +1247,10 @@ DEF_CPY_FUNC(32s,    int);
 DEF_CVT_FUNC(32f32s, float, int);
 DEF_CVT_FUNC(64f32s, double, int);
 
-DEF_CVT_FUNC(8u32f,  uchar, float);
+DEF_CVT_FUNC_DISPATCH(8u32f, uchar, float);
 DEF_CVT_FUNC(8s32f,  schar, float);
-DEF_CVT_FUNC(16u32f, ushort, float);
-DEF_CVT_FUNC(16s32f, short, float);
+DEF_CVT_FUNC_DISPATCH(16u32f, ushort, float);
+DEF_CVT_FUNC_DISPATCH(16s32f, short, float);
 DEF_CVT_FUNC(32s32f, int, float);
 DEF_CVT_FUNC(64f32f, double, float);
 
@@ -1144,9 +1459,43 @@ LUT8u_( const uchar* src, const T* lut, T* dst, int len, int cn, int lutcn )
     }
 }
 
+// all the lookups of a group are issued before the stores, so that the compiler does not have to
+// serialize them because of the possible aliasing between dst and lut
 static void LUT8u_8u( const uchar* src, const uchar* lut, uchar* dst, int len, int cn, int lutcn )
 {
-    LUT8u_( src, lut, dst, len, cn, lutcn );
+    int i = 0, total = len*cn;
+    if( lutcn == 1 )
+    {
+        for( ; i <= total - 4; i += 4 )
+        {
+            uchar t0 = lut[src[i]], t1 = lut[src[i+1]];
+            uchar t2 = lut[src[i+2]], t3 = lut[src[i+3]];
+            dst[i] = t0; dst[i+1] = t1;
+            dst[i+2] = t2; dst[i+3] = t3;
+        }
+        for( ; i < total; i++ )
+            dst[i] = lut[src[i]];
+    }
+    else if( cn == 3 )
+    {
+        for( ; i < total; i += 3 )
+        {
+            uchar t0 = lut[src[i]*3], t1 = lut[src[i+1]*3+1], t2 = lut[src[i+2]*3+2];
+            dst[i] = t0; dst[i+1] = t1; dst[i+2] = t2;
+        }
+    }
+    else if( cn == 4 )
+    {
+        for( ; i < total; i += 4 )
+        {
+            uchar t0 = lut[src[i]*4], t1 = lut[src[i+1]*4+1];
+            uchar t2 = lut[src[i+2]*4+2], t3 = lut[src[i+3]*4+3];
+            dst[i] = t0; dst[i+1] = t1;
+            dst[i+2] = t2; dst[i+3] = t3;
+        }
+    }
+    else
+        LUT8u_( src, lut, dst, len, cn, lutcn );
 }
 
 static void LUT8u_8s( const uchar* src, const schar* lut, schar* dst, int len, int cn, int lutcn )
@@ -1189,6 +1538,31 @@ static LUTFunc lutTab[] =
 
 }
 
+namespace cv
+{
+
+class LUTParallelBody : public ParallelLoopBody
+{
+public:
+    LUTParallelBody( const Mat& _src, const Mat& _lut, Mat& _dst, LUTFunc _func ) :
+        src(&_src), lut(&_lut), dst(&_dst), func(_func) {}
+
+    void operator()( const Range& range ) const
+    {
+        int cn = src->channels(), lutcn = lut->channels();
+        for( int y = range.start; y < range.end; y++ )
+            func(src->ptr(y), lut->data, dst->ptr(y), src->cols, cn, lutcn);
+    }
+
+private:
+    const Mat* src;
+    const Mat* lut;
+    Mat* dst;
+    LUTFunc func;
+};
+
+}
+
 void cv::LUT( InputArray _src, InputArray _lut, OutputArray _dst )
 {
     Mat src = _src.getMat(), lut = _lut.getMat();
@@ -1204,6 +1578,13 @@ void cv::LUT( InputArray _src, InputArray _lut, OutputArray _dst )
     LUTFunc func = lutTab[lut.depth()];
     CV_Assert( func != 0 );
 
+    // the large 2D images are processed by stripes of rows in parallel
+    if( src.dims <= 2 && src.rows > 1 && (double)src.total()*cn >= 1 << 16 )
+    {
+        parallel_for_(Range(0, src.rows), LUTParallelBody(src, lut, dst, func));
+        return;
+    }
+
     const Mat* arrays[] = {&src, &dst, 0};
     uchar* ptrs[2];
     NAryMatIterator it(arrays, ptrs);
@@ -1213,6 +1594,134 @@ void cv::LUT( InputArray _src, InputArray _lut, OutputArray _dst )
         func(ptrs[0], lut.data, ptrs[1], len, cn, lutcn);
 }
 
+/****************************************************************************************\
+*                                   LUT Pipeline                                         *
+\****************************************************************************************/
+
+cv::LUTPipeline::LUTPipeline(int _channels)
+{
+    CV_Assert( 1 <= _channels && _channels <= CV_CN_MAX );
+    tab.create(1, 256, CV_8UC(_channels));
+    reset();
+}
+
+void cv::LUTPipeline::reset()
+{
+    int cn = tab.channels();
+    uchar* t = tab.data;
+    for( int i = 0; i < 256; i++ )
+        for( int k = 0; k < cn; k++ )
+            t[i*cn + k] = (uchar)i;
+}
+
+int cv::LUTPipeline::channels() const
+{
+    return tab.channels();
+}
+
+const cv::Mat& cv::LUTPipeline::table() const
+{
+    return tab;
+}
+
+namespace cv
+{
+
+// composes the table of the selected channel(s) with the 256-entry mapping f
+static void composeLUT( Mat& tab, const uchar* f, int channel )
+{
+    int cn = tab.channels();
+    CV_Assert( -1 <= channel && channel < cn );
+    int k0 = channel < 0 ? 0 : channel, k1 = channel < 0 ? cn : channel + 1;
+    uchar* t = tab.data;
+    for( int i = 0; i < 256; i++ )
+        for( int k = k0; k < k1; k++ )
+            t[i*cn + k] = f[t[i*cn + k]];
+}
+
+}
+
+cv::LUTPipeline& cv::LUTPipeline::gamma(double g, int channel)
+{
+    CV_Assert( g > 0 );
+    uchar f[256];
+    for( int i = 0; i < 256; i++ )
+        f[i] = saturate_cast<uchar>(std::pow(i*(1./255), g)*255.);
+    composeLUT(tab, f, channel);
+    return *this;
+}
+
+cv::LUTPipeline& cv::LUTPipeline::contrast(double alpha, double beta, int channel)
+{
+    // the same single-precision arithmetic as in convertTo() of 8-bit images
+    float a = (float)alpha, b = (float)beta;
+    uchar f[256];
+    for( int i = 0; i < 256; i++ )
+        f[i] = saturate_cast<uchar>(i*a + b);
+    composeLUT(tab, f, channel);
+    return *this;
+}
+
+cv::LUTPipeline& cv::LUTPipeline::scaleAbs(double alpha, double beta, int channel)
+{
+    // the same single-precision arithmetic as in cvtScaleAbs_
+    float a = (float)alpha, b = (float)beta;
+    uchar f[256];
+    for( int i = 0; i < 256; i++ )
+        f[i] = saturate_cast<uchar>(std::abs(i*a + b));
+    composeLUT(tab, f, channel);
+    return *this;
+}
+
+cv::LUTPipeline& cv::LUTPipeline::threshold(double thresh, double maxval, int type, int channel)
+{
+    // the same rounding of the parameters as in threshold() for 8-bit images
+    int ithresh = cvFloor(thresh);
+    int imaxval = saturate_cast<uchar>(type == THRESH_TRUNC ? ithresh : cvRound(maxval));
+    uchar f[256];
+
+    for( int i = 0; i < 256; i++ )
+    {
+        bool above = i > ithresh;
+        int v;
+        switch( type )
+        {
+        case THRESH_BINARY: v = above ? imaxval : 0; break;
+        case THRESH_BINARY_INV: v = above ? 0 : imaxval; break;
+        case THRESH_TRUNC: v = above ? imaxval : i; break;
+        case THRESH_TOZERO: v = above ? i : 0; break;
+        case THRESH_TOZERO_INV: v = above ? 0 : i; break;
+        default:
+            CV_Error( CV_StsBadArg, "Unknown threshold type" );
+            v = 0;
+        }
+        f[i] = (uchar)v;
+    }
+    composeLUT(tab, f, channel);
+    return *this;
+}
+
+cv::LUTPipeline& cv::LUTPipeline::lut(InputArray _lut)
+{
+    Mat l = _lut.getMat();
+    int cn = tab.channels(), lutcn = l.channels();
+    CV_Assert( l.depth() == CV_8U && l.total() == 256 && l.isContinuous() &&
+               (lutcn == 1 || lutcn == cn) );
+
+    uchar* t = tab.data;
+    const uchar* f = l.data;
+    for( int i = 0; i < 256; i++ )
+        for( int k = 0; k < cn; k++ )
+            t[i*cn + k] = lutcn == 1 ? f[t[i*cn + k]] : f[t[i*cn + k]*cn + k];
+    return *this;
+}
+
+void cv::LUTPipeline::apply(InputArray src, OutputArray dst) const
+{
+    CV_Assert( src.depth() == CV_8U && (src.channels() == tab.channels() || tab.channels() == 1) );
+    LUT(src, tab, dst);
+}
+
 
 void cv::normalize( InputArray _src, OutputArray _dst, double a, double b,
                     int norm_type, int rtype, InputArray _mask )
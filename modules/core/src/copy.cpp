@@ -379,10 +379,71 @@ Mat& Mat::setTo(InputArray _value, InputArray _mask)
 }
 
 
+#if CV_SSE2
+// reverses the order of the 16/esz elements of v
+static inline __m128i flipBlock( __m128i v, size_t esz )
+{
+    if( esz == 8 )
+        return _mm_shuffle_epi32(v, _MM_SHUFFLE(1,0,3,2));
+    if( esz == 4 )
+        return _mm_shuffle_epi32(v, _MM_SHUFFLE(0,1,2,3));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0,1,2,3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0,1,2,3));
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1,0,3,2));
+    if( esz == 1 )
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    return v;
+}
+#endif
+
+// exchanges the elements of cn values of type T from both ends of the row
+template<typename T, int cn> static void
+flipHorizRow_( const uchar* _src, uchar* _dst, int width )
+{
+    const T* src = (const T*)_src;
+    T* dst = (T*)_dst;
+
+    for( int i = 0, j = (width - 1)*cn; i < j; i += cn, j -= cn )
+        for( int k = 0; k < cn; k++ )
+        {
+            T t0 = src[i + k], t1 = src[j + k];
+            dst[i + k] = t1; dst[j + k] = t0;
+        }
+    if( width & 1 )
+        for( int k = 0, i = (width/2)*cn; k < cn; k++ )
+            dst[i + k] = src[i + k];
+}
+
+typedef void (*FlipHorizRowFunc)( const uchar* src, uchar* dst, int width );
+
+// dstep may be negative, flip() writes the rows bottom-up to flip around both axes
 static void
-flipHoriz( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size size, size_t esz )
+flipHoriz( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size size, size_t esz )
 {
     int i, j, limit = (int)(((size.width + 1)/2)*esz);
+    int width = (int)(size.width*esz);
+#if CV_SSE2
+    bool useSIMD = USE_SSE2 && (esz == 1 || esz == 2 || esz == 4 || esz == 8);
+#endif
+
+    // the multi-channel elements are moved as a whole when the rows are aligned
+    FlipHorizRowFunc rowFunc = 0;
+    size_t align = ((size_t)src | (size_t)dst | (size_t)sstep | (size_t)dstep);
+    if( esz == 3 )
+        rowFunc = flipHorizRow_<uchar, 3>;
+    else if( esz == 6 && align % sizeof(ushort) == 0 )
+        rowFunc = flipHorizRow_<ushort, 3>;
+    else if( esz % sizeof(int) == 0 && esz > 8 && align % sizeof(int) == 0 )
+        rowFunc = esz == 12 ? flipHorizRow_<int, 3> : esz == 16 ? flipHorizRow_<int, 4> :
+                  esz == 24 ? flipHorizRow_<int, 6> : esz == 32 ? flipHorizRow_<int, 8> : 0;
+
+    if( rowFunc )
+    {
+        for( ; size.height--; src += sstep, dst += dstep )
+            rowFunc( src, dst, size.width );
+        return;
+    }
+
     AutoBuffer<int> _tab(size.width*esz);
     int* tab = _tab;
 
@@ -392,7 +453,19 @@ flipHoriz( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size size,
 
     for( ; size.height--; src += sstep, dst += dstep )
     {
-        for( i = 0; i < limit; i++ )
+        i = 0;
+#if CV_SSE2
+        // exchange the reversed 16-byte blocks from both ends of the row
+        if( useSIMD )
+            for( ; i <= width/2 - 16; i += 16 )
+            {
+                __m128i v0 = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i v1 = _mm_loadu_si128((const __m128i*)(src + width - i - 16));
+                _mm_storeu_si128((__m128i*)(dst + i), flipBlock(v1, esz));
+                _mm_storeu_si128((__m128i*)(dst + width - i - 16), flipBlock(v0, esz));
+            }
+#endif
+        for( ; i < limit; i++ )
         {
             j = tab[i];
             uchar t0 = src[i], t1 = src[j];
@@ -412,6 +485,16 @@ flipVert( const uchar* src0, size_t sstep, uchar* dst0, size_t dstep, Size size,
                                                   dst0 += dstep, dst1 -= dstep )
     {
         int i = 0;
+#if CV_SSE2
+        if( USE_SSE2 )
+            for( ; i <= size.width - 16; i += 16 )
+            {
+                __m128i t0 = _mm_loadu_si128((const __m128i*)(src0 + i));
+                __m128i t1 = _mm_loadu_si128((const __m128i*)(src1 + i));
+                _mm_storeu_si128((__m128i*)(dst0 + i), t1);
+                _mm_storeu_si128((__m128i*)(dst1 + i), t0);
+            }
+#endif
         if( ((size_t)src0|(size_t)dst0|(size_t)src1|(size_t)dst1) % sizeof(int) == 0 )
         {
             for( ; i <= size.width - 16; i += 16 )
@@ -471,13 +554,18 @@ void flip( InputArray _src, OutputArray _dst, int flip_mode )
     Mat dst = _dst.getMat();
     size_t esz = src.elemSize();
 
-    if( flip_mode <= 0 )
+    if( flip_mode < 0 && src.data != dst.data && src.rows > 0 )
+        // flip around both axes in one pass, the rows are written bottom-up
+        flipHoriz( src.data, src.step, dst.data + dst.step*(dst.rows - 1), -(ptrdiff_t)dst.step,
+                   src.size(), esz );
+    else if( flip_mode <= 0 )
+    {
         flipVert( src.data, src.step, dst.data, dst.step, src.size(), esz );
+        if( flip_mode < 0 )
+            flipHoriz( dst.data, dst.step, dst.data, dst.step, dst.size(), esz );
+    }
     else
         flipHoriz( src.data, src.step, dst.data, dst.step, src.size(), esz );
-
-    if( flip_mode < 0 )
-        flipHoriz( dst.data, dst.step, dst.data, dst.step, dst.size(), esz );
 }
 
 
@@ -55,21 +55,34 @@ struct PolyEdge
     PolyEdge *next;
 };
 
+/*
+ The internal drawing functions take the optional range of rows that they are allowed to modify.
+ The geometry (clipping etc.) is always computed for the whole image, so drawing a primitive band by band
+ produces exactly the same pixels as drawing it at once (see DrawingBatch).
+*/
+static inline Range clipRows( const Mat& img, const Range& rows )
+{
+    return Range( std::max(rows.start, 0), std::min(rows.end, img.rows) );
+}
+
 static void
 CollectPolyEdges( Mat& img, const Point* v, int npts,
                   std::vector<PolyEdge>& edges, const void* color, int line_type,
-                  int shift, Point offset=Point() );
+                  int shift, Point offset=Point(), const Range& rows=Range::all() );
 
 static void
-FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color );
+FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color,
+                    const Range& rows=Range::all() );
 
 static void
 PolyLine( Mat& img, const Point* v, int npts, bool closed,
-          const void* color, int thickness, int line_type, int shift );
+          const void* color, int thickness, int line_type, int shift,
+          const Range& rows=Range::all() );
 
 static void
 FillConvexPoly( Mat& img, const Point* v, int npts,
-                const void* color, int line_type, int shift );
+                const void* color, int line_type, int shift,
+                const Range& rows=Range::all() );
 
 /****************************************************************************************\
 *                                   Lines                                                *
@@ -235,7 +248,7 @@ LineIterator::LineIterator(const Mat& img, Point pt1, Point pt2,
 
 static void
 Line( Mat& img, Point pt1, Point pt2,
-      const void* _color, int connectivity = 8 )
+      const void* _color, int connectivity = 8, const Range& rows = Range::all() )
 {
     if( connectivity == 0 )
         connectivity = 8;
@@ -246,10 +259,22 @@ Line( Mat& img, Point pt1, Point pt2,
     int i, count = iterator.count;
     int pix_size = (int)img.elemSize();
     const uchar* color = (const uchar*)_color;
+    Range r = clipRows(img, rows);
+    const uchar* row0 = img.data + r.start*img.step;
+    const uchar* row1 = img.data + r.end*img.step;
+    bool inside = false;
 
     for( i = 0; i < count; i++, ++iterator )
     {
         uchar* ptr = *iterator;
+        // the line is monotonic in y, so it can not come back once it has left the rows
+        if( ptr < row0 || ptr >= row1 )
+        {
+            if( inside )
+                break;
+            continue;
+        }
+        inside = true;
         if( pix_size == 1 )
             ptr[0] = color[0];
         else if( pix_size == 3 )
@@ -279,7 +304,7 @@ static const int FilterTable[] = {
 };
 
 static void
-LineAA( Mat& img, Point pt1, Point pt2, const void* color )
+LineAA( Mat& img, Point pt1, Point pt2, const void* color, const Range& rows = Range::all() )
 {
     int dx, dy;
     int ecount, scount = 0;
@@ -294,10 +319,13 @@ LineAA( Mat& img, Point pt1, Point pt2, const void* color )
     uchar* ptr = img.data;
     size_t step = img.step;
     Size size = img.size();
+    Range r = clipRows(img, rows);
+    const uchar* row0 = img.data + r.start*step;
+    const uchar* row1 = img.data + r.end*step;
 
     if( !((nch == 1 || nch == 3) && img.depth() == CV_8U) )
     {
-        Line(img, pt1, pt2, color);
+        Line(img, pt1, pt2, color, 8, rows);
         return;
     }
 
@@ -391,6 +419,7 @@ LineAA( Mat& img, Point pt1, Point pt2, const void* color )
     if( nch == 3 )
     {
         #define  ICV_PUT_POINT()            \
+        if( tptr >= row0 && tptr < row1 )   \
         {                                   \
             _cb = tptr[0];                  \
             _cb += ((cb - _cb)*a + 127)>> 8;\
@@ -471,6 +500,7 @@ LineAA( Mat& img, Point pt1, Point pt2, const void* color )
     else
     {
         #define  ICV_PUT_POINT()            \
+        if( tptr >= row0 && tptr < row1 )   \
         {                                   \
             _cb = tptr[0];                  \
             _cb += ((cb - _cb)*a + 127)>> 8;\
@@ -547,7 +577,7 @@ LineAA( Mat& img, Point pt1, Point pt2, const void* color )
 
 
 static void
-Line2( Mat& img, Point pt1, Point pt2, const void* color )
+Line2( Mat& img, Point pt1, Point pt2, const void* color, const Range& rows = Range::all() )
 {
     int dx, dy;
     int ecount;
@@ -561,6 +591,7 @@ Line2( Mat& img, Point pt1, Point pt2, const void* color )
     uchar *ptr = img.data, *tptr;
     size_t step = img.step;
     Size size = img.size(), sizeScaled(size.width*XY_ONE, size.height*XY_ONE);
+    Range r = clipRows(img, rows);
 
     //assert( img && (nch == 1 || nch == 3) && img.depth() == CV_8U );
 
@@ -614,7 +645,7 @@ Line2( Mat& img, Point pt1, Point pt2, const void* color )
         #define  ICV_PUT_POINT(_x,_y)   \
         x = (_x); y = (_y);             \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            r.start <= y && y < r.end ) \
         {                               \
             tptr = ptr + y*step + x*3;  \
             tptr[0] = (uchar)cb;        \
@@ -657,7 +688,7 @@ Line2( Mat& img, Point pt1, Point pt2, const void* color )
         #define  ICV_PUT_POINT(_x,_y) \
         x = (_x); y = (_y);           \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            r.start <= y && y < r.end ) \
         {                           \
             tptr = ptr + y*step + x;\
             tptr[0] = (uchar)cb;    \
@@ -698,7 +729,7 @@ Line2( Mat& img, Point pt1, Point pt2, const void* color )
         #define  ICV_PUT_POINT(_x,_y)   \
         x = (_x); y = (_y);             \
         if( 0 <= x && x < size.width && \
-            0 <= y && y < size.height ) \
+            r.start <= y && y < r.end ) \
         {                               \
             tptr = ptr + y*step + x*pix_size;\
             for( j = 0; j < pix_size; j++ ) \
@@ -900,7 +931,8 @@ void ellipse2Poly( Point center, Size axes, int angle,
 static void
 EllipseEx( Mat& img, Point center, Size axes,
            int angle, int arc_start, int arc_end,
-           const void* color, int thickness, int line_type )
+           const void* color, int thickness, int line_type,
+           const Range& rows = Range::all() )
 {
     axes.width = std::abs(axes.width), axes.height = std::abs(axes.height);
     int delta = (std::max(axes.width,axes.height)+(XY_ONE>>1))>>XY_SHIFT;
@@ -910,15 +942,15 @@ EllipseEx( Mat& img, Point center, Size axes,
     ellipse2Poly( center, axes, angle, arc_start, arc_end, delta, v );
 
     if( thickness >= 0 )
-        PolyLine( img, &v[0], (int)v.size(), false, color, thickness, line_type, XY_SHIFT );
+        PolyLine( img, &v[0], (int)v.size(), false, color, thickness, line_type, XY_SHIFT, rows );
     else if( arc_end - arc_start >= 360 )
-        FillConvexPoly( img, &v[0], (int)v.size(), color, line_type, XY_SHIFT );
+        FillConvexPoly( img, &v[0], (int)v.size(), color, line_type, XY_SHIFT, rows );
     else
     {
         v.push_back(center);
         std::vector<PolyEdge> edges;
-        CollectPolyEdges( img,  &v[0], (int)v.size(), edges, color, line_type, XY_SHIFT );
-        FillEdgeCollection( img, edges, color );
+        CollectPolyEdges( img,  &v[0], (int)v.size(), edges, color, line_type, XY_SHIFT, Point(), rows );
+        FillEdgeCollection( img, edges, color, rows );
     }
 }
 
@@ -927,26 +959,56 @@ EllipseEx( Mat& img, Point center, Size axes,
 *                                Polygons filling                                        *
 \****************************************************************************************/
 
-/* helper macros: filling horizontal row */
-#define ICV_HLINE( ptr, xl, xr, color, pix_size )            \
-{                                                            \
-    uchar* hline_ptr = (uchar*)(ptr) + (xl)*(pix_size);      \
-    uchar* hline_max_ptr = (uchar*)(ptr) + (xr)*(pix_size);  \
-                                                             \
-    for( ; hline_ptr <= hline_max_ptr; hline_ptr += (pix_size))\
-    {                                                        \
-        int hline_j;                                         \
-        for( hline_j = 0; hline_j < (pix_size); hline_j++ )  \
-        {                                                    \
-            hline_ptr[hline_j] = ((uchar*)color)[hline_j];   \
-        }                                                    \
-    }                                                        \
+/* fills the horizontal span [xl, xr] of the image row with the color */
+static inline void
+HLine( uchar* ptr, int xl, int xr, const void* color, int pix_size )
+{
+    if( xl > xr )
+        return;
+
+    const uchar* c = (const uchar*)color;
+    uchar* hline_ptr = ptr + xl*pix_size;
+    int i = 0, j, len = (xr - xl + 1)*pix_size;
+
+    if( pix_size == 1 )
+    {
+        memset( hline_ptr, c[0], len );
+        return;
+    }
+
+#if CV_SSE2
+    // 48 bytes hold a whole number of pixels for all the pixel sizes dividing 48 (2, 3, 4, 6, 8, 12, 16, 24),
+    // so the span is filled with the same 3 vectors
+    if( USE_SSE2 && len >= 48 && 48 % pix_size == 0 )
+    {
+        uchar CV_DECL_ALIGNED(16) pattern[48];
+        for( j = 0; j < 48; j += pix_size )
+            memcpy( pattern + j, c, pix_size );
+        __m128i v0 = _mm_load_si128((const __m128i*)pattern);
+        __m128i v1 = _mm_load_si128((const __m128i*)(pattern + 16));
+        __m128i v2 = _mm_load_si128((const __m128i*)(pattern + 32));
+
+        for( ; i <= len - 48; i += 48 )
+        {
+            _mm_storeu_si128((__m128i*)(hline_ptr + i), v0);
+            _mm_storeu_si128((__m128i*)(hline_ptr + i + 16), v1);
+            _mm_storeu_si128((__m128i*)(hline_ptr + i + 32), v2);
+        }
+        memcpy( hline_ptr + i, pattern, len - i );
+        return;
+    }
+#endif
+
+    for( ; i < len; i += pix_size )
+        for( j = 0; j < pix_size; j++ )
+            hline_ptr[i + j] = c[j];
 }
 
 
 /* filling convex polygon. v - array of vertices, ntps - number of points */
 static void
-FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_type, int shift )
+FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_type, int shift,
+                const Range& rows )
 {
     struct
     {
@@ -964,6 +1026,7 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
     int pix_size = (int)img.elemSize();
     Point p0;
     int delta1, delta2;
+    Range r = clipRows(img, rows);
 
     if( line_type < CV_AA )
         delta1 = delta2 = XY_ONE >> 1;
@@ -1003,13 +1066,13 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
                 pt0.y = p0.y >> XY_SHIFT;
                 pt1.x = p.x >> XY_SHIFT;
                 pt1.y = p.y >> XY_SHIFT;
-                Line( img, pt0, pt1, color, line_type );
+                Line( img, pt0, pt1, color, line_type, rows );
             }
             else
-                Line2( img, p0, p, color );
+                Line2( img, p0, p, color, rows );
         }
         else
-            LineAA( img, p0, p, color );
+            LineAA( img, p0, p, color, rows );
         p0 = p;
     }
 
@@ -1018,10 +1081,12 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
     ymin = (ymin + delta) >> shift;
     ymax = (ymax + delta) >> shift;
 
-    if( npts < 3 || xmax < 0 || ymax < 0 || xmin >= size.width || ymin >= size.height )
+    if( npts < 3 || xmax < 0 || ymax < r.start || xmin >= size.width || ymin >= r.end )
         return;
 
+    // the last row is processed differently in the antialiased mode, so it must not depend on the rows range
     ymax = MIN( ymax, size.height - 1 );
+    int yend = MIN( ymax, r.end - 1 );
     edge[0].idx = edge[1].idx = imin;
 
     edge[0].ye = edge[1].ye = y = ymin;
@@ -1077,7 +1142,7 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
         x1 = edge[left].x;
         x2 = edge[right].x;
 
-        if( y >= 0 )
+        if( y >= r.start )
         {
             int xx1 = (x1 + delta1) >> XY_SHIFT;
             int xx2 = (x2 + delta2) >> XY_SHIFT;
@@ -1088,7 +1153,7 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
                     xx1 = 0;
                 if( xx2 >= size.width )
                     xx2 = size.width - 1;
-                ICV_HLINE( ptr, xx1, xx2, color, pix_size );
+                HLine( ptr, xx1, xx2, color, pix_size );
             }
         }
 
@@ -1099,7 +1164,7 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
         edge[right].x = x2;
         ptr += img.step;
     }
-    while( ++y <= ymax );
+    while( ++y <= yend );
 }
 
 
@@ -1107,7 +1172,7 @@ FillConvexPoly( Mat& img, const Point* v, int npts, const void* color, int line_
 
 static void
 CollectPolyEdges( Mat& img, const Point* v, int count, std::vector<PolyEdge>& edges,
-                  const void* color, int line_type, int shift, Point offset )
+                  const void* color, int line_type, int shift, Point offset, const Range& rows )
 {
     int i, delta = offset.y + (shift ? 1 << (shift - 1) : 0);
     Point pt0 = v[count-1], pt1;
@@ -1130,14 +1195,14 @@ CollectPolyEdges( Mat& img, const Point* v, int count, std::vector<PolyEdge>& ed
             t0.y = pt0.y; t1.y = pt1.y;
             t0.x = (pt0.x + (XY_ONE >> 1)) >> XY_SHIFT;
             t1.x = (pt1.x + (XY_ONE >> 1)) >> XY_SHIFT;
-            Line( img, t0, t1, color, line_type );
+            Line( img, t0, t1, color, line_type, rows );
         }
         else
         {
             t0.x = pt0.x; t1.x = pt1.x;
             t0.y = pt0.y << XY_SHIFT;
             t1.y = pt1.y << XY_SHIFT;
-            LineAA( img, t0, t1, color );
+            LineAA( img, t0, t1, color, rows );
         }
 
         if( pt0.y == pt1.y )
@@ -1172,11 +1237,12 @@ struct CmpEdges
 /**************** helper macros and functions for sequence/contour processing ***********/
 
 static void
-FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
+FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color, const Range& rows )
 {
     PolyEdge tmp;
     int i, y, total = (int)edges.size();
     Size size = img.size();
+    Range r = clipRows(img, rows);
     PolyEdge* e;
     int y_max = INT_MIN, x_max = INT_MIN, y_min = INT_MAX, x_min = INT_MAX;
     int pix_size = (int)img.elemSize();
@@ -1194,7 +1260,7 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
         x_max = std::max( x_max, e1.x );
     }
 
-    if( y_max < 0 || y_min >= size.height || x_max < 0 || x_min >= (size.width<<XY_SHIFT) )
+    if( y_max < r.start || y_min >= r.end || x_max < 0 || x_min >= (size.width<<XY_SHIFT) )
         return;
 
     std::sort( edges.begin(), edges.end(), CmpEdges() );
@@ -1206,14 +1272,14 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
     i = 0;
     tmp.next = 0;
     e = &edges[i];
-    y_max = MIN( y_max, size.height );
+    y_max = MIN( y_max, r.end );
 
     for( y = e->y0; y < y_max; y++ )
     {
         PolyEdge *last, *prelast, *keep_prelast;
         int sort_flag = 0;
         int draw = 0;
-        int clipline = y < 0;
+        int clipline = y < r.start;
 
         prelast = &tmp;
         last = tmp.next;
@@ -1271,7 +1337,7 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
                             x1 = 0;
                         if( x2 >= size.width )
                             x2 = size.width - 1;
-                        ICV_HLINE( timg, x1, x2, color, pix_size );
+                        HLine( timg, x1, x2, color, pix_size );
                     }
                 }
                 keep_prelast->x += keep_prelast->dx;
@@ -1316,15 +1382,18 @@ FillEdgeCollection( Mat& img, std::vector<PolyEdge>& edges, const void* color )
 
 /* draws simple or filled circle */
 static void
-Circle( Mat& img, Point center, int radius, const void* color, int fill )
+Circle( Mat& img, Point center, int radius, const void* color, int fill,
+        const Range& rows = Range::all() )
 {
     Size size = img.size();
     size_t step = img.step;
     int pix_size = (int)img.elemSize();
     uchar* ptr = img.data;
     int err = 0, dx = radius, dy = 0, plus = 1, minus = (radius << 1) - 1;
+    Range r = clipRows(img, rows);
     int inside = center.x >= radius && center.x < size.width - radius &&
-        center.y >= radius && center.y < size.height - radius;
+        center.y >= r.start + radius && center.y < r.end - radius;
+    unsigned nrows = (unsigned)std::max(r.end - r.start, 0);
 
     #define ICV_PUT_POINT( ptr, x )     \
         memcpy( ptr + (x)*pix_size, color, pix_size );
@@ -1349,8 +1418,8 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
             }
             else
             {
-                ICV_HLINE( tptr0, x11, x12, color, pix_size );
-                ICV_HLINE( tptr1, x11, x12, color, pix_size );
+                HLine( tptr0, x11, x12, color, pix_size );
+                HLine( tptr1, x11, x12, color, pix_size );
             }
 
             tptr0 = ptr + y21 * step;
@@ -1365,11 +1434,11 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
             }
             else
             {
-                ICV_HLINE( tptr0, x21, x22, color, pix_size );
-                ICV_HLINE( tptr1, x21, x22, color, pix_size );
+                HLine( tptr0, x21, x22, color, pix_size );
+                HLine( tptr1, x21, x22, color, pix_size );
             }
         }
-        else if( x11 < size.width && x12 >= 0 && y21 < size.height && y22 >= 0 )
+        else if( x11 < size.width && x12 >= 0 && y21 < r.end && y22 >= r.start )
         {
             if( fill )
             {
@@ -1377,7 +1446,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                 x12 = MIN( x12, size.width - 1 );
             }
 
-            if( (unsigned)y11 < (unsigned)size.height )
+            if( (unsigned)(y11 - r.start) < nrows )
             {
                 uchar *tptr = ptr + y11 * step;
 
@@ -1389,10 +1458,10 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                         ICV_PUT_POINT( tptr, x12 );
                 }
                 else
-                    ICV_HLINE( tptr, x11, x12, color, pix_size );
+                    HLine( tptr, x11, x12, color, pix_size );
             }
 
-            if( (unsigned)y12 < (unsigned)size.height )
+            if( (unsigned)(y12 - r.start) < nrows )
             {
                 uchar *tptr = ptr + y12 * step;
 
@@ -1404,7 +1473,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                         ICV_PUT_POINT( tptr, x12 );
                 }
                 else
-                    ICV_HLINE( tptr, x11, x12, color, pix_size );
+                    HLine( tptr, x11, x12, color, pix_size );
             }
 
             if( x21 < size.width && x22 >= 0 )
@@ -1415,7 +1484,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                     x22 = MIN( x22, size.width - 1 );
                 }
 
-                if( (unsigned)y21 < (unsigned)size.height )
+                if( (unsigned)(y21 - r.start) < nrows )
                 {
                     uchar *tptr = ptr + y21 * step;
 
@@ -1427,10 +1496,10 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                             ICV_PUT_POINT( tptr, x22 );
                     }
                     else
-                        ICV_HLINE( tptr, x21, x22, color, pix_size );
+                        HLine( tptr, x21, x22, color, pix_size );
                 }
 
-                if( (unsigned)y22 < (unsigned)size.height )
+                if( (unsigned)(y22 - r.start) < nrows )
                 {
                     uchar *tptr = ptr + y22 * step;
 
@@ -1442,7 +1511,7 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
                             ICV_PUT_POINT( tptr, x22 );
                     }
                     else
-                        ICV_HLINE( tptr, x21, x22, color, pix_size );
+                        HLine( tptr, x21, x22, color, pix_size );
                 }
             }
         }
@@ -1463,7 +1532,8 @@ Circle( Mat& img, Point center, int radius, const void* color, int fill )
 
 static void
 ThickLine( Mat& img, Point p0, Point p1, const void* color,
-           int thickness, int line_type, int flags, int shift )
+           int thickness, int line_type, int flags, int shift,
+           const Range& rows = Range::all() )
 {
     static const double INV_XY_ONE = 1./XY_ONE;
 
@@ -1482,13 +1552,13 @@ ThickLine( Mat& img, Point p0, Point p1, const void* color,
                 p0.y = (p0.y + (XY_ONE>>1)) >> XY_SHIFT;
                 p1.x = (p1.x + (XY_ONE>>1)) >> XY_SHIFT;
                 p1.y = (p1.y + (XY_ONE>>1)) >> XY_SHIFT;
-                Line( img, p0, p1, color, line_type );
+                Line( img, p0, p1, color, line_type, rows );
             }
             else
-                Line2( img, p0, p1, color );
+                Line2( img, p0, p1, color, rows );
         }
         else
-            LineAA( img, p0, p1, color );
+            LineAA( img, p0, p1, color, rows );
     }
     else
     {
@@ -1513,7 +1583,7 @@ ThickLine( Mat& img, Point p0, Point p1, const void* color,
             pt[3].x = p1.x + dp.x;
             pt[3].y = p1.y + dp.y;
 
-            FillConvexPoly( img, pt, 4, color, line_type, XY_SHIFT );
+            FillConvexPoly( img, pt, 4, color, line_type, XY_SHIFT, rows );
         }
 
         for( i = 0; i < 2; i++ )
@@ -1525,12 +1595,12 @@ ThickLine( Mat& img, Point p0, Point p1, const void* color,
                     Point center;
                     center.x = (p0.x + (XY_ONE>>1)) >> XY_SHIFT;
                     center.y = (p0.y + (XY_ONE>>1)) >> XY_SHIFT;
-                    Circle( img, center, (thickness + (XY_ONE>>1)) >> XY_SHIFT, color, 1 );
+                    Circle( img, center, (thickness + (XY_ONE>>1)) >> XY_SHIFT, color, 1, rows );
                 }
                 else
                 {
                     EllipseEx( img, p0, cvSize(thickness, thickness),
-                               0, 0, 360, color, -1, line_type );
+                               0, 0, 360, color, -1, line_type, rows );
                 }
             }
             p0 = p1;
@@ -1542,7 +1612,7 @@ ThickLine( Mat& img, Point p0, Point p1, const void* color,
 static void
 PolyLine( Mat& img, const Point* v, int count, bool is_closed,
           const void* color, int thickness,
-          int line_type, int shift )
+          int line_type, int shift, const Range& rows )
 {
     if( !v || count <= 0 )
         return;
@@ -1556,7 +1626,7 @@ PolyLine( Mat& img, const Point* v, int count, bool is_closed,
     for( i = !is_closed; i < count; i++ )
     {
         Point p = v[i];
-        ThickLine( img, p0, p, color, thickness, line_type, flags, shift );
+        ThickLine( img, p0, p, color, thickness, line_type, flags, shift, rows );
         p0 = p;
         flags = 2;
     }
@@ -1916,22 +1986,17 @@ static const int* getFontData(int fontFace)
 }
 
 
-void putText( Mat& img, const String& text, Point org,
-              int fontFace, double fontScale, Scalar color,
-              int thickness, int line_type, bool bottomLeftOrigin )
-
+/* converts the text string into the polylines with XY_SHIFT fractional bits;
+   npts receives the number of points in each polyline */
+static void
+TextToPolylines( const String& text, Point org, int fontFace, double fontScale,
+                 bool bottomLeftOrigin, std::vector<Point>& allpts, std::vector<int>& npts )
 {
     const int* ascii = getFontData(fontFace);
 
-    double buf[4];
-    scalarToRawData(color, buf, img.type(), 0);
-
     int base_line = -(ascii[0] & 15);
     int hscale = cvRound(fontScale*XY_ONE), vscale = hscale;
 
-    if( line_type == CV_AA && img.depth() != CV_8U )
-        line_type = 8;
-
     if( bottomLeftOrigin )
         vscale = -vscale;
 
@@ -1961,7 +2026,10 @@ void putText( Mat& img, const String& text, Point org,
             if( *ptr == ' ' || !*ptr )
             {
                 if( pts.size() > 1 )
-                    PolyLine( img, &pts[0], (int)pts.size(), false, buf, thickness, line_type, XY_SHIFT );
+                {
+                    allpts.insert( allpts.end(), pts.begin(), pts.end() );
+                    npts.push_back( (int)pts.size() );
+                }
                 if( !*ptr++ )
                     break;
                 pts.resize(0);
@@ -1978,6 +2046,25 @@ void putText( Mat& img, const String& text, Point org,
     }
 }
 
+void putText( Mat& img, const String& text, Point org,
+              int fontFace, double fontScale, Scalar color,
+              int thickness, int line_type, bool bottomLeftOrigin )
+
+{
+    std::vector<Point> pts;
+    std::vector<int> npts;
+    TextToPolylines( text, org, fontFace, fontScale, bottomLeftOrigin, pts, npts );
+
+    double buf[4];
+    scalarToRawData(color, buf, img.type(), 0);
+
+    if( line_type == CV_AA && img.depth() != CV_8U )
+        line_type = 8;
+
+    for( size_t i = 0, ofs = 0; i < npts.size(); ofs += npts[i++] )
+        PolyLine( img, &pts[ofs], npts[i], false, buf, thickness, line_type, XY_SHIFT );
+}
+
 Size getTextSize( const String& text, int fontFace, double fontScale, int thickness, int* _base_line)
 {
     Size size;
@@ -2009,6 +2096,241 @@ Size getTextSize( const String& text, int fontFace, double fontScale, int thickn
     return size;
 }
 
+/****************************************************************************************\
+*                                 Batched drawing                                        *
+\****************************************************************************************/
+
+enum { DRAW_POLYLINE = 0, DRAW_FILL_CONVEX = 1, DRAW_FILL_POLY = 2, DRAW_CIRCLE = 3 };
+
+DrawingBatch::DrawingBatch() {}
+
+void DrawingBatch::addPrimitive( int kind, const Point* v, int count, int radius, bool closed,
+                                 const Scalar& color, int thickness, int lineType, int shift )
+{
+    CV_Assert( 0 <= shift && shift <= XY_SHIFT && thickness <= 255 );
+    if( !v || count <= 0 )
+        return;
+
+    Primitive prim;
+    prim.kind = kind;
+    prim.ofs = (int)pts.size();
+    prim.count = count;
+    prim.radius = radius;
+    prim.thickness = thickness;
+    prim.lineType = lineType;
+    prim.shift = shift;
+    prim.closed = closed;
+    prim.color = color;
+
+    // the rows that the primitive may touch, with the margin for the thickness and antialiasing
+    int i, ymin = v[0].y, ymax = v[0].y;
+    for( i = 1; i < count; i++ )
+    {
+        ymin = std::min( ymin, v[i].y );
+        ymax = std::max( ymax, v[i].y );
+    }
+    int margin = std::max(thickness, 0)/2 + 3;
+    ymin -= radius;
+    ymax += radius;
+    prim.rows = Range( (ymin >> shift) - margin, (ymax >> shift) + margin + 1 );
+    // thin circles ignore the shift (see cv::circle)
+    if( kind == DRAW_CIRCLE )
+        prim.rows = Range( std::min(prim.rows.start, ymin - margin), std::max(prim.rows.end, ymax + margin + 1) );
+
+    pts.insert( pts.end(), v, v + count );
+    prims.push_back( prim );
+}
+
+void DrawingBatch::line( Point pt1, Point pt2, const Scalar& color,
+                         int thickness, int lineType, int shift )
+{
+    CV_Assert( 0 <= thickness );
+    Point v[] = { pt1, pt2 };
+    addPrimitive( DRAW_POLYLINE, v, 2, 0, false, color, thickness, lineType, shift );
+}
+
+void DrawingBatch::rectangle( Rect rec, const Scalar& color,
+                              int thickness, int lineType, int shift )
+{
+    CV_Assert( 0 <= shift && shift <= XY_SHIFT );
+    if( rec.area() <= 0 )
+        return;
+
+    Point pt1 = rec.tl(), pt2 = rec.br() - Point(1<<shift, 1<<shift);
+    Point v[] = { pt1, Point(pt2.x, pt1.y), pt2, Point(pt1.x, pt2.y) };
+    addPrimitive( thickness >= 0 ? DRAW_POLYLINE : DRAW_FILL_CONVEX, v, 4, 0, true,
+                  color, thickness, lineType, shift );
+}
+
+void DrawingBatch::circle( Point center, int radius, const Scalar& color,
+                           int thickness, int lineType, int shift )
+{
+    CV_Assert( radius >= 0 );
+    addPrimitive( DRAW_CIRCLE, &center, 1, radius, false, color, thickness, lineType, shift );
+}
+
+void DrawingBatch::polylines( InputArray _pts, bool isClosed, const Scalar& color,
+                              int thickness, int lineType, int shift )
+{
+    Mat p = _pts.getMat();
+    if( p.total() == 0 )
+        return;
+    CV_Assert( p.checkVector(2, CV_32S) >= 0 && 0 <= thickness );
+    addPrimitive( DRAW_POLYLINE, (const Point*)p.data, p.rows*p.cols*p.channels()/2, 0, isClosed,
+                  color, thickness, lineType, shift );
+}
+
+void DrawingBatch::fillPoly( InputArray _pts, const Scalar& color, int lineType, int shift )
+{
+    Mat p = _pts.getMat();
+    if( p.total() == 0 )
+        return;
+    CV_Assert( p.checkVector(2, CV_32S) >= 0 );
+    addPrimitive( DRAW_FILL_POLY, (const Point*)p.data, p.rows*p.cols*p.channels()/2, 0, false,
+                  color, -1, lineType, shift );
+}
+
+void DrawingBatch::putText( const String& text, Point org, int fontFace, double fontScale,
+                            Scalar color, int thickness, int lineType, bool bottomLeftOrigin )
+{
+    std::vector<Point> v;
+    std::vector<int> npts;
+    TextToPolylines( text, org, fontFace, fontScale, bottomLeftOrigin, v, npts );
+
+    for( size_t i = 0, ofs = 0; i < npts.size(); ofs += npts[i++] )
+        addPrimitive( DRAW_POLYLINE, &v[ofs], npts[i], 0, false,
+                      color, thickness, lineType, XY_SHIFT );
+}
+
+void DrawingBatch::clear()
+{
+    prims.clear();
+    pts.clear();
+}
+
+size_t DrawingBatch::size() const
+{
+    return prims.size();
+}
+
+void DrawingBatch::drawRows( Mat& img, const Range& rows, const double* colors ) const
+{
+    std::vector<PolyEdge> edges;
+
+    for( size_t i = 0; i < prims.size(); i++ )
+    {
+        const Primitive& prim = prims[i];
+        if( prim.rows.end <= rows.start || prim.rows.start >= rows.end )
+            continue;
+
+        const Point* v = &pts[prim.ofs];
+        const double* color = colors + i*4;
+        int lineType = prim.lineType;
+        if( lineType == CV_AA && img.depth() != CV_8U )
+            lineType = 8;
+
+        if( prim.kind == DRAW_POLYLINE )
+            PolyLine( img, v, prim.count, prim.closed, color, prim.thickness, lineType, prim.shift, rows );
+        else if( prim.kind == DRAW_FILL_CONVEX )
+            FillConvexPoly( img, v, prim.count, color, lineType, prim.shift, rows );
+        else if( prim.kind == DRAW_FILL_POLY )
+        {
+            edges.clear();
+            CollectPolyEdges( img, v, prim.count, edges, color, lineType, prim.shift, Point(), rows );
+            FillEdgeCollection( img, edges, color, rows );
+        }
+        else
+        {
+            // the same logic as in cv::circle
+            Point center = v[0];
+            int radius = prim.radius;
+            if( prim.thickness > 1 || lineType >= CV_AA )
+            {
+                center.x <<= XY_SHIFT - prim.shift;
+                center.y <<= XY_SHIFT - prim.shift;
+                radius <<= XY_SHIFT - prim.shift;
+                EllipseEx( img, center, Size(radius, radius),
+                           0, 0, 360, color, prim.thickness, lineType, rows );
+            }
+            else
+                Circle( img, center, radius, color, prim.thickness < 0, rows );
+        }
+    }
+}
+
+class DrawingBatchInvoker : public ParallelLoopBody
+{
+public:
+    DrawingBatchInvoker( const DrawingBatch& _batch, const Mat& _img, const Mat& _canvas,
+                         const double* _colors, double _alpha, int _nbands )
+        : batch(&_batch), img(_img), canvas(_canvas), colors(_colors), alpha(_alpha), nbands(_nbands)
+    {
+    }
+
+    void operator()( const Range& range ) const
+    {
+        for( int b = range.start; b < range.end; b++ )
+        {
+            Range rows( b*img.rows/nbands, (b + 1)*img.rows/nbands );
+            if( alpha >= 1 )
+            {
+                Mat dst = img;
+                batch->drawRows( dst, rows, colors );
+                continue;
+            }
+
+            // blend back only the rows some primitive can touch
+            int y0 = rows.end, y1 = rows.start;
+            for( size_t i = 0; i < batch->prims.size(); i++ )
+            {
+                const Range& r = batch->prims[i].rows;
+                if( r.end <= rows.start || r.start >= rows.end )
+                    continue;
+                y0 = std::min( y0, std::max(r.start, rows.start) );
+                y1 = std::max( y1, std::min(r.end, rows.end) );
+            }
+            if( y0 >= y1 )
+                continue;
+            rows = Range( y0, y1 );
+
+            // render the band over the copy of the original content and blend it back
+            Mat dst = canvas, src = img.rowRange(rows), drawn = canvas.rowRange(rows);
+            src.copyTo( drawn );
+            batch->drawRows( dst, rows, colors );
+            addWeighted( drawn, alpha, src, 1 - alpha, 0, src );
+        }
+    }
+
+private:
+    const DrawingBatch* batch;
+    Mat img, canvas;
+    const double* colors;
+    double alpha;
+    int nbands;
+};
+
+void DrawingBatch::draw( InputOutputArray _img, double alpha ) const
+{
+    Mat img = _img.getMat();
+    if( prims.empty() || img.empty() || alpha <= 0 )
+        return;
+    CV_Assert( img.dims <= 2 );
+    alpha = std::min( alpha, 1. );
+
+    size_t i, n = prims.size();
+    std::vector<double> colors(n*4);
+    for( i = 0; i < n; i++ )
+        scalarToRawData( prims[i].color, &colors[i*4], img.type(), 0 );
+
+    Mat canvas;
+    if( alpha < 1 )
+        canvas.create( img.size(), img.type() );
+
+    // a few bands per thread for load balancing; the bands are exact, so the count does not affect the result
+    int nbands = std::min( img.rows, std::max(getNumThreads(), 1)*4 );
+    parallel_for_( Range(0, nbands), DrawingBatchInvoker(*this, img, canvas, &colors[0], alpha, nbands) );
+}
+
 }
 
 
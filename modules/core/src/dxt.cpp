@@ -362,6 +362,110 @@ DFTInit( int n0, int nf, int* factors, int* itab, int elem_size, void* _wave, in
     }
 }
 
+/*
+   The factorization, permutation table and twiddle factors of a 1D transform of the
+   given length and depth. The plans are shared by the dft() calls through a small
+   process-wide cache, so the repeated transforms of the same size (video frames,
+   convolution by the same kernel size etc.) do not rebuild the tables on every call.
+   A plan is never modified after it is created; the transforms that change factors[]
+   on the fly work on a copy.
+*/
+struct DFTPlan
+{
+    DFTPlan(int _len, int _depth, bool _invItab) : len(_len), depth(_depth), invItab(_invItab), lastUse(0)
+    {
+        int complex_elem_size = depth == CV_32F ? (int)sizeof(Complexf) : (int)sizeof(Complexd);
+        nf = DFTFactorize(len, factors);
+        size = (size_t)len*(sizeof(int) + complex_elem_size);
+        itab.allocate(len);
+        wave.allocate(len*complex_elem_size);
+        DFTInit(len, nf, factors, itab, complex_elem_size, wave, invItab);
+    }
+
+    int len, depth, nf;
+    bool invItab;
+    int factors[34];
+    size_t size;
+    AutoBuffer<int> itab;
+    AutoBuffer<uchar> wave;
+    uint64 lastUse;
+};
+
+// besides the number of plans, the cache is limited by the total size of their tables
+// (a 64K-point double plan takes ~1.3 MB), the larger plans are never cached
+enum { DFT_PLAN_CACHE_SIZE = 16, DFT_PLAN_CACHE_MAX_BYTES = 4 << 20 };
+
+struct DFTPlanCache
+{
+    DFTPlanCache() : maxPlans(DFT_PLAN_CACHE_SIZE), size(0), useCount(0) {}
+
+    Mutex mutex;
+    int maxPlans;
+    size_t size;
+    uint64 useCount;
+    std::vector<Ptr<DFTPlan> > plans;
+};
+
+static DFTPlanCache& getDFTPlanCache()
+{
+    // never destroyed, dft() may be called from the static destructors of other modules
+    static DFTPlanCache* cache = new DFTPlanCache;
+    return *cache;
+}
+
+// removes the least recently used plan; the callers holding it keep their reference
+static void evictDFTPlan( DFTPlanCache& cache )
+{
+    size_t lru = 0;
+    for( size_t i = 1; i < cache.plans.size(); i++ )
+        if( cache.plans[i]->lastUse < cache.plans[lru]->lastUse )
+            lru = i;
+    cache.size -= cache.plans[lru]->size;
+    cache.plans.erase(cache.plans.begin() + lru);
+}
+
+static Ptr<DFTPlan> getDFTPlan( int len, int depth, bool invItab )
+{
+    DFTPlanCache& cache = getDFTPlanCache();
+    size_t planSize = (size_t)len*(sizeof(int) + (depth == CV_32F ? sizeof(Complexf) : sizeof(Complexd)));
+    if( planSize <= (size_t)DFT_PLAN_CACHE_MAX_BYTES )
+    {
+        AutoLock lock(cache.mutex);
+        for( size_t i = 0; i < cache.plans.size(); i++ )
+        {
+            DFTPlan* p = cache.plans[i];
+            if( p->len == len && p->depth == depth && p->invItab == invItab )
+            {
+                p->lastUse = ++cache.useCount;
+                return cache.plans[i];
+            }
+        }
+    }
+
+    // the tables are built outside of the lock; if several threads miss the same plan
+    // at once, each of them uses its own copy and only one copy is kept
+    Ptr<DFTPlan> plan = new DFTPlan(len, depth, invItab);
+    if( planSize > (size_t)DFT_PLAN_CACHE_MAX_BYTES )
+        return plan;
+
+    AutoLock lock(cache.mutex);
+    if( cache.maxPlans <= 0 )
+        return plan;
+    for( size_t i = 0; i < cache.plans.size(); i++ )
+    {
+        DFTPlan* p = cache.plans[i];
+        if( p->len == len && p->depth == depth && p->invItab == invItab )
+            return plan;
+    }
+    while( (int)cache.plans.size() >= cache.maxPlans ||
+           (!cache.plans.empty() && cache.size + planSize > (size_t)DFT_PLAN_CACHE_MAX_BYTES) )
+        evictDFTPlan(cache);
+    plan->lastUse = ++cache.useCount;
+    cache.size += planSize;
+    cache.plans.push_back(plan);
+    return plan;
+}
+
 template<typename T> struct DFT_VecR4
 {
     int operator()(Complex<T>*, int, int, int&, const Complex<T>*) const { return 1; }
@@ -374,6 +478,10 @@ template<> struct DFT_VecR4<float>
 {
     int operator()(Complex<float>* dst, int N, int n0, int& _dw0, const Complex<float>* wave) const
     {
+        const SIMDKernels* simd = currentSIMDKernels;
+        if( simd )
+            return simd->dftRadix4_32f((float*)dst, N, n0, &_dw0, (const float*)wave);
+
         int n = 1, i, j, nx, dw, dw0 = _dw0;
         __m128 z = _mm_setzero_ps(), x02=z, x13=z, w01=z, w23=z, y01, y23, t0, t1;
         Cv32suf t; t.i = 0x80000000;
@@ -1456,6 +1564,149 @@ static void CCSIDFT_64f( const double* src, double* dst, int n, int nf, int* fac
     CCSIDFT( src, dst, n, nf, factors, itab, wave, tab_size, spec, buf, flags, scale);
 }
 
+enum { DFT_STRIPE_SIZE = 1 << 14, DFT_MIN_PARALLEL_SIZE = 1 << 16 };
+
+// the number of stripes for count independent 1D transforms of length len
+static int dftStripes( int count, int len )
+{
+    int64 total = (int64)count*len;
+    if( count < 2 || total < DFT_MIN_PARALLEL_SIZE )
+        return 1;
+    return (int)std::min((int64)count, total/DFT_STRIPE_SIZE);
+}
+
+class DFTRowsInvoker : public ParallelLoopBody
+{
+public:
+    DFTRowsInvoker( const Mat& _src, const Mat& _dst, DFTFunc _func, int _len, int _nf,
+                    const int* _factors, const int* _itab, const uchar* _wave, const void* _spec,
+                    size_t _bufSize, int _tmpSize, int _dptrOffset, int _dstFullLen,
+                    int _flags, double _scale )
+        : src(_src), dst(_dst), func(_func), len(_len), nf(_nf), itab(_itab), wave(_wave),
+          spec(_spec), bufSize(_bufSize), tmpSize(_tmpSize), dptrOffset(_dptrOffset),
+          dstFullLen(_dstFullLen), flags(_flags), scale(_scale)
+    {
+        memcpy( factors, _factors, nf*sizeof(factors[0]) );
+    }
+
+    void operator()( const Range& range ) const
+    {
+        // RealDFT and CCSIDFT modify the factors temporarily
+        int _factors[34];
+        memcpy( _factors, factors, nf*sizeof(factors[0]) );
+        ScratchBuffer<uchar> buf( bufSize );
+        uchar* ptr = alignPtr( (uchar*)buf, 16 );
+        uchar* tmp_buf = 0;
+
+        if( tmpSize > 0 )
+        {
+            tmp_buf = ptr;
+            ptr += tmpSize;
+        }
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const uchar* sptr = src.data + i*src.step;
+            uchar* dptr0 = dst.data + i*dst.step;
+            uchar* dptr = tmp_buf ? tmp_buf : dptr0;
+
+            func( sptr, dptr, len, nf, _factors, itab, wave, len, spec, ptr, flags, scale );
+            if( dptr != dptr0 )
+                memcpy( dptr0, dptr + dptrOffset, dstFullLen );
+        }
+    }
+
+protected:
+    const Mat& src;
+    const Mat& dst;
+    DFTFunc func;
+    int len, nf;
+    int factors[34];
+    const int* itab;
+    const uchar* wave;
+    const void* spec;
+    size_t bufSize;
+    int tmpSize, dptrOffset, dstFullLen, flags;
+    double scale;
+};
+
+// complex 1D transforms of the columns, processed in pairs
+class DFTColumnsInvoker : public ParallelLoopBody
+{
+public:
+    DFTColumnsInvoker( const uchar* _sptr0, size_t _sstep, uchar* _dptr0, size_t _dstep, int _ncols,
+                       DFTFunc _func, int _len, int _nf, const int* _factors, const int* _itab,
+                       const uchar* _wave, const void* _spec, size_t _bufSize, bool _useBuf,
+                       int _elemSize, int _flags, double _scale )
+        : sptr0(_sptr0), sstep(_sstep), dptr0(_dptr0), dstep(_dstep), ncols(_ncols), func(_func),
+          len(_len), nf(_nf), itab(_itab), wave(_wave), spec(_spec), bufSize(_bufSize),
+          useBuf(_useBuf), elemSize(_elemSize), flags(_flags), scale(_scale)
+    {
+        memcpy( factors, _factors, nf*sizeof(factors[0]) );
+    }
+
+    void operator()( const Range& range ) const
+    {
+        int _factors[34];
+        memcpy( _factors, factors, nf*sizeof(factors[0]) );
+        ScratchBuffer<uchar> buf( bufSize );
+        uchar* ptr = alignPtr( (uchar*)buf, 16 );
+        uchar *buf0, *buf1, *dbuf0, *dbuf1;
+
+        buf0 = ptr;
+        ptr += len*elemSize;
+        buf1 = ptr;
+        ptr += len*elemSize;
+        dbuf0 = buf0, dbuf1 = buf1;
+
+        if( useBuf )
+        {
+            dbuf1 = ptr;
+            dbuf0 = buf1;
+            ptr += len*elemSize;
+        }
+
+        for( int k = range.start; k < range.end; k++ )
+        {
+            const uchar* sptr = sptr0 + k*2*elemSize;
+            uchar* dptr = dptr0 + k*2*elemSize;
+            bool pair = k*2 + 1 < ncols;
+
+            if( pair )
+            {
+                CopyFrom2Columns( sptr, sstep, buf0, buf1, len, elemSize );
+                func( buf1, dbuf1, len, nf, _factors, itab, wave, len, spec, ptr, flags, scale );
+            }
+            else
+                CopyColumn( sptr, sstep, buf0, elemSize, len, elemSize );
+
+            func( buf0, dbuf0, len, nf, _factors, itab, wave, len, spec, ptr, flags, scale );
+
+            if( pair )
+                CopyTo2Columns( dbuf0, dbuf1, dptr, dstep, len, elemSize );
+            else
+                CopyColumn( dbuf0, elemSize, dptr, dstep, len, elemSize );
+        }
+    }
+
+protected:
+    const uchar* sptr0;
+    size_t sstep;
+    uchar* dptr0;
+    size_t dstep;
+    int ncols;
+    DFTFunc func;
+    int len, nf;
+    int factors[34];
+    const int* itab;
+    const uchar* wave;
+    const void* spec;
+    size_t bufSize;
+    bool useBuf;
+    int elemSize, flags;
+    double scale;
+};
+
 }
 
 
@@ -1475,7 +1726,8 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
     void *spec = 0;
 
     Mat src0 = _src0.getMat(), src = src0;
-    int prev_len = 0, stage = 0;
+    Ptr<DFTPlan> plan;
+    int stage = 0;
     bool inv = (flags & DFT_INVERSE) != 0;
     int nf = 0, real_transform = src.channels() == 1 || (inv && (flags & DFT_REAL_OUTPUT)!=0);
     int type = src.type(), depth = src.depth();
@@ -1593,11 +1845,13 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
         else
 #endif
         {
-            if( len != prev_len )
-                nf = DFTFactorize( len, factors );
+            bool inv_itab = stage == 0 && inv && real_transform;
+            if( !plan || plan->len != len || plan->invItab != inv_itab )
+                plan = getDFTPlan( len, depth, inv_itab );
+            nf = plan->nf;
+            memcpy( factors, plan->factors, nf*sizeof(factors[0]) );
 
             inplace_transform = factors[0] == factors[nf-1];
-            sz += len*(complex_elem_size + sizeof(int));
             i = nf > 1 && (factors[0] & 1) == 0;
             if( (factors[i] & 1) != 0 && factors[i] > 5 )
                 sz += (factors[i]+1)*complex_elem_size;
@@ -1610,41 +1864,21 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
             }
         }
 
-        ptr = (uchar*)buf;
-        buf.allocate( sz + 32 );
-        if( ptr != (uchar*)buf )
-            prev_len = 0; // because we release the buffer,
-                          // force recalculation of
-                          // twiddle factors and permutation table
-        ptr = (uchar*)buf;
         if( !spec )
         {
-            wave = ptr;
-            ptr += len*complex_elem_size;
-            itab = (int*)ptr;
-            ptr = (uchar*)cvAlignPtr( ptr + len*sizeof(int), 16 );
-
-            if( len != prev_len || (!inplace_transform && inv && real_transform))
-                DFTInit( len, nf, factors, itab, complex_elem_size,
-                            wave, stage == 0 && inv && real_transform );
-            // otherwise reuse the tables calculated on the previous stage
+            wave = plan->wave;
+            itab = plan->itab;
         }
 
         if( stage == 0 )
         {
-            uchar* tmp_buf = 0;
             int dptr_offset = 0;
             int dst_full_len = len*elem_size;
             int _flags = (int)inv + (src.channels() != dst.channels() ?
                          DFT_COMPLEX_INPUT_OR_OUTPUT : 0);
-            if( use_buf )
-            {
-                tmp_buf = ptr;
-                ptr += len*complex_elem_size;
-                if( odd_real && !inv && len > 1 &&
-                    !(_flags & DFT_COMPLEX_INPUT_OR_OUTPUT))
-                    dptr_offset = elem_size;
-            }
+            if( use_buf && odd_real && !inv && len > 1 &&
+                !(_flags & DFT_COMPLEX_INPUT_OR_OUTPUT))
+                dptr_offset = elem_size;
 
             if( !inv && (_flags & DFT_COMPLEX_INPUT_OR_OUTPUT) )
                 dst_full_len += (len & 1) ? elem_size : complex_elem_size;
@@ -1659,21 +1893,17 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
             if( nonzero_rows <= 0 || nonzero_rows > count )
                 nonzero_rows = count;
 
-            for( i = 0; i < nonzero_rows; i++ )
-            {
-                uchar* sptr = src.data + i*src.step;
-                uchar* dptr0 = dst.data + i*dst.step;
-                uchar* dptr = dptr0;
-
-                if( tmp_buf )
-                    dptr = tmp_buf;
-
-                dft_func( sptr, dptr, len, nf, factors, itab, wave, len, spec, ptr, _flags, scale );
-                if( dptr != dptr0 )
-                    memcpy( dptr0, dptr + dptr_offset, dst_full_len );
-            }
+            // the rows are independent, each stripe has its own work buffers
+            DFTRowsInvoker body( src, dst, dft_func, len, nf, factors, itab, wave, spec,
+                                 sz + 32, use_buf ? len*complex_elem_size : 0,
+                                 dptr_offset, dst_full_len, _flags, scale );
+            int nstripes = dftStripes( nonzero_rows, len );
+            if( nstripes > 1 )
+                parallel_for_( Range(0, nonzero_rows), body, nstripes );
+            else
+                body( Range(0, nonzero_rows) );
 
-            for( ; i < count; i++ )
+            for( i = nonzero_rows; i < count; i++ )
             {
                 uchar* dptr0 = dst.data + i*dst.step;
                 memset( dptr0, 0, dst_full_len );
@@ -1689,6 +1919,8 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
             uchar *buf0, *buf1, *dbuf0, *dbuf1;
             uchar* sptr0 = src.data;
             uchar* dptr0 = dst.data;
+            buf.allocate( sz + 32 );
+            ptr = alignPtr( (uchar*)buf, 16 );
             buf0 = ptr;
             ptr += len*complex_elem_size;
             buf1 = ptr;
@@ -1797,26 +2029,18 @@ void cv::dft( InputArray _src0, OutputArray _dst, int flags, int nonzero_rows )
                 }
             }
 
-            for( i = a; i < b; i += 2 )
+            if( a < b )
             {
-                if( i+1 < b )
-                {
-                    CopyFrom2Columns( sptr0, src.step, buf0, buf1, len, complex_elem_size );
-                    dft_func( buf1, dbuf1, len, nf, factors, itab,
-                              wave, len, spec, ptr, inv, scale );
-                }
-                else
-                    CopyColumn( sptr0, src.step, buf0, complex_elem_size, len, complex_elem_size );
-
-                dft_func( buf0, dbuf0, len, nf, factors, itab,
-                          wave, len, spec, ptr, inv, scale );
-
-                if( i+1 < b )
-                    CopyTo2Columns( dbuf0, dbuf1, dptr0, dst.step, len, complex_elem_size );
+                // the column pairs are independent, each stripe has its own buffers
+                DFTColumnsInvoker body( sptr0, src.step, dptr0, dst.step, b - a, dft_func,
+                                        len, nf, factors, itab, wave, spec, sz + 32,
+                                        use_buf != 0, complex_elem_size, (int)inv, scale );
+                int npairs = (b - a + 1)/2;
+                int nstripes = dftStripes( npairs, len*2 );
+                if( nstripes > 1 )
+                    parallel_for_( Range(0, npairs), body, nstripes );
                 else
-                    CopyColumn( dbuf0, complex_elem_size, dptr0, dst.step, len, complex_elem_size );
-                sptr0 += 2*complex_elem_size;
-                dptr0 += 2*complex_elem_size;
+                    body( Range(0, npairs) );
             }
 
             if( stage != 0 )
@@ -2625,6 +2849,22 @@ int cv::getOptimalDFTSize( int size0 )
     return optimalDFTSizeTab[b];
 }
 
+void cv::setDFTPlanCacheSize( int maxPlans )
+{
+    DFTPlanCache& cache = getDFTPlanCache();
+    AutoLock lock(cache.mutex);
+    cache.maxPlans = std::max(maxPlans, 0);
+    while( (int)cache.plans.size() > cache.maxPlans )
+        evictDFTPlan(cache);
+}
+
+int cv::getDFTPlanCacheSize()
+{
+    DFTPlanCache& cache = getDFTPlanCache();
+    AutoLock lock(cache.mutex);
+    return cache.maxPlans;
+}
+
 CV_IMPL void
 cvDFT( const CvArr* srcarr, CvArr* dstarr, int flags, int nonzero_rows )
 {
@@ -720,6 +720,939 @@ static void JacobiSVD(double* At, size_t astep, double* W, double* Vt, size_t vs
     JacobiSVDImpl_(At, astep, W, Vt, vstep, m, n, !Vt ? 0 : n1 < 0 ? n : n1, DBL_MIN, DBL_EPSILON*10);
 }
 
+/****************************************************************************************\
+*              Householder reduction followed by implicit QL/QR iterations              *
+\****************************************************************************************/
+
+/*
+   The Jacobi methods above are very accurate, but their cost grows as O(n^3) with a large
+   constant. Starting from this size the symmetric eigenproblem is solved via tridiagonalization
+   and the implicit QL algorithm, and SVD via bidiagonalization and the implicit QR algorithm
+   (Golub-Kahan-Reinsch). Both are computed in double precision.
+*/
+enum { JACOBI_MAX_SIZE = 32 };
+
+static inline double vecDot( const double* a, const double* b, int n )
+{
+    int k = 0;
+    double s = 0;
+#if CV_SSE2
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    for( ; k <= n - 4; k += 4 )
+    {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + k), _mm_loadu_pd(b + k)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + k + 2), _mm_loadu_pd(b + k + 2)));
+    }
+    double sbuf[2];
+    _mm_storeu_pd(sbuf, _mm_add_pd(s0, s1));
+    s = sbuf[0] + sbuf[1];
+#endif
+    for( ; k < n; k++ )
+        s += a[k]*b[k];
+    return s;
+}
+
+// a += alpha*b
+static inline void vecAxpy( double* a, const double* b, int n, double alpha )
+{
+    int k = 0;
+#if CV_SSE2
+    __m128d alpha2 = _mm_set1_pd(alpha);
+    for( ; k <= n - 4; k += 4 )
+    {
+        __m128d a0 = _mm_loadu_pd(a + k), a1 = _mm_loadu_pd(a + k + 2);
+        a0 = _mm_add_pd(a0, _mm_mul_pd(_mm_loadu_pd(b + k), alpha2));
+        a1 = _mm_add_pd(a1, _mm_mul_pd(_mm_loadu_pd(b + k + 2), alpha2));
+        _mm_storeu_pd(a + k, a0);
+        _mm_storeu_pd(a + k + 2, a1);
+    }
+#endif
+    for( ; k < n; k++ )
+        a[k] += alpha*b[k];
+}
+
+// (a, b) = (c*a + s*b, c*b - s*a), the same convention as in VBLAS::givens
+static inline void vecRotate( double* a, double* b, int n, double c, double s )
+{
+    int k = 0;
+#if CV_SSE2
+    __m128d c2 = _mm_set1_pd(c), s2 = _mm_set1_pd(s);
+    for( ; k <= n - 2; k += 2 )
+    {
+        __m128d a0 = _mm_loadu_pd(a + k), b0 = _mm_loadu_pd(b + k);
+        _mm_storeu_pd(a + k, _mm_add_pd(_mm_mul_pd(a0, c2), _mm_mul_pd(b0, s2)));
+        _mm_storeu_pd(b + k, _mm_sub_pd(_mm_mul_pd(b0, c2), _mm_mul_pd(a0, s2)));
+    }
+#endif
+    for( ; k < n; k++ )
+    {
+        double a0 = a[k], b0 = b[k];
+        a[k] = c*a0 + s*b0;
+        b[k] = c*b0 - s*a0;
+    }
+}
+
+// the operation is run in parallel only when it is large enough to pay off
+static inline void parallelForLarge( const Range& range, const ParallelLoopBody& body, double work )
+{
+    if( work >= 1 << 16 && range.end - range.start > 1 )
+        parallel_for_(range, body);
+    else
+        body(range);
+}
+
+struct PlaneRotation
+{
+    PlaneRotation() {}
+    PlaneRotation(int _i, int _j, double _c, double _s) : i(_i), j(_j), c(_c), s(_s) {}
+    int i, j;
+    double c, s;
+};
+
+/*
+   Applies a sequence of plane rotations to the rows of Z. The QL/QR sweeps produce
+   long sequences of rotations of the neighbour rows; instead of sweeping the whole
+   matrix for each of them, all the rotations are applied to one narrow stripe of
+   columns while it is in cache, and the stripes are processed in parallel.
+*/
+class RotateRowsInvoker : public ParallelLoopBody
+{
+public:
+    enum { STRIPE = 64 };
+
+    RotateRowsInvoker( double* _Z, size_t _zstep, int _ncols, const PlaneRotation* _rots, int _nrots ) :
+        Z(_Z), zstep(_zstep), ncols(_ncols), rots(_rots), nrots(_nrots) {}
+
+    void operator()( const Range& range ) const
+    {
+        int c0 = range.start*STRIPE, c1 = std::min(range.end*STRIPE, ncols);
+        for( int k = 0; k < nrots; k++ )
+        {
+            const PlaneRotation& r = rots[k];
+            vecRotate(Z + r.i*zstep + c0, Z + r.j*zstep + c0, c1 - c0, r.c, r.s);
+        }
+    }
+
+private:
+    double* Z;
+    size_t zstep;
+    int ncols;
+    const PlaneRotation* rots;
+    int nrots;
+};
+
+static void rotateRows( double* Z, size_t zstep, int ncols, std::vector<PlaneRotation>& rots )
+{
+    if( Z && !rots.empty() )
+    {
+        int nstripes = (ncols + RotateRowsInvoker::STRIPE - 1)/RotateRowsInvoker::STRIPE;
+        parallelForLarge(Range(0, nstripes),
+                         RotateRowsInvoker(Z, zstep, ncols, &rots[0], (int)rots.size()),
+                         (double)rots.size()*ncols);
+    }
+    rots.clear();
+}
+
+// X_j[ofs:ofs+len] -= beta*(X_j[ofs:ofs+len] . v)*v, i.e. applies the reflector I - beta*v*v' to the rows of X
+class ReflectRowsInvoker : public ParallelLoopBody
+{
+public:
+    ReflectRowsInvoker( double* _X, size_t _xstep, int _ofs, int _len, const double* _v, double _beta ) :
+        X(_X), xstep(_xstep), ofs(_ofs), len(_len), v(_v), beta(_beta) {}
+
+    void operator()( const Range& range ) const
+    {
+        for( int j = range.start; j < range.end; j++ )
+        {
+            double* x = X + j*xstep + ofs;
+            vecAxpy(x, v, len, -beta*vecDot(x, v, len));
+        }
+    }
+
+private:
+    double* X;
+    size_t xstep;
+    int ofs, len;
+    const double* v;
+    double beta;
+};
+
+static void reflectRows( double* X, size_t xstep, int j0, int j1, int ofs, int len, const double* v, double beta )
+{
+    if( j0 < j1 )
+        parallelForLarge(Range(j0, j1), ReflectRowsInvoker(X, xstep, ofs, len, v, beta), (double)(j1 - j0)*len);
+}
+
+/////////////////////////////// symmetric eigenproblem ///////////////////////////////
+
+// p = beta*A22*v, where A22 = A[k+1:n, k+1:n]
+class SymmMatVecInvoker : public ParallelLoopBody
+{
+public:
+    SymmMatVecInvoker( const double* _A, size_t _astep, int _k, int _n, const double* _v, double _beta, double* _p ) :
+        A(_A), astep(_astep), k(_k), n(_n), v(_v), beta(_beta), p(_p) {}
+
+    void operator()( const Range& range ) const
+    {
+        int len = n - k - 1;
+        for( int i = range.start; i < range.end; i++ )
+            p[i - k - 1] = beta*vecDot(A + i*astep + k + 1, v, len);
+    }
+
+private:
+    const double* A;
+    size_t astep;
+    int k, n;
+    const double* v;
+    double beta;
+    double* p;
+};
+
+// A22 -= v*w' + w*v'
+class SymmRank2Invoker : public ParallelLoopBody
+{
+public:
+    SymmRank2Invoker( double* _A, size_t _astep, int _k, int _n, const double* _v, const double* _w ) :
+        A(_A), astep(_astep), k(_k), n(_n), v(_v), w(_w) {}
+
+    void operator()( const Range& range ) const
+    {
+        int len = n - k - 1;
+        for( int i = range.start; i < range.end; i++ )
+        {
+            double* a = A + i*astep + k + 1;
+            vecAxpy(a, w, len, -v[i - k - 1]);
+            vecAxpy(a, v, len, -w[i - k - 1]);
+        }
+    }
+
+private:
+    double* A;
+    size_t astep;
+    int k, n;
+    const double* v;
+    const double* w;
+};
+
+/*
+   Reduces the symmetric matrix A to the tridiagonal form T = Q'*A*Q, Q = H_0*H_1*...*H_{n-3}.
+   On exit the diagonal of T is stored in d, the off-diagonal in e (e[i] = T(i,i+1), e[n-1] = 0).
+   The Householder vector of H_k = I - beta[k]*u*u' is stored in A[k][k+1:n].
+*/
+static void tridiagonalize( double* A, size_t astep, int n, double* d, double* e, double* beta, double* buf )
+{
+    double* p = buf;
+    for( int k = 0; k < n - 2; k++ )
+    {
+        double* v = A + k*astep + k + 1;
+        int len = n - k - 1;
+        double scale = 0, tail = 0;
+        d[k] = A[k*astep + k];
+
+        for( int i = 0; i < len; i++ )
+            scale = std::max(scale, std::abs(v[i]));
+        if( scale > 0 )
+            for( int i = 1; i < len; i++ )
+                tail += (v[i]/scale)*(v[i]/scale);
+
+        if( tail == 0 )
+        {
+            e[k] = v[0];
+            beta[k] = 0;
+            continue;
+        }
+
+        double x0 = v[0]/scale, alpha = std::sqrt(x0*x0 + tail);
+        if( x0 > 0 )
+            alpha = -alpha;
+        for( int i = 0; i < len; i++ )
+            v[i] /= scale;
+        v[0] = x0 - alpha;
+        double b = beta[k] = 1./(alpha*(alpha - x0));
+        e[k] = alpha*scale;
+
+        parallelForLarge(Range(k + 1, n), SymmMatVecInvoker(A, astep, k, n, v, b, p), (double)len*len);
+        vecAxpy(p, v, len, -0.5*b*vecDot(p, v, len));
+        parallelForLarge(Range(k + 1, n), SymmRank2Invoker(A, astep, k, n, v, p), (double)len*len*2);
+    }
+
+    if( n >= 2 )
+    {
+        d[n-2] = A[(n-2)*astep + n-2];
+        e[n-2] = A[(n-2)*astep + n-1];
+    }
+    d[n-1] = A[(n-1)*astep + n-1];
+    e[n-1] = 0;
+}
+
+// V = V*Q', where Q is the matrix built by tridiagonalize(); rows of V are processed in parallel
+class TridiagBackTransformInvoker : public ParallelLoopBody
+{
+public:
+    TridiagBackTransformInvoker( const double* _A, size_t _astep, const double* _beta, int _n,
+                                 double* _V, size_t _vstep ) :
+        A(_A), astep(_astep), beta(_beta), n(_n), V(_V), vstep(_vstep) {}
+
+    void operator()( const Range& range ) const
+    {
+        for( int j = range.start; j < range.end; j++ )
+        {
+            double* x = V + j*vstep;
+            for( int k = n - 3; k >= 0; k-- )
+                if( beta[k] != 0 )
+                {
+                    const double* v = A + k*astep + k + 1;
+                    int len = n - k - 1;
+                    vecAxpy(x + k + 1, v, len, -beta[k]*vecDot(x + k + 1, v, len));
+                }
+        }
+    }
+
+private:
+    const double* A;
+    size_t astep;
+    const double* beta;
+    int n;
+    double* V;
+    size_t vstep;
+};
+
+/*
+   Computes the eigenvalues (and, if Zt is not NULL, the eigenvectors, stored as the rows of Zt)
+   of the symmetric tridiagonal matrix (d, e) using the implicit QL algorithm
+   (tql2 procedure from EISPACK). The rotations of each QL sweep are applied to Zt in a batch.
+*/
+static bool tridiagQL( double* d, double* e, int n, double* Zt, size_t zstep )
+{
+    const double eps = DBL_EPSILON;
+    const int maxIters = 60;
+    double f = 0, tst1 = 0;
+    std::vector<PlaneRotation> rots;
+    if( Zt )
+        rots.reserve(n);
+
+    for( int l = 0; l < n; l++ )
+    {
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        int m = l;
+        for( ; m < n - 1; m++ )
+            if( std::abs(e[m]) <= eps*tst1 )
+                break;
+
+        if( m > l )
+        {
+            int iter = 0;
+            do
+            {
+                if( ++iter > maxIters )
+                    return false;
+
+                double g = d[l];
+                double p = (d[l+1] - g)/(2.*e[l]);
+                double r = hypot(p, 1.);
+                if( p < 0 )
+                    r = -r;
+                d[l] = e[l]/(p + r);
+                d[l+1] = e[l]*(p + r);
+                double dl1 = d[l+1];
+                double h = g - d[l];
+                for( int i = l + 2; i < n; i++ )
+                    d[i] -= h;
+                f += h;
+
+                p = d[m];
+                double c = 1, c2 = c, c3 = c;
+                double el1 = e[l+1];
+                double s = 0, s2 = 0;
+                for( int i = m - 1; i >= l; i-- )
+                {
+                    c3 = c2;
+                    c2 = c;
+                    s2 = s;
+                    g = c*e[i];
+                    h = c*p;
+                    r = hypot(p, e[i]);
+                    e[i+1] = s*r;
+                    s = e[i]/r;
+                    c = p/r;
+                    p = c*d[i] - s*g;
+                    d[i+1] = h + s*(c*g + s*d[i]);
+                    // z_i = c*z_i - s*z_{i+1}, z_{i+1} = s*z_i + c*z_{i+1}
+                    if( Zt )
+                        rots.push_back(PlaneRotation(i, i+1, c, -s));
+                }
+                rotateRows(Zt, zstep, n, rots);
+
+                p = -s*s2*c3*el1*e[l]/dl1;
+                e[l] = s*p;
+                d[l] = c*p;
+            }
+            while( std::abs(e[l]) > eps*tst1 );
+        }
+        d[l] += f;
+        e[l] = 0;
+    }
+    return true;
+}
+
+// x -= (x, z_j)*z_j for all the given vectors z_j (the modified Gram-Schmidt process)
+static void orthogonalizeVector( double* x, const double* Zt, size_t zstep, int count, int n )
+{
+    for( int j = 0; j < count; j++ )
+    {
+        const double* z = Zt + j*zstep;
+        vecAxpy(x, z, n, -vecDot(x, z, n));
+    }
+}
+
+/*
+   Computes the eigenvector of the tridiagonal matrix (d, e) corresponding to the eigenvalue
+   lambda using inverse iteration (the same scheme as dstein in LAPACK). The vectors of
+   the close eigenvalues, found before, are passed in Zt[0:nprev]; the new vector is
+   orthogonalized against them on every iteration. Within a cluster most of the solution
+   is taken by these vectors, so when the projection cancels most of the norm, it is repeated
+   to keep the vectors orthogonal to the working precision. The iterations stop a couple of
+   steps after the growth of the solution shows that lambda is accurate.
+*/
+static void tridiagInverseIteration( const double* d, const double* e, int n, double lambda, double tnorm,
+                                     const double* Zt, size_t zstep, int nprev, double* x, double* buf,
+                                     RNG& rng )
+{
+    const int maxIters = 5, extraIters = 2;
+    double *u1 = buf, *u2 = u1 + n, *u3 = u2 + n, *l = u3 + n, *y = l + n;
+    uchar* piv = (uchar*)(y + n);
+    double tiny = std::max(tnorm, DBL_MIN)*DBL_EPSILON;
+    int i, iter, extra = 0;
+
+    // LU factorization of T - lambda*I with partial pivoting
+    double p = d[0] - lambda, q = n > 1 ? e[0] : 0.;
+    for( i = 0; i < n - 1; i++ )
+    {
+        double s = e[i], dd = d[i+1] - lambda, t = i < n - 2 ? e[i+1] : 0.;
+        if( std::abs(p) >= std::abs(s) )
+        {
+            if( p == 0 )
+                p = tiny;
+            double m = s/p;
+            u1[i] = p; u2[i] = q; u3[i] = 0;
+            p = dd - m*q; q = t;
+            l[i] = m; piv[i] = 0;
+        }
+        else
+        {
+            double m = p/s;
+            u1[i] = s; u2[i] = dd; u3[i] = t;
+            p = q - m*dd; q = -m*t;
+            l[i] = m; piv[i] = 1;
+        }
+    }
+    u1[n-1] = p != 0 ? p : tiny;
+
+    // the solution of (T - lambda*I)*x = b for a unit b grows at least this much when
+    // lambda is within a small multiple of the rounding error from an eigenvalue
+    double minGrowth = std::sqrt(0.1/n)/(n*std::max(tiny, std::abs(u1[n-1])));
+
+    // a random starting vector, so that the vectors of a cluster do not start from the same point
+    for( i = 0; i < n; i++ )
+        x[i] = rng.uniform(-1., 1.);
+    orthogonalizeVector(x, Zt, zstep, nprev, n);
+    double nrm = std::sqrt(vecDot(x, x, n));
+
+    for( iter = 0; iter < maxIters + extraIters && extra <= extraIters; iter++ )
+    {
+        if( nrm == 0 )
+        {
+            x[iter % n] = 1;
+            nrm = 1;
+        }
+        nrm = 1./nrm;
+        for( i = 0; i < n; i++ )
+            y[i] = x[i]*nrm;
+
+        for( i = 0; i < n - 1; i++ )
+        {
+            if( piv[i] )
+                std::swap(y[i], y[i+1]);
+            y[i+1] -= l[i]*y[i];
+        }
+        x[n-1] = y[n-1]/u1[n-1];
+        if( n > 1 )
+            x[n-2] = (y[n-2] - u2[n-2]*x[n-1])/u1[n-2];
+        for( i = n - 3; i >= 0; i-- )
+            x[i] = (y[i] - u2[i]*x[i+1] - u3[i]*x[i+2])/u1[i];
+
+        double nrm0 = std::sqrt(vecDot(x, x, n));
+        if( nrm0 >= minGrowth || iter >= maxIters - 1 )
+            extra++;
+        orthogonalizeVector(x, Zt, zstep, nprev, n);
+        nrm = std::sqrt(vecDot(x, x, n));
+        if( nrm < 0.5*nrm0 )
+        {
+            orthogonalizeVector(x, Zt, zstep, nprev, n);
+            nrm = std::sqrt(vecDot(x, x, n));
+        }
+    }
+
+    nrm = nrm > 0 ? 1./nrm : 0.;
+    for( i = 0; i < n; i++ )
+        x[i] *= nrm;
+}
+
+/*
+   The Jacobi method, the full and the partial (top-k) tridiagonal decompositions compute the
+   eigenvectors differently; to make the results consistent, each vector is flipped so that
+   its largest component is positive
+*/
+template<typename _Tp> static void
+normalizeEigenvectorSigns( _Tp* V, size_t vstep, int count, int n )
+{
+    for( int i = 0; i < count; i++ )
+    {
+        _Tp* v = V + i*vstep;
+        int k = 0;
+        for( int j = 1; j < n; j++ )
+            if( std::abs(v[j]) > std::abs(v[k]) )
+                k = j;
+        if( v[k] < 0 )
+            for( int j = 0; j < n; j++ )
+                v[j] = -v[j];
+    }
+}
+
+/*
+   Computes the eigenvalues (in descending order) and, optionally, eigenvectors of the symmetric
+   matrix A. If 0 < count < n, only the count largest eigenvalues and the corresponding
+   eigenvectors are computed; the eigenvectors are then found by inverse iteration
+   on the tridiagonal matrix, which makes the cost of this part O(n^2*count) instead of O(n^3).
+*/
+static bool symmetricEigen( double* A, size_t astep, int n, double* W, double* V, size_t vstep, int count )
+{
+    AutoBuffer<double> _buf(n*12 + 8);
+    double *d = _buf, *e = d + n, *beta = e + n, *buf = beta + n;
+    int i, j;
+
+    if( count <= 0 || count > n )
+        count = n;
+
+    tridiagonalize(A, astep, n, d, e, beta, buf);
+
+    if( V && count == n )
+    {
+        for( i = 0; i < n; i++ )
+        {
+            for( j = 0; j < n; j++ )
+                V[i*vstep + j] = 0;
+            V[i*vstep + i] = 1;
+        }
+        if( !tridiagQL(d, e, n, V, vstep) )
+            return false;
+    }
+    else
+    {
+        std::vector<double> d0(d, d + n), e0(e, e + n);
+        if( !tridiagQL(d, e, n, 0, 0) )
+            return false;
+        std::sort(d, d + n);
+        std::reverse(d, d + n);
+
+        if( V )
+        {
+            double tnorm = 0;
+            for( i = 0; i < n; i++ )
+                tnorm = std::max(tnorm, std::abs(d0[i]) + std::abs(e0[i]) + (i > 0 ? std::abs(e0[i-1]) : 0.));
+
+            // the vectors of the eigenvalues closer than this are explicitly orthogonalized
+            double ortol = 1e-3*tnorm, lambda = 0;
+            RNG rng(0x12345678);
+            for( i = 0, j = 0; i < count; i++ )
+            {
+                if( i > 0 && d[i-1] - d[i] > ortol )
+                    j = i;
+                // split the multiple eigenvalues a bit, so that inverse iteration gives different vectors
+                lambda = i > 0 && d[i] >= lambda ? lambda - 10*DBL_EPSILON*tnorm : d[i];
+                tridiagInverseIteration(&d0[0], &e0[0], n, lambda, tnorm,
+                                        V + j*vstep, vstep, i - j, V + i*vstep, buf, rng);
+            }
+        }
+        for( i = 0; i < n; i++ )
+            W[i] = d[i];
+        if( V )
+        {
+            parallelForLarge(Range(0, count), TridiagBackTransformInvoker(A, astep, beta, n, V, vstep),
+                             (double)count*n*n);
+            normalizeEigenvectorSigns(V, vstep, count, n);
+        }
+        return true;
+    }
+
+    // sort eigenvalues & eigenvectors
+    for( i = 0; i < n; i++ )
+        W[i] = d[i];
+    for( int k = 0; k < n - 1; k++ )
+    {
+        int m = k;
+        for( i = k + 1; i < n; i++ )
+            if( W[m] < W[i] )
+                m = i;
+        if( k != m )
+        {
+            std::swap(W[m], W[k]);
+            if( V )
+                for( i = 0; i < n; i++ )
+                    std::swap(V[vstep*m + i], V[vstep*k + i]);
+        }
+    }
+
+    if( V )
+    {
+        parallelForLarge(Range(0, n), TridiagBackTransformInvoker(A, astep, beta, n, V, vstep),
+                         (double)n*n*n);
+        normalizeEigenvectorSigns(V, vstep, n, n);
+    }
+    return true;
+}
+
+/////////////////////////////////// SVD ////////////////////////////////////
+
+// work[ofs:ofs+len] = sum_{j0 <= j < j1} x[j]*X_j[ofs:ofs+len], computed by stripes of columns
+class RowCombinationInvoker : public ParallelLoopBody
+{
+public:
+    enum { STRIPE = 256 };
+
+    RowCombinationInvoker( const double* _X, size_t _xstep, int _j0, int _j1, int _ofs, int _len,
+                           const double* _x, double* _work ) :
+        X(_X), xstep(_xstep), j0(_j0), j1(_j1), ofs(_ofs), len(_len), x(_x), work(_work) {}
+
+    void operator()( const Range& range ) const
+    {
+        int c0 = ofs + range.start*STRIPE, c1 = ofs + std::min(range.end*STRIPE, len);
+        for( int i = c0; i < c1; i++ )
+            work[i] = 0;
+        for( int j = j0; j < j1; j++ )
+            vecAxpy(work + c0, X + j*xstep + c0, c1 - c0, x[j]);
+    }
+
+private:
+    const double* X;
+    size_t xstep;
+    int j0, j1, ofs, len;
+    const double* x;
+    double* work;
+};
+
+// X_j[ofs:ofs+len] += alpha*x[j]*work[ofs:ofs+len]
+class RowRank1Invoker : public ParallelLoopBody
+{
+public:
+    RowRank1Invoker( double* _X, size_t _xstep, int _ofs, int _len, const double* _x, double _alpha,
+                     const double* _work ) :
+        X(_X), xstep(_xstep), ofs(_ofs), len(_len), x(_x), alpha(_alpha), work(_work) {}
+
+    void operator()( const Range& range ) const
+    {
+        for( int j = range.start; j < range.end; j++ )
+            vecAxpy(X + j*xstep + ofs, work + ofs, len, alpha*x[j]);
+    }
+
+private:
+    double* X;
+    size_t xstep;
+    int ofs, len;
+    const double* x;
+    double alpha;
+    const double* work;
+};
+
+/*
+   Computes SVD of the m x n matrix A (m >= n) using Householder bidiagonalization followed
+   by the implicit QR iterations (svd procedure from LINPACK/EISPACK, as in JAMA).
+   The input matrix is passed transposed, i.e. each row of At is a column of A, which keeps
+   all the vector operations contiguous. If n1 > 0, At is replaced with the first n1 rows
+   of U' (At must have space for n1 rows then) and V' is stored in Vt.
+*/
+static bool GolubKahanSVD( double* At, size_t astep, double* s, double* Vt, size_t vstep, int m, int n, int n1 )
+{
+    const double eps = DBL_EPSILON, tiny = DBL_MIN/DBL_EPSILON;
+    const int maxIters = 75;
+    bool wantu = n1 > 0, wantv = wantu && Vt != 0;
+    int nu = std::max(n1, n);
+    int i, j, k;
+
+    AutoBuffer<double> _buf(n + m);
+    double *e = _buf, *work = e + n;
+    std::vector<PlaneRotation> urots, vrots;
+
+    int nct = std::min(m - 1, n);
+    int nrt = std::max(0, std::min(n - 2, m));
+    for( k = 0; k < std::max(nct, nrt); k++ )
+    {
+        double* ak = At + k*astep;
+        if( k < nct )
+        {
+            // the k-th column Householder reflection
+            s[k] = 0;
+            for( i = k; i < m; i++ )
+                s[k] = hypot(s[k], ak[i]);
+            if( s[k] != 0 )
+            {
+                if( ak[k] < 0 )
+                    s[k] = -s[k];
+                double scale = 1./s[k];
+                for( i = k; i < m; i++ )
+                    ak[i] *= scale;
+                ak[k] += 1;
+                reflectRows(At, astep, k + 1, n, k, m - k, ak + k, 1./ak[k]);
+            }
+            s[k] = -s[k];
+        }
+        for( j = k + 1; j < n; j++ )
+            e[j] = At[j*astep + k];
+
+        if( k < nrt )
+        {
+            // the k-th row Householder reflection
+            e[k] = 0;
+            for( i = k + 1; i < n; i++ )
+                e[k] = hypot(e[k], e[i]);
+            if( e[k] != 0 )
+            {
+                if( e[k+1] < 0 )
+                    e[k] = -e[k];
+                double scale = 1./e[k];
+                for( i = k + 1; i < n; i++ )
+                    e[i] *= scale;
+                e[k+1] += 1;
+            }
+            e[k] = -e[k];
+            if( k + 1 < m && e[k] != 0 )
+            {
+                int len = m - k - 1, nstripes = (len + RowCombinationInvoker::STRIPE - 1)/RowCombinationInvoker::STRIPE;
+                parallelForLarge(Range(0, nstripes),
+                                 RowCombinationInvoker(At, astep, k + 1, n, k + 1, len, e, work),
+                                 (double)len*(n - k - 1));
+                parallelForLarge(Range(k + 1, n),
+                                 RowRank1Invoker(At, astep, k + 1, len, e, -1./e[k+1], work),
+                                 (double)len*(n - k - 1));
+            }
+            if( wantv )
+                for( i = k + 1; i < n; i++ )
+                    Vt[k*vstep + i] = e[i];
+        }
+    }
+
+    // the final bidiagonal matrix of order p
+    int p = std::min(n, m + 1);
+    if( nct < n )
+        s[nct] = At[nct*astep + nct];
+    if( m < p )
+        s[p-1] = 0;
+    if( nrt + 1 < p )
+        e[nrt] = At[(p-1)*astep + nrt];
+    e[p-1] = 0;
+
+    if( wantu )
+    {
+        // U is stored in place of A, so its k-th row is the k-th Householder vector
+        for( j = nct; j < nu; j++ )
+        {
+            double* u = At + j*astep;
+            for( i = 0; i < m; i++ )
+                u[i] = 0;
+            u[j] = 1;
+        }
+        for( k = nct - 1; k >= 0; k-- )
+        {
+            double* u = At + k*astep;
+            if( s[k] != 0 )
+            {
+                reflectRows(At, astep, k + 1, nu, k, m - k, u + k, 1./u[k]);
+                for( i = k; i < m; i++ )
+                    u[i] = -u[i];
+                u[k] += 1;
+                for( i = 0; i < k; i++ )
+                    u[i] = 0;
+            }
+            else
+            {
+                for( i = 0; i < m; i++ )
+                    u[i] = 0;
+                u[k] = 1;
+            }
+        }
+    }
+
+    if( wantv )
+    {
+        for( k = n - 1; k >= 0; k-- )
+        {
+            double* v = Vt + k*vstep;
+            if( k < nrt && e[k] != 0 )
+                reflectRows(Vt, vstep, k + 1, n, k + 1, n - k - 1, v + k + 1, 1./v[k+1]);
+            for( i = 0; i < n; i++ )
+                v[i] = 0;
+            v[k] = 1;
+        }
+    }
+
+    // the main iteration loop for the singular values
+    int pp = p - 1, iter = 0;
+    while( p > 0 )
+    {
+        int kase;
+
+        // kase = 1: s(p) and e[k-1] are negligible and k < p
+        // kase = 2: s(k) is negligible and k < p
+        // kase = 3: e[k-1] is negligible, k < p, and s(k), ..., s(p) are not negligible (qr step)
+        // kase = 4: e(p-1) is negligible (convergence)
+        for( k = p - 2; k >= 0; k-- )
+            if( std::abs(e[k]) <= tiny + eps*(std::abs(s[k]) + std::abs(s[k+1])) )
+            {
+                e[k] = 0;
+                break;
+            }
+
+        if( k == p - 2 )
+            kase = 4;
+        else
+        {
+            int ks;
+            for( ks = p - 1; ks > k; ks-- )
+            {
+                double t = (ks != p ? std::abs(e[ks]) : 0.) + (ks != k + 1 ? std::abs(e[ks-1]) : 0.);
+                if( std::abs(s[ks]) <= tiny + eps*t )
+                {
+                    s[ks] = 0;
+                    break;
+                }
+            }
+            if( ks == k )
+                kase = 3;
+            else if( ks == p - 1 )
+                kase = 1;
+            else
+            {
+                kase = 2;
+                k = ks;
+            }
+        }
+        k++;
+
+        if( kase == 1 )
+        {
+            // deflate negligible s(p)
+            double f = e[p-2];
+            e[p-2] = 0;
+            for( j = p - 2; j >= k; j-- )
+            {
+                double t = hypot(s[j], f);
+                double cs = s[j]/t, sn = f/t;
+                s[j] = t;
+                if( j != k )
+                {
+                    f = -sn*e[j-1];
+                    e[j-1] = cs*e[j-1];
+                }
+                if( wantv )
+                    vrots.push_back(PlaneRotation(j, p-1, cs, sn));
+            }
+            rotateRows(Vt, vstep, n, vrots);
+        }
+        else if( kase == 2 )
+        {
+            // split at negligible s(k)
+            double f = e[k-1];
+            e[k-1] = 0;
+            for( j = k; j < p; j++ )
+            {
+                double t = hypot(s[j], f);
+                double cs = s[j]/t, sn = f/t;
+                s[j] = t;
+                f = -sn*e[j];
+                e[j] = cs*e[j];
+                if( wantu )
+                    urots.push_back(PlaneRotation(j, k-1, cs, sn));
+            }
+            rotateRows(At, astep, m, urots);
+        }
+        else if( kase == 3 )
+        {
+            if( ++iter > maxIters )
+                return false;
+
+            // calculate the shift
+            double scale = std::max(std::max(std::max(std::max(std::abs(s[p-1]), std::abs(s[p-2])),
+                                    std::abs(e[p-2])), std::abs(s[k])), std::abs(e[k]));
+            double sp = s[p-1]/scale, spm1 = s[p-2]/scale, epm1 = e[p-2]/scale;
+            double sk = s[k]/scale, ek = e[k]/scale;
+            double b = ((spm1 + sp)*(spm1 - sp) + epm1*epm1)/2.;
+            double c = (sp*epm1)*(sp*epm1);
+            double shift = 0;
+            if( b != 0 || c != 0 )
+            {
+                shift = std::sqrt(b*b + c);
+                if( b < 0 )
+                    shift = -shift;
+                shift = c/(b + shift);
+            }
+            double f = (sk + sp)*(sk - sp) + shift;
+            double g = sk*ek;
+
+            // chase zeros
+            for( j = k; j < p - 1; j++ )
+            {
+                double t = hypot(f, g);
+                double cs = f/t, sn = g/t;
+                if( j != k )
+                    e[j-1] = t;
+                f = cs*s[j] + sn*e[j];
+                e[j] = cs*e[j] - sn*s[j];
+                g = sn*s[j+1];
+                s[j+1] = cs*s[j+1];
+                if( wantv )
+                    vrots.push_back(PlaneRotation(j, j+1, cs, sn));
+                t = hypot(f, g);
+                cs = f/t; sn = g/t;
+                s[j] = t;
+                f = cs*e[j] + sn*s[j+1];
+                s[j+1] = -sn*e[j] + cs*s[j+1];
+                g = sn*e[j+1];
+                e[j+1] = cs*e[j+1];
+                if( wantu && j < m - 1 )
+                    urots.push_back(PlaneRotation(j, j+1, cs, sn));
+            }
+            e[p-2] = f;
+            rotateRows(Vt, vstep, n, vrots);
+            rotateRows(At, astep, m, urots);
+        }
+        else
+        {
+            // make the singular value positive
+            if( s[k] <= 0 )
+            {
+                s[k] = s[k] < 0 ? -s[k] : 0.;
+                if( wantv )
+                    for( i = 0; i <= pp; i++ )
+                        Vt[k*vstep + i] = -Vt[k*vstep + i];
+            }
+            // order the singular values
+            for( ; k < pp && s[k] < s[k+1]; k++ )
+            {
+                std::swap(s[k], s[k+1]);
+                if( wantv )
+                    for( i = 0; i < n; i++ )
+                        std::swap(Vt[k*vstep + i], Vt[(k+1)*vstep + i]);
+                if( wantu )
+                    for( i = 0; i < m; i++ )
+                        std::swap(At[k*astep + i], At[(k+1)*astep + i]);
+            }
+            iter = 0;
+            p--;
+        }
+    }
+    return true;
+}
+
 /* y[0:m,0:n] += diag(a[0:1,0:m]) * x[0:m,0:n] */
 template<typename T1, typename T2, typename T3> static void
 MatrAXPY( int m, int n, const T1* x, int dx,
@@ -1465,7 +2398,10 @@ bool cv::solve( InputArray _src, InputArray _src2arg, OutputArray _dst, int meth
 
 /////////////////// finding eigenvalues and eigenvectors of a symmetric matrix ///////////////
 
-bool cv::eigen( InputArray _src, OutputArray _evals, OutputArray _evects )
+namespace cv
+{
+
+static bool eigenImpl( InputArray _src, OutputArray _evals, OutputArray _evects, int count )
 {
     Mat src = _src.getMat();
     int type = src.type();
@@ -1474,11 +2410,33 @@ bool cv::eigen( InputArray _src, OutputArray _evals, OutputArray _evects )
     CV_Assert( src.rows == src.cols );
     CV_Assert (type == CV_32F || type == CV_64F);
 
+    if( count <= 0 || count > n )
+        count = n;
+
+    if( n > JACOBI_MAX_SIZE )
+    {
+        Mat a, v, w(n, 1, CV_64F);
+        src.convertTo(a, CV_64F);
+        if( _evects.needed() )
+            v.create(count, n, CV_64F);
+        bool ok = symmetricEigen(a.ptr<double>(), a.step/sizeof(double), n, w.ptr<double>(),
+                                 v.data ? v.ptr<double>() : 0, v.step/sizeof(double), count);
+        w.rowRange(0, count).convertTo(_evals, type);
+        if( _evects.needed() )
+            v.convertTo(_evects, type);
+        return ok;
+    }
+
     Mat v;
     if( _evects.needed() )
     {
-        _evects.create(n, n, type);
-        v = _evects.getMat();
+        if( count < n )
+            v.create(n, n, type);
+        else
+        {
+            _evects.create(n, n, type);
+            v = _evects.getMat();
+        }
     }
 
     size_t elemSize = src.elemSize(), astep = alignSize(n*elemSize, 16);
@@ -1490,11 +2448,32 @@ bool cv::eigen( InputArray _src, OutputArray _evals, OutputArray _evects )
     bool ok = type == CV_32F ?
         Jacobi(a.ptr<float>(), a.step, w.ptr<float>(), v.ptr<float>(), v.step, n, ptr) :
         Jacobi(a.ptr<double>(), a.step, w.ptr<double>(), v.ptr<double>(), v.step, n, ptr);
+    if( v.data )
+    {
+        if( type == CV_32F )
+            normalizeEigenvectorSigns(v.ptr<float>(), v.step/sizeof(float), n, n);
+        else
+            normalizeEigenvectorSigns(v.ptr<double>(), v.step/sizeof(double), n, n);
+    }
 
-    w.copyTo(_evals);
+    w.rowRange(0, count).copyTo(_evals);
+    if( v.data && count < n )
+        v.rowRange(0, count).copyTo(_evects);
     return ok;
 }
 
+}
+
+bool cv::eigen( InputArray _src, OutputArray _evals, OutputArray _evects )
+{
+    return eigenImpl(_src, _evals, _evects, 0);
+}
+
+bool cv::eigen( InputArray _src, OutputArray _evals, OutputArray _evects, int maxCount )
+{
+    return eigenImpl(_src, _evals, _evects, maxCount);
+}
+
 namespace cv
 {
 
@@ -1524,6 +2503,48 @@ static void _SVDcompute( InputArray _aarr, OutputArray _w,
     }
 
     int urows = full_uv ? m : n;
+
+    if( n > JACOBI_MAX_SIZE )
+    {
+        // the larger matrices are decomposed via bidiagonalization, in double precision
+        Mat temp_a(urows, m, CV_64F), temp_w(n, 1, CV_64F), temp_v;
+        Mat a0 = temp_a.rowRange(0, n);
+        if( !at )
+        {
+            Mat src64;
+            src.convertTo(src64, CV_64F);
+            transpose(src64, a0);
+        }
+        else
+            src.convertTo(a0, CV_64F);
+
+        if( compute_uv )
+            temp_v.create(n, n, CV_64F);
+
+        GolubKahanSVD(temp_a.ptr<double>(), temp_a.step/sizeof(double), temp_w.ptr<double>(),
+                      compute_uv ? temp_v.ptr<double>() : 0, temp_v.step/sizeof(double),
+                      m, n, compute_uv ? urows : 0);
+
+        temp_w.convertTo(_w, type);
+        if( compute_uv )
+        {
+            Mat tmp;
+            if( !at )
+            {
+                transpose(temp_a, tmp);
+                tmp.convertTo(_u, type);
+                temp_v.convertTo(_vt, type);
+            }
+            else
+            {
+                transpose(temp_v, tmp);
+                tmp.convertTo(_u, type);
+                temp_a.convertTo(_vt, type);
+            }
+        }
+        return;
+    }
+
     size_t esz = src.elemSize(), astep = alignSize(m*esz, 16), vstep = alignSize(n*esz, 16);
     AutoBuffer<uchar> _buf(urows*astep + n*vstep + n*esz + 32);
     uchar* buf = alignPtr((uchar*)_buf, 16);
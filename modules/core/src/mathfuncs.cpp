@@ -87,6 +87,10 @@ static void FastAtan2_32f(const float *Y, const float *X, float *angle, int len,
         return;
 #endif
 
+    const SIMDKernels* simd = currentSIMDKernels;
+    if( simd )
+        i = simd->fastAtan2_32f(Y, X, angle, len, angleInDegrees);
+
 #if CV_SSE2
     if( USE_SSE2 )
     {
@@ -198,6 +202,10 @@ static void Magnitude_32f(const float* x, const float* y, float* mag, int len)
 {
     int i = 0;
 
+    const SIMDKernels* simd = currentSIMDKernels;
+    if( simd )
+        i = simd->magnitude32f(x, y, mag, len);
+
 #if CV_SSE
     if( USE_SSE2 )
     {
@@ -781,6 +789,10 @@ static void Exp_32f( const float *_x, float *y, int n )
     const Cv32suf* x = (const Cv32suf*)_x;
     Cv32suf buf[4];
 
+    const SIMDKernels* simd = currentSIMDKernels;
+    if( simd )
+        i = simd->exp32f(_x, y, n, expTab);
+
 #if CV_SSE2
     if( n >= 8 && USE_SSE2 )
     {
@@ -1464,6 +1476,10 @@ static void Log_32f( const float *_x, float *y, int n )
     Cv32suf buf[4];
     const int* x = (const int*)_x;
 
+    const SIMDKernels* simd = currentSIMDKernels;
+    if( simd )
+        i = simd->log32f(_x, y, n, icvLogTab);
+
 #if CV_SSE2
     if( USE_SSE2 )
     {
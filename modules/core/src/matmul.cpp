@@ -693,6 +693,287 @@ static void GEMMStore_64fc( const Complexd* c_data, size_t c_step,
     GEMMStore(c_data, c_step, d_buf, d_buf_step, d_data, d_step, d_size, alpha, beta, flags);
 }
 
+/*
+   Packed-panel GEMM for single-channel float and double matrices.
+
+   D = alpha*op(A)*op(B) + beta*op(C) is computed by blocks: a KC x NC panel of op(B) is packed
+   into NR-column slivers, then an MC x KC block of op(A) is packed into MR-row slivers, and the
+   MR x NR micro-kernel multiplies a pair of slivers keeping the whole MR x NR tile of the product
+   in registers. The transposition flags only change the way the panels are packed. The MC x NC
+   blocks of D are distributed between the threads with parallel_for_.
+*/
+
+template<typename T> struct GEMMPackedParams {};
+template<> struct GEMMPackedParams<float> { enum { MR = 4, NR = 8, KC = 256, MC = 128, NC = 2048 }; };
+template<> struct GEMMPackedParams<double> { enum { MR = 4, NR = 4, KC = 256, MC = 64, NC = 1024 }; };
+
+// the number of columns of D processed by a parallel_for_ stripe
+enum { GEMM_PACKED_STRIPE_WIDTH = 256 };
+
+// packs op(A)(i0:i0+mc, k0:k0+kc) into MR-row slivers; the last sliver is padded with zeros
+template<typename T, int MR> static void
+GEMMPackA( const T* a, size_t a_step, bool t, int i0, int mc, int k0, int kc, T* buf )
+{
+    for( int i = 0; i < mc; i += MR, buf += MR*kc )
+    {
+        int r, m = std::min(mc - i, MR);
+        for( int k = 0; k < kc; k++ )
+        {
+            T* dst = buf + k*MR;
+            if( !t )
+                for( r = 0; r < m; r++ )
+                    dst[r] = a[(i0 + i + r)*a_step + k0 + k];
+            else
+            {
+                const T* src = a + (k0 + k)*a_step + i0 + i;
+                for( r = 0; r < m; r++ )
+                    dst[r] = src[r];
+            }
+            for( ; r < MR; r++ )
+                dst[r] = 0;
+        }
+    }
+}
+
+// packs op(B)(k0:k0+kc, j0:j0+nc) into NR-column slivers; the last sliver is padded with zeros
+template<typename T, int NR> static void
+GEMMPackB( const T* b, size_t b_step, bool t, int k0, int kc, int j0, int nc, T* buf )
+{
+    for( int j = 0; j < nc; j += NR, buf += NR*kc )
+    {
+        int c, n = std::min(nc - j, NR);
+        for( int k = 0; k < kc; k++ )
+        {
+            T* dst = buf + k*NR;
+            if( !t )
+            {
+                const T* src = b + (k0 + k)*b_step + j0 + j;
+                for( c = 0; c < n; c++ )
+                    dst[c] = src[c];
+            }
+            else
+                for( c = 0; c < n; c++ )
+                    dst[c] = b[(j0 + j + c)*b_step + k0 + k];
+            for( ; c < NR; c++ )
+                dst[c] = 0;
+        }
+    }
+}
+
+// adds alpha*(the product of the slivers) to the m x n (m <= MR, n <= NR) tile of D
+template<typename T, int MR, int NR> static void
+GEMMMicroKernel( int kc, const T* a, const T* b, T* d, size_t d_step, int m, int n, T alpha )
+{
+    T acc[MR][NR];
+    int i, j;
+
+    for( i = 0; i < MR; i++ )
+        for( j = 0; j < NR; j++ )
+            acc[i][j] = 0;
+
+    for( int k = 0; k < kc; k++, a += MR, b += NR )
+        for( i = 0; i < MR; i++ )
+        {
+            T ai = a[i];
+            for( j = 0; j < NR; j++ )
+                acc[i][j] += ai*b[j];
+        }
+
+    for( i = 0; i < m; i++, d += d_step )
+        for( j = 0; j < n; j++ )
+            d[j] += alpha*acc[i][j];
+}
+
+static void
+GEMMMicroKernel_32f( int kc, const float* a, const float* b, float* d, size_t d_step, int m, int n, float alpha )
+{
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128 c00 = _mm_setzero_ps(), c01 = c00, c10 = c00, c11 = c00;
+        __m128 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+
+        for( int k = 0; k < kc; k++, a += 4, b += 8 )
+        {
+            __m128 b0 = _mm_load_ps(b), b1 = _mm_load_ps(b + 4), ai;
+            ai = _mm_set1_ps(a[0]);
+            c00 = _mm_add_ps(c00, _mm_mul_ps(ai, b0)); c01 = _mm_add_ps(c01, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[1]);
+            c10 = _mm_add_ps(c10, _mm_mul_ps(ai, b0)); c11 = _mm_add_ps(c11, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[2]);
+            c20 = _mm_add_ps(c20, _mm_mul_ps(ai, b0)); c21 = _mm_add_ps(c21, _mm_mul_ps(ai, b1));
+            ai = _mm_set1_ps(a[3]);
+            c30 = _mm_add_ps(c30, _mm_mul_ps(ai, b0)); c31 = _mm_add_ps(c31, _mm_mul_ps(ai, b1));
+        }
+
+        __m128 valpha = _mm_set1_ps(alpha);
+        if( m == 4 && n == 8 )
+        {
+            __m128* acc[] = { &c00, &c01, &c10, &c11, &c20, &c21, &c30, &c31 };
+            for( int i = 0; i < 4; i++, d += d_step )
+            {
+                _mm_storeu_ps(d, _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(*acc[i*2], valpha)));
+                _mm_storeu_ps(d + 4, _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(*acc[i*2+1], valpha)));
+            }
+        }
+        else
+        {
+            float CV_DECL_ALIGNED(16) buf[4][8];
+            _mm_store_ps(buf[0], c00); _mm_store_ps(buf[0] + 4, c01);
+            _mm_store_ps(buf[1], c10); _mm_store_ps(buf[1] + 4, c11);
+            _mm_store_ps(buf[2], c20); _mm_store_ps(buf[2] + 4, c21);
+            _mm_store_ps(buf[3], c30); _mm_store_ps(buf[3] + 4, c31);
+            for( int i = 0; i < m; i++, d += d_step )
+                for( int j = 0; j < n; j++ )
+                    d[j] += alpha*buf[i][j];
+        }
+        return;
+    }
+#endif
+    GEMMMicroKernel<float, 4, 8>(kc, a, b, d, d_step, m, n, alpha);
+}
+
+static void
+GEMMMicroKernel_64f( int kc, const double* a, const double* b, double* d, size_t d_step, int m, int n, double alpha )
+{
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128d c00 = _mm_setzero_pd(), c01 = c00, c10 = c00, c11 = c00;
+        __m128d c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+
+        for( int k = 0; k < kc; k++, a += 4, b += 4 )
+        {
+            __m128d b0 = _mm_load_pd(b), b1 = _mm_load_pd(b + 2), ai;
+            ai = _mm_set1_pd(a[0]);
+            c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[1]);
+            c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[2]);
+            c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+            ai = _mm_set1_pd(a[3]);
+            c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+        }
+
+        double CV_DECL_ALIGNED(16) buf[4][4];
+        __m128d valpha = _mm_set1_pd(alpha);
+        _mm_store_pd(buf[0], _mm_mul_pd(c00, valpha)); _mm_store_pd(buf[0] + 2, _mm_mul_pd(c01, valpha));
+        _mm_store_pd(buf[1], _mm_mul_pd(c10, valpha)); _mm_store_pd(buf[1] + 2, _mm_mul_pd(c11, valpha));
+        _mm_store_pd(buf[2], _mm_mul_pd(c20, valpha)); _mm_store_pd(buf[2] + 2, _mm_mul_pd(c21, valpha));
+        _mm_store_pd(buf[3], _mm_mul_pd(c30, valpha)); _mm_store_pd(buf[3] + 2, _mm_mul_pd(c31, valpha));
+        for( int i = 0; i < m; i++, d += d_step )
+            for( int j = 0; j < n; j++ )
+                d[j] += buf[i][j];
+        return;
+    }
+#endif
+    GEMMMicroKernel<double, 4, 4>(kc, a, b, d, d_step, m, n, alpha);
+}
+
+static inline void GEMMMicroKernel_( int kc, const float* a, const float* b, float* d, size_t d_step,
+                                     int m, int n, float alpha )
+{
+    GEMMMicroKernel_32f(kc, a, b, d, d_step, m, n, alpha);
+}
+
+static inline void GEMMMicroKernel_( int kc, const double* a, const double* b, double* d, size_t d_step,
+                                     int m, int n, double alpha )
+{
+    GEMMMicroKernel_64f(kc, a, b, d, d_step, m, n, alpha);
+}
+
+template<typename T> class GEMMPackedInvoker : public ParallelLoopBody
+{
+public:
+    typedef GEMMPackedParams<T> P;
+
+    GEMMPackedInvoker( const Mat& _A, bool _a_t, const T* _b_panel, Mat& _D,
+                       int _j0, int _nc, int _k0, int _kc, T _alpha )
+        : A(&_A), a_t(_a_t), b_panel(_b_panel), D(&_D), j0(_j0), nc(_nc), k0(_k0), kc(_kc), alpha(_alpha)
+    {
+        nstripes_x = (nc + GEMM_PACKED_STRIPE_WIDTH - 1)/GEMM_PACKED_STRIPE_WIDTH;
+        nstripes_y = (D->rows + P::MC - 1)/P::MC;
+    }
+
+    // every stripe is an MC x GEMM_PACKED_STRIPE_WIDTH block of D
+    void operator()( const Range& range ) const
+    {
+        ScratchBuffer<T> a_buf(P::MC*kc);
+        size_t a_step = A->step/sizeof(T), d_step = D->step/sizeof(T);
+
+        for( int idx = range.start; idx < range.end; idx++ )
+        {
+            int i0 = (idx / nstripes_x)*P::MC, mc = std::min(D->rows - i0, (int)P::MC);
+            int x0 = (idx % nstripes_x)*GEMM_PACKED_STRIPE_WIDTH;
+            int x1 = std::min(x0 + GEMM_PACKED_STRIPE_WIDTH, nc);
+
+            GEMMPackA<T, P::MR>((const T*)A->data, a_step, a_t, i0, mc, k0, kc, a_buf);
+
+            for( int j = x0; j < x1; j += P::NR )
+            {
+                const T* b = b_panel + (j/P::NR)*P::NR*kc;
+                T* d = (T*)(D->data + D->step*i0) + j0 + j;
+                int n = std::min(x1 - j, (int)P::NR);
+
+                for( int i = 0; i < mc; i += P::MR, d += d_step*P::MR )
+                    GEMMMicroKernel_(kc, (const T*)a_buf + i*kc, b, d, d_step,
+                                     std::min(mc - i, (int)P::MR), n, alpha);
+            }
+        }
+    }
+
+    int stripes() const { return nstripes_x*nstripes_y; }
+
+private:
+    const Mat* A;
+    bool a_t;
+    const T* b_panel;
+    Mat* D;
+    int j0, nc, k0, kc;
+    int nstripes_x, nstripes_y;
+    T alpha;
+};
+
+template<typename T> static void
+GEMMPacked( const Mat& A, const Mat& B, double alpha, const Mat& C, double beta, Mat& D, int flags )
+{
+    typedef GEMMPackedParams<T> P;
+    bool a_t = (flags & GEMM_1_T) != 0, b_t = (flags & GEMM_2_T) != 0;
+    int N = D.cols, K = a_t ? A.rows : A.cols;
+    size_t b_step = B.step/sizeof(T);
+
+    // D = beta*op(C); the product is accumulated into it
+    if( C.data && beta != 0 )
+    {
+        if( flags & GEMM_3_T )
+            transpose(C, D);
+        else if( C.data != D.data )
+            C.copyTo(D);
+        if( beta != 1 )
+            D.convertTo(D, D.type(), beta);
+    }
+    else
+        D = Scalar::all(0);
+
+    ScratchBuffer<T> b_buf((size_t)P::KC*((std::min(N, (int)P::NC) + P::NR - 1)/P::NR*P::NR));
+
+    for( int j0 = 0; j0 < N; j0 += P::NC )
+    {
+        int nc = std::min(N - j0, (int)P::NC);
+        for( int k0 = 0; k0 < K; k0 += P::KC )
+        {
+            int kc = std::min(K - k0, (int)P::KC);
+            GEMMPackB<T, P::NR>((const T*)B.data, b_step, b_t, k0, kc, j0, nc, b_buf);
+
+            GEMMPackedInvoker<T> invoker(A, a_t, b_buf, D, j0, nc, k0, kc, (T)alpha);
+            if( (double)D.rows*nc*kc >= 1 << 20 )
+                parallel_for_(Range(0, invoker.stripes()), invoker, invoker.stripes());
+            else
+                invoker(Range(0, invoker.stripes()));
+        }
+    }
+}
+
 }
 
 void cv::gemm( InputArray matA, InputArray matB, double alpha,
@@ -1007,6 +1288,20 @@ void cv::gemm( InputArray matA, InputArray matB, double alpha,
         }
     }
 
+    if( (type == CV_32FC1 || type == CV_64FC1) && useOptimized() &&
+        std::min(d_size.width, d_size.height) >= 8 && len >= 8 &&
+        (double)d_size.width*d_size.height*len >= 32768 )
+    {
+        Mat dst = D.data == A.data || D.data == B.data ? Mat(d_size, type) : D;
+        if( type == CV_32FC1 )
+            GEMMPacked<float>(A, B, alpha, C, beta, dst, flags);
+        else
+            GEMMPacked<double>(A, B, alpha, C, beta, dst, flags);
+        if( dst.data != D.data )
+            dst.copyTo(D);
+        return;
+    }
+
     {
     size_t b_step = B.step;
     GEMMSingleMulFunc singleMulFunc;
@@ -2855,7 +3150,8 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
     }
 
     calcCovarMatrix( data, covar, mean, covar_flags, ctype );
-    eigen( covar, eigenvalues, eigenvectors );
+    // only the retained components are computed
+    eigen( covar, eigenvalues, eigenvectors, out_count );
 
     if( !(covar_flags & CV_COVAR_NORMAL) )
     {
@@ -2873,7 +3169,7 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
             tmp_data = tmp_mean;
         }
 
-        Mat evects1(count, len, ctype);
+        Mat evects1(out_count, len, ctype);
         gemm( eigenvectors, tmp_data, 1, Mat(), 0, evects1,
             (flags & CV_PCA_DATA_AS_COL) ? CV_GEMM_B_T : 0);
         eigenvectors = evects1;
@@ -2886,12 +3182,6 @@ PCA& PCA::operator()(InputArray _data, InputArray __mean, int flags, int maxComp
         }
     }
 
-    if( count > out_count )
-    {
-        // use clone() to physically copy the data and thus deallocate the original matrices
-        eigenvalues = eigenvalues.rowRange(0,out_count).clone();
-        eigenvectors = eigenvectors.rowRange(0,out_count).clone();
-    }
     return *this;
 }
 
@@ -47,6 +47,7 @@
 // */
 
 #include "precomp.hpp"
+#include <functional>
 
 namespace cv
 {
@@ -205,6 +206,25 @@ public:
 
 static MatOp_Initializer g_MatOp_Initializer;
 
+class MatOp_Fused : public MatOp
+{
+public:
+    MatOp_Fused() {}
+    virtual ~MatOp_Fused() {}
+
+    bool elementWise(const MatExpr& /*expr*/) const { return true; }
+    void assign(const MatExpr& expr, Mat& m, int type=-1) const;
+
+    int type(const MatExpr& expr) const;
+
+    static bool makeExpr(MatExpr& res, char op, const MatExpr& e1, const MatExpr& e2, double scale=1);
+    static bool makeExpr(MatExpr& res, char op, const MatExpr& e, const Scalar& s);
+    static bool makeCmpExpr(MatExpr& res, int cmpop, const MatExpr& e1, const MatExpr& e2);
+    static bool makeCmpExpr(MatExpr& res, int cmpop, const MatExpr& e, double s);
+};
+
+static MatOp_Fused g_MatOp_Fused;
+
 static inline bool isIdentity(const MatExpr& e) { return e.op == &g_MatOp_Identity; }
 static inline bool isAddEx(const MatExpr& e) { return e.op == &g_MatOp_AddEx; }
 static inline bool isScaled(const MatExpr& e) { return isAddEx(e) && (!e.b.data || e.beta == 0) && e.s == Scalar(); }
@@ -217,6 +237,10 @@ static inline bool isSolve(const MatExpr& e) { return e.op == &g_MatOp_Solve; }
 static inline bool isGEMM(const MatExpr& e) { return e.op == &g_MatOp_GEMM; }
 static inline bool isMatProd(const MatExpr& e) { return e.op == &g_MatOp_GEMM && (!e.c.data || e.beta == 0); }
 static inline bool isInitializer(const MatExpr& e) { return e.op == &g_MatOp_Initializer; }
+static inline bool isFused(const MatExpr& e) { return e.op == &g_MatOp_Fused; }
+// the expressions that MatOp::add() and MatOp::multiply() use without evaluating them first
+static inline bool isTerm(const MatExpr& e) { return isIdentity(e) || (isAddEx(e) && (!e.b.data || e.beta == 0)); }
+static inline bool isFactor(const MatExpr& e) { return isIdentity(e) || isScaled(e) || isReciprocal(e); }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -332,6 +356,9 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 {
     if( this == e2.op )
     {
+        if( (!isTerm(e1) || !isTerm(e2)) && MatOp_Fused::makeExpr(res, '+', e1, e2) )
+            return;
+
         double alpha = 1, beta = 1;
         Scalar s;
         Mat m1, m2;
@@ -361,6 +388,9 @@ void MatOp::add(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
 void MatOp::add(const MatExpr& expr1, const Scalar& s, MatExpr& res) const
 {
+    if( !isIdentity(expr1) && MatOp_Fused::makeExpr(res, '+', expr1, s) )
+        return;
+
     Mat m1;
     expr1.op->assign(expr1, m1);
     MatOp_AddEx::makeExpr(res, m1, Mat(), 1, 0, s);
@@ -371,6 +401,9 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 {
     if( this == e2.op )
     {
+        if( (!isTerm(e1) || !isTerm(e2)) && MatOp_Fused::makeExpr(res, '-', e1, e2) )
+            return;
+
         double alpha = 1, beta = -1;
         Scalar s;
         Mat m1, m2;
@@ -400,6 +433,9 @@ void MatOp::subtract(const MatExpr& e1, const MatExpr& e2, MatExpr& res) const
 
 void MatOp::subtract(const Scalar& s, const MatExpr& expr, MatExpr& res) const
 {
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, '-', expr, s) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), -1, 0, s);
@@ -410,6 +446,9 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
 {
     if( this == e2.op )
     {
+        if( (!isFactor(e1) || !isFactor(e2)) && MatOp_Fused::makeExpr(res, '*', e1, e2, scale) )
+            return;
+
         Mat m1, m2;
 
         if( isReciprocal(e1) )
@@ -459,6 +498,9 @@ void MatOp::multiply(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double
 
 void MatOp::multiply(const MatExpr& expr, double s, MatExpr& res) const
 {
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, '*', expr, Scalar(s)) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_AddEx::makeExpr(res, m, Mat(), s, 0);
@@ -469,6 +511,9 @@ void MatOp::divide(const MatExpr& e1, const MatExpr& e2, MatExpr& res, double sc
 {
     if( this == e2.op )
     {
+        if( (!isFactor(e1) || !isFactor(e2)) && MatOp_Fused::makeExpr(res, '/', e1, e2, scale) )
+            return;
+
         if( isReciprocal(e1) && isReciprocal(e2) )
             MatOp_Bin::makeExpr(res, '/', e2.a, e1.a, e1.alpha/e2.alpha);
         else
@@ -515,6 +560,9 @@ void MatOp::divide(double s, const MatExpr& expr, MatExpr& res) const
 
 void MatOp::abs(const MatExpr& expr, MatExpr& res) const
 {
+    if( !isIdentity(expr) && MatOp_Fused::makeExpr(res, 'a', expr, Scalar()) )
+        return;
+
     Mat m;
     expr.op->assign(expr, m);
     MatOp_Bin::makeExpr(res, 'a', m, Mat());
@@ -1075,6 +1123,97 @@ MatExpr max(double s, const Mat& a)
     return e;
 }
 
+// the comparisons, min() and max() of expressions extend the fused element-wise expression if possible;
+// otherwise the expressions are evaluated and the operation is applied to the result
+#define CV_MAT_EXPR_CMP_OP(op, cmpop, swapped_cmpop) \
+MatExpr operator op (const MatExpr& e, const Mat& m) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeCmpExpr(res, cmpop, e, MatExpr(m)) ) \
+        MatOp_Cmp::makeExpr(res, cmpop, (Mat)e, m); \
+    return res; \
+} \
+\
+MatExpr operator op (const Mat& m, const MatExpr& e) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeCmpExpr(res, cmpop, MatExpr(m), e) ) \
+        MatOp_Cmp::makeExpr(res, cmpop, m, (Mat)e); \
+    return res; \
+} \
+\
+MatExpr operator op (const MatExpr& e1, const MatExpr& e2) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeCmpExpr(res, cmpop, e1, e2) ) \
+        MatOp_Cmp::makeExpr(res, cmpop, (Mat)e1, (Mat)e2); \
+    return res; \
+} \
+\
+MatExpr operator op (const MatExpr& e, double s) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeCmpExpr(res, cmpop, e, s) ) \
+        MatOp_Cmp::makeExpr(res, cmpop, (Mat)e, s); \
+    return res; \
+} \
+\
+MatExpr operator op (double s, const MatExpr& e) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeCmpExpr(res, swapped_cmpop, e, s) ) \
+        MatOp_Cmp::makeExpr(res, swapped_cmpop, (Mat)e, s); \
+    return res; \
+}
+
+CV_MAT_EXPR_CMP_OP(<, CV_CMP_LT, CV_CMP_GT)
+CV_MAT_EXPR_CMP_OP(<=, CV_CMP_LE, CV_CMP_GE)
+CV_MAT_EXPR_CMP_OP(==, CV_CMP_EQ, CV_CMP_EQ)
+CV_MAT_EXPR_CMP_OP(!=, CV_CMP_NE, CV_CMP_NE)
+CV_MAT_EXPR_CMP_OP(>=, CV_CMP_GE, CV_CMP_LE)
+CV_MAT_EXPR_CMP_OP(>, CV_CMP_GT, CV_CMP_LT)
+
+#define CV_MAT_EXPR_MINMAX_OP(func, op) \
+MatExpr func(const MatExpr& e, const Mat& m) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeExpr(res, op, e, MatExpr(m)) ) \
+        MatOp_Bin::makeExpr(res, op, (Mat)e, m); \
+    return res; \
+} \
+\
+MatExpr func(const Mat& m, const MatExpr& e) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeExpr(res, op, MatExpr(m), e) ) \
+        MatOp_Bin::makeExpr(res, op, m, (Mat)e); \
+    return res; \
+} \
+\
+MatExpr func(const MatExpr& e1, const MatExpr& e2) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeExpr(res, op, e1, e2) ) \
+        MatOp_Bin::makeExpr(res, op, (Mat)e1, (Mat)e2); \
+    return res; \
+} \
+\
+MatExpr func(const MatExpr& e, double s) \
+{ \
+    MatExpr res; \
+    if( !MatOp_Fused::makeExpr(res, op, e, Scalar(s)) ) \
+        MatOp_Bin::makeExpr(res, op, (Mat)e, s); \
+    return res; \
+} \
+\
+MatExpr func(double s, const MatExpr& e) \
+{ \
+    return func(e, s); \
+}
+
+CV_MAT_EXPR_MINMAX_OP(min, 'm')
+CV_MAT_EXPR_MINMAX_OP(max, 'M')
+
 MatExpr operator & (const Mat& a, const Mat& b)
 {
     MatExpr e;
@@ -1588,6 +1727,469 @@ inline void MatOp_Initializer::makeExpr(MatExpr& res, int method, int ndims, con
     res = MatExpr(&g_MatOp_Initializer, method, Mat(ndims, sizes, type, (void*)0), Mat(), Mat(), alpha, 0);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*
+   Fused element-wise expressions.
+
+   A chain of element-wise operations on floating-point matrices, such as a*alpha + b*beta - c
+   or abs(a - b) > t, is evaluated in a single pass over the data instead of computing
+   a temporary matrix per operation. The chain starts with the value of the matrix a and applies
+   up to FusedChain::MAX_STEPS steps to it. The step codes are packed into MatExpr::flags,
+   FUSED_STEP_BITS bits per step; the matrix operands of the steps are taken from b and c and
+   the constants from alpha, beta and s[0..3], in the order of the steps.
+
+   Integer matrices are not fused, since the result of every operation on them is saturated.
+*/
+
+enum
+{
+    FUSED_ADD_M = 1, // v += m*k
+    FUSED_MUL_M,     // v *= m
+    FUSED_DIV_M,     // v = m != 0 ? v/m : 0, as in cv::divide
+    FUSED_MIN_M,     // v = min(v, m)
+    FUSED_MAX_M,     // v = max(v, m)
+    FUSED_ADD_C,     // v += k
+    FUSED_MUL_C,     // v *= k
+    FUSED_MIN_C,     // v = min(v, k)
+    FUSED_MAX_C,     // v = max(v, k)
+    FUSED_ABS,       // v = |v|
+    FUSED_CMP_M,     // FUSED_CMP_M + cmpop: v = v cmpop m ? 255 : 0
+    FUSED_CMP_C = FUSED_CMP_M + 6, // FUSED_CMP_C + cmpop: v = v cmpop k ? 255 : 0
+    FUSED_STEP_BITS = 5,
+    FUSED_TILE = 1024
+};
+
+static inline bool fusedStepUsesMat(int op)
+{
+    return op <= FUSED_MAX_M || (op >= FUSED_CMP_M && op < FUSED_CMP_C);
+}
+
+static inline bool fusedStepUsesConst(int op)
+{
+    return op == FUSED_ADD_M || (op >= FUSED_ADD_C && op <= FUSED_MAX_C) || op >= FUSED_CMP_C;
+}
+
+struct FusedChain
+{
+    enum { MAX_STEPS = 6, MAX_MATS = 3, MAX_CONSTS = 6 };
+
+    FusedChain() : nsteps(0), nmats(0), nconsts(0) {}
+
+    void reset()
+    {
+        for( int i = 0; i < nmats; i++ )
+            mats[i].release();
+        nsteps = nmats = nconsts = 0;
+    }
+
+    bool start(const Mat& m)
+    {
+        int depth = m.depth();
+        if( !m.data || m.dims > 2 || (depth != CV_32F && depth != CV_64F) )
+            return false;
+        mats[0] = m;
+        nmats = 1;
+        return true;
+    }
+
+    bool isFinal() const { return nsteps > 0 && ops[nsteps-1] >= FUSED_CMP_M; }
+
+    bool addStep(int op, const Mat& m=Mat(), double k=0)
+    {
+        if( nsteps >= MAX_STEPS || isFinal() )
+            return false;
+        if( fusedStepUsesMat(op) )
+        {
+            if( nmats >= MAX_MATS || !m.data || m.dims > 2 ||
+                m.type() != mats[0].type() || m.size() != mats[0].size() )
+                return false;
+            mats[nmats++] = m;
+        }
+        if( fusedStepUsesConst(op) )
+        {
+            if( nconsts >= MAX_CONSTS )
+                return false;
+            consts[nconsts++] = k;
+        }
+        ops[nsteps++] = op;
+        return true;
+    }
+
+    // the scalar can be used as a constant if it is the same for every channel
+    bool isConst(const Scalar& s) const
+    {
+        int cn = mats[0].channels();
+        if( cn > 4 )
+            return s == Scalar();
+        for( int i = 1; i < cn; i++ )
+            if( s[i] != s[0] )
+                return false;
+        return true;
+    }
+
+    // represents the expression as a chain
+    bool init(const MatExpr& e)
+    {
+        if( isIdentity(e) )
+            return start(e.a);
+        if( isAddEx(e) )
+            return start(e.a) && isConst(e.s) &&
+                (e.alpha == 1 || addStep(FUSED_MUL_C, Mat(), e.alpha)) &&
+                (!e.b.data || e.beta == 0 || addStep(FUSED_ADD_M, e.b, e.beta)) &&
+                (e.s[0] == 0 || addStep(FUSED_ADD_C, Mat(), e.s[0]));
+        if( isCmp(e) )
+            return start(e.a) && (e.b.data ? addStep(FUSED_CMP_M + e.flags, e.b) :
+                                  addStep(FUSED_CMP_C + e.flags, Mat(), e.alpha));
+        if( isBin(e, '*') || (isBin(e, '/') && e.b.data) )
+            return start(e.a) && addStep(e.flags == '*' ? FUSED_MUL_M : FUSED_DIV_M, e.b) &&
+                (e.alpha == 1 || addStep(FUSED_MUL_C, Mat(), e.alpha));
+        if( isBin(e, 'm') || isBin(e, 'M') )
+            return start(e.a) && (e.b.data ? addStep(e.flags == 'm' ? FUSED_MIN_M : FUSED_MAX_M, e.b) :
+                                  addStep(e.flags == 'm' ? FUSED_MIN_C : FUSED_MAX_C, Mat(), e.s[0]));
+        if( isBin(e, 'a') )
+            return start(e.a) && (e.b.data ? addStep(FUSED_ADD_M, e.b, -1) :
+                                  isConst(e.s) && addStep(FUSED_ADD_C, Mat(), -e.s[0])) &&
+                addStep(FUSED_ABS);
+        if( isFused(e) )
+        {
+            const Mat* m[] = { &e.b, &e.c };
+            double k[] = { e.alpha, e.beta, e.s[0], e.s[1], e.s[2], e.s[3] };
+            int im = 0, ik = 0;
+            if( !start(e.a) )
+                return false;
+            for( int i = 0; i < MAX_STEPS; i++ )
+            {
+                int op = (e.flags >> (i*FUSED_STEP_BITS)) & ((1 << FUSED_STEP_BITS) - 1);
+                if( op == 0 )
+                    break;
+                const Mat& mi = fusedStepUsesMat(op) ? *m[im++] : Mat();
+                double ki = fusedStepUsesConst(op) ? k[ik++] : 0;
+                if( !addStep(op, mi, ki) )
+                    return false;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // adds scale*e to the chain, where e is a weighted sum of matrices and a constant
+    bool addTerms(const MatExpr& e, double scale)
+    {
+        if( isIdentity(e) )
+            return addStep(FUSED_ADD_M, e.a, scale);
+        if( isAddEx(e) )
+            return isConst(e.s) && addStep(FUSED_ADD_M, e.a, e.alpha*scale) &&
+                (!e.b.data || e.beta == 0 || addStep(FUSED_ADD_M, e.b, e.beta*scale)) &&
+                (e.s[0] == 0 || addStep(FUSED_ADD_C, Mat(), e.s[0]*scale));
+        return false;
+    }
+
+    void store(MatExpr& res) const
+    {
+        int flags = 0;
+        double k[MAX_CONSTS] = {0};
+        for( int i = 0; i < nsteps; i++ )
+            flags |= ops[i] << (i*FUSED_STEP_BITS);
+        for( int i = 0; i < nconsts; i++ )
+            k[i] = consts[i];
+        res = MatExpr(&g_MatOp_Fused, flags, mats[0], nmats > 1 ? mats[1] : Mat(),
+                      nmats > 2 ? mats[2] : Mat(), k[0], k[1], Scalar(k[2], k[3], k[4], k[5]));
+    }
+
+    int type() const
+    {
+        return isFinal() ? CV_MAKETYPE(CV_8U, mats[0].channels()) : mats[0].type();
+    }
+
+    int nsteps, nmats, nconsts;
+    int ops[MAX_STEPS];
+    Mat mats[MAX_MATS];
+    double consts[MAX_CONSTS];
+};
+
+// a matrix multiplied by a constant
+static bool getScaled(const MatExpr& e, Mat& m, double& k)
+{
+    if( isIdentity(e) || isScaled(e) )
+    {
+        m = e.a;
+        k = isIdentity(e) ? 1 : e.alpha;
+        return true;
+    }
+    return false;
+}
+
+template<typename T, class Cmp> static void
+fusedCompare(const T* v, const T* m, T k, uchar* dst, int len, Cmp cmp)
+{
+    if( m )
+        for( int i = 0; i < len; i++ )
+            dst[i] = (uchar)(cmp(v[i], m[i]) ? 255 : 0);
+    else
+        for( int i = 0; i < len; i++ )
+            dst[i] = (uchar)(cmp(v[i], k) ? 255 : 0);
+}
+
+// runs the chain over len elements; the intermediate values stay in the tile buffer
+template<typename T> static void
+fusedTile(const FusedChain& ch, const uchar** src, uchar* dst, int len)
+{
+    T buf[FUSED_TILE];
+    const T* a = (const T*)src[0];
+    int i, im = 1, ik = 0;
+
+    for( i = 0; i < len; i++ )
+        buf[i] = a[i];
+
+    for( int step = 0; step < ch.nsteps; step++ )
+    {
+        int op = ch.ops[step];
+        const T* m = fusedStepUsesMat(op) ? (const T*)src[im++] : 0;
+        T k = fusedStepUsesConst(op) ? (T)ch.consts[ik++] : (T)0;
+
+        switch( op )
+        {
+        case FUSED_ADD_M:
+            if( k == 1 )
+                for( i = 0; i < len; i++ )
+                    buf[i] += m[i];
+            else if( k == -1 )
+                for( i = 0; i < len; i++ )
+                    buf[i] -= m[i];
+            else
+                for( i = 0; i < len; i++ )
+                    buf[i] += m[i]*k;
+            break;
+        case FUSED_MUL_M:
+            for( i = 0; i < len; i++ )
+                buf[i] *= m[i];
+            break;
+        case FUSED_DIV_M:
+            for( i = 0; i < len; i++ )
+                buf[i] = m[i] != 0 ? buf[i]/m[i] : (T)0;
+            break;
+        case FUSED_MIN_M:
+            for( i = 0; i < len; i++ )
+                buf[i] = std::min(buf[i], m[i]);
+            break;
+        case FUSED_MAX_M:
+            for( i = 0; i < len; i++ )
+                buf[i] = std::max(buf[i], m[i]);
+            break;
+        case FUSED_ADD_C:
+            for( i = 0; i < len; i++ )
+                buf[i] += k;
+            break;
+        case FUSED_MUL_C:
+            for( i = 0; i < len; i++ )
+                buf[i] *= k;
+            break;
+        case FUSED_MIN_C:
+            for( i = 0; i < len; i++ )
+                buf[i] = std::min(buf[i], k);
+            break;
+        case FUSED_MAX_C:
+            for( i = 0; i < len; i++ )
+                buf[i] = std::max(buf[i], k);
+            break;
+        case FUSED_ABS:
+            for( i = 0; i < len; i++ )
+                buf[i] = std::abs(buf[i]);
+            break;
+        default:
+            switch( (op - FUSED_CMP_M) % 6 )
+            {
+            case CMP_EQ: fusedCompare(buf, m, k, dst, len, std::equal_to<T>()); break;
+            case CMP_GT: fusedCompare(buf, m, k, dst, len, std::greater<T>()); break;
+            case CMP_GE: fusedCompare(buf, m, k, dst, len, std::greater_equal<T>()); break;
+            case CMP_LT: fusedCompare(buf, m, k, dst, len, std::less<T>()); break;
+            case CMP_LE: fusedCompare(buf, m, k, dst, len, std::less_equal<T>()); break;
+            default: fusedCompare(buf, m, k, dst, len, std::not_equal_to<T>()); break;
+            }
+            return;
+        }
+    }
+
+    memcpy(dst, buf, len*sizeof(T));
+}
+
+class FusedInvoker : public ParallelLoopBody
+{
+public:
+    FusedInvoker(const FusedChain& _ch, Mat& _dst, int _rows, int _width)
+        : ch(&_ch), dst(&_dst), rows(_rows), width(_width)
+    {
+        ntiles = (width + FUSED_TILE - 1)/FUSED_TILE;
+    }
+
+    // every row is split into tiles of FUSED_TILE elements
+    void operator()(const Range& range) const
+    {
+        const uchar* src[FusedChain::MAX_MATS];
+        size_t esz = ch->mats[0].elemSize1(), desz = dst->elemSize1();
+        bool isDouble = ch->mats[0].depth() == CV_64F;
+
+        for( int idx = range.start; idx < range.end; idx++ )
+        {
+            int y = idx / ntiles, x = (idx % ntiles)*FUSED_TILE;
+            int len = std::min(width - x, (int)FUSED_TILE);
+
+            for( int i = 0; i < ch->nmats; i++ )
+                src[i] = ch->mats[i].data + ch->mats[i].step[0]*y + esz*x;
+            uchar* d = dst->data + dst->step[0]*y + desz*x;
+
+            if( isDouble )
+                fusedTile<double>(*ch, src, d, len);
+            else
+                fusedTile<float>(*ch, src, d, len);
+        }
+    }
+
+    int total() const { return rows*ntiles; }
+
+private:
+    const FusedChain* ch;
+    Mat* dst;
+    int rows, width, ntiles;
+};
+
+void MatOp_Fused::assign(const MatExpr& e, Mat& m, int _type) const
+{
+    FusedChain ch;
+    CV_Assert( ch.init(e) );
+
+    int dtype = ch.type();
+    Mat temp, &dst = _type == -1 || _type == dtype ? m : temp;
+    const Mat& a = ch.mats[0];
+    dst.create(a.size(), dtype);
+
+    bool continuous = dst.isContinuous();
+    for( int i = 0; i < ch.nmats; i++ )
+        continuous = continuous && ch.mats[i].isContinuous();
+    int rows = continuous ? 1 : a.rows;
+    int width = (int)(continuous ? a.total() : a.cols)*a.channels();
+
+    FusedInvoker invoker(ch, dst, rows, width);
+    double work = (double)rows*width;
+    if( work >= (1 << 16) )
+        parallel_for_(Range(0, invoker.total()), invoker, work/(1 << 16));
+    else
+        invoker(Range(0, invoker.total()));
+
+    if( dst.data != m.data )
+        dst.convertTo(m, _type);
+}
+
+int MatOp_Fused::type(const MatExpr& e) const
+{
+    FusedChain ch;
+    return ch.init(e) ? ch.type() : -1;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, char op, const MatExpr& e1, const MatExpr& e2, double scale)
+{
+    FusedChain ch;
+    Mat m;
+    double k = 1;
+    bool ok = false;
+
+    if( op == '+' || op == '-' )
+    {
+        double sign = op == '+' ? 1 : -1;
+        ok = ch.init(e1) && ch.addTerms(e2, sign);
+        if( !ok )
+        {
+            ch.reset();
+            ok = ch.init(e2) && (sign > 0 || ch.addStep(FUSED_MUL_C, Mat(), -1)) && ch.addTerms(e1, 1);
+        }
+    }
+    else if( op == '*' )
+    {
+        ok = getScaled(e2, m, k) && ch.init(e1) && ch.addStep(FUSED_MUL_M, m);
+        if( !ok )
+        {
+            ch.reset();
+            ok = getScaled(e1, m, k) && ch.init(e2) && ch.addStep(FUSED_MUL_M, m);
+        }
+        ok = ok && (k*scale == 1 || ch.addStep(FUSED_MUL_C, Mat(), k*scale));
+    }
+    else if( op == '/' )
+    {
+        ok = getScaled(e2, m, k) && k != 0 && ch.init(e1) && ch.addStep(FUSED_DIV_M, m) &&
+            (scale/k == 1 || ch.addStep(FUSED_MUL_C, Mat(), scale/k));
+    }
+    else if( op == 'm' || op == 'M' )
+    {
+        int step = op == 'm' ? FUSED_MIN_M : FUSED_MAX_M;
+        if( isIdentity(e1) && isIdentity(e2) )
+            return false;
+        ok = isIdentity(e2) && ch.init(e1) && ch.addStep(step, e2.a);
+        if( !ok )
+        {
+            ch.reset();
+            ok = isIdentity(e1) && ch.init(e2) && ch.addStep(step, e1.a);
+        }
+    }
+
+    if( ok )
+        ch.store(res);
+    return ok;
+}
+
+bool MatOp_Fused::makeExpr(MatExpr& res, char op, const MatExpr& e, const Scalar& s)
+{
+    FusedChain ch;
+    bool ok = ch.init(e);
+
+    if( op == '+' )
+        ok = ok && ch.isConst(s) && (s[0] == 0 || ch.addStep(FUSED_ADD_C, Mat(), s[0]));
+    else if( op == '-' )
+        ok = ok && ch.isConst(s) && ch.addStep(FUSED_MUL_C, Mat(), -1) &&
+            (s[0] == 0 || ch.addStep(FUSED_ADD_C, Mat(), s[0]));
+    else if( op == '*' )
+        ok = ok && ch.addStep(FUSED_MUL_C, Mat(), s[0]);
+    else if( op == 'a' )
+        ok = ok && ch.addStep(FUSED_ABS);
+    else if( op == 'm' || op == 'M' )
+        ok = ok && !isIdentity(e) && ch.addStep(op == 'm' ? FUSED_MIN_C : FUSED_MAX_C, Mat(), s[0]);
+    else
+        ok = false;
+
+    if( ok )
+        ch.store(res);
+    return ok;
+}
+
+bool MatOp_Fused::makeCmpExpr(MatExpr& res, int cmpop, const MatExpr& e1, const MatExpr& e2)
+{
+    static const int swapped[] = { CMP_EQ, CMP_LT, CMP_LE, CMP_GT, CMP_GE, CMP_NE };
+    FusedChain ch;
+    bool ok;
+
+    if( isIdentity(e1) && isIdentity(e2) )
+        return false;
+    ok = isIdentity(e2) && ch.init(e1) && ch.addStep(FUSED_CMP_M + cmpop, e2.a);
+    if( !ok )
+    {
+        ch.reset();
+        ok = isIdentity(e1) && ch.init(e2) && ch.addStep(FUSED_CMP_M + swapped[cmpop], e1.a);
+    }
+
+    if( ok )
+        ch.store(res);
+    return ok;
+}
+
+bool MatOp_Fused::makeCmpExpr(MatExpr& res, int cmpop, const MatExpr& e, double s)
+{
+    FusedChain ch;
+    bool ok = !isIdentity(e) && ch.init(e) && ch.addStep(FUSED_CMP_C + cmpop, Mat(), s);
+    if( ok )
+        ch.store(res);
+    return ok;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 MatExpr Mat::t() const
@@ -81,6 +81,8 @@ void swap( Mat& a, Mat& b )
     }
 }
 
+// used by Mat::create() when the matrix has no custom allocator, see Mat::setDefaultAllocator()
+static MatAllocator* defaultAllocator = 0;
 
 static inline void setSize( Mat& m, int _dims, const int* _sz,
                             const size_t* _steps, bool autoSteps=false )
@@ -208,6 +210,8 @@ void Mat::create(int d, const int* _sizes, int _type)
 #ifdef HAVE_TGPU
         if( !allocator || allocator == tegra::getAllocator() ) allocator = tegra::getAllocator(d, _sizes, _type);
 #endif
+        if( !allocator )
+            allocator = defaultAllocator;
         if( !allocator )
         {
             size_t totalsize = alignSize(step.p[0]*size.p[0], (int)sizeof(*refcount));
@@ -250,6 +254,16 @@ void Mat::copySize(const Mat& m)
     }
 }
 
+MatAllocator* Mat::getDefaultAllocator()
+{
+    return defaultAllocator;
+}
+
+void Mat::setDefaultAllocator(MatAllocator* _allocator)
+{
+    defaultAllocator = _allocator;
+}
+
 void Mat::deallocate()
 {
     if( allocator )
@@ -1866,8 +1880,9 @@ cv::Scalar cv::trace( InputArray _m )
 namespace cv
 {
 
+// the steps are signed, rotate() reads or writes the rows in the reverse order
 template<typename T> static void
-transpose_( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz )
+transpose_( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size sz )
 {
     int i=0, j, m = sz.width, n = sz.height;
 
@@ -1922,35 +1937,221 @@ transpose_( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz )
     }
 }
 
-template<typename T> static void
-transposeI_( uchar* data, size_t step, int n )
+// no in-register kernel, the tiles are transposed by transpose_()
+struct TransposeBlockNone
 {
-    int i, j;
-    for( i = 0; i < n; i++ )
+    enum { SIZE = 0 };
+    void operator()( const uchar*, ptrdiff_t, uchar*, ptrdiff_t ) const {}
+};
+
+#if CV_SSE2
+
+template<int esz> static inline __m128i transposeUnpackLo( __m128i a, __m128i b );
+template<int esz> static inline __m128i transposeUnpackHi( __m128i a, __m128i b );
+
+template<> inline __m128i transposeUnpackLo<1>( __m128i a, __m128i b ) { return _mm_unpacklo_epi8(a, b); }
+template<> inline __m128i transposeUnpackHi<1>( __m128i a, __m128i b ) { return _mm_unpackhi_epi8(a, b); }
+template<> inline __m128i transposeUnpackLo<2>( __m128i a, __m128i b ) { return _mm_unpacklo_epi16(a, b); }
+template<> inline __m128i transposeUnpackHi<2>( __m128i a, __m128i b ) { return _mm_unpackhi_epi16(a, b); }
+template<> inline __m128i transposeUnpackLo<4>( __m128i a, __m128i b ) { return _mm_unpacklo_epi32(a, b); }
+template<> inline __m128i transposeUnpackHi<4>( __m128i a, __m128i b ) { return _mm_unpackhi_epi32(a, b); }
+template<> inline __m128i transposeUnpackLo<8>( __m128i a, __m128i b ) { return _mm_unpacklo_epi64(a, b); }
+template<> inline __m128i transposeUnpackHi<8>( __m128i a, __m128i b ) { return _mm_unpackhi_epi64(a, b); }
+
+// transposes a square block of 16/esz rows by 16 bytes in the registers:
+// log2(16/esz) rounds of interleaving the row k with the row k + SIZE/2
+template<int esz> struct TransposeBlockSSE2
+{
+    enum { SIZE = 16/esz };
+
+    void operator()( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep ) const
     {
-        T* row = (T*)(data + step*i);
-        uchar* data1 = data + i*sizeof(T);
-        for( j = i+1; j < n; j++ )
-            std::swap( row[j], *(T*)(data1 + step*j) );
+        __m128i r[SIZE], t[SIZE];
+        int k;
+
+        for( k = 0; k < SIZE; k++ )
+            r[k] = _mm_loadu_si128((const __m128i*)(src + sstep*k));
+
+        for( int n = SIZE; n > 1; n >>= 1 )
+        {
+            for( k = 0; k < SIZE/2; k++ )
+            {
+                t[k*2] = transposeUnpackLo<esz>(r[k], r[k + SIZE/2]);
+                t[k*2+1] = transposeUnpackHi<esz>(r[k], r[k + SIZE/2]);
+            }
+            for( k = 0; k < SIZE; k++ )
+                r[k] = t[k];
+        }
+
+        for( k = 0; k < SIZE; k++ )
+            _mm_storeu_si128((__m128i*)(dst + dstep*k), r[k]);
     }
+};
+
+#endif
+
+// transposes a w x h tile of the source; the inner part is processed by the
+// in-register kernel, the right and the bottom margins by transpose_()
+template<typename T, class Block> static void
+transposeTile_( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, int w, int h )
+{
+    Block block;
+    int bw = 0, bh = 0;
+
+    if( Block::SIZE > 0 )
+    {
+        bw = w - w % Block::SIZE;
+        bh = h - h % Block::SIZE;
+        for( int i = 0; i < bw; i += Block::SIZE )
+            for( int j = 0; j < bh; j += Block::SIZE )
+                block( src + sstep*j + i*sizeof(T), sstep, dst + dstep*i + j*sizeof(T), dstep );
+    }
+
+    if( bw < w )
+        transpose_<T>( src + bw*sizeof(T), sstep, dst + dstep*bw, dstep, Size(w - bw, h) );
+    if( bh < h && bw > 0 )
+        transpose_<T>( src + sstep*bh, sstep, dst + bh*sizeof(T), dstep, Size(bw, h - bh) );
 }
 
-typedef void (*TransposeFunc)( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz );
-typedef void (*TransposeInplaceFunc)( uchar* data, size_t step, int n );
+enum { TRANSPOSE_PARALLEL_SIZE = 1 << 18 };
+
+template<typename T> struct TransposeTile
+{
+    // a tile of both the source and the destination fits into L1
+    enum { SIZE = sizeof(T) == 1 ? 64 : sizeof(T) <= 4 ? 32 : 16 };
+};
+
+// each stripe transposes a band of the source columns, i.e. of the destination rows
+template<typename T, class Block> class TransposeInvoker : public ParallelLoopBody
+{
+public:
+    TransposeInvoker( const uchar* _src, ptrdiff_t _sstep, uchar* _dst, ptrdiff_t _dstep, Size _sz )
+        : src(_src), sstep(_sstep), dst(_dst), dstep(_dstep), sz(_sz) {}
+
+    void operator()( const Range& range ) const
+    {
+        const int TILE = TransposeTile<T>::SIZE;
+        int i0 = range.start*TILE, i1 = std::min(range.end*TILE, sz.width);
+
+        for( int j = 0; j < sz.height; j += TILE )
+            for( int i = i0; i < i1; i += TILE )
+                transposeTile_<T, Block>( src + sstep*j + i*sizeof(T), sstep,
+                                          dst + dstep*i + j*sizeof(T), dstep,
+                                          std::min(TILE, i1 - i), std::min(TILE, sz.height - j) );
+    }
+
+protected:
+    const uchar* src;
+    ptrdiff_t sstep;
+    uchar* dst;
+    ptrdiff_t dstep;
+    Size sz;
+};
+
+template<typename T, class Block> static void
+transposeBlocked_( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size sz )
+{
+    const int TILE = TransposeTile<T>::SIZE;
+    TransposeInvoker<T, Block> body( src, sstep, dst, dstep, sz );
+    Range range( 0, (sz.width + TILE - 1)/TILE );
+
+    if( (size_t)sz.width*sz.height*sizeof(T) >= (size_t)TRANSPOSE_PARALLEL_SIZE )
+        parallel_for_( range, body );
+    else
+        body( range );
+}
+
+// in-place transposition of a square matrix: the tiles symmetric with respect to the
+// main diagonal are exchanged through a temporary tile; each stripe handles the tile
+// pairs (bi, bj), bj >= bi of its tile rows
+template<typename T, class Block> class TransposeInplaceInvoker : public ParallelLoopBody
+{
+public:
+    TransposeInplaceInvoker( uchar* _data, ptrdiff_t _step, int _n )
+        : data(_data), step(_step), n(_n) {}
+
+    void operator()( const Range& range ) const
+    {
+        const int TILE = TransposeTile<T>::SIZE;
+        const ptrdiff_t tstep = TILE*sizeof(T);
+        AutoBuffer<uchar> _tmp( TILE*tstep );
+        uchar* tmp = _tmp;
+
+        for( int bi = range.start; bi < range.end; bi++ )
+        {
+            int i = bi*TILE, h = std::min(TILE, n - i);
+            for( int j = i; j < n; j += TILE )
+            {
+                int w = std::min(TILE, n - j), y;
+                uchar* a = data + step*i + j*sizeof(T);
+                uchar* b = data + step*j + i*sizeof(T);
+
+                // tmp = a'; b' -> a; tmp -> b
+                transposeTile_<T, Block>( a, step, tmp, tstep, w, h );
+                if( j != i )
+                    transposeTile_<T, Block>( b, step, a, step, h, w );
+                for( y = 0; y < w; y++ )
+                    memcpy( b + step*y, tmp + tstep*y, h*sizeof(T) );
+            }
+        }
+    }
+
+protected:
+    uchar* data;
+    ptrdiff_t step;
+    int n;
+};
+
+template<typename T, class Block> static void
+transposeInplaceBlocked_( uchar* data, ptrdiff_t step, int n )
+{
+    const int TILE = TransposeTile<T>::SIZE;
+    TransposeInplaceInvoker<T, Block> body( data, step, n );
+    Range range( 0, (n + TILE - 1)/TILE );
+
+    if( (size_t)n*n*sizeof(T) >= (size_t)TRANSPOSE_PARALLEL_SIZE )
+        parallel_for_( range, body );
+    else
+        body( range );
+}
+
+typedef void (*TransposeFunc)( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size sz );
+typedef void (*TransposeInplaceFunc)( uchar* data, ptrdiff_t step, int n );
 
 #define DEF_TRANSPOSE_FUNC(suffix, type) \
-static void transpose_##suffix( const uchar* src, size_t sstep, uchar* dst, size_t dstep, Size sz ) \
-{ transpose_<type>(src, sstep, dst, dstep, sz); } \
+static void transpose_##suffix( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size sz ) \
+{ transposeBlocked_<type, TransposeBlockNone>(src, sstep, dst, dstep, sz); } \
 \
-static void transposeI_##suffix( uchar* data, size_t step, int n ) \
-{ transposeI_<type>(data, step, n); }
+static void transposeI_##suffix( uchar* data, ptrdiff_t step, int n ) \
+{ transposeInplaceBlocked_<type, TransposeBlockNone>(data, step, n); }
+
+#if CV_SSE2
+#define DEF_TRANSPOSE_FUNC_SIMD(suffix, type) \
+static void transpose_##suffix( const uchar* src, ptrdiff_t sstep, uchar* dst, ptrdiff_t dstep, Size sz ) \
+{ \
+    if( USE_SSE2 ) \
+        transposeBlocked_<type, TransposeBlockSSE2<sizeof(type)> >(src, sstep, dst, dstep, sz); \
+    else \
+        transposeBlocked_<type, TransposeBlockNone>(src, sstep, dst, dstep, sz); \
+} \
+\
+static void transposeI_##suffix( uchar* data, ptrdiff_t step, int n ) \
+{ \
+    if( USE_SSE2 ) \
+        transposeInplaceBlocked_<type, TransposeBlockSSE2<sizeof(type)> >(data, step, n); \
+    else \
+        transposeInplaceBlocked_<type, TransposeBlockNone>(data, step, n); \
+}
+#else
+#define DEF_TRANSPOSE_FUNC_SIMD DEF_TRANSPOSE_FUNC
+#endif
 
-DEF_TRANSPOSE_FUNC(8u, uchar)
-DEF_TRANSPOSE_FUNC(16u, ushort)
+DEF_TRANSPOSE_FUNC_SIMD(8u, uchar)
+DEF_TRANSPOSE_FUNC_SIMD(16u, ushort)
 DEF_TRANSPOSE_FUNC(8uC3, Vec3b)
-DEF_TRANSPOSE_FUNC(32s, int)
+DEF_TRANSPOSE_FUNC_SIMD(32s, int)
 DEF_TRANSPOSE_FUNC(16uC3, Vec3s)
-DEF_TRANSPOSE_FUNC(32sC2, Vec2i)
+DEF_TRANSPOSE_FUNC_SIMD(32sC2, Vec2i)
 DEF_TRANSPOSE_FUNC(32sC3, Vec3i)
 DEF_TRANSPOSE_FUNC(32sC4, Vec4i)
 DEF_TRANSPOSE_FUNC(32sC6, Vec6i)
@@ -2009,6 +2210,47 @@ void cv::transpose( InputArray _src, OutputArray _dst )
 }
 
 
+void cv::rotate( InputArray _src, OutputArray _dst, int rotateCode )
+{
+    CV_Assert( rotateCode == ROTATE_90_CLOCKWISE || rotateCode == ROTATE_180 ||
+               rotateCode == ROTATE_90_COUNTERCLOCKWISE );
+
+    if( rotateCode == ROTATE_180 )
+    {
+        flip( _src, _dst, -1 );
+        return;
+    }
+
+    Mat src = _src.getMat();
+    if( src.empty() )
+    {
+        _dst.release();
+        return;
+    }
+    size_t esz = src.elemSize();
+    CV_Assert( src.dims <= 2 && esz <= (size_t)32 );
+
+    _dst.create(src.cols, src.rows, src.type());
+    Mat dst = _dst.getMat();
+    if( dst.data == src.data )
+        src = src.clone();
+
+    TransposeFunc func = transposeTab[esz];
+    CV_Assert( func != 0 );
+
+    // both rotations are transpositions with one of the matrices traversed bottom-up,
+    // so no intermediate transposed matrix is needed
+    if( rotateCode == ROTATE_90_CLOCKWISE )
+        // dst(i, j) = src(src.rows - 1 - j, i)
+        func( src.data + src.step*(src.rows - 1), -(ptrdiff_t)src.step,
+              dst.data, dst.step, src.size() );
+    else
+        // dst(i, j) = src(j, src.cols - 1 - i)
+        func( src.data, src.step, dst.data + dst.step*(dst.rows - 1),
+              -(ptrdiff_t)dst.step, src.size() );
+}
+
+
 void cv::completeSymm( InputOutputArray _m, bool LtoR )
 {
     Mat m = _m.getMat();
@@ -2368,14 +2610,148 @@ void cv::reduce(InputArray _src, OutputArray _dst, int dim, int op, int dtype)
 namespace cv
 {
 
-template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
+// maps the elements to unsigned keys whose unsigned order matches the element order
+template<typename T> struct RadixKey {};
+
+template<> struct RadixKey<uchar>
+{
+    typedef uchar type;
+    static uchar to( uchar x ) { return x; }
+    static uchar from( uchar k ) { return k; }
+};
+
+template<> struct RadixKey<schar>
+{
+    typedef uchar type;
+    static uchar to( schar x ) { return (uchar)(x ^ 0x80); }
+    static schar from( uchar k ) { return (schar)(k ^ 0x80); }
+};
+
+template<> struct RadixKey<ushort>
+{
+    typedef ushort type;
+    static ushort to( ushort x ) { return x; }
+    static ushort from( ushort k ) { return k; }
+};
+
+template<> struct RadixKey<short>
+{
+    typedef ushort type;
+    static ushort to( short x ) { return (ushort)(x ^ 0x8000); }
+    static short from( ushort k ) { return (short)(k ^ 0x8000); }
+};
+
+template<> struct RadixKey<int>
+{
+    typedef unsigned type;
+    static unsigned to( int x ) { return (unsigned)x ^ 0x80000000u; }
+    static int from( unsigned k ) { return (int)(k ^ 0x80000000u); }
+};
+
+// negative numbers have all the bits inverted, non-negative ones only the sign bit
+template<> struct RadixKey<float>
 {
+    typedef unsigned type;
+    static unsigned to( float x )
+    {
+        Cv32suf v; v.f = x;
+        return v.u ^ ((unsigned)(v.i >> 31) | 0x80000000u);
+    }
+    static float from( unsigned k )
+    {
+        Cv32suf v; v.u = k ^ ((k & 0x80000000u) ? 0x80000000u : 0xffffffffu);
+        return v.f;
+    }
+};
+
+template<> struct RadixKey<double>
+{
+    typedef uint64 type;
+    static uint64 to( double x )
+    {
+        Cv64suf v; v.f = x;
+        return v.u ^ ((uint64)(v.i >> 63) | CV_BIG_UINT(0x8000000000000000));
+    }
+    static double from( uint64 k )
+    {
+        Cv64suf v;
+        v.u = k ^ ((k & CV_BIG_UINT(0x8000000000000000)) ? CV_BIG_UINT(0x8000000000000000) : ~(uint64)0);
+        return v.f;
+    }
+};
+
+// shorter rows are left to std::sort
+enum { RADIX_SORT_MIN_LEN = 256 };
+
+/*
+  LSD radix sort by 8-bit digits; it is stable, so the descending order is produced by
+  sorting the inverted keys. When idx is not NULL, the indices follow the keys. keys and
+  tmp (and idx and itmp) are swapped after each pass, so on return keys and idx point to
+  the sorted data. The passes over digits that are the same in all the keys are skipped.
+*/
+template<typename UT> static void
+radixSort_( UT*& keys, UT*& tmp, int*& idx, int*& itmp, int len )
+{
+    enum { DIGITS = sizeof(UT) };
+    int hist[DIGITS][256];
+    int i, d;
+
+    memset( hist, 0, sizeof(hist) );
+    for( i = 0; i < len; i++ )
+    {
+        UT k = keys[i];
+        for( d = 0; d < DIGITS; d++ )
+            hist[d][(k >> d*8) & 255]++;
+    }
+
+    for( d = 0; d < DIGITS; d++ )
+    {
+        int* h = hist[d];
+        int shift = d*8, sum = 0;
+        if( h[(keys[0] >> shift) & 255] == len )
+            continue;
+
+        for( i = 0; i < 256; i++ )
+        {
+            int c = h[i];
+            h[i] = sum;
+            sum += c;
+        }
+
+        if( idx )
+        {
+            for( i = 0; i < len; i++ )
+            {
+                UT k = keys[i];
+                int pos = h[(k >> shift) & 255]++;
+                tmp[pos] = k;
+                itmp[pos] = idx[i];
+            }
+            std::swap( idx, itmp );
+        }
+        else
+        {
+            for( i = 0; i < len; i++ )
+            {
+                UT k = keys[i];
+                tmp[h[(k >> shift) & 255]++] = k;
+            }
+        }
+        std::swap( keys, tmp );
+    }
+}
+
+template<typename T> static void sort_( const Mat& src, Mat& dst, int flags, const Range& range )
+{
+    typedef typename RadixKey<T>::type UT;
     AutoBuffer<T> buf;
+    AutoBuffer<UT> kbuf;
     T* bptr;
     int i, j, n, len;
     bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
     bool inplace = src.data == dst.data;
     bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+    UT kmask = sortDescending ? (UT)~(UT)0 : (UT)0;
 
     if( sortRows )
         n = src.rows, len = src.cols;
@@ -2384,11 +2760,43 @@ template<typename T> static void sort_( const Mat& src, Mat& dst, int flags )
         n = src.cols, len = src.rows;
         buf.allocate(len);
     }
+    bool radix = len >= RADIX_SORT_MIN_LEN;
+    if( radix )
+        kbuf.allocate(len*2);
     bptr = (T*)buf;
+    CV_Assert( range.end <= n );
 
-    for( i = 0; i < n; i++ )
+    for( i = range.start; i < range.end; i++ )
     {
         T* ptr = bptr;
+        if( radix )
+        {
+            UT *keys = kbuf, *ktmp = keys + len;
+            int *idx = 0, *itmp = 0;
+            if( sortRows )
+            {
+                const T* sptr = (const T*)(src.data + src.step*i);
+                for( j = 0; j < len; j++ )
+                    keys[j] = RadixKey<T>::to(sptr[j]) ^ kmask;
+            }
+            else
+                for( j = 0; j < len; j++ )
+                    keys[j] = RadixKey<T>::to(((const T*)(src.data + src.step*j))[i]) ^ kmask;
+
+            radixSort_( keys, ktmp, idx, itmp, len );
+
+            if( sortRows )
+            {
+                T* dptr = (T*)(dst.data + dst.step*i);
+                for( j = 0; j < len; j++ )
+                    dptr[j] = RadixKey<T>::from((UT)(keys[j] ^ kmask));
+            }
+            else
+                for( j = 0; j < len; j++ )
+                    ((T*)(dst.data + dst.step*j))[i] = RadixKey<T>::from((UT)(keys[j] ^ kmask));
+            continue;
+        }
+
         if( sortRows )
         {
             T* dptr = (T*)(dst.data + dst.step*i);
@@ -2423,17 +2831,27 @@ public:
     const _Tp* arr;
 };
 
+template<typename _Tp> class GreaterThanIdx
+{
+public:
+    GreaterThanIdx( const _Tp* _arr ) : arr(_arr) {}
+    bool operator()(int a, int b) const { return arr[a] > arr[b]; }
+    const _Tp* arr;
+};
 
-
-template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
+template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags, const Range& range )
 {
+    typedef typename RadixKey<T>::type UT;
     AutoBuffer<T> buf;
     AutoBuffer<int> ibuf;
+    AutoBuffer<UT> kbuf;
     T* bptr;
     int* _iptr;
     int i, j, n, len;
     bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
     bool sortDescending = (flags & CV_SORT_DESCENDING) != 0;
+    bool stable = (flags & SORT_STABLE) != 0;
+    UT kmask = sortDescending ? (UT)~(UT)0 : (UT)0;
 
     CV_Assert( src.data != dst.data );
 
@@ -2443,16 +2861,50 @@ template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
     {
         n = src.cols, len = src.rows;
         buf.allocate(len);
-        ibuf.allocate(len);
     }
+    bool radix = len >= RADIX_SORT_MIN_LEN;
+    if( radix )
+    {
+        kbuf.allocate(len*2);
+        ibuf.allocate(len*2);
+    }
+    else if( !sortRows )
+        ibuf.allocate(len);
     bptr = (T*)buf;
     _iptr = (int*)ibuf;
+    CV_Assert( range.end <= n );
 
-    for( i = 0; i < n; i++ )
+    for( i = range.start; i < range.end; i++ )
     {
         T* ptr = bptr;
         int* iptr = _iptr;
 
+        if( radix )
+        {
+            UT *keys = kbuf, *ktmp = keys + len;
+            int *idx = _iptr, *itmp = idx + len;
+            if( sortRows )
+            {
+                const T* sptr = (const T*)(src.data + src.step*i);
+                for( j = 0; j < len; j++ )
+                    keys[j] = RadixKey<T>::to(sptr[j]) ^ kmask;
+            }
+            else
+                for( j = 0; j < len; j++ )
+                    keys[j] = RadixKey<T>::to(((const T*)(src.data + src.step*j))[i]) ^ kmask;
+            for( j = 0; j < len; j++ )
+                idx[j] = j;
+
+            radixSort_( keys, ktmp, idx, itmp, len );
+
+            if( sortRows )
+                memcpy( dst.data + dst.step*i, idx, len*sizeof(idx[0]) );
+            else
+                for( j = 0; j < len; j++ )
+                    ((int*)(dst.data + dst.step*j))[i] = idx[j];
+            continue;
+        }
+
         if( sortRows )
         {
             ptr = (T*)(src.data + src.step*i);
@@ -2465,17 +2917,68 @@ template<typename T> static void sortIdx_( const Mat& src, Mat& dst, int flags )
         }
         for( j = 0; j < len; j++ )
             iptr[j] = j;
-        std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
-        if( sortDescending )
-            for( j = 0; j < len/2; j++ )
-                std::swap(iptr[j], iptr[len-1-j]);
+        if( stable )
+        {
+            if( sortDescending )
+                std::stable_sort( iptr, iptr + len, GreaterThanIdx<T>(ptr) );
+            else
+                std::stable_sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
+        }
+        else
+        {
+            std::sort( iptr, iptr + len, LessThanIdx<T>(ptr) );
+            if( sortDescending )
+                for( j = 0; j < len/2; j++ )
+                    std::swap(iptr[j], iptr[len-1-j]);
+        }
         if( !sortRows )
             for( j = 0; j < len; j++ )
                 ((int*)(dst.data + dst.step*j))[i] = iptr[j];
     }
 }
 
-typedef void (*SortFunc)(const Mat& src, Mat& dst, int flags);
+typedef void (*SortFunc)(const Mat& src, Mat& dst, int flags, const Range& range);
+
+// the rows (columns) are sorted in parallel once there is enough work
+enum { SORT_PARALLEL_SIZE = 1 << 16 };
+
+class SortInvoker : public ParallelLoopBody
+{
+public:
+    SortInvoker( SortFunc _func, const Mat& _src, Mat& _dst, int _flags )
+        : func(_func), src(&_src), dst(&_dst), flags(_flags) {}
+
+    void operator()( const Range& range ) const
+    {
+        func( *src, *dst, flags, range );
+    }
+
+protected:
+    SortFunc func;
+    const Mat* src;
+    Mat* dst;
+    int flags;
+};
+
+static void runSort( SortFunc func, const Mat& src, Mat& dst, int flags )
+{
+    bool sortRows = (flags & 1) == CV_SORT_EVERY_ROW;
+    int n = sortRows ? src.rows : src.cols;
+    SortInvoker body( func, src, dst, flags );
+
+    if( n > 1 && src.total() >= (size_t)SORT_PARALLEL_SIZE )
+        parallel_for_( Range(0, n), body );
+    else
+        body( Range(0, n) );
+}
+
+// gathering long strided columns is cache-hostile, so large matrices
+// are sorted by rows of the transposed matrix
+static bool sortTransposed( const Mat& src, int flags )
+{
+    return (flags & 1) == CV_SORT_EVERY_COLUMN && src.cols > 1 &&
+        src.rows >= RADIX_SORT_MIN_LEN && src.total() >= (size_t)SORT_PARALLEL_SIZE;
+}
 
 }
 
@@ -2489,9 +2992,19 @@ void cv::sort( InputArray _src, OutputArray _dst, int flags )
     Mat src = _src.getMat();
     SortFunc func = tab[src.depth()];
     CV_Assert( src.dims <= 2 && src.channels() == 1 && func != 0 );
+
+    if( sortTransposed(src, flags) )
+    {
+        Mat t = src.t();
+        runSort( func, t, t, flags & ~CV_SORT_EVERY_COLUMN );
+        _dst.create( src.size(), src.type() );
+        transpose( t, _dst );
+        return;
+    }
+
     _dst.create( src.size(), src.type() );
     Mat dst = _dst.getMat();
-    func( src, dst, flags );
+    runSort( func, src, dst, flags );
 }
 
 void cv::sortIdx( InputArray _src, OutputArray _dst, int flags )
@@ -2508,12 +3021,21 @@ void cv::sortIdx( InputArray _src, OutputArray _dst, int flags )
     Mat dst = _dst.getMat();
     if( dst.data == src.data )
         _dst.release();
+
+    if( sortTransposed(src, flags) )
+    {
+        Mat t = src.t(), tidx( t.size(), CV_32S );
+        runSort( func, t, tidx, flags & ~CV_SORT_EVERY_COLUMN );
+        _dst.create( src.size(), CV_32S );
+        transpose( tidx, _dst );
+        return;
+    }
+
     _dst.create( src.size(), CV_32S );
     dst = _dst.getMat();
-    func( src, dst, flags );
+    runSort( func, src, dst, flags );
 }
 
-
 ////////////////////////////////////////// kmeans ////////////////////////////////////////////
 
 namespace cv
@@ -3541,7 +4063,7 @@ static ConvertScaleData getConvertScaleElem(int fromType, int toType)
     return func;
 }
 
-enum { HASH_SIZE0 = 8 };
+enum { HASH_SIZE0 = 16, HASH_GROUP_SIZE = 16, HASH_TAG_EMPTY = 0, HASH_TAG_DELETED = 1, HASH_TAG_BIT = 0x80 };
 
 static inline void copyElem(const uchar* from, uchar* to, size_t elemSize)
 {
@@ -3564,6 +4086,185 @@ static inline bool isZeroElem(const uchar* data, size_t elemSize)
     return true;
 }
 
+/*
+ The sparse matrix hash table uses open addressing. The slots are split into groups of
+ HASH_GROUP_SIZE, and each slot has an 8-bit tag (7 bits of the mixed hash value plus HASH_TAG_BIT),
+ so all the candidates within a group are found with a single 16-byte comparison, and the nodes
+ themselves are only touched on a tag match. The groups are probed linearly until a group
+ with an empty slot is met; erased slots become "deleted" unless their group still has an empty slot.
+*/
+static const size_t SPARSE_NO_SLOT = (size_t)-1;
+enum { SPARSE_BATCH_SIZE = 16 };
+
+static inline unsigned sparseHashMix(size_t h)
+{
+    unsigned x = (unsigned)h ^ (unsigned)((h >> 16) >> 16);
+    x ^= x >> 16;
+    x *= 0x85ebca6bU;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35U;
+    return x ^ (x >> 16);
+}
+
+static inline uchar sparseHashTag(unsigned x)
+{
+    return (uchar)(HASH_TAG_BIT | (x >> 25));
+}
+
+static inline size_t sparseHashGroup(unsigned x, size_t hsize)
+{
+    return (size_t)x & (hsize - 1) & ~(size_t)(HASH_GROUP_SIZE - 1);
+}
+
+// returns the mask of the group slots with the specified tag and the mask of the empty slots
+static inline unsigned matchHashGroup(const uchar* tags, uchar tag, unsigned& emptyMask)
+{
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128i g = _mm_loadu_si128((const __m128i*)tags);
+        emptyMask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_setzero_si128()));
+        return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)tag)));
+    }
+#endif
+    unsigned m = 0, e = 0;
+    for( int i = 0; i < HASH_GROUP_SIZE; i++ )
+    {
+        m |= (unsigned)(tags[i] == tag) << i;
+        e |= (unsigned)(tags[i] == HASH_TAG_EMPTY) << i;
+    }
+    emptyMask = e;
+    return m;
+}
+
+// returns the mask of the group slots that are empty or deleted
+static inline unsigned freeHashGroupSlots(const uchar* tags)
+{
+#if CV_SSE2
+    if( USE_SSE2 )
+        return ~(unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)tags)) & 0xffff;
+#endif
+    unsigned m = 0;
+    for( int i = 0; i < HASH_GROUP_SIZE; i++ )
+        m |= (unsigned)(tags[i] < HASH_TAG_BIT) << i;
+    return m;
+}
+
+static size_t findSparseSlot(const SparseMat::Hdr& hdr, size_t h, const int* idx)
+{
+    size_t hsize = hdr.hashtab.size();
+    unsigned x = sparseHashMix(h);
+    uchar tag = sparseHashTag(x);
+    const uchar* tags = &hdr.hashtags[0];
+    const size_t* htab = &hdr.hashtab[0];
+    const uchar* pool = &hdr.pool[0];
+    int i, d = hdr.dims;
+
+    for( size_t g = sparseHashGroup(x, hsize);; g = (g + HASH_GROUP_SIZE) & (hsize - 1) )
+    {
+        unsigned emptyMask, m = matchHashGroup(tags + g, tag, emptyMask);
+        for( size_t j = g; m != 0; j++, m >>= 1 )
+        {
+            if( !(m & 1) )
+                continue;
+            const SparseMat::Node* elem = (const SparseMat::Node*)(pool + htab[j]);
+            if( elem->hashval != h )
+                continue;
+            for( i = 0; i < d; i++ )
+                if( elem->idx[i] != idx[i] )
+                    break;
+            if( i == d )
+                return j;
+        }
+        if( emptyMask )
+            return SPARSE_NO_SLOT;
+    }
+}
+
+static size_t freeSparseSlot(const SparseMat::Hdr& hdr, unsigned x)
+{
+    size_t hsize = hdr.hashtab.size();
+    const uchar* tags = &hdr.hashtags[0];
+
+    for( size_t g = sparseHashGroup(x, hsize);; g = (g + HASH_GROUP_SIZE) & (hsize - 1) )
+    {
+        unsigned m = freeHashGroupSlots(tags + g);
+        for( size_t j = g; m != 0; j++, m >>= 1 )
+            if( m & 1 )
+                return j;
+    }
+}
+
+static inline uchar* sparsePtr(SparseMat& m, const int* idx, size_t h, bool createMissing)
+{
+    SparseMat::Hdr& hdr = *m.hdr;
+    size_t hidx = findSparseSlot(hdr, h, idx);
+    if( hidx != SPARSE_NO_SLOT )
+        return &hdr.pool[hdr.hashtab[hidx]] + hdr.valueOffset;
+    return createMissing ? m.newNode(idx, h) : 0;
+}
+
+// appends the new nodes to the pool and puts them into the free list
+static void growSparsePool(SparseMat::Hdr& hdr, size_t newpsize)
+{
+    size_t i, nsz = hdr.nodeSize, psize = hdr.pool.size();
+    CV_Assert( newpsize > psize && newpsize % nsz == 0 );
+    hdr.pool.resize(newpsize);
+    uchar* pool = &hdr.pool[0];
+    for( i = psize; i < newpsize - nsz; i += nsz )
+        ((SparseMat::Node*)(pool + i))->next = i + nsz;
+    ((SparseMat::Node*)(pool + i))->next = hdr.freeList;
+    hdr.freeList = psize;
+}
+
+// computes the hash values of a batch of elements and prefetches their hash table groups
+static void hashSparseBatch(const SparseMat& m, const int* idx, int count, size_t* hashvals)
+{
+    const SparseMat::Hdr& hdr = *m.hdr;
+    size_t hsize = hdr.hashtab.size();
+    int d = hdr.dims;
+    for( int k = 0; k < count; k++ )
+    {
+        size_t h = hashvals[k] = m.hash(idx + k*d);
+#if CV_SSE2
+        size_t g = sparseHashGroup(sparseHashMix(h), hsize);
+        _mm_prefetch((const char*)&hdr.hashtags[g], _MM_HINT_T0);
+        _mm_prefetch((const char*)&hdr.hashtab[g], _MM_HINT_T0);
+#else
+        (void)hsize;
+#endif
+    }
+}
+
+template<typename T> static void
+accumulateElem_(const uchar* _from, uchar* _to, int cn)
+{
+    const T* from = (const T*)_from;
+    T* to = (T*)_to;
+    int i;
+    if( from )
+        for( i = 0; i < cn; i++ )
+            to[i] = saturate_cast<T>(to[i] + from[i]);
+    else
+        for( i = 0; i < cn; i++ )
+            to[i] = saturate_cast<T>(to[i] + 1);
+}
+
+typedef void (*AccumulateElemFunc)(const uchar* from, uchar* to, int cn);
+
+static AccumulateElemFunc getAccumulateElem(int depth)
+{
+    static AccumulateElemFunc tab[] =
+    {
+        accumulateElem_<uchar>, accumulateElem_<schar>, accumulateElem_<ushort>,
+        accumulateElem_<short>, accumulateElem_<int>, accumulateElem_<float>,
+        accumulateElem_<double>, 0
+    };
+    AccumulateElemFunc func = tab[CV_MAT_DEPTH(depth)];
+    CV_Assert( func != 0 );
+    return func;
+}
+
 SparseMat::Hdr::Hdr( int _dims, const int* _sizes, int _type )
 {
     refcount = 1;
@@ -3586,9 +4287,11 @@ void SparseMat::Hdr::clear()
 {
     hashtab.clear();
     hashtab.resize(HASH_SIZE0);
+    hashtags.clear();
+    hashtags.resize(HASH_SIZE0);
     pool.clear();
     pool.resize(nodeSize);
-    nodeCount = freeList = 0;
+    nodeCount = freeList = deletedCount = 0;
 }
 
 
@@ -3775,215 +4478,159 @@ uchar* SparseMat::ptr(int i0, bool createMissing, size_t* hashval)
 {
     CV_Assert( hdr && hdr->dims == 1 );
     size_t h = hashval ? *hashval : hash(i0);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx];
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
-    {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h && elem->idx[0] == i0 )
-            return &value<uchar>(elem);
-        nidx = elem->next;
-    }
-
-    if( createMissing )
-    {
-        int idx[] = { i0 };
-        return newNode( idx, h );
-    }
-    return 0;
+    int idx[] = { i0 };
+    return sparsePtr( *this, idx, h, createMissing );
 }
 
 uchar* SparseMat::ptr(int i0, int i1, bool createMissing, size_t* hashval)
 {
     CV_Assert( hdr && hdr->dims == 2 );
     size_t h = hashval ? *hashval : hash(i0, i1);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx];
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
-    {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h && elem->idx[0] == i0 && elem->idx[1] == i1 )
-            return &value<uchar>(elem);
-        nidx = elem->next;
-    }
-
-    if( createMissing )
-    {
-        int idx[] = { i0, i1 };
-        return newNode( idx, h );
-    }
-    return 0;
+    int idx[] = { i0, i1 };
+    return sparsePtr( *this, idx, h, createMissing );
 }
 
 uchar* SparseMat::ptr(int i0, int i1, int i2, bool createMissing, size_t* hashval)
 {
     CV_Assert( hdr && hdr->dims == 3 );
     size_t h = hashval ? *hashval : hash(i0, i1, i2);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx];
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
+    int idx[] = { i0, i1, i2 };
+    return sparsePtr( *this, idx, h, createMissing );
+}
+
+uchar* SparseMat::ptr(const int* idx, bool createMissing, size_t* hashval)
+{
+    CV_Assert( hdr );
+    size_t h = hashval ? *hashval : hash(idx);
+    return sparsePtr( *this, idx, h, createMissing );
+}
+
+void SparseMat::ptr(const int* idx, int count, uchar** ptrs, bool createMissing)
+{
+    CV_Assert( hdr && count >= 0 && ((idx && ptrs) || count == 0) );
+    int k0, k, d = hdr->dims;
+
+    if( createMissing && count > 0 )
     {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h && elem->idx[0] == i0 &&
-            elem->idx[1] == i1 && elem->idx[2] == i2 )
-            return &value<uchar>(elem);
-        nidx = elem->next;
+        // reserve the hash table and the pool, so that the insertions do not move the nodes
+        size_t hsize = hdr->hashtab.size(), n = hdr->nodeCount + count;
+        if( (hdr->nodeCount + hdr->deletedCount + count)*4 > hsize*3 )
+            resizeHashTab(std::max(hsize, n*2));
+        size_t nsz = hdr->nodeSize, psize = hdr->pool.size();
+        if( psize/nsz - 1 < n )
+            growSparsePool(*hdr, std::max(psize*2, (n + 1)*nsz));
     }
 
-    if( createMissing )
+    size_t hashvals[SPARSE_BATCH_SIZE];
+    for( k0 = 0; k0 < count; k0 += SPARSE_BATCH_SIZE )
     {
-        int idx[] = { i0, i1, i2 };
-        return newNode( idx, h );
+        int bcount = std::min(count - k0, (int)SPARSE_BATCH_SIZE);
+        hashSparseBatch( *this, idx + k0*d, bcount, hashvals );
+        for( k = 0; k < bcount; k++ )
+            ptrs[k0 + k] = sparsePtr( *this, idx + (k0 + k)*d, hashvals[k], createMissing );
     }
-    return 0;
 }
 
-uchar* SparseMat::ptr(const int* idx, bool createMissing, size_t* hashval)
+void SparseMat::accumulate(const int* idx, const void* values, int count)
 {
-    CV_Assert( hdr );
-    int i, d = hdr->dims;
-    size_t h = hashval ? *hashval : hash(idx);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx];
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
+    CV_Assert( hdr && count >= 0 && (idx || count == 0) );
+    int k0, k, d = hdr->dims, cn = channels();
+    size_t esz = elemSize();
+    const uchar* vptr = (const uchar*)values;
+    AccumulateElemFunc func = getAccumulateElem(depth());
+
+    size_t hashvals[SPARSE_BATCH_SIZE];
+    for( k0 = 0; k0 < count; k0 += SPARSE_BATCH_SIZE )
     {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h )
+        int bcount = std::min(count - k0, (int)SPARSE_BATCH_SIZE);
+        hashSparseBatch( *this, idx + k0*d, bcount, hashvals );
+        for( k = 0; k < bcount; k++ )
         {
-            for( i = 0; i < d; i++ )
-                if( elem->idx[i] != idx[i] )
-                    break;
-            if( i == d )
-                return &value<uchar>(elem);
+            uchar* to = sparsePtr( *this, idx + (k0 + k)*d, hashvals[k], true );
+            func( vptr ? vptr + (k0 + k)*esz : 0, to, cn );
         }
-        nidx = elem->next;
     }
-
-    return createMissing ? newNode(idx, h) : 0;
 }
 
 void SparseMat::erase(int i0, int i1, size_t* hashval)
 {
     CV_Assert( hdr && hdr->dims == 2 );
     size_t h = hashval ? *hashval : hash(i0, i1);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx], previdx=0;
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
-    {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h && elem->idx[0] == i0 && elem->idx[1] == i1 )
-            break;
-        previdx = nidx;
-        nidx = elem->next;
-    }
-
-    if( nidx )
-        removeNode(hidx, nidx, previdx);
+    int idx[] = { i0, i1 };
+    size_t hidx = findSparseSlot(*hdr, h, idx);
+    if( hidx != SPARSE_NO_SLOT )
+        removeNode(hidx, hdr->hashtab[hidx]);
 }
 
 void SparseMat::erase(int i0, int i1, int i2, size_t* hashval)
 {
     CV_Assert( hdr && hdr->dims == 3 );
     size_t h = hashval ? *hashval : hash(i0, i1, i2);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx], previdx=0;
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
-    {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h && elem->idx[0] == i0 &&
-            elem->idx[1] == i1 && elem->idx[2] == i2 )
-            break;
-        previdx = nidx;
-        nidx = elem->next;
-    }
-
-    if( nidx )
-        removeNode(hidx, nidx, previdx);
+    int idx[] = { i0, i1, i2 };
+    size_t hidx = findSparseSlot(*hdr, h, idx);
+    if( hidx != SPARSE_NO_SLOT )
+        removeNode(hidx, hdr->hashtab[hidx]);
 }
 
 void SparseMat::erase(const int* idx, size_t* hashval)
 {
     CV_Assert( hdr );
-    int i, d = hdr->dims;
     size_t h = hashval ? *hashval : hash(idx);
-    size_t hidx = h & (hdr->hashtab.size() - 1), nidx = hdr->hashtab[hidx], previdx=0;
-    uchar* pool = &hdr->pool[0];
-    while( nidx != 0 )
-    {
-        Node* elem = (Node*)(pool + nidx);
-        if( elem->hashval == h )
-        {
-            for( i = 0; i < d; i++ )
-                if( elem->idx[i] != idx[i] )
-                    break;
-            if( i == d )
-                break;
-        }
-        previdx = nidx;
-        nidx = elem->next;
-    }
-
-    if( nidx )
-        removeNode(hidx, nidx, previdx);
+    size_t hidx = findSparseSlot(*hdr, h, idx);
+    if( hidx != SPARSE_NO_SLOT )
+        removeNode(hidx, hdr->hashtab[hidx]);
 }
 
 void SparseMat::resizeHashTab(size_t newsize)
 {
-    newsize = std::max(newsize, (size_t)8);
+    newsize = std::max(newsize, std::max(hdr->nodeCount*2, (size_t)HASH_SIZE0));
     if((newsize & (newsize-1)) != 0)
         newsize = (size_t)1 << cvCeil(std::log((double)newsize)/CV_LOG2);
 
-    size_t i, hsize = hdr->hashtab.size();
-    std::vector<size_t> _newh(newsize);
-    size_t* newh = &_newh[0];
-    for( i = 0; i < newsize; i++ )
-        newh[i] = 0;
-    uchar* pool = &hdr->pool[0];
+    std::vector<size_t> _oldh(newsize, 0);
+    std::vector<uchar> _newt(newsize, (uchar)HASH_TAG_EMPTY);
+    std::swap(hdr->hashtab, _oldh);
+    std::swap(hdr->hashtags, _newt);
+    hdr->deletedCount = 0;
+
+    size_t i, hsize = _oldh.size();
+    const uchar* pool = &hdr->pool[0];
     for( i = 0; i < hsize; i++ )
     {
-        size_t nidx = hdr->hashtab[i];
-        while( nidx )
-        {
-            Node* elem = (Node*)(pool + nidx);
-            size_t next = elem->next;
-            size_t newhidx = elem->hashval & (newsize - 1);
-            elem->next = newh[newhidx];
-            newh[newhidx] = nidx;
-            nidx = next;
-        }
+        size_t nidx = _oldh[i];
+        if( !nidx )
+            continue;
+        unsigned x = sparseHashMix(((const Node*)(pool + nidx))->hashval);
+        size_t hidx = freeSparseSlot(*hdr, x);
+        hdr->hashtags[hidx] = sparseHashTag(x);
+        hdr->hashtab[hidx] = nidx;
     }
-    hdr->hashtab = _newh;
 }
 
 uchar* SparseMat::newNode(const int* idx, size_t hashval)
 {
-    const int HASH_MAX_FILL_FACTOR=3;
     assert(hdr);
     size_t hsize = hdr->hashtab.size();
-    if( ++hdr->nodeCount > hsize*HASH_MAX_FILL_FACTOR )
-    {
-        resizeHashTab(std::max(hsize*2, (size_t)8));
-        hsize = hdr->hashtab.size();
-    }
+    // keep at least 1/4 of the slots empty; the table is grown when it is more than half full
+    // with the live nodes, otherwise it is just rehashed to drop the deleted slots
+    if( (hdr->nodeCount + hdr->deletedCount + 1)*4 > hsize*3 )
+        resizeHashTab((hdr->nodeCount + 1)*2 > hsize ? hsize*2 : hsize);
 
     if( !hdr->freeList )
-    {
-        size_t i, nsz = hdr->nodeSize, psize = hdr->pool.size(),
-            newpsize = std::max(psize*2, 8*nsz);
-        hdr->pool.resize(newpsize);
-        uchar* pool = &hdr->pool[0];
-        hdr->freeList = std::max(psize, nsz);
-        for( i = hdr->freeList; i < newpsize - nsz; i += nsz )
-            ((Node*)(pool + i))->next = i + nsz;
-        ((Node*)(pool + i))->next = 0;
-    }
+        growSparsePool(*hdr, std::max(hdr->pool.size()*2, 8*hdr->nodeSize));
     size_t nidx = hdr->freeList;
     Node* elem = (Node*)&hdr->pool[nidx];
     hdr->freeList = elem->next;
     elem->hashval = hashval;
-    size_t hidx = hashval & (hsize - 1);
-    elem->next = hdr->hashtab[hidx];
+    elem->next = 0;
+
+    unsigned x = sparseHashMix(hashval);
+    size_t hidx = freeSparseSlot(*hdr, x);
+    if( hdr->hashtags[hidx] == HASH_TAG_DELETED )
+        hdr->deletedCount--;
+    hdr->hashtags[hidx] = sparseHashTag(x);
     hdr->hashtab[hidx] = nidx;
+    hdr->nodeCount++;
 
     int i, d = hdr->dims;
     for( i = 0; i < d; i++ )
@@ -4001,16 +4648,22 @@ uchar* SparseMat::newNode(const int* idx, size_t hashval)
 }
 
 
-void SparseMat::removeNode(size_t hidx, size_t nidx, size_t previdx)
+void SparseMat::removeNode(size_t hidx, size_t nidx)
 {
     Node* n = node(nidx);
-    if( previdx )
+    // the slot can become empty only if no probe sequence has passed through its group,
+    // i.e. if the group still has empty slots
+    size_t g = hidx & ~(size_t)(HASH_GROUP_SIZE - 1);
+    unsigned emptyMask;
+    matchHashGroup(&hdr->hashtags[g], (uchar)HASH_TAG_EMPTY, emptyMask);
+    if( emptyMask )
+        hdr->hashtags[hidx] = (uchar)HASH_TAG_EMPTY;
+    else
     {
-        Node* prev = node(previdx);
-        prev->next = n->next;
+        hdr->hashtags[hidx] = (uchar)HASH_TAG_DELETED;
+        hdr->deletedCount++;
     }
-    else
-        hdr->hashtab[hidx] = n->next;
+    hdr->hashtab[hidx] = 0;
     n->next = hdr->freeList;
     hdr->freeList = nidx;
     --hdr->nodeCount;
@@ -4042,12 +4695,6 @@ SparseMatConstIterator& SparseMatConstIterator::operator ++()
     if( !ptr || !m || !m->hdr )
         return *this;
     SparseMat::Hdr& hdr = *m->hdr;
-    size_t next = ((const SparseMat::Node*)(ptr - hdr.valueOffset))->next;
-    if( next )
-    {
-        ptr = &hdr.pool[next] + hdr.valueOffset;
-        return *this;
-    }
     size_t i = hashidx + 1, sz = hdr.hashtab.size();
     for( ; i < sz; i++ )
     {
@@ -48,6 +48,8 @@
     #undef min
     #undef max
     #undef abs
+#else
+    #include <pthread.h>
 #endif
 
 #if defined __linux__ || defined __APPLE__
@@ -79,6 +81,7 @@
    3. HAVE_OPENMP      - integrated to compiler, should be explicitly enabled
    4. HAVE_GCD         - system wide, used automatically        (APPLE only)
    5. HAVE_CONCURRENCY - part of runtime, used automatically    (Windows only - MSVS 10, MSVS 11)
+   6. HAVE_PTHREADS_PF - pthreads-based thread pool, used automatically when nothing above is available
 */
 
 #if defined HAVE_TBB
@@ -111,6 +114,10 @@
 #endif
 
 #if defined HAVE_TBB || defined HAVE_CSTRIPES || defined HAVE_OPENMP || defined HAVE_GCD || defined HAVE_CONCURRENCY
+    #undef HAVE_PTHREADS_PF
+#endif
+
+#if defined HAVE_TBB || defined HAVE_CSTRIPES || defined HAVE_OPENMP || defined HAVE_GCD || defined HAVE_CONCURRENCY || defined HAVE_PTHREADS_PF
    #define HAVE_PARALLEL_FRAMEWORK
 #endif
 
@@ -122,6 +129,74 @@ namespace cv
 namespace
 {
 #ifdef HAVE_PARALLEL_FRAMEWORK
+#if defined HAVE_CSTRIPES || defined HAVE_OPENMP || defined HAVE_PTHREADS_PF
+// These frameworks can't run a parallel region from inside another one. A nested
+// parallel_for_ (called from a loop body) is executed by the calling thread, so the
+// number of busy threads never exceeds getNumThreads(). The flag is per-thread:
+// the calls made concurrently by different user threads all go to the framework.
+#define HAVE_PARALLEL_REGION_GUARD
+
+class ParallelRegionFlag
+{
+public:
+    ParallelRegionFlag()
+    {
+#if defined WIN32 || defined _WIN32
+        key = TlsAlloc();
+        CV_Assert(key != TLS_OUT_OF_INDEXES);
+#else
+        int errcode = pthread_key_create(&key, 0);
+        CV_Assert(errcode == 0);
+#endif
+    }
+
+#if defined WIN32 || defined _WIN32
+    bool get() const { return TlsGetValue(key) != 0; }
+    void set(bool on) { TlsSetValue(key, on ? (void*)1 : 0); }
+
+private:
+    DWORD key;
+#else
+    bool get() const { return pthread_getspecific(key) != 0; }
+    void set(bool on) { pthread_setspecific(key, on ? (void*)1 : 0); }
+
+private:
+    pthread_key_t key;
+#endif
+};
+
+static ParallelRegionFlag& getParallelRegionFlag()
+{
+    static ParallelRegionFlag flag;
+    return flag;
+}
+
+// create the key during the static initialization, before any thread can race for it
+static ParallelRegionFlag& parallelRegionFlagInit = getParallelRegionFlag();
+
+// marks the thread as running a parallel region: set by the thread that calls parallel_for_
+// and by the workers for the time they run its stripes
+class ParallelRegionGuard
+{
+public:
+    ParallelRegionGuard()
+    {
+        outer = !getParallelRegionFlag().get();
+        if (outer)
+            getParallelRegionFlag().set(true);
+    }
+    ~ParallelRegionGuard()
+    {
+        if (outer)
+            getParallelRegionFlag().set(false);
+    }
+    bool isOuter() const { return outer; }
+
+private:
+    bool outer;
+};
+#endif
+
     class ParallelLoopBodyWrapper
     {
     public:
@@ -134,6 +209,10 @@ namespace
         }
         void operator()(const cv::Range& sr) const
         {
+            CV_TRACE_REGION("parallel_for_.stripe");
+#ifdef HAVE_PARALLEL_REGION_GUARD
+            ParallelRegionGuard region;
+#endif
             cv::Range r;
             r.start = (int)(wholeRange.start +
                             ((size_t)sr.start*(wholeRange.end - wholeRange.start) + nstripes/2)/nstripes);
@@ -184,6 +263,19 @@ namespace
             this->ParallelLoopBodyWrapper::operator()(cv::Range(i, i + 1));
         }
     };
+#elif defined HAVE_PTHREADS_PF
+    class ProxyLoopBody : public cv::ParallelLoopBody, public ParallelLoopBodyWrapper
+    {
+    public:
+        ProxyLoopBody(const cv::ParallelLoopBody& _body, const cv::Range& _r, double _nstripes)
+        : ParallelLoopBodyWrapper(_body, _r, _nstripes)
+        {}
+
+        void operator ()(const cv::Range& sr) const
+        {
+            this->ParallelLoopBodyWrapper::operator()(sr);
+        }
+    };
 #else
     typedef ParallelLoopBodyWrapper ProxyLoopBody;
 #endif
@@ -216,6 +308,8 @@ public:
     ~SchedPtr() { *this = 0; }
 };
 static SchedPtr pplScheduler;
+#elif defined HAVE_PTHREADS_PF
+// the thread pool is created on first use, see parallel_pthreads.cpp
 #endif
 
 #endif // HAVE_PARALLEL_FRAMEWORK
@@ -226,12 +320,23 @@ static SchedPtr pplScheduler;
 
 void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body, double nstripes)
 {
+    CV_TRACE_FUNCTION();
+
 #ifdef HAVE_PARALLEL_FRAMEWORK
 
-    if(numThreads != 0)
+#ifdef HAVE_PARALLEL_REGION_GUARD
+    ParallelRegionGuard region;
+#endif
+
+    if(numThreads != 0
+#ifdef HAVE_PARALLEL_REGION_GUARD
+       && region.isOuter()
+#endif
+      )
     {
         ProxyLoopBody pbody(body, range, nstripes);
         cv::Range stripeRange = pbody.stripeRange();
+        CV_TRACE_COUNTER("parallel_for_.stripes", stripeRange.end - stripeRange.start);
 
 #if defined HAVE_TBB
 
@@ -272,6 +377,10 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
             Concurrency::CurrentScheduler::Detach();
         }
 
+#elif defined HAVE_PTHREADS_PF
+
+        parallel_for_pthreads(stripeRange, pbody);
+
 #else
 
 #error You have hacked and compiling with unsupported parallel framework
@@ -284,6 +393,7 @@ void cv::parallel_for_(const cv::Range& range, const cv::ParallelLoopBody& body,
 #endif // HAVE_PARALLEL_FRAMEWORK
     {
         (void)nstripes;
+        CV_TRACE_COUNTER("parallel_for_.stripes", 1);
         body(range);
     }
 }
@@ -323,6 +433,10 @@ int cv::getNumThreads(void)
                 ? Concurrency::CurrentScheduler::Get()->GetNumberOfVirtualProcessors()
                 : pplScheduler->GetNumberOfVirtualProcessors());
 
+#elif defined HAVE_PTHREADS_PF
+
+    return parallel_pthreads_get_threads_num();
+
 #else
 
     return 1;
@@ -376,6 +490,10 @@ void cv::setNumThreads( int threads )
                        Concurrency::MaxConcurrency, threads-1));
     }
 
+#elif defined HAVE_PTHREADS_PF
+
+    parallel_pthreads_set_threads_num(threads);
+
 #endif
 }
 
@@ -396,6 +514,8 @@ int cv::getThreadNum(void)
     return (int)(size_t)(void*)pthread_self(); // no zero-based indexing
 #elif defined HAVE_CONCURRENCY
     return std::max(0, (int)Concurrency::Context::VirtualProcessorId()); // zero for master thread, unique number for others but not necessary 1,2,3,...
+#elif defined HAVE_PTHREADS_PF
+    return parallel_pthreads_get_thread_num();
 #else
     return 0;
 #endif
@@ -0,0 +1,426 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+
+#if defined HAVE_PTHREADS_PF
+
+#include <pthread.h>
+
+/*
+   Work-stealing thread pool used by parallel_for_ when no other parallel
+   framework is available.
+
+   Every participant (the calling thread is participant 0, pool workers are
+   1..N-1) owns a deque of stripe indices. Since the stripes of a single
+   parallel_for_ call are contiguous, a deque is just a [begin, end) range:
+   the owner pops chunks from the front, an idle participant steals the back
+   half of somebody else's range and makes it its own. The chunk taken by the
+   owner shrinks with the amount of remaining work, so large `nstripes` values
+   do not cost a lock per stripe while the tail of the loop is still balanced.
+*/
+
+namespace cv
+{
+
+namespace
+{
+
+struct StripeQueue
+{
+    StripeQueue() : begin(0), end(0) { pthread_mutex_init(&mtx, 0); }
+    ~StripeQueue() { pthread_mutex_destroy(&mtx); }
+
+    pthread_mutex_t mtx;
+    int begin, end;
+    // keep the queues of different participants in different cache lines
+    char pad[64];
+};
+
+class ThreadPool
+{
+public:
+    ThreadPool();
+    ~ThreadPool();
+
+    void run(const Range& stripes, const ParallelLoopBody& body);
+
+    int  getNumThreads() const;
+    void setNumThreads(int nthreads);
+    int  getThreadNum() const;
+
+    static ThreadPool& instance();
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator = (const ThreadPool&);
+
+    void reconfigure(int nthreads);
+    void stop();
+    void work(int self);
+    bool pop(int self, Range& r);
+    bool steal(int self);
+
+    static void* workerMain(void* arg);
+
+    struct WorkerArg { ThreadPool* pool; int idx; unsigned jobId; };
+
+    std::vector<pthread_t> threads;
+    std::vector<WorkerArg> args;
+    StripeQueue* queues;
+    int nqueues;
+    // the thread count the pool was started for; nqueues is less when pthread_create failed
+    int configuredThreads;
+
+    // serializes parallel_for_ calls made by different threads
+    pthread_mutex_t runMtx;
+
+    // job hand-off between the calling thread and the workers
+    pthread_mutex_t mtx;
+    pthread_cond_t jobCond, doneCond;
+    unsigned jobId;
+    int pending;
+    bool stopping;
+    const ParallelLoopBody* job;
+
+    bool failed;
+    Exception error;
+
+    int requestedThreads;
+    pthread_key_t threadIdx;
+};
+
+ThreadPool::ThreadPool()
+    : queues(0), nqueues(0), configuredThreads(0), jobId(0), pending(0), stopping(false), job(0),
+      failed(false), requestedThreads(-1)
+{
+    pthread_mutex_init(&runMtx, 0);
+    pthread_mutex_init(&mtx, 0);
+    pthread_cond_init(&jobCond, 0);
+    pthread_cond_init(&doneCond, 0);
+    pthread_key_create(&threadIdx, 0);
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+    pthread_key_delete(threadIdx);
+    pthread_cond_destroy(&doneCond);
+    pthread_cond_destroy(&jobCond);
+    pthread_mutex_destroy(&mtx);
+    pthread_mutex_destroy(&runMtx);
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+int ThreadPool::getNumThreads() const
+{
+    return requestedThreads > 0 ? requestedThreads : getNumberOfCPUs();
+}
+
+void ThreadPool::setNumThreads(int nthreads)
+{
+    // the workers are (re)started lazily by the next parallel_for_ call
+    pthread_mutex_lock(&runMtx);
+    requestedThreads = nthreads;
+    pthread_mutex_unlock(&runMtx);
+}
+
+int ThreadPool::getThreadNum() const
+{
+    size_t idx = (size_t)pthread_getspecific(threadIdx);
+    return idx > 0 ? (int)idx - 1 : 0;
+}
+
+void ThreadPool::stop()
+{
+    pthread_mutex_lock(&mtx);
+    stopping = true;
+    pthread_cond_broadcast(&jobCond);
+    pthread_mutex_unlock(&mtx);
+
+    for (size_t i = 0; i < threads.size(); i++)
+        pthread_join(threads[i], 0);
+    threads.clear();
+    args.clear();
+
+    delete[] queues;
+    queues = 0;
+    nqueues = 0;
+    configuredThreads = 0;
+    stopping = false;
+}
+
+void ThreadPool::reconfigure(int nthreads)
+{
+    stop();
+
+    configuredThreads = nthreads;
+    nqueues = nthreads;
+    queues = new StripeQueue[nqueues];
+
+    threads.resize(nthreads - 1);
+    args.resize(nthreads - 1);
+    for (int i = 0; i < nthreads - 1; i++)
+    {
+        args[i].pool = this;
+        args[i].idx = i + 1;
+        args[i].jobId = jobId;
+        if (pthread_create(&threads[i], 0, workerMain, &args[i]) != 0)
+        {
+            // run with the workers we managed to start; the pool is not restarted
+            // until the thread count is changed
+            threads.resize(i);
+            args.resize(i);
+            nqueues = i + 1;
+            break;
+        }
+    }
+}
+
+void* ThreadPool::workerMain(void* arg)
+{
+    ThreadPool* pool = ((WorkerArg*)arg)->pool;
+    int self = ((WorkerArg*)arg)->idx;
+    unsigned seenJob = ((WorkerArg*)arg)->jobId;
+
+    pthread_setspecific(pool->threadIdx, (void*)(size_t)(self + 1));
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->mtx);
+        while (!pool->stopping && pool->jobId == seenJob)
+            pthread_cond_wait(&pool->jobCond, &pool->mtx);
+        if (pool->stopping)
+        {
+            pthread_mutex_unlock(&pool->mtx);
+            break;
+        }
+        seenJob = pool->jobId;
+        pthread_mutex_unlock(&pool->mtx);
+
+        pool->work(self);
+
+        pthread_mutex_lock(&pool->mtx);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->doneCond);
+        pthread_mutex_unlock(&pool->mtx);
+    }
+
+    return 0;
+}
+
+bool ThreadPool::pop(int self, Range& r)
+{
+    StripeQueue& q = queues[self];
+    pthread_mutex_lock(&q.mtx);
+    int len = q.end - q.begin;
+    bool ok = len > 0;
+    if (ok)
+    {
+        int chunk = std::max(len / (nqueues * 2), 1);
+        r = Range(q.begin, q.begin + chunk);
+        q.begin += chunk;
+    }
+    pthread_mutex_unlock(&q.mtx);
+    return ok;
+}
+
+bool ThreadPool::steal(int self)
+{
+    for (int k = 1; k < nqueues; k++)
+    {
+        StripeQueue& victim = queues[(self + k) % nqueues];
+        Range r;
+
+        pthread_mutex_lock(&victim.mtx);
+        int len = victim.end - victim.begin;
+        if (len > 0)
+        {
+            int half = (len + 1) / 2;
+            r = Range(victim.end - half, victim.end);
+            victim.end -= half;
+        }
+        pthread_mutex_unlock(&victim.mtx);
+
+        if (len > 0)
+        {
+            StripeQueue& q = queues[self];
+            pthread_mutex_lock(&q.mtx);
+            q.begin = r.start;
+            q.end = r.end;
+            pthread_mutex_unlock(&q.mtx);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::work(int self)
+{
+    Range r;
+    bool aborted = false;
+    try
+    {
+        for (;;)
+        {
+            if (pop(self, r))
+                (*job)(r);
+            else if (!steal(self))
+                break;
+        }
+    }
+    catch (const Exception& e)
+    {
+        pthread_mutex_lock(&mtx);
+        if (!failed)
+            error = e;
+        failed = aborted = true;
+        pthread_mutex_unlock(&mtx);
+    }
+    catch (...)
+    {
+        pthread_mutex_lock(&mtx);
+        if (!failed)
+            error = Exception(CV_StsError, "Unknown exception in parallel_for_ body", "", __FILE__, __LINE__);
+        failed = aborted = true;
+        pthread_mutex_unlock(&mtx);
+    }
+
+    if (aborted)
+    {
+        // drop the stripes nobody has started yet
+        for (int i = 0; i < nqueues; i++)
+        {
+            pthread_mutex_lock(&queues[i].mtx);
+            queues[i].begin = queues[i].end;
+            pthread_mutex_unlock(&queues[i].mtx);
+        }
+    }
+}
+
+void ThreadPool::run(const Range& stripes, const ParallelLoopBody& body)
+{
+    // a body calling parallel_for_ from one of the participating threads
+    if (pthread_getspecific(threadIdx) != 0)
+    {
+        body(stripes);
+        return;
+    }
+
+    pthread_mutex_lock(&runMtx);
+
+    int nthreads = getNumThreads();
+    if (nthreads != configuredThreads)
+        reconfigure(nthreads);
+
+    int len = stripes.end - stripes.start;
+    if (nqueues <= 1 || len <= 1)
+    {
+        pthread_mutex_unlock(&runMtx);
+        body(stripes);
+        return;
+    }
+
+    // initial even distribution of the stripes between the participants
+    int nparts = std::min(nqueues, len);
+    for (int i = 0; i < nqueues; i++)
+    {
+        queues[i].begin = i < nparts ? stripes.start + (int)((int64)len*i/nparts) : stripes.end;
+        queues[i].end = i < nparts ? stripes.start + (int)((int64)len*(i+1)/nparts) : stripes.end;
+    }
+
+    pthread_mutex_lock(&mtx);
+    job = &body;
+    failed = false;
+    pending = nqueues - 1;
+    jobId++;
+    pthread_cond_broadcast(&jobCond);
+    pthread_mutex_unlock(&mtx);
+
+    pthread_setspecific(threadIdx, (void*)(size_t)1);
+    work(0);
+    pthread_setspecific(threadIdx, 0);
+
+    pthread_mutex_lock(&mtx);
+    while (pending > 0)
+        pthread_cond_wait(&doneCond, &mtx);
+    job = 0;
+    bool rethrow = failed;
+    Exception e = error;
+    pthread_mutex_unlock(&mtx);
+
+    pthread_mutex_unlock(&runMtx);
+
+    if (rethrow)
+        throw e;
+}
+
+} // namespace
+
+void parallel_for_pthreads(const Range& stripes, const ParallelLoopBody& body)
+{
+    ThreadPool::instance().run(stripes, body);
+}
+
+int parallel_pthreads_get_threads_num()
+{
+    return ThreadPool::instance().getNumThreads();
+}
+
+void parallel_pthreads_set_threads_num(int nthreads)
+{
+    ThreadPool::instance().setNumThreads(nthreads);
+}
+
+int parallel_pthreads_get_thread_num()
+{
+    return ThreadPool::instance().getThreadNum();
+}
+
+} // namespace cv
+
+#endif // HAVE_PTHREADS_PF
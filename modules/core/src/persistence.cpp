@@ -46,6 +46,17 @@
 #include <deque>
 #include <iterator>
 
+#if defined WIN32 || defined _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <io.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
 #define USE_ZLIB 1
 
 #ifdef __APPLE__
@@ -198,6 +209,7 @@ typedef void (*CvWriteString)( struct CvFileStorage* fs, const char* key,
                                const char* value, int quote );
 typedef void (*CvWriteComment)( struct CvFileStorage* fs, const char* comment, int eol_comment );
 typedef void (*CvStartNextStream)( struct CvFileStorage* fs );
+typedef void (*CvWriteSink)( void* userdata, const char* data, size_t len );
 
 typedef struct CvFileStorage
 {
@@ -240,13 +252,130 @@ typedef struct CvFileStorage
     std::deque<char>* outbuf;
 
     bool is_opened;
+
+    struct CvFileMapping* mapping;
+    size_t binpos;
+
+    // streaming output: the content of outbuf is passed to the sink when it grows
+    // over sink_limit bytes or when a top-level collection is complete
+    CvWriteSink sink;
+    void* sink_userdata;
+    size_t sink_limit;
+#if USE_ZLIB
+    z_stream* zstream;
+#endif
 }
 CvFileStorage;
 
+/* The memory a binary storage has been parsed from. The matrices read from the storage
+   may reference it directly, so the region is reference-counted; refcount must be the first
+   field since Mat::refcount points to it */
+typedef struct CvFileMapping
+{
+    int refcount;
+    uchar* data;
+    size_t size;
+    bool mapped;
+}
+CvFileMapping;
+
+/* sequence of numbers stored in a binary storage as a single raw array. The nodes
+   are not created until somebody accesses the sequence elements individually */
+typedef struct CvFileBlob
+{
+    CV_SEQUENCE_FIELDS()
+    const uchar* blob_data;
+    int blob_depth;
+    int expanded;
+}
+CvFileBlob;
+
+#define CV_NODE_SEQ_BLOB 512
+#define CV_NODE_SEQ_IS_BLOB(seq) (((seq)->flags & CV_NODE_SEQ_BLOB) != 0)
+
+// the reader of a blob walks the raw array instead of the sequence blocks
+#define CV_IS_BLOB_READER(reader) \
+    ((reader)->seq && !(reader)->block && CV_NODE_SEQ_IS_BLOB((CvSeq*)(reader)->seq))
+
+static void icvFlushSink( CvFileStorage* fs )
+{
+    if( fs->sink && !fs->outbuf->empty() )
+    {
+        std::vector<char> chunk( fs->outbuf->begin(), fs->outbuf->end() );
+        fs->outbuf->clear();
+        fs->sink( fs->sink_userdata, &chunk[0], chunk.size() );
+    }
+}
+
+#if USE_ZLIB
+static void icvDeflate( CvFileStorage* fs, const char* data, size_t len, int flush )
+{
+    z_stream* zstream = fs->zstream;
+    char buf[1 << 14];
+
+    do
+    {
+        uInt count = (uInt)std::min( len, (size_t)1 << 30 );
+        zstream->next_in = (Bytef*)data;
+        zstream->avail_in = count;
+        data += count;
+        len -= count;
+        do
+        {
+            zstream->next_out = (Bytef*)buf;
+            zstream->avail_out = (uInt)sizeof(buf);
+            deflate( zstream, len > 0 ? Z_NO_FLUSH : flush );
+            fs->outbuf->insert( fs->outbuf->end(), buf, buf + sizeof(buf) - zstream->avail_out );
+            if( fs->sink && fs->outbuf->size() >= fs->sink_limit )
+                icvFlushSink( fs );
+        }
+        while( zstream->avail_out == 0 );
+    }
+    while( len > 0 );
+}
+
+static z_stream* icvCreateDeflateStream( int level )
+{
+    z_stream* zstream = new z_stream;
+    memset( zstream, 0, sizeof(*zstream) );
+    // 16 added to the window bits produces the gzip header and trailer
+    if( deflateInit2( zstream, level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+    {
+        delete zstream;
+        CV_Error( CV_StsError, "Could not initialize the compressor" );
+    }
+    return zstream;
+}
+
+static void icvReleaseDeflateStream( CvFileStorage* fs )
+{
+    if( fs->zstream )
+    {
+        deflateEnd( fs->zstream );
+        delete fs->zstream;
+        fs->zstream = 0;
+    }
+}
+#endif
+
+/* appends the data to the memory output, compressing it if needed */
+static void icvPutToOutbuf( CvFileStorage* fs, const char* data, size_t len )
+{
+#if USE_ZLIB
+    if( fs->zstream )
+        icvDeflate( fs, data, len, Z_NO_FLUSH );
+    else
+#endif
+        fs->outbuf->insert( fs->outbuf->end(), data, data + len );
+
+    if( fs->sink && fs->outbuf->size() >= fs->sink_limit )
+        icvFlushSink( fs );
+}
+
 static void icvPuts( CvFileStorage* fs, const char* str )
 {
     if( fs->outbuf )
-        std::copy(str, str + strlen(str), std::back_inserter(*fs->outbuf));
+        icvPutToOutbuf( fs, str, strlen(str) );
     else if( fs->file )
         fputs( str, fs->file );
 #if USE_ZLIB
@@ -326,6 +455,103 @@ static void icvRewind( CvFileStorage* fs )
     fs->strbufpos = 0;
 }
 
+static void icvFreeFileMapping( CvFileMapping* mapping )
+{
+    if( mapping->mapped )
+    {
+#if defined WIN32 || defined _WIN32
+        UnmapViewOfFile( mapping->data );
+#else
+        munmap( mapping->data, mapping->size );
+#endif
+    }
+    else
+        cv::fastFree( mapping->data );
+    cvFree( &mapping );
+}
+
+static void icvReleaseFileMapping( CvFileMapping** mapping )
+{
+    if( *mapping && CV_XADD(&(*mapping)->refcount, -1) == 1 )
+        icvFreeFileMapping( *mapping );
+    *mapping = 0;
+}
+
+static CvFileMapping* icvCreateFileMapping( uchar* data, size_t size, bool mapped )
+{
+    CvFileMapping* mapping = (CvFileMapping*)cvAlloc( sizeof(*mapping) );
+    mapping->refcount = 1;
+    mapping->data = data;
+    mapping->size = size;
+    mapping->mapped = mapped;
+    return mapping;
+}
+
+/* maps the file into memory. The mapping is private: the pages are shared with
+   the other processes mapping the same file until somebody modifies them */
+static CvFileMapping* icvMapFile( FILE* f )
+{
+    uchar* data = 0;
+    size_t size = 0;
+#if defined WIN32 || defined _WIN32
+    HANDLE hfile = (HANDLE)_get_osfhandle( _fileno(f) );
+    LARGE_INTEGER fsize;
+    if( hfile == INVALID_HANDLE_VALUE || !GetFileSizeEx( hfile, &fsize ) || fsize.QuadPart <= 0 )
+        return 0;
+    size = (size_t)fsize.QuadPart;
+    HANDLE hmap = CreateFileMapping( hfile, 0, PAGE_WRITECOPY, 0, 0, 0 );
+    if( !hmap )
+        return 0;
+    data = (uchar*)MapViewOfFile( hmap, FILE_MAP_COPY, 0, 0, 0 );
+    // the view keeps the mapping object alive
+    CloseHandle( hmap );
+    if( !data )
+        return 0;
+#else
+    struct stat st;
+    if( fstat( fileno(f), &st ) != 0 || st.st_size <= 0 )
+        return 0;
+    size = (size_t)st.st_size;
+    void* ptr = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0 );
+    if( ptr == MAP_FAILED )
+        return 0;
+    data = (uchar*)ptr;
+#endif
+    return icvCreateFileMapping( data, size, true );
+}
+
+/* reads the whole (possibly compressed) file into memory */
+static CvFileMapping* icvLoadFile( CvFileStorage* fs )
+{
+    std::vector<uchar> buf;
+    size_t size = 0, chunk = 1 << 20;
+
+    icvRewind( fs );
+    for(;;)
+    {
+        buf.resize( size + chunk );
+        size_t count = 0;
+        if( fs->file )
+            count = fread( &buf[size], 1, chunk, fs->file );
+#if USE_ZLIB
+        else if( fs->gzfile )
+        {
+            int n = gzread( fs->gzfile, &buf[size], (unsigned)chunk );
+            count = n > 0 ? (size_t)n : 0;
+        }
+#endif
+        if( count == 0 )
+            break;
+        size += count;
+    }
+
+    if( size == 0 )
+        return 0;
+    uchar* data = (uchar*)cv::fastMalloc( size );
+    memcpy( data, &buf[0], size );
+    return icvCreateFileMapping( data, size, false );
+}
+
 #define CV_YML_INDENT  3
 #define CV_XML_INDENT  2
 #define CV_YML_INDENT_FLOW  1
@@ -435,6 +661,94 @@ icvFSCreateCollection( CvFileStorage* fs, int tag, CvFileNode* collection )
 }
 
 
+static void
+icvBlobElemToNode( const uchar* data, int depth, int idx, CvFileNode* node )
+{
+    node->info = 0;
+    switch( depth )
+    {
+    case CV_8U:
+        node->tag = CV_NODE_INT;
+        node->data.i = ((const uchar*)data)[idx];
+        break;
+    case CV_8S:
+        node->tag = CV_NODE_INT;
+        node->data.i = ((const schar*)data)[idx];
+        break;
+    case CV_16U:
+        node->tag = CV_NODE_INT;
+        node->data.i = ((const ushort*)data)[idx];
+        break;
+    case CV_16S:
+        node->tag = CV_NODE_INT;
+        node->data.i = ((const short*)data)[idx];
+        break;
+    case CV_32S:
+        node->tag = CV_NODE_INT;
+        node->data.i = ((const int*)data)[idx];
+        break;
+    case CV_32F:
+        node->tag = CV_NODE_REAL;
+        node->data.f = ((const float*)data)[idx];
+        break;
+    default:
+        node->tag = CV_NODE_REAL;
+        node->data.f = ((const double*)data)[idx];
+    }
+}
+
+
+static void
+icvFSAppendBlobNodes( CvSeq* seq, const uchar* data, int depth, int count )
+{
+    CvFileNode buf[256];
+    for( int i = 0; i < count; )
+    {
+        int j, n = std::min( count - i, (int)(sizeof(buf)/sizeof(buf[0])) );
+        for( j = 0; j < n; j++, i++ )
+            icvBlobElemToNode( data, depth, i, buf + j );
+        cvSeqPushMulti( seq, buf, n );
+    }
+}
+
+
+/* creates the file nodes for the elements of the raw array; it is done once,
+   when the sequence is accessed via the functions returning the element nodes */
+static void
+icvFSExpandBlob( const CvFileNode* node )
+{
+    if( !node || !CV_NODE_IS_SEQ(node->tag) || !CV_NODE_SEQ_IS_BLOB(node->data.seq) )
+        return;
+
+    CvFileBlob* blob = (CvFileBlob*)node->data.seq;
+    if( !blob->expanded )
+    {
+        int count = blob->total;
+        blob->total = 0;
+        icvFSAppendBlobNodes( (CvSeq*)blob, blob->blob_data, blob->blob_depth, count );
+        blob->expanded = 1;
+    }
+}
+
+
+static bool
+icvIsLazyBlob( const CvSeq* seq )
+{
+    return CV_NODE_SEQ_IS_BLOB(seq) && !((const CvFileBlob*)seq)->expanded;
+}
+
+
+static void
+icvStartReadBlob( const CvFileBlob* blob, CvSeqReader* reader )
+{
+    memset( reader, 0, sizeof(*reader) );
+    reader->header_size = sizeof(*reader);
+    reader->seq = (CvSeq*)blob;
+    reader->ptr = reader->block_min = (schar*)blob->blob_data;
+    reader->block_max = reader->block_min + (size_t)blob->total*CV_ELEM_SIZE1(blob->blob_depth);
+}
+
+
 /*static void
 icvFSReleaseCollection( CvSeq* seq )
 {
@@ -536,6 +850,15 @@ icvClose( CvFileStorage* fs, cv::String* out )
             icvFSFlush(fs);
             if( fs->fmt == CV_STORAGE_FORMAT_XML )
                 icvPuts( fs, "</opencv_storage>\n" );
+#if USE_ZLIB
+            if( fs->zstream )
+            {
+                icvDeflate( fs, 0, 0, Z_FINISH );
+                icvReleaseDeflateStream( fs );
+            }
+#endif
+            if( fs->outbuf )
+                icvFlushSink( fs );
         }
 
         icvCloseFile(fs);
@@ -565,6 +888,10 @@ cvReleaseFileStorage( CvFileStorage** p_fs )
         cvReleaseMemStorage( &fs->strstorage );
         cvFree( &fs->buffer_start );
         cvReleaseMemStorage( &fs->memstorage );
+        icvReleaseFileMapping( &fs->mapping );
+#if USE_ZLIB
+        icvReleaseDeflateStream( fs );
+#endif
 
         if( fs->outbuf )
             delete fs->outbuf;
@@ -681,6 +1008,7 @@ cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
                 if( !create_missing )
                 {
                     value = &another->value;
+                    icvFSExpandBlob( value );
                     return value;
                 }
                 CV_PARSE_ERROR( "Duplicated key" );
@@ -701,8 +1029,8 @@ cvGetFileNode( CvFileStorage* fs, CvFileNode* _map_node,
 }
 
 
-CV_IMPL CvFileNode*
-cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
+static CvFileNode*
+icvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
 {
     CvFileNode* value = 0;
     int i, len, tab_size;
@@ -772,6 +1100,16 @@ cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const
 }
 
 
+CV_IMPL CvFileNode*
+cvGetFileNodeByName( const CvFileStorage* fs, const CvFileNode* _map_node, const char* str )
+{
+    CvFileNode* value = icvGetFileNodeByName( fs, _map_node, str );
+    // the caller may access the sequence elements directly
+    icvFSExpandBlob( value );
+    return value;
+}
+
+
 CV_IMPL CvFileNode*
 cvGetRootFileNode( const CvFileStorage* fs, int stream_index )
 {
@@ -2650,6 +2988,478 @@ icvXMLWriteComment( CvFileStorage* fs, const char* comment, int eol_comment )
 }
 
 
+/****************************************************************************************\
+*                              Binary Emitter and Parser                                 *
+\****************************************************************************************/
+
+/*
+   The binary storage starts with 16-byte header: the signature padded with zeros and
+   a byte order mark. It is followed by a stream of records, each starting with one-byte code.
+   The records of collection elements have a key (int32 length + characters) after the code;
+   the length is 0 for sequence elements:
+
+     'i' <key> int32                  'r' <key> float64
+     's' <key> int32 len, chars       '{' <key> int32 flags, int32 len, type name chars
+     '}'                              '-' (the next stream starts)
+     'd' <key> int32 depth, int32 count, int32 pad, pad zero bytes, raw array
+
+   The raw arrays written by cvWriteRawData are aligned, big arrays start at a page
+   boundary, so the matrices can be used right from the mapped file.
+*/
+
+#define CV_BIN_SIGNATURE "%CVBIN:1.0\n"
+#define CV_BIN_HEADER_SIZE 16
+#define CV_BIN_BYTE_ORDER 0x01020304
+#define CV_BIN_DATA_ALIGN 16
+#define CV_BIN_PAGE_SIZE 4096
+#define CV_BIN_PAGE_ALIGN_THRESHOLD (1 << 16)
+
+static void
+icvBinaryPut( CvFileStorage* fs, const void* data, size_t len )
+{
+    const char* ptr = (const char*)data;
+
+    if( fs->outbuf )
+        icvPutToOutbuf( fs, ptr, len );
+    else if( fs->file )
+    {
+        if( fwrite( ptr, 1, len, fs->file ) != len )
+            CV_Error( CV_StsError, "Could not write to the file storage" );
+    }
+#if USE_ZLIB
+    else if( fs->gzfile )
+    {
+        for( size_t ofs = 0; ofs < len; )
+        {
+            unsigned n = (unsigned)std::min( len - ofs, (size_t)1 << 30 );
+            if( gzwrite( fs->gzfile, ptr + ofs, n ) != (int)n )
+                CV_Error( CV_StsError, "Could not write to the file storage" );
+            ofs += n;
+        }
+    }
+#endif
+    else
+        CV_Error( CV_StsError, "The storage is not opened" );
+
+    fs->binpos += len;
+}
+
+
+static void
+icvBinaryPutInt( CvFileStorage* fs, int value )
+{
+    icvBinaryPut( fs, &value, sizeof(value) );
+}
+
+
+static void
+icvBinaryPutString( CvFileStorage* fs, const char* str )
+{
+    int len = str ? (int)strlen(str) : 0;
+    icvBinaryPutInt( fs, len );
+    icvBinaryPut( fs, str, len );
+}
+
+
+static void
+icvBinaryStartRecord( CvFileStorage* fs, char code, const char* key )
+{
+    int struct_flags = fs->struct_flags;
+
+    if( key && key[0] == '\0' )
+        key = 0;
+
+    if( CV_NODE_IS_COLLECTION(struct_flags) )
+    {
+        if( (CV_NODE_IS_MAP(struct_flags) ^ (key != 0)) )
+            CV_Error( CV_StsBadArg, "An attempt to add element without a key to a map, "
+                                    "or add element with key to sequence" );
+    }
+    else
+    {
+        fs->is_first = 0;
+        struct_flags = CV_NODE_EMPTY | (key ? CV_NODE_MAP : CV_NODE_SEQ);
+    }
+
+    if( key )
+    {
+        if( strlen(key) > CV_FS_MAX_LEN )
+            CV_Error( CV_StsBadArg, "The key is too long" );
+        if( !cv_isalpha(key[0]) && key[0] != '_' )
+            CV_Error( CV_StsBadArg, "Key must start with a letter or _" );
+    }
+
+    icvBinaryPut( fs, &code, 1 );
+    icvBinaryPutString( fs, key );
+    fs->struct_flags = struct_flags & ~CV_NODE_EMPTY;
+}
+
+
+static void
+icvBinaryStartWriteStruct( CvFileStorage* fs, const char* key, int struct_flags,
+                           const char* type_name CV_DEFAULT(0))
+{
+    int parent_flags;
+
+    struct_flags = (struct_flags & (CV_NODE_TYPE_MASK|CV_NODE_FLOW)) | CV_NODE_EMPTY;
+    if( !CV_NODE_IS_COLLECTION(struct_flags))
+        CV_Error( CV_StsBadArg,
+        "Some collection type - CV_NODE_SEQ or CV_NODE_MAP, must be specified" );
+
+    if( type_name && strlen(type_name) > CV_FS_MAX_LEN )
+        CV_Error( CV_StsBadArg, "The type name is too long" );
+
+    icvBinaryStartRecord( fs, '{', key );
+    icvBinaryPutInt( fs, struct_flags & (CV_NODE_TYPE_MASK|CV_NODE_FLOW) );
+    icvBinaryPutString( fs, type_name );
+
+    parent_flags = fs->struct_flags;
+    cvSeqPush( fs->write_stack, &parent_flags );
+    fs->struct_flags = struct_flags;
+}
+
+
+static void
+icvBinaryEndWriteStruct( CvFileStorage* fs )
+{
+    int parent_flags = 0;
+    char code = '}';
+
+    if( fs->write_stack->total == 0 )
+        CV_Error( CV_StsError, "EndWriteStruct w/o matching StartWriteStruct" );
+
+    cvSeqPop( fs->write_stack, &parent_flags );
+    icvBinaryPut( fs, &code, 1 );
+    fs->struct_flags = parent_flags;
+}
+
+
+static void
+icvBinaryStartNextStream( CvFileStorage* fs )
+{
+    if( !fs->is_first )
+    {
+        char code = '-';
+        while( fs->write_stack->total > 0 )
+            icvBinaryEndWriteStruct(fs);
+
+        icvBinaryPut( fs, &code, 1 );
+        fs->struct_flags = CV_NODE_EMPTY;
+    }
+}
+
+
+static void
+icvBinaryWriteInt( CvFileStorage* fs, const char* key, int value )
+{
+    icvBinaryStartRecord( fs, 'i', key );
+    icvBinaryPutInt( fs, value );
+}
+
+
+static void
+icvBinaryWriteReal( CvFileStorage* fs, const char* key, double value )
+{
+    icvBinaryStartRecord( fs, 'r', key );
+    icvBinaryPut( fs, &value, sizeof(value) );
+}
+
+
+static void
+icvBinaryWriteString( CvFileStorage* fs, const char* key,
+                      const char* str, int /*quote*/ CV_DEFAULT(0))
+{
+    if( !str )
+        CV_Error( CV_StsNullPtr, "Null string pointer" );
+
+    if( strlen(str) > CV_FS_MAX_LEN )
+        CV_Error( CV_StsBadArg, "The written string is too long" );
+
+    icvBinaryStartRecord( fs, 's', key );
+    icvBinaryPutString( fs, str );
+}
+
+
+static void
+icvBinaryWriteComment( CvFileStorage* /*fs*/, const char* comment, int /*eol_comment*/ )
+{
+    // the comments are not stored in the binary storage
+    if( !comment )
+        CV_Error( CV_StsNullPtr, "Null comment" );
+}
+
+
+static const char*
+icvBinaryWriteScalar( CvFileStorage* fs, const char* data, int elem_type )
+{
+    switch( elem_type )
+    {
+    case CV_8U:
+        icvBinaryWriteInt( fs, 0, *(uchar*)data );
+        return data + 1;
+    case CV_8S:
+        icvBinaryWriteInt( fs, 0, *(schar*)data );
+        return data + 1;
+    case CV_16U:
+        icvBinaryWriteInt( fs, 0, *(ushort*)data );
+        return data + sizeof(ushort);
+    case CV_16S:
+        icvBinaryWriteInt( fs, 0, *(short*)data );
+        return data + sizeof(short);
+    case CV_32S:
+        icvBinaryWriteInt( fs, 0, *(int*)data );
+        return data + sizeof(int);
+    case CV_32F:
+        icvBinaryWriteReal( fs, 0, *(float*)data );
+        return data + sizeof(float);
+    case CV_64F:
+        icvBinaryWriteReal( fs, 0, *(double*)data );
+        return data + sizeof(double);
+    case CV_USRTYPE1: /* reference */
+        icvBinaryWriteInt( fs, 0, (int)*(size_t*)data );
+        return data + sizeof(size_t);
+    default:
+        CV_Error( CV_StsBadArg, "Unsupported element type" );
+    }
+    return data;
+}
+
+
+static void
+icvBinaryWriteRawData( CvFileStorage* fs, const void* data, int depth, int count )
+{
+    static const char zeros[CV_BIN_PAGE_SIZE] = {0};
+    size_t size = (size_t)count*CV_ELEM_SIZE1(depth);
+
+    icvBinaryStartRecord( fs, 'd', 0 );
+    icvBinaryPutInt( fs, depth );
+    icvBinaryPutInt( fs, count );
+
+    size_t pos = fs->binpos + sizeof(int);
+    int align = size >= CV_BIN_PAGE_ALIGN_THRESHOLD ? CV_BIN_PAGE_SIZE : CV_BIN_DATA_ALIGN;
+    int pad = (int)(cv::alignSize( pos, align ) - pos);
+
+    icvBinaryPutInt( fs, pad );
+    icvBinaryPut( fs, zeros, pad );
+    icvBinaryPut( fs, data, size );
+}
+
+
+struct CvBinaryParseFrame
+{
+    CvFileNode* node;
+    // the raw array that is so far the only content of the sequence
+    const uchar* blob_data;
+    int blob_depth;
+    int blob_count;
+    bool is_simple;
+};
+
+
+static const uchar*
+icvBinaryGet( CvFileStorage* fs, const uchar* ptr, void* dst, size_t len )
+{
+    if( (size_t)(fs->mapping->data + fs->mapping->size - ptr) < len )
+        CV_PARSE_ERROR( "Unexpected end of file" );
+    memcpy( dst, ptr, len );
+    return ptr + len;
+}
+
+
+static const uchar*
+icvBinaryGetString( CvFileStorage* fs, const uchar* ptr, const char*& str, int& len )
+{
+    ptr = icvBinaryGet( fs, ptr, &len, sizeof(len) );
+    if( len < 0 || (size_t)(fs->mapping->data + fs->mapping->size - ptr) < (size_t)len )
+        CV_PARSE_ERROR( "Invalid string length" );
+    str = (const char*)ptr;
+    return ptr + len;
+}
+
+
+static void
+icvBinaryCloseCollection( CvFileStorage* fs, const CvBinaryParseFrame& frame )
+{
+    CvFileNode* node = frame.node;
+
+    if( frame.blob_data )
+    {
+        // replace the empty sequence with the blob
+        CvFileBlob* blob = (CvFileBlob*)cvCreateSeq( 0, sizeof(CvFileBlob),
+                                sizeof(CvFileNode), fs->memstorage );
+        blob->flags |= CV_NODE_SEQ_BLOB | CV_NODE_SEQ_SIMPLE;
+        blob->total = frame.blob_count;
+        blob->blob_data = frame.blob_data;
+        blob->blob_depth = frame.blob_depth;
+        blob->expanded = 0;
+        node->data.seq = (CvSeq*)blob;
+    }
+    else if( CV_NODE_IS_SEQ(node->tag) && frame.is_simple )
+        node->data.seq->flags |= CV_NODE_SEQ_SIMPLE;
+}
+
+
+static void
+icvBinaryParse( CvFileStorage* fs )
+{
+    const uchar* base = fs->mapping->data;
+    const uchar* end = base + fs->mapping->size;
+    const uchar* ptr = base;
+    std::vector<CvBinaryParseFrame> stack;
+    char type_name[CV_FS_MAX_LEN + 1];
+    int byte_order = 0;
+
+    if( fs->mapping->size < CV_BIN_HEADER_SIZE ||
+        memcmp( base, CV_BIN_SIGNATURE, strlen(CV_BIN_SIGNATURE) ) != 0 )
+        CV_PARSE_ERROR( "Invalid binary storage signature" );
+
+    memcpy( &byte_order, base + CV_BIN_HEADER_SIZE - sizeof(int), sizeof(int) );
+    if( byte_order != CV_BIN_BYTE_ORDER )
+        CV_PARSE_ERROR( "The storage has been written on a platform with different byte order" );
+    ptr += CV_BIN_HEADER_SIZE;
+
+    for(;;)
+    {
+        const char *key = 0, *str = 0;
+        int keylen = 0, len = 0;
+        CvFileNode* elem;
+
+        // report the byte offset instead of the line number
+        fs->lineno = (int)(ptr - base);
+
+        if( ptr == end || *ptr == '-' )
+        {
+            // the top-level collection of the stream is closed implicitly
+            if( stack.size() > 1 )
+                CV_PARSE_ERROR( "Unexpected end of stream inside a collection" );
+            if( !stack.empty() )
+                icvBinaryCloseCollection( fs, stack.back() );
+            stack.clear();
+            if( ptr == end )
+                break;
+            ptr++;
+            continue;
+        }
+
+        char code = (char)*ptr++;
+        if( code == '}' )
+        {
+            if( stack.size() <= 1 )
+                CV_PARSE_ERROR( "Unexpected end of collection" );
+            icvBinaryCloseCollection( fs, stack.back() );
+            stack.pop_back();
+            continue;
+        }
+
+        ptr = icvBinaryGetString( fs, ptr, key, keylen );
+
+        if( stack.empty() )
+        {
+            // the stream root is a map or a sequence depending on the first element
+            CvBinaryParseFrame root = { 0, 0, 0, 0, true };
+            root.node = (CvFileNode*)cvSeqPush( fs->roots, 0 );
+            memset( root.node, 0, sizeof(*root.node) );
+            icvFSCreateCollection( fs, keylen > 0 ? CV_NODE_MAP : CV_NODE_SEQ, root.node );
+            stack.push_back( root );
+        }
+
+        CvBinaryParseFrame& frame = stack.back();
+        CvFileNode* parent = frame.node;
+
+        if( CV_NODE_IS_MAP(parent->tag) != (keylen > 0) )
+            CV_PARSE_ERROR( "Map elements must have keys and sequence elements must not" );
+
+        if( frame.blob_data )
+        {
+            icvFSAppendBlobNodes( parent->data.seq, frame.blob_data,
+                                  frame.blob_depth, frame.blob_count );
+            frame.blob_data = 0;
+        }
+
+        if( code == 'd' )
+        {
+            int depth = -1, count = 0, pad = -1;
+            ptr = icvBinaryGet( fs, ptr, &depth, sizeof(depth) );
+            ptr = icvBinaryGet( fs, ptr, &count, sizeof(count) );
+            ptr = icvBinaryGet( fs, ptr, &pad, sizeof(pad) );
+            if( depth < CV_8U || depth > CV_64F || count <= 0 || pad < 0 )
+                CV_PARSE_ERROR( "Invalid raw data record" );
+
+            size_t size = (size_t)count*CV_ELEM_SIZE1(depth);
+            if( (size_t)(end - ptr) < (size_t)pad || (size_t)(end - ptr - pad) < size )
+                CV_PARSE_ERROR( "Unexpected end of file" );
+            ptr += pad;
+
+            if( parent->data.seq->total == 0 )
+            {
+                frame.blob_data = ptr;
+                frame.blob_depth = depth;
+                frame.blob_count = count;
+            }
+            else
+                icvFSAppendBlobNodes( parent->data.seq, ptr, depth, count );
+            ptr += size;
+            continue;
+        }
+
+        if( keylen > 0 )
+        {
+            CvStringHashNode* hkey = cvGetHashedKey( fs, key, keylen, 1 );
+            elem = cvGetFileNode( fs, parent, hkey, 1 );
+        }
+        else
+            elem = (CvFileNode*)cvSeqPush( parent->data.seq, 0 );
+        memset( elem, 0, sizeof(*elem) );
+
+        switch( code )
+        {
+        case 'i':
+            elem->tag = CV_NODE_INT;
+            ptr = icvBinaryGet( fs, ptr, &elem->data.i, sizeof(elem->data.i) );
+            break;
+        case 'r':
+            elem->tag = CV_NODE_REAL;
+            ptr = icvBinaryGet( fs, ptr, &elem->data.f, sizeof(elem->data.f) );
+            break;
+        case 's':
+            ptr = icvBinaryGetString( fs, ptr, str, len );
+            elem->tag = CV_NODE_STRING;
+            elem->data.str = cvMemStorageAllocString( fs->memstorage, str, len );
+            break;
+        case '{':
+            {
+            int flags = 0;
+            ptr = icvBinaryGet( fs, ptr, &flags, sizeof(flags) );
+            ptr = icvBinaryGetString( fs, ptr, str, len );
+            if( !CV_NODE_IS_COLLECTION(flags) )
+                CV_PARSE_ERROR( "Invalid collection type" );
+            if( len > 0 )
+            {
+                if( len > CV_FS_MAX_LEN )
+                    CV_PARSE_ERROR( "Too long type name" );
+                memcpy( type_name, str, len );
+                type_name[len] = '\0';
+                elem->info = cvFindType( type_name );
+            }
+            icvFSCreateCollection( fs, CV_NODE_TYPE(flags) + (elem->info ? CV_NODE_USER : 0), elem );
+            if( keylen > 0 )
+                elem->tag |= CV_NODE_NAMED;
+            frame.is_simple = false;
+
+            CvBinaryParseFrame child = { elem, 0, 0, 0, true };
+            stack.push_back( child );
+            continue;
+            }
+        default:
+            CV_PARSE_ERROR( "Unknown record type" );
+        }
+
+        if( keylen > 0 )
+            elem->tag |= CV_NODE_NAMED;
+    }
+}
+
+
 /****************************************************************************************\
 *                              Common High-Level Functions                               *
 \****************************************************************************************/
@@ -2663,6 +3473,7 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
     bool append = (flags & 3) == CV_STORAGE_APPEND;
     bool mem = (flags & CV_STORAGE_MEMORY) != 0;
     bool write_mode = (flags & 3) != 0;
+    bool binary = write_mode && (flags & CV_STORAGE_FORMAT_MASK) == CV_STORAGE_FORMAT_BINARY;
     bool isGZ = false;
     size_t fnamelen = 0;
 
@@ -2678,6 +3489,9 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
     if( mem && append )
         CV_Error( CV_StsBadFlag, "CV_STORAGE_APPEND and CV_STORAGE_MEMORY are not currently compatible" );
 
+    if( binary && append )
+        CV_Error( CV_StsNotImplemented, "Appending data to binary file storage is not implemented" );
+
     fs = (CvFileStorage*)cvAlloc( sizeof(*fs) );
     memset( fs, 0, sizeof(*fs));
 
@@ -2708,7 +3522,7 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
 
         if( !isGZ )
         {
-            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : !append ? "wt" : "a+t" );
+            fs->file = fopen(fs->filename, !fs->write_mode ? "rt" : binary ? "wb" : !append ? "wt" : "a+t" );
             if( !fs->file )
                 goto _exit_;
         }
@@ -2724,6 +3538,24 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
             #endif
         }
     }
+    else if( write_mode && fnamelen > 0 )
+    {
+        // the name of the memory storage may request the compressed output, e.g. "data.yml.gz"
+        const char* dot_pos = strrchr(filename, '.');
+
+        if( dot_pos && dot_pos[1] == 'g' && dot_pos[2] == 'z' &&
+            (dot_pos[3] == '\0' || (cv_isdigit(dot_pos[3]) && dot_pos[4] == '\0')) )
+        {
+            #if USE_ZLIB
+            isGZ = true;
+            fs->zstream = icvCreateDeflateStream( dot_pos[3] ? dot_pos[3] - '0' : 3 );
+            if( dot_pos[3] )
+                fnamelen--;
+            #else
+            CV_Error(CV_StsNotImplemented, "There is no compressed file storage support in this configuration");
+            #endif
+        }
+    }
 
     fs->roots = 0;
     fs->struct_indent = 0;
@@ -2761,7 +3593,21 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
         fs->struct_flags = CV_NODE_EMPTY;
         fs->buffer_start = fs->buffer = (char*)cvAlloc( buf_size + 1024 );
         fs->buffer_end = fs->buffer_start + buf_size;
-        if( fs->fmt == CV_STORAGE_FORMAT_XML )
+        if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+        {
+            char header[CV_BIN_HEADER_SIZE] = CV_BIN_SIGNATURE;
+            int byte_order = CV_BIN_BYTE_ORDER;
+            memcpy( header + CV_BIN_HEADER_SIZE - sizeof(int), &byte_order, sizeof(int) );
+            icvBinaryPut( fs, header, sizeof(header) );
+            fs->start_write_struct = icvBinaryStartWriteStruct;
+            fs->end_write_struct = icvBinaryEndWriteStruct;
+            fs->write_int = icvBinaryWriteInt;
+            fs->write_real = icvBinaryWriteReal;
+            fs->write_string = icvBinaryWriteString;
+            fs->write_comment = icvBinaryWriteComment;
+            fs->start_next_stream = icvBinaryStartNextStream;
+        }
+        else if( fs->fmt == CV_STORAGE_FORMAT_XML )
         {
             size_t file_size = fs->file ? (size_t)ftell( fs->file ) : (size_t)0;
             fs->strstorage = cvCreateChildMemStorage( fs->memstorage );
@@ -2854,7 +3700,11 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
         char buf[16];
         icvGets( fs, buf, sizeof(buf)-2 );
         fs->fmt = strncmp( buf, yaml_signature, strlen(yaml_signature) ) == 0 ?
-            CV_STORAGE_FORMAT_YAML : CV_STORAGE_FORMAT_XML;
+            CV_STORAGE_FORMAT_YAML : strcmp( buf, CV_BIN_SIGNATURE ) == 0 ?
+            CV_STORAGE_FORMAT_BINARY : CV_STORAGE_FORMAT_XML;
+
+        if( fs->fmt == CV_STORAGE_FORMAT_BINARY && mem )
+            CV_Error( CV_StsNotImplemented, "Binary file storage can only be read from a file" );
 
         if( !isGZ )
         {
@@ -2876,6 +3726,28 @@ cvOpenFileStorage( const char* filename, CvMemStorage* dststorage, int flags, co
         fs->roots = cvCreateSeq( 0, sizeof(CvSeq),
                         sizeof(CvFileNode), fs->memstorage );
 
+        if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+        {
+            if( fs->file )
+            {
+                fs->mapping = icvMapFile( fs->file );
+                if( !fs->mapping )
+                {
+                    // could not map the file; read it instead, the text mode would corrupt the data
+                    fclose( fs->file );
+                    fs->file = fopen( fs->filename, "rb" );
+                }
+            }
+            if( !fs->mapping && (fs->file || fs->gzfile) )
+                fs->mapping = icvLoadFile( fs );
+            if( !fs->mapping )
+                CV_Error( CV_StsError, "Could not read the binary file storage" );
+
+            icvBinaryParse( fs );
+            fs->is_opened = true;
+            goto _exit_;
+        }
+
         fs->buffer = fs->buffer_start = (char*)cvAlloc( buf_size + 256 );
         fs->buffer_end = fs->buffer_start + buf_size;
         fs->buffer[0] = '\n';
@@ -2930,6 +3802,19 @@ cvEndWriteStruct( CvFileStorage* fs )
 {
     CV_CHECK_OUTPUT_FILE_STORAGE(fs);
     fs->end_write_struct( fs );
+
+    if( fs->sink && fs->write_stack->total == 0 )
+    {
+        // a top-level collection is complete; pass it to the sink
+        // together with its last line, which is still in the write buffer
+        if( fs->fmt != CV_STORAGE_FORMAT_BINARY )
+            icvFSFlush( fs );
+#if USE_ZLIB
+        if( fs->zstream )
+            icvDeflate( fs, 0, 0, Z_SYNC_FLUSH );
+#endif
+        icvFlushSink( fs );
+    }
 }
 
 
@@ -3101,6 +3986,13 @@ cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
     if( !data0 )
         CV_Error( CV_StsNullPtr, "Null data pointer" );
 
+    if( fs->fmt == CV_STORAGE_FORMAT_BINARY && fmt_pair_count == 1 &&
+        fmt_pairs[1] != CV_USRTYPE1 && (int64)fmt_pairs[0]*len <= INT_MAX )
+    {
+        icvBinaryWriteRawData( fs, data0, fmt_pairs[1], fmt_pairs[0]*len );
+        return;
+    }
+
     if( fmt_pair_count == 1 )
     {
         fmt_pairs[0] *= len;
@@ -3121,6 +4013,12 @@ cvWriteRawData( CvFileStorage* fs, const void* _data, int len, const char* dt )
 
             for( i = 0; i < count; i++ )
             {
+                if( fs->fmt == CV_STORAGE_FORMAT_BINARY )
+                {
+                    data = icvBinaryWriteScalar( fs, data, elem_type );
+                    continue;
+                }
+
                 switch( elem_type )
                 {
                 case CV_8U:
@@ -3195,7 +4093,10 @@ cvStartReadRawData( const CvFileStorage* fs, const CvFileNode* src, CvSeqReader*
     }
     else if( node_type == CV_NODE_SEQ )
     {
-        cvStartReadSeq( src->data.seq, reader, 0 );
+        if( icvIsLazyBlob(src->data.seq) )
+            icvStartReadBlob( (CvFileBlob*)src->data.seq, reader );
+        else
+            cvStartReadSeq( src->data.seq, reader, 0 );
     }
     else if( node_type == CV_NODE_NONE )
     {
@@ -3224,6 +4125,23 @@ cvReadRawDataSlice( const CvFileStorage* fs, CvSeqReader* reader,
 
     fmt_pair_count = icvDecodeFormat( dt, fmt_pairs, CV_FS_MAX_FMT_PAIRS );
 
+    bool blob = CV_IS_BLOB_READER(reader);
+    int blob_depth = blob ? ((CvFileBlob*)reader->seq)->blob_depth : 0;
+    int blob_elem_size = CV_ELEM_SIZE1(blob_depth);
+    CvFileNode blob_node;
+
+    if( blob && len > (reader->block_max - reader->ptr)/blob_elem_size )
+        CV_Error( CV_StsOutOfRange, "The sequence slice is out of the sequence" );
+
+    if( blob && fmt_pair_count == 1 && fmt_pairs[1] == blob_depth && len % fmt_pairs[0] == 0 )
+    {
+        // the stored array has the requested type, just copy it
+        size_t size = (size_t)len*blob_elem_size;
+        memcpy( data0, reader->ptr, size );
+        reader->ptr += size;
+        return;
+    }
+
     for(;;)
     {
         for( k = 0; k < fmt_pair_count; k++ )
@@ -3239,6 +4157,12 @@ cvReadRawDataSlice( const CvFileStorage* fs, CvSeqReader* reader,
             for( i = 0; i < count; i++ )
             {
                 CvFileNode* node = (CvFileNode*)reader->ptr;
+                if( blob )
+                {
+                    icvBlobElemToNode( (const uchar*)reader->ptr, blob_depth, 0, &blob_node );
+                    node = &blob_node;
+                }
+
                 if( CV_NODE_IS_INT(node->tag) )
                 {
                     int ival = node->data.i;
@@ -3336,7 +4260,10 @@ cvReadRawDataSlice( const CvFileStorage* fs, CvSeqReader* reader,
                     CV_Error( CV_StsError,
                     "The sequence element is not a numerical scalar" );
 
-                CV_NEXT_SEQ_ELEM( sizeof(CvFileNode), *reader );
+                if( blob )
+                    reader->ptr += blob_elem_size;
+                else
+                    CV_NEXT_SEQ_ELEM( sizeof(CvFileNode), *reader );
                 if( !--len )
                     goto end_loop;
             }
@@ -3381,6 +4308,14 @@ icvWriteCollection( CvFileStorage* fs, const CvFileNode* node )
     int is_map = CV_NODE_IS_MAP(node->tag);
     CvSeqReader reader;
 
+    if( CV_NODE_SEQ_IS_BLOB(node->data.seq) )
+    {
+        const CvFileBlob* blob = (const CvFileBlob*)node->data.seq;
+        char dt[16];
+        cvWriteRawData( fs, blob->blob_data, total, icvEncodeFormat( blob->blob_depth, dt ) );
+        return;
+    }
+
     cvStartReadSeq( node->data.seq, &reader, 0 );
 
     for( i = 0; i < total; i++ )
@@ -3546,7 +4481,7 @@ icvReadMat( CvFileStorage* fs, CvFileNode* node )
 
     elem_type = icvDecodeSimpleFormat( dt );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
@@ -3623,7 +4558,7 @@ icvReadMatND( CvFileStorage* fs, CvFileNode* node )
     int sizes[CV_MAX_DIM], dims, elem_type;
     int i, total_size;
 
-    sizes_node = cvGetFileNodeByName( fs, node, "sizes" );
+    sizes_node = icvGetFileNodeByName( fs, node, "sizes" );
     dt = cvReadStringByName( fs, node, "dt", 0 );
 
     if( !sizes_node || !dt )
@@ -3638,7 +4573,7 @@ icvReadMatND( CvFileStorage* fs, CvFileNode* node )
     cvReadRawData( fs, sizes_node, sizes, "i" );
     elem_type = icvDecodeSimpleFormat( dt );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The matrix data is not found in file storage" );
 
@@ -3927,7 +4862,7 @@ icvReadImage( CvFileStorage* fs, CvFileNode* node )
     if( strcmp( data_order, "interleaved" ) != 0 )
         CV_Error( CV_StsError, "Only interleaved images can be read" );
 
-    data = cvGetFileNodeByName( fs, node, "data" );
+    data = icvGetFileNodeByName( fs, node, "data" );
     if( !data )
         CV_Error( CV_StsError, "The image data is not found in file storage" );
 
@@ -5155,6 +6090,32 @@ bool FileStorage::open(const String& filename, int flags, const String& encoding
     return ok;
 }
 
+FileStorage::Sink::~Sink() {}
+
+static void icvWriteToSink( void* userdata, const char* data, size_t len )
+{
+    ((FileStorage::Sink*)userdata)->write( data, len );
+}
+
+bool FileStorage::open(const Ptr<Sink>& _sink, const String& name, int flags,
+                       size_t bufferSize, const String& encoding)
+{
+    release();
+    CV_Assert( !_sink.empty() && (flags & 3) == WRITE );
+    fs = Ptr<CvFileStorage>(cvOpenFileStorage( name.c_str(), 0, flags | MEMORY,
+                                               !encoding.empty() ? encoding.c_str() : 0));
+    bool ok = isOpened();
+    if( ok )
+    {
+        sink = _sink;
+        fs->sink = icvWriteToSink;
+        fs->sink_userdata = sink.obj;
+        fs->sink_limit = std::max(bufferSize, (size_t)1);
+    }
+    state = ok ? NAME_EXPECTED + INSIDE_MAP : UNDEFINED;
+    return ok;
+}
+
 bool FileStorage::isOpened() const
 {
     return !fs.empty() && fs.obj->is_opened;
@@ -5163,6 +6124,7 @@ bool FileStorage::isOpened() const
 void FileStorage::release()
 {
     fs.release();
+    sink.release();
     structs.clear();
     state = UNDEFINED;
 }
@@ -5262,26 +6224,28 @@ void FileStorage::writeObj( const String& name, const void* obj )
 
 FileNode FileStorage::operator[](const String& nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, 0, nodename.c_str()));
+    return FileNode(fs, icvGetFileNodeByName(fs, 0, nodename.c_str()));
 }
 
 FileNode FileStorage::operator[](const char* nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, 0, nodename));
+    return FileNode(fs, icvGetFileNodeByName(fs, 0, nodename));
 }
 
 FileNode FileNode::operator[](const String& nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, node, nodename.c_str()));
+    return FileNode(fs, icvGetFileNodeByName(fs, node, nodename.c_str()));
 }
 
 FileNode FileNode::operator[](const char* nodename) const
 {
-    return FileNode(fs, cvGetFileNodeByName(fs, node, nodename));
+    return FileNode(fs, icvGetFileNodeByName(fs, node, nodename));
 }
 
 FileNode FileNode::operator[](int i) const
 {
+    if( isSeq() )
+        icvFSExpandBlob( node );
     return isSeq() ? FileNode(fs, (CvFileNode*)cvGetSeqElem(node->data.seq, i)) :
         i == 0 ? *this : FileNode();
 }
@@ -5317,7 +6281,10 @@ FileNodeIterator::FileNodeIterator(const CvFileStorage* _fs,
         container = _node;
         if( !(_node->tag & FileNode::USER) && (node_type == FileNode::SEQ || node_type == FileNode::MAP) )
         {
-            cvStartReadSeq( _node->data.seq, (CvSeqReader*)&reader );
+            if( icvIsLazyBlob(_node->data.seq) )
+                icvStartReadBlob( (CvFileBlob*)_node->data.seq, (CvSeqReader*)&reader );
+            else
+                cvStartReadSeq( _node->data.seq, (CvSeqReader*)&reader );
             remaining = FileNode(_fs, _node).size();
         }
         else
@@ -5345,11 +6312,25 @@ FileNodeIterator::FileNodeIterator(const FileNodeIterator& it)
     remaining = it.remaining;
 }
 
+FileNode FileNodeIterator::blobElem() const
+{
+    if( CV_IS_BLOB_READER(&reader) )
+    {
+        // the element nodes of the blob are only created when they are accessed
+        int idx = (int)((reader.ptr - reader.block_min)/CV_ELEM_SIZE1(((CvFileBlob*)reader.seq)->blob_depth));
+        icvFSExpandBlob( container );
+        return FileNode(fs, (const CvFileNode*)cvGetSeqElem((CvSeq*)reader.seq, idx));
+    }
+    return FileNode(fs, (const CvFileNode*)reader.ptr);
+}
+
 FileNodeIterator& FileNodeIterator::operator ++()
 {
     if( remaining > 0 )
     {
-        if( reader.seq )
+        if( CV_IS_BLOB_READER(&reader) )
+            reader.ptr += CV_ELEM_SIZE1(((CvFileBlob*)reader.seq)->blob_depth);
+        else if( reader.seq )
         {
             if( ((reader).ptr += (((CvSeq*)reader.seq)->elem_size)) >= (reader).block_max )
             {
@@ -5372,7 +6353,9 @@ FileNodeIterator& FileNodeIterator::operator --()
 {
     if( remaining < FileNode(fs, container).size() )
     {
-        if( reader.seq )
+        if( CV_IS_BLOB_READER(&reader) )
+            reader.ptr -= CV_ELEM_SIZE1(((CvFileBlob*)reader.seq)->blob_depth);
+        else if( reader.seq )
         {
             if( ((reader).ptr -= (((CvSeq*)reader.seq)->elem_size)) < (reader).block_min )
             {
@@ -5403,7 +6386,9 @@ FileNodeIterator& FileNodeIterator::operator += (int ofs)
         ofs = (int)(remaining - std::min(remaining - ofs, count));
     }
     remaining -= ofs;
-    if( reader.seq )
+    if( CV_IS_BLOB_READER(&reader) )
+        reader.ptr += (ptrdiff_t)ofs*CV_ELEM_SIZE1(((CvFileBlob*)reader.seq)->blob_depth);
+    else if( reader.seq )
         cvSetSeqReaderPos( (CvSeqReader*)&reader, ofs, 1 );
     return *this;
 }
@@ -5498,6 +6483,96 @@ internal::WriteStructContext::~WriteStructContext()
 }
 
 
+/*
+   The allocator of the matrices referencing the memory of a binary file storage.
+   Mat::refcount points to the reference counter of the file mapping, so the mapping
+   is released when the storage and all such matrices are released. The matrices
+   reallocated by Mat::create() get their own heap block with the same layout.
+*/
+class FileMappingAllocator : public MatAllocator
+{
+public:
+    void allocate(int dims, const int* sizes, int type, int*& refcount,
+                  uchar*& datastart, uchar*& data, size_t* step)
+    {
+        size_t total = CV_ELEM_SIZE(type);
+        for( int i = dims-1; i >= 0; i-- )
+        {
+            step[i] = total;
+            total *= sizes[i];
+        }
+        CvFileMapping* mapping = icvCreateFileMapping( (uchar*)fastMalloc(total), total, false );
+        refcount = &mapping->refcount;
+        datastart = data = mapping->data;
+    }
+
+    void deallocate(int* refcount, uchar*, uchar*)
+    {
+        icvFreeFileMapping( (CvFileMapping*)refcount );
+    }
+};
+
+static FileMappingAllocator fileMappingAllocator;
+
+/* reads the matrix stored as a single raw array of a binary storage
+   without copying the data */
+static bool readMappedMat( const FileNode& node, Mat& mat )
+{
+    CvFileStorage* fs = (CvFileStorage*)node.fs;
+    const CvFileNode* mnode = node.node;
+    if( !fs->mapping || !CV_NODE_IS_USER(mnode->tag) || !mnode->info )
+        return false;
+
+    const char* type_name = mnode->info->type_name;
+    bool is_nd = strcmp( type_name, CV_TYPE_NAME_MATND ) == 0;
+    if( !is_nd && strcmp( type_name, CV_TYPE_NAME_MAT ) != 0 )
+        return false;
+
+    const CvFileNode* data = icvGetFileNodeByName( fs, mnode, "data" );
+    const char* dt = cvReadStringByName( fs, mnode, "dt", 0 );
+    if( !data || !dt || !CV_NODE_IS_SEQ(data->tag) || !CV_NODE_SEQ_IS_BLOB(data->data.seq) )
+        return false;
+
+    const CvFileBlob* blob = (const CvFileBlob*)data->data.seq;
+    int type = icvDecodeSimpleFormat( dt ), dims = 2, sizes[CV_MAX_DIM];
+    if( CV_MAT_DEPTH(type) != blob->blob_depth )
+        return false;
+
+    if( is_nd )
+    {
+        CvFileNode* sizes_node = icvGetFileNodeByName( fs, mnode, "sizes" );
+        dims = sizes_node ? icvFileNodeSeqLen( sizes_node ) : 0;
+        if( dims <= 0 || dims > CV_MAX_DIM )
+            return false;
+        cvReadRawData( fs, sizes_node, sizes, "i" );
+    }
+    else
+    {
+        sizes[0] = cvReadIntByName( fs, mnode, "rows", -1 );
+        sizes[1] = cvReadIntByName( fs, mnode, "cols", -1 );
+    }
+
+    int64 total = CV_MAT_CN(type);
+    for( int i = 0; i < dims; i++ )
+        total *= sizes[i];
+    if( total != blob->total )
+        return false;
+
+    Mat m(dims, sizes, type, (void*)blob->blob_data);
+    if( mat.data && mat.size == m.size && mat.type() == type )
+    {
+        // keep the semantics of reading into the preallocated matrix
+        m.copyTo(mat);
+        return true;
+    }
+
+    CV_XADD(&fs->mapping->refcount, 1);
+    m.refcount = &fs->mapping->refcount;
+    m.allocator = &fileMappingAllocator;
+    mat = m;
+    return true;
+}
+
 void read( const FileNode& node, Mat& mat, const Mat& default_mat )
 {
     if( node.empty() )
@@ -5505,6 +6580,8 @@ void read( const FileNode& node, Mat& mat, const Mat& default_mat )
         default_mat.copyTo(mat);
         return;
     }
+    if( readMappedMat(node, mat) )
+        return;
     void* obj = cvRead((CvFileStorage*)node.fs, (CvFileNode*)*node);
     if(CV_IS_MAT_HDR_Z(obj))
     {
@@ -105,9 +105,19 @@ extern const uchar g_Saturate8u[];
 
 #if defined WIN32 || defined _WIN32
 void deleteThreadAllocData();
+void deleteThreadPoolData();
+void deleteThreadScratchData();
 void deleteThreadRNGData();
 #endif
 
+#if defined HAVE_PTHREADS_PF
+// pthreads-based backend of parallel_for_ (parallel_pthreads.cpp)
+void parallel_for_pthreads(const Range& stripes, const ParallelLoopBody& body);
+int parallel_pthreads_get_threads_num();
+void parallel_pthreads_set_threads_num(int nthreads);
+int parallel_pthreads_get_thread_num();
+#endif
+
 template<typename T1, typename T2=T1, typename T3=T1> struct OpAdd
 {
     typedef T1 type1;
@@ -217,4 +227,6 @@ void convertAndUnrollScalar( const Mat& sc, int buftype, uchar* scbuf, size_t bl
 
 }
 
+#include "simd_dispatch.hpp"
+
 #endif /*_CXCORE_INTERNAL_H_*/
@@ -478,15 +478,29 @@ static RandnScaleFunc randnScaleTab[] =
     (RandnScaleFunc)randnScale_64f, 0
 };
 
-void RNG::fill( InputOutputArray _mat, int disttype,
-                InputArray _param1arg, InputArray _param2arg, bool saturateRange )
+// parameters of RNG::fill()/RNG_Philox::fill() converted to the per-channel
+// form expected by the low-level generators
+struct RandFillParams
 {
-    Mat mat = _mat.getMat(), _param1 = _param1arg.getMat(), _param2 = _param2arg.getMat();
-    int depth = mat.depth(), cn = mat.channels();
-    AutoBuffer<double> _parambuf;
-    int j, k, fast_int_mode = 0, smallFlag = 1;
-    RandFunc func = 0;
-    RandnScaleFunc scaleFunc = 0;
+    RandFillParams() : fastIntMode(0), smallFlag(1), ip(0), ds(0), fp(0), dp(0),
+        mean(0), stddev(0), stdmtx(false), scaleFunc(0) {}
+
+    int fastIntMode, smallFlag;
+    Vec2i* ip;
+    DivStruct* ds;
+    Vec2f* fp;
+    Vec2d* dp;
+    uchar* mean;
+    uchar* stddev;
+    bool stdmtx;
+    RandnScaleFunc scaleFunc;
+    AutoBuffer<double> buf;
+};
+
+static void initRandFillParams( RandFillParams& rp, int depth, int cn, int disttype,
+                                const Mat& _param1, const Mat& _param2, bool saturateRange )
+{
+    int j;
 
     CV_Assert(_param1.channels() == 1 && (_param1.rows == 1 || _param1.cols == 1) &&
               (_param1.rows + _param1.cols - 1 == cn || _param1.rows + _param1.cols - 1 == 1 ||
@@ -495,22 +509,15 @@ void RNG::fill( InputOutputArray _mat, int disttype,
                (((_param2.rows == 1 || _param2.cols == 1) &&
                 (_param2.rows + _param2.cols - 1 == cn || _param2.rows + _param2.cols - 1 == 1 ||
                 (_param1.size() == Size(1, 4) && _param1.type() == CV_64F && cn <= 4))) ||
-                (_param2.rows == cn && _param2.cols == cn && disttype == NORMAL)));
-
-    Vec2i* ip = 0;
-    Vec2d* dp = 0;
-    Vec2f* fp = 0;
-    DivStruct* ds = 0;
-    uchar* mean = 0;
-    uchar* stddev = 0;
-    bool stdmtx = false;
+                (_param2.rows == cn && _param2.cols == cn && disttype == RNG::NORMAL)));
+
     int n1 = (int)_param1.total();
     int n2 = (int)_param2.total();
 
-    if( disttype == UNIFORM )
+    if( disttype == RNG::UNIFORM )
     {
-        _parambuf.allocate(cn*8 + n1 + n2);
-        double* parambuf = _parambuf;
+        rp.buf.allocate(cn*8 + n1 + n2);
+        double* parambuf = rp.buf;
         double* p1 = (double*)_param1.data;
         double* p2 = (double*)_param2.data;
 
@@ -536,8 +543,9 @@ void RNG::fill( InputOutputArray _mat, int disttype,
 
         if( depth <= CV_32S )
         {
-            ip = (Vec2i*)(parambuf + cn*2);
-            for( j = 0, fast_int_mode = 1; j < cn; j++ )
+            Vec2i* ip = rp.ip = (Vec2i*)(parambuf + cn*2);
+            int fast_int_mode = 1, smallFlag = 1;
+            for( j = 0; j < cn; j++ )
             {
                 double a = std::min(p1[j], p2[j]);
                 double b = std::max(p1[j], p2[j]);
@@ -566,7 +574,7 @@ void RNG::fill( InputOutputArray _mat, int disttype,
 
             if( !fast_int_mode )
             {
-                ds = (DivStruct*)(ip + cn);
+                DivStruct* ds = rp.ds = (DivStruct*)(ip + cn);
                 for( j = 0; j < cn; j++ )
                 {
                     ds[j].delta = ip[j][1];
@@ -579,8 +587,8 @@ void RNG::fill( InputOutputArray _mat, int disttype,
                     ds[j].sh2 = std::max(l - 1, 0);
                 }
             }
-
-            func = randTab[fast_int_mode][depth];
+            rp.fastIntMode = fast_int_mode;
+            rp.smallFlag = smallFlag;
         }
         else
         {
@@ -595,7 +603,7 @@ void RNG::fill( InputOutputArray _mat, int disttype,
             // dparam[1][i]*X + dparam[0][i]
             if( depth == CV_32F )
             {
-                fp = (Vec2f*)(parambuf + cn*2);
+                Vec2f* fp = rp.fp = (Vec2f*)(parambuf + cn*2);
                 for( j = 0; j < cn; j++ )
                 {
                     fp[j][0] = (float)(std::min(maxdiff, p2[j] - p1[j])*scale);
@@ -604,63 +612,111 @@ void RNG::fill( InputOutputArray _mat, int disttype,
             }
             else
             {
-                dp = (Vec2d*)(parambuf + cn*2);
+                Vec2d* dp = rp.dp = (Vec2d*)(parambuf + cn*2);
                 for( j = 0; j < cn; j++ )
                 {
                     dp[j][0] = std::min(DBL_MAX, p2[j] - p1[j])*scale;
                     dp[j][1] = ((p2[j] + p1[j])*0.5);
                 }
             }
-
-            func = randTab[0][depth];
         }
-        CV_Assert( func != 0 );
     }
     else if( disttype == CV_RAND_NORMAL )
     {
-        _parambuf.allocate(MAX(n1, cn) + MAX(n2, cn));
-        double* parambuf = _parambuf;
+        rp.buf.allocate(MAX(n1, cn) + MAX(n2, cn));
+        double* parambuf = rp.buf;
 
         int ptype = depth == CV_64F ? CV_64F : CV_32F;
         int esz = (int)CV_ELEM_SIZE(ptype);
 
         if( _param1.isContinuous() && _param1.type() == ptype )
-            mean = _param1.data;
+            rp.mean = _param1.data;
         else
         {
             Mat tmp(_param1.size(), ptype, parambuf);
             _param1.convertTo(tmp, ptype);
-            mean = (uchar*)parambuf;
+            rp.mean = (uchar*)parambuf;
         }
 
         if( n1 < cn )
             for( j = n1*esz; j < cn*esz; j++ )
-                mean[j] = mean[j - n1*esz];
+                rp.mean[j] = rp.mean[j - n1*esz];
 
         if( _param2.isContinuous() && _param2.type() == ptype )
-            stddev = _param2.data;
+            rp.stddev = _param2.data;
         else
         {
             Mat tmp(_param2.size(), ptype, parambuf + cn);
             _param2.convertTo(tmp, ptype);
-            stddev = (uchar*)(parambuf + cn);
+            rp.stddev = (uchar*)(parambuf + cn);
         }
 
         if( n1 < cn )
             for( j = n1*esz; j < cn*esz; j++ )
-                stddev[j] = stddev[j - n1*esz];
+                rp.stddev[j] = rp.stddev[j - n1*esz];
 
-        stdmtx = _param2.rows == cn && _param2.cols == cn;
-        scaleFunc = randnScaleTab[depth];
-        CV_Assert( scaleFunc != 0 );
+        rp.stdmtx = _param2.rows == cn && _param2.cols == cn;
+        rp.scaleFunc = randnScaleTab[depth];
+        CV_Assert( rp.scaleFunc != 0 );
     }
     else
         CV_Error( CV_StsBadArg, "Unknown distribution type" );
+}
+
+// replicates the per-channel uniform distribution parameters
+// over a block of blockSize elements
+static void replicateRandParams( const RandFillParams& rp, uchar* param, int blockSize, int cn )
+{
+    int j, k;
+    if( rp.ds )
+    {
+        DivStruct* p = (DivStruct*)param;
+        for( j = 0; j < blockSize*cn; j += cn )
+            for( k = 0; k < cn; k++ )
+                p[j + k] = rp.ds[k];
+    }
+    else if( rp.ip )
+    {
+        Vec2i* p = (Vec2i*)param;
+        for( j = 0; j < blockSize*cn; j += cn )
+            for( k = 0; k < cn; k++ )
+                p[j + k] = rp.ip[k];
+    }
+    else if( rp.fp )
+    {
+        Vec2f* p = (Vec2f*)param;
+        for( j = 0; j < blockSize*cn; j += cn )
+            for( k = 0; k < cn; k++ )
+                p[j + k] = rp.fp[k];
+    }
+    else
+    {
+        Vec2d* p = (Vec2d*)param;
+        for( j = 0; j < blockSize*cn; j += cn )
+            for( k = 0; k < cn; k++ )
+                p[j + k] = rp.dp[k];
+    }
+}
+
+void RNG::fill( InputOutputArray _mat, int disttype,
+                InputArray _param1arg, InputArray _param2arg, bool saturateRange )
+{
+    Mat mat = _mat.getMat(), _param1 = _param1arg.getMat(), _param2 = _param2arg.getMat();
+    int depth = mat.depth(), cn = mat.channels();
+    RandFillParams rp;
+    RandFunc func = 0;
+
+    initRandFillParams(rp, depth, cn, disttype, _param1, _param2, saturateRange);
+    if( disttype == UNIFORM )
+    {
+        func = randTab[rp.fastIntMode][depth];
+        CV_Assert( func != 0 );
+    }
 
     const Mat* arrays[] = {&mat, 0};
     uchar* ptr;
     NAryMatIterator it(arrays, &ptr);
-    int total = (int)it.size, blockSize = std::min((BLOCK_SIZE + cn - 1)/cn, total);
+    int j, total = (int)it.size, blockSize = std::min((BLOCK_SIZE + cn - 1)/cn, total);
     size_t esz = mat.elemSize();
     AutoBuffer<double> buf;
     uchar* param = 0;
@@ -670,38 +726,7 @@ void RNG::fill( InputOutputArray _mat, int disttype,
     {
         buf.allocate(blockSize*cn*4);
         param = (uchar*)(double*)buf;
-
-        if( ip )
-        {
-            if( ds )
-            {
-                DivStruct* p = (DivStruct*)param;
-                for( j = 0; j < blockSize*cn; j += cn )
-                    for( k = 0; k < cn; k++ )
-                        p[j + k] = ds[k];
-            }
-            else
-            {
-                Vec2i* p = (Vec2i*)param;
-                for( j = 0; j < blockSize*cn; j += cn )
-                    for( k = 0; k < cn; k++ )
-                        p[j + k] = ip[k];
-            }
-        }
-        else if( fp )
-        {
-            Vec2f* p = (Vec2f*)param;
-            for( j = 0; j < blockSize*cn; j += cn )
-                for( k = 0; k < cn; k++ )
-                    p[j + k] = fp[k];
-        }
-        else
-        {
-            Vec2d* p = (Vec2d*)param;
-            for( j = 0; j < blockSize*cn; j += cn )
-                for( k = 0; k < cn; k++ )
-                    p[j + k] = dp[k];
-        }
+        replicateRandParams(rp, param, blockSize, cn);
     }
     else
     {
@@ -716,11 +741,11 @@ void RNG::fill( InputOutputArray _mat, int disttype,
             int len = std::min(total - j, blockSize);
 
             if( disttype == CV_RAND_UNI )
-                func( ptr, len*cn, &state, param, smallFlag != 0 );
+                func( ptr, len*cn, &state, param, rp.smallFlag != 0 );
             else
             {
                 randn_0_1_32f(nbuf, len*cn, &state);
-                scaleFunc(nbuf, ptr, len, cn, mean, stddev, stdmtx);
+                rp.scaleFunc(nbuf, ptr, len, cn, rp.mean, rp.stddev, rp.stdmtx);
             }
             ptr += len*esz;
         }
@@ -800,8 +825,8 @@ void cv::randn(InputOutputArray dst, InputArray mean, InputArray stddev)
 namespace cv
 {
 
-template<typename T> static void
-randShuffle_( Mat& _arr, RNG& rng, double iterFactor )
+template<typename T, class RNGType> static void
+randShuffle_( Mat& _arr, RNGType& rng, double iterFactor )
 {
     int sz = _arr.rows*_arr.cols, iters = cvRound(iterFactor*sz);
     if( _arr.isContinuous() )
@@ -828,41 +853,51 @@ randShuffle_( Mat& _arr, RNG& rng, double iterFactor )
     }
 }
 
-typedef void (*RandShuffleFunc)( Mat& dst, RNG& rng, double iterFactor );
-
-}
-
-void cv::randShuffle( InputOutputArray _dst, double iterFactor, RNG* _rng )
+template<class RNGType> static void
+randShuffleImpl( Mat& dst, RNGType& rng, double iterFactor )
 {
+    typedef void (*RandShuffleFunc)( Mat& dst, RNGType& rng, double iterFactor );
     RandShuffleFunc tab[] =
     {
         0,
-        randShuffle_<uchar>, // 1
-        randShuffle_<ushort>, // 2
-        randShuffle_<Vec<uchar,3> >, // 3
-        randShuffle_<int>, // 4
+        randShuffle_<uchar, RNGType>, // 1
+        randShuffle_<ushort, RNGType>, // 2
+        randShuffle_<Vec<uchar,3>, RNGType>, // 3
+        randShuffle_<int, RNGType>, // 4
         0,
-        randShuffle_<Vec<ushort,3> >, // 6
+        randShuffle_<Vec<ushort,3>, RNGType>, // 6
         0,
-        randShuffle_<Vec<int,2> >, // 8
+        randShuffle_<Vec<int,2>, RNGType>, // 8
         0, 0, 0,
-        randShuffle_<Vec<int,3> >, // 12
+        randShuffle_<Vec<int,3>, RNGType>, // 12
         0, 0, 0,
-        randShuffle_<Vec<int,4> >, // 16
+        randShuffle_<Vec<int,4>, RNGType>, // 16
         0, 0, 0, 0, 0, 0, 0,
-        randShuffle_<Vec<int,6> >, // 24
+        randShuffle_<Vec<int,6>, RNGType>, // 24
         0, 0, 0, 0, 0, 0, 0,
-        randShuffle_<Vec<int,8> > // 32
+        randShuffle_<Vec<int,8>, RNGType> // 32
     };
 
-    Mat dst = _dst.getMat();
-    RNG& rng = _rng ? *_rng : theRNG();
     CV_Assert( dst.elemSize() <= 32 );
     RandShuffleFunc func = tab[dst.elemSize()];
     CV_Assert( func != 0 );
     func( dst, rng, iterFactor );
 }
 
+}
+
+void cv::randShuffle( InputOutputArray _dst, double iterFactor, RNG* _rng )
+{
+    Mat dst = _dst.getMat();
+    randShuffleImpl( dst, _rng ? *_rng : theRNG(), iterFactor );
+}
+
+void cv::randShuffle( InputOutputArray _dst, double iterFactor, RNG_Philox& rng )
+{
+    Mat dst = _dst.getMat();
+    randShuffleImpl( dst, rng, iterFactor );
+}
+
 CV_IMPL void
 cvRandArr( CvRNG* _rng, CvArr* arr, int disttype, CvScalar param1, CvScalar param2 )
 {
@@ -1005,4 +1040,412 @@ unsigned cv::RNG_MT19937::operator ()(unsigned b) { return next() % b; }
 
 unsigned cv::RNG_MT19937::operator ()() { return next(); }
 
+/*
+   Philox4x32-10 counter-based generator, see
+   J. K. Salmon, M. A. Moraes, R. O. Dror, D. E. Shaw,
+   "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11.
+
+   The 32-bit output with index n of the stream s is the word (n & 3) of
+   the block Philox(counter = {n >> 2, s}, key = seed), so any part of the
+   sequence can be computed independently of the others.
+*/
+
+namespace cv
+{
+
+static const unsigned PHILOX_M0 = 0xD2511F53U, PHILOX_M1 = 0xCD9E8D57U;
+static const unsigned PHILOX_W0 = 0x9E3779B9U, PHILOX_W1 = 0xBB67AE85U;
+static const int PHILOX_ROUNDS = 10;
+
+static inline void philoxBlock( uint64 key, uint64 stream, uint64 blockIdx, unsigned* out )
+{
+    unsigned c0 = (unsigned)blockIdx, c1 = (unsigned)(blockIdx >> 32);
+    unsigned c2 = (unsigned)stream, c3 = (unsigned)(stream >> 32);
+    unsigned k0 = (unsigned)key, k1 = (unsigned)(key >> 32);
+
+    for( int r = 0; r < PHILOX_ROUNDS; r++ )
+    {
+        uint64 p0 = (uint64)c0*PHILOX_M0;
+        uint64 p1 = (uint64)c2*PHILOX_M1;
+        unsigned t0 = (unsigned)(p1 >> 32) ^ c1 ^ k0;
+        unsigned t2 = (unsigned)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (unsigned)p1; c3 = (unsigned)p0;
+        c0 = t0; c2 = t2;
+        k0 += PHILOX_W0; k1 += PHILOX_W1;
+    }
+
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+#if CV_SSE2
+static inline void philoxMulHiLo( __m128i a, __m128i m, __m128i& hi, __m128i& lo )
+{
+    __m128i p02 = _mm_mul_epu32(a, m);
+    __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    __m128i t0 = _mm_unpacklo_epi32(p02, p13);
+    __m128i t1 = _mm_unpackhi_epi32(p02, p13);
+    lo = _mm_unpacklo_epi64(t0, t1);
+    hi = _mm_unpackhi_epi64(t0, t1);
+}
+
+// computes 4 consecutive blocks (16 words) at once, one block per SIMD lane
+static void philoxBlock4_SSE2( uint64 key, uint64 stream, uint64 blockIdx, unsigned* out )
+{
+    unsigned lo = (unsigned)blockIdx;
+    __m128i c0 = _mm_add_epi32(_mm_set1_epi32((int)lo), _mm_setr_epi32(0, 1, 2, 3));
+    // carry into the high word of the counter, if the low one wraps around within the group
+    __m128i carry = _mm_setr_epi32(0, lo > 0xFFFFFFFEU, lo > 0xFFFFFFFDU, lo > 0xFFFFFFFCU);
+    __m128i c1 = _mm_add_epi32(_mm_set1_epi32((int)(blockIdx >> 32)), carry);
+    __m128i c2 = _mm_set1_epi32((int)(unsigned)stream);
+    __m128i c3 = _mm_set1_epi32((int)(unsigned)(stream >> 32));
+    __m128i m0 = _mm_set1_epi32((int)PHILOX_M0), m1 = _mm_set1_epi32((int)PHILOX_M1);
+    unsigned k0 = (unsigned)key, k1 = (unsigned)(key >> 32);
+
+    for( int r = 0; r < PHILOX_ROUNDS; r++ )
+    {
+        __m128i hi0, lo0, hi1, lo1;
+        philoxMulHiLo(c0, m0, hi0, lo0);
+        philoxMulHiLo(c2, m1, hi1, lo1);
+        c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+        c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+        c1 = lo1; c3 = lo0;
+        k0 += PHILOX_W0; k1 += PHILOX_W1;
+    }
+
+    // transpose lanes back to the block-major order
+    __m128i t0 = _mm_unpacklo_epi32(c0, c1), t1 = _mm_unpackhi_epi32(c0, c1);
+    __m128i t2 = _mm_unpacklo_epi32(c2, c3), t3 = _mm_unpackhi_epi32(c2, c3);
+    _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi64(t0, t2));
+    _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi64(t0, t2));
+    _mm_storeu_si128((__m128i*)(out + 8), _mm_unpacklo_epi64(t1, t3));
+    _mm_storeu_si128((__m128i*)(out + 12), _mm_unpackhi_epi64(t1, t3));
+}
+#endif
+
+// generates the words [wordIdx, wordIdx + len) of the stream; wordIdx must be a multiple of 4
+static void philoxWords( uint64 key, uint64 stream, uint64 wordIdx, unsigned* arr, int len )
+{
+    uint64 blockIdx = wordIdx >> 2;
+    int i = 0;
+
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        for( ; i <= len - 16; i += 16, blockIdx += 4 )
+            philoxBlock4_SSE2(key, stream, blockIdx, arr + i);
+    }
+#endif
+
+    for( ; i <= len - 4; i += 4, blockIdx++ )
+        philoxBlock(key, stream, blockIdx, arr + i);
+
+    if( i < len )
+    {
+        unsigned tail[4];
+        philoxBlock(key, stream, blockIdx, tail);
+        for( int k = 0; i < len; i++, k++ )
+            arr[i] = tail[k];
+    }
+}
+
+// converts the random words to the values of the requested distribution;
+// the mapping follows randBits_, randi_ and randf_* with the MWC state replaced by the words
+
+template<typename T> static void
+philoxBits_( const unsigned* w, T* arr, int len, const Vec2i* p )
+{
+    for( int i = 0; i < len; i++ )
+        arr[i] = saturate_cast<T>(((int)w[i] & p[i][0]) + p[i][1]);
+}
+
+template<typename T> static void
+philoxDiv_( const unsigned* w, T* arr, int len, const DivStruct* p )
+{
+    for( int i = 0; i < len; i++ )
+    {
+        unsigned t0 = w[i];
+        unsigned v0 = (unsigned)(((uint64)t0 * p[i].M) >> 32);
+        v0 = (v0 + ((t0 - v0) >> p[i].sh1)) >> p[i].sh2;
+        v0 = t0 - v0*p[i].d + p[i].delta;
+        arr[i] = saturate_cast<T>((int)v0);
+    }
+}
+
+#define DEF_PHILOX_FUNC(suffix, type) \
+static void philoxBits_##suffix(const unsigned* w, type* arr, int len, const Vec2i* p) \
+{ philoxBits_(w, arr, len, p); } \
+\
+static void philoxDiv_##suffix(const unsigned* w, type* arr, int len, const DivStruct* p) \
+{ philoxDiv_(w, arr, len, p); }
+
+DEF_PHILOX_FUNC(8u, uchar)
+DEF_PHILOX_FUNC(8s, schar)
+DEF_PHILOX_FUNC(16u, ushort)
+DEF_PHILOX_FUNC(16s, short)
+DEF_PHILOX_FUNC(32s, int)
+
+static void philox_32f( const unsigned* w, float* arr, int len, const Vec2f* p )
+{
+    int i = 0;
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        for( ; i <= len - 4; i += 4 )
+        {
+            __m128 q0 = _mm_loadu_ps((const float*)(p + i));
+            __m128 q1 = _mm_loadu_ps((const float*)(p + i + 2));
+            __m128 q01l = _mm_unpacklo_ps(q0, q1);
+            __m128 q01h = _mm_unpackhi_ps(q0, q1);
+            __m128 p0 = _mm_unpacklo_ps(q01l, q01h);
+            __m128 p1 = _mm_unpackhi_ps(q01l, q01h);
+            __m128 f = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(w + i)));
+            _mm_storeu_ps(arr + i, _mm_add_ps(_mm_mul_ps(f, p0), p1));
+        }
+    }
+#endif
+    for( ; i < len; i++ )
+    {
+        arr[i] = (float)(int)w[i]*p[i][0] + p[i][1];
+    }
+}
+
+static void philox_64f( const unsigned* w, double* arr, int len, const Vec2d* p )
+{
+    for( int i = 0; i < len; i++ )
+    {
+        int64 v = (int64)(((uint64)w[i*2] << 32) | w[i*2+1]);
+        arr[i] = v*p[i][0] + p[i][1];
+    }
+}
+
+typedef void (*PhiloxFunc)(const unsigned* w, uchar* arr, int len, const void* p);
+
+static PhiloxFunc philoxTab[][8] =
+{
+    {
+        (PhiloxFunc)philoxDiv_8u, (PhiloxFunc)philoxDiv_8s, (PhiloxFunc)philoxDiv_16u,
+        (PhiloxFunc)philoxDiv_16s, (PhiloxFunc)philoxDiv_32s, (PhiloxFunc)philox_32f,
+        (PhiloxFunc)philox_64f, 0
+    },
+    {
+        (PhiloxFunc)philoxBits_8u, (PhiloxFunc)philoxBits_8s, (PhiloxFunc)philoxBits_16u,
+        (PhiloxFunc)philoxBits_16s, (PhiloxFunc)philoxBits_32s, 0, 0, 0
+    }
+};
+
+/*
+   Box-Muller transform: unlike the Ziggurat method used by RNG it consumes
+   exactly one word per value, which keeps the stream position of every
+   value known in advance. len must be even.
+*/
+static void philoxNormal_32f( const unsigned* w, float* arr, int len )
+{
+    const float scale = 5.9604644775390625e-8f; // 2^-24
+    const float twoPi = (float)(CV_PI*2);
+    for( int i = 0; i < len; i += 2 )
+    {
+        float u1 = (float)((w[i] >> 8) + 1)*scale; // (0, 1]
+        float u2 = (float)(w[i+1] >> 8)*scale;     // [0, 1)
+        float r = std::sqrt(-2.f*std::log(u1));
+        float a = u2*twoPi;
+        arr[i] = r*std::cos(a);
+        arr[i+1] = r*std::sin(a);
+    }
+}
+
+class PhiloxFillInvoker : public ParallelLoopBody
+{
+public:
+    PhiloxFillInvoker( const RandFillParams& _rp, PhiloxFunc _func, int _disttype,
+                       const std::vector<uchar*>& _planes, int _planeSize, int _cn, size_t _esz,
+                       int _blockSize, int64 _total, uint64 _key, uint64 _stream, uint64 _word0 ) :
+        rp(&_rp), func(_func), disttype(_disttype), planes(&_planes), planeSize(_planeSize),
+        cn(_cn), esz(_esz), blockSize(_blockSize), total(_total),
+        key(_key), stream(_stream), word0(_word0)
+    {
+        wordsPerValue = func == (PhiloxFunc)philox_64f ? 2 : 1;
+    }
+
+    void operator()( const Range& range ) const
+    {
+        int wlen = blockSize*cn*wordsPerValue;
+        AutoBuffer<unsigned> _words(wlen);
+        AutoBuffer<double> _buf(disttype == RNG::UNIFORM ? blockSize*cn*4 : (blockSize*cn+1)/2);
+        unsigned* words = _words;
+        uchar* param = (uchar*)(double*)_buf;
+        float* nbuf = (float*)(double*)_buf;
+
+        if( disttype == RNG::UNIFORM )
+            replicateRandParams(*rp, param, blockSize, cn);
+
+        for( int b = range.start; b < range.end; b++ )
+        {
+            int64 e0 = (int64)b*blockSize;
+            int len = (int)std::min((int64)blockSize, total - e0), n = len*cn;
+
+            // blockSize is a multiple of 4, so every block starts at the Philox block boundary
+            if( disttype == RNG::UNIFORM )
+                philoxWords(key, stream, word0 + (uint64)e0*cn*wordsPerValue, words, n*wordsPerValue);
+            else
+            {
+                int n2 = (n + 1) & -2;
+                philoxWords(key, stream, word0 + (uint64)e0*cn, words, n2);
+                philoxNormal_32f(words, nbuf, n2);
+            }
+
+            // a block may span several planes of a non-continuous array
+            for( int ofs = 0; ofs < len; )
+            {
+                int64 e = e0 + ofs;
+                int plane = (int)(e / planeSize), pe = (int)(e - (int64)plane*planeSize);
+                int l = std::min(planeSize - pe, len - ofs);
+                uchar* ptr = (*planes)[plane] + pe*esz;
+
+                if( disttype == RNG::UNIFORM )
+                    func(words + ofs*cn*wordsPerValue, ptr, l*cn, param);
+                else
+                    rp->scaleFunc(nbuf + ofs*cn, ptr, l, cn, rp->mean, rp->stddev, rp->stdmtx);
+                ofs += l;
+            }
+        }
+    }
+
+private:
+    const RandFillParams* rp;
+    PhiloxFunc func;
+    int disttype;
+    const std::vector<uchar*>* planes;
+    int planeSize, cn;
+    size_t esz;
+    int blockSize;
+    int64 total;
+    uint64 key, stream, word0;
+    int wordsPerValue;
+};
+
+}
+
+cv::RNG_Philox::RNG_Philox() { seed(0); }
+
+cv::RNG_Philox::RNG_Philox(uint64 s, uint64 _stream) { seed(s, _stream); }
+
+void cv::RNG_Philox::seed(uint64 s, uint64 _stream)
+{
+    key = s;
+    stream = _stream;
+    counter = 0;
+}
+
+void cv::RNG_Philox::skip(uint64 n)
+{
+    setCounter(counter + n);
+}
+
+void cv::RNG_Philox::setCounter(uint64 _counter)
+{
+    counter = _counter;
+    if( counter & 3 )
+        philoxBlock(key, stream, counter >> 2, buf);
+}
+
+uint64 cv::RNG_Philox::getCounter() const
+{
+    return counter;
+}
+
+cv::RNG_Philox cv::RNG_Philox::split(uint64 _stream) const
+{
+    return RNG_Philox(key, _stream);
+}
+
+unsigned cv::RNG_Philox::next()
+{
+    if( (counter & 3) == 0 )
+        philoxBlock(key, stream, counter >> 2, buf);
+    return buf[counter++ & 3];
+}
+
+cv::RNG_Philox::operator unsigned() { return next(); }
+
+cv::RNG_Philox::operator int() { return (int)next(); }
+
+cv::RNG_Philox::operator float() { return next()*2.3283064365386962890625e-10f; }
+
+cv::RNG_Philox::operator double()
+{
+    unsigned t = next();
+    return (((uint64)t << 32) | next()) * 5.4210108624275221700372640043497e-20;
+}
+
+unsigned cv::RNG_Philox::operator ()(unsigned N) { return (unsigned)uniform(0, (int)N); }
+
+unsigned cv::RNG_Philox::operator ()() { return next(); }
+
+int cv::RNG_Philox::uniform(int a, int b) { return a == b ? a : (int)(next() % (b - a) + a); }
+
+float cv::RNG_Philox::uniform(float a, float b) { return ((float)*this)*(b - a) + a; }
+
+double cv::RNG_Philox::uniform(double a, double b) { return ((double)*this)*(b - a) + a; }
+
+double cv::RNG_Philox::gaussian(double sigma)
+{
+    unsigned w[2];
+    float v[2];
+    w[0] = next();
+    w[1] = next();
+    cv::philoxNormal_32f(w, v, 2);
+    return v[0]*sigma;
+}
+
+void cv::RNG_Philox::fill( InputOutputArray _mat, int disttype,
+                           InputArray _param1arg, InputArray _param2arg, bool saturateRange )
+{
+    Mat mat = _mat.getMat(), _param1 = _param1arg.getMat(), _param2 = _param2arg.getMat();
+    int depth = mat.depth(), cn = mat.channels();
+    RandFillParams rp;
+    PhiloxFunc func = 0;
+
+    initRandFillParams(rp, depth, cn, disttype, _param1, _param2, saturateRange);
+    if( disttype == RNG::UNIFORM )
+    {
+        func = philoxTab[rp.fastIntMode][depth];
+        CV_Assert( func != 0 );
+    }
+
+    const Mat* arrays[] = {&mat, 0};
+    uchar* ptr;
+    NAryMatIterator it(arrays, &ptr);
+    std::vector<uchar*> planes(it.nplanes);
+    for( size_t i = 0; i < it.nplanes; i++, ++it )
+        planes[i] = ptr;
+
+    int planeSize = (int)it.size;
+    int64 total = (int64)planeSize*(int64)it.nplanes;
+    if( total == 0 )
+        return;
+
+    // the values are generated in blocks of a fixed size, so the stream position
+    // of each value (and hence the result) does not depend on the number of threads
+    int blockSize = (((BLOCK_SIZE + cn - 1)/cn) + 3) & -4;
+    int nblocks = (int)((total + blockSize - 1)/blockSize);
+    int wordsPerValue = depth == CV_64F && disttype == RNG::UNIFORM ? 2 : 1;
+    uint64 word0 = (counter + 3) & ~(uint64)3;
+
+    parallel_for_(Range(0, nblocks),
+                  PhiloxFillInvoker(rp, func, disttype, planes, planeSize, cn, mat.elemSize(),
+                                    blockSize, total, key, stream, word0));
+
+    counter = word0 + (((uint64)total*cn*wordsPerValue + 3) & ~(uint64)3);
+}
+
+void cv::randu(InputOutputArray dst, InputArray low, InputArray high, RNG_Philox& rng)
+{
+    rng.fill(dst, RNG::UNIFORM, low, high);
+}
+
+void cv::randn(InputOutputArray dst, InputArray mean, InputArray stddev, RNG_Philox& rng)
+{
+    rng.fill(dst, RNG::NORMAL, mean, stddev);
+}
+
 /* End of file. */
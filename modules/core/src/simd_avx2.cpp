@@ -0,0 +1,753 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+/* ////////////////////////////////////////////////////////////////////
+//
+//  AVX2 variants of the core kernels, see simd_dispatch.hpp
+//
+// */
+
+// Not precomp.hpp: it pulls in Eigen, TBB, IPP and a lot of inline code that must not
+// be compiled with the flags of this file. The file is also kept out of the
+// precompiled header (see modules/core/CMakeLists.txt).
+#include "cvconfig.h"
+#include "opencv2/core.hpp"
+#include "simd_dispatch.hpp"
+
+#ifdef HAVE_AVX2_DISPATCH
+
+#include <immintrin.h>
+
+/*
+   This file is compiled with -mavx2 (/arch:AVX2), so it must not instantiate any
+   inline function or template shared with the other translation units (saturate_cast,
+   cvRound, std::min ...): the linker could pick the AVX2 copy for the whole library.
+   Everything used here is either an intrinsic or defined in the namespace of this file.
+*/
+
+namespace cv
+{
+namespace opt_AVX2
+{
+
+static inline int clip(int v, int lo, int hi) { return v < lo ? lo : v > hi ? hi : v; }
+static inline int round32f(float v) { return _mm_cvtss_si32(_mm_set_ss(v)); }
+static inline float abs32f(float v) { return v < 0 ? -v : v; }
+
+#define CV_ROW_PTR(type, ptr, step) ((type*)((uchar*)(ptr) + (step)))
+
+/////////////////////////////////// add, sub, absdiff ///////////////////////////////////
+
+struct VAdd8u
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_adds_epu8(a, b); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)clip(a + b, 0, 255); }
+};
+struct VSub8u
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_subs_epu8(a, b); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)clip(a - b, 0, 255); }
+};
+struct VAbsDiff8u
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    { return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a)); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)(a > b ? a - b : b - a); }
+};
+
+struct VAdd16u
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_adds_epu16(a, b); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)clip(a + b, 0, 65535); }
+};
+struct VSub16u
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_subs_epu16(a, b); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)clip(a - b, 0, 65535); }
+};
+struct VAbsDiff16u
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    { return _mm256_or_si256(_mm256_subs_epu16(a, b), _mm256_subs_epu16(b, a)); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)(a > b ? a - b : b - a); }
+};
+
+struct VAdd16s
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_adds_epi16(a, b); }
+    short operator()(short a, short b) const { return (short)clip(a + b, -32768, 32767); }
+};
+struct VSub16s
+{
+    __m256i operator()(__m256i a, __m256i b) const { return _mm256_subs_epi16(a, b); }
+    short operator()(short a, short b) const { return (short)clip(a - b, -32768, 32767); }
+};
+struct VAbsDiff16s
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    { return _mm256_subs_epi16(_mm256_max_epi16(a, b), _mm256_min_epi16(a, b)); }
+    short operator()(short a, short b) const { return (short)clip(a > b ? a - b : b - a, 0, 32767); }
+};
+
+struct VAdd32f
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    { return _mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b))); }
+    float operator()(float a, float b) const { return a + b; }
+};
+struct VSub32f
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    { return _mm256_castps_si256(_mm256_sub_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b))); }
+    float operator()(float a, float b) const { return a - b; }
+};
+struct VAbsDiff32f
+{
+    __m256i operator()(__m256i a, __m256i b) const
+    {
+        __m256 d = _mm256_sub_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b));
+        return _mm256_and_si256(_mm256_castps_si256(d), _mm256_set1_epi32(0x7fffffff));
+    }
+    float operator()(float a, float b) const { return abs32f(a - b); }
+};
+
+template<typename T, class Op> static void
+binOp(const T* src1, size_t step1, const T* src2, size_t step2, T* dst, size_t step, Size sz)
+{
+    const int VECSZ = (int)(sizeof(__m256i)/sizeof(T));
+    Op op;
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const T, src1, step1),
+                        src2 = CV_ROW_PTR(const T, src2, step2),
+                        dst = CV_ROW_PTR(T, dst, step) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - VECSZ*2; x += VECSZ*2 )
+        {
+            __m256i r0 = _mm256_loadu_si256((const __m256i*)(src1 + x));
+            __m256i r1 = _mm256_loadu_si256((const __m256i*)(src1 + x + VECSZ));
+            r0 = op(r0, _mm256_loadu_si256((const __m256i*)(src2 + x)));
+            r1 = op(r1, _mm256_loadu_si256((const __m256i*)(src2 + x + VECSZ)));
+            _mm256_storeu_si256((__m256i*)(dst + x), r0);
+            _mm256_storeu_si256((__m256i*)(dst + x + VECSZ), r1);
+        }
+        for( ; x <= sz.width - VECSZ; x += VECSZ )
+        {
+            __m256i r0 = _mm256_loadu_si256((const __m256i*)(src1 + x));
+            r0 = op(r0, _mm256_loadu_si256((const __m256i*)(src2 + x)));
+            _mm256_storeu_si256((__m256i*)(dst + x), r0);
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = op(src1[x], src2[x]);
+    }
+}
+
+#define DEF_BIN_FUNC(name, type, op) \
+static void name( const type* src1, size_t step1, const type* src2, size_t step2, \
+                  type* dst, size_t step, Size sz ) \
+{ \
+    binOp<type, op>(src1, step1, src2, step2, dst, step, sz); \
+}
+
+DEF_BIN_FUNC(add8u, uchar, VAdd8u)
+DEF_BIN_FUNC(sub8u, uchar, VSub8u)
+DEF_BIN_FUNC(absdiff8u, uchar, VAbsDiff8u)
+DEF_BIN_FUNC(add16u, ushort, VAdd16u)
+DEF_BIN_FUNC(sub16u, ushort, VSub16u)
+DEF_BIN_FUNC(absdiff16u, ushort, VAbsDiff16u)
+DEF_BIN_FUNC(add16s, short, VAdd16s)
+DEF_BIN_FUNC(sub16s, short, VSub16s)
+DEF_BIN_FUNC(absdiff16s, short, VAbsDiff16s)
+DEF_BIN_FUNC(add32f, float, VAdd32f)
+DEF_BIN_FUNC(sub32f, float, VSub32f)
+DEF_BIN_FUNC(absdiff32f, float, VAbsDiff32f)
+
+/////////////////////////////////////// compare ////////////////////////////////////////
+
+// CMP_GE and CMP_LT are turned into CMP_LE and CMP_GT by swapping the operands,
+// then every operation is either "greater" or "equal", optionally inverted
+template<typename T> static bool
+normalizeCmp(const T*& src1, size_t& step1, const T*& src2, size_t& step2, int& code)
+{
+    if( code == CMP_GE || code == CMP_LT )
+    {
+        const T* t = src1; src1 = src2; src2 = t;
+        size_t s = step1; step1 = step2; step2 = s;
+        code = code == CMP_GE ? CMP_LE : CMP_GT;
+    }
+    return code == CMP_GT || code == CMP_LE;
+}
+
+static void cmp8u( const uchar* src1, size_t step1, const uchar* src2, size_t step2,
+                   uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m256i vm = _mm256_set1_epi8((char)m), sign = _mm256_set1_epi8((char)-128);
+
+    for( ; sz.height--; src1 += step1, src2 += step2, dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 32; x += 32 )
+        {
+            __m256i a = _mm256_loadu_si256((const __m256i*)(src1 + x));
+            __m256i b = _mm256_loadu_si256((const __m256i*)(src2 + x));
+            __m256i r = gt ? _mm256_cmpgt_epi8(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign)) :
+                             _mm256_cmpeq_epi8(a, b);
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm256_xor_si256(r, vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+static void cmp16s( const short* src1, size_t step1, const short* src2, size_t step2,
+                    uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m256i vm = _mm256_set1_epi8((char)m);
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const short, src1, step1),
+                        src2 = CV_ROW_PTR(const short, src2, step2), dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 32; x += 32 )
+        {
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)(src1 + x));
+            __m256i a1 = _mm256_loadu_si256((const __m256i*)(src1 + x + 16));
+            __m256i b0 = _mm256_loadu_si256((const __m256i*)(src2 + x));
+            __m256i b1 = _mm256_loadu_si256((const __m256i*)(src2 + x + 16));
+            __m256i r0 = gt ? _mm256_cmpgt_epi16(a0, b0) : _mm256_cmpeq_epi16(a0, b0);
+            __m256i r1 = gt ? _mm256_cmpgt_epi16(a1, b1) : _mm256_cmpeq_epi16(a1, b1);
+            // packs works within the 128-bit lanes, restore the order of the 64-bit blocks
+            __m256i r = _mm256_permute4x64_epi64(_mm256_packs_epi16(r0, r1), 0xD8);
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm256_xor_si256(r, vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+static inline __m256i pack32to8(__m256i r0, __m256i r1, __m256i r2, __m256i r3, bool sat_unsigned)
+{
+    __m256i r01 = _mm256_packs_epi32(r0, r1), r23 = _mm256_packs_epi32(r2, r3);
+    __m256i r = sat_unsigned ? _mm256_packus_epi16(r01, r23) : _mm256_packs_epi16(r01, r23);
+    // each of the packs interleaves the 128-bit lanes, restore the order of the 32-bit blocks
+    return _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+static void cmp32f( const float* src1, size_t step1, const float* src2, size_t step2,
+                    uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m256i vm = _mm256_set1_epi8((char)m);
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const float, src1, step1),
+                        src2 = CV_ROW_PTR(const float, src2, step2), dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 32; x += 32 )
+        {
+            __m256i r[4];
+            for( int k = 0; k < 4; k++ )
+            {
+                __m256 a = _mm256_loadu_ps(src1 + x + k*8), b = _mm256_loadu_ps(src2 + x + k*8);
+                r[k] = _mm256_castps_si256(gt ? _mm256_cmp_ps(a, b, _CMP_GT_OQ) : _mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+            }
+            __m256i v = pack32to8(r[0], r[1], r[2], r[3], false);
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm256_xor_si256(v, vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+/////////////////////////////////////// convertTo ///////////////////////////////////////
+
+static void cvt8u32f( const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src += sstep, dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            _mm256_storeu_ps(dst + x, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v)));
+            _mm256_storeu_ps(dst + x + 8, _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8))));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static void cvt16u32f( const ushort* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const ushort, src, sstep), dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(src + x + 8));
+            _mm256_storeu_ps(dst + x, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v0)));
+            _mm256_storeu_ps(dst + x + 8, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(v1)));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static void cvt16s32f( const short* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const short, src, sstep), dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(src + x + 8));
+            _mm256_storeu_ps(dst + x, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v0)));
+            _mm256_storeu_ps(dst + x + 8, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(v1)));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static void cvt32f8u( const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst += dstep )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 32; x += 32 )
+        {
+            __m256i r0 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x));
+            __m256i r1 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x + 8));
+            __m256i r2 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x + 16));
+            __m256i r3 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x + 24));
+            _mm256_storeu_si256((__m256i*)(dst + x), pack32to8(r0, r1, r2, r3, true));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)clip(round32f(src[x]), 0, 255);
+    }
+}
+
+static void cvt32f16u( const float* src, size_t sstep, ushort* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst = CV_ROW_PTR(ushort, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m256i r0 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x));
+            __m256i r1 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x + 8));
+            __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi32(r0, r1), 0xD8);
+            _mm256_storeu_si256((__m256i*)(dst + x), r);
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (ushort)clip(round32f(src[x]), 0, 65535);
+    }
+}
+
+static void cvt32f16s( const float* src, size_t sstep, short* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst = CV_ROW_PTR(short, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m256i r0 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x));
+            __m256i r1 = _mm256_cvtps_epi32(_mm256_loadu_ps(src + x + 8));
+            __m256i r = _mm256_permute4x64_epi64(_mm256_packs_epi32(r0, r1), 0xD8);
+            _mm256_storeu_si256((__m256i*)(dst + x), r);
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (short)clip(round32f(src[x]), -32768, 32767);
+    }
+}
+
+static void cvtScale8u32f( const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz,
+                           float scale, float shift )
+{
+    __m256 vscale = _mm256_set1_ps(scale), vshift = _mm256_set1_ps(shift);
+
+    for( ; sz.height--; src += sstep, dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            __m256 f0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+            __m256 f1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+            _mm256_storeu_ps(dst + x, _mm256_add_ps(_mm256_mul_ps(f0, vscale), vshift));
+            _mm256_storeu_ps(dst + x + 8, _mm256_add_ps(_mm256_mul_ps(f1, vscale), vshift));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = src[x]*scale + shift;
+    }
+}
+
+static void cvtScale32f8u( const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz,
+                           float scale, float shift )
+{
+    __m256 vscale = _mm256_set1_ps(scale), vshift = _mm256_set1_ps(shift);
+
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst += dstep )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 32; x += 32 )
+        {
+            __m256i r[4];
+            for( int k = 0; k < 4; k++ )
+            {
+                __m256 f = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(src + x + k*8), vscale), vshift);
+                r[k] = _mm256_cvtps_epi32(f);
+            }
+            _mm256_storeu_si256((__m256i*)(dst + x), pack32to8(r[0], r[1], r[2], r[3], true));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)clip(round32f(src[x]*scale + shift), 0, 255);
+    }
+}
+
+///////////////////////////////////// math functions ////////////////////////////////////
+
+static int magnitude32f( const float* x, const float* y, float* mag, int len )
+{
+    int i = 0;
+    for( ; i <= len - 16; i += 16 )
+    {
+        __m256 x0 = _mm256_loadu_ps(x + i), x1 = _mm256_loadu_ps(x + i + 8);
+        __m256 y0 = _mm256_loadu_ps(y + i), y1 = _mm256_loadu_ps(y + i + 8);
+        x0 = _mm256_add_ps(_mm256_mul_ps(x0, x0), _mm256_mul_ps(y0, y0));
+        x1 = _mm256_add_ps(_mm256_mul_ps(x1, x1), _mm256_mul_ps(y1, y1));
+        _mm256_storeu_ps(mag + i, _mm256_sqrt_ps(x0));
+        _mm256_storeu_ps(mag + i + 8, _mm256_sqrt_ps(x1));
+    }
+    return i;
+}
+
+// the same polynomial as in fastAtan2() (mathfuncs.cpp)
+static const float atan2_p1 = 0.9997878412794807f*(float)(180/CV_PI);
+static const float atan2_p3 = -0.3258083974640975f*(float)(180/CV_PI);
+static const float atan2_p5 = 0.1555786518463281f*(float)(180/CV_PI);
+static const float atan2_p7 = -0.04432655554792128f*(float)(180/CV_PI);
+
+static int fastAtan2_32f( const float* Y, const float* X, float* angle, int len, bool angleInDegrees )
+{
+    int i = 0;
+    float scale = angleInDegrees ? 1 : (float)(CV_PI/180);
+    __m256 eps = _mm256_set1_ps((float)DBL_EPSILON);
+    __m256 absmask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 _90 = _mm256_set1_ps(90.f), _180 = _mm256_set1_ps(180.f), _360 = _mm256_set1_ps(360.f);
+    __m256 z = _mm256_setzero_ps(), scale8 = _mm256_set1_ps(scale);
+    __m256 p1 = _mm256_set1_ps(atan2_p1), p3 = _mm256_set1_ps(atan2_p3);
+    __m256 p5 = _mm256_set1_ps(atan2_p5), p7 = _mm256_set1_ps(atan2_p7);
+
+    for( ; i <= len - 8; i += 8 )
+    {
+        __m256 x = _mm256_loadu_ps(X + i), y = _mm256_loadu_ps(Y + i);
+        __m256 ax = _mm256_and_ps(x, absmask), ay = _mm256_and_ps(y, absmask);
+        __m256 mask = _mm256_cmp_ps(ax, ay, _CMP_LT_OQ);
+        __m256 tmin = _mm256_min_ps(ax, ay), tmax = _mm256_max_ps(ax, ay);
+        __m256 c = _mm256_div_ps(tmin, _mm256_add_ps(tmax, eps));
+        __m256 c2 = _mm256_mul_ps(c, c);
+        __m256 a = _mm256_mul_ps(c2, p7);
+        a = _mm256_mul_ps(_mm256_add_ps(a, p5), c2);
+        a = _mm256_mul_ps(_mm256_add_ps(a, p3), c2);
+        a = _mm256_mul_ps(_mm256_add_ps(a, p1), c);
+
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_90, a), mask);
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_180, a), _mm256_cmp_ps(x, z, _CMP_LT_OQ));
+        a = _mm256_blendv_ps(a, _mm256_sub_ps(_360, a), _mm256_cmp_ps(y, z, _CMP_LT_OQ));
+
+        _mm256_storeu_ps(angle + i, _mm256_mul_ps(a, scale8));
+    }
+    return i;
+}
+
+// must match the table parameters in mathfuncs.cpp
+#define EXPTAB_SCALE 6
+#define EXPTAB_MASK  ((1 << EXPTAB_SCALE) - 1)
+#define EXPPOLY_32F_A0 .9670371139572337719125840413672004409288e-2
+
+static int exp32f( const float* x, float* y, int n, const double* expTab )
+{
+    static const double exp_prescale = 1.4426950408889634073599246810019 * (1 << EXPTAB_SCALE);
+    static const double exp_postscale = 1./(1 << EXPTAB_SCALE);
+    static const double exp_max_val = 3000.*(1 << EXPTAB_SCALE); // log10(DBL_MAX) < 3000
+    static const float
+        A4 = (float)(1.000000000000002438532970795181890933776 / EXPPOLY_32F_A0),
+        A3 = (float)(.6931471805521448196800669615864773144641 / EXPPOLY_32F_A0),
+        A2 = (float)(.2402265109513301490103372422686535526573 / EXPPOLY_32F_A0),
+        A1 = (float)(.5550339366753125211915322047004666939128e-1 / EXPPOLY_32F_A0);
+
+    int i = 0;
+    if( n < 8 )
+        return 0;
+
+    __m256d prescale4 = _mm256_set1_pd(exp_prescale);
+    __m256 postscale8 = _mm256_set1_ps((float)exp_postscale);
+    __m256 maxval8 = _mm256_set1_ps((float)(exp_max_val/exp_prescale));
+    __m256 minval8 = _mm256_set1_ps((float)(-exp_max_val/exp_prescale));
+    __m256 mA1 = _mm256_set1_ps(A1), mA2 = _mm256_set1_ps(A2);
+    __m256 mA3 = _mm256_set1_ps(A3), mA4 = _mm256_set1_ps(A4);
+
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m256 xf = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(x + i), minval8), maxval8);
+
+        __m256d xd0 = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(xf)), prescale4);
+        __m256d xd1 = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(xf, 1)), prescale4);
+        __m128i xi0 = _mm256_cvtpd_epi32(xd0), xi1 = _mm256_cvtpd_epi32(xd1);
+
+        xd0 = _mm256_sub_pd(xd0, _mm256_cvtepi32_pd(xi0));
+        xd1 = _mm256_sub_pd(xd1, _mm256_cvtepi32_pd(xi1));
+        xf = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(xd0)), _mm256_cvtpd_ps(xd1), 1);
+        xf = _mm256_mul_ps(xf, postscale8);
+
+        __m256i xi = _mm256_inserti128_si256(_mm256_castsi128_si256(xi0), xi1, 1);
+        __m256i idx = _mm256_and_si256(xi, _mm256_set1_epi32(EXPTAB_MASK));
+        // the biased exponent of 2^(xi >> EXPTAB_SCALE), saturated to [0, 255]
+        xi = _mm256_add_epi32(_mm256_srai_epi32(xi, EXPTAB_SCALE), _mm256_set1_epi32(127));
+        xi = _mm256_min_epi32(_mm256_max_epi32(xi, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+
+        __m256d yd0 = _mm256_i32gather_pd(expTab, _mm256_castsi256_si128(idx), 8);
+        __m256d yd1 = _mm256_i32gather_pd(expTab, _mm256_extracti128_si256(idx, 1), 8);
+        __m256 yf = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(yd0)), _mm256_cvtpd_ps(yd1), 1);
+        yf = _mm256_mul_ps(yf, _mm256_castsi256_ps(_mm256_slli_epi32(xi, 23)));
+
+        __m256 zf = _mm256_add_ps(xf, mA1);
+        zf = _mm256_add_ps(_mm256_mul_ps(zf, xf), mA2);
+        zf = _mm256_add_ps(_mm256_mul_ps(zf, xf), mA3);
+        zf = _mm256_add_ps(_mm256_mul_ps(zf, xf), mA4);
+
+        _mm256_storeu_ps(y + i, _mm256_mul_ps(zf, yf));
+    }
+    return i;
+}
+
+#define LOGTAB_SCALE        8
+#define LOGTAB_MASK         ((1 << LOGTAB_SCALE) - 1)
+#define LOGTAB_MASK2_32F    ((1 << (23 - LOGTAB_SCALE)) - 1)
+
+static int log32f( const float* x, float* y, int n, const double* logTab )
+{
+    static const double ln_2 = 0.69314718055994530941723212145818;
+    static const float A0 = 0.3333333333333333333333333f, A1 = -0.5f, A2 = 1.f;
+
+    __m256d ln2 = _mm256_set1_pd(ln_2);
+    __m256 one = _mm256_set1_ps(1.f), shift8 = _mm256_set1_ps(-1.f/512);
+    __m256 mA0 = _mm256_set1_ps(A0), mA1 = _mm256_set1_ps(A1), mA2 = _mm256_set1_ps(A2);
+
+    int i = 0;
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m256i h = _mm256_loadu_si256((const __m256i*)(x + i));
+        __m256i yi = _mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(h, 23), _mm256_set1_epi32(255)),
+                                      _mm256_set1_epi32(127));
+        __m256d yd0 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(yi)), ln2);
+        __m256d yd1 = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(yi, 1)), ln2);
+
+        __m256i xi = _mm256_or_si256(_mm256_and_si256(h, _mm256_set1_epi32(LOGTAB_MASK2_32F)),
+                                     _mm256_set1_epi32(127 << 23));
+
+        h = _mm256_and_si256(_mm256_srli_epi32(h, 23 - LOGTAB_SCALE - 1), _mm256_set1_epi32(LOGTAB_MASK*2));
+        __m128i h0 = _mm256_castsi256_si128(h), h1 = _mm256_extracti128_si256(h, 1);
+        __m256 edge = _mm256_castsi256_ps(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(510)));
+
+        __m256d t0 = _mm256_i32gather_pd(logTab, h0, 8), t1 = _mm256_i32gather_pd(logTab + 1, h0, 8);
+        __m256d t2 = _mm256_i32gather_pd(logTab, h1, 8), t3 = _mm256_i32gather_pd(logTab + 1, h1, 8);
+
+        yd0 = _mm256_add_pd(yd0, t0);
+        yd1 = _mm256_add_pd(yd1, t2);
+        __m256 yf = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(yd0)), _mm256_cvtpd_ps(yd1), 1);
+
+        __m256 xf = _mm256_sub_ps(_mm256_castsi256_ps(xi), one);
+        xf = _mm256_mul_ps(xf, _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(t1)), _mm256_cvtpd_ps(t3), 1));
+        xf = _mm256_add_ps(xf, _mm256_and_ps(edge, shift8));
+
+        __m256 zf = _mm256_mul_ps(xf, mA0);
+        zf = _mm256_mul_ps(_mm256_add_ps(zf, mA1), xf);
+        zf = _mm256_mul_ps(_mm256_add_ps(zf, mA2), xf);
+
+        _mm256_storeu_ps(y + i, _mm256_add_ps(yf, zf));
+    }
+    return i;
+}
+
+
+//////////////////////////////////////// DFT ////////////////////////////////////////////
+
+// one radix-4 butterfly, the same operations as in DFT_VecR4<float> (dxt.cpp);
+// v0 and v1 point to the j-th elements of the 1st and the 3rd quarters, dw = j*dw0
+static inline void radix4Butterfly( float* v0, float* v1, int nx, const float* wave, int dw )
+{
+    __m128 z = _mm_setzero_ps(), x02, x13, y01, y23, t0, t1;
+    __m128 neg3_mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, (int)0x80000000));
+
+    if( dw == 0 )
+    {
+        x02 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)v0), (const __m64*)v1);
+        x13 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(v0 + nx*2)), (const __m64*)(v1 + nx*2));
+    }
+    else
+    {
+        x13 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(v0 + nx*2)), (const __m64*)(v1 + nx*2));
+        __m128 w23 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(wave + dw*4)), (const __m64*)(wave + dw*6));
+        t0 = _mm_mul_ps(_mm_moveldup_ps(x13), w23);
+        t1 = _mm_mul_ps(_mm_movehdup_ps(x13), _mm_shuffle_ps(w23, w23, _MM_SHUFFLE(2,3,0,1)));
+        x13 = _mm_addsub_ps(t0, t1);
+
+        x02 = _mm_loadl_pi(z, (const __m64*)v1);
+        __m128 w01 = _mm_loadl_pi(z, (const __m64*)(wave + dw*2));
+        x02 = _mm_shuffle_ps(x02, x02, _MM_SHUFFLE(0,0,1,1));
+        w01 = _mm_shuffle_ps(w01, w01, _MM_SHUFFLE(1,0,0,1));
+        x02 = _mm_mul_ps(x02, w01);
+        x02 = _mm_addsub_ps(x02, _mm_movelh_ps(x02, x02));
+        x02 = _mm_loadl_pi(x02, (const __m64*)v0);
+    }
+
+    y01 = _mm_add_ps(x02, x13);
+    y23 = _mm_sub_ps(x02, x13);
+    t1 = _mm_xor_ps(_mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2,3,3,2)), neg3_mask);
+    t0 = _mm_movelh_ps(y01, y23);
+    y01 = _mm_add_ps(t0, t1);
+    y23 = _mm_sub_ps(t0, t1);
+
+    _mm_storel_pi((__m64*)v0, y01);
+    _mm_storeh_pi((__m64*)(v0 + nx*2), y01);
+    _mm_storel_pi((__m64*)v1, y23);
+    _mm_storeh_pi((__m64*)(v1 + nx*2), y23);
+}
+
+// (re, im) pairs: x*w = (xr*wr - xi*wi, xr*wi + xi*wr)
+static inline __m256 complexMul( __m256 x, __m256 w )
+{
+    __m256 t0 = _mm256_mul_ps(_mm256_moveldup_ps(x), w);
+    __m256 t1 = _mm256_mul_ps(_mm256_movehdup_ps(x), _mm256_permute_ps(w, _MM_SHUFFLE(2,3,0,1)));
+    return _mm256_addsub_ps(t0, t1);
+}
+
+static int dftRadix4_32f( float* dst, int N, int n0, int* _dw0, const float* wave )
+{
+    int n = 1, i, j, nx, dw0 = *_dw0;
+    const double* wave2 = (const double*)wave; // a complex number is loaded as one double
+    const __m256 neg_im = _mm256_castsi256_ps(_mm256_set1_epi64x((long long)0x8000000000000000ULL));
+
+    for( ; n*4 <= N; )
+    {
+        nx = n;
+        n *= 4;
+        dw0 /= 4;
+
+        __m128i dw1_0 = _mm_mullo_epi32(_mm_setr_epi32(1, 2, 3, 4), _mm_set1_epi32(dw0));
+        __m128i dw_step = _mm_set1_epi32(dw0*4);
+
+        for( i = 0; i < n0; i += n )
+        {
+            float* v0 = dst + i*2;
+            float* v1 = v0 + nx*4;
+            __m128i dw1 = dw1_0;
+
+            radix4Butterfly(v0, v1, nx, wave, 0);
+
+            for( j = 1; j <= nx - 4; j += 4, dw1 = _mm_add_epi32(dw1, dw_step) )
+            {
+                __m128i dw2 = _mm_add_epi32(dw1, dw1), dw3 = _mm_add_epi32(dw2, dw1);
+                __m256 w1 = _mm256_castpd_ps(_mm256_i32gather_pd(wave2, dw1, 8));
+                __m256 w2 = _mm256_castpd_ps(_mm256_i32gather_pd(wave2, dw2, 8));
+                __m256 w3 = _mm256_castpd_ps(_mm256_i32gather_pd(wave2, dw3, 8));
+                float* p0 = v0 + j*2;
+                float* p1 = v1 + j*2;
+
+                __m256 a0 = _mm256_loadu_ps(p0);
+                __m256 b1 = complexMul(_mm256_loadu_ps(p0 + nx*2), w2);
+                __m256 b2 = complexMul(_mm256_loadu_ps(p1), w1);
+                __m256 b3 = complexMul(_mm256_loadu_ps(p1 + nx*2), w3);
+
+                __m256 p = _mm256_add_ps(a0, b1), q = _mm256_sub_ps(a0, b1);
+                __m256 s = _mm256_add_ps(b2, b3), d = _mm256_sub_ps(b2, b3);
+                // (d.im, -d.re)
+                d = _mm256_xor_ps(_mm256_permute_ps(d, _MM_SHUFFLE(2,3,0,1)), neg_im);
+
+                _mm256_storeu_ps(p0, _mm256_add_ps(p, s));
+                _mm256_storeu_ps(p0 + nx*2, _mm256_add_ps(q, d));
+                _mm256_storeu_ps(p1, _mm256_sub_ps(p, s));
+                _mm256_storeu_ps(p1 + nx*2, _mm256_sub_ps(q, d));
+            }
+
+            for( ; j < nx; j++ )
+                radix4Butterfly(v0 + j*2, v1 + j*2, nx, wave, j*dw0);
+        }
+    }
+
+    *_dw0 = dw0;
+    return n;
+}
+
+}
+
+static const SIMDKernels kernelsAVX2 =
+{
+    opt_AVX2::add8u, opt_AVX2::sub8u, opt_AVX2::absdiff8u,
+    opt_AVX2::add16u, opt_AVX2::sub16u, opt_AVX2::absdiff16u,
+    opt_AVX2::add16s, opt_AVX2::sub16s, opt_AVX2::absdiff16s,
+    opt_AVX2::add32f, opt_AVX2::sub32f, opt_AVX2::absdiff32f,
+    opt_AVX2::cmp8u, opt_AVX2::cmp16s, opt_AVX2::cmp32f,
+    opt_AVX2::cvt8u32f, opt_AVX2::cvt16u32f, opt_AVX2::cvt16s32f,
+    opt_AVX2::cvt32f8u, opt_AVX2::cvt32f16u, opt_AVX2::cvt32f16s,
+    opt_AVX2::cvtScale8u32f, opt_AVX2::cvtScale32f8u,
+    opt_AVX2::magnitude32f, opt_AVX2::fastAtan2_32f, opt_AVX2::exp32f, opt_AVX2::log32f,
+    opt_AVX2::dftRadix4_32f
+};
+
+const SIMDKernels* getSIMDKernelsAVX2()
+{
+    return &kernelsAVX2;
+}
+
+}
+
+#endif
@@ -0,0 +1,735 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+/* ////////////////////////////////////////////////////////////////////
+//
+//  AVX-512 (F + BW) variants of the core kernels, see simd_dispatch.hpp
+//
+// */
+
+// Not precomp.hpp, see simd_avx2.cpp
+#include "cvconfig.h"
+#include "opencv2/core.hpp"
+#include "simd_dispatch.hpp"
+
+#ifdef HAVE_AVX512_DISPATCH
+
+#include <immintrin.h>
+
+/*
+   Like simd_avx2.cpp, this file is compiled with its own instruction set flags, so it must
+   not instantiate any inline function or template shared with the other translation units.
+   Only the F and BW subsets are used, they are checked together at runtime.
+*/
+
+namespace cv
+{
+namespace opt_AVX512
+{
+
+static inline int clip(int v, int lo, int hi) { return v < lo ? lo : v > hi ? hi : v; }
+static inline int round32f(float v) { return _mm_cvtss_si32(_mm_set_ss(v)); }
+static inline float abs32f(float v) { return v < 0 ? -v : v; }
+
+#define CV_ROW_PTR(type, ptr, step) ((type*)((uchar*)(ptr) + (step)))
+
+// the 256-bit halves, without the AVX512DQ instructions
+static inline __m512 combine(__m256 lo, __m256 hi)
+{ return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(lo)), _mm256_castps_pd(hi), 1)); }
+static inline __m256 high(__m512 v)
+{ return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)); }
+static inline __m512i combine(__m256i lo, __m256i hi)
+{ return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1); }
+static inline __m256i high(__m512i v)
+{ return _mm512_extracti64x4_epi64(v, 1); }
+
+/////////////////////////////////// add, sub, absdiff ///////////////////////////////////
+
+struct VAdd8u
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_adds_epu8(a, b); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)clip(a + b, 0, 255); }
+};
+struct VSub8u
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_subs_epu8(a, b); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)clip(a - b, 0, 255); }
+};
+struct VAbsDiff8u
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    { return _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a)); }
+    uchar operator()(uchar a, uchar b) const { return (uchar)(a > b ? a - b : b - a); }
+};
+
+struct VAdd16u
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_adds_epu16(a, b); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)clip(a + b, 0, 65535); }
+};
+struct VSub16u
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_subs_epu16(a, b); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)clip(a - b, 0, 65535); }
+};
+struct VAbsDiff16u
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    { return _mm512_or_si512(_mm512_subs_epu16(a, b), _mm512_subs_epu16(b, a)); }
+    ushort operator()(ushort a, ushort b) const { return (ushort)(a > b ? a - b : b - a); }
+};
+
+struct VAdd16s
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_adds_epi16(a, b); }
+    short operator()(short a, short b) const { return (short)clip(a + b, -32768, 32767); }
+};
+struct VSub16s
+{
+    __m512i operator()(__m512i a, __m512i b) const { return _mm512_subs_epi16(a, b); }
+    short operator()(short a, short b) const { return (short)clip(a - b, -32768, 32767); }
+};
+struct VAbsDiff16s
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    { return _mm512_subs_epi16(_mm512_max_epi16(a, b), _mm512_min_epi16(a, b)); }
+    short operator()(short a, short b) const { return (short)clip(a > b ? a - b : b - a, 0, 32767); }
+};
+
+struct VAdd32f
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    { return _mm512_castps_si512(_mm512_add_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b))); }
+    float operator()(float a, float b) const { return a + b; }
+};
+struct VSub32f
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    { return _mm512_castps_si512(_mm512_sub_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b))); }
+    float operator()(float a, float b) const { return a - b; }
+};
+struct VAbsDiff32f
+{
+    __m512i operator()(__m512i a, __m512i b) const
+    {
+        __m512 d = _mm512_sub_ps(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b));
+        return _mm512_and_si512(_mm512_castps_si512(d), _mm512_set1_epi32(0x7fffffff));
+    }
+    float operator()(float a, float b) const { return abs32f(a - b); }
+};
+
+template<typename T, class Op> static void
+binOp(const T* src1, size_t step1, const T* src2, size_t step2, T* dst, size_t step, Size sz)
+{
+    const int VECSZ = (int)(sizeof(__m512i)/sizeof(T));
+    Op op;
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const T, src1, step1),
+                        src2 = CV_ROW_PTR(const T, src2, step2),
+                        dst = CV_ROW_PTR(T, dst, step) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - VECSZ*2; x += VECSZ*2 )
+        {
+            __m512i r0 = _mm512_loadu_si512(src1 + x);
+            __m512i r1 = _mm512_loadu_si512(src1 + x + VECSZ);
+            r0 = op(r0, _mm512_loadu_si512(src2 + x));
+            r1 = op(r1, _mm512_loadu_si512(src2 + x + VECSZ));
+            _mm512_storeu_si512(dst + x, r0);
+            _mm512_storeu_si512(dst + x + VECSZ, r1);
+        }
+        for( ; x <= sz.width - VECSZ; x += VECSZ )
+        {
+            __m512i r0 = _mm512_loadu_si512(src1 + x);
+            r0 = op(r0, _mm512_loadu_si512(src2 + x));
+            _mm512_storeu_si512(dst + x, r0);
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = op(src1[x], src2[x]);
+    }
+}
+
+#define DEF_BIN_FUNC(name, type, op) \
+static void name( const type* src1, size_t step1, const type* src2, size_t step2, \
+                  type* dst, size_t step, Size sz ) \
+{ \
+    binOp<type, op>(src1, step1, src2, step2, dst, step, sz); \
+}
+
+DEF_BIN_FUNC(add8u, uchar, VAdd8u)
+DEF_BIN_FUNC(sub8u, uchar, VSub8u)
+DEF_BIN_FUNC(absdiff8u, uchar, VAbsDiff8u)
+DEF_BIN_FUNC(add16u, ushort, VAdd16u)
+DEF_BIN_FUNC(sub16u, ushort, VSub16u)
+DEF_BIN_FUNC(absdiff16u, ushort, VAbsDiff16u)
+DEF_BIN_FUNC(add16s, short, VAdd16s)
+DEF_BIN_FUNC(sub16s, short, VSub16s)
+DEF_BIN_FUNC(absdiff16s, short, VAbsDiff16s)
+DEF_BIN_FUNC(add32f, float, VAdd32f)
+DEF_BIN_FUNC(sub32f, float, VSub32f)
+DEF_BIN_FUNC(absdiff32f, float, VAbsDiff32f)
+
+/////////////////////////////////////// compare ////////////////////////////////////////
+
+// CMP_GE and CMP_LT are turned into CMP_LE and CMP_GT by swapping the operands,
+// then every operation is either "greater" or "equal", optionally inverted
+template<typename T> static bool
+normalizeCmp(const T*& src1, size_t& step1, const T*& src2, size_t& step2, int& code)
+{
+    if( code == CMP_GE || code == CMP_LT )
+    {
+        const T* t = src1; src1 = src2; src2 = t;
+        size_t s = step1; step1 = step2; step2 = s;
+        code = code == CMP_GE ? CMP_LE : CMP_GT;
+    }
+    return code == CMP_GT || code == CMP_LE;
+}
+
+static void cmp8u( const uchar* src1, size_t step1, const uchar* src2, size_t step2,
+                   uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m512i vm = _mm512_set1_epi8((char)m);
+
+    for( ; sz.height--; src1 += step1, src2 += step2, dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 64; x += 64 )
+        {
+            __m512i a = _mm512_loadu_si512(src1 + x), b = _mm512_loadu_si512(src2 + x);
+            __mmask64 r = gt ? _mm512_cmpgt_epu8_mask(a, b) : _mm512_cmpeq_epi8_mask(a, b);
+            _mm512_storeu_si512(dst + x, _mm512_xor_si512(_mm512_movm_epi8(r), vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+static void cmp16s( const short* src1, size_t step1, const short* src2, size_t step2,
+                    uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m512i vm = _mm512_set1_epi8((char)m);
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const short, src1, step1),
+                        src2 = CV_ROW_PTR(const short, src2, step2), dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 64; x += 64 )
+        {
+            __mmask64 r = 0;
+            for( int k = 0; k < 2; k++ )
+            {
+                __m512i a = _mm512_loadu_si512(src1 + x + k*32), b = _mm512_loadu_si512(src2 + x + k*32);
+                __mmask32 rk = gt ? _mm512_cmpgt_epi16_mask(a, b) : _mm512_cmpeq_epi16_mask(a, b);
+                r |= (__mmask64)rk << (k*32);
+            }
+            _mm512_storeu_si512(dst + x, _mm512_xor_si512(_mm512_movm_epi8(r), vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+static void cmp32f( const float* src1, size_t step1, const float* src2, size_t step2,
+                    uchar* dst, size_t step, Size sz, int code )
+{
+    bool gt = normalizeCmp(src1, step1, src2, step2, code);
+    int m = code == CMP_GT || code == CMP_EQ ? 0 : 255;
+    __m512i vm = _mm512_set1_epi8((char)m);
+
+    for( ; sz.height--; src1 = CV_ROW_PTR(const float, src1, step1),
+                        src2 = CV_ROW_PTR(const float, src2, step2), dst += step )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 64; x += 64 )
+        {
+            __mmask64 r = 0;
+            for( int k = 0; k < 4; k++ )
+            {
+                __m512 a = _mm512_loadu_ps(src1 + x + k*16), b = _mm512_loadu_ps(src2 + x + k*16);
+                __mmask16 rk = gt ? _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ) : _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+                r |= (__mmask64)rk << (k*16);
+            }
+            _mm512_storeu_si512(dst + x, _mm512_xor_si512(_mm512_movm_epi8(r), vm));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)(-(gt ? src1[x] > src2[x] : src1[x] == src2[x]) ^ m);
+    }
+}
+
+/////////////////////////////////////// convertTo ///////////////////////////////////////
+
+static void cvt8u32f( const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src += sstep, dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512i v = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(src + x)));
+            _mm512_storeu_ps(dst + x, _mm512_cvtepi32_ps(v));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static void cvt16u32f( const ushort* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const ushort, src, sstep), dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512i v = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(src + x)));
+            _mm512_storeu_ps(dst + x, _mm512_cvtepi32_ps(v));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static void cvt16s32f( const short* src, size_t sstep, float* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const short, src, sstep), dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512i v = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)(src + x)));
+            _mm512_storeu_ps(dst + x, _mm512_cvtepi32_ps(v));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (float)src[x];
+    }
+}
+
+static inline __m128i cvt32s8u(__m512i v)
+{
+    v = _mm512_min_epi32(_mm512_max_epi32(v, _mm512_setzero_si512()), _mm512_set1_epi32(255));
+    return _mm512_cvtepi32_epi8(v);
+}
+
+static void cvt32f8u( const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst += dstep )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+            _mm_storeu_si128((__m128i*)(dst + x), cvt32s8u(_mm512_cvtps_epi32(_mm512_loadu_ps(src + x))));
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)clip(round32f(src[x]), 0, 255);
+    }
+}
+
+static void cvt32f16u( const float* src, size_t sstep, ushort* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst = CV_ROW_PTR(ushort, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512i v = _mm512_cvtps_epi32(_mm512_loadu_ps(src + x));
+            v = _mm512_min_epi32(_mm512_max_epi32(v, _mm512_setzero_si512()), _mm512_set1_epi32(65535));
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm512_cvtepi32_epi16(v));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (ushort)clip(round32f(src[x]), 0, 65535);
+    }
+}
+
+static void cvt32f16s( const float* src, size_t sstep, short* dst, size_t dstep, Size sz )
+{
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst = CV_ROW_PTR(short, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512i v = _mm512_cvtps_epi32(_mm512_loadu_ps(src + x));
+            _mm256_storeu_si256((__m256i*)(dst + x), _mm512_cvtsepi32_epi16(v));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (short)clip(round32f(src[x]), -32768, 32767);
+    }
+}
+
+static void cvtScale8u32f( const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz,
+                           float scale, float shift )
+{
+    __m512 vscale = _mm512_set1_ps(scale), vshift = _mm512_set1_ps(shift);
+
+    for( ; sz.height--; src += sstep, dst = CV_ROW_PTR(float, dst, dstep) )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512 f = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(src + x))));
+            _mm512_storeu_ps(dst + x, _mm512_add_ps(_mm512_mul_ps(f, vscale), vshift));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = src[x]*scale + shift;
+    }
+}
+
+static void cvtScale32f8u( const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz,
+                           float scale, float shift )
+{
+    __m512 vscale = _mm512_set1_ps(scale), vshift = _mm512_set1_ps(shift);
+
+    for( ; sz.height--; src = CV_ROW_PTR(const float, src, sstep), dst += dstep )
+    {
+        int x = 0;
+        for( ; x <= sz.width - 16; x += 16 )
+        {
+            __m512 f = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(src + x), vscale), vshift);
+            _mm_storeu_si128((__m128i*)(dst + x), cvt32s8u(_mm512_cvtps_epi32(f)));
+        }
+        for( ; x < sz.width; x++ )
+            dst[x] = (uchar)clip(round32f(src[x]*scale + shift), 0, 255);
+    }
+}
+
+///////////////////////////////////// math functions ////////////////////////////////////
+
+static int magnitude32f( const float* x, const float* y, float* mag, int len )
+{
+    int i = 0;
+    for( ; i <= len - 32; i += 32 )
+    {
+        __m512 x0 = _mm512_loadu_ps(x + i), x1 = _mm512_loadu_ps(x + i + 16);
+        __m512 y0 = _mm512_loadu_ps(y + i), y1 = _mm512_loadu_ps(y + i + 16);
+        x0 = _mm512_add_ps(_mm512_mul_ps(x0, x0), _mm512_mul_ps(y0, y0));
+        x1 = _mm512_add_ps(_mm512_mul_ps(x1, x1), _mm512_mul_ps(y1, y1));
+        _mm512_storeu_ps(mag + i, _mm512_sqrt_ps(x0));
+        _mm512_storeu_ps(mag + i + 16, _mm512_sqrt_ps(x1));
+    }
+    return i;
+}
+
+// the same polynomial as in fastAtan2() (mathfuncs.cpp)
+static const float atan2_p1 = 0.9997878412794807f*(float)(180/CV_PI);
+static const float atan2_p3 = -0.3258083974640975f*(float)(180/CV_PI);
+static const float atan2_p5 = 0.1555786518463281f*(float)(180/CV_PI);
+static const float atan2_p7 = -0.04432655554792128f*(float)(180/CV_PI);
+
+static int fastAtan2_32f( const float* Y, const float* X, float* angle, int len, bool angleInDegrees )
+{
+    int i = 0;
+    float scale = angleInDegrees ? 1 : (float)(CV_PI/180);
+    __m512 eps = _mm512_set1_ps((float)DBL_EPSILON);
+    __m512i absmask = _mm512_set1_epi32(0x7fffffff);
+    __m512 _90 = _mm512_set1_ps(90.f), _180 = _mm512_set1_ps(180.f), _360 = _mm512_set1_ps(360.f);
+    __m512 z = _mm512_setzero_ps(), scale16 = _mm512_set1_ps(scale);
+    __m512 p1 = _mm512_set1_ps(atan2_p1), p3 = _mm512_set1_ps(atan2_p3);
+    __m512 p5 = _mm512_set1_ps(atan2_p5), p7 = _mm512_set1_ps(atan2_p7);
+
+    for( ; i <= len - 16; i += 16 )
+    {
+        __m512 x = _mm512_loadu_ps(X + i), y = _mm512_loadu_ps(Y + i);
+        __m512 ax = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(x), absmask));
+        __m512 ay = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(y), absmask));
+        __mmask16 mask = _mm512_cmp_ps_mask(ax, ay, _CMP_LT_OQ);
+        __m512 tmin = _mm512_min_ps(ax, ay), tmax = _mm512_max_ps(ax, ay);
+        __m512 c = _mm512_div_ps(tmin, _mm512_add_ps(tmax, eps));
+        __m512 c2 = _mm512_mul_ps(c, c);
+        __m512 a = _mm512_mul_ps(c2, p7);
+        a = _mm512_mul_ps(_mm512_add_ps(a, p5), c2);
+        a = _mm512_mul_ps(_mm512_add_ps(a, p3), c2);
+        a = _mm512_mul_ps(_mm512_add_ps(a, p1), c);
+
+        a = _mm512_mask_blend_ps(mask, a, _mm512_sub_ps(_90, a));
+        a = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, z, _CMP_LT_OQ), a, _mm512_sub_ps(_180, a));
+        a = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(y, z, _CMP_LT_OQ), a, _mm512_sub_ps(_360, a));
+
+        _mm512_storeu_ps(angle + i, _mm512_mul_ps(a, scale16));
+    }
+    return i;
+}
+
+// must match the table parameters in mathfuncs.cpp
+#define EXPTAB_SCALE 6
+#define EXPTAB_MASK  ((1 << EXPTAB_SCALE) - 1)
+#define EXPPOLY_32F_A0 .9670371139572337719125840413672004409288e-2
+
+static int exp32f( const float* x, float* y, int n, const double* expTab )
+{
+    static const double exp_prescale = 1.4426950408889634073599246810019 * (1 << EXPTAB_SCALE);
+    static const double exp_postscale = 1./(1 << EXPTAB_SCALE);
+    static const double exp_max_val = 3000.*(1 << EXPTAB_SCALE); // log10(DBL_MAX) < 3000
+    static const float
+        A4 = (float)(1.000000000000002438532970795181890933776 / EXPPOLY_32F_A0),
+        A3 = (float)(.6931471805521448196800669615864773144641 / EXPPOLY_32F_A0),
+        A2 = (float)(.2402265109513301490103372422686535526573 / EXPPOLY_32F_A0),
+        A1 = (float)(.5550339366753125211915322047004666939128e-1 / EXPPOLY_32F_A0);
+
+    int i = 0;
+    if( n < 8 )
+        return 0;
+
+    __m512d prescale8 = _mm512_set1_pd(exp_prescale);
+    __m512 postscale16 = _mm512_set1_ps((float)exp_postscale);
+    __m512 maxval16 = _mm512_set1_ps((float)(exp_max_val/exp_prescale));
+    __m512 minval16 = _mm512_set1_ps((float)(-exp_max_val/exp_prescale));
+    __m512 mA1 = _mm512_set1_ps(A1), mA2 = _mm512_set1_ps(A2);
+    __m512 mA3 = _mm512_set1_ps(A3), mA4 = _mm512_set1_ps(A4);
+
+    for( ; i <= n - 16; i += 16 )
+    {
+        __m512 xf = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(x + i), minval16), maxval16);
+
+        __m512d xd0 = _mm512_mul_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(xf)), prescale8);
+        __m512d xd1 = _mm512_mul_pd(_mm512_cvtps_pd(high(xf)), prescale8);
+        __m256i xi0 = _mm512_cvtpd_epi32(xd0), xi1 = _mm512_cvtpd_epi32(xd1);
+
+        xd0 = _mm512_sub_pd(xd0, _mm512_cvtepi32_pd(xi0));
+        xd1 = _mm512_sub_pd(xd1, _mm512_cvtepi32_pd(xi1));
+        xf = _mm512_mul_ps(combine(_mm512_cvtpd_ps(xd0), _mm512_cvtpd_ps(xd1)), postscale16);
+
+        __m512i xi = combine(xi0, xi1);
+        __m512i idx = _mm512_and_si512(xi, _mm512_set1_epi32(EXPTAB_MASK));
+        // the biased exponent of 2^(xi >> EXPTAB_SCALE), saturated to [0, 255]
+        xi = _mm512_add_epi32(_mm512_srai_epi32(xi, EXPTAB_SCALE), _mm512_set1_epi32(127));
+        xi = _mm512_min_epi32(_mm512_max_epi32(xi, _mm512_setzero_si512()), _mm512_set1_epi32(255));
+
+        __m512d yd0 = _mm512_i32gather_pd(_mm512_castsi512_si256(idx), expTab, 8);
+        __m512d yd1 = _mm512_i32gather_pd(high(idx), expTab, 8);
+        __m512 yf = combine(_mm512_cvtpd_ps(yd0), _mm512_cvtpd_ps(yd1));
+        yf = _mm512_mul_ps(yf, _mm512_castsi512_ps(_mm512_slli_epi32(xi, 23)));
+
+        __m512 zf = _mm512_add_ps(xf, mA1);
+        zf = _mm512_add_ps(_mm512_mul_ps(zf, xf), mA2);
+        zf = _mm512_add_ps(_mm512_mul_ps(zf, xf), mA3);
+        zf = _mm512_add_ps(_mm512_mul_ps(zf, xf), mA4);
+
+        _mm512_storeu_ps(y + i, _mm512_mul_ps(zf, yf));
+    }
+    return i;
+}
+
+#define LOGTAB_SCALE        8
+#define LOGTAB_MASK         ((1 << LOGTAB_SCALE) - 1)
+#define LOGTAB_MASK2_32F    ((1 << (23 - LOGTAB_SCALE)) - 1)
+
+static int log32f( const float* x, float* y, int n, const double* logTab )
+{
+    static const double ln_2 = 0.69314718055994530941723212145818;
+    static const float A0 = 0.3333333333333333333333333f, A1 = -0.5f, A2 = 1.f;
+
+    __m512d ln2 = _mm512_set1_pd(ln_2);
+    __m512 one = _mm512_set1_ps(1.f), shift16 = _mm512_set1_ps(-1.f/512);
+    __m512 mA0 = _mm512_set1_ps(A0), mA1 = _mm512_set1_ps(A1), mA2 = _mm512_set1_ps(A2);
+
+    int i = 0;
+    for( ; i <= n - 16; i += 16 )
+    {
+        __m512i h = _mm512_loadu_si512(x + i);
+        __m512i yi = _mm512_sub_epi32(_mm512_and_si512(_mm512_srli_epi32(h, 23), _mm512_set1_epi32(255)),
+                                      _mm512_set1_epi32(127));
+        __m512d yd0 = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm512_castsi512_si256(yi)), ln2);
+        __m512d yd1 = _mm512_mul_pd(_mm512_cvtepi32_pd(high(yi)), ln2);
+
+        __m512i xi = _mm512_or_si512(_mm512_and_si512(h, _mm512_set1_epi32(LOGTAB_MASK2_32F)),
+                                     _mm512_set1_epi32(127 << 23));
+
+        h = _mm512_and_si512(_mm512_srli_epi32(h, 23 - LOGTAB_SCALE - 1), _mm512_set1_epi32(LOGTAB_MASK*2));
+        __m256i h0 = _mm512_castsi512_si256(h), h1 = high(h);
+        __mmask16 edge = _mm512_cmpeq_epi32_mask(h, _mm512_set1_epi32(510));
+
+        __m512d t0 = _mm512_i32gather_pd(h0, logTab, 8), t1 = _mm512_i32gather_pd(h0, logTab + 1, 8);
+        __m512d t2 = _mm512_i32gather_pd(h1, logTab, 8), t3 = _mm512_i32gather_pd(h1, logTab + 1, 8);
+
+        yd0 = _mm512_add_pd(yd0, t0);
+        yd1 = _mm512_add_pd(yd1, t2);
+        __m512 yf = combine(_mm512_cvtpd_ps(yd0), _mm512_cvtpd_ps(yd1));
+
+        __m512 xf = _mm512_sub_ps(_mm512_castsi512_ps(xi), one);
+        xf = _mm512_mul_ps(xf, combine(_mm512_cvtpd_ps(t1), _mm512_cvtpd_ps(t3)));
+        xf = _mm512_add_ps(xf, _mm512_maskz_mov_ps(edge, shift16));
+
+        __m512 zf = _mm512_mul_ps(xf, mA0);
+        zf = _mm512_mul_ps(_mm512_add_ps(zf, mA1), xf);
+        zf = _mm512_mul_ps(_mm512_add_ps(zf, mA2), xf);
+
+        _mm512_storeu_ps(y + i, _mm512_add_ps(yf, zf));
+    }
+    return i;
+}
+
+
+//////////////////////////////////////// DFT ////////////////////////////////////////////
+
+// one radix-4 butterfly, the same operations as in DFT_VecR4<float> (dxt.cpp);
+// v0 and v1 point to the j-th elements of the 1st and the 3rd quarters, dw = j*dw0
+static inline void radix4Butterfly( float* v0, float* v1, int nx, const float* wave, int dw )
+{
+    __m128 z = _mm_setzero_ps(), x02, x13, y01, y23, t0, t1;
+    __m128 neg3_mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, (int)0x80000000));
+
+    if( dw == 0 )
+    {
+        x02 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)v0), (const __m64*)v1);
+        x13 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(v0 + nx*2)), (const __m64*)(v1 + nx*2));
+    }
+    else
+    {
+        x13 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(v0 + nx*2)), (const __m64*)(v1 + nx*2));
+        __m128 w23 = _mm_loadh_pi(_mm_loadl_pi(z, (const __m64*)(wave + dw*4)), (const __m64*)(wave + dw*6));
+        t0 = _mm_mul_ps(_mm_moveldup_ps(x13), w23);
+        t1 = _mm_mul_ps(_mm_movehdup_ps(x13), _mm_shuffle_ps(w23, w23, _MM_SHUFFLE(2,3,0,1)));
+        x13 = _mm_addsub_ps(t0, t1);
+
+        x02 = _mm_loadl_pi(z, (const __m64*)v1);
+        __m128 w01 = _mm_loadl_pi(z, (const __m64*)(wave + dw*2));
+        x02 = _mm_shuffle_ps(x02, x02, _MM_SHUFFLE(0,0,1,1));
+        w01 = _mm_shuffle_ps(w01, w01, _MM_SHUFFLE(1,0,0,1));
+        x02 = _mm_mul_ps(x02, w01);
+        x02 = _mm_addsub_ps(x02, _mm_movelh_ps(x02, x02));
+        x02 = _mm_loadl_pi(x02, (const __m64*)v0);
+    }
+
+    y01 = _mm_add_ps(x02, x13);
+    y23 = _mm_sub_ps(x02, x13);
+    t1 = _mm_xor_ps(_mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2,3,3,2)), neg3_mask);
+    t0 = _mm_movelh_ps(y01, y23);
+    y01 = _mm_add_ps(t0, t1);
+    y23 = _mm_sub_ps(t0, t1);
+
+    _mm_storel_pi((__m64*)v0, y01);
+    _mm_storeh_pi((__m64*)(v0 + nx*2), y01);
+    _mm_storel_pi((__m64*)v1, y23);
+    _mm_storeh_pi((__m64*)(v1 + nx*2), y23);
+}
+
+// (re, im) pairs: x*w = (xr*wr - xi*wi, xr*wi + xi*wr); there is no 512-bit addsub,
+// the real parts are recomputed as differences
+static inline __m512 complexMul( __m512 x, __m512 w )
+{
+    __m512 t0 = _mm512_mul_ps(_mm512_moveldup_ps(x), w);
+    __m512 t1 = _mm512_mul_ps(_mm512_movehdup_ps(x), _mm512_permute_ps(w, _MM_SHUFFLE(2,3,0,1)));
+    return _mm512_mask_sub_ps(_mm512_add_ps(t0, t1), (__mmask16)0x5555, t0, t1);
+}
+
+static int dftRadix4_32f( float* dst, int N, int n0, int* _dw0, const float* wave )
+{
+    int n = 1, i, j, nx, dw0 = *_dw0;
+    const double* wave2 = (const double*)wave; // a complex number is loaded as one double
+    const __m512i neg_im = _mm512_set1_epi64((long long)0x8000000000000000ULL);
+
+    for( ; n*4 <= N; )
+    {
+        nx = n;
+        n *= 4;
+        dw0 /= 4;
+
+        __m256i dw1_0 = _mm256_mullo_epi32(_mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8), _mm256_set1_epi32(dw0));
+        __m256i dw_step = _mm256_set1_epi32(dw0*8);
+
+        for( i = 0; i < n0; i += n )
+        {
+            float* v0 = dst + i*2;
+            float* v1 = v0 + nx*4;
+            __m256i dw1 = dw1_0;
+
+            radix4Butterfly(v0, v1, nx, wave, 0);
+
+            for( j = 1; j <= nx - 8; j += 8, dw1 = _mm256_add_epi32(dw1, dw_step) )
+            {
+                __m256i dw2 = _mm256_add_epi32(dw1, dw1), dw3 = _mm256_add_epi32(dw2, dw1);
+                __m512 w1 = _mm512_castpd_ps(_mm512_i32gather_pd(dw1, wave2, 8));
+                __m512 w2 = _mm512_castpd_ps(_mm512_i32gather_pd(dw2, wave2, 8));
+                __m512 w3 = _mm512_castpd_ps(_mm512_i32gather_pd(dw3, wave2, 8));
+                float* p0 = v0 + j*2;
+                float* p1 = v1 + j*2;
+
+                __m512 a0 = _mm512_loadu_ps(p0);
+                __m512 b1 = complexMul(_mm512_loadu_ps(p0 + nx*2), w2);
+                __m512 b2 = complexMul(_mm512_loadu_ps(p1), w1);
+                __m512 b3 = complexMul(_mm512_loadu_ps(p1 + nx*2), w3);
+
+                __m512 p = _mm512_add_ps(a0, b1), q = _mm512_sub_ps(a0, b1);
+                __m512 s = _mm512_add_ps(b2, b3), d = _mm512_sub_ps(b2, b3);
+                // (d.im, -d.re)
+                d = _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(
+                        _mm512_permute_ps(d, _MM_SHUFFLE(2,3,0,1))), neg_im));
+
+                _mm512_storeu_ps(p0, _mm512_add_ps(p, s));
+                _mm512_storeu_ps(p0 + nx*2, _mm512_add_ps(q, d));
+                _mm512_storeu_ps(p1, _mm512_sub_ps(p, s));
+                _mm512_storeu_ps(p1 + nx*2, _mm512_sub_ps(q, d));
+            }
+
+            for( ; j < nx; j++ )
+                radix4Butterfly(v0 + j*2, v1 + j*2, nx, wave, j*dw0);
+        }
+    }
+
+    *_dw0 = dw0;
+    return n;
+}
+
+}
+
+static const SIMDKernels kernelsAVX512 =
+{
+    opt_AVX512::add8u, opt_AVX512::sub8u, opt_AVX512::absdiff8u,
+    opt_AVX512::add16u, opt_AVX512::sub16u, opt_AVX512::absdiff16u,
+    opt_AVX512::add16s, opt_AVX512::sub16s, opt_AVX512::absdiff16s,
+    opt_AVX512::add32f, opt_AVX512::sub32f, opt_AVX512::absdiff32f,
+    opt_AVX512::cmp8u, opt_AVX512::cmp16s, opt_AVX512::cmp32f,
+    opt_AVX512::cvt8u32f, opt_AVX512::cvt16u32f, opt_AVX512::cvt16s32f,
+    opt_AVX512::cvt32f8u, opt_AVX512::cvt32f16u, opt_AVX512::cvt32f16s,
+    opt_AVX512::cvtScale8u32f, opt_AVX512::cvtScale32f8u,
+    opt_AVX512::magnitude32f, opt_AVX512::fastAtan2_32f, opt_AVX512::exp32f, opt_AVX512::log32f,
+    opt_AVX512::dftRadix4_32f
+};
+
+const SIMDKernels* getSIMDKernelsAVX512()
+{
+    return &kernelsAVX512;
+}
+
+}
+
+#endif
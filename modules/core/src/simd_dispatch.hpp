@@ -0,0 +1,117 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#ifndef __OPENCV_CORE_SIMD_DISPATCH_HPP__
+#define __OPENCV_CORE_SIMD_DISPATCH_HPP__
+
+namespace cv
+{
+
+/*
+   Kernels built for the instruction sets newer than the build baseline.
+
+   simd_avx2.cpp and simd_avx512.cpp are compiled with their own instruction set
+   flags (see ENABLE_CPU_DISPATCH), each of them fills a table of this type. The table
+   matching the CPU is chosen at startup, so a baseline SSE2 binary still uses the
+   256- and 512-bit vectors where they are available. The results are bit-exact
+   with the SSE2 code; except for exp32f and log32f, which follow the SSE2 code
+   and differ from the C one by ~1 ulp, they are also bit-exact with the C code.
+
+   The arithmetic, comparison and conversion kernels process the whole 2D block, like
+   the BinaryFunc's do. The math kernels process the vectorizable part of the array
+   and return the number of the processed elements, the caller does the rest.
+*/
+struct SIMDKernels
+{
+    void (*add8u)(const uchar* src1, size_t step1, const uchar* src2, size_t step2, uchar* dst, size_t step, Size sz);
+    void (*sub8u)(const uchar* src1, size_t step1, const uchar* src2, size_t step2, uchar* dst, size_t step, Size sz);
+    void (*absdiff8u)(const uchar* src1, size_t step1, const uchar* src2, size_t step2, uchar* dst, size_t step, Size sz);
+    void (*add16u)(const ushort* src1, size_t step1, const ushort* src2, size_t step2, ushort* dst, size_t step, Size sz);
+    void (*sub16u)(const ushort* src1, size_t step1, const ushort* src2, size_t step2, ushort* dst, size_t step, Size sz);
+    void (*absdiff16u)(const ushort* src1, size_t step1, const ushort* src2, size_t step2, ushort* dst, size_t step, Size sz);
+    void (*add16s)(const short* src1, size_t step1, const short* src2, size_t step2, short* dst, size_t step, Size sz);
+    void (*sub16s)(const short* src1, size_t step1, const short* src2, size_t step2, short* dst, size_t step, Size sz);
+    void (*absdiff16s)(const short* src1, size_t step1, const short* src2, size_t step2, short* dst, size_t step, Size sz);
+    void (*add32f)(const float* src1, size_t step1, const float* src2, size_t step2, float* dst, size_t step, Size sz);
+    void (*sub32f)(const float* src1, size_t step1, const float* src2, size_t step2, float* dst, size_t step, Size sz);
+    void (*absdiff32f)(const float* src1, size_t step1, const float* src2, size_t step2, float* dst, size_t step, Size sz);
+
+    // cmpop is one of CMP_EQ, CMP_GT, ..., the result is 0 or 255
+    void (*cmp8u)(const uchar* src1, size_t step1, const uchar* src2, size_t step2, uchar* dst, size_t step, Size sz, int cmpop);
+    void (*cmp16s)(const short* src1, size_t step1, const short* src2, size_t step2, uchar* dst, size_t step, Size sz, int cmpop);
+    void (*cmp32f)(const float* src1, size_t step1, const float* src2, size_t step2, uchar* dst, size_t step, Size sz, int cmpop);
+
+    void (*cvt8u32f)(const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz);
+    void (*cvt16u32f)(const ushort* src, size_t sstep, float* dst, size_t dstep, Size sz);
+    void (*cvt16s32f)(const short* src, size_t sstep, float* dst, size_t dstep, Size sz);
+    void (*cvt32f8u)(const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz);
+    void (*cvt32f16u)(const float* src, size_t sstep, ushort* dst, size_t dstep, Size sz);
+    void (*cvt32f16s)(const float* src, size_t sstep, short* dst, size_t dstep, Size sz);
+    void (*cvtScale8u32f)(const uchar* src, size_t sstep, float* dst, size_t dstep, Size sz, float scale, float shift);
+    void (*cvtScale32f8u)(const float* src, size_t sstep, uchar* dst, size_t dstep, Size sz, float scale, float shift);
+
+    int (*magnitude32f)(const float* x, const float* y, float* mag, int len);
+    int (*fastAtan2_32f)(const float* y, const float* x, float* angle, int len, bool angleInDegrees);
+    // expTab and logTab are the tables from mathfuncs.cpp
+    int (*exp32f)(const float* x, float* y, int n, const double* expTab);
+    int (*log32f)(const float* x, float* y, int n, const double* logTab);
+
+    // the radix-4 passes of the complex DFT (see DFT_VecR4 in dxt.cpp); dst and wave are
+    // the interleaved complex arrays. Returns the size of the transformed sub-sequences
+    // and updates *dw0, the C code does the remaining passes
+    int (*dftRadix4_32f)(float* dst, int N, int n0, int* dw0, const float* wave);
+};
+
+#ifdef HAVE_AVX2_DISPATCH
+const SIMDKernels* getSIMDKernelsAVX2();
+#endif
+#ifdef HAVE_AVX512_DISPATCH
+const SIMDKernels* getSIMDKernelsAVX512();
+#endif
+
+//! the kernels for the current CPU, or NULL when there is nothing better than the baseline
+//! or the optimizations are turned off with setUseOptimized(false)
+extern const SIMDKernels* volatile currentSIMDKernels;
+
+}
+
+#endif
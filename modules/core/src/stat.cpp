@@ -57,6 +57,63 @@ template<typename T> static inline Scalar rawToScalar(const T& v)
     return s;
 }
 
+/****************************************************************************************\
+*                               stripe-parallel reductions                               *
+\****************************************************************************************/
+
+// Large 2D matrices are reduced by horizontal stripes of about STAT_STRIPE_SIZE elements
+// in parallel. The split depends only on the matrix size and the partial results are merged
+// in the stripe order, so the result does not depend on the number of threads.
+enum { STAT_STRIPE_SIZE = 1 << 16 };
+
+// returns the number of rows in a stripe or 0 if the matrix should be processed at once
+static int statStripeRows( const Mat& src )
+{
+    if( src.dims > 2 || src.rows <= 1 )
+        return 0;
+    size_t rowSize = (size_t)src.cols*src.channels();
+    int stripeRows = (int)std::max((size_t)STAT_STRIPE_SIZE/rowSize, (size_t)1);
+    return stripeRows < src.rows ? stripeRows : 0;
+}
+
+static inline Mat statStripe( const Mat& m, int y0, int y1 )
+{
+    return m.empty() ? m : m.rowRange(y0, y1);
+}
+
+template<typename Op> class StatStripeInvoker : public ParallelLoopBody
+{
+public:
+    typedef typename Op::result_type result_type;
+
+    StatStripeInvoker( const Op& _op, int _rows, int _stripeRows, result_type* _results )
+        : op(&_op), rows(_rows), stripeRows(_stripeRows), results(_results) {}
+
+    void operator()( const Range& range ) const
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y0 = i*stripeRows;
+            results[i] = (*op)(y0, std::min(y0 + stripeRows, rows));
+        }
+    }
+
+private:
+    const Op* op;
+    int rows, stripeRows;
+    result_type* results;
+};
+
+// applies op to every stripe, stores the partial results and returns the number of stripes
+template<typename Op> static int
+statStripes( const Op& op, int rows, int stripeRows, AutoBuffer<typename Op::result_type>& results )
+{
+    int nstripes = (rows + stripeRows - 1)/stripeRows;
+    results.allocate(nstripes);
+    parallel_for_(Range(0, nstripes), StatStripeInvoker<Op>(op, rows, stripeRows, results), nstripes);
+    return nstripes;
+}
+
 /****************************************************************************************\
 *                                        sum                                             *
 \****************************************************************************************/
@@ -183,17 +240,104 @@ static int sum8u( const uchar* src, const uchar* mask, int* dst, int len, int cn
 static int sum8s( const schar* src, const uchar* mask, int* dst, int len, int cn )
 { return sum_(src, mask, dst, len, cn); }
 
+#if CV_SSE2
+// The vectorized sums below process the unmasked matrices with 1, 2 or 4 channels, where
+// the vector lane k always accumulates the channel k % cn. They return the number of the
+// processed pixels; the rest is handled by sum_.
+
+static int sumVec16u( const ushort* src, int* dst, int len, int cn )
+{
+    int j = 0, n = len*cn;
+    __m128i z = _mm_setzero_si128(), s0 = z, s1 = z;
+    for( ; j <= n - 8; j += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + j));
+        s0 = _mm_add_epi32(s0, _mm_unpacklo_epi16(v, z));
+        s1 = _mm_add_epi32(s1, _mm_unpackhi_epi16(v, z));
+    }
+    int CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_si128((__m128i*)buf, _mm_add_epi32(s0, s1));
+    for( int k = 0; k < 4; k++ )
+        dst[k % cn] += buf[k];
+    return j/cn;
+}
+
+static int sumVec16s( const short* src, int* dst, int len, int cn )
+{
+    int j = 0, n = len*cn;
+    __m128i s0 = _mm_setzero_si128(), s1 = s0;
+    for( ; j <= n - 8; j += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + j));
+        s0 = _mm_add_epi32(s0, _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+        s1 = _mm_add_epi32(s1, _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+    }
+    int CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_si128((__m128i*)buf, _mm_add_epi32(s0, s1));
+    for( int k = 0; k < 4; k++ )
+        dst[k % cn] += buf[k];
+    return j/cn;
+}
+
+static int sumVec32f( const float* src, double* dst, int len, int cn )
+{
+    int j = 0, n = len*cn;
+    __m128d s0 = _mm_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    for( ; j <= n - 8; j += 8 )
+    {
+        __m128 v0 = _mm_loadu_ps(src + j), v1 = _mm_loadu_ps(src + j + 4);
+        s0 = _mm_add_pd(s0, _mm_cvtps_pd(v0));
+        s1 = _mm_add_pd(s1, _mm_cvtps_pd(_mm_movehl_ps(v0, v0)));
+        s2 = _mm_add_pd(s2, _mm_cvtps_pd(v1));
+        s3 = _mm_add_pd(s3, _mm_cvtps_pd(_mm_movehl_ps(v1, v1)));
+    }
+    double CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_pd(buf, _mm_add_pd(s0, s2));
+    _mm_store_pd(buf + 2, _mm_add_pd(s1, s3));
+    for( int k = 0; k < 4; k++ )
+        dst[k % cn] += buf[k];
+    return j/cn;
+}
+#endif
+
 static int sum16u( const ushort* src, const uchar* mask, int* dst, int len, int cn )
-{ return sum_(src, mask, dst, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sumVec16u(src, dst, len, cn);
+        return i + sum_(src + i*cn, mask, dst, len - i, cn);
+    }
+#endif
+    return sum_(src, mask, dst, len, cn);
+}
 
 static int sum16s( const short* src, const uchar* mask, int* dst, int len, int cn )
-{ return sum_(src, mask, dst, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sumVec16s(src, dst, len, cn);
+        return i + sum_(src + i*cn, mask, dst, len - i, cn);
+    }
+#endif
+    return sum_(src, mask, dst, len, cn);
+}
 
 static int sum32s( const int* src, const uchar* mask, double* dst, int len, int cn )
 { return sum_(src, mask, dst, len, cn); }
 
 static int sum32f( const float* src, const uchar* mask, double* dst, int len, int cn )
-{ return sum_(src, mask, dst, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sumVec32f(src, dst, len, cn);
+        return i + sum_(src + i*cn, mask, dst, len - i, cn);
+    }
+#endif
+    return sum_(src, mask, dst, len, cn);
+}
 
 static int sum64f( const double* src, const uchar* mask, double* dst, int len, int cn )
 { return sum_(src, mask, dst, len, cn); }
@@ -258,17 +402,91 @@ static int countNonZero8u( const uchar* src, int len )
     return nz;
 }
 
+#if CV_SSE2
+// the vectorized loops below count zeros; every zero element adds 1 to a 32-bit (64-bit for double) lane
+static inline int countZeros_( __m128i zeros )
+{
+    int CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_si128((__m128i*)buf, zeros);
+    return buf[0] + buf[1] + buf[2] + buf[3];
+}
+#endif
+
 static int countNonZero16u( const ushort* src, int len )
-{ return countNonZero_(src, len); }
+{
+    int i = 0, nz = 0;
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128i z = _mm_setzero_si128(), ones = _mm_set1_epi16(-1), zeros = z;
+        for( ; i <= len - 8; i += 8 )
+        {
+            __m128i m = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(src + i)), z);
+            zeros = _mm_add_epi32(zeros, _mm_madd_epi16(m, ones));
+        }
+        nz = i - countZeros_(zeros);
+    }
+#endif
+    return nz + countNonZero_(src + i, len - i);
+}
 
 static int countNonZero32s( const int* src, int len )
-{ return countNonZero_(src, len); }
+{
+    int i = 0, nz = 0;
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128i z = _mm_setzero_si128(), zeros = z;
+        for( ; i <= len - 8; i += 8 )
+        {
+            zeros = _mm_sub_epi32(zeros, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(src + i)), z));
+            zeros = _mm_sub_epi32(zeros, _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(src + i + 4)), z));
+        }
+        nz = i - countZeros_(zeros);
+    }
+#endif
+    return nz + countNonZero_(src + i, len - i);
+}
 
 static int countNonZero32f( const float* src, int len )
-{ return countNonZero_(src, len); }
+{
+    int i = 0, nz = 0;
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128 z = _mm_setzero_ps();
+        __m128i zeros = _mm_setzero_si128();
+        for( ; i <= len - 8; i += 8 )
+        {
+            zeros = _mm_sub_epi32(zeros, _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(src + i), z)));
+            zeros = _mm_sub_epi32(zeros, _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(src + i + 4), z)));
+        }
+        nz = i - countZeros_(zeros);
+    }
+#endif
+    return nz + countNonZero_(src + i, len - i);
+}
 
 static int countNonZero64f( const double* src, int len )
-{ return countNonZero_(src, len); }
+{
+    int i = 0, nz = 0;
+#if CV_SSE2
+    if( USE_SSE2 )
+    {
+        __m128d z = _mm_setzero_pd();
+        __m128i zeros = _mm_setzero_si128();
+        for( ; i <= len - 4; i += 4 )
+        {
+            zeros = _mm_sub_epi64(zeros, _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(src + i), z)));
+            zeros = _mm_sub_epi64(zeros, _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(src + i + 2), z)));
+        }
+        int64 CV_DECL_ALIGNED(16) buf[2];
+        _mm_store_si128((__m128i*)buf, zeros);
+        nz = i - (int)(buf[0] + buf[1]);
+    }
+#endif
+    return nz + countNonZero_(src + i, len - i);
+}
 
 typedef int (*CountNonZeroFunc)(const uchar*, int);
 
@@ -411,17 +629,120 @@ static int sqsum8u( const uchar* src, const uchar* mask, int* sum, int* sqsum, i
 static int sqsum8s( const schar* src, const uchar* mask, int* sum, int* sqsum, int len, int cn )
 { return sumsqr_(src, mask, sum, sqsum, len, cn); }
 
+#if CV_SSE2
+// The squares of 16-bit values are computed exactly as 32-bit integers and accumulated as doubles;
+// the unsigned squares are biased by -2^31 to be converted as signed integers. The lane layout
+// is the same as in sumVec16u.
+template<bool isSigned> static int
+sqsumVec16_( const ushort* src, int* sum, double* sqsum, int len, int cn )
+{
+    int j = 0, n = len*cn;
+    __m128i z = _mm_setzero_si128(), s = z, delta = _mm_set1_epi32(isSigned ? 0 : (int)0x80000000);
+    __m128d sq0 = _mm_setzero_pd(), sq1 = sq0;
+    for( ; j <= n - 8; j += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + j)), v0, v1, lo, hi;
+        if( isSigned )
+        {
+            v0 = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            v1 = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            hi = _mm_mulhi_epi16(v, v);
+        }
+        else
+        {
+            v0 = _mm_unpacklo_epi16(v, z);
+            v1 = _mm_unpackhi_epi16(v, z);
+            hi = _mm_mulhi_epu16(v, v);
+        }
+        lo = _mm_mullo_epi16(v, v);
+        s = _mm_add_epi32(s, _mm_add_epi32(v0, v1));
+
+        __m128i p0 = _mm_xor_si128(_mm_unpacklo_epi16(lo, hi), delta);
+        __m128i p1 = _mm_xor_si128(_mm_unpackhi_epi16(lo, hi), delta);
+        sq0 = _mm_add_pd(sq0, _mm_add_pd(_mm_cvtepi32_pd(p0), _mm_cvtepi32_pd(p1)));
+        sq1 = _mm_add_pd(sq1, _mm_add_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(p0, p0)),
+                                         _mm_cvtepi32_pd(_mm_unpackhi_epi64(p1, p1))));
+    }
+    int CV_DECL_ALIGNED(16) sbuf[4];
+    double CV_DECL_ALIGNED(16) sqbuf[4];
+    double bias = isSigned ? 0 : (double)(j/4)*2147483648.;
+    _mm_store_si128((__m128i*)sbuf, s);
+    _mm_store_pd(sqbuf, sq0);
+    _mm_store_pd(sqbuf + 2, sq1);
+    for( int k = 0; k < 4; k++ )
+    {
+        sum[k % cn] += sbuf[k];
+        sqsum[k % cn] += sqbuf[k] + bias;
+    }
+    return j/cn;
+}
+#endif
+
 static int sqsum16u( const ushort* src, const uchar* mask, int* sum, double* sqsum, int len, int cn )
-{ return sumsqr_(src, mask, sum, sqsum, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sqsumVec16_<false>(src, sum, sqsum, len, cn);
+        return i + sumsqr_(src + i*cn, mask, sum, sqsum, len - i, cn);
+    }
+#endif
+    return sumsqr_(src, mask, sum, sqsum, len, cn);
+}
 
 static int sqsum16s( const short* src, const uchar* mask, int* sum, double* sqsum, int len, int cn )
-{ return sumsqr_(src, mask, sum, sqsum, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sqsumVec16_<true>((const ushort*)src, sum, sqsum, len, cn);
+        return i + sumsqr_(src + i*cn, mask, sum, sqsum, len - i, cn);
+    }
+#endif
+    return sumsqr_(src, mask, sum, sqsum, len, cn);
+}
 
 static int sqsum32s( const int* src, const uchar* mask, double* sum, double* sqsum, int len, int cn )
 { return sumsqr_(src, mask, sum, sqsum, len, cn); }
 
+#if CV_SSE2
+// the same lane layout as in sumVec32f
+static int sqsumVec32f( const float* src, double* sum, double* sqsum, int len, int cn )
+{
+    int j = 0, n = len*cn;
+    __m128d s0 = _mm_setzero_pd(), s1 = s0, sq0 = s0, sq1 = s0;
+    for( ; j <= n - 4; j += 4 )
+    {
+        __m128 v = _mm_loadu_ps(src + j);
+        __m128d v0 = _mm_cvtps_pd(v), v1 = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        s0 = _mm_add_pd(s0, v0);
+        s1 = _mm_add_pd(s1, v1);
+        sq0 = _mm_add_pd(sq0, _mm_mul_pd(v0, v0));
+        sq1 = _mm_add_pd(sq1, _mm_mul_pd(v1, v1));
+    }
+    double CV_DECL_ALIGNED(16) buf[8];
+    _mm_store_pd(buf, s0); _mm_store_pd(buf + 2, s1);
+    _mm_store_pd(buf + 4, sq0); _mm_store_pd(buf + 6, sq1);
+    for( int k = 0; k < 4; k++ )
+    {
+        sum[k % cn] += buf[k];
+        sqsum[k % cn] += buf[k + 4];
+    }
+    return j/cn;
+}
+#endif
+
 static int sqsum32f( const float* src, const uchar* mask, double* sum, double* sqsum, int len, int cn )
-{ return sumsqr_(src, mask, sum, sqsum, len, cn); }
+{
+#if CV_SSE2
+    if( USE_SSE2 && !mask && (cn == 1 || cn == 2 || cn == 4) )
+    {
+        int i = sqsumVec32f(src, sum, sqsum, len, cn);
+        return i + sumsqr_(src + i*cn, mask, sum, sqsum, len - i, cn);
+    }
+#endif
+    return sumsqr_(src, mask, sum, sqsum, len, cn);
+}
 
 static int sqsum64f( const double* src, const uchar* mask, double* sum, double* sqsum, int len, int cn )
 { return sumsqr_(src, mask, sum, sqsum, len, cn); }
@@ -434,82 +755,9 @@ static SumSqrFunc sumSqrTab[] =
     (SumSqrFunc)sqsum32s, (SumSqrFunc)GET_OPTIMIZED(sqsum32f), (SumSqrFunc)sqsum64f, 0
 };
 
-}
-
-cv::Scalar cv::sum( InputArray _src )
-{
-    Mat src = _src.getMat();
-    int k, cn = src.channels(), depth = src.depth();
-    SumFunc func = sumTab[depth];
-
-    CV_Assert( cn <= 4 && func != 0 );
-
-    const Mat* arrays[] = {&src, 0};
-    uchar* ptrs[1];
-    NAryMatIterator it(arrays, ptrs);
-    Scalar s;
-    int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0;
-    AutoBuffer<int> _buf;
-    int* buf = (int*)&s[0];
-    size_t esz = 0;
-    bool blockSum = depth < CV_32S;
-
-    if( blockSum )
-    {
-        intSumBlockSize = depth <= CV_8S ? (1 << 23) : (1 << 15);
-        blockSize = std::min(blockSize, intSumBlockSize);
-        _buf.allocate(cn);
-        buf = _buf;
-
-        for( k = 0; k < cn; k++ )
-            buf[k] = 0;
-        esz = src.elemSize();
-    }
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-    {
-        for( j = 0; j < total; j += blockSize )
-        {
-            int bsz = std::min(total - j, blockSize);
-            func( ptrs[0], 0, (uchar*)buf, bsz, cn );
-            count += bsz;
-            if( blockSum && (count + blockSize >= intSumBlockSize || (i+1 >= it.nplanes && j+bsz >= total)) )
-            {
-                for( k = 0; k < cn; k++ )
-                {
-                    s[k] += buf[k];
-                    buf[k] = 0;
-                }
-                count = 0;
-            }
-            ptrs[0] += bsz*esz;
-        }
-    }
-    return s;
-}
-
-int cv::countNonZero( InputArray _src )
-{
-    Mat src = _src.getMat();
-    CountNonZeroFunc func = countNonZeroTab[src.depth()];
-
-    CV_Assert( src.channels() == 1 && func != 0 );
-
-    const Mat* arrays[] = {&src, 0};
-    uchar* ptrs[1];
-    NAryMatIterator it(arrays, ptrs);
-    int total = (int)it.size, nz = 0;
-
-    for( size_t i = 0; i < it.nplanes; i++, ++it )
-        nz += func( ptrs[0], total );
-
-    return nz;
-}
-
-cv::Scalar cv::mean( InputArray _src, InputArray _mask )
+// sums the elements of the (masked) matrix; returns the number of the summed pixels
+static size_t sumMasked( const Mat& src, const Mat& mask, Scalar& s )
 {
-    Mat src = _src.getMat(), mask = _mask.getMat();
     CV_Assert( mask.empty() || mask.type() == CV_8U );
 
     int k, cn = src.channels(), depth = src.depth();
@@ -520,7 +768,6 @@ cv::Scalar cv::mean( InputArray _src, InputArray _mask )
     const Mat* arrays[] = {&src, &mask, 0};
     uchar* ptrs[2];
     NAryMatIterator it(arrays, ptrs);
-    Scalar s;
     int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
     int j, count = 0;
     AutoBuffer<int> _buf;
@@ -562,13 +809,13 @@ cv::Scalar cv::mean( InputArray _src, InputArray _mask )
                 ptrs[1] += bsz;
         }
     }
-    return s*(nz0 ? 1./nz0 : 0);
+    return nz0;
 }
 
-
-void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray _mask )
+// computes the per-channel sums and sums of squares of the elements of the (masked) matrix;
+// returns the number of the summed pixels
+static size_t sumSqrMasked( const Mat& src, const Mat& mask, double* s, double* sq )
 {
-    Mat src = _src.getMat(), mask = _mask.getMat();
     CV_Assert( mask.empty() || mask.type() == CV_8U );
 
     int k, cn = src.channels(), depth = src.depth();
@@ -580,9 +827,9 @@ void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, Input
     uchar* ptrs[2];
     NAryMatIterator it(arrays, ptrs);
     int total = (int)it.size, blockSize = total, intSumBlockSize = 0;
-    int j, count = 0, nz0 = 0;
-    AutoBuffer<double> _buf(cn*4);
-    double *s = (double*)_buf, *sq = s + cn;
+    int j, count = 0;
+    size_t nz0 = 0;
+    AutoBuffer<int> _buf;
     int *sbuf = (int*)s, *sqbuf = (int*)sq;
     bool blockSum = depth <= CV_16S, blockSqSum = depth <= CV_8S;
     size_t esz = 0;
@@ -594,7 +841,8 @@ void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, Input
     {
         intSumBlockSize = 1 << 15;
         blockSize = std::min(blockSize, intSumBlockSize);
-        sbuf = (int*)(sq + cn);
+        _buf.allocate(cn*2);
+        sbuf = _buf;
         if( blockSqSum )
             sqbuf = sbuf + cn;
         for( k = 0; k < cn; k++ )
@@ -632,8 +880,143 @@ void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, Input
                 ptrs[1] += bsz;
         }
     }
+    return nz0;
+}
+
+struct StatSums
+{
+    StatSums() : nz(0) {}
+    Scalar s, sq;
+    size_t nz;
+};
+
+struct SumStripe
+{
+    typedef StatSums result_type;
+
+    SumStripe( const Mat& _src, const Mat& _mask, bool _sqr ) : src(&_src), mask(&_mask), sqr(_sqr) {}
+
+    StatSums operator()( int y0, int y1 ) const
+    {
+        StatSums r;
+        Mat srcStripe = src->rowRange(y0, y1), maskStripe = statStripe(*mask, y0, y1);
+        r.nz = sqr ? sumSqrMasked(srcStripe, maskStripe, r.s.val, r.sq.val) :
+                     sumMasked(srcStripe, maskStripe, r.s);
+        return r;
+    }
+
+    const Mat* src;
+    const Mat* mask;
+    bool sqr;
+};
+
+// sums the elements (and their squares if sqr is set) of a matrix with up to 4 channels by stripes
+static size_t sumStripes( const Mat& src, const Mat& mask, bool sqr, int stripeRows, Scalar& s, Scalar& sq )
+{
+    CV_Assert( src.channels() <= 4 && (mask.empty() || mask.size == src.size) );
+
+    AutoBuffer<StatSums> partials;
+    int nstripes = statStripes(SumStripe(src, mask, sqr), src.rows, stripeRows, partials);
+    size_t nz = 0;
+
+    for( int i = 0; i < nstripes; i++ )
+    {
+        s += partials[i].s;
+        sq += partials[i].sq;
+        nz += partials[i].nz;
+    }
+    return nz;
+}
+
+struct CountNonZeroStripe
+{
+    typedef int result_type;
+
+    CountNonZeroStripe( const Mat& _src ) : src(&_src) {}
+
+    int operator()( int y0, int y1 ) const { return countNonZero(src->rowRange(y0, y1)); }
+
+    const Mat* src;
+};
+
+}
+
+cv::Scalar cv::sum( InputArray _src )
+{
+    Mat src = _src.getMat();
+    Scalar s, sq;
+    int stripeRows = statStripeRows(src);
+
+    if( stripeRows > 0 )
+        sumStripes(src, Mat(), false, stripeRows, s, sq);
+    else
+        sumMasked(src, Mat(), s);
+    return s;
+}
+
+int cv::countNonZero( InputArray _src )
+{
+    Mat src = _src.getMat();
+    CountNonZeroFunc func = countNonZeroTab[src.depth()];
+
+    CV_Assert( src.channels() == 1 && func != 0 );
+
+    int stripeRows = statStripeRows(src);
+    if( stripeRows > 0 )
+    {
+        AutoBuffer<int> partials;
+        int nstripes = statStripes(CountNonZeroStripe(src), src.rows, stripeRows, partials);
+        int nz = 0;
+        for( int i = 0; i < nstripes; i++ )
+            nz += partials[i];
+        return nz;
+    }
+
+    const Mat* arrays[] = {&src, 0};
+    uchar* ptrs[1];
+    NAryMatIterator it(arrays, ptrs);
+    int total = (int)it.size, nz = 0;
+
+    for( size_t i = 0; i < it.nplanes; i++, ++it )
+        nz += func( ptrs[0], total );
+
+    return nz;
+}
+
+cv::Scalar cv::mean( InputArray _src, InputArray _mask )
+{
+    Mat src = _src.getMat(), mask = _mask.getMat();
+    Scalar s, sq;
+    int stripeRows = statStripeRows(src);
+    size_t nz = stripeRows > 0 ? sumStripes(src, mask, false, stripeRows, s, sq) : sumMasked(src, mask, s);
+
+    return s*(nz ? 1./nz : 0);
+}
+
+
+void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, InputArray _mask )
+{
+    Mat src = _src.getMat(), mask = _mask.getMat();
+    int j, k, cn = src.channels();
+    AutoBuffer<double> _buf(cn*2);
+    double *s = (double*)_buf, *sq = s + cn;
+    int stripeRows = cn <= 4 ? statStripeRows(src) : 0;
+    size_t nz;
+
+    if( stripeRows > 0 )
+    {
+        Scalar ssum, sqsum;
+        nz = sumStripes(src, mask, true, stripeRows, ssum, sqsum);
+        for( k = 0; k < cn; k++ )
+        {
+            s[k] = ssum[k];
+            sq[k] = sqsum[k];
+        }
+    }
+    else
+        nz = sumSqrMasked(src, mask, s, sq);
 
-    double scale = nz0 ? 1./nz0 : 0.;
+    double scale = nz ? 1./nz : 0.;
     for( k = 0; k < cn; k++ )
     {
         s[k] *= scale;
@@ -668,14 +1051,185 @@ void cv::meanStdDev( InputArray _src, OutputArray _mean, OutputArray _sdv, Input
 namespace cv
 {
 
+// Finds the minimum and the maximum of the array with SIMD instructions (NaNs are skipped
+// like in the scalar loop); returns false if the type is not supported or SIMD is not available.
+template<typename T> static inline bool minMaxVec_( const T*, int, T&, T& ) { return false; }
+
+#if CV_SSE2
+template<typename T> static inline void minMaxTail_( const T* src, int i, int len, T& minVal, T& maxVal )
+{
+    for( ; i < len; i++ )
+    {
+        T val = src[i];
+        if( val < minVal )
+            minVal = val;
+        if( val > maxVal )
+            maxVal = val;
+    }
+}
+
+static bool minMaxVec_( const uchar* src, int len, uchar& minVal, uchar& maxVal )
+{
+    if( !USE_SSE2 || len < 16 )
+        return false;
+    int i = 0;
+    __m128i vmin = _mm_set1_epi8(-1), vmax = _mm_setzero_si128();
+    for( ; i <= len - 16; i += 16 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        vmin = _mm_min_epu8(vmin, v);
+        vmax = _mm_max_epu8(vmax, v);
+    }
+    uchar CV_DECL_ALIGNED(16) bmin[16], bmax[16];
+    _mm_store_si128((__m128i*)bmin, vmin);
+    _mm_store_si128((__m128i*)bmax, vmax);
+    minVal = UCHAR_MAX; maxVal = 0;
+    minMaxTail_(bmin, 0, 16, minVal, maxVal);
+    minMaxTail_(bmax, 0, 16, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+
+static bool minMaxVec_( const schar* src, int len, schar& minVal, schar& maxVal )
+{
+    if( !USE_SSE2 || len < 16 )
+        return false;
+    int i = 0;
+    __m128i delta = _mm_set1_epi8((char)0x80), vmin = _mm_set1_epi8(-1), vmax = _mm_setzero_si128();
+    for( ; i <= len - 16; i += 16 )
+    {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), delta);
+        vmin = _mm_min_epu8(vmin, v);
+        vmax = _mm_max_epu8(vmax, v);
+    }
+    schar CV_DECL_ALIGNED(16) bmin[16], bmax[16];
+    _mm_store_si128((__m128i*)bmin, _mm_xor_si128(vmin, delta));
+    _mm_store_si128((__m128i*)bmax, _mm_xor_si128(vmax, delta));
+    minVal = SCHAR_MAX; maxVal = SCHAR_MIN;
+    minMaxTail_(bmin, 0, 16, minVal, maxVal);
+    minMaxTail_(bmax, 0, 16, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+
+static bool minMaxVec_( const ushort* src, int len, ushort& minVal, ushort& maxVal )
+{
+    if( !USE_SSE2 || len < 8 )
+        return false;
+    int i = 0;
+    __m128i delta = _mm_set1_epi16((short)0x8000), vmin = _mm_set1_epi16(SHRT_MAX), vmax = _mm_set1_epi16(SHRT_MIN);
+    for( ; i <= len - 8; i += 8 )
+    {
+        __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), delta);
+        vmin = _mm_min_epi16(vmin, v);
+        vmax = _mm_max_epi16(vmax, v);
+    }
+    ushort CV_DECL_ALIGNED(16) bmin[8], bmax[8];
+    _mm_store_si128((__m128i*)bmin, _mm_xor_si128(vmin, delta));
+    _mm_store_si128((__m128i*)bmax, _mm_xor_si128(vmax, delta));
+    minVal = USHRT_MAX; maxVal = 0;
+    minMaxTail_(bmin, 0, 8, minVal, maxVal);
+    minMaxTail_(bmax, 0, 8, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+
+static bool minMaxVec_( const short* src, int len, short& minVal, short& maxVal )
+{
+    if( !USE_SSE2 || len < 8 )
+        return false;
+    int i = 0;
+    __m128i vmin = _mm_set1_epi16(SHRT_MAX), vmax = _mm_set1_epi16(SHRT_MIN);
+    for( ; i <= len - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        vmin = _mm_min_epi16(vmin, v);
+        vmax = _mm_max_epi16(vmax, v);
+    }
+    short CV_DECL_ALIGNED(16) bmin[8], bmax[8];
+    _mm_store_si128((__m128i*)bmin, vmin);
+    _mm_store_si128((__m128i*)bmax, vmax);
+    minVal = SHRT_MAX; maxVal = SHRT_MIN;
+    minMaxTail_(bmin, 0, 8, minVal, maxVal);
+    minMaxTail_(bmax, 0, 8, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+
+static bool minMaxVec_( const float* src, int len, float& minVal, float& maxVal )
+{
+    if( !USE_SSE2 || len < 8 )
+        return false;
+    int i = 0;
+    __m128 vmin = _mm_set1_ps(FLT_MAX), vmax = _mm_set1_ps(-FLT_MAX);
+    for( ; i <= len - 4; i += 4 )
+    {
+        // minps/maxps return the second operand if any of them is NaN
+        __m128 v = _mm_loadu_ps(src + i);
+        vmin = _mm_min_ps(v, vmin);
+        vmax = _mm_max_ps(v, vmax);
+    }
+    float CV_DECL_ALIGNED(16) bmin[4], bmax[4];
+    _mm_store_ps(bmin, vmin);
+    _mm_store_ps(bmax, vmax);
+    minVal = FLT_MAX; maxVal = -FLT_MAX;
+    minMaxTail_(bmin, 0, 4, minVal, maxVal);
+    minMaxTail_(bmax, 0, 4, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+
+static bool minMaxVec_( const double* src, int len, double& minVal, double& maxVal )
+{
+    if( !USE_SSE2 || len < 4 )
+        return false;
+    int i = 0;
+    __m128d vmin = _mm_set1_pd(DBL_MAX), vmax = _mm_set1_pd(-DBL_MAX);
+    for( ; i <= len - 2; i += 2 )
+    {
+        __m128d v = _mm_loadu_pd(src + i);
+        vmin = _mm_min_pd(v, vmin);
+        vmax = _mm_max_pd(v, vmax);
+    }
+    double CV_DECL_ALIGNED(16) bmin[2], bmax[2];
+    _mm_store_pd(bmin, vmin);
+    _mm_store_pd(bmax, vmax);
+    minVal = DBL_MAX; maxVal = -DBL_MAX;
+    minMaxTail_(bmin, 0, 2, minVal, maxVal);
+    minMaxTail_(bmax, 0, 2, minVal, maxVal);
+    minMaxTail_(src, i, len, minVal, maxVal);
+    return true;
+}
+#endif
+
 template<typename T, typename WT> static void
 minMaxIdx_( const T* src, const uchar* mask, WT* _minVal, WT* _maxVal,
             size_t* _minIdx, size_t* _maxIdx, int len, size_t startIdx )
 {
     WT minVal = *_minVal, maxVal = *_maxVal;
     size_t minIdx = *_minIdx, maxIdx = *_maxIdx;
+    T vmin, vmax;
 
-    if( !mask )
+    if( !mask && minMaxVec_(src, len, vmin, vmax) )
+    {
+        // the extremes are found, now locate their first occurrences
+        int i;
+        if( vmin < minVal )
+        {
+            for( i = 0; !(src[i] == vmin); i++ )
+                ;
+            minVal = src[i];
+            minIdx = startIdx + i;
+        }
+        if( vmax > maxVal )
+        {
+            for( i = 0; !(src[i] == vmax); i++ )
+                ;
+            maxVal = src[i];
+            maxIdx = startIdx + i;
+        }
+    }
+    else if( !mask )
     {
         for( int i = 0; i < len; i++ )
         {
@@ -775,6 +1329,33 @@ static void ofs2idx(const Mat& a, size_t ofs, int* idx)
     }
 }
 
+struct MinMaxPartial
+{
+    double minVal, maxVal;
+    int minIdx[2], maxIdx[2];
+};
+
+struct MinMaxStripe
+{
+    typedef MinMaxPartial result_type;
+
+    MinMaxStripe( const Mat& _src, const Mat& _mask ) : src(&_src), mask(&_mask) {}
+
+    // multi-channel arrays are processed as single-channel ones, so the locations are always available
+    MinMaxPartial operator()( int y0, int y1 ) const
+    {
+        MinMaxPartial r;
+        minMaxIdx(src->rowRange(y0, y1).reshape(1), &r.minVal, &r.maxVal, r.minIdx, r.maxIdx,
+                  statStripe(*mask, y0, y1));
+        r.minIdx[0] += y0;
+        r.maxIdx[0] += y0;
+        return r;
+    }
+
+    const Mat* src;
+    const Mat* mask;
+};
+
 }
 
 void cv::minMaxIdx(InputArray _src, double* minVal,
@@ -789,6 +1370,45 @@ void cv::minMaxIdx(InputArray _src, double* minVal,
     MinMaxIdxFunc func = minmaxTab[depth];
     CV_Assert( func != 0 );
 
+    int stripeRows = statStripeRows(src);
+    if( stripeRows > 0 )
+    {
+        CV_Assert( mask.empty() || mask.size == src.size );
+
+        AutoBuffer<MinMaxPartial> partials;
+        int nstripes = statStripes(MinMaxStripe(src, mask), src.rows, stripeRows, partials);
+        const MinMaxPartial *pmin = 0, *pmax = 0;
+
+        // the strict comparisons keep the first occurrences, like in the sequential scan;
+        // the stripes without pixels to check have negative locations
+        for( int i = 0; i < nstripes; i++ )
+        {
+            const MinMaxPartial& p = partials[i];
+            if( p.minIdx[1] < 0 )
+                continue;
+            if( !pmin || p.minVal < pmin->minVal )
+                pmin = &p;
+            if( !pmax || p.maxVal > pmax->maxVal )
+                pmax = &p;
+        }
+
+        if( minVal )
+            *minVal = pmin ? pmin->minVal : 0;
+        if( maxVal )
+            *maxVal = pmax ? pmax->maxVal : 0;
+        if( minIdx )
+        {
+            minIdx[0] = pmin ? pmin->minIdx[0] : -1;
+            minIdx[1] = pmin ? pmin->minIdx[1] : -1;
+        }
+        if( maxIdx )
+        {
+            maxIdx[0] = pmax ? pmax->maxIdx[0] : -1;
+            maxIdx[1] = pmax ? pmax->maxIdx[1] : -1;
+        }
+        return;
+    }
+
     const Mat* arrays[] = {&src, &mask, 0};
     uchar* ptrs[2];
     NAryMatIterator it(arrays, ptrs);
@@ -1094,13 +1714,194 @@ int normHamming(const uchar* a, const uchar* b, int n, int cellSize)
 }
 
 
+// The vectorized parts of the unmasked norms. They update the result and return the number
+// of the processed elements; the rest is processed by the inline norms from base.hpp.
+template<typename T, typename ST> static inline int normInfVec_( const T*, int, ST& ) { return 0; }
+template<typename T, typename ST> static inline int normL1Vec_( const T*, int, ST& ) { return 0; }
+template<typename T, typename ST> static inline int normL2Vec_( const T*, int, ST& ) { return 0; }
+
+#if CV_SSE2
+static inline int hsum_epi32( __m128i v )
+{
+    int CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_si128((__m128i*)buf, v);
+    return buf[0] + buf[1] + buf[2] + buf[3];
+}
+
+static inline double hsum_pd( __m128d v )
+{
+    double CV_DECL_ALIGNED(16) buf[2];
+    _mm_store_pd(buf, v);
+    return buf[0] + buf[1];
+}
+
+static int normInfVec_( const ushort* src, int n, int& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128i delta = _mm_set1_epi16((short)0x8000), vmax = _mm_set1_epi16(SHRT_MIN);
+    for( ; i <= n - 8; i += 8 )
+        vmax = _mm_max_epi16(vmax, _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i)), delta));
+    ushort CV_DECL_ALIGNED(16) buf[8];
+    _mm_store_si128((__m128i*)buf, _mm_xor_si128(vmax, delta));
+    for( int k = 0; k < 8; k++ )
+        result = std::max(result, (int)buf[k]);
+    return i;
+}
+
+static int normInfVec_( const short* src, int n, int& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128i vmin = _mm_setzero_si128(), vmax = vmin;
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        vmin = _mm_min_epi16(vmin, v);
+        vmax = _mm_max_epi16(vmax, v);
+    }
+    short CV_DECL_ALIGNED(16) bmin[8], bmax[8];
+    _mm_store_si128((__m128i*)bmin, vmin);
+    _mm_store_si128((__m128i*)bmax, vmax);
+    for( int k = 0; k < 8; k++ )
+        result = std::max(result, std::max(-(int)bmin[k], (int)bmax[k]));
+    return i;
+}
+
+static int normInfVec_( const float* src, int n, float& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)), vmax = _mm_setzero_ps();
+    for( ; i <= n - 4; i += 4 )
+        vmax = _mm_max_ps(_mm_and_ps(_mm_loadu_ps(src + i), absmask), vmax); // skips NaNs
+    float CV_DECL_ALIGNED(16) buf[4];
+    _mm_store_ps(buf, vmax);
+    for( int k = 0; k < 4; k++ )
+        result = std::max(result, buf[k]);
+    return i;
+}
+
+static int normL1Vec_( const ushort* src, int n, int& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128i z = _mm_setzero_si128(), s = z;
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        s = _mm_add_epi32(s, _mm_add_epi32(_mm_unpacklo_epi16(v, z), _mm_unpackhi_epi16(v, z)));
+    }
+    result += hsum_epi32(s);
+    return i;
+}
+
+static int normL1Vec_( const short* src, int n, int& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128i s = _mm_setzero_si128();
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i v0 = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16), v1 = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        __m128i m0 = _mm_srai_epi32(v0, 31), m1 = _mm_srai_epi32(v1, 31);
+        v0 = _mm_sub_epi32(_mm_xor_si128(v0, m0), m0);
+        v1 = _mm_sub_epi32(_mm_xor_si128(v1, m1), m1);
+        s = _mm_add_epi32(s, _mm_add_epi32(v0, v1));
+    }
+    result += hsum_epi32(s);
+    return i;
+}
+
+static int normL1Vec_( const float* src, int n, double& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128d s0 = _mm_setzero_pd(), s1 = s0;
+    for( ; i <= n - 4; i += 4 )
+    {
+        __m128 v = _mm_and_ps(_mm_loadu_ps(src + i), absmask);
+        s0 = _mm_add_pd(s0, _mm_cvtps_pd(v));
+        s1 = _mm_add_pd(s1, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    result += hsum_pd(_mm_add_pd(s0, s1));
+    return i;
+}
+
+// the squares of 16-bit values are computed exactly as 32-bit integers and accumulated as doubles
+static int normL2Vec_( const ushort* src, int n, double& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128i delta = _mm_set1_epi32((int)0x80000000);
+    __m128d s0 = _mm_setzero_pd(), s1 = s0;
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_mullo_epi16(v, v), hi = _mm_mulhi_epu16(v, v);
+        // the unsigned squares are biased by -2^31 to be converted as signed integers
+        __m128i p0 = _mm_xor_si128(_mm_unpacklo_epi16(lo, hi), delta);
+        __m128i p1 = _mm_xor_si128(_mm_unpackhi_epi16(lo, hi), delta);
+        s0 = _mm_add_pd(s0, _mm_add_pd(_mm_cvtepi32_pd(p0), _mm_cvtepi32_pd(_mm_unpackhi_epi64(p0, p0))));
+        s1 = _mm_add_pd(s1, _mm_add_pd(_mm_cvtepi32_pd(p1), _mm_cvtepi32_pd(_mm_unpackhi_epi64(p1, p1))));
+    }
+    result += hsum_pd(_mm_add_pd(s0, s1)) + (double)i*2147483648.;
+    return i;
+}
+
+static int normL2Vec_( const short* src, int n, double& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128d s0 = _mm_setzero_pd(), s1 = s0;
+    for( ; i <= n - 8; i += 8 )
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_mullo_epi16(v, v), hi = _mm_mulhi_epi16(v, v);
+        __m128i p0 = _mm_unpacklo_epi16(lo, hi), p1 = _mm_unpackhi_epi16(lo, hi);
+        s0 = _mm_add_pd(s0, _mm_add_pd(_mm_cvtepi32_pd(p0), _mm_cvtepi32_pd(_mm_unpackhi_epi64(p0, p0))));
+        s1 = _mm_add_pd(s1, _mm_add_pd(_mm_cvtepi32_pd(p1), _mm_cvtepi32_pd(_mm_unpackhi_epi64(p1, p1))));
+    }
+    result += hsum_pd(_mm_add_pd(s0, s1));
+    return i;
+}
+
+static int normL2Vec_( const float* src, int n, double& result )
+{
+    if( !USE_SSE2 )
+        return 0;
+    int i = 0;
+    __m128d s0 = _mm_setzero_pd(), s1 = s0;
+    for( ; i <= n - 4; i += 4 )
+    {
+        __m128 v = _mm_loadu_ps(src + i);
+        __m128d v0 = _mm_cvtps_pd(v), v1 = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        s0 = _mm_add_pd(s0, _mm_mul_pd(v0, v0));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(v1, v1));
+    }
+    result += hsum_pd(_mm_add_pd(s0, s1));
+    return i;
+}
+#endif
+
 template<typename T, typename ST> int
 normInf_(const T* src, const uchar* mask, ST* _result, int len, int cn)
 {
     ST result = *_result;
     if( !mask )
     {
-        result = std::max(result, normInf<T, ST>(src, len*cn));
+        int i = normInfVec_(src, len*cn, result);
+        result = std::max(result, normInf<T, ST>(src + i, len*cn - i));
     }
     else
     {
@@ -1121,7 +1922,8 @@ normL1_(const T* src, const uchar* mask, ST* _result, int len, int cn)
     ST result = *_result;
     if( !mask )
     {
-        result += normL1<T, ST>(src, len*cn);
+        int i = normL1Vec_(src, len*cn, result);
+        result += normL1<T, ST>(src + i, len*cn - i);
     }
     else
     {
@@ -1142,7 +1944,8 @@ normL2_(const T* src, const uchar* mask, ST* _result, int len, int cn)
     ST result = *_result;
     if( !mask )
     {
-        result += normL2Sqr<T, ST>(src, len*cn);
+        int i = normL2Vec_(src, len*cn, result);
+        result += normL2Sqr<T, ST>(src + i, len*cn - i);
     }
     else
     {
@@ -1289,6 +2092,40 @@ static NormDiffFunc normDiffTab[3][8] =
     }
 };
 
+// the partial norms of the stripes: NORM_L2 is computed as NORM_L2SQR, the others as is
+struct NormStripe
+{
+    typedef double result_type;
+
+    NormStripe( const Mat& _src1, const Mat* _src2, const Mat& _mask, int _normType )
+        : src1(&_src1), src2(_src2), mask(&_mask), normType(_normType == NORM_L2 ? NORM_L2SQR : _normType) {}
+
+    double operator()( int y0, int y1 ) const
+    {
+        Mat maskStripe = statStripe(*mask, y0, y1);
+        return src2 ? norm(src1->rowRange(y0, y1), src2->rowRange(y0, y1), normType, maskStripe) :
+                      norm(src1->rowRange(y0, y1), normType, maskStripe);
+    }
+
+    const Mat* src1;
+    const Mat* src2;
+    const Mat* mask;
+    int normType;
+};
+
+static double normStripes( const Mat& src1, const Mat* src2, const Mat& mask, int normType, int stripeRows )
+{
+    CV_Assert( mask.empty() || mask.size == src1.size );
+
+    AutoBuffer<double> partials;
+    int nstripes = statStripes(NormStripe(src1, src2, mask, normType), src1.rows, stripeRows, partials);
+    double result = 0;
+
+    for( int i = 0; i < nstripes; i++ )
+        result = normType == NORM_INF ? std::max(result, partials[i]) : result + partials[i];
+    return normType == NORM_L2 ? std::sqrt(result) : result;
+}
+
 }
 
 double cv::norm( InputArray _src, int normType, InputArray _mask )
@@ -1300,6 +2137,10 @@ double cv::norm( InputArray _src, int normType, InputArray _mask )
     CV_Assert( normType == NORM_INF || normType == NORM_L1 || normType == NORM_L2 || normType == NORM_L2SQR ||
                ((normType == NORM_HAMMING || normType == NORM_HAMMING2) && src.type() == CV_8U) );
 
+    int stripeRows = statStripeRows(src);
+    if( stripeRows > 0 )
+        return normStripes(src, 0, mask, normType, stripeRows);
+
     if( src.isContinuous() && mask.empty() )
     {
         size_t len = src.total()*cn;
@@ -1449,6 +2290,10 @@ double cv::norm( InputArray _src1, InputArray _src2, int normType, InputArray _m
     CV_Assert( normType == NORM_INF || normType == NORM_L1 || normType == NORM_L2 || normType == NORM_L2SQR ||
               ((normType == NORM_HAMMING || normType == NORM_HAMMING2) && src1.type() == CV_8U) );
 
+    int stripeRows = statStripeRows(src1);
+    if( stripeRows > 0 )
+        return normStripes(src1, &src2, mask, normType, stripeRows);
+
     if( src1.isContinuous() && src2.isContinuous() && mask.empty() )
     {
         size_t len = src1.total()*src1.channels();
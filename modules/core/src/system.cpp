@@ -134,6 +134,50 @@ void Exception::formatMessage()
         msg = format("%s:%d: error: (%d) %s\n", file.c_str(), line, code, err.c_str());
 }
 
+// returns the cpuid leaf/subleaf registers, or zeros when the leaf is not supported
+static void cpuidEx(int* cpuid_data, int leaf, int subleaf)
+{
+    cpuid_data[0] = cpuid_data[1] = cpuid_data[2] = cpuid_data[3] = 0;
+#if defined _MSC_VER && _MSC_VER >= 1500 && (defined _M_IX86 || defined _M_X64)
+    __cpuidex(cpuid_data, leaf, subleaf);
+#elif defined __GNUC__ && defined __x86_64__
+    asm __volatile__
+    (
+     "cpuid\n\t"
+     : "=a"(cpuid_data[0]), "=b"(cpuid_data[1]), "=c"(cpuid_data[2]), "=d"(cpuid_data[3])
+     : "a"(leaf), "c"(subleaf)
+     : "cc"
+    );
+#elif defined __GNUC__ && defined __i386__
+    asm volatile
+    (
+     "movl %%ebx, %%esi\n\t"
+     "cpuid\n\t"
+     "xchgl %%ebx, %%esi\n\t"
+     : "=a"(cpuid_data[0]), "=S"(cpuid_data[1]), "=c"(cpuid_data[2]), "=d"(cpuid_data[3])
+     : "a"(leaf), "c"(subleaf)
+     : "cc"
+    );
+#else
+    (void)leaf; (void)subleaf;
+#endif
+}
+
+// returns XCR0, i.e. the register state saved by the OS; must be called only when OSXSAVE is set
+static int64 xgetbv0()
+{
+#if defined _MSC_FULL_VER && _MSC_FULL_VER >= 160040219 && (defined _M_IX86 || defined _M_X64)
+    return (int64)_xgetbv(0);
+#elif defined __GNUC__ && (defined __i386__ || defined __x86_64__)
+    unsigned lo = 0, hi = 0;
+    // xgetbv, encoded explicitly for the old assemblers
+    asm volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((int64)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
 struct HWFeatures
 {
     enum { MAX_FEATURE = CV_HARDWARE_MAX_FEATURE };
@@ -187,6 +231,24 @@ struct HWFeatures
             f.have[CV_CPU_SSE4_2] = (cpuid_data[2] & (1<<20)) != 0;
             f.have[CV_CPU_POPCNT] = (cpuid_data[2] & (1<<23)) != 0;
             f.have[CV_CPU_AVX]    = (((cpuid_data[2] & (1<<28)) != 0)&&((cpuid_data[2] & (1<<27)) != 0));//OS uses XSAVE_XRSTORE and CPU support AVX
+
+            if( f.have[CV_CPU_AVX] )
+            {
+                // the wider registers are usable only if the OS saves them on the context switch:
+                // XCR0 bits 1-2 are SSE/AVX state, bits 5-7 are the AVX-512 opmask and ZMM state
+                int64 xcr0 = xgetbv0();
+                int cpuid_data7[4];
+                cpuidEx(cpuid_data7, 0, 0);
+                if( cpuid_data7[0] >= 7 )
+                    cpuidEx(cpuid_data7, 7, 0);
+                else
+                    cpuid_data7[1] = 0;
+
+                bool os_ymm = (xcr0 & 0x06) == 0x06, os_zmm = (xcr0 & 0xe6) == 0xe6;
+                f.have[CV_CPU_AVX2]      = os_ymm && (cpuid_data7[1] & (1<<5)) != 0;
+                f.have[CV_CPU_AVX_512F]  = os_zmm && (cpuid_data7[1] & (1<<16)) != 0;
+                f.have[CV_CPU_AVX_512BW] = os_zmm && (cpuid_data7[1] & (1<<30)) != 0;
+            }
         }
 
         return f;
@@ -220,11 +282,28 @@ volatile bool USE_SSE2 = featuresEnabled.have[CV_CPU_SSE2];
 volatile bool USE_SSE4_2 = featuresEnabled.have[CV_CPU_SSE4_2];
 volatile bool USE_AVX = featuresEnabled.have[CV_CPU_AVX];
 
+static const SIMDKernels* selectSIMDKernels(const HWFeatures& f)
+{
+#ifdef HAVE_AVX512_DISPATCH
+    if( f.have[CV_CPU_AVX_512F] && f.have[CV_CPU_AVX_512BW] )
+        return getSIMDKernelsAVX512();
+#endif
+#ifdef HAVE_AVX2_DISPATCH
+    if( f.have[CV_CPU_AVX2] )
+        return getSIMDKernelsAVX2();
+#endif
+    (void)f;
+    return 0;
+}
+
+const SIMDKernels* volatile currentSIMDKernels = selectSIMDKernels(featuresEnabled);
+
 void setUseOptimized( bool flag )
 {
     useOptimizedFlag = flag;
     currentFeatures = flag ? &featuresEnabled : &featuresDisabled;
     USE_SSE2 = currentFeatures->have[CV_CPU_SSE2];
+    currentSIMDKernels = selectSIMDKernels(*currentFeatures);
 }
 
 bool useOptimized(void)
@@ -685,6 +764,8 @@ BOOL WINAPI DllMain( HINSTANCE, DWORD  fdwReason, LPVOID )
     if( fdwReason == DLL_THREAD_DETACH || fdwReason == DLL_PROCESS_DETACH )
     {
         cv::deleteThreadAllocData();
+        cv::deleteThreadPoolData();
+        cv::deleteThreadScratchData();
         cv::deleteThreadRNGData();
     }
     return TRUE;
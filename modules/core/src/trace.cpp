@@ -0,0 +1,385 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                           License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000-2008, Intel Corporation, all rights reserved.
+// Copyright (C) 2009-2011, Willow Garage Inc., all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of the copyright holders may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "precomp.hpp"
+#include <map>
+
+#if defined WIN32 || defined _WIN32 || defined WINCE
+#  include <windows.h>
+#  undef small
+#  undef min
+#  undef max
+#  undef abs
+#else
+#  include <pthread.h>
+#endif
+
+namespace cv
+{
+
+// the collection itself is always built, so that the user code can record its own regions;
+// HAVE_TRACE only adds the instrumentation of the library functions (see CV_TRACE_REGION)
+
+enum { TRACE_REGION = 0, TRACE_COUNTER = 1 };
+
+// the per-thread buffers are never shrunk below this limit; the events above it are dropped
+enum { TRACE_MAX_THREAD_EVENTS = 1 << 22 };
+
+struct TraceEvent
+{
+    const char* name;
+    int64 start;
+    int64 value; // the duration of a region, in ticks, or the value of a counter
+    int type;
+};
+
+struct TraceThreadBuffer
+{
+    TraceThreadBuffer(int _tid) : tid(_tid), dropped(0) {}
+
+    // the lock is almost never contended: only resetTrace() and writeTrace() take it from other threads
+    void add( const char* name, int64 start, int64 value, int type )
+    {
+        AutoLock lock(mutex);
+        if( events.size() >= (size_t)TRACE_MAX_THREAD_EVENTS )
+        {
+            dropped++;
+            return;
+        }
+        TraceEvent e = { name, start, value, type };
+        events.push_back(e);
+    }
+
+    int tid;
+    size_t dropped;
+    std::vector<TraceEvent> events;
+    Mutex mutex;
+};
+
+// the buffers stay registered after their threads exit, so that their events can be written
+struct TraceStorage
+{
+    TraceStorage() : origin(getTickCount()) {}
+
+    TraceThreadBuffer* addThread()
+    {
+        AutoLock lock(mutex);
+        TraceThreadBuffer* buf = new TraceThreadBuffer((int)buffers.size());
+        buffers.push_back(buf);
+        return buf;
+    }
+
+    Mutex mutex;
+    std::vector<TraceThreadBuffer*> buffers;
+    int64 origin;
+};
+
+static TraceStorage& getTraceStorage()
+{
+    static TraceStorage* storage = new TraceStorage;
+    return *storage;
+}
+
+static volatile bool traceOn = false;
+
+#if defined WIN32 || defined _WIN32
+
+static DWORD tlsTraceKey = TLS_OUT_OF_INDEXES;
+
+static TraceThreadBuffer* getTraceThreadBuffer()
+{
+    if( tlsTraceKey == TLS_OUT_OF_INDEXES )
+    {
+        // the first threads may get here simultaneously; only one of the allocated keys is kept
+        DWORD key = TlsAlloc();
+        CV_Assert(key != TLS_OUT_OF_INDEXES);
+        if( InterlockedCompareExchange((LONG volatile*)&tlsTraceKey, (LONG)key,
+                                       (LONG)TLS_OUT_OF_INDEXES) != (LONG)TLS_OUT_OF_INDEXES )
+            TlsFree(key);
+    }
+    TraceThreadBuffer* buf = (TraceThreadBuffer*)TlsGetValue(tlsTraceKey);
+    if( !buf )
+    {
+        buf = getTraceStorage().addThread();
+        TlsSetValue(tlsTraceKey, buf);
+    }
+    return buf;
+}
+
+#else
+
+static pthread_key_t tlsTraceKey = 0;
+static pthread_once_t tlsTraceKeyOnce = PTHREAD_ONCE_INIT;
+
+static void makeTraceKey()
+{
+    int errcode = pthread_key_create(&tlsTraceKey, 0);
+    CV_Assert(errcode == 0);
+}
+
+static TraceThreadBuffer* getTraceThreadBuffer()
+{
+    pthread_once(&tlsTraceKeyOnce, makeTraceKey);
+    TraceThreadBuffer* buf = (TraceThreadBuffer*)pthread_getspecific(tlsTraceKey);
+    if( !buf )
+    {
+        buf = getTraceStorage().addThread();
+        pthread_setspecific(tlsTraceKey, buf);
+    }
+    return buf;
+}
+
+#endif
+
+TraceRegion::TraceRegion(const char* _name)
+{
+    name = traceOn ? _name : 0;
+    start = name ? getTickCount() : 0;
+}
+
+TraceRegion::~TraceRegion()
+{
+    if( name )
+    {
+        int64 end = getTickCount();
+        getTraceThreadBuffer()->add(name, start, end - start, TRACE_REGION);
+    }
+}
+
+void traceCounter(const char* name, int64 value)
+{
+    if( traceOn )
+        getTraceThreadBuffer()->add(name, getTickCount(), value, TRACE_COUNTER);
+}
+
+bool haveTraceSupport()
+{
+#ifdef HAVE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void setTraceEnabled(bool enabled)
+{
+    getTraceStorage();
+    traceOn = enabled;
+}
+
+bool traceEnabled() { return traceOn; }
+
+void resetTrace()
+{
+    TraceStorage& storage = getTraceStorage();
+    AutoLock lock(storage.mutex);
+    for( size_t i = 0; i < storage.buffers.size(); i++ )
+    {
+        TraceThreadBuffer& buf = *storage.buffers[i];
+        AutoLock bufLock(buf.mutex);
+        buf.events.clear();
+        buf.dropped = 0;
+    }
+    storage.origin = getTickCount();
+}
+
+static void writeChromeTrace( FILE* f, const TraceStorage& storage )
+{
+    double scale = 1e6/getTickFrequency();
+    bool first = true;
+
+    fprintf(f, "{\"traceEvents\":[\n");
+    for( size_t i = 0; i < storage.buffers.size(); i++ )
+    {
+        TraceThreadBuffer& buf = *storage.buffers[i];
+        AutoLock bufLock(buf.mutex);
+        for( size_t j = 0; j < buf.events.size(); j++ )
+        {
+            const TraceEvent& e = buf.events[j];
+            double ts = (e.start - storage.origin)*scale;
+            fprintf(f, first ? "" : ",\n");
+            first = false;
+            if( e.type == TRACE_REGION )
+                fprintf(f, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        e.name, buf.tid, ts, e.value*scale);
+            else
+                fprintf(f, "{\"name\":\"%s\",\"ph\":\"C\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+                        e.name, buf.tid, ts, (long long)e.value);
+        }
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+struct TraceStat
+{
+    TraceStat() : type(TRACE_REGION), count(0), total(0), maxval(0) {}
+    int type;
+    int64 count, total, maxval;
+};
+
+static bool cmpTraceStat( const std::pair<String, TraceStat>& a,
+                          const std::pair<String, TraceStat>& b )
+{
+    if( a.second.type != b.second.type )
+        return a.second.type < b.second.type;
+    return a.second.total > b.second.total;
+}
+
+static void writeFlatProfile( FILE* f, const TraceStorage& storage )
+{
+    // the events are first aggregated by the name pointer, so that nothing is allocated with
+    // fastMalloc (which may be instrumented itself) while a buffer is locked
+    std::map<const char*, TraceStat> rawStats;
+    std::map<String, TraceStat> stats;
+    size_t dropped = 0;
+    double scale = 1e3/getTickFrequency();
+
+    for( size_t i = 0; i < storage.buffers.size(); i++ )
+    {
+        TraceThreadBuffer& buf = *storage.buffers[i];
+        AutoLock bufLock(buf.mutex);
+        dropped += buf.dropped;
+        for( size_t j = 0; j < buf.events.size(); j++ )
+        {
+            const TraceEvent& e = buf.events[j];
+            TraceStat& st = rawStats[e.name];
+            st.type = e.type;
+            st.count++;
+            st.total += e.value;
+            st.maxval = std::max(st.maxval, e.value);
+        }
+    }
+
+    // the same name may come from the different string literals
+    for( std::map<const char*, TraceStat>::const_iterator it = rawStats.begin(); it != rawStats.end(); ++it )
+    {
+        TraceStat& st = stats[it->first];
+        st.type = it->second.type;
+        st.count += it->second.count;
+        st.total += it->second.total;
+        st.maxval = std::max(st.maxval, it->second.maxval);
+    }
+
+    std::vector<std::pair<String, TraceStat> > sorted(stats.begin(), stats.end());
+    std::sort(sorted.begin(), sorted.end(), cmpTraceStat);
+
+    fprintf(f, "%-40s %10s %14s %12s %12s\n", "region", "calls", "total, ms", "avg, ms", "max, ms");
+    for( size_t i = 0; i < sorted.size() && sorted[i].second.type == TRACE_REGION; i++ )
+    {
+        const TraceStat& st = sorted[i].second;
+        fprintf(f, "%-40s %10lld %14.3f %12.4f %12.4f\n", sorted[i].first.c_str(), (long long)st.count,
+                st.total*scale, st.total*scale/st.count, st.maxval*scale);
+    }
+
+    fprintf(f, "\n%-40s %10s %14s %12s %12s\n", "counter", "samples", "sum", "avg", "max");
+    for( size_t i = 0; i < sorted.size(); i++ )
+    {
+        const TraceStat& st = sorted[i].second;
+        if( st.type != TRACE_COUNTER )
+            continue;
+        fprintf(f, "%-40s %10lld %14lld %12.1f %12lld\n", sorted[i].first.c_str(), (long long)st.count,
+                (long long)st.total, (double)st.total/st.count, (long long)st.maxval);
+    }
+
+    fprintf(f, "\nthreads: %d", (int)storage.buffers.size());
+    if( dropped > 0 )
+        fprintf(f, ", dropped events: %lld", (long long)dropped);
+    fprintf(f, "\n");
+}
+
+bool writeTrace(const String& filename, int format)
+{
+    if( format == TRACE_FORMAT_AUTO )
+    {
+        size_t len = filename.size();
+        format = len >= 5 && filename.substr(len - 5) == ".json" ? TRACE_FORMAT_CHROME : TRACE_FORMAT_FLAT;
+    }
+    CV_Assert( format == TRACE_FORMAT_CHROME || format == TRACE_FORMAT_FLAT );
+
+    FILE* f = fopen(filename.c_str(), "wt");
+    if( !f )
+        return false;
+
+    // the collection is paused, since the aggregation itself allocates memory with fastMalloc
+    bool wasOn = traceOn;
+    traceOn = false;
+    {
+    TraceStorage& storage = getTraceStorage();
+    AutoLock lock(storage.mutex);
+    if( format == TRACE_FORMAT_CHROME )
+        writeChromeTrace(f, storage);
+    else
+        writeFlatProfile(f, storage);
+    }
+    traceOn = wasOn;
+    fclose(f);
+    return true;
+}
+
+// OPENCV_TRACE turns the collection on at startup, OPENCV_TRACE_FILE also writes the trace at exit
+struct TraceEnvironment
+{
+    TraceEnvironment()
+    {
+        const char* on = getenv("OPENCV_TRACE");
+        const char* file = getenv("OPENCV_TRACE_FILE");
+        if( file && *file )
+            filename = file;
+        if( (on && atoi(on) != 0) || !filename.empty() )
+            setTraceEnabled(true);
+    }
+
+    ~TraceEnvironment()
+    {
+        if( !filename.empty() )
+        {
+            traceOn = false;
+            writeTrace(filename);
+        }
+    }
+
+    String filename;
+};
+
+static TraceEnvironment traceEnvironment;
+
+}
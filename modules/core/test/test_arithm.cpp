@@ -855,6 +855,39 @@ struct TransposeOp : public BaseElemWiseOp
     }
 };
 
+struct RotateOp : public BaseElemWiseOp
+{
+    RotateOp() : BaseElemWiseOp(1, FIX_ALPHA+FIX_BETA+FIX_GAMMA, 1, 1, Scalar::all(0)) {};
+    void getRandomSize(RNG& rng, vector<int>& size)
+    {
+        cvtest::randomSize(rng, 2, 2, cvtest::ARITHM_MAX_SIZE_LOG, size);
+    }
+    void op(const vector<Mat>& src, Mat& dst, const Mat&)
+    {
+        cv::rotate(src[0], dst, rotateCode);
+    }
+    void refop(const vector<Mat>& src, Mat& dst, const Mat&)
+    {
+        Mat t;
+        if( rotateCode == ROTATE_180 )
+            cvtest::flip(src[0], dst, -1);
+        else
+        {
+            cvtest::transpose(src[0], t);
+            cvtest::flip(t, dst, rotateCode == ROTATE_90_CLOCKWISE ? 1 : 0);
+        }
+    }
+    void generateScalars(int, RNG& rng)
+    {
+        rotateCode = rng.uniform(0, 3);
+    }
+    double getMaxErr(int)
+    {
+        return 0;
+    }
+    int rotateCode;
+};
+
 struct SetIdentityOp : public BaseElemWiseOp
 {
     SetIdentityOp() : BaseElemWiseOp(0, FIX_ALPHA+FIX_BETA, 1, 1, Scalar::all(0)) {};
@@ -1411,6 +1444,7 @@ INSTANTIATE_TEST_CASE_P(Core_InRange, ElemWiseTest, ::testing::Values(ElemWiseOp
 
 INSTANTIATE_TEST_CASE_P(Core_Flip, ElemWiseTest, ::testing::Values(ElemWiseOpPtr(new cvtest::FlipOp)));
 INSTANTIATE_TEST_CASE_P(Core_Transpose, ElemWiseTest, ::testing::Values(ElemWiseOpPtr(new cvtest::TransposeOp)));
+INSTANTIATE_TEST_CASE_P(Core_Rotate, ElemWiseTest, ::testing::Values(ElemWiseOpPtr(new cvtest::RotateOp)));
 INSTANTIATE_TEST_CASE_P(Core_SetIdentity, ElemWiseTest, ::testing::Values(ElemWiseOpPtr(new cvtest::SetIdentityOp)));
 
 INSTANTIATE_TEST_CASE_P(Core_Exp, ElemWiseTest, ::testing::Values(ElemWiseOpPtr(new cvtest::ExpOp)));
@@ -1564,3 +1598,291 @@ TEST(Core_round, CvRound)
     ASSERT_EQ(-2, cvRound(-2.5));
     ASSERT_EQ(-4, cvRound(-3.5));
 }
+
+TEST(Core_SIMDDispatch, MatchesReferenceImplementation)
+{
+    // with setUseOptimized(false) the AVX2/AVX-512 kernels (if any) and the SSE code are bypassed
+    bool useOptimized = cv::useOptimized();
+    cv::RNG& rng = cv::theRNG();
+    const int depths[] = { CV_8U, CV_16U, CV_16S, CV_32F };
+    const int cmpops[] = { cv::CMP_EQ, cv::CMP_GT, cv::CMP_GE, cv::CMP_LT, cv::CMP_LE, cv::CMP_NE };
+
+    for( int iter = 0; iter < 10; iter++ )
+    {
+        cv::Size sz(1 + rng.uniform(0, 257), 1 + rng.uniform(0, 7));
+
+        for( int d = 0; d < 4; d++ )
+        {
+            int depth = depths[d];
+            cv::Mat a(sz, depth), b(sz, depth);
+            if( depth == CV_32F )
+            {
+                rng.fill(a, cv::RNG::UNIFORM, -70000, 70000);
+                rng.fill(b, cv::RNG::UNIFORM, -70000, 70000);
+                a.colRange(0, sz.width/2).copyTo(b.colRange(0, sz.width/2));
+            }
+            else
+            {
+                rng.fill(a, cv::RNG::UNIFORM, -40000, 70000);
+                rng.fill(b, cv::RNG::UNIFORM, -40000, 70000);
+                a.colRange(0, sz.width/3).copyTo(b.colRange(0, sz.width/3));
+            }
+
+            cv::Mat ref[5 + 6], dst[5 + 6];
+            for( int opt = 0; opt < 2; opt++ )
+            {
+                cv::setUseOptimized(opt != 0);
+                cv::Mat* r = opt ? dst : ref;
+                cv::add(a, b, r[0]);
+                cv::subtract(a, b, r[1]);
+                cv::absdiff(a, b, r[2]);
+                if( depth == CV_32F )
+                {
+                    a.convertTo(r[3], CV_16S);
+                    a.convertTo(r[4], CV_8U, 0.01, 3);
+                }
+                else
+                {
+                    a.convertTo(r[3], CV_32F);
+                    a.convertTo(r[4], CV_32F, 0.5, -1);
+                }
+                for( int k = 0; k < 6; k++ )
+                    if( depth != CV_16U )
+                        cv::compare(a, b, r[5 + k], cmpops[k]);
+            }
+            cv::setUseOptimized(useOptimized);
+
+            for( int k = 0; k < 5 + 6; k++ )
+                ASSERT_EQ(0, cvtest::norm(ref[k], dst[k], cv::NORM_INF)) << "depth=" << depth << ", op=" << k;
+        }
+
+        cv::Mat x(sz, CV_32F), y(sz, CV_32F), ref[4], dst[4];
+        rng.fill(x, cv::RNG::UNIFORM, -100, 100);
+        rng.fill(y, cv::RNG::UNIFORM, -100, 100);
+        cv::Mat p = cv::abs(x) + 1e-3;
+        for( int opt = 0; opt < 2; opt++ )
+        {
+            cv::setUseOptimized(opt != 0);
+            cv::Mat* r = opt ? dst : ref;
+            cv::magnitude(x, y, r[0]);
+            cv::phase(x, y, r[1], true);
+            cv::exp(x, r[2]);
+            cv::log(p, r[3]);
+        }
+        cv::setUseOptimized(useOptimized);
+
+        ASSERT_EQ(0, cvtest::norm(ref[0], dst[0], cv::NORM_INF));
+        ASSERT_EQ(0, cvtest::norm(ref[1], dst[1], cv::NORM_INF));
+        // the vector exp() and log() (SSE2 and the dispatched ones alike) evaluate the polynomial
+        // in single precision, while the C code does it in double, so they differ by ~1 ulp
+        ASSERT_LE(cv::norm(ref[2], dst[2], cv::NORM_INF | cv::NORM_RELATIVE), 1e-6);
+        ASSERT_LE(cvtest::norm(ref[3], dst[3], cv::NORM_INF), 1e-5);
+    }
+}
+
+TEST(Core_Stat, StripeParallelReductions)
+{
+    // the large matrices are reduced by stripes; the results must not depend on the number of threads
+    int nthreads = cv::getNumThreads();
+    cv::RNG& rng = cv::theRNG();
+    const int types[] = { CV_8UC1, CV_8UC4, CV_16UC1, CV_16UC4, CV_16SC1, CV_16SC3, CV_32SC1, CV_32FC1, CV_32FC2, CV_64FC1 };
+
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+    {
+        int type = types[t], depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+        cv::Mat src(431, 613, type), src2(src.size(), type), mask(src.size(), CV_8U);
+        double a = depth == CV_8U ? 0 : depth == CV_16U ? 0 : depth == CV_16S ? -32768 : -1000;
+        double b = depth == CV_8U ? 256 : depth == CV_16U ? 65536 : depth == CV_16S ? 32768 : 1000;
+        rng.fill(src, cv::RNG::UNIFORM, a, b);
+        rng.fill(src2, cv::RNG::UNIFORM, a, b);
+        rng.fill(mask, cv::RNG::UNIFORM, 0, 2);
+        src.rowRange(100, 150).setTo(cv::Scalar::all(0));
+        cv::Mat src1c = src.reshape(1), mask1c = cn == 1 ? mask : cv::Mat();
+
+        cv::Scalar s[2], m[2], mean[2], sdv[2];
+        double n[2][5], minv[2], maxv[2];
+        int nz[2], minIdx[2][2], maxIdx[2][2];
+
+        for( int k = 0; k < 2; k++ )
+        {
+            cv::setNumThreads(k == 0 ? 1 : std::max(nthreads, 4));
+            s[k] = cv::sum(src);
+            m[k] = cv::mean(src, mask);
+            cv::meanStdDev(src, mean[k], sdv[k], mask);
+            n[k][0] = cv::norm(src, cv::NORM_INF, mask);
+            n[k][1] = cv::norm(src, cv::NORM_L1, mask);
+            n[k][2] = cv::norm(src, cv::NORM_L2);
+            n[k][3] = cv::norm(src, src2, cv::NORM_L1);
+            n[k][4] = cv::norm(src, src2, cv::NORM_L2, mask);
+            nz[k] = cv::countNonZero(src1c);
+            cv::minMaxIdx(src1c, &minv[k], &maxv[k], minIdx[k], maxIdx[k], mask1c);
+        }
+        cv::setNumThreads(nthreads);
+
+        EXPECT_EQ(s[0], s[1]) << "type=" << type;
+        EXPECT_EQ(m[0], m[1]) << "type=" << type;
+        EXPECT_EQ(mean[0], mean[1]) << "type=" << type;
+        EXPECT_EQ(sdv[0], sdv[1]) << "type=" << type;
+        for( int j = 0; j < 5; j++ )
+            EXPECT_EQ(n[0][j], n[1][j]) << "type=" << type << ", norm=" << j;
+        EXPECT_EQ(nz[0], nz[1]) << "type=" << type;
+        EXPECT_EQ(minv[0], minv[1]) << "type=" << type;
+        EXPECT_EQ(maxv[0], maxv[1]) << "type=" << type;
+        EXPECT_TRUE(minIdx[0][0] == minIdx[1][0] && minIdx[0][1] == minIdx[1][1]) << "type=" << type;
+        EXPECT_TRUE(maxIdx[0][0] == maxIdx[1][0] && maxIdx[0][1] == maxIdx[1][1]) << "type=" << type;
+
+        // compare with the reference implementation
+        cv::Mat src64f, sq64f;
+        src.convertTo(src64f, CV_64F);
+        cv::multiply(src64f, src64f, sq64f);
+        cv::Scalar refMean = cvtest::mean(src, mask), refSqMean = cvtest::mean(sq64f, mask);
+        cv::Scalar refSum = cvtest::mean(src)*(double)src.total();
+        for( int c = 0; c < cn; c++ )
+        {
+            double refSdv = std::sqrt(std::max(refSqMean[c] - refMean[c]*refMean[c], 0.));
+            EXPECT_NEAR(refSum[c], s[1][c], std::abs(refSum[c])*1e-9 + 1e-6) << "type=" << type;
+            EXPECT_NEAR(refMean[c], m[1][c], std::abs(refMean[c])*1e-9 + 1e-6) << "type=" << type;
+            EXPECT_NEAR(refMean[c], mean[1][c], std::abs(refMean[c])*1e-9 + 1e-6) << "type=" << type;
+            EXPECT_NEAR(refSdv, sdv[1][c], refSdv*1e-6 + 1e-6) << "type=" << type;
+        }
+
+        double refNorm[] =
+        {
+            cvtest::norm(src, cv::NORM_INF, mask), cvtest::norm(src, cv::NORM_L1, mask),
+            cvtest::norm(src, cv::NORM_L2), cvtest::norm(src, src2, cv::NORM_L1),
+            cvtest::norm(src, src2, cv::NORM_L2, mask)
+        };
+        for( int j = 0; j < 5; j++ )
+            EXPECT_NEAR(refNorm[j], n[1][j], refNorm[j]*1e-9) << "type=" << type << ", norm=" << j;
+
+        int refNz = 0;
+        for( int y = 0; y < src1c.rows; y++ )
+            for( int x = 0; x < src1c.cols; x++ )
+                refNz += src64f.reshape(1).at<double>(y, x) != 0;
+        EXPECT_EQ(refNz, nz[1]) << "type=" << type;
+
+        double refMin = 0, refMax = 0;
+        std::vector<int> refMinLoc, refMaxLoc;
+        cvtest::minMaxLoc(src1c, &refMin, &refMax, &refMinLoc, &refMaxLoc, mask1c);
+        EXPECT_EQ(refMin, minv[1]) << "type=" << type;
+        EXPECT_EQ(refMax, maxv[1]) << "type=" << type;
+        EXPECT_TRUE(refMinLoc[0] == minIdx[1][0] && refMinLoc[1] == minIdx[1][1]) << "type=" << type;
+        EXPECT_TRUE(refMaxLoc[0] == maxIdx[1][0] && refMaxLoc[1] == maxIdx[1][1]) << "type=" << type;
+    }
+}
+
+TEST(Core_Transpose, InplaceAndFlip)
+{
+    // in-place square transposition (tile pairs exchanged through a temporary tile)
+    // and in-place flips, compared with the out-of-place results
+    int types[] = { CV_8UC1, CV_16UC1, CV_8UC3, CV_32FC1, CV_16SC3, CV_64FC1, CV_32SC3, CV_32FC4, CV_64FC3, CV_64FC4 };
+    int sizes[] = { 1, 7, 16, 33, 64, 100, 257, 600 };
+    RNG& rng = theRNG();
+
+    for( size_t i = 0; i < sizeof(types)/sizeof(types[0]); i++ )
+        for( size_t j = 0; j < sizeof(sizes)/sizeof(sizes[0]); j++ )
+        {
+            int n = sizes[j];
+            Mat big(n + 3, n + 5, types[i]), ref, dst;
+            rng.fill(big, RNG::UNIFORM, Scalar::all(0), Scalar::all(100));
+            Mat src = big(Rect(2, 1, n, n));
+
+            cvtest::transpose(src, ref);
+            dst = src.clone();
+            cv::transpose(dst, dst);
+            ASSERT_EQ(0., cvtest::norm(ref, dst, NORM_INF)) << "type=" << types[i] << ", n=" << n;
+
+            for( int flipCode = -1; flipCode <= 1; flipCode++ )
+            {
+                cvtest::flip(src, ref, flipCode);
+                dst = src.clone();
+                cv::flip(dst, dst, flipCode);
+                ASSERT_EQ(0., cvtest::norm(ref, dst, NORM_INF)) << "type=" << types[i] << ", n=" << n << ", flipCode=" << flipCode;
+            }
+        }
+}
+
+TEST(Core_LUT, fastPaths)
+{
+    // the unrolled and the parallel LUT paths compared with the per-element lookup
+    int cns[] = { 1, 2, 3, 4 };
+    Size sizes[] = { Size(1, 1), Size(7, 3), Size(640, 480), Size(1, 300) };
+    RNG& rng = theRNG();
+
+    for( size_t i = 0; i < sizeof(cns)/sizeof(cns[0]); i++ )
+        for( size_t j = 0; j < sizeof(sizes)/sizeof(sizes[0]); j++ )
+            for( int lutcn = 1; lutcn <= cns[i]; lutcn += std::max(cns[i] - 1, 1) )
+            {
+                int cn = cns[i];
+                Mat big(sizes[j].height + 2, sizes[j].width + 3, CV_8UC(cn)), lut(1, 256, CV_8UC(lutcn)), dst;
+                rng.fill(big, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+                rng.fill(lut, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+                Mat src = big(Rect(1, 2, sizes[j].width, sizes[j].height));
+
+                cv::LUT(src, lut, dst);
+                ASSERT_EQ(src.size(), dst.size());
+                ASSERT_EQ(src.type(), dst.type());
+
+                int errors = 0;
+                for( int y = 0; y < src.rows; y++ )
+                {
+                    const uchar* s = src.ptr(y);
+                    const uchar* d = dst.ptr(y);
+                    for( int x = 0; x < src.cols*cn; x++ )
+                        errors += d[x] != lut.data[s[x]*lutcn + (lutcn > 1 ? x % cn : 0)];
+                }
+                ASSERT_EQ(0, errors) << "cn=" << cn << ", lutcn=" << lutcn << ", size=" << sizes[j];
+            }
+}
+
+TEST(Core_LUTPipeline, accuracy)
+{
+    // the composed table must give the same result as applying the operations one by one
+    RNG& rng = theRNG();
+    Mat src(123, 321, CV_8UC3), lut(1, 256, CV_8U), expected, dst;
+    rng.fill(src, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+    rng.fill(lut, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+
+    LUTPipeline pipeline(3);
+    pipeline.contrast(1.7, -20).gamma(0.6).scaleAbs(-0.9, 30, 1).threshold(100.5, 200, LUTPipeline::THRESH_TRUNC, 2).lut(lut);
+    pipeline.apply(src, dst);
+
+    src.convertTo(expected, CV_8U, 1.7, -20);
+    for( int y = 0; y < expected.rows; y++ )
+    {
+        uchar* p = expected.ptr(y);
+        for( int x = 0; x < expected.cols*3; x++ )
+            p[x] = saturate_cast<uchar>(std::pow(p[x]/255., 0.6)*255.);
+    }
+
+    std::vector<Mat> planes;
+    split(expected, planes);
+    convertScaleAbs(planes[1], planes[1], -0.9, 30);
+    min(planes[2], Scalar(100), planes[2]);
+    merge(planes, expected);
+    cv::LUT(expected, lut, expected);
+
+    ASSERT_EQ(0., cvtest::norm(expected, dst, NORM_INF));
+
+    pipeline.reset();
+    pipeline.apply(src, dst);
+    ASSERT_EQ(0., cvtest::norm(src, dst, NORM_INF));
+
+    // all the threshold modes on the identity table
+    const int modes[] = { LUTPipeline::THRESH_BINARY, LUTPipeline::THRESH_BINARY_INV, LUTPipeline::THRESH_TRUNC,
+                          LUTPipeline::THRESH_TOZERO, LUTPipeline::THRESH_TOZERO_INV };
+    for( int k = 0; k < 5; k++ )
+    {
+        LUTPipeline p;
+        const uchar* t = p.threshold(100.5, 200.4, modes[k]).table().data;
+        for( int i = 0; i < 256; i++ )
+        {
+            bool above = i > 100;
+            int v = modes[k] == LUTPipeline::THRESH_BINARY ? (above ? 200 : 0) :
+                    modes[k] == LUTPipeline::THRESH_BINARY_INV ? (above ? 0 : 200) :
+                    modes[k] == LUTPipeline::THRESH_TRUNC ? (above ? 100 : i) :
+                    modes[k] == LUTPipeline::THRESH_TOZERO ? (above ? i : 0) : (above ? 0 : i);
+            ASSERT_EQ(v, (int)t[i]) << "mode=" << modes[k] << ", i=" << i;
+        }
+    }
+}
@@ -868,3 +868,49 @@ protected:
 TEST(Core_DFT, complex_output) { Core_DFTComplexOutputTest test; test.safe_run(); }
 
 
+
+TEST(Core_DFT, plans_threads_and_simd)
+{
+    // the cached plans, the row/column stripes and the wider radix-4 kernels
+    // must give exactly the same result as a single-threaded transform with fresh tables
+    int sizes[][2] = { {1, 1024}, {3, 256}, {64, 64}, {17, 1000}, {120, 1920}, {256, 512}, {1080, 48} };
+    int flags[] = { 0, DFT_ROWS, DFT_INVERSE, DFT_INVERSE + DFT_SCALE, DFT_COMPLEX_OUTPUT, DFT_INVERSE + DFT_REAL_OUTPUT };
+    int types[] = { CV_32FC1, CV_32FC2, CV_64FC1, CV_64FC2 };
+    RNG& rng = theRNG();
+    int nthreads = getNumThreads();
+    bool useOpt = useOptimized();
+    int cacheSize = getDFTPlanCacheSize();
+
+    for( size_t i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++ )
+        for( size_t j = 0; j < sizeof(types)/sizeof(types[0]); j++ )
+            for( size_t k = 0; k < sizeof(flags)/sizeof(flags[0]); k++ )
+            {
+                if( (flags[k] & DFT_REAL_OUTPUT) && CV_MAT_CN(types[j]) == 1 )
+                    continue;
+                Mat src(sizes[i][0], sizes[i][1], types[j]);
+                rng.fill(src, RNG::UNIFORM, Scalar::all(-1), Scalar::all(1));
+                // the 1D real transforms with complex output fill only the first half of the row
+                int dtype = flags[k] & DFT_COMPLEX_OUTPUT ? CV_MAKETYPE(src.depth(), 2) :
+                            flags[k] & DFT_REAL_OUTPUT ? src.depth() : src.type();
+                Mat ref = Mat::zeros(src.size(), dtype), dst = Mat::zeros(src.size(), dtype);
+
+                setNumThreads(1);
+                setUseOptimized(false);
+                setDFTPlanCacheSize(0);
+                dft(src, ref, flags[k]);
+
+                setNumThreads(std::max(nthreads, 4));
+                setUseOptimized(true);
+                setDFTPlanCacheSize(cacheSize);
+                for( int iter = 0; iter < 2; iter++ )
+                {
+                    dft(src, dst, flags[k]);
+                    ASSERT_EQ(0., norm(ref, dst, NORM_INF))
+                        << "size=" << src.size() << ", type=" << types[j] << ", flags=" << flags[k];
+                }
+            }
+
+    setNumThreads(nthreads);
+    setUseOptimized(useOpt);
+    setDFTPlanCacheSize(cacheSize);
+}
@@ -409,3 +409,80 @@ TEST(Core_Eigen, scalar_32) {Core_EigenTest_Scalar_32 test; test.safe_run(); }
 TEST(Core_Eigen, scalar_64) {Core_EigenTest_Scalar_64 test; test.safe_run(); }
 TEST(Core_Eigen, vector_32) { Core_EigenTest_32 test; test.safe_run(); }
 TEST(Core_Eigen, vector_64) { Core_EigenTest_64 test; test.safe_run(); }
+
+TEST(Core_Eigen, top_k)
+{
+    const int n = 150, k = 12;
+    for( int depth = CV_32F; depth <= CV_64F; depth++ )
+    {
+        cv::Mat a(n, n, depth), src, evals, evects, evals_k, evects_k;
+        cv::RNG rng(depth);
+        rng.fill(a, cv::RNG::UNIFORM, -1, 1);
+        // covariance-like matrix with a zero eigenvalue
+        cv::mulTransposed(a, src, true);
+        src.row(5).setTo(0);
+        src.col(5).setTo(0);
+
+        cv::eigen(src, evals, evects);
+        cv::eigen(src, evals_k, evects_k, k);
+
+        ASSERT_EQ(k, evals_k.rows);
+        ASSERT_EQ(k, evects_k.rows);
+        ASSERT_EQ(n, evects_k.cols);
+
+        double eps = depth == CV_32F ? 1e-4 : 1e-10;
+        double scale = cv::norm(src, cv::NORM_INF);
+        EXPECT_LE(cv::norm(evals.rowRange(0, k), evals_k, cv::NORM_INF), eps*scale);
+        EXPECT_LE(cv::norm(evects_k*evects_k.t(), cv::Mat::eye(k, k, depth), cv::NORM_INF), eps);
+
+        cv::Mat lambda = cv::Mat::diag(evals_k);
+        EXPECT_LE(cv::norm(evects_k*src, lambda*evects_k, cv::NORM_INF), eps*scale);
+    }
+}
+
+TEST(Core_Eigen, repeated_eigenvalues)
+{
+    // Q*diag(w)*Q' with clusters of equal eigenvalues at the top and in the middle of the spectrum,
+    // and the glued Wilkinson matrix (W21 blocks coupled by 1e-14, every eigenvalue is repeated
+    // 5 times up to the rounding errors). The eigenvectors of a cluster must stay orthonormal for
+    // the Jacobi method (n <= 32), the tridiagonal QL and the inverse iteration (top-k)
+    for( int t = 0; t < 3; t++ )
+    {
+        int n = t == 0 ? 20 : t == 1 ? 100 : 105, k = t < 2 ? 8 : 20;
+        cv::Mat src;
+        if( t < 2 )
+        {
+            cv::RNG rng(n);
+            cv::Mat a(n, n, CV_64F), w(n, 1, CV_64F);
+            rng.fill(a, cv::RNG::NORMAL, 0, 1);
+            cv::Mat q = cv::SVD(a).u;
+            for( int i = 0; i < n; i++ )
+                w.at<double>(i) = i < 5 ? 3. : i < n/2 ? 1. : 1. + (double)i/n;
+            src = q*cv::Mat::diag(w)*q.t();
+            src = (src + src.t())*0.5;
+        }
+        else
+        {
+            src = cv::Mat::zeros(n, n, CV_64F);
+            for( int i = 0; i < n; i++ )
+            {
+                src.at<double>(i, i) = std::abs(10 - i % 21);
+                if( i < n - 1 )
+                    src.at<double>(i, i + 1) = src.at<double>(i + 1, i) = i % 21 == 20 ? 1e-14 : 1.;
+            }
+        }
+
+        for( int count = 0; count <= k; count += k )
+        {
+            cv::Mat evals, evects;
+            cv::eigen(src, evals, evects, count);
+            int m = evects.rows;
+            double scale = cv::norm(src, cv::NORM_INF);
+
+            EXPECT_LE(cv::norm(evects*evects.t(), cv::Mat::eye(m, m, CV_64F), cv::NORM_INF), 1e-12)
+                << "n=" << n << ", count=" << count;
+            EXPECT_LE(cv::norm(evects*src, cv::Mat::diag(evals)*evects, cv::NORM_INF), 1e-12*scale)
+                << "n=" << n << ", count=" << count;
+        }
+    }
+}
@@ -83,15 +83,16 @@ static bool cvTsCheckSparse(const CvSparseMat* m1, const CvSparseMat* m2, double
 class Core_IOTest : public cvtest::BaseTest
 {
 public:
-    Core_IOTest() {};
+    Core_IOTest(bool _binary = false) : binary(_binary) {};
 protected:
+    bool binary;
     void run(int)
     {
         double ranges[][2] = {{0, 256}, {-128, 128}, {0, 65536}, {-32768, 32768},
             {-1000000, 1000000}, {-10, 10}, {-10, 10}};
         RNG& rng = ts->get_rng();
         RNG rng0;
-        test_case_count = 4;
+        test_case_count = binary ? 2 : 4;
         int progress = 0;
         MemStorage storage(cvCreateMemStorage(0));
 
@@ -102,10 +103,11 @@ protected:
 
             cvClearMemStorage(storage);
 
-            bool mem = (idx % 4) >= 2;
-            string filename = tempfile(idx % 2 ? ".yml" : ".xml");
+            bool mem = !binary && (idx % 4) >= 2;
+            string filename = tempfile(binary ? (idx % 2 ? ".bin.gz" : ".bin") : idx % 2 ? ".yml" : ".xml");
 
-            FileStorage fs(filename, FileStorage::WRITE + (mem ? FileStorage::MEMORY : 0));
+            FileStorage fs(filename, FileStorage::WRITE + (mem ? FileStorage::MEMORY : 0) +
+                           (binary ? FileStorage::FORMAT_BINARY : 0));
 
             int test_int = (int)cvtest::randInt(rng);
             double test_real = (cvtest::randInt(rng)%2?1:-1)*exp(cvtest::randReal(rng)*18-9);
@@ -377,6 +379,7 @@ protected:
 };
 
 TEST(Core_InputOutput, write_read_consistency) { Core_IOTest test; test.safe_run(); }
+TEST(Core_InputOutput, write_read_consistency_binary) { Core_IOTest test(true); test.safe_run(); }
 
 extern void testFormatter();
 
@@ -481,3 +484,134 @@ TEST(Core_InputOutput, FileStorage)
     sprintf(arr, "sprintf is hell %d", 666);
     EXPECT_NO_THROW(f << arr);
 }
+
+TEST(Core_InputOutput, FileStorage_binary_mapped_mat)
+{
+    std::string file = cv::tempfile(".bin");
+    cv::Mat big(300, 257, CV_32FC3), small(3, 4, CV_16S), roi, big2, small2(3, 4, CV_16S), roi2;
+    cv::randu(big, -100, 100);
+    cv::randu(small, -1000, 1000);
+    roi = big(cv::Rect(10, 20, 30, 40));
+    std::vector<float> vec(1000);
+    cv::randu(vec, 0, 1);
+    std::vector<float> vec2;
+
+    {
+        cv::FileStorage fs(file, cv::FileStorage::WRITE + cv::FileStorage::FORMAT_BINARY);
+        fs << "big" << big << "small" << small << "roi" << roi << "vec" << vec;
+    }
+
+    {
+        cv::FileStorage fs(file, cv::FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        uchar* small2_data = small2.data;
+        fs["big"] >> big2;
+        fs["small"] >> small2;
+        fs["roi"] >> roi2;
+        fs["vec"] >> vec2;
+
+        // the big matrix is used right from the page-aligned file mapping
+        EXPECT_EQ(0, (int)((size_t)big2.data % 4096));
+        // the preallocated matrix of the same size and type is reused
+        EXPECT_EQ(small2_data, small2.data);
+    }
+
+    // the matrices stay valid after the storage is released
+    EXPECT_EQ(0, cv::norm(big, big2, cv::NORM_INF));
+    EXPECT_EQ(0, cv::norm(small, small2, cv::NORM_INF));
+    EXPECT_EQ(0, cv::norm(roi, roi2, cv::NORM_INF));
+    ASSERT_EQ(vec.size(), vec2.size());
+    EXPECT_EQ(0, cv::norm(vec, vec2, cv::NORM_INF));
+
+    cv::Mat big3 = big2;
+    big2.release();
+    big3 += 1;
+    EXPECT_LT(cv::norm(big3, big + 1, cv::NORM_INF), 1e-3);
+    big3.create(5, 5, CV_8U);
+    big3.setTo(1);
+    EXPECT_EQ(25, cv::countNonZero(big3));
+
+    remove(file.c_str());
+}
+
+namespace
+{
+
+struct CollectingSink : public cv::FileStorage::Sink
+{
+    CollectingSink() : chunks(0), maxChunk(0) {}
+    void write(const char* data, size_t len)
+    {
+        buf.insert(buf.end(), data, data + len);
+        chunks++;
+        maxChunk = std::max(maxChunk, len);
+    }
+
+    std::string buf;
+    int chunks;
+    size_t maxChunk;
+};
+
+}
+
+TEST(Core_InputOutput, FileStorage_sink)
+{
+    const char* names[] = { ".yml", ".xml", ".yml.gz", ".xml.gz9" };
+    const size_t bufferSize = 1 << 12;
+    cv::Mat m(100, 100, CV_32F);
+    cv::randu(m, 0, 1);
+
+    for( int k = 0; k < 4; k++ )
+    {
+        bool gz = strstr(names[k], ".gz") != 0;
+        cv::Ptr<CollectingSink> sink = new CollectingSink;
+        std::string str;
+
+        for( int mode = 0; mode < 2; mode++ )
+        {
+            cv::FileStorage fs;
+            if( mode == 0 )
+                ASSERT_TRUE(fs.open(sink, names[k], cv::FileStorage::WRITE, bufferSize));
+            else
+                ASSERT_TRUE(fs.open(names[k], cv::FileStorage::WRITE + cv::FileStorage::MEMORY));
+            for( int i = 0; i < 20; i++ )
+                fs << cv::format("frame%d", i) << "{" << "idx" << i << "m" << m << "}";
+            if( mode == 0 )
+            {
+                // every completed top-level collection has been passed to the sink
+                EXPECT_GT(sink->chunks, 20);
+                fs.release();
+            }
+            else
+                str = fs.releaseAndGetString();
+        }
+
+        // the buffer overflows by at most one line or one deflate output block
+        EXPECT_LE(sink->maxChunk, bufferSize + (gz ? (1 << 14) : (1 << 10)));
+        if( !gz )
+        {
+            EXPECT_EQ(str, sink->buf);
+            continue;
+        }
+
+        std::string file = cv::tempfile(names[k]);
+        file.resize(file.size() - (names[k][strlen(names[k])-1] == '9'));
+        FILE* f = fopen(file.c_str(), "wb");
+        ASSERT_TRUE(f != 0);
+        fwrite(sink->buf.data(), 1, sink->buf.size(), f);
+        fclose(f);
+
+        cv::FileStorage fs(file, cv::FileStorage::READ);
+        ASSERT_TRUE(fs.isOpened());
+        for( int i = 0; i < 20; i++ )
+        {
+            cv::Mat m2;
+            cv::FileNode node = fs[cv::format("frame%d", i)];
+            EXPECT_EQ(i, (int)node["idx"]);
+            node["m"] >> m2;
+            EXPECT_EQ(0, cv::norm(m, m2, cv::NORM_INF));
+        }
+        fs.release();
+        remove(file.c_str());
+    }
+}
@@ -1078,6 +1078,210 @@ TEST(Core_Array, basic_operations) { Core_ArrayOpTest test; test.safe_run(); }
 TEST(Core_Merge, shape_operations) { Core_MergeTest test; test.safe_run(); }
 TEST(Core_Split, shape_operations) { Core_SplitTest test; test.safe_run(); }
 
+template<typename T> static void checkSortedRows( const Mat& src, int flags, const Mat& dst, const Mat& idx )
+{
+    bool byRows = (flags & SORT_EVERY_COLUMN) == 0, desc = (flags & SORT_DESCENDING) != 0;
+    Mat s = byRows ? src : src.t(), d = byRows ? dst : dst.t(), ix = byRows ? idx : idx.t();
+
+    for( int i = 0; i < s.rows; i++ )
+    {
+        // reference: the stable order of (value, original position) pairs
+        vector<pair<T, int> > v(s.cols);
+        for( int j = 0; j < s.cols; j++ )
+            v[j] = make_pair(s.at<T>(i, j), desc ? -j : j);
+        std::sort(v.begin(), v.end());
+        if( desc )
+            std::reverse(v.begin(), v.end());
+
+        for( int j = 0; j < s.cols; j++ )
+        {
+            ASSERT_EQ(v[j].first, d.at<T>(i, j)) << "row " << i << ", flags " << flags;
+            ASSERT_EQ(desc ? -v[j].second : v[j].second, ix.at<int>(i, j)) << "row " << i << ", flags " << flags;
+        }
+    }
+}
+
+TEST(Core_Sort, radix_parallel_stable)
+{
+    // the lengths are below and above the radix sort threshold; the last size goes
+    // through the parallel, transposed column sort
+    const Size sizes[] = { Size(100, 7), Size(1000, 9), Size(600, 300) };
+    RNG& rng = theRNG();
+
+    for( int si = 0; si < 3; si++ )
+        for( int flags = 0; flags < 4; flags++ )
+        {
+            int sortFlags = ((flags & 1) ? SORT_EVERY_COLUMN : SORT_EVERY_ROW) |
+                            ((flags & 2) ? SORT_DESCENDING : SORT_ASCENDING);
+            Mat dst, idx;
+
+            // a small value range produces many ties
+            Mat a8s(sizes[si], CV_8S);
+            rng.fill(a8s, RNG::UNIFORM, -20, 20);
+            cv::sort(a8s, dst, sortFlags);
+            sortIdx(a8s, idx, sortFlags | SORT_STABLE);
+            checkSortedRows<schar>(a8s, sortFlags, dst, idx);
+
+            Mat a32s(sizes[si], CV_32S);
+            rng.fill(a32s, RNG::UNIFORM, -100000, 100000);
+            a32s.row(0).setTo(Scalar::all(INT_MIN));
+            cv::sort(a32s, dst, sortFlags);
+            sortIdx(a32s, idx, sortFlags | SORT_STABLE);
+            checkSortedRows<int>(a32s, sortFlags, dst, idx);
+
+            Mat a32f(sizes[si], CV_32F);
+            rng.fill(a32f, RNG::UNIFORM, -50, 50);
+            a32f.convertTo(a32f, CV_32F, 0.25);
+            cv::sort(a32f, dst, sortFlags);
+            sortIdx(a32f, idx, sortFlags | SORT_STABLE);
+            checkSortedRows<float>(a32f, sortFlags, dst, idx);
+
+            Mat a64f(sizes[si], CV_64F);
+            rng.fill(a64f, RNG::UNIFORM, -1e10, 1e10);
+            cv::sort(a64f, dst, sortFlags);
+            sortIdx(a64f, idx, sortFlags | SORT_STABLE);
+            checkSortedRows<double>(a64f, sortFlags, dst, idx);
+
+            // in-place sorting
+            Mat b = a64f.clone();
+            cv::sort(b, b, sortFlags);
+            cv::sort(a64f, dst, sortFlags);
+            ASSERT_EQ(0, norm(b, dst, NORM_INF));
+        }
+}
+
+TEST(Core_SparseMat, open_addressing_batch)
+{
+    const int sz[] = { 1000, 1000, 50 };
+    RNG& rng = theRNG();
+    SparseMat m(3, sz, CV_32F);
+    std::map<int64, float> ref;
+
+    // many insertions and deletions, so that the deleted slots are reused and purged on rehash
+    for( int iter = 0; iter < 100000; iter++ )
+    {
+        int idx[] = { rng.uniform(0, 100), rng.uniform(0, 100), rng.uniform(0, 50) };
+        int64 key = ((int64)idx[0]*1000 + idx[1])*50 + idx[2];
+        if( rng.uniform(0, 3) == 0 )
+        {
+            m.erase(idx);
+            ref.erase(key);
+        }
+        else
+        {
+            float v = (float)rng.uniform(1, 100);
+            m.ref<float>(idx) += v;
+            ref[key] += v;
+        }
+    }
+    ASSERT_EQ(ref.size(), m.nzcount());
+
+    size_t n = 0;
+    for( SparseMatConstIterator_<float> it = m.begin<float>(); it != m.end<float>(); ++it, n++ )
+    {
+        const SparseMat::Node* node = it.node();
+        int64 key = ((int64)node->idx[0]*1000 + node->idx[1])*50 + node->idx[2];
+        ASSERT_EQ(ref[key], *it);
+        ASSERT_EQ(m.hash(node->idx), node->hashval);
+    }
+    ASSERT_EQ(ref.size(), n);
+
+    // batch lookup and insertion
+    const int count = 5000;
+    std::vector<int> idx(count*3);
+    for( int k = 0; k < count; k++ )
+    {
+        idx[k*3] = rng.uniform(0, 200);
+        idx[k*3+1] = rng.uniform(0, 200);
+        idx[k*3+2] = rng.uniform(0, 50);
+    }
+    std::vector<uchar*> ptrs(count);
+    m.ptr(&idx[0], count, &ptrs[0], false);
+    for( int k = 0; k < count; k++ )
+        ASSERT_EQ(m.find<float>(&idx[k*3]), (const float*)ptrs[k]);
+
+    SparseMat m2 = m.clone();
+    m2.ptr(&idx[0], count, &ptrs[0], true);
+    for( int k = 0; k < count; k++ )
+    {
+        ASSERT_TRUE(ptrs[k] != 0);
+        ASSERT_EQ(m2.find<float>(&idx[k*3]), (const float*)ptrs[k]);
+        ASSERT_EQ(m.value<float>(&idx[k*3]), *(const float*)ptrs[k]);
+    }
+
+    // accumulation with explicit values and with the unit increments
+    std::vector<float> vals(count);
+    for( int k = 0; k < count; k++ )
+        vals[k] = (float)rng.uniform(-10, 10);
+    m2 = m.clone();
+    m2.accumulate(&idx[0], &vals[0], count);
+    SparseMat m3 = m.clone();
+    for( int k = 0; k < count; k++ )
+        m3.ref<float>(&idx[k*3]) += vals[k];
+    ASSERT_EQ(m3.nzcount(), m2.nzcount());
+    ASSERT_EQ(0, norm(m3, NORM_L1) - norm(m2, NORM_L1));
+    for( SparseMatConstIterator_<float> it = m3.begin<float>(); it != m3.end<float>(); ++it )
+        ASSERT_EQ(*it, m2.value<float>(it.node()->idx));
+
+    const int hsz[] = { 16, 16 };
+    SparseMat hist(2, hsz, CV_32SC2);
+    std::vector<int> hidx(count*2);
+    for( int k = 0; k < count*2; k++ )
+        hidx[k] = rng.uniform(0, 16);
+    hist.accumulate(&hidx[0], 0, count);
+    Mat dense;
+    hist.copyTo(dense);
+    ASSERT_EQ(Scalar(count, count, 0, 0), sum(dense));
+}
+
+TEST(Core_Split, simd_and_parallel)
+{
+    const int depths[] = { CV_8U, CV_16U, CV_16S, CV_32S, CV_32F };
+    // an odd-sized ROI, so that the vector loops leave tails, and an array that is split in stripes
+    const Size sizes[] = { Size(77, 5), Size(1031, 600) };
+    RNG& rng = theRNG();
+
+    for( int si = 0; si < 2; si++ )
+        for( int di = 0; di < 5; di++ )
+            for( int cn = 2; cn <= 4; cn++ )
+            {
+                int depth = depths[di];
+                Mat big(sizes[si].height + 2, sizes[si].width + 3, CV_MAKETYPE(depth, cn));
+                rng.fill(big, RNG::UNIFORM, 0, 30000);
+                Mat src = big(Rect(Point(1, 2), sizes[si]));
+
+                vector<Mat> planes;
+                split(src, planes);
+                ASSERT_EQ((size_t)cn, planes.size());
+
+                for( int k = 0; k < cn; k++ )
+                {
+                    Mat ref(src.size(), depth);
+                    int pair[] = { k, 0 };
+                    mixChannels(&src, 1, &ref, 1, pair, 1);
+                    EXPECT_EQ(0, norm(planes[k], ref, NORM_INF)) << "depth=" << depth << " cn=" << cn << " k=" << k;
+                }
+
+                Mat merged;
+                merge(planes, merged);
+                EXPECT_EQ(0, norm(merged, src, NORM_INF)) << "depth=" << depth << " cn=" << cn;
+
+                // the same through mixChannels, which forwards these patterns to split & merge
+                vector<Mat> planes2(cn);
+                vector<int> fromTo;
+                for( int k = 0; k < cn; k++ )
+                {
+                    planes2[k].create(src.size(), depth);
+                    fromTo.push_back(k);
+                    fromTo.push_back(k);
+                }
+                mixChannels(src, planes2, fromTo);
+                Mat merged2(src.size(), src.type());
+                mixChannels(planes2, merged2, fromTo);
+                EXPECT_EQ(0, norm(merged2, src, NORM_INF)) << "depth=" << depth << " cn=" << cn;
+            }
+}
+
 
 TEST(Core_IOArray, submat_assignment)
 {
@@ -1113,3 +1317,74 @@ TEST(Core_Mat, reshape_1942)
     );
     ASSERT_EQ(1, cn);
 }
+
+TEST(Core_Mat, pool_allocator)
+{
+    PoolMatAllocator* pool = PoolMatAllocator::getInstance();
+    size_t limit = pool->getCacheLimit();
+    pool->trim();
+    pool->resetStats();
+
+    {
+        Mat a;
+        a.allocator = pool;
+        a.create(480, 640, CV_8UC3);
+        a.setTo(Scalar::all(7));
+        EXPECT_EQ(pool, a.allocator);
+        EXPECT_EQ(640*3u, a.step[0]);
+    }
+    PoolMatAllocator::Stats stats = pool->getStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_LE((size_t)480*640*3, stats.cachedBytes);
+
+    // the same size class is served from the cache, also via the default allocator
+    MatAllocator* defaultAllocator = Mat::getDefaultAllocator();
+    Mat::setDefaultAllocator(pool);
+    {
+        Mat b(640, 480, CV_8UC3, Scalar::all(3));
+        EXPECT_EQ(pool, b.allocator);
+        EXPECT_EQ(Vec3b(3, 3, 3), b.at<Vec3b>(639, 479));
+    }
+    Mat::setDefaultAllocator(defaultAllocator);
+    stats = pool->getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+
+    // nothing is cached when the limit is 0
+    pool->setCacheLimit(0);
+    EXPECT_EQ(0u, pool->getStats().cachedBytes);
+    {
+        Mat c;
+        c.allocator = pool;
+        c.create(100, 100, CV_32F);
+    }
+    stats = pool->getStats();
+    EXPECT_EQ(0u, stats.cachedBytes);
+    EXPECT_LE((size_t)480*640*3 + 100*100*4, stats.trimmedBytes);
+
+    // a block larger than the limit does not flush the cache
+    pool->setCacheLimit(1 << 20);
+    {
+        Mat d[5];
+        for( int i = 0; i < 5; i++ )
+        {
+            d[i].allocator = pool;
+            d[i].create(100, 100, CV_32F);
+        }
+    }
+    size_t cached = pool->getStats().cachedBytes;
+    EXPECT_LE((size_t)5*100*100*4, cached);
+    // the blocks are accounted in kilobytes, as against the limit
+    EXPECT_EQ(0u, cached % 1024);
+    {
+        Mat e;
+        e.allocator = pool;
+        e.create(1024, 1024, CV_32F);
+    }
+    EXPECT_EQ(cached, pool->getStats().cachedBytes);
+    pool->trim();
+
+    pool->setCacheLimit(limit);
+    pool->resetStats();
+}
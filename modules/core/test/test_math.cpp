@@ -2627,6 +2627,45 @@ TEST(Core_SVD, flt)
     EXPECT_LE(norm(B1, B, NORM_L2 + NORM_RELATIVE), FLT_EPSILON*10);
 }
 
+TEST(Core_SVD, large)
+{
+    // the matrices of this size are decomposed via bidiagonalization instead of Jacobi rotations
+    const int sizes[][2] = { {200, 150}, {150, 200}, {129, 129} };
+    for( int t = 0; t < 3; t++ )
+        for( int depth = CV_32F; depth <= CV_64F; depth++ )
+        {
+            Mat A(sizes[t][0], sizes[t][1], depth), w, u, vt;
+            RNG rng(t);
+            rng.fill(A, RNG::UNIFORM, -1, 1);
+            // make the matrix rank-deficient
+            A.col(3).copyTo(A.col(0));
+            A.row(3).copyTo(A.row(0));
+            SVD::compute(A, w, u, vt, SVD::FULL_UV);
+
+            int m = A.rows, n = A.cols, nm = std::min(m, n);
+            double eps = depth == CV_32F ? 1e-5 : 1e-12;
+            Mat wd, W = Mat::zeros(m, n, CV_64F);
+            w.convertTo(wd, CV_64F);
+            for( int i = 0; i < nm; i++ )
+            {
+                W.at<double>(i, i) = wd.at<double>(i);
+                if( i > 0 )
+                {
+                    ASSERT_GE(wd.at<double>(i-1), wd.at<double>(i));
+                }
+            }
+            W.convertTo(W, depth);
+            EXPECT_LE(norm(u*W*vt, A, NORM_INF), eps*norm(A, NORM_INF));
+            EXPECT_LE(norm(u*u.t(), Mat::eye(m, m, depth), NORM_INF), eps);
+            EXPECT_LE(norm(vt*vt.t(), Mat::eye(n, n, depth), NORM_INF), eps);
+            EXPECT_LE(wd.at<double>(nm-1), eps*10);
+
+            Mat w1;
+            SVD::compute(A, w1, SVD::NO_UV);
+            EXPECT_LE(norm(w, w1, NORM_INF), eps*norm(w, NORM_INF));
+        }
+}
+
 
 // TODO: eigenvv, invsqrt, cbrt, fastarctan, (round, floor, ceil(?)),
 
@@ -2754,5 +2793,37 @@ TEST(CovariationMatrixVectorOfMatWithMean, accuracy)
     ASSERT_EQ(sDiff.dot(sDiff), 0.0);
 }
 
+
+TEST(Core_GEMM, packed_vs_reference)
+{
+    RNG& rng = theRNG();
+    const int types[] = { CV_32FC1, CV_64FC1 };
+    const Size sizes[][2] = { { Size(300, 257), Size(131, 300) }, { Size(64, 9), Size(1030, 64) }, { Size(517, 33), Size(8, 517) } };
+
+    for( int ti = 0; ti < 2; ti++ )
+        for( int si = 0; si < 3; si++ )
+            for( int flags = 0; flags < 8; flags++ )
+            {
+                int type = types[ti];
+                Size sa = sizes[si][0], sb = sizes[si][1];
+                Mat A(flags & GEMM_1_T ? Size(sa.height, sa.width) : sa, type);
+                Mat B(flags & GEMM_2_T ? Size(sb.height, sb.width) : sb, type);
+                Size dsz(sb.width, sa.height);
+                Mat C(flags & GEMM_3_T ? Size(dsz.height, dsz.width) : dsz, type);
+                rng.fill(A, RNG::UNIFORM, -1, 1);
+                rng.fill(B, RNG::UNIFORM, -1, 1);
+                rng.fill(C, RNG::UNIFORM, -1, 1);
+
+                Mat dst, ref;
+                setUseOptimized(false);
+                gemm(A, B, 0.75, C, -1.5, ref, flags);
+                setUseOptimized(true);
+                gemm(A, B, 0.75, C, -1.5, dst, flags);
+
+                double eps = type == CV_32FC1 ? 1e-3 : 1e-10;
+                ASSERT_LE(norm(dst, ref, NORM_INF), eps) << "type=" << type << " size=" << si << " flags=" << flags;
+            }
+}
+
 /* End of file. */
 
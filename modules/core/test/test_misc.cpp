@@ -1,4 +1,17 @@
 #include "test_precomp.hpp"
+#include <fstream>
+#include <numeric>
+
+#if defined WIN32 || defined _WIN32
+#  include <windows.h>
+#  undef small
+#  undef min
+#  undef max
+#  undef abs
+#else
+#  include <pthread.h>
+#  include <unistd.h>
+#endif
 
 using namespace cv;
 using namespace std;
@@ -25,6 +38,95 @@ TEST(Core_Drawing, _914)
 }
 
 
+TEST(Core_Drawing, batch_matches_sequential)
+{
+    const int types[] = { CV_8UC3, CV_8UC1, CV_16UC4, CV_32FC1 };
+    const int lineTypes[] = { LINE_4, LINE_8, LINE_AA };
+    RNG& rng = theRNG();
+
+    for( int ti = 0; ti < 4; ti++ )
+    {
+        // some primitives cross the image borders and many cross the band borders
+        Size sz(rng.uniform(200, 500), rng.uniform(150, 400));
+        Mat base(sz, types[ti]), seq, res;
+        rng.fill(base, RNG::UNIFORM, 0, 200);
+        seq = base.clone();
+        DrawingBatch batch;
+
+        for( int k = 0; k < 300; k++ )
+        {
+            int shift = rng.uniform(0, 3) == 0 ? rng.uniform(1, 4) : 0;
+            int scale = 1 << shift;
+            Point p1(rng.uniform(-50, sz.width + 50)*scale, rng.uniform(-50, sz.height + 50)*scale);
+            Point p2(rng.uniform(-50, sz.width + 50)*scale, rng.uniform(-50, sz.height + 50)*scale);
+            Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+            int lineType = lineTypes[rng.uniform(0, 3)];
+            int thickness = rng.uniform(0, 4);
+
+            switch( rng.uniform(0, 6) )
+            {
+            case 0:
+                line(seq, p1, p2, color, thickness, lineType, shift);
+                batch.line(p1, p2, color, thickness, lineType, shift);
+                break;
+            case 1:
+            {
+                Rect r(Point(p1.x/scale, p1.y/scale), Size(rng.uniform(1, 100), rng.uniform(1, 100)));
+                thickness = rng.uniform(0, 2) ? thickness : -1;
+                rectangle(seq, r, color, thickness, lineType);
+                batch.rectangle(r, color, thickness, lineType);
+                break;
+            }
+            case 2:
+            {
+                int radius = rng.uniform(0, 80)*scale;
+                thickness = rng.uniform(0, 2) ? thickness : -1;
+                circle(seq, p1, radius, color, thickness, lineType, shift);
+                batch.circle(p1, radius, color, thickness, lineType, shift);
+                break;
+            }
+            case 3:
+            case 4:
+            {
+                vector<Point> v(rng.uniform(3, 8));
+                for( size_t j = 0; j < v.size(); j++ )
+                    v[j] = Point(p1.x + rng.uniform(-100, 100)*scale, p1.y + rng.uniform(-100, 100)*scale);
+                if( rng.uniform(0, 2) )
+                {
+                    polylines(seq, v, true, color, thickness, lineType, shift);
+                    batch.polylines(v, true, color, thickness, lineType, shift);
+                }
+                else
+                {
+                    fillPoly(seq, vector<vector<Point> >(1, v), color, lineType, shift);
+                    batch.fillPoly(v, color, lineType, shift);
+                }
+                break;
+            }
+            default:
+                putText(seq, "Label 42", Point(p1.x/scale, p1.y/scale), FONT_HERSHEY_SIMPLEX,
+                        0.5, color, std::max(thickness, 1), lineType);
+                batch.putText("Label 42", Point(p1.x/scale, p1.y/scale), FONT_HERSHEY_SIMPLEX,
+                              0.5, color, std::max(thickness, 1), lineType);
+            }
+        }
+
+        res = base.clone();
+        batch.draw(res);
+        ASSERT_EQ(0, norm(seq, res, NORM_INF)) << "type " << types[ti];
+
+        // blending with the original content
+        Mat blended;
+        addWeighted(seq, 0.25, base, 0.75, 0, blended);
+        res = base.clone();
+        batch.draw(res, 0.25);
+        ASSERT_EQ(0, norm(blended, res, NORM_INF)) << "type " << types[ti];
+
+        batch.clear();
+        ASSERT_EQ(0u, batch.size());
+    }
+}
+
 TEST(Core_OutputArraySreate, _1997)
 {
     struct local {
@@ -48,3 +150,301 @@ TEST(Core_SaturateCast, NegativeNotClipped)
 
     ASSERT_EQ(0xffffffff, val);
 }
+
+namespace
+{
+    class StripeCounter : public ParallelLoopBody
+    {
+    public:
+        StripeCounter(Mat& _hits) : hits(_hits) {}
+
+        void operator ()(const Range& r) const
+        {
+            for (int i = r.start; i < r.end; i++)
+                hits.at<int>(i)++;
+        }
+
+    private:
+        Mat& hits;
+    };
+}
+
+TEST(Core_Parallel, each_index_is_processed_once)
+{
+    const int len = 10007;
+    int nthreads = getNumThreads();
+
+    for (int threads = 1; threads <= 4; threads++)
+    {
+        setNumThreads(threads);
+        for (int k = 0; k < 4; k++)
+        {
+            double nstripes = k == 0 ? -1 : k == 1 ? 3 : k == 2 ? 64 : len;
+            Mat hits(1, len, CV_32S, Scalar(0));
+            parallel_for_(Range(0, len), StripeCounter(hits), nstripes);
+            EXPECT_EQ(len, countNonZero(hits == 1)) << "threads=" << threads << " nstripes=" << nstripes;
+        }
+    }
+
+    setNumThreads(nthreads);
+}
+
+namespace
+{
+    class NestedStripeCounter : public ParallelLoopBody
+    {
+    public:
+        NestedStripeCounter(Mat& _hits) : hits(_hits) {}
+
+        void operator ()(const Range& r) const
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                Mat row = hits.row(i);
+                parallel_for_(Range(0, hits.cols), StripeCounter(row), 8);
+            }
+        }
+
+    private:
+        Mat& hits;
+    };
+}
+
+TEST(Core_Parallel, nested_regions)
+{
+    int nthreads = getNumThreads();
+
+    for (int threads = 1; threads <= 4; threads++)
+    {
+        setNumThreads(threads);
+        Mat hits(37, 101, CV_32S, Scalar(0));
+        parallel_for_(Range(0, hits.rows), NestedStripeCounter(hits));
+        EXPECT_EQ((int)hits.total(), countNonZero(hits == 1)) << "threads=" << threads;
+    }
+
+    setNumThreads(nthreads);
+}
+
+namespace
+{
+    // marks the pool threads that run the stripes; every stripe takes about a millisecond
+    class ThreadRecorder : public ParallelLoopBody
+    {
+    public:
+        ThreadRecorder(std::vector<int>& _used) : used(_used) {}
+
+        void operator ()(const Range& r) const
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+#if defined WIN32 || defined _WIN32
+                Sleep(1);
+#else
+                usleep(1000);
+#endif
+                int t = getThreadNum();
+                if (t >= 0 && t < (int)used.size())
+                    CV_XADD(&used[t], 1);
+            }
+        }
+
+    private:
+        std::vector<int>& used;
+    };
+
+    struct ConcurrentRegion
+    {
+        ConcurrentRegion() : used(64, 0), nused(0) {}
+
+        void run()
+        {
+            parallel_for_(Range(0, 64), ThreadRecorder(used), 64);
+            nused = (int)used.size() - (int)std::count(used.begin(), used.end(), 0);
+        }
+
+        std::vector<int> used;
+        int nused;
+    };
+
+#if defined WIN32 || defined _WIN32
+    DWORD WINAPI runConcurrentRegion(LPVOID arg)
+    {
+        ((ConcurrentRegion*)arg)->run();
+        return 0;
+    }
+#else
+    void* runConcurrentRegion(void* arg)
+    {
+        ((ConcurrentRegion*)arg)->run();
+        return 0;
+    }
+#endif
+}
+
+TEST(Core_Parallel, concurrent_regions)
+{
+    // the regions started by different user threads at the same time are not treated as nested
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+
+    ConcurrentRegion regions[2];
+#if defined WIN32 || defined _WIN32
+    HANDLE threads[2];
+    for (int i = 0; i < 2; i++)
+        threads[i] = CreateThread(0, 0, runConcurrentRegion, &regions[i], 0, 0);
+    WaitForMultipleObjects(2, threads, TRUE, INFINITE);
+    for (int i = 0; i < 2; i++)
+        CloseHandle(threads[i]);
+    setNumThreads(nthreads);
+#else
+    pthread_t threads[2];
+    int started = 0;
+    while (started < 2 && pthread_create(&threads[started], 0, runConcurrentRegion, &regions[started]) == 0)
+        started++;
+    for (int i = 0; i < started; i++)
+        pthread_join(threads[i], 0);
+    setNumThreads(nthreads);
+    ASSERT_EQ(2, started);
+#endif
+
+    for (int i = 0; i < 2; i++)
+    {
+        EXPECT_EQ(64, std::accumulate(regions[i].used.begin(), regions[i].used.end(), 0));
+        EXPECT_GT(regions[i].nused, 1) << "region " << i;
+    }
+}
+
+TEST(Core_ScratchBuffer, reuses_thread_arena)
+{
+    // warm up the arena of this thread
+    {
+        ScratchBuffer<uchar> a(100000), b(50000);
+        memset(a, 1, a.size());
+        memset(b, 2, b.size());
+    }
+    int heapAllocs = getFastMallocCount();
+
+    for (int iter = 0; iter < 10; iter++)
+    {
+        ScratchBuffer<int> a(20000);
+        ScratchBuffer<double> b(5000);
+        EXPECT_EQ(0u, (size_t)(int*)a % 16);
+        EXPECT_EQ(0u, (size_t)(double*)b % 16);
+        EXPECT_TRUE((uchar*)(double*)b >= (uchar*)(int*)a + a.size()*sizeof(int) ||
+                    (uchar*)(int*)a >= (uchar*)(double*)b + b.size()*sizeof(double));
+
+        // the blocks released out of order are reclaimed when the arena gets empty
+        uchar* c = (uchar*)scratchMalloc(1000);
+        uchar* d = (uchar*)scratchMalloc(1000);
+        scratchFree(c);
+        scratchFree(d);
+    }
+
+    EXPECT_EQ(heapAllocs, getFastMallocCount());
+}
+
+TEST(Core_Trace, regions_and_counters)
+{
+    String chromeFile = tempfile(".json"), flatFile = tempfile(".txt");
+
+    bool wasEnabled = traceEnabled();
+    resetTrace();
+    setTraceEnabled(true);
+    {
+        TraceRegion region("Core_Trace.outer");
+        Mat hits(1, 1000, CV_32S, Scalar(0));
+        parallel_for_(Range(0, hits.cols), StripeCounter(hits), 4);
+        traceCounter("Core_Trace.counter", 42);
+        Mat m(100, 100, CV_8U);
+    }
+    setTraceEnabled(wasEnabled);
+
+    ASSERT_TRUE(writeTrace(chromeFile));
+    ASSERT_TRUE(writeTrace(flatFile, TRACE_FORMAT_FLAT));
+
+    std::string chrome, flat, line;
+    std::ifstream fc(chromeFile.c_str());
+    while (std::getline(fc, line))
+        chrome += line + "\n";
+    std::ifstream ff(flatFile.c_str());
+    while (std::getline(ff, line))
+        flat += line + "\n";
+    remove(chromeFile.c_str());
+    remove(flatFile.c_str());
+
+    EXPECT_EQ(0u, chrome.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, chrome.find("\"name\":\"Core_Trace.outer\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, chrome.find("\"name\":\"Core_Trace.counter\",\"ph\":\"C\""));
+    EXPECT_NE(std::string::npos, flat.find("Core_Trace.outer"));
+    EXPECT_NE(std::string::npos, flat.find("Core_Trace.counter"));
+
+    // the library functions are only instrumented with ENABLE_INSTRUMENTATION
+    if (haveTraceSupport())
+    {
+        EXPECT_NE(std::string::npos, chrome.find("\"name\":\"parallel_for_.stripe\""));
+        EXPECT_NE(std::string::npos, chrome.find("\"name\":\"fastMalloc\""));
+        EXPECT_NE(std::string::npos, flat.find("parallel_for_.stripes"));
+    }
+    else
+    {
+        EXPECT_EQ(std::string::npos, chrome.find("\"name\":\"parallel_for_.stripe\""));
+    }
+
+    resetTrace();
+}
+
+namespace
+{
+    // the first stripe keeps discarding and writing the trace while the others record events
+    class TraceResetter : public ParallelLoopBody
+    {
+    public:
+        TraceResetter(const String& _file) : file(_file) {}
+
+        void operator ()(const Range& r) const
+        {
+            for (int i = r.start; i < r.end; i++)
+            {
+                for (int k = 0; k < 2000; k++)
+                {
+                    if (i == 0)
+                    {
+                        resetTrace();
+                        if (k % 500 == 0)
+                            writeTrace(file, TRACE_FORMAT_FLAT);
+                    }
+                    else
+                    {
+                        TraceRegion region("Core_Trace.concurrent");
+                        traceCounter("Core_Trace.iteration", k);
+                    }
+                }
+            }
+        }
+
+    private:
+        String file;
+    };
+}
+
+TEST(Core_Trace, reset_while_recording)
+{
+    String file = tempfile(".txt");
+    bool wasEnabled = traceEnabled();
+    int nthreads = getNumThreads();
+    setNumThreads(4);
+    setTraceEnabled(true);
+    parallel_for_(Range(0, 8), TraceResetter(file), 8);
+    setTraceEnabled(wasEnabled);
+    setNumThreads(nthreads);
+
+    resetTrace();
+    ASSERT_TRUE(writeTrace(file, TRACE_FORMAT_FLAT));
+    std::string flat, line;
+    std::ifstream ff(file.c_str());
+    while (std::getline(ff, line))
+        flat += line + "\n";
+    ff.close();
+    remove(file.c_str());
+    EXPECT_EQ(std::string::npos, flat.find("Core_Trace.concurrent"));
+}
@@ -1214,3 +1214,65 @@ protected:
 };
 
 TEST(Core_SparseMat, iterations) { CV_SparseMatTest test; test.safe_run(); }
+
+TEST(Core_MatExpr, fused_elementwise)
+{
+    for( int depth = CV_32F; depth <= CV_64F; depth++ )
+    {
+        Mat a(37, 1029, CV_MAKETYPE(depth, 2)), b(a.size(), a.type()), c(a.size(), a.type());
+        Mat t, ref, dst;
+        randu(a, -10, 10);
+        randu(b, -10, 10);
+        randu(c, 1, 10);
+        double eps = depth == CV_32F ? 1e-4 : 1e-10;
+
+        addWeighted(a, 0.5, b, -0.25, 0, t);
+        subtract(t, c, ref);
+        dst = a*0.5 - b*0.25 - c;
+        EXPECT_EQ(a.type(), dst.type());
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps);
+
+        absdiff(a, b, t);
+        compare(t.reshape(1), 5, ref, CMP_GT);
+        MatExpr e = abs(a - b) > 5;
+        EXPECT_EQ(CV_8UC2, e.type());
+        dst = e;
+        EXPECT_EQ(0, norm(dst.reshape(1), ref, NORM_INF));
+
+        compare(c.reshape(1), Mat(t + Scalar::all(1)).reshape(1), ref, CMP_GE);
+        dst = c >= abs(a - b) + Scalar::all(1);
+        EXPECT_EQ(0, norm(dst.reshape(1), ref, NORM_INF));
+
+        add(a, b, t);
+        max(t, c, t);
+        min(t, 7, ref);
+        dst = min(max(a + b, c), 7);
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps);
+
+        add(a, b, t);
+        multiply(t, c, t, 2);
+        divide(t, c, ref, 0.5);
+        dst = ((a + b).mul(c, 2)/c)*0.5;
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps);
+
+        addWeighted(a, 3, b, 3, 0, t);
+        subtract(Scalar::all(1), t, ref);
+        dst = Scalar::all(1) - (a + b)*3;
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps*10);
+
+        // the result may overwrite an operand
+        Mat acc = a.clone();
+        addWeighted(a, 0.9, b, 0.1, 0, t);
+        subtract(t, c, ref);
+        acc = acc*0.9 + b*0.1 - c;
+        EXPECT_LE(norm(acc, ref, NORM_INF), eps);
+
+        // non-continuous operands
+        Rect r(3, 5, 500, 20);
+        subtract(Mat(a*2 + b)(r), c(r), ref);
+        dst = a(r)*2 + b(r) - c(r);
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps);
+        dst = (a*2 + b - c)(r);
+        EXPECT_LE(norm(dst, ref, NORM_INF), eps);
+    }
+}
@@ -365,3 +365,142 @@ TEST(Core_RNG_MT19937, regression)
         ASSERT_EQ(expected[i], actual[i]);
     }
 }
+
+TEST(Core_RNG_Philox, known_answer)
+{
+    // Philox4x32-10, counter = {0, 0, 0, 0}, key = {0, 0}
+    cv::RNG_Philox rng(0, 0);
+    unsigned expected[] = { 0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U };
+    for( int i = 0; i < 4; i++ )
+        ASSERT_EQ(expected[i], rng.next());
+}
+
+TEST(Core_RNG_Philox, skip_and_split)
+{
+    cv::RNG_Philox a(2013), b(2013);
+    for( int i = 0; i < 1001; i++ )
+        a.next();
+    b.skip(1000);
+    b.next();
+    for( int i = 0; i < 10; i++ )
+        ASSERT_EQ(a.next(), b.next());
+
+    cv::RNG_Philox c = a.split(1), d(2013, 1);
+    int same = 0;
+    for( int i = 0; i < 100; i++ )
+    {
+        unsigned v = c.next();
+        ASSERT_EQ(d.next(), v);
+        same += v == a.next();
+    }
+    ASSERT_LT(same, 3);
+}
+
+TEST(Core_RNG_Philox, fill_reproducible)
+{
+    const int types[] = { CV_8UC1, CV_8SC3, CV_16UC2, CV_16SC1, CV_32SC4, CV_32FC3, CV_64FC1 };
+    const int ntypes = (int)(sizeof(types)/sizeof(types[0]));
+    int nthreads = cv::getNumThreads();
+
+    for( int t = 0; t < ntypes; t++ )
+        for( int dist = cv::RNG::UNIFORM; dist <= cv::RNG::NORMAL; dist++ )
+        {
+            cv::Mat a(301, 517, types[t]), b(a.size(), a.type());
+            cv::Mat big(400, 600, a.type());
+            cv::Mat c = big(cv::Rect(3, 5, a.cols, a.rows));
+            cv::Scalar p1 = cv::Scalar::all(-10), p2 = cv::Scalar::all(77);
+
+            cv::setNumThreads(1);
+            cv::RNG_Philox ra(99);
+            ra.fill(a, dist, p1, p2);
+            cv::setNumThreads(nthreads);
+            cv::RNG_Philox rb(99);
+            rb.fill(b, dist, p1, p2);
+            cv::RNG_Philox rc(99);
+            if( dist == cv::RNG::UNIFORM )
+                cv::randu(c, p1, p2, rc);
+            else
+                cv::randn(c, p1, p2, rc);
+
+            ASSERT_EQ(0, cv::norm(a, b, cv::NORM_INF));
+            ASSERT_EQ(0, cv::norm(a, c, cv::NORM_INF));
+            ASSERT_EQ(ra.getCounter(), rb.getCounter());
+
+            // a subsequent fill continues the stream rather than repeating it
+            ra.fill(b, dist, p1, p2);
+            ASSERT_GT(cv::norm(a, b, cv::NORM_INF), 0);
+
+            cv::Scalar mean, stddev;
+            cv::meanStdDev(a.reshape(1), mean, stddev);
+            if( types[t] == CV_32FC3 || types[t] == CV_64FC1 || types[t] == CV_32SC4 )
+            {
+                if( dist == cv::RNG::UNIFORM )
+                {
+                    ASSERT_NEAR(33.5, mean[0], 0.5);
+                    ASSERT_NEAR(87/std::sqrt(12.), stddev[0], 0.5);
+                }
+                else
+                {
+                    ASSERT_NEAR(-10, mean[0], 0.5);
+                    ASSERT_NEAR(77, stddev[0], 0.5);
+                }
+            }
+        }
+}
+
+TEST(Core_RNG_Philox, fill_matches_next)
+{
+    cv::Mat m(123, 457, CV_8UC3);
+    cv::RNG_Philox a(12345, 7), b(12345, 7);
+    a.fill(m, cv::RNG::UNIFORM, 0, 256);
+    for( int i = 0; i < m.rows; i++ )
+        for( int j = 0; j < m.cols*m.channels(); j++ )
+            ASSERT_EQ((int)(b.next() & 255), (int)m.ptr<uchar>(i)[j]);
+}
+
+TEST(Core_RNG_Philox, setCounter)
+{
+    // moving to any position, within a block of 4 outputs or not, gives the same outputs
+    // as reaching it by next(), and the fills continue from there
+    cv::RNG_Philox a(5, 3), b(5, 3);
+    unsigned ref[40];
+    for( int i = 0; i < 40; i++ )
+        ref[i] = a.next();
+
+    const int pos[] = { 13, 2, 0, 35, 8, 21 };
+    for( int k = 0; k < 6; k++ )
+    {
+        b.setCounter(pos[k]);
+        ASSERT_EQ((uint64)pos[k], b.getCounter());
+        for( int i = pos[k]; i < 40; i++ )
+            ASSERT_EQ(ref[i], b.next()) << "pos=" << pos[k] << ", i=" << i;
+    }
+
+    cv::Mat m1(7, 9, CV_32S), m2(m1.size(), m1.type());
+    a.setCounter(6);
+    a.fill(m1, cv::RNG::UNIFORM, cv::Scalar::all(INT_MIN), cv::Scalar::all(INT_MAX));
+    b.setCounter(8);
+    b.fill(m2, cv::RNG::UNIFORM, cv::Scalar::all(INT_MIN), cv::Scalar::all(INT_MAX));
+    ASSERT_EQ(0, cv::norm(m1, m2, cv::NORM_INF));
+    ASSERT_EQ(a.getCounter(), b.getCounter());
+}
+
+TEST(Core_RNG_Philox, randShuffle)
+{
+    cv::Mat a(1, 1000, CV_32S), b;
+    for( int i = 0; i < a.cols; i++ )
+        a.at<int>(i) = i;
+    b = a.clone();
+
+    cv::RNG_Philox ra(7), rb(7);
+    cv::randShuffle(a, 1., ra);
+    cv::randShuffle(b, 1., rb);
+    ASSERT_EQ(0, cv::norm(a, b, cv::NORM_INF));
+    ASSERT_EQ(ra.getCounter(), rb.getCounter());
+
+    cv::Mat sorted;
+    cv::sort(a, sorted, cv::SORT_EVERY_ROW + cv::SORT_ASCENDING);
+    for( int i = 0; i < a.cols; i++ )
+        ASSERT_EQ(i, sorted.at<int>(i));
+    ASSERT_GT(cv::countNonZero(a != sorted), a.cols/2);
+}
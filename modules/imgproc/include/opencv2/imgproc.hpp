@@ -935,6 +935,14 @@ CV_EXPORTS_W void bilateralFilter( InputArray src, OutputArray dst, int d,
                                    double sigmaColor, double sigmaSpace,
                                    int borderType = BORDER_DEFAULT );
 
+//! approximates bilateralFilter by splatting the pixels into a coarse grid, blurring it and slicing it;
+//! the cost does not depend on sigmaSpace, so it suits large spatial sigmas. 1-channel images use
+//! a bilateral grid, 3-channel images use a permutohedral lattice over (x, y, c0, c1, c2), so their
+//! colors are compared by the Euclidean distance. The image is processed in horizontal bands,
+//! so the memory stays bounded for any sigmas
+CV_EXPORTS_W void bilateralGridFilter( InputArray src, OutputArray dst,
+                                       double sigmaColor, double sigmaSpace );
+
 //! smooths the image using the box filter. Each pixel is processed in O(1) time
 CV_EXPORTS_W void boxFilter( InputArray src, OutputArray dst, int ddepth,
                              Size ksize, Point anchor = Point(-1,-1),
@@ -1262,6 +1270,12 @@ CV_EXPORTS_W int floodFill( InputOutputArray image, InputOutputArray mask,
 //! converts image from one color space to another
 CV_EXPORTS_W void cvtColor( InputArray src, OutputArray dst, int code, int dstCn = 0 );
 
+//! converts a 8-bit image (BGR, BGRA, gray, NV12 or NV21; see code) to 3 channels, resizes it
+//! bilinearly to dsize, computes scale*x + shift[c] and stores the result as a planar 1 x cn x H x W
+//! CV_32F blob in a single pass. code = -1 keeps the source channels
+CV_EXPORTS_W void resizeToPlanar( InputArray src, OutputArray dst, Size dsize, int code = -1,
+                                  double scale = 1, const Scalar& shift = Scalar() );
+
 // main function for all demosaicing procceses
 CV_EXPORTS_W void demosaicing(InputArray _src, OutputArray _dst, int code, int dcn = 0);
 
@@ -36,3 +36,78 @@ PERF_TEST_P( TestBilateralFilter, BilateralFilter,
 
     SANITY_CHECK(dst);
 }
+
+typedef TestBaseWithParam< tr1::tuple<Size, double, Mat_Type> > TestBilateralGrid;
+
+// the direct filter has O(sigmaSpace^2) cost per pixel, the grid filter does not depend on sigmaSpace
+PERF_TEST_P( TestBilateralGrid, BilateralFilter_largeSigma,
+             Combine(
+                Values( szVGA ), // image size
+                Values( 4., 8. ), // sigmaSpace
+                ValuesIn( Mat_Type::all() ) // image type
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    double sigmaSpace = get<1>(GetParam());
+    int type = get<2>(GetParam());
+    double sigmaColor = CV_MAT_DEPTH(type) == CV_8U ? 25. : 0.1;
+
+    Mat src(sz, type);
+    Mat dst(sz, type);
+
+    declare.in(src, WARMUP_RNG).out(dst).time(60);
+
+    TEST_CYCLE() bilateralFilter(src, dst, -1, sigmaColor, sigmaSpace);
+
+    SANITY_CHECK(dst, 1);
+}
+
+PERF_TEST_P( TestBilateralGrid, BilateralGridFilter,
+             Combine(
+                Values( szVGA, sz1080p, Size(3840, 2160) ), // image size
+                Values( 4., 8., 16. ), // sigmaSpace
+                ValuesIn( Mat_Type::all() ) // image type
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    double sigmaSpace = get<1>(GetParam());
+    int type = get<2>(GetParam());
+    bool is8u = CV_MAT_DEPTH(type) == CV_8U;
+    double sigmaColor = is8u ? 25. : 0.1;
+
+    // a smooth image with edges and noise, so the quality against the direct filter is meaningful
+    Mat src(sz, type), noise(sz, type);
+    Mat gx(1, sz.width, CV_32F), gy(sz.height, 1, CV_32F), ramp;
+    for( int j = 0; j < sz.width; j++ )
+        gx.at<float>(j) = (float)(j < sz.width/2 ? 0.25 : 0.75) + 0.1f*(float)std::sin(j*0.02);
+    for( int i = 0; i < sz.height; i++ )
+        gy.at<float>(i) = (float)(i < sz.height/2 ? 0 : 0.15);
+    ramp = repeat(gx, sz.height, 1) + repeat(gy, 1, sz.width);
+    if( CV_MAT_CN(type) == 3 )
+        merge(std::vector<Mat>(3, ramp), ramp);
+    ramp.convertTo(src, type, is8u ? 255 : 1);
+    randn(noise, 0, is8u ? 12 : 0.05);
+    add(src, noise, src);
+    Mat dst(sz, type);
+
+    declare.in(src).out(dst).time(30);
+
+    TEST_CYCLE() bilateralGridFilter(src, dst, sigmaColor, sigmaSpace);
+
+    // the quality is reported against the direct filter on the VGA image only (it is slow)
+    if( sz == szVGA )
+    {
+        Mat ref;
+        bilateralFilter(src, ref, -1, sigmaColor, sigmaSpace);
+        double rms = norm(ref, dst, NORM_L2)/std::sqrt((double)ref.total()*ref.channels());
+        double psnr = 20*std::log10((is8u ? 255. : 1.)/rms);
+        RecordProperty("psnr", cv::format("%.2f", psnr).c_str());
+        // 3-channel colors are compared by the Euclidean distance instead of the L1 one,
+        // so independent noise in the channels is smoothed more than by the direct filter
+        EXPECT_GT(psnr, CV_MAT_CN(type) == 1 ? 40. : 30.);
+    }
+
+    SANITY_CHECK(dst, is8u ? 1 : 1e-3);
+}
@@ -263,6 +263,38 @@ PERF_TEST_P(Size_CvtMode, cvtColor8u,
     SANITY_CHECK(dst, 1);
 }
 
+CV_ENUM(CvtMode32F,
+    COLOR_BGR2GRAY, COLOR_BGRA2GRAY, COLOR_BGR2RGB, COLOR_BGR2BGRA, COLOR_BGRA2BGR,
+    COLOR_BGR2YCrCb, CX_BGRA2YCrCb, COLOR_YCrCb2BGR, CX_YCrCb2BGRA,
+    COLOR_BGR2HSV, CX_BGRA2HSV, COLOR_BGR2Lab, COLOR_BGR2XYZ
+    )
+
+typedef std::tr1::tuple<Size, CvtMode32F> Size_CvtMode32F_t;
+typedef perf::TestBaseWithParam<Size_CvtMode32F_t> Size_CvtMode32F;
+
+PERF_TEST_P(Size_CvtMode32F, cvtColor32f,
+            testing::Combine(
+                testing::Values(::perf::szODD, ::perf::szVGA, ::perf::sz1080p),
+                testing::ValuesIn(CvtMode32F::all())
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int mode = get<1>(GetParam());
+    ChPair ch = getConversionInfo(mode);
+    mode %= COLOR_COLORCVT_MAX;
+
+    Mat src(sz, CV_32FC(ch.scn));
+    Mat dst(sz, CV_32FC(ch.dcn));
+
+    declare.time(100);
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    TEST_CYCLE() cvtColor(src, dst, mode, ch.dcn);
+
+    SANITY_CHECK(dst, 1e-4, ERROR_RELATIVE);
+}
+
 typedef std::tr1::tuple<Size, CvtModeBayer> Size_CvtMode_Bayer_t;
 typedef perf::TestBaseWithParam<Size_CvtMode_Bayer_t> Size_CvtMode_Bayer;
 
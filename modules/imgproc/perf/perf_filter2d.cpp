@@ -74,3 +74,31 @@ PERF_TEST_P( Image_KernelSize, GaborFilter2d,
 }
 
 
+
+typedef TestBaseWithParam< tr1::tuple<Size, int> > Size_Threads;
+
+PERF_TEST_P( Size_Threads, Filter2d_threads,
+             Combine(
+                Values( sz1080p, sz2160p ),
+                Values( 1, 2, 4, 8 )
+             )
+)
+{
+    Size sz = get<0>(GetParam());
+    int threads = get<1>(GetParam());
+
+    Mat src(sz, CV_8UC1);
+    Mat dst(sz, CV_8UC1);
+
+    Mat kernel(5, 5, CV_32FC1);
+    randu(kernel, -3, 10);
+    double s = fabs( sum(kernel)[0] );
+    if(s > 1e-3) kernel /= s;
+
+    declare.in(src, WARMUP_RNG).out(dst).tbb_threads(threads);
+
+    TEST_CYCLE() filter2D(src, dst, CV_8U, kernel, Point(-1, -1), 0., BORDER_REFLECT_101);
+
+    setNumThreads(-1);
+    SANITY_CHECK(dst, 1);
+}
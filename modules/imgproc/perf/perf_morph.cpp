@@ -38,3 +38,28 @@ PERF_TEST_P(Size_MatType, dilate, TYPICAL_MATS_MORPH)
 
     SANITY_CHECK(dst);
 }
+
+typedef std::tr1::tuple<Size, int> Size_Threads_t;
+typedef perf::TestBaseWithParam<Size_Threads_t> Size_Threads;
+
+PERF_TEST_P(Size_Threads, erode_threads,
+            testing::Combine(
+                testing::Values(sz1080p, sz2160p),
+                testing::Values(1, 2, 4, 8)
+                )
+            )
+{
+    Size sz = get<0>(GetParam());
+    int threads = get<1>(GetParam());
+
+    Mat src(sz, CV_8UC1);
+    Mat dst(sz, CV_8UC1);
+    Mat elem = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
+
+    declare.in(src, WARMUP_RNG).out(dst).tbb_threads(threads);
+
+    TEST_CYCLE() erode(src, dst, elem);
+
+    setNumThreads(-1);
+    SANITY_CHECK(dst);
+}
@@ -0,0 +1,70 @@
+#include "perf_precomp.hpp"
+
+using namespace std;
+using namespace cv;
+using namespace perf;
+using std::tr1::make_tuple;
+using std::tr1::get;
+
+CV_ENUM(PreprocessCode, COLOR_YUV2BGR_NV12, COLOR_BGR2RGB)
+
+typedef std::tr1::tuple<Size, Size, PreprocessCode> Size_Size_Code_t;
+typedef perf::TestBaseWithParam<Size_Size_Code_t> Size_Size_Code;
+
+#define PREPROCESS_PARAMS testing::Combine( \
+                testing::Values(szVGA, sz720p, sz1080p), \
+                testing::Values(Size(224, 224), Size(640, 360)), \
+                testing::ValuesIn(PreprocessCode::all()) \
+                )
+
+static Mat makePreprocessSource(Size sz, int code)
+{
+    return code == COLOR_YUV2BGR_NV12 ? Mat(sz.height*3/2, sz.width, CV_8UC1) : Mat(sz, CV_8UC3);
+}
+
+static Mat planarView(const Mat& blob)
+{
+    return Mat(blob.size[1]*blob.size[2], blob.size[3], CV_32F, blob.data);
+}
+
+PERF_TEST_P(Size_Size_Code, resizeToPlanar_fused, PREPROCESS_PARAMS)
+{
+    Size from = get<0>(GetParam());
+    Size to = get<1>(GetParam());
+    int code = get<2>(GetParam());
+    Mat src = makePreprocessSource(from, code);
+    Mat blob;
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE() resizeToPlanar(src, blob, to, code, 1./255, Scalar(-0.5, -0.5, -0.5));
+
+    Mat dst = planarView(blob);
+    SANITY_CHECK(dst, 1e-4);
+}
+
+PERF_TEST_P(Size_Size_Code, resizeToPlanar_chain, PREPROCESS_PARAMS)
+{
+    Size from = get<0>(GetParam());
+    Size to = get<1>(GetParam());
+    int code = get<2>(GetParam());
+    Mat src = makePreprocessSource(from, code);
+    int sz[] = { 1, 3, to.height, to.width };
+    Mat blob(4, sz, CV_32F), cvt, resized, fl;
+    vector<Mat> planes;
+    for( int k = 0; k < 3; k++ )
+        planes.push_back(Mat(to, CV_32F, blob.ptr(0, k)));
+
+    declare.in(src, WARMUP_RNG);
+
+    TEST_CYCLE()
+    {
+        cvtColor(src, cvt, code);
+        resize(cvt, resized, to, 0, 0, INTER_LINEAR);
+        resized.convertTo(fl, CV_32F, 1./255, -0.5);
+        split(fl, planes);
+    }
+
+    Mat dst = planarView(blob);
+    SANITY_CHECK(dst, 1e-2);
+}
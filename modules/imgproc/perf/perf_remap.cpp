@@ -67,3 +67,60 @@ PERF_TEST_P( TestRemap, Remap,
 
     SANITY_CHECK(dst);
 }
+
+// runs remap() once in every thread of the pool, so that all their scratch arenas are warmed up;
+// the stripes wait for each other, so no thread can take two of them
+class RemapWarmUpInvoker : public ParallelLoopBody
+{
+public:
+    RemapWarmUpInvoker(const Mat& _src, const Mat& _map1, const Mat& _map2, int _nstripes, int* _started) :
+        src(_src), map1(_map1), map2(_map2), nstripes(_nstripes), started(_started) {}
+
+    void operator()(const cv::Range& range) const
+    {
+        // the wait is bounded, in case the pool has fewer threads than stripes
+        CV_XADD(started, range.end - range.start);
+        int64 t0 = getTickCount();
+        while (CV_XADD(started, 0) < nstripes && getTickCount() - t0 < getTickFrequency())
+            ;
+
+        // with the thread pool frameworks the nested remap() runs all its stripes in this thread
+        Mat dst;
+        remap(src, dst, map1, map2, INTER_LINEAR);
+    }
+
+private:
+    const Mat& src;
+    const Mat& map1;
+    const Mat& map2;
+    int nstripes;
+    int* started;
+};
+
+PERF_TEST(Remap, steady_state_no_fastmalloc)
+{
+    Size sz = szVGA;
+    Mat src(sz, CV_8UC3), dst(sz, CV_8UC3), map1(sz, CV_32FC1), map2(sz, CV_32FC1);
+
+    for (int j = 0; j < sz.height; ++j)
+        for (int i = 0; i < sz.width; ++i)
+        {
+            map1.at<float>(j, i) = (float)(sz.width - i - 1) * 0.9f;
+            map2.at<float>(j, i) = (float)j * 0.9f;
+        }
+
+    declare.in(src, WARMUP_RNG).out(dst);
+
+    remap(src, dst, map1, map2, INTER_LINEAR);
+    int nthreads = getNumThreads(), started = 0;
+    parallel_for_(cv::Range(0, nthreads), RemapWarmUpInvoker(src, map1, map2, nthreads, &started), nthreads);
+    int heapAllocs = getFastMallocCount();
+
+    TEST_CYCLE() remap(src, dst, map1, map2, INTER_LINEAR);
+
+    // the temporary buffers of the warmed up calls come from the scratch arenas,
+    // nothing is allocated with fastMalloc
+    EXPECT_EQ(heapAllocs, getFastMallocCount());
+
+    SANITY_CHECK(dst, 1);
+}
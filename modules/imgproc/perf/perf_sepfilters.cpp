@@ -242,3 +242,50 @@ PERF_TEST_P(Size_MatType_dx_dy_Border3x3ROI, scharrViaSobelFilter,
 
     SANITY_CHECK(dst);
 }
+
+/**************** Thread scaling ********************/
+
+typedef std::tr1::tuple<Size, int> Size_Threads_t;
+typedef perf::TestBaseWithParam<Size_Threads_t> Size_Threads;
+
+PERF_TEST_P(Size_Threads, gaussianBlur5x5_threads,
+            testing::Combine(
+                testing::Values(sz1080p, sz2160p),
+                testing::Values(1, 2, 4, 8)
+            )
+          )
+{
+    Size size = get<0>(GetParam());
+    int threads = get<1>(GetParam());
+
+    Mat src(size, CV_8UC1);
+    Mat dst(size, CV_8UC1);
+
+    declare.in(src, WARMUP_RNG).out(dst).tbb_threads(threads);
+
+    TEST_CYCLE() GaussianBlur(src, dst, Size(5, 5), 0);
+
+    setNumThreads(-1);
+    SANITY_CHECK(dst, 1);
+}
+
+PERF_TEST_P(Size_Threads, sobelFilter_threads,
+            testing::Combine(
+                testing::Values(sz1080p, sz2160p),
+                testing::Values(1, 2, 4, 8)
+            )
+          )
+{
+    Size size = get<0>(GetParam());
+    int threads = get<1>(GetParam());
+
+    Mat src(size, CV_8UC1);
+    Mat dst(size, CV_16SC1);
+
+    declare.in(src, WARMUP_RNG).out(dst).tbb_threads(threads);
+
+    TEST_CYCLE() Sobel(src, dst, CV_16S, 1, 0, 3);
+
+    setNumThreads(-1);
+    SANITY_CHECK(dst);
+}
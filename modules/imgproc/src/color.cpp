@@ -191,16 +191,336 @@ void CvtColorLoop(const Mat& src, Mat& dst, const Cvt& cvt)
     parallel_for_(Range(0, src.rows), CvtColorLoop_Invoker<Cvt>(src, dst, cvt), src.total()/(double)(1<<16) );
 }
 
+#if CV_SSE2
+
+// The deinterleaving functions take 6 (3-channel) or 4 (4-channel) consecutive vectors of
+// interleaved pixels and put the channels into separate vectors: (v0, v1) take channel 0 and so on
+// (for 4 channels v0..v3 take channels 0..3). One unpack layer is a perfect shuffle of the elements;
+// repeating it log2(elements per vector)+1 times sorts the elements by channel.
+// The interleaving functions do the inverse.
+
+static inline void _mm_deinterleave_epi8(__m128i& v0, __m128i& v1, __m128i& v2,
+                                         __m128i& v3, __m128i& v4, __m128i& v5)
+{
+    for( int k = 0; k < 5; k++ )
+    {
+        __m128i t0 = _mm_unpacklo_epi8(v0, v3), t1 = _mm_unpackhi_epi8(v0, v3);
+        __m128i t2 = _mm_unpacklo_epi8(v1, v4), t3 = _mm_unpackhi_epi8(v1, v4);
+        __m128i t4 = _mm_unpacklo_epi8(v2, v5), t5 = _mm_unpackhi_epi8(v2, v5);
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3; v4 = t4; v5 = t5;
+    }
+}
+
+static inline void _mm_interleave_epi8(__m128i& v0, __m128i& v1, __m128i& v2,
+                                       __m128i& v3, __m128i& v4, __m128i& v5)
+{
+    const __m128i m = _mm_set1_epi16(0xff);
+    for( int k = 0; k < 5; k++ )
+    {
+        __m128i t0 = _mm_packus_epi16(_mm_and_si128(v0, m), _mm_and_si128(v1, m));
+        __m128i t3 = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+        __m128i t1 = _mm_packus_epi16(_mm_and_si128(v2, m), _mm_and_si128(v3, m));
+        __m128i t4 = _mm_packus_epi16(_mm_srli_epi16(v2, 8), _mm_srli_epi16(v3, 8));
+        __m128i t2 = _mm_packus_epi16(_mm_and_si128(v4, m), _mm_and_si128(v5, m));
+        __m128i t5 = _mm_packus_epi16(_mm_srli_epi16(v4, 8), _mm_srli_epi16(v5, 8));
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3; v4 = t4; v5 = t5;
+    }
+}
+
+static inline void _mm_deinterleave_epi8(__m128i& v0, __m128i& v1, __m128i& v2, __m128i& v3)
+{
+    for( int k = 0; k < 4; k++ )
+    {
+        __m128i t0 = _mm_unpacklo_epi8(v0, v2), t1 = _mm_unpackhi_epi8(v0, v2);
+        __m128i t2 = _mm_unpacklo_epi8(v1, v3), t3 = _mm_unpackhi_epi8(v1, v3);
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3;
+    }
+}
+
+static inline void _mm_interleave_epi8(__m128i& v0, __m128i& v1, __m128i& v2, __m128i& v3)
+{
+    const __m128i m = _mm_set1_epi16(0xff);
+    for( int k = 0; k < 4; k++ )
+    {
+        __m128i t0 = _mm_packus_epi16(_mm_and_si128(v0, m), _mm_and_si128(v1, m));
+        __m128i t2 = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+        __m128i t1 = _mm_packus_epi16(_mm_and_si128(v2, m), _mm_and_si128(v3, m));
+        __m128i t3 = _mm_packus_epi16(_mm_srli_epi16(v2, 8), _mm_srli_epi16(v3, 8));
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3;
+    }
+}
+
+static inline void _mm_deinterleave_ps(__m128& v0, __m128& v1, __m128& v2,
+                                       __m128& v3, __m128& v4, __m128& v5)
+{
+    for( int k = 0; k < 3; k++ )
+    {
+        __m128 t0 = _mm_unpacklo_ps(v0, v3), t1 = _mm_unpackhi_ps(v0, v3);
+        __m128 t2 = _mm_unpacklo_ps(v1, v4), t3 = _mm_unpackhi_ps(v1, v4);
+        __m128 t4 = _mm_unpacklo_ps(v2, v5), t5 = _mm_unpackhi_ps(v2, v5);
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3; v4 = t4; v5 = t5;
+    }
+}
+
+static inline void _mm_interleave_ps(__m128& v0, __m128& v1, __m128& v2,
+                                     __m128& v3, __m128& v4, __m128& v5)
+{
+    for( int k = 0; k < 3; k++ )
+    {
+        __m128 t0 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 t3 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 t1 = _mm_shuffle_ps(v2, v3, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 t4 = _mm_shuffle_ps(v2, v3, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 t2 = _mm_shuffle_ps(v4, v5, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 t5 = _mm_shuffle_ps(v4, v5, _MM_SHUFFLE(3, 1, 3, 1));
+        v0 = t0; v1 = t1; v2 = t2; v3 = t3; v4 = t4; v5 = t5;
+    }
+}
+
+// loads 8 pixels of a 3- or 4-channel float image as the planes c0, c1, c2 (2 vectors each)
+static inline void _mm_load_deinterleave_ps(const float* src, int scn, __m128* c0, __m128* c1, __m128* c2)
+{
+    if( scn == 3 )
+    {
+        __m128 v0 = _mm_loadu_ps(src), v1 = _mm_loadu_ps(src + 4), v2 = _mm_loadu_ps(src + 8);
+        __m128 v3 = _mm_loadu_ps(src + 12), v4 = _mm_loadu_ps(src + 16), v5 = _mm_loadu_ps(src + 20);
+        _mm_deinterleave_ps(v0, v1, v2, v3, v4, v5);
+        c0[0] = v0; c0[1] = v1; c1[0] = v2; c1[1] = v3; c2[0] = v4; c2[1] = v5;
+    }
+    else
+    {
+        for( int k = 0; k < 2; k++, src += 16 )
+        {
+            __m128 v0 = _mm_loadu_ps(src), v1 = _mm_loadu_ps(src + 4);
+            __m128 v2 = _mm_loadu_ps(src + 8), v3 = _mm_loadu_ps(src + 12);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            c0[k] = v0; c1[k] = v1; c2[k] = v2;
+        }
+    }
+}
+
+// stores 8 pixels of a 3-channel float image given as the planes c0, c1, c2
+static inline void _mm_interleave_store_ps(float* dst, const __m128* c0, const __m128* c1, const __m128* c2)
+{
+    __m128 v0 = c0[0], v1 = c0[1], v2 = c1[0], v3 = c1[1], v4 = c2[0], v5 = c2[1];
+    _mm_interleave_ps(v0, v1, v2, v3, v4, v5);
+    _mm_storeu_ps(dst, v0); _mm_storeu_ps(dst + 4, v1); _mm_storeu_ps(dst + 8, v2);
+    _mm_storeu_ps(dst + 12, v3); _mm_storeu_ps(dst + 16, v4); _mm_storeu_ps(dst + 20, v5);
+}
+
+// stores 8 pixels of a 3- or 4-channel float image; the 4th channel is filled with alpha
+static inline void _mm_interleave_store_ps(float* dst, int dcn, const __m128* c0, const __m128* c1,
+                                           const __m128* c2, __m128 alpha)
+{
+    if( dcn == 3 )
+        _mm_interleave_store_ps(dst, c0, c1, c2);
+    else
+    {
+        for( int k = 0; k < 2; k++, dst += 16 )
+        {
+            __m128 v0 = c0[k], v1 = c1[k], v2 = c2[k], v3 = alpha;
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            _mm_storeu_ps(dst, v0); _mm_storeu_ps(dst + 4, v1);
+            _mm_storeu_ps(dst + 8, v2); _mm_storeu_ps(dst + 12, v3);
+        }
+    }
+}
+
+// loads 32 pixels of a 3- or 4-channel 8-bit image as the planes c0, c1, c2 (and c3 if scn == 4)
+static inline void _mm_load_deinterleave_epi8(const uchar* src, int scn, __m128i* c0, __m128i* c1,
+                                              __m128i* c2, __m128i* c3 = 0)
+{
+    if( scn == 3 )
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)src), v1 = _mm_loadu_si128((const __m128i*)(src + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(src + 32)), v3 = _mm_loadu_si128((const __m128i*)(src + 48));
+        __m128i v4 = _mm_loadu_si128((const __m128i*)(src + 64)), v5 = _mm_loadu_si128((const __m128i*)(src + 80));
+        _mm_deinterleave_epi8(v0, v1, v2, v3, v4, v5);
+        c0[0] = v0; c0[1] = v1; c1[0] = v2; c1[1] = v3; c2[0] = v4; c2[1] = v5;
+    }
+    else
+    {
+        for( int k = 0; k < 2; k++, src += 64 )
+        {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)src), v1 = _mm_loadu_si128((const __m128i*)(src + 16));
+            __m128i v2 = _mm_loadu_si128((const __m128i*)(src + 32)), v3 = _mm_loadu_si128((const __m128i*)(src + 48));
+            _mm_deinterleave_epi8(v0, v1, v2, v3);
+            c0[k] = v0; c1[k] = v1; c2[k] = v2;
+            if( c3 )
+                c3[k] = v3;
+        }
+    }
+}
+
+// stores 32 pixels of a 3- or 4-channel 8-bit image given as the planes c0, c1, c2 (and c3 if dcn == 4)
+static inline void _mm_interleave_store_epi8(uchar* dst, int dcn, const __m128i* c0, const __m128i* c1,
+                                             const __m128i* c2, const __m128i* c3 = 0)
+{
+    if( dcn == 3 )
+    {
+        __m128i v0 = c0[0], v1 = c0[1], v2 = c1[0], v3 = c1[1], v4 = c2[0], v5 = c2[1];
+        _mm_interleave_epi8(v0, v1, v2, v3, v4, v5);
+        _mm_storeu_si128((__m128i*)dst, v0); _mm_storeu_si128((__m128i*)(dst + 16), v1);
+        _mm_storeu_si128((__m128i*)(dst + 32), v2); _mm_storeu_si128((__m128i*)(dst + 48), v3);
+        _mm_storeu_si128((__m128i*)(dst + 64), v4); _mm_storeu_si128((__m128i*)(dst + 80), v5);
+    }
+    else
+    {
+        for( int k = 0; k < 2; k++, dst += 64 )
+        {
+            __m128i v0 = c0[k], v1 = c1[k], v2 = c2[k], v3 = c3[k];
+            _mm_interleave_epi8(v0, v1, v2, v3);
+            _mm_storeu_si128((__m128i*)dst, v0); _mm_storeu_si128((__m128i*)(dst + 16), v1);
+            _mm_storeu_si128((__m128i*)(dst + 32), v2); _mm_storeu_si128((__m128i*)(dst + 48), v3);
+        }
+    }
+}
+
+// computes (x0*c0 + x1*c1 + delta) >> shift for 8 pairs of 16-bit values;
+// c01 holds the interleaved pair of coefficients, the result is saturated to 16 bits
+static inline __m128i _mm_madd_descale_epi16(__m128i x0, __m128i x1, __m128i c01, __m128i delta, int shift)
+{
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), c01), delta);
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), c01), delta);
+    return _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+}
+
+static inline __m128i _mm_set_pair_epi16(int c0, int c1)
+{
+    return _mm_set1_epi32((c0 & 0xffff) | (c1 << 16));
+}
+
+// computes (x0*c0 + x1*c1 + x2*c2 + delta) >> shift for 8 triples of 16-bit values,
+// c01 = (c0, c1) and c2d = (c2, delta) are the interleaved pairs of 16-bit coefficients
+static inline __m128i _mm_dot3_descale_epi16(__m128i x0, __m128i x1, __m128i x2,
+                                             __m128i c01, __m128i c2d, int shift)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(x0, x1), c01),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(x2, one), c2d));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(x0, x1), c01),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(x2, one), c2d));
+    return _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+}
+
+static inline bool isShortCoeffs(const int* coeffs, int n)
+{
+    for( int i = 0; i < n; i++ )
+        if( std::abs(coeffs[i]) > SHRT_MAX )
+            return false;
+    return true;
+}
+
+// the low 32 bits of the products of 32-bit elements (SSE2 has no pmulld);
+// they are the same for the signed and the unsigned elements
+static inline __m128i _mm_mullo_epi32_sse2(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// splineInterpolate() for 4 values: the index is clamped the same way, including the values
+// out of the int range, and the 4 table rows are loaded and transposed
+static inline __m128 _mm_splineInterpolate_ps(__m128 x, const float* tab, int n)
+{
+    __m128i ix = _mm_cvttps_epi32(x), n1 = _mm_set1_epi32(n - 1);
+    ix = _mm_andnot_si128(_mm_srai_epi32(ix, 31), ix);
+    __m128i mask = _mm_cmpgt_epi32(ix, n1);
+    ix = _mm_or_si128(_mm_and_si128(mask, n1), _mm_andnot_si128(mask, ix));
+    x = _mm_sub_ps(x, _mm_cvtepi32_ps(ix));
+
+    int CV_DECL_ALIGNED(16) idx[4];
+    _mm_store_si128((__m128i*)idx, ix);
+    __m128 t0 = _mm_loadu_ps(tab + idx[0]*4), t1 = _mm_loadu_ps(tab + idx[1]*4);
+    __m128 t2 = _mm_loadu_ps(tab + idx[2]*4), t3 = _mm_loadu_ps(tab + idx[3]*4);
+    _MM_TRANSPOSE4_PS(t0, t1, t2, t3);
+    return _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(t3, x), t2), x), t1), x), t0);
+}
+
+// converts 16 8-bit values to 4 float vectors
+static inline void _mm_cvtepu8_ps(__m128i v, __m128* f)
+{
+    const __m128i z = _mm_setzero_si128();
+    __m128i lo = _mm_unpacklo_epi8(v, z), hi = _mm_unpackhi_epi8(v, z);
+    f[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, z));
+    f[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, z));
+    f[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, z));
+    f[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, z));
+}
+
+// saturate_cast<uchar> of 16 float values: both round to the nearest even
+static inline __m128i _mm_cvtps_epu8(const __m128* f)
+{
+    return _mm_packus_epi16(_mm_packs_epi32(_mm_cvtps_epi32(f[0]), _mm_cvtps_epi32(f[1])),
+                            _mm_packs_epi32(_mm_cvtps_epi32(f[2]), _mm_cvtps_epi32(f[3])));
+}
+
+#endif
+
 ////////////////// Various 3/4-channel to 3/4-channel RGB transformations /////////////////
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int RGB2RGB_SSE2(const _Tp*, _Tp*, int, int, int, int)
+{
+    return 0;
+}
+
+// returns the number of the processed pixels
+static int RGB2RGB_SSE2(const uchar* src, uchar* dst, int n, int scn, int dcn, int bidx)
+{
+    int i = 0;
+    if( scn == 4 && dcn == 4 )
+    {
+        // swap the bytes 0 and 2 of every 32-bit pixel
+        const __m128i m1 = _mm_set1_epi32(0xff00ff00), m0 = _mm_set1_epi32(0xff);
+        for( ; i <= n - 4; i += 4 )
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i*4));
+            v = _mm_or_si128(_mm_and_si128(v, m1),
+                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, 16), m0),
+                             _mm_slli_epi32(_mm_and_si128(v, m0), 16)));
+            _mm_storeu_si128((__m128i*)(dst + i*4), v);
+        }
+        return i;
+    }
+
+    __m128i c[3][2], a[2];
+    a[0] = a[1] = _mm_set1_epi8(-1);
+    for( ; i <= n - 32; i += 32 )
+    {
+        _mm_load_deinterleave_epi8(src + i*scn, scn, c[0], c[1], c[2]);
+        if( dcn == 3 )
+            _mm_interleave_store_epi8(dst + i*3, 3, c[bidx], c[1], c[bidx^2]);
+        else
+            _mm_interleave_store_epi8(dst + i*4, 4, c[bidx], c[1], c[bidx^2], a);
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct RGB2RGB
 {
     typedef _Tp channel_type;
 
-    RGB2RGB(int _srccn, int _dstcn, int _blueIdx) : srccn(_srccn), dstcn(_dstcn), blueIdx(_blueIdx) {}
+    RGB2RGB(int _srccn, int _dstcn, int _blueIdx) : srccn(_srccn), dstcn(_dstcn), blueIdx(_blueIdx)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
         int scn = srccn, dcn = dstcn, bidx = blueIdx;
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            int i = RGB2RGB_SSE2(src, dst, n, scn, dcn, bidx);
+            src += i*scn; dst += i*dcn; n -= i;
+        }
+#endif
         if( dcn == 3 )
         {
             n *= 3;
@@ -232,6 +552,7 @@ template<typename _Tp> struct RGB2RGB
     }
 
     int srccn, dstcn, blueIdx;
+    bool haveSIMD;
 };
 
 /////////// Transforming 16-bit (565 or 555) RGB to/from 24/32-bit (888[8]) RGB //////////
@@ -400,6 +721,30 @@ struct RGB5x52Gray
 };
 
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int RGB2Gray_SSE2(const _Tp*, _Tp*, int, int, const float*)
+{
+    return 0;
+}
+
+static int RGB2Gray_SSE2(const float* src, float* dst, int n, int scn, const float* coeffs)
+{
+    __m128 cb = _mm_set1_ps(coeffs[0]), cg = _mm_set1_ps(coeffs[1]), cr = _mm_set1_ps(coeffs[2]);
+    __m128 c[3][2];
+    int i = 0;
+    for( ; i <= n - 8; i += 8, src += scn*8 )
+    {
+        _mm_load_deinterleave_ps(src, scn, c[0], c[1], c[2]);
+        for( int k = 0; k < 2; k++ )
+            _mm_storeu_ps(dst + i + k*4, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0][k], cb),
+                _mm_mul_ps(c[1][k], cg)), _mm_mul_ps(c[2][k], cr)));
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct RGB2Gray
 {
     typedef _Tp channel_type;
@@ -410,17 +755,26 @@ template<typename _Tp> struct RGB2Gray
         memcpy( coeffs, _coeffs ? _coeffs : coeffs0, 3*sizeof(coeffs[0]) );
         if(blueIdx == 0)
             std::swap(coeffs[0], coeffs[2]);
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
     }
 
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
-        int scn = srccn;
+        int scn = srccn, i = 0;
         float cb = coeffs[0], cg = coeffs[1], cr = coeffs[2];
-        for(int i = 0; i < n; i++, src += scn)
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = RGB2Gray_SSE2(src, dst, n, scn, coeffs);
+            src += i*scn;
+        }
+#endif
+        for( ; i < n; i++, src += scn)
             dst[i] = saturate_cast<_Tp>(src[0]*cb + src[1]*cg + src[2]*cr);
     }
     int srccn;
     float coeffs[3];
+    bool haveSIMD;
 };
 
 
@@ -442,16 +796,45 @@ template<> struct RGB2Gray<uchar>
             tab[i+256] = g;
             tab[i+512] = r;
         }
+
+        // the vectorized version computes the same sums directly; it is only used when
+        // the result always fits 8 bits, i.e. when the table version does not wrap around
+        vcoeffs[0] = db; vcoeffs[1] = dg; vcoeffs[2] = dr;
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2) && db >= 0 && dg >= 0 && dr >= 0 &&
+            db + dg + dr <= (1 << yuv_shift);
     }
     void operator()(const uchar* src, uchar* dst, int n) const
     {
-        int scn = srccn;
+        int scn = srccn, i = 0;
         const int* _tab = tab;
-        for(int i = 0; i < n; i++, src += scn)
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            const __m128i z = _mm_setzero_si128();
+            __m128i c01 = _mm_set_pair_epi16(vcoeffs[0], vcoeffs[1]);
+            __m128i c2d = _mm_set_pair_epi16(vcoeffs[2], 1 << (yuv_shift-1));
+            __m128i c[3][2];
+            for( ; i <= n - 32; i += 32, src += scn*32 )
+            {
+                _mm_load_deinterleave_epi8(src, scn, c[0], c[1], c[2]);
+                for( int k = 0; k < 2; k++ )
+                {
+                    __m128i y0 = _mm_dot3_descale_epi16(_mm_unpacklo_epi8(c[0][k], z), _mm_unpacklo_epi8(c[1][k], z),
+                                                        _mm_unpacklo_epi8(c[2][k], z), c01, c2d, yuv_shift);
+                    __m128i y1 = _mm_dot3_descale_epi16(_mm_unpackhi_epi8(c[0][k], z), _mm_unpackhi_epi8(c[1][k], z),
+                                                        _mm_unpackhi_epi8(c[2][k], z), c01, c2d, yuv_shift);
+                    _mm_storeu_si128((__m128i*)(dst + i + k*16), _mm_packus_epi16(y0, y1));
+                }
+            }
+        }
+#endif
+        for( ; i < n; i++, src += scn)
             dst[i] = (uchar)((_tab[src[0]] + _tab[src[1]+256] + _tab[src[2]+512]) >> yuv_shift);
     }
     int srccn;
     int tab[256*3];
+    int vcoeffs[3];
+    bool haveSIMD;
 };
 
 
@@ -480,6 +863,35 @@ template<> struct RGB2Gray<ushort>
 
 ///////////////////////////////////// RGB <-> YCrCb //////////////////////////////////////
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int RGB2YCrCb_f_SSE2(const _Tp*, _Tp*, int, int, int, const float*)
+{
+    return 0;
+}
+
+static int RGB2YCrCb_f_SSE2(const float* src, float* dst, int n, int scn, int bidx, const float* coeffs)
+{
+    __m128 C0 = _mm_set1_ps(coeffs[0]), C1 = _mm_set1_ps(coeffs[1]), C2 = _mm_set1_ps(coeffs[2]);
+    __m128 C3 = _mm_set1_ps(coeffs[3]), C4 = _mm_set1_ps(coeffs[4]), delta = _mm_set1_ps(0.5f);
+    __m128 c[3][2], y[2], cr[2], cb[2];
+    int i = 0;
+    for( ; i <= n - 8; i += 8, src += scn*8 )
+    {
+        _mm_load_deinterleave_ps(src, scn, c[0], c[1], c[2]);
+        for( int k = 0; k < 2; k++ )
+        {
+            y[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c[0][k], C0), _mm_mul_ps(c[1][k], C1)), _mm_mul_ps(c[2][k], C2));
+            cr[k] = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(c[bidx^2][k], y[k]), C3), delta);
+            cb[k] = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(c[bidx][k], y[k]), C4), delta);
+        }
+        _mm_interleave_store_ps(dst + i*3, y, cr, cb);
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct RGB2YCrCb_f
 {
     typedef _Tp channel_type;
@@ -489,15 +901,23 @@ template<typename _Tp> struct RGB2YCrCb_f
         static const float coeffs0[] = {0.299f, 0.587f, 0.114f, 0.713f, 0.564f};
         memcpy(coeffs, _coeffs ? _coeffs : coeffs0, 5*sizeof(coeffs[0]));
         if(blueIdx==0) std::swap(coeffs[0], coeffs[2]);
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
     }
 
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
-        int scn = srccn, bidx = blueIdx;
+        int scn = srccn, bidx = blueIdx, i = 0;
         const _Tp delta = ColorChannel<_Tp>::half();
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2], C3 = coeffs[3], C4 = coeffs[4];
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = RGB2YCrCb_f_SSE2(src, dst, n, scn, bidx, coeffs);
+            src += i*scn;
+        }
+#endif
         n *= 3;
-        for(int i = 0; i < n; i += 3, src += scn)
+        for( i *= 3; i < n; i += 3, src += scn)
         {
             _Tp Y = saturate_cast<_Tp>(src[0]*C0 + src[1]*C1 + src[2]*C2);
             _Tp Cr = saturate_cast<_Tp>((src[bidx^2] - Y)*C3 + delta);
@@ -507,9 +927,55 @@ template<typename _Tp> struct RGB2YCrCb_f
     }
     int srccn, blueIdx;
     float coeffs[5];
+    bool haveSIMD;
 };
 
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int RGB2YCrCb_i_SSE2(const _Tp*, _Tp*, int, int, int, const int*)
+{
+    return 0;
+}
+
+static int RGB2YCrCb_i_SSE2(const uchar* src, uchar* dst, int n, int scn, int bidx, const int* coeffs)
+{
+    const __m128i z = _mm_setzero_si128(), one = _mm_set1_epi16(1);
+    const __m128i delta = _mm_set1_epi32(128 << yuv_shift);
+    __m128i c01 = _mm_set_pair_epi16(coeffs[0], coeffs[1]);
+    __m128i c2d = _mm_set_pair_epi16(coeffs[2], 1 << (yuv_shift-1));
+    __m128i c3d = _mm_set_pair_epi16(coeffs[3], 1 << (yuv_shift-1));
+    __m128i c4d = _mm_set_pair_epi16(coeffs[4], 1 << (yuv_shift-1));
+    __m128i c[3][2], y[2], cr[2], cb[2];
+    int i = 0;
+    for( ; i <= n - 32; i += 32, src += scn*32 )
+    {
+        _mm_load_deinterleave_epi8(src, scn, c[0], c[1], c[2]);
+        for( int k = 0; k < 2; k++ )
+        {
+            __m128i t[3][2], yy[2];
+            for( int j = 0; j < 3; j++ )
+            {
+                t[j][0] = _mm_unpacklo_epi8(c[j][k], z);
+                t[j][1] = _mm_unpackhi_epi8(c[j][k], z);
+            }
+            for( int h = 0; h < 2; h++ )
+                yy[h] = _mm_dot3_descale_epi16(t[0][h], t[1][h], t[2][h], c01, c2d, yuv_shift);
+            y[k] = _mm_packus_epi16(yy[0], yy[1]);
+            cr[k] = _mm_packus_epi16(
+                _mm_madd_descale_epi16(_mm_sub_epi16(t[bidx^2][0], yy[0]), one, c3d, delta, yuv_shift),
+                _mm_madd_descale_epi16(_mm_sub_epi16(t[bidx^2][1], yy[1]), one, c3d, delta, yuv_shift));
+            cb[k] = _mm_packus_epi16(
+                _mm_madd_descale_epi16(_mm_sub_epi16(t[bidx][0], yy[0]), one, c4d, delta, yuv_shift),
+                _mm_madd_descale_epi16(_mm_sub_epi16(t[bidx][1], yy[1]), one, c4d, delta, yuv_shift));
+        }
+        _mm_interleave_store_epi8(dst + i*3, 3, y, cr, cb);
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct RGB2YCrCb_i
 {
     typedef _Tp channel_type;
@@ -520,14 +986,22 @@ template<typename _Tp> struct RGB2YCrCb_i
         static const int coeffs0[] = {R2Y, G2Y, B2Y, 11682, 9241};
         memcpy(coeffs, _coeffs ? _coeffs : coeffs0, 5*sizeof(coeffs[0]));
         if(blueIdx==0) std::swap(coeffs[0], coeffs[2]);
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2) && isShortCoeffs(coeffs, 5);
     }
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
-        int scn = srccn, bidx = blueIdx;
+        int scn = srccn, bidx = blueIdx, i = 0;
         int C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2], C3 = coeffs[3], C4 = coeffs[4];
         int delta = ColorChannel<_Tp>::half()*(1 << yuv_shift);
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = RGB2YCrCb_i_SSE2(src, dst, n, scn, bidx, coeffs);
+            src += i*scn;
+        }
+#endif
         n *= 3;
-        for(int i = 0; i < n; i += 3, src += scn)
+        for( i *= 3; i < n; i += 3, src += scn)
         {
             int Y = CV_DESCALE(src[0]*C0 + src[1]*C1 + src[2]*C2, yuv_shift);
             int Cr = CV_DESCALE((src[bidx^2] - Y)*C3 + delta, yuv_shift);
@@ -539,9 +1013,41 @@ template<typename _Tp> struct RGB2YCrCb_i
     }
     int srccn, blueIdx;
     int coeffs[5];
+    bool haveSIMD;
 };
 
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int YCrCb2RGB_f_SSE2(const _Tp*, _Tp*, int, int, int, const float*)
+{
+    return 0;
+}
+
+static int YCrCb2RGB_f_SSE2(const float* src, float* dst, int n, int dcn, int bidx, const float* coeffs)
+{
+    __m128 C0 = _mm_set1_ps(coeffs[0]), C1 = _mm_set1_ps(coeffs[1]);
+    __m128 C2 = _mm_set1_ps(coeffs[2]), C3 = _mm_set1_ps(coeffs[3]);
+    __m128 delta = _mm_set1_ps(0.5f), alpha = _mm_set1_ps(1.f);
+    __m128 c[3][2], rgb[3][2];
+    int i = 0;
+    for( ; i <= n - 8; i += 8, src += 24 )
+    {
+        _mm_load_deinterleave_ps(src, 3, c[0], c[1], c[2]);
+        for( int k = 0; k < 2; k++ )
+        {
+            __m128 Y = c[0][k], Cr = _mm_sub_ps(c[1][k], delta), Cb = _mm_sub_ps(c[2][k], delta);
+            rgb[bidx][k] = _mm_add_ps(Y, _mm_mul_ps(Cb, C3));
+            rgb[1][k] = _mm_add_ps(_mm_add_ps(Y, _mm_mul_ps(Cb, C2)), _mm_mul_ps(Cr, C1));
+            rgb[bidx^2][k] = _mm_add_ps(Y, _mm_mul_ps(Cr, C0));
+        }
+        _mm_interleave_store_ps(dst + i*dcn, dcn, rgb[0], rgb[1], rgb[2], alpha);
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct YCrCb2RGB_f
 {
     typedef _Tp channel_type;
@@ -551,14 +1057,22 @@ template<typename _Tp> struct YCrCb2RGB_f
     {
         static const float coeffs0[] = {1.403f, -0.714f, -0.344f, 1.773f};
         memcpy(coeffs, _coeffs ? _coeffs : coeffs0, 4*sizeof(coeffs[0]));
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
     }
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
-        int dcn = dstcn, bidx = blueIdx;
+        int dcn = dstcn, bidx = blueIdx, i = 0;
         const _Tp delta = ColorChannel<_Tp>::half(), alpha = ColorChannel<_Tp>::max();
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2], C3 = coeffs[3];
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = YCrCb2RGB_f_SSE2(src, dst, n, dcn, bidx, coeffs);
+            dst += i*dcn;
+        }
+#endif
         n *= 3;
-        for(int i = 0; i < n; i += 3, dst += dcn)
+        for( i *= 3; i < n; i += 3, dst += dcn)
         {
             _Tp Y = src[i];
             _Tp Cr = src[i+1];
@@ -575,9 +1089,53 @@ template<typename _Tp> struct YCrCb2RGB_f
     }
     int dstcn, blueIdx;
     float coeffs[4];
+    bool haveSIMD;
 };
 
 
+#if CV_SSE2
+
+template<typename _Tp> static inline int YCrCb2RGB_i_SSE2(const _Tp*, _Tp*, int, int, int, const int*)
+{
+    return 0;
+}
+
+static int YCrCb2RGB_i_SSE2(const uchar* src, uchar* dst, int n, int dcn, int bidx, const int* coeffs)
+{
+    const __m128i z = _mm_setzero_si128(), one = _mm_set1_epi16(1), c128 = _mm_set1_epi16(128);
+    const __m128i half = _mm_set1_epi32(1 << (yuv_shift-1));
+    __m128i c0d = _mm_set_pair_epi16(coeffs[0], 1 << (yuv_shift-1));
+    __m128i c21 = _mm_set_pair_epi16(coeffs[2], coeffs[1]);
+    __m128i c3d = _mm_set_pair_epi16(coeffs[3], 1 << (yuv_shift-1));
+    __m128i c[3][2], rgb[3][2], a[2];
+    a[0] = a[1] = _mm_set1_epi8(-1);
+    int i = 0;
+    for( ; i <= n - 32; i += 32, src += 96 )
+    {
+        _mm_load_deinterleave_epi8(src, 3, c[0], c[1], c[2]);
+        for( int k = 0; k < 2; k++ )
+        {
+            __m128i b[2], g[2], r[2];
+            for( int h = 0; h < 2; h++ )
+            {
+                __m128i Y = h == 0 ? _mm_unpacklo_epi8(c[0][k], z) : _mm_unpackhi_epi8(c[0][k], z);
+                __m128i Cr = _mm_sub_epi16(h == 0 ? _mm_unpacklo_epi8(c[1][k], z) : _mm_unpackhi_epi8(c[1][k], z), c128);
+                __m128i Cb = _mm_sub_epi16(h == 0 ? _mm_unpacklo_epi8(c[2][k], z) : _mm_unpackhi_epi8(c[2][k], z), c128);
+                b[h] = _mm_add_epi16(Y, _mm_madd_descale_epi16(Cb, one, c3d, z, yuv_shift));
+                g[h] = _mm_add_epi16(Y, _mm_madd_descale_epi16(Cb, Cr, c21, half, yuv_shift));
+                r[h] = _mm_add_epi16(Y, _mm_madd_descale_epi16(Cr, one, c0d, z, yuv_shift));
+            }
+            rgb[bidx][k] = _mm_packus_epi16(b[0], b[1]);
+            rgb[1][k] = _mm_packus_epi16(g[0], g[1]);
+            rgb[bidx^2][k] = _mm_packus_epi16(r[0], r[1]);
+        }
+        _mm_interleave_store_epi8(dst + i*dcn, dcn, rgb[0], rgb[1], rgb[2], a);
+    }
+    return i;
+}
+
+#endif
+
 template<typename _Tp> struct YCrCb2RGB_i
 {
     typedef _Tp channel_type;
@@ -587,15 +1145,23 @@ template<typename _Tp> struct YCrCb2RGB_i
     {
         static const int coeffs0[] = {22987, -11698, -5636, 29049};
         memcpy(coeffs, _coeffs ? _coeffs : coeffs0, 4*sizeof(coeffs[0]));
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2) && isShortCoeffs(coeffs, 4);
     }
 
     void operator()(const _Tp* src, _Tp* dst, int n) const
     {
-        int dcn = dstcn, bidx = blueIdx;
+        int dcn = dstcn, bidx = blueIdx, i = 0;
         const _Tp delta = ColorChannel<_Tp>::half(), alpha = ColorChannel<_Tp>::max();
         int C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2], C3 = coeffs[3];
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = YCrCb2RGB_i_SSE2(src, dst, n, dcn, bidx, coeffs);
+            dst += i*dcn;
+        }
+#endif
         n *= 3;
-        for(int i = 0; i < n; i += 3, dst += dcn)
+        for( i *= 3; i < n; i += 3, dst += dcn)
         {
             _Tp Y = src[i];
             _Tp Cr = src[i+1];
@@ -614,6 +1180,7 @@ template<typename _Tp> struct YCrCb2RGB_i
     }
     int dstcn, blueIdx;
     int coeffs[4];
+    bool haveSIMD;
 };
 
 
@@ -807,7 +1374,82 @@ struct RGB2HSV_b
     : srccn(_srccn), blueIdx(_blueIdx), hrange(_hrange)
     {
         CV_Assert( hrange == 180 || hrange == 256 );
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below: the masks are computed on 8-bit values,
+    // the hue in 16 bits and the products in 32 bits. The division tables are read per element
+    int process_SSE2(const uchar* src, uchar* dst, int n, const int* sdiv_table, const int* hdiv_table) const
+    {
+        int i = 0, bidx = blueIdx, scn = srccn;
+        const int hsv_shift = 12;
+        const __m128i z = _mm_setzero_si128(), delta = _mm_set1_epi32(1 << (hsv_shift-1));
+        const __m128i hr = _mm_set1_epi32(hrange);
+        int CV_DECL_ALIGNED(16) sdiv[16];
+        int CV_DECL_ALIGNED(16) hdiv[16];
+        uchar CV_DECL_ALIGNED(16) vbuf[16], dbuf[16];
+        __m128i c[3][2], hsv[3][2];
+
+        for( ; i <= n - 32; i += 32, src += scn*32 )
+        {
+            _mm_load_deinterleave_epi8(src, scn, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128i b = c[bidx][k], g = c[1][k], r = c[bidx^2][k];
+                __m128i v = _mm_max_epu8(b, _mm_max_epu8(g, r));
+                __m128i diff = _mm_sub_epi8(v, _mm_min_epu8(b, _mm_min_epu8(g, r)));
+                __m128i vr = _mm_cmpeq_epi8(v, r), vg = _mm_cmpeq_epi8(v, g);
+
+                _mm_store_si128((__m128i*)vbuf, v);
+                _mm_store_si128((__m128i*)dbuf, diff);
+                for( int j = 0; j < 16; j++ )
+                {
+                    sdiv[j] = sdiv_table[vbuf[j]];
+                    hdiv[j] = hdiv_table[dbuf[j]];
+                }
+
+                __m128i s16[2], h16[2];
+                for( int l = 0; l < 2; l++ )
+                {
+                    __m128i b16 = l == 0 ? _mm_unpacklo_epi8(b, z) : _mm_unpackhi_epi8(b, z);
+                    __m128i g16 = l == 0 ? _mm_unpacklo_epi8(g, z) : _mm_unpackhi_epi8(g, z);
+                    __m128i r16 = l == 0 ? _mm_unpacklo_epi8(r, z) : _mm_unpackhi_epi8(r, z);
+                    __m128i d16 = l == 0 ? _mm_unpacklo_epi8(diff, z) : _mm_unpackhi_epi8(diff, z);
+                    __m128i vr16 = l == 0 ? _mm_unpacklo_epi8(vr, vr) : _mm_unpackhi_epi8(vr, vr);
+                    __m128i vg16 = l == 0 ? _mm_unpacklo_epi8(vg, vg) : _mm_unpackhi_epi8(vg, vg);
+                    __m128i d2 = _mm_add_epi16(d16, d16);
+
+                    __m128i h = _mm_or_si128(_mm_and_si128(vg16, _mm_add_epi16(_mm_sub_epi16(b16, r16), d2)),
+                                             _mm_andnot_si128(vg16, _mm_add_epi16(_mm_sub_epi16(r16, g16),
+                                                                                  _mm_add_epi16(d2, d2))));
+                    h = _mm_or_si128(_mm_and_si128(vr16, _mm_sub_epi16(g16, b16)), _mm_andnot_si128(vr16, h));
+
+                    __m128i s32[2], h32[2];
+                    for( int m = 0; m < 2; m++ )
+                    {
+                        int j = l*8 + m*4;
+                        __m128i d32 = m == 0 ? _mm_unpacklo_epi16(d16, z) : _mm_unpackhi_epi16(d16, z);
+                        __m128i hh = m == 0 ? _mm_unpacklo_epi16(h, h) : _mm_unpackhi_epi16(h, h);
+                        hh = _mm_srai_epi32(hh, 16);
+                        s32[m] = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32_sse2(d32,
+                                                _mm_load_si128((const __m128i*)(sdiv + j))), delta), hsv_shift);
+                        hh = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32_sse2(hh,
+                                            _mm_load_si128((const __m128i*)(hdiv + j))), delta), hsv_shift);
+                        h32[m] = _mm_add_epi32(hh, _mm_and_si128(_mm_cmplt_epi32(hh, z), hr));
+                    }
+                    s16[l] = _mm_packs_epi32(s32[0], s32[1]);
+                    h16[l] = _mm_packs_epi32(h32[0], h32[1]);
+                }
+                hsv[0][k] = _mm_packus_epi16(h16[0], h16[1]);
+                hsv[1][k] = _mm_packus_epi16(s16[0], s16[1]);
+                hsv[2][k] = v;
+            }
+            _mm_interleave_store_epi8(dst + i*3, 3, hsv[0], hsv[1], hsv[2]);
+        }
+        return i;
     }
+#endif
 
     void operator()(const uchar* src, uchar* dst, int n) const
     {
@@ -835,7 +1477,16 @@ struct RGB2HSV_b
             initialized = true;
         }
 
-        for( i = 0; i < n; i += 3, src += scn )
+        i = 0;
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n/3, sdiv_table, hdiv_table);
+            src += i*scn;
+        }
+#endif
+
+        for( i *= 3; i < n; i += 3, src += scn )
         {
             int b = src[bidx], g = src[1], r = src[bidx^2];
             int h, s, v = b;
@@ -864,6 +1515,7 @@ struct RGB2HSV_b
     }
 
     int srccn, blueIdx, hrange;
+    bool haveSIMD;
 };
 
 
@@ -872,15 +1524,67 @@ struct RGB2HSV_f
     typedef float channel_type;
 
     RGB2HSV_f(int _srccn, int _blueIdx, float _hrange)
-    : srccn(_srccn), blueIdx(_blueIdx), hrange(_hrange) {}
+    : srccn(_srccn), blueIdx(_blueIdx), hrange(_hrange)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below, with the branches replaced by masks
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, bidx = blueIdx, scn = srccn;
+        const __m128 eps = _mm_set1_ps(FLT_EPSILON), c60 = _mm_set1_ps(60.f);
+        const __m128 c120 = _mm_set1_ps(120.f), c240 = _mm_set1_ps(240.f), c360 = _mm_set1_ps(360.f);
+        const __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)), z = _mm_setzero_ps();
+        __m128 hscale = _mm_set1_ps(hrange*(1.f/360.f));
+        __m128 c[3][2], hsv[3][2];
+
+        for( ; i <= n - 8; i += 8, src += scn*8 )
+        {
+            _mm_load_deinterleave_ps(src, scn, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128 b = c[bidx][k], g = c[1][k], r = c[bidx^2][k];
+                __m128 v = _mm_max_ps(b, _mm_max_ps(g, r));
+                __m128 vmin = _mm_min_ps(b, _mm_min_ps(g, r));
+                __m128 diff = _mm_sub_ps(v, vmin);
+                __m128 s = _mm_div_ps(diff, _mm_add_ps(_mm_and_ps(v, absmask), eps));
+                diff = _mm_div_ps(c60, _mm_add_ps(diff, eps));
+
+                __m128 hr = _mm_mul_ps(_mm_sub_ps(g, b), diff);
+                __m128 hg = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(b, r), diff), c120);
+                __m128 hb = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(r, g), diff), c240);
+                __m128 mr = _mm_cmpeq_ps(v, r), mg = _mm_andnot_ps(mr, _mm_cmpeq_ps(v, g));
+                __m128 h = _mm_or_ps(_mm_and_ps(mr, hr), _mm_or_ps(_mm_and_ps(mg, hg),
+                                     _mm_andnot_ps(_mm_or_ps(mr, mg), hb)));
+                __m128 mneg = _mm_cmplt_ps(h, z);
+                h = _mm_or_ps(_mm_and_ps(mneg, _mm_add_ps(h, c360)), _mm_andnot_ps(mneg, h));
+
+                hsv[0][k] = _mm_mul_ps(h, hscale);
+                hsv[1][k] = s;
+                hsv[2][k] = v;
+            }
+            _mm_interleave_store_ps(dst + i*3, hsv[0], hsv[1], hsv[2]);
+        }
+        return i;
+    }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, bidx = blueIdx, scn = srccn;
+        int i = 0, bidx = blueIdx, scn = srccn;
         float hscale = hrange*(1.f/360.f);
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            src += i*scn;
+        }
+#endif
         n *= 3;
 
-        for( i = 0; i < n; i += 3, src += scn )
+        for( i *= 3; i < n; i += 3, src += scn )
         {
             float b = src[bidx], g = src[1], r = src[bidx^2];
             float h, s, v;
@@ -913,6 +1617,7 @@ struct RGB2HSV_f
 
     int srccn, blueIdx;
     float hrange;
+    bool haveSIMD;
 };
 
 
@@ -921,16 +1626,85 @@ struct HSV2RGB_f
     typedef float channel_type;
 
     HSV2RGB_f(int _dstcn, int _blueIdx, float _hrange)
-    : dstcn(_dstcn), blueIdx(_blueIdx), hscale(6.f/_hrange) {}
+    : dstcn(_dstcn), blueIdx(_blueIdx), hscale(6.f/_hrange)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below; the sector table lookup is replaced by masks
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, bidx = blueIdx, dcn = dstcn;
+        const __m128 z = _mm_setzero_ps(), one = _mm_set1_ps(1.f), c6 = _mm_set1_ps(6.f);
+        const __m128i iz = _mm_setzero_si128(), c5 = _mm_set1_epi32(5);
+        __m128 _hscale = _mm_set1_ps(hscale), alpha = _mm_set1_ps(ColorChannel<float>::max());
+        __m128 c[3][2], rgb[3][2];
+
+        for( ; i <= n - 8; i += 8, src += 24 )
+        {
+            _mm_load_deinterleave_ps(src, 3, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128 s = c[1][k], v = c[2][k], m;
+                __m128 gray = _mm_cmpeq_ps(s, z);
+                __m128 h = _mm_andnot_ps(gray, _mm_mul_ps(c[0][k], _hscale));
+                while( _mm_movemask_ps(m = _mm_cmplt_ps(h, z)) )
+                    h = _mm_add_ps(h, _mm_and_ps(m, c6));
+                // h == 6 after the additions gives sector 0 and h = 0, as the invalid sector does
+                while( _mm_movemask_ps(m = _mm_cmpge_ps(h, c6)) )
+                    h = _mm_sub_ps(h, _mm_and_ps(m, c6));
+
+                // h >= 0 here, so the truncation is floor; NaN gives a negative sector
+                __m128i sector = _mm_cvttps_epi32(h);
+                __m128i bad = _mm_or_si128(_mm_cmpgt_epi32(sector, c5), _mm_cmplt_epi32(sector, iz));
+                sector = _mm_andnot_si128(bad, sector);
+                h = _mm_andnot_ps(_mm_castsi128_ps(bad), _mm_sub_ps(h, _mm_cvtepi32_ps(sector)));
+
+                __m128 t0 = v;
+                __m128 t1 = _mm_mul_ps(v, _mm_sub_ps(one, s));
+                __m128 t2 = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(s, h)));
+                __m128 t3 = _mm_mul_ps(v, _mm_sub_ps(one, _mm_mul_ps(s, _mm_sub_ps(one, h))));
+                __m128 m0 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, iz));
+                __m128 m1 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, _mm_set1_epi32(1)));
+                __m128 m2 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, _mm_set1_epi32(2)));
+                __m128 m3 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, _mm_set1_epi32(3)));
+                __m128 m4 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, _mm_set1_epi32(4)));
+                __m128 m5 = _mm_castsi128_ps(_mm_cmpeq_epi32(sector, c5));
+
+                // sector_data: {1,3,0}, {1,0,2}, {3,0,1}, {0,2,1}, {0,1,3}, {2,1,0}
+                __m128 b = _mm_or_ps(_mm_or_ps(_mm_and_ps(_mm_or_ps(m0, m1), t1), _mm_and_ps(m2, t3)),
+                                     _mm_or_ps(_mm_and_ps(_mm_or_ps(m3, m4), t0), _mm_and_ps(m5, t2)));
+                __m128 g = _mm_or_ps(_mm_or_ps(_mm_and_ps(m0, t3), _mm_and_ps(_mm_or_ps(m1, m2), t0)),
+                                     _mm_or_ps(_mm_and_ps(m3, t2), _mm_and_ps(_mm_or_ps(m4, m5), t1)));
+                __m128 r = _mm_or_ps(_mm_or_ps(_mm_and_ps(_mm_or_ps(m0, m5), t0), _mm_and_ps(m1, t2)),
+                                     _mm_or_ps(_mm_and_ps(_mm_or_ps(m2, m3), t1), _mm_and_ps(m4, t3)));
+
+                rgb[bidx][k] = _mm_or_ps(_mm_and_ps(gray, v), _mm_andnot_ps(gray, b));
+                rgb[1][k] = _mm_or_ps(_mm_and_ps(gray, v), _mm_andnot_ps(gray, g));
+                rgb[bidx^2][k] = _mm_or_ps(_mm_and_ps(gray, v), _mm_andnot_ps(gray, r));
+            }
+            _mm_interleave_store_ps(dst + i*dcn, dcn, rgb[0], rgb[1], rgb[2], alpha);
+        }
+        return i;
+    }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, bidx = blueIdx, dcn = dstcn;
+        int i = 0, bidx = blueIdx, dcn = dstcn;
         float _hscale = hscale;
         float alpha = ColorChannel<float>::max();
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            dst += i*dcn;
+        }
+#endif
         n *= 3;
 
-        for( i = 0; i < n; i += 3, dst += dcn )
+        for( i *= 3; i < n; i += 3, dst += dcn )
         {
             float h = src[i], s = src[i+1], v = src[i+2];
             float b, g, r;
@@ -976,6 +1750,7 @@ struct HSV2RGB_f
 
     int dstcn, blueIdx;
     float hscale;
+    bool haveSIMD;
 };
 
 
@@ -1309,20 +2084,108 @@ struct RGB2Lab_b
             CV_Assert( coeffs[i] >= 0 && coeffs[i*3+1] >= 0 && coeffs[i*3+2] >= 0 &&
                       coeffs[i*3] + coeffs[i*3+1] + coeffs[i*3+2] < 2*(1 << lab_shift) );
         }
+        // the per-element table reads make the vector loop slower than the scalar one
+        // when there is no gamma correction to amortize them
+        haveSIMD = srgb && checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below. The gamma and the cube root tables are
+    // read per element, the sums of products are computed with pmaddwd and the rest in 32 bits
+    int process_SSE2(const uchar* src, uchar* dst, int n) const
+    {
+        const int Lscale = (116*255+50)/100;
+        const int Lshift = -((16*255*(1 << lab_shift2) + 50)/100);
+        const ushort* tab = srgb ? sRGBGammaTab_b : linearGammaTab_b;
+        int i = 0, scn = srccn;
+        const __m128i z = _mm_setzero_si128();
+        const __m128i Ls = _mm_set1_epi32(Lscale), Ld = _mm_set1_epi32(Lshift + (1 << (lab_shift2-1)));
+        const __m128i c500 = _mm_set1_epi32(500), c200 = _mm_set1_epi32(200);
+        const __m128i abd = _mm_set1_epi32(128*(1 << lab_shift2) + (1 << (lab_shift2-1)));
+        __m128i C01[3], C2d[3];
+        for( int j = 0; j < 3; j++ )
+        {
+            C01[j] = _mm_set_pair_epi16(coeffs[j*3], coeffs[j*3+1]);
+            C2d[j] = _mm_set_pair_epi16(coeffs[j*3+2], 1 << (lab_shift-1));
+        }
+        ushort CV_DECL_ALIGNED(16) buf[3][16];
+        __m128i c[3][2], lab[3][2];
+
+        for( ; i <= n - 32; i += 32, src += scn*32 )
+        {
+            _mm_load_deinterleave_epi8(src, scn, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128i rgb[3][2], f[3][2];
+                for( int j = 0; j < 3; j++ )
+                {
+                    uchar CV_DECL_ALIGNED(16) v[16];
+                    _mm_store_si128((__m128i*)v, c[j][k]);
+                    for( int l = 0; l < 16; l++ )
+                        buf[j][l] = tab[v[l]];
+                    rgb[j][0] = _mm_load_si128((const __m128i*)buf[j]);
+                    rgb[j][1] = _mm_load_si128((const __m128i*)(buf[j] + 8));
+                }
+                for( int j = 0; j < 3; j++ )
+                {
+                    _mm_store_si128((__m128i*)buf[j], _mm_dot3_descale_epi16(rgb[0][0], rgb[1][0], rgb[2][0],
+                                                                            C01[j], C2d[j], lab_shift));
+                    _mm_store_si128((__m128i*)(buf[j] + 8), _mm_dot3_descale_epi16(rgb[0][1], rgb[1][1], rgb[2][1],
+                                                                                  C01[j], C2d[j], lab_shift));
+                    for( int l = 0; l < 16; l++ )
+                        buf[j][l] = LabCbrtTab_b[buf[j][l]];
+                    f[j][0] = _mm_load_si128((const __m128i*)buf[j]);
+                    f[j][1] = _mm_load_si128((const __m128i*)(buf[j] + 8));
+                }
+
+                __m128i L16[2], a16[2], b16[2];
+                for( int l = 0; l < 2; l++ )
+                {
+                    __m128i L32[2], a32[2], b32[2];
+                    for( int m = 0; m < 2; m++ )
+                    {
+                        __m128i fX = m == 0 ? _mm_unpacklo_epi16(f[0][l], z) : _mm_unpackhi_epi16(f[0][l], z);
+                        __m128i fY = m == 0 ? _mm_unpacklo_epi16(f[1][l], z) : _mm_unpackhi_epi16(f[1][l], z);
+                        __m128i fZ = m == 0 ? _mm_unpacklo_epi16(f[2][l], z) : _mm_unpackhi_epi16(f[2][l], z);
+                        L32[m] = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32_sse2(fY, Ls), Ld), lab_shift2);
+                        a32[m] = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32_sse2(_mm_sub_epi32(fX, fY), c500),
+                                                              abd), lab_shift2);
+                        b32[m] = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32_sse2(_mm_sub_epi32(fY, fZ), c200),
+                                                              abd), lab_shift2);
+                    }
+                    L16[l] = _mm_packs_epi32(L32[0], L32[1]);
+                    a16[l] = _mm_packs_epi32(a32[0], a32[1]);
+                    b16[l] = _mm_packs_epi32(b32[0], b32[1]);
+                }
+                lab[0][k] = _mm_packus_epi16(L16[0], L16[1]);
+                lab[1][k] = _mm_packus_epi16(a16[0], a16[1]);
+                lab[2][k] = _mm_packus_epi16(b16[0], b16[1]);
+            }
+            _mm_interleave_store_epi8(dst + i*3, 3, lab[0], lab[1], lab[2]);
+        }
+        return i;
     }
+#endif
 
     void operator()(const uchar* src, uchar* dst, int n) const
     {
         const int Lscale = (116*255+50)/100;
         const int Lshift = -((16*255*(1 << lab_shift2) + 50)/100);
         const ushort* tab = srgb ? sRGBGammaTab_b : linearGammaTab_b;
-        int i, scn = srccn;
+        int i = 0, scn = srccn;
         int C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2],
             C3 = coeffs[3], C4 = coeffs[4], C5 = coeffs[5],
             C6 = coeffs[6], C7 = coeffs[7], C8 = coeffs[8];
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            src += i*scn;
+        }
+#endif
         n *= 3;
 
-        for( i = 0; i < n; i += 3, src += scn )
+        for( i *= 3; i < n; i += 3, src += scn )
         {
             int R = tab[src[0]], G = tab[src[1]], B = tab[src[2]];
             int fX = LabCbrtTab_b[CV_DESCALE(R*C0 + G*C1 + B*C2, lab_shift)];
@@ -1342,9 +2205,35 @@ struct RGB2Lab_b
     int srccn;
     int coeffs[9];
     bool srgb;
+    bool haveSIMD;
 };
 
 
+// The cube root of x >= 0: the exponent bits divided by 3 give a guess within 4%, a Halley and
+// a Newton iteration bring it within 1 ulp of the exact value. _mm_labCbrt_ps() does the same
+// operations, so both give the same results
+static inline float labCbrt(float x)
+{
+    Cv32suf u;
+    u.f = x;
+    u.i = (int)((float)u.i*(1.f/3)) + 709921077;
+    float y = u.f, y3 = y*y*y;
+    y = y*(y3 + x + x)/(y3 + y3 + x);
+    return y + (x/(y*y) - y)*(1.f/3);
+}
+
+#if CV_SSE2
+static inline __m128 _mm_labCbrt_ps(__m128 x)
+{
+    const __m128 third = _mm_set1_ps(1.f/3);
+    __m128i u = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(x)), third));
+    __m128 y = _mm_castsi128_ps(_mm_add_epi32(u, _mm_set1_epi32(709921077)));
+    __m128 y3 = _mm_mul_ps(_mm_mul_ps(y, y), y);
+    y = _mm_div_ps(_mm_mul_ps(y, _mm_add_ps(_mm_add_ps(y3, x), x)), _mm_add_ps(_mm_add_ps(y3, y3), x));
+    return _mm_add_ps(y, _mm_mul_ps(_mm_sub_ps(_mm_div_ps(x, _mm_mul_ps(y, y)), y), third));
+}
+#endif
+
 #define clip(value) \
     value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
 
@@ -1376,21 +2265,75 @@ struct RGB2Lab_f
             CV_Assert( coeffs[j] >= 0 && coeffs[j + 1] >= 0 && coeffs[j + 2] >= 0 &&
                        coeffs[j] + coeffs[j + 1] + coeffs[j + 2] < 1.5f*LabCbrtTabScale );
         }
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below, with the branches replaced by masks
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, scn = srccn;
+        const float* gammaTab = srgb ? sRGBGammaTab : 0;
+        const __m128 gscale = _mm_set1_ps(GammaTabScale), z = _mm_setzero_ps(), one = _mm_set1_ps(1.f);
+        const __m128 thresh = _mm_set1_ps(0.008856f), c7787 = _mm_set1_ps(7.787f);
+        const __m128 c16_116 = _mm_set1_ps(16.0f / 116.0f), c116 = _mm_set1_ps(116.f), c16 = _mm_set1_ps(16.f);
+        const __m128 c9033 = _mm_set1_ps(903.3f), c500 = _mm_set1_ps(500.f), c200 = _mm_set1_ps(200.f);
+        __m128 C[9], c[3][2], lab[3][2];
+        for( int j = 0; j < 9; j++ )
+            C[j] = _mm_set1_ps(coeffs[j]);
+
+        for( ; i <= n - 8; i += 8, src += scn*8 )
+        {
+            _mm_load_deinterleave_ps(src, scn, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                // clip() keeps NaN, so does max(0, x)
+                __m128 rgb[3], f[3];
+                for( int j = 0; j < 3; j++ )
+                {
+                    rgb[j] = _mm_min_ps(one, _mm_max_ps(z, c[j][k]));
+                    if( gammaTab )
+                        rgb[j] = _mm_splineInterpolate_ps(_mm_mul_ps(rgb[j], gscale), gammaTab, GAMMA_TAB_SIZE);
+                }
+                for( int j = 0; j < 3; j++ )
+                {
+                    __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rgb[0], C[j*3]), _mm_mul_ps(rgb[1], C[j*3+1])),
+                                          _mm_mul_ps(rgb[2], C[j*3+2]));
+                    __m128 m = _mm_cmpgt_ps(v, thresh);
+                    f[j] = _mm_or_ps(_mm_and_ps(m, _mm_labCbrt_ps(v)),
+                                     _mm_andnot_ps(m, _mm_add_ps(_mm_mul_ps(c7787, v), c16_116)));
+                    if( j == 1 )
+                        lab[0][k] = _mm_or_ps(_mm_and_ps(m, _mm_sub_ps(_mm_mul_ps(c116, f[1]), c16)),
+                                              _mm_andnot_ps(m, _mm_mul_ps(c9033, v)));
+                }
+                lab[1][k] = _mm_mul_ps(c500, _mm_sub_ps(f[0], f[1]));
+                lab[2][k] = _mm_mul_ps(c200, _mm_sub_ps(f[1], f[2]));
+            }
+            _mm_interleave_store_ps(dst + i*3, lab[0], lab[1], lab[2]);
+        }
+        return i;
     }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, scn = srccn;
+        int i = 0, scn = srccn;
         float gscale = GammaTabScale;
         const float* gammaTab = srgb ? sRGBGammaTab : 0;
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2],
               C3 = coeffs[3], C4 = coeffs[4], C5 = coeffs[5],
               C6 = coeffs[6], C7 = coeffs[7], C8 = coeffs[8];
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            src += i*scn;
+        }
+#endif
         n *= 3;
 
-        static const float _1_3 = 1.0f / 3.0f;
         static const float _a = 16.0f / 116.0f;
-        for (i = 0; i < n; i += 3, src += scn )
+        for (i *= 3; i < n; i += 3, src += scn )
         {
             float R = clip(src[0]);
             float G = clip(src[1]);
@@ -1410,9 +2353,9 @@ struct RGB2Lab_f
             float Y = R*C3 + G*C4 + B*C5;
             float Z = R*C6 + G*C7 + B*C8;
 
-            float FX = X > 0.008856f ? std::pow(X, _1_3) : (7.787f * X + _a);
-            float FY = Y > 0.008856f ? std::pow(Y, _1_3) : (7.787f * Y + _a);
-            float FZ = Z > 0.008856f ? std::pow(Z, _1_3) : (7.787f * Z + _a);
+            float FX = X > 0.008856f ? labCbrt(X) : (7.787f * X + _a);
+            float FY = Y > 0.008856f ? labCbrt(Y) : (7.787f * Y + _a);
+            float FZ = Z > 0.008856f ? labCbrt(Z) : (7.787f * Z + _a);
 
             float L = Y > 0.008856f ? (116.f * FY - 16.f) : (903.3f * Y);
             float a = 500.f * (FX - FY);
@@ -1427,6 +2370,7 @@ struct RGB2Lab_f
     int srccn;
     float coeffs[9];
     bool srgb;
+    bool haveSIMD;
 };
 
 struct Lab2RGB_f
@@ -1450,22 +2394,90 @@ struct Lab2RGB_f
             coeffs[i+3] = _coeffs[i+3]*_whitept[i];
             coeffs[i+blueIdx*3] = _coeffs[i+6]*_whitept[i];
         }
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below, with the branches replaced by masks;
+    // the sRGB gamma is applied afterwards, it is a table lookup
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, dcn = dstcn;
+        const float* gammaTab = srgb ? sRGBInvGammaTab : 0;
+        float gscale = GammaTabScale;
+        const __m128 lThresh = _mm_set1_ps(0.008856f * 903.3f);
+        const __m128 fThresh = _mm_set1_ps(7.787f * 0.008856f + 16.0f / 116.0f);
+        const __m128 c16_116 = _mm_set1_ps(16.0f / 116.0f), c7787 = _mm_set1_ps(7.787f);
+        const __m128 c9033 = _mm_set1_ps(903.3f), c16 = _mm_set1_ps(16.0f), c116 = _mm_set1_ps(116.0f);
+        const __m128 c500 = _mm_set1_ps(500.0f), c200 = _mm_set1_ps(200.0f);
+        const __m128 z = _mm_setzero_ps(), one = _mm_set1_ps(1.f);
+        __m128 alpha = _mm_set1_ps(ColorChannel<float>::max()), C[9];
+        __m128 c[3][2], rgb[3][2];
+        for( int j = 0; j < 9; j++ )
+            C[j] = _mm_set1_ps(coeffs[j]);
+
+        for( ; i <= n - 8; i += 8, src += 24 )
+        {
+            _mm_load_deinterleave_ps(src, 3, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128 li = c[0][k], ai = c[1][k], bi = c[2][k];
+                __m128 ml = _mm_cmple_ps(li, lThresh);
+                __m128 y0 = _mm_div_ps(li, c9033), fy0 = _mm_add_ps(_mm_mul_ps(c7787, y0), c16_116);
+                __m128 fy1 = _mm_div_ps(_mm_add_ps(li, c16), c116), y1 = _mm_mul_ps(_mm_mul_ps(fy1, fy1), fy1);
+                __m128 y = _mm_or_ps(_mm_and_ps(ml, y0), _mm_andnot_ps(ml, y1));
+                __m128 fy = _mm_or_ps(_mm_and_ps(ml, fy0), _mm_andnot_ps(ml, fy1));
+                __m128 fxz[] = { _mm_add_ps(_mm_div_ps(ai, c500), fy), _mm_sub_ps(fy, _mm_div_ps(bi, c200)) };
+
+                for( int j = 0; j < 2; j++ )
+                {
+                    __m128 mf = _mm_cmple_ps(fxz[j], fThresh);
+                    __m128 f0 = _mm_div_ps(_mm_sub_ps(fxz[j], c16_116), c7787);
+                    __m128 f1 = _mm_mul_ps(_mm_mul_ps(fxz[j], fxz[j]), fxz[j]);
+                    fxz[j] = _mm_or_ps(_mm_and_ps(mf, f0), _mm_andnot_ps(mf, f1));
+                }
+
+                // clip() keeps NaN, so does max(0, x)
+                __m128 x = fxz[0], zz = fxz[1];
+                for( int j = 0; j < 3; j++ )
+                {
+                    __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(C[j*3], x), _mm_mul_ps(C[j*3+1], y)),
+                                          _mm_mul_ps(C[j*3+2], zz));
+                    rgb[j][k] = _mm_min_ps(one, _mm_max_ps(z, v));
+                }
+            }
+            _mm_interleave_store_ps(dst + i*dcn, dcn, rgb[0], rgb[1], rgb[2], alpha);
+
+            if( gammaTab )
+                for( int j = 0; j < 8; j++ )
+                    for( int ch = 0; ch < 3; ch++ )
+                        dst[(i + j)*dcn + ch] = splineInterpolate(dst[(i + j)*dcn + ch]*gscale, gammaTab, GAMMA_TAB_SIZE);
+        }
+        return i;
     }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, dcn = dstcn;
+        int i = 0, dcn = dstcn;
         const float* gammaTab = srgb ? sRGBInvGammaTab : 0;
         float gscale = GammaTabScale;
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2],
         C3 = coeffs[3], C4 = coeffs[4], C5 = coeffs[5],
         C6 = coeffs[6], C7 = coeffs[7], C8 = coeffs[8];
         float alpha = ColorChannel<float>::max();
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            dst += i*dcn;
+        }
+#endif
         n *= 3;
 
         static const float lThresh = 0.008856f * 903.3f;
         static const float fThresh = 7.787f * 0.008856f + 16.0f / 116.0f;
-        for (i = 0; i < n; i += 3, dst += dcn)
+        for (i *= 3; i < n; i += 3, dst += dcn)
         {
             float li = src[i];
             float ai = src[i + 1];
@@ -1518,6 +2530,7 @@ struct Lab2RGB_f
     float coeffs[9];
     bool srgb;
     int blueInd;
+    bool haveSIMD;
 };
 
 #undef clip
@@ -1596,20 +2609,72 @@ struct RGB2Luv_f
         vn = 9*whitept[1]*d;
 
         CV_Assert(whitept[1] == 1.f);
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below; max(eps, x), like std::max(x, eps), keeps NaN
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, scn = srccn;
+        const float* gammaTab = srgb ? sRGBGammaTab : 0;
+        const __m128 gscale = _mm_set1_ps(GammaTabScale), lscale = _mm_set1_ps(LabCbrtTabScale);
+        const __m128 c116 = _mm_set1_ps(116.f), c16 = _mm_set1_ps(16.f), c15 = _mm_set1_ps(15.f);
+        const __m128 c3 = _mm_set1_ps(3.f), c52 = _mm_set1_ps(4*13), c225 = _mm_set1_ps(9*0.25f);
+        const __m128 eps = _mm_set1_ps(FLT_EPSILON), _un = _mm_set1_ps(13*un), _vn = _mm_set1_ps(13*vn);
+        __m128 C[9], c[3][2], luv[3][2];
+        for( int j = 0; j < 9; j++ )
+            C[j] = _mm_set1_ps(coeffs[j]);
+
+        for( ; i <= n - 8; i += 8, src += scn*8 )
+        {
+            _mm_load_deinterleave_ps(src, scn, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128 rgb[3], xyz[3];
+                for( int j = 0; j < 3; j++ )
+                {
+                    rgb[j] = c[j][k];
+                    if( gammaTab )
+                        rgb[j] = _mm_splineInterpolate_ps(_mm_mul_ps(rgb[j], gscale), gammaTab, GAMMA_TAB_SIZE);
+                }
+                for( int j = 0; j < 3; j++ )
+                    xyz[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rgb[0], C[j*3]), _mm_mul_ps(rgb[1], C[j*3+1])),
+                                        _mm_mul_ps(rgb[2], C[j*3+2]));
+
+                __m128 L = _mm_splineInterpolate_ps(_mm_mul_ps(xyz[1], lscale), LabCbrtTab, LAB_CBRT_TAB_SIZE);
+                L = _mm_sub_ps(_mm_mul_ps(c116, L), c16);
+                __m128 d = _mm_add_ps(_mm_add_ps(xyz[0], _mm_mul_ps(c15, xyz[1])), _mm_mul_ps(c3, xyz[2]));
+                d = _mm_div_ps(c52, _mm_max_ps(eps, d));
+                luv[0][k] = L;
+                luv[1][k] = _mm_mul_ps(L, _mm_sub_ps(_mm_mul_ps(xyz[0], d), _un));
+                luv[2][k] = _mm_mul_ps(L, _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(c225, xyz[1]), d), _vn));
+            }
+            _mm_interleave_store_ps(dst + i*3, luv[0], luv[1], luv[2]);
+        }
+        return i;
     }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, scn = srccn;
+        int i = 0, scn = srccn;
         float gscale = GammaTabScale;
         const float* gammaTab = srgb ? sRGBGammaTab : 0;
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2],
               C3 = coeffs[3], C4 = coeffs[4], C5 = coeffs[5],
               C6 = coeffs[6], C7 = coeffs[7], C8 = coeffs[8];
         float _un = 13*un, _vn = 13*vn;
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            src += i*scn;
+        }
+#endif
         n *= 3;
 
-        for( i = 0; i < n; i += 3, src += scn )
+        for( i *= 3; i < n; i += 3, src += scn )
         {
             float R = src[0], G = src[1], B = src[2];
             if( gammaTab )
@@ -1637,6 +2702,7 @@ struct RGB2Luv_f
     int srccn;
     float coeffs[9], un, vn;
     bool srgb;
+    bool haveSIMD;
 };
 
 
@@ -1665,11 +2731,58 @@ struct Luv2RGB_f
         vn = 9*whitept[1]*d;
 
         CV_Assert(whitept[1] == 1.f);
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+#if CV_SSE2
+    // the same operations as in the scalar loop below; the sRGB gamma is applied afterwards
+    int process_SSE2(const float* src, float* dst, int n) const
+    {
+        int i = 0, dcn = dstcn;
+        const float* gammaTab = srgb ? sRGBInvGammaTab : 0;
+        float gscale = GammaTabScale;
+        const __m128 c16 = _mm_set1_ps(16.f), c1_116 = _mm_set1_ps(1.f/116.f), c1_13 = _mm_set1_ps(1.f/13.f);
+        const __m128 one = _mm_set1_ps(1.f), c225 = _mm_set1_ps(2.25f), c12 = _mm_set1_ps(12.f);
+        const __m128 c3 = _mm_set1_ps(3.f), c20 = _mm_set1_ps(20.f), c025 = _mm_set1_ps(0.25f);
+        __m128 _un = _mm_set1_ps(un), _vn = _mm_set1_ps(vn);
+        __m128 alpha = _mm_set1_ps(ColorChannel<float>::max()), C[9];
+        __m128 c[3][2], rgb[3][2];
+        for( int j = 0; j < 9; j++ )
+            C[j] = _mm_set1_ps(coeffs[j]);
+
+        for( ; i <= n - 8; i += 8, src += 24 )
+        {
+            _mm_load_deinterleave_ps(src, 3, c[0], c[1], c[2]);
+            for( int k = 0; k < 2; k++ )
+            {
+                __m128 L = c[0][k], u = c[1][k], v = c[2][k];
+                __m128 Y = _mm_mul_ps(_mm_add_ps(L, c16), c1_116);
+                Y = _mm_mul_ps(_mm_mul_ps(Y, Y), Y);
+                __m128 d = _mm_div_ps(c1_13, L);
+                u = _mm_add_ps(_mm_mul_ps(u, d), _un);
+                v = _mm_add_ps(_mm_mul_ps(v, d), _vn);
+                __m128 iv = _mm_div_ps(one, v);
+                __m128 X = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(c225, u), Y), iv);
+                __m128 Z = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(c12, _mm_mul_ps(c3, u)),
+                                      _mm_mul_ps(c20, v)), Y), c025), iv);
+                for( int j = 0; j < 3; j++ )
+                    rgb[j][k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, C[j*3]), _mm_mul_ps(Y, C[j*3+1])),
+                                           _mm_mul_ps(Z, C[j*3+2]));
+            }
+            _mm_interleave_store_ps(dst + i*dcn, dcn, rgb[0], rgb[1], rgb[2], alpha);
+
+            if( gammaTab )
+                for( int j = 0; j < 8; j++ )
+                    for( int ch = 0; ch < 3; ch++ )
+                        dst[(i + j)*dcn + ch] = splineInterpolate(dst[(i + j)*dcn + ch]*gscale, gammaTab, GAMMA_TAB_SIZE);
+        }
+        return i;
     }
+#endif
 
     void operator()(const float* src, float* dst, int n) const
     {
-        int i, dcn = dstcn;
+        int i = 0, dcn = dstcn;
         const float* gammaTab = srgb ? sRGBInvGammaTab : 0;
         float gscale = GammaTabScale;
         float C0 = coeffs[0], C1 = coeffs[1], C2 = coeffs[2],
@@ -1677,9 +2790,16 @@ struct Luv2RGB_f
               C6 = coeffs[6], C7 = coeffs[7], C8 = coeffs[8];
         float alpha = ColorChannel<float>::max();
         float _un = un, _vn = vn;
+#if CV_SSE2
+        if( haveSIMD )
+        {
+            i = process_SSE2(src, dst, n);
+            dst += i*dcn;
+        }
+#endif
         n *= 3;
 
-        for( i = 0; i < n; i += 3, dst += dcn )
+        for( i *= 3; i < n; i += 3, dst += dcn )
         {
             float L = src[i], u = src[i+1], v = src[i+2], d, X, Y, Z;
             Y = (L + 16.f) * (1.f/116.f);
@@ -1711,6 +2831,7 @@ struct Luv2RGB_f
     int dstcn;
     float coeffs[9], un, vn;
     bool srgb;
+    bool haveSIMD;
 };
 
 
@@ -1720,18 +2841,47 @@ struct RGB2Luv_b
 
     RGB2Luv_b( int _srccn, int blueIdx, const float* _coeffs,
                const float* _whitept, bool _srgb )
-    : srccn(_srccn), cvt(3, blueIdx, _coeffs, _whitept, _srgb) {}
+    : srccn(_srccn), cvt(3, blueIdx, _coeffs, _whitept, _srgb)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
 
     void operator()(const uchar* src, uchar* dst, int n) const
     {
         int i, j, scn = srccn;
-        float buf[3*BLOCK_SIZE];
+        float CV_DECL_ALIGNED(16) buf[3*BLOCK_SIZE];
 
         for( i = 0; i < n; i += BLOCK_SIZE, dst += BLOCK_SIZE*3 )
         {
             int dn = std::min(n - i, (int)BLOCK_SIZE);
+            j = 0;
 
-            for( j = 0; j < dn*3; j += 3, src += scn )
+#if CV_SSE2
+            // the conversions to and from float are vectorized, the float conversion is
+            // vectorized by itself
+            if( haveSIMD )
+            {
+                const __m128 scale = _mm_set1_ps(1.f/255.f);
+                __m128i c[3][2];
+                __m128 f[3][4];
+                for( ; j <= (dn - 32)*3; j += 96, src += scn*32 )
+                {
+                    _mm_load_deinterleave_epi8(src, scn, c[0], c[1], c[2]);
+                    for( int k = 0; k < 2; k++ )
+                    {
+                        for( int ch = 0; ch < 3; ch++ )
+                        {
+                            _mm_cvtepu8_ps(c[ch][k], f[ch]);
+                            for( int l = 0; l < 4; l++ )
+                                f[ch][l] = _mm_mul_ps(f[ch][l], scale);
+                        }
+                        for( int l = 0; l < 4; l += 2 )
+                            _mm_interleave_store_ps(buf + j + k*48 + l*12, f[0] + l, f[1] + l, f[2] + l);
+                    }
+                }
+            }
+#endif
+            for( ; j < dn*3; j += 3, src += scn )
             {
                 buf[j] = src[0]*(1.f/255.f);
                 buf[j+1] = (float)(src[1]*(1.f/255.f));
@@ -1739,7 +2889,35 @@ struct RGB2Luv_b
             }
             cvt(buf, buf, dn);
 
-            for( j = 0; j < dn*3; j += 3 )
+            j = 0;
+#if CV_SSE2
+            if( haveSIMD )
+            {
+                const __m128 s0 = _mm_set1_ps(2.55f), s1 = _mm_set1_ps(0.72033898305084743f);
+                const __m128 d1 = _mm_set1_ps(96.525423728813564f), s2 = _mm_set1_ps(0.99609375f);
+                const __m128 d2 = _mm_set1_ps(139.453125f);
+                __m128i luv[3][2];
+                for( ; j <= (dn - 32)*3; j += 96 )
+                {
+                    for( int k = 0; k < 2; k++ )
+                    {
+                        __m128 f[3][4];
+                        for( int l = 0; l < 4; l += 2 )
+                            _mm_load_deinterleave_ps(buf + j + k*48 + l*12, 3, f[0] + l, f[1] + l, f[2] + l);
+                        for( int l = 0; l < 4; l++ )
+                        {
+                            f[0][l] = _mm_mul_ps(f[0][l], s0);
+                            f[1][l] = _mm_add_ps(_mm_mul_ps(f[1][l], s1), d1);
+                            f[2][l] = _mm_add_ps(_mm_mul_ps(f[2][l], s2), d2);
+                        }
+                        for( int ch = 0; ch < 3; ch++ )
+                            luv[ch][k] = _mm_cvtps_epu8(f[ch]);
+                    }
+                    _mm_interleave_store_epi8(dst + j, 3, luv[0], luv[1], luv[2]);
+                }
+            }
+#endif
+            for( ; j < dn*3; j += 3 )
             {
                 dst[j] = saturate_cast<uchar>(buf[j]*2.55f);
                 dst[j+1] = saturate_cast<uchar>(buf[j+1]*0.72033898305084743f + 96.525423728813564f);
@@ -1750,6 +2928,7 @@ struct RGB2Luv_b
 
     int srccn;
     RGB2Luv_f cvt;
+    bool haveSIMD;
 };
 
 
@@ -1814,15 +2993,124 @@ const int ITUR_BT_601_CBU =  460324;
 const int ITUR_BT_601_CGV = -385875;
 const int ITUR_BT_601_CBV = -74448;
 
+#if CV_SSE2
+
+// converts 16 pixels of each of the rows y1 and y2 that share the 8 chroma samples u and v
+// (16-bit, 128 subtracted) to rgb[row][channel][k]; the 20-bit coefficients are split as
+// c = (c >> 7)*128 + (c & 127), so that all the products are computed exactly with _mm_madd_epi16
+// from the pairs (128*x, x)
+static inline void YUV420toRGB_SSE2(__m128i u, __m128i v, const uchar* y1, const uchar* y2,
+                                    int bIdx, int k, __m128i rgb[2][3][2])
+{
+    const __m128i z = _mm_setzero_si128(), c16 = _mm_set1_epi8(16);
+    const __m128i half = _mm_set1_epi32(1 << (ITUR_BT_601_SHIFT - 1));
+    const __m128i cY = _mm_set_pair_epi16(ITUR_BT_601_CY >> 7, ITUR_BT_601_CY & 127);
+    const __m128i cVR = _mm_set_pair_epi16(ITUR_BT_601_CVR >> 7, ITUR_BT_601_CVR & 127);
+    const __m128i cVG = _mm_set_pair_epi16(ITUR_BT_601_CVG >> 7, ITUR_BT_601_CVG & 127);
+    const __m128i cUG = _mm_set_pair_epi16(ITUR_BT_601_CUG >> 7, ITUR_BT_601_CUG & 127);
+    const __m128i cUB = _mm_set_pair_epi16(ITUR_BT_601_CUB >> 7, ITUR_BT_601_CUB & 127);
+    __m128i u7 = _mm_slli_epi16(u, 7), v7 = _mm_slli_epi16(v, 7);
+
+    // (r|g|b)uv for the 8 chroma samples, as 2 vectors of 32-bit values
+    __m128i ruv[2], guv[2], buv[2];
+    ruv[0] = _mm_add_epi32(half, _mm_madd_epi16(_mm_unpacklo_epi16(v7, v), cVR));
+    ruv[1] = _mm_add_epi32(half, _mm_madd_epi16(_mm_unpackhi_epi16(v7, v), cVR));
+    guv[0] = _mm_add_epi32(_mm_add_epi32(half, _mm_madd_epi16(_mm_unpacklo_epi16(v7, v), cVG)),
+                           _mm_madd_epi16(_mm_unpacklo_epi16(u7, u), cUG));
+    guv[1] = _mm_add_epi32(_mm_add_epi32(half, _mm_madd_epi16(_mm_unpackhi_epi16(v7, v), cVG)),
+                           _mm_madd_epi16(_mm_unpackhi_epi16(u7, u), cUG));
+    buv[0] = _mm_add_epi32(half, _mm_madd_epi16(_mm_unpacklo_epi16(u7, u), cUB));
+    buv[1] = _mm_add_epi32(half, _mm_madd_epi16(_mm_unpackhi_epi16(u7, u), cUB));
+
+    for( int row = 0; row < 2; row++ )
+    {
+        __m128i yv = _mm_subs_epu8(_mm_loadu_si128((const __m128i*)(row == 0 ? y1 : y2)), c16);
+        __m128i yy[4], r[4], g[4], b[4];
+        for( int h = 0; h < 2; h++ )
+        {
+            __m128i y16 = h == 0 ? _mm_unpacklo_epi8(yv, z) : _mm_unpackhi_epi8(yv, z);
+            __m128i y7 = _mm_slli_epi16(y16, 7);
+            yy[h*2] = _mm_madd_epi16(_mm_unpacklo_epi16(y7, y16), cY);
+            yy[h*2+1] = _mm_madd_epi16(_mm_unpackhi_epi16(y7, y16), cY);
+        }
+        // every chroma sample is shared by 2 neighbour pixels
+        for( int j = 0; j < 4; j++ )
+        {
+            __m128i rj = (j & 1) ? _mm_unpackhi_epi32(ruv[j/2], ruv[j/2]) : _mm_unpacklo_epi32(ruv[j/2], ruv[j/2]);
+            __m128i gj = (j & 1) ? _mm_unpackhi_epi32(guv[j/2], guv[j/2]) : _mm_unpacklo_epi32(guv[j/2], guv[j/2]);
+            __m128i bj = (j & 1) ? _mm_unpackhi_epi32(buv[j/2], buv[j/2]) : _mm_unpacklo_epi32(buv[j/2], buv[j/2]);
+            r[j] = _mm_srai_epi32(_mm_add_epi32(yy[j], rj), ITUR_BT_601_SHIFT);
+            g[j] = _mm_srai_epi32(_mm_add_epi32(yy[j], gj), ITUR_BT_601_SHIFT);
+            b[j] = _mm_srai_epi32(_mm_add_epi32(yy[j], bj), ITUR_BT_601_SHIFT);
+        }
+        rgb[row][2-bIdx][k] = _mm_packus_epi16(_mm_packs_epi32(r[0], r[1]), _mm_packs_epi32(r[2], r[3]));
+        rgb[row][1][k] = _mm_packus_epi16(_mm_packs_epi32(g[0], g[1]), _mm_packs_epi32(g[2], g[3]));
+        rgb[row][bIdx][k] = _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]), _mm_packs_epi32(b[2], b[3]));
+    }
+}
+
+// converts the pixels [0, i) of a pair of rows sharing the interleaved chroma row uv, i = width & -32
+static int YUV420sp2RGB_SSE2(const uchar* y1, const uchar* y2, const uchar* uv, uchar* row1, uchar* row2,
+                             int width, int dcn, int bIdx, int uIdx)
+{
+    const __m128i c128 = _mm_set1_epi16(128), m = _mm_set1_epi16(0xff);
+    __m128i rgb[2][3][2], a[2];
+    a[0] = a[1] = _mm_set1_epi8(-1);
+    int i = 0;
+
+    for( ; i <= width - 32; i += 32 )
+    {
+        for( int k = 0; k < 2; k++ )
+        {
+            __m128i uv0 = _mm_loadu_si128((const __m128i*)(uv + i + k*16));
+            __m128i u = _mm_sub_epi16(uIdx == 0 ? _mm_and_si128(uv0, m) : _mm_srli_epi16(uv0, 8), c128);
+            __m128i v = _mm_sub_epi16(uIdx == 0 ? _mm_srli_epi16(uv0, 8) : _mm_and_si128(uv0, m), c128);
+            YUV420toRGB_SSE2(u, v, y1 + i + k*16, y2 + i + k*16, bIdx, k, rgb);
+        }
+        _mm_interleave_store_epi8(row1 + i*dcn, dcn, rgb[0][0], rgb[0][1], rgb[0][2], a);
+        _mm_interleave_store_epi8(row2 + i*dcn, dcn, rgb[1][0], rgb[1][1], rgb[1][2], a);
+    }
+    return i;
+}
+
+// the same for the planar chroma rows u and v (I420, YV12)
+static int YUV420p2RGB_SSE2(const uchar* y1, const uchar* y2, const uchar* u1, const uchar* v1,
+                            uchar* row1, uchar* row2, int width, int dcn, int bIdx)
+{
+    const __m128i z = _mm_setzero_si128(), c128 = _mm_set1_epi16(128);
+    __m128i rgb[2][3][2], a[2];
+    a[0] = a[1] = _mm_set1_epi8(-1);
+    int i = 0;
+
+    for( ; i <= width - 32; i += 32 )
+    {
+        for( int k = 0; k < 2; k++ )
+        {
+            __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u1 + i/2 + k*8)), z), c128);
+            __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v1 + i/2 + k*8)), z), c128);
+            YUV420toRGB_SSE2(u, v, y1 + i + k*16, y2 + i + k*16, bIdx, k, rgb);
+        }
+        _mm_interleave_store_epi8(row1 + i*dcn, dcn, rgb[0][0], rgb[0][1], rgb[0][2], a);
+        _mm_interleave_store_epi8(row2 + i*dcn, dcn, rgb[1][0], rgb[1][1], rgb[1][2], a);
+    }
+    return i;
+}
+
+#endif
+
 template<int bIdx, int uIdx>
 struct YUV420sp2RGB888Invoker
 {
     Mat* dst;
     const uchar* my1, *muv;
     int width, stride;
+    bool haveSIMD;
 
     YUV420sp2RGB888Invoker(Mat* _dst, int _stride, const uchar* _y1, const uchar* _uv)
-        : dst(_dst), my1(_y1), muv(_uv), width(_dst->cols), stride(_stride) {}
+        : dst(_dst), my1(_y1), muv(_uv), width(_dst->cols), stride(_stride)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
 
     void operator()(const BlockedRange& range) const
     {
@@ -1849,8 +3137,16 @@ struct YUV420sp2RGB888Invoker
             uchar* row1 = dst->ptr<uchar>(j);
             uchar* row2 = dst->ptr<uchar>(j + 1);
             const uchar* y2 = y1 + stride;
+            int i = 0;
 
-            for (int i = 0; i < width; i += 2, row1 += 6, row2 += 6)
+#if CV_SSE2
+            if( haveSIMD )
+            {
+                i = YUV420sp2RGB_SSE2(y1, y2, uv, row1, row2, width, 3, bIdx, uIdx);
+                row1 += i*3; row2 += i*3;
+            }
+#endif
+            for ( ; i < width; i += 2, row1 += 6, row2 += 6)
             {
                 int u = int(uv[i + 0 + uIdx]) - 128;
                 int v = int(uv[i + 1 - uIdx]) - 128;
@@ -1889,9 +3185,13 @@ struct YUV420sp2RGBA8888Invoker
     Mat* dst;
     const uchar* my1, *muv;
     int width, stride;
+    bool haveSIMD;
 
     YUV420sp2RGBA8888Invoker(Mat* _dst, int _stride, const uchar* _y1, const uchar* _uv)
-        : dst(_dst), my1(_y1), muv(_uv), width(_dst->cols), stride(_stride) {}
+        : dst(_dst), my1(_y1), muv(_uv), width(_dst->cols), stride(_stride)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
 
     void operator()(const BlockedRange& range) const
     {
@@ -1918,8 +3218,16 @@ struct YUV420sp2RGBA8888Invoker
             uchar* row1 = dst->ptr<uchar>(j);
             uchar* row2 = dst->ptr<uchar>(j + 1);
             const uchar* y2 = y1 + stride;
+            int i = 0;
 
-            for (int i = 0; i < width; i += 2, row1 += 8, row2 += 8)
+#if CV_SSE2
+            if( haveSIMD )
+            {
+                i = YUV420sp2RGB_SSE2(y1, y2, uv, row1, row2, width, 4, bIdx, uIdx);
+                row1 += i*4; row2 += i*4;
+            }
+#endif
+            for ( ; i < width; i += 2, row1 += 8, row2 += 8)
             {
                 int u = int(uv[i + 0 + uIdx]) - 128;
                 int v = int(uv[i + 1 - uIdx]) - 128;
@@ -1963,9 +3271,13 @@ struct YUV420p2RGB888Invoker
     const uchar* my1, *mu, *mv;
     int width, stride;
     int ustepIdx, vstepIdx;
+    bool haveSIMD;
 
     YUV420p2RGB888Invoker(Mat* _dst, int _stride, const uchar* _y1, const uchar* _u, const uchar* _v, int _ustepIdx, int _vstepIdx)
-        : dst(_dst), my1(_y1), mu(_u), mv(_v), width(_dst->cols), stride(_stride), ustepIdx(_ustepIdx), vstepIdx(_vstepIdx) {}
+        : dst(_dst), my1(_y1), mu(_u), mv(_v), width(_dst->cols), stride(_stride), ustepIdx(_ustepIdx), vstepIdx(_vstepIdx)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
 
     void operator()(const BlockedRange& range) const
     {
@@ -1990,8 +3302,16 @@ struct YUV420p2RGB888Invoker
             uchar* row1 = dst->ptr<uchar>(j);
             uchar* row2 = dst->ptr<uchar>(j + 1);
             const uchar* y2 = y1 + stride;
+            int i = 0;
 
-            for (int i = 0; i < width / 2; i += 1, row1 += 6, row2 += 6)
+#if CV_SSE2
+            if( haveSIMD )
+            {
+                i = YUV420p2RGB_SSE2(y1, y2, u1, v1, row1, row2, width, 3, bIdx)/2;
+                row1 += i*6; row2 += i*6;
+            }
+#endif
+            for ( ; i < width / 2; i += 1, row1 += 6, row2 += 6)
             {
                 int u = int(u1[i]) - 128;
                 int v = int(v1[i]) - 128;
@@ -2031,9 +3351,13 @@ struct YUV420p2RGBA8888Invoker
     const uchar* my1, *mu, *mv;
     int width, stride;
     int ustepIdx, vstepIdx;
+    bool haveSIMD;
 
     YUV420p2RGBA8888Invoker(Mat* _dst, int _stride, const uchar* _y1, const uchar* _u, const uchar* _v, int _ustepIdx, int _vstepIdx)
-        : dst(_dst), my1(_y1), mu(_u), mv(_v), width(_dst->cols), stride(_stride), ustepIdx(_ustepIdx), vstepIdx(_vstepIdx) {}
+        : dst(_dst), my1(_y1), mu(_u), mv(_v), width(_dst->cols), stride(_stride), ustepIdx(_ustepIdx), vstepIdx(_vstepIdx)
+    {
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
 
     void operator()(const BlockedRange& range) const
     {
@@ -2058,8 +3382,16 @@ struct YUV420p2RGBA8888Invoker
             uchar* row1 = dst->ptr<uchar>(j);
             uchar* row2 = dst->ptr<uchar>(j + 1);
             const uchar* y2 = y1 + stride;
+            int i = 0;
 
-            for (int i = 0; i < width / 2; i += 1, row1 += 8, row2 += 8)
+#if CV_SSE2
+            if( haveSIMD )
+            {
+                i = YUV420p2RGB_SSE2(y1, y2, u1, v1, row1, row2, width, 4, bIdx)/2;
+                row1 += i*8; row2 += i*8;
+            }
+#endif
+            for ( ; i < width / 2; i += 1, row1 += 8, row2 += 8)
             {
                 int u = int(u1[i]) - 128;
                 int v = int(v1[i]) - 128;
@@ -2397,6 +3729,157 @@ struct mRGBA2RGBA
     }
 };
 
+//////////////////////////// Fused convert/resize to planar float ////////////////////////////
+
+// horizontal coefficients are fixed-point, as in resize()
+static const int PLANAR_COEF_BITS = 11;
+static const int PLANAR_COEF_SCALE = 1 << PLANAR_COEF_BITS;
+
+typedef void (*YUV420spPairFunc)(Mat& pair, int stride, const uchar* y, const uchar* uv);
+
+// decodes a single row pair of NV12/NV21 into the 2-row image "pair"
+template<int bIdx, int uIdx>
+static void cvtYUV420spPair(Mat& pair, int stride, const uchar* y, const uchar* uv)
+{
+    YUV420sp2RGB888Invoker<bIdx, uIdx>(&pair, stride, y, uv)(BlockedRange(0, 1));
+}
+
+// Each output row is produced from two source rows, which are resampled horizontally into
+// planar fixed-point rows; the rows are cached, so every source row is processed once per stripe
+// when the image is upscaled. Channel swaps and gray expansion are folded into the horizontal
+// pass (cmap tells which source channel feeds each output plane); NV12/NV21 row pairs are
+// decoded on demand. The vertical pass applies the scale and shift and writes the output
+// planes directly.
+class ResizeToPlanarInvoker : public ParallelLoopBody
+{
+public:
+    ResizeToPlanarInvoker(const Mat& _src, Mat& _dst, Size _ssize, int _scn, const int* _cmap,
+                          YUV420spPairFunc _yuvFunc, const int* _xofs0, const int* _xofs1,
+                          const int* _alpha, const int* _yofs, const float* _beta,
+                          float _scale, const float* _shift) :
+        ParallelLoopBody(), src(_src), dst(_dst), ssize(_ssize), scn(_scn), cn(_dst.size[1]),
+        yuvFunc(_yuvFunc), xofs0(_xofs0), xofs1(_xofs1), alpha(_alpha), yofs(_yofs), beta(_beta),
+        scale(_scale)
+    {
+        for( int k = 0; k < cn; k++ )
+        {
+            cmap[k] = _cmap[k];
+            shift[k] = _shift[k];
+        }
+        haveSIMD = checkHardwareSupport(CV_CPU_SSE2);
+    }
+
+    virtual void operator()(const Range& range) const
+    {
+        int dwidth = dst.size[3];
+        AutoBuffer<uchar> _pairs(yuvFunc ? ssize.width*scn*4 : 1);
+        AutoBuffer<int> _hbuf(dwidth*cn*2);
+        int* hbuf[] = { _hbuf, _hbuf + dwidth*cn };
+        int hkey[] = { -1, -1 }, pkey[] = { -1, -1 };
+
+        for( int dy = range.start; dy < range.end; dy++ )
+        {
+            int sy0 = yofs[dy], sy1 = std::min(sy0 + 1, ssize.height - 1);
+            const int* h0 = resampleRow(sy0, _pairs, pkey, hbuf, hkey);
+            const int* h1 = resampleRow(sy1, _pairs, pkey, hbuf, hkey);
+            float b0 = beta[dy*2]*scale, b1 = beta[dy*2+1]*scale;
+
+            for( int k = 0; k < cn; k++, h0 += dwidth, h1 += dwidth )
+            {
+                float* D = (float*)dst.ptr(0, k) + (size_t)dy*dwidth;
+                float s = shift[k];
+                int dx = 0;
+            #if CV_SSE2
+                if( haveSIMD )
+                {
+                    __m128 vb0 = _mm_set1_ps(b0), vb1 = _mm_set1_ps(b1), vs = _mm_set1_ps(s);
+                    for( ; dx <= dwidth - 4; dx += 4 )
+                    {
+                        __m128 v0 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(h0 + dx)));
+                        __m128 v1 = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(h1 + dx)));
+                        __m128 v = _mm_add_ps(_mm_mul_ps(v0, vb0), _mm_mul_ps(v1, vb1));
+                        _mm_storeu_ps(D + dx, _mm_add_ps(v, vs));
+                    }
+                }
+            #endif
+                for( ; dx < dwidth; dx++ )
+                    D[dx] = h0[dx]*b0 + h1[dx]*b1 + s;
+            }
+        }
+    }
+
+private:
+    // returns the source row sy; NV12/NV21 row pairs are decoded into BGR/RGB first
+    const uchar* fetchRow(int sy, uchar* pairs, int* pkey) const
+    {
+        if( !yuvFunc )
+            return src.ptr(sy);
+
+        // consecutive pairs go to different slots, so both rows of an output row stay cached
+        int rowsize = ssize.width*scn, pair = sy >> 1, slot = pair & 1;
+        uchar* buf = pairs + slot*rowsize*2;
+        if( pkey[slot] != pair )
+        {
+            Mat tile(2, ssize.width, CV_8UC3, buf);
+            const uchar* y = src.data + (size_t)pair*2*src.step;
+            const uchar* uv = src.data + (size_t)ssize.height*src.step + (size_t)pair*src.step;
+            yuvFunc(tile, (int)src.step, y, uv);
+            pkey[slot] = pair;
+        }
+        return buf + (sy & 1)*rowsize;
+    }
+
+    const int* resampleRow(int sy, uchar* pairs, int* pkey, int** hbuf, int* hkey) const
+    {
+        int slot = sy & 1;
+        int* H = hbuf[slot];
+        if( hkey[slot] == sy )
+            return H;
+
+        const uchar* S = fetchRow(sy, pairs, pkey);
+        int dwidth = dst.size[3];
+        if( cn == 3 )
+        {
+            int c0 = cmap[0], c1 = cmap[1], c2 = cmap[2];
+            int* H1 = H + dwidth, *H2 = H1 + dwidth;
+            for( int dx = 0; dx < dwidth; dx++ )
+            {
+                const uchar* s0 = S + xofs0[dx], *s1 = S + xofs1[dx];
+                int a1 = alpha[dx], a0 = PLANAR_COEF_SCALE - a1;
+                H[dx] = s0[c0]*a0 + s1[c0]*a1;
+                H1[dx] = s0[c1]*a0 + s1[c1]*a1;
+                H2[dx] = s0[c2]*a0 + s1[c2]*a1;
+            }
+        }
+        else
+        {
+            for( int k = 0; k < cn; k++, H += dwidth )
+                for( int dx = 0; dx < dwidth; dx++ )
+                {
+                    int a1 = alpha[dx];
+                    H[dx] = S[xofs0[dx] + k]*(PLANAR_COEF_SCALE - a1) + S[xofs1[dx] + k]*a1;
+                }
+        }
+        hkey[slot] = sy;
+        return hbuf[slot];
+    }
+
+    const Mat& src;
+    Mat& dst;
+    Size ssize;
+    int scn, cn, cmap[4];
+    YUV420spPairFunc yuvFunc;
+    const int* xofs0;
+    const int* xofs1;
+    const int* alpha;
+    const int* yofs;
+    const float* beta;
+    float scale, shift[4];
+    bool haveSIMD;
+
+    const ResizeToPlanarInvoker& operator= (const ResizeToPlanarInvoker&);
+};
+
 }//namespace cv
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -2405,6 +3888,7 @@ struct mRGBA2RGBA
 
 void cv::cvtColor( InputArray _src, OutputArray _dst, int code, int dcn )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), dst;
     Size sz = src.size();
     int scn = src.channels(), depth = src.depth(), bidx;
@@ -2939,6 +4423,98 @@ void cv::cvtColor( InputArray _src, OutputArray _dst, int code, int dcn )
     }
 }
 
+void cv::resizeToPlanar( InputArray _src, OutputArray _dst, Size dsize, int code,
+                         double scale, const Scalar& shift )
+{
+    Mat src = _src.getMat();
+    Size ssize = src.size();
+    int scn = src.channels(), cn = 3;
+    int cmap[] = { 0, 1, 2, 3 };
+    YUV420spPairFunc yuvFunc = 0;
+
+    CV_Assert( src.depth() == CV_8U && dsize.area() > 0 );
+
+    switch( code )
+    {
+        case -1:
+            CV_Assert( 1 <= scn && scn <= 4 );
+            cn = scn;
+            break;
+        case COLOR_BGR2RGB: case COLOR_BGRA2RGB:
+            CV_Assert( scn == (code == COLOR_BGR2RGB ? 3 : 4) );
+            std::swap(cmap[0], cmap[2]);
+            break;
+        case COLOR_BGRA2BGR:
+            CV_Assert( scn == 4 );
+            break;
+        case COLOR_GRAY2BGR:
+            CV_Assert( scn == 1 );
+            cmap[1] = cmap[2] = 0;
+            break;
+        case COLOR_YUV2BGR_NV12: case COLOR_YUV2RGB_NV12:
+        case COLOR_YUV2BGR_NV21: case COLOR_YUV2RGB_NV21:
+            {
+                CV_Assert( scn == 1 && ssize.width % 2 == 0 && ssize.height % 3 == 0 );
+                ssize.height = ssize.height*2/3;
+                CV_Assert( ssize.height % 2 == 0 );
+                int bIdx = (code == COLOR_YUV2BGR_NV12 || code == COLOR_YUV2BGR_NV21) ? 0 : 2;
+                int uIdx = (code == COLOR_YUV2BGR_NV21 || code == COLOR_YUV2RGB_NV21) ? 1 : 0;
+                yuvFunc = bIdx == 0 ? (uIdx == 0 ? cvtYUV420spPair<0, 0> : cvtYUV420spPair<0, 1>) :
+                                      (uIdx == 0 ? cvtYUV420spPair<2, 0> : cvtYUV420spPair<2, 1>);
+                // the offsets below address the decoded 3-channel rows
+                scn = 3;
+            }
+            break;
+        default:
+            CV_Error( CV_StsBadFlag, "Unknown/unsupported color conversion code" );
+    }
+
+    int sz[] = { 1, cn, dsize.height, dsize.width };
+    _dst.create(4, sz, CV_32F);
+    Mat dst = _dst.getMat();
+
+    // the same pixel mapping as resize(..., INTER_LINEAR)
+    double scale_x = (double)ssize.width/dsize.width, scale_y = (double)ssize.height/dsize.height;
+    AutoBuffer<int> _ofs(dsize.width*3 + dsize.height);
+    AutoBuffer<float> _beta(dsize.height*2);
+    int* xofs0 = _ofs, *xofs1 = xofs0 + dsize.width, *alpha = xofs1 + dsize.width;
+    int* yofs = alpha + dsize.width;
+    float* beta = _beta;
+
+    for( int dx = 0; dx < dsize.width; dx++ )
+    {
+        float fx = (float)((dx+0.5)*scale_x - 0.5);
+        int sx = cvFloor(fx);
+        fx -= sx;
+        if( sx < 0 )
+            fx = 0, sx = 0;
+        if( sx >= ssize.width-1 )
+            fx = 0, sx = ssize.width-1;
+        xofs0[dx] = sx*scn;
+        xofs1[dx] = std::min(sx + 1, ssize.width - 1)*scn;
+        alpha[dx] = saturate_cast<int>(fx*PLANAR_COEF_SCALE);
+    }
+
+    for( int dy = 0; dy < dsize.height; dy++ )
+    {
+        float fy = (float)((dy+0.5)*scale_y - 0.5);
+        int sy = cvFloor(fy);
+        fy -= sy;
+        if( sy < 0 )
+            fy = 0, sy = 0;
+        if( sy >= ssize.height-1 )
+            fy = 0, sy = ssize.height-1;
+        yofs[dy] = sy;
+        beta[dy*2] = (1.f - fy)/PLANAR_COEF_SCALE;
+        beta[dy*2+1] = fy/PLANAR_COEF_SCALE;
+    }
+
+    float fshift[] = { (float)shift[0], (float)shift[1], (float)shift[2], (float)shift[3] };
+    ResizeToPlanarInvoker invoker(src, dst, ssize, scn, cmap, yuvFunc,
+                                  xofs0, xofs1, alpha, yofs, beta, (float)scale, fshift);
+    parallel_for_(Range(0, dsize.height), invoker, dst.total()/(double)(1<<16));
+}
+
 CV_IMPL void
 cvCvtColor( const CvArr* srcarr, CvArr* dstarr, int code )
 {
@@ -1703,6 +1703,7 @@ cvFindContours( void*  img,  CvMemStorage*  storage,
 void cv::findContours( InputOutputArray _image, OutputArrayOfArrays _contours,
                    OutputArray _hierarchy, int mode, int method, Point offset )
 {
+    CV_TRACE_FUNCTION();
     Mat image = _image.getMat();
     MemStorage storage(cvCreateMemStorage());
     CvMat _cimage = image;
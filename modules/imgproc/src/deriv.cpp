@@ -413,6 +413,7 @@ static bool IPPDeriv(const Mat& src, Mat& dst, int ddepth, int dx, int dy, int k
 void cv::Sobel( InputArray _src, OutputArray _dst, int ddepth, int dx, int dy,
                 int ksize, double scale, double delta, int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat();
     if (ddepth < 0)
         ddepth = src.depth();
@@ -682,6 +682,7 @@ distanceATS_L1_8u( const Mat& src, Mat& dst )
 void cv::distanceTransform( InputArray _src, OutputArray _dst, OutputArray _labels,
                             int distType, int maskSize, int labelType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), dst = _dst.getMat(), labels;
     bool need_labels = _labels.needed();
 
@@ -169,6 +169,8 @@ int FilterEngine::start(Size _wholeSize, Rect _roi, int _maxBufRows)
         _maxBufRows = ksize.height + 3;
     _maxBufRows = std::max(_maxBufRows, std::max(anchor.y, ksize.height-anchor.y-1)*2+1);
 
+    // the buffers are members of the engine, they live as long as the engine and may be used by
+    // another thread, so they cannot come from the scratch arena; they are kept between the calls
     if( maxWidth < roi.width || _maxBufRows != (int)rows.size() )
     {
         rows.resize(_maxBufRows);
@@ -407,6 +409,57 @@ void FilterEngine::apply(const Mat& src, Mat& dst,
              dst.data + dstOfs.y*dst.step + dstOfs.x*dst.elemSize(), (int)dst.step );
 }
 
+
+class FilterBandInvoker : public ParallelLoopBody
+{
+public:
+    FilterBandInvoker( const FilterEngineFactory& _factory, const Mat& _src, Mat& _dst,
+                       bool _isolated, int _nbands ) :
+        factory(&_factory), src(&_src), dst(&_dst), isolated(_isolated), nbands(_nbands) {}
+
+    void operator()( const Range& range ) const
+    {
+        // every band has its own engine, so the ring buffers and the filter states are not shared.
+        // The rows above and below the band are read from the source image, the same as in the case of
+        // a single pass, and the border extrapolation is only done at the edges of the whole image.
+        Ptr<FilterEngine> f = factory->create();
+        for( int i = range.start; i < range.end; i++ )
+        {
+            int y0 = (int)((int64)src->rows*i/nbands);
+            int y1 = (int)((int64)src->rows*(i+1)/nbands);
+            f->apply(*src, *dst, Rect(0, y0, src->cols, y1 - y0), Point(0, y0), isolated);
+        }
+    }
+
+private:
+    const FilterEngineFactory* factory;
+    const Mat* src;
+    Mat* dst;
+    bool isolated;
+    int nbands;
+};
+
+void applyFilterParallel( const FilterEngineFactory& factory, const Mat& src, Mat& dst, bool isolated )
+{
+    Ptr<FilterEngine> f = factory.create();
+    CV_Assert( src.size() == dst.size() );
+
+    // each band re-reads ksize.height-1 source rows of its neighbours,
+    // so the bands should be much taller than the kernel
+    int minBandRows = std::max(f->ksize.height*8, 32);
+    int nbands = std::min(getNumThreads()*4, src.rows/minBandRows);
+    bool inplace = src.datastart < dst.dataend && dst.datastart < src.dataend;
+
+    if( nbands < 2 || inplace || src.total() < (size_t)(1 << 16) )
+    {
+        f->apply(src, dst, Rect(0,0,-1,-1), Point(), isolated);
+        return;
+    }
+
+    parallel_for_(Range(0, nbands), FilterBandInvoker(factory, src, dst, isolated, nbands),
+                  std::min(getNumThreads(), nbands));
+}
+
 }
 
 /****************************************************************************************\
@@ -3184,10 +3237,59 @@ cv::Ptr<cv::FilterEngine> cv::createLinearFilter( int _srcType, int _dstType,
 }
 
 
+namespace cv
+{
+
+class LinearFilterFactory : public FilterEngineFactory
+{
+public:
+    LinearFilterFactory( int _srcType, int _dstType, const Mat& _kernel, Point _anchor,
+                         double _delta, int _borderType ) :
+        srcType(_srcType), dstType(_dstType), kernel(_kernel), anchor(_anchor),
+        delta(_delta), borderType(_borderType) {}
+
+    Ptr<FilterEngine> create() const
+    {
+        return createLinearFilter(srcType, dstType, kernel, anchor, delta, borderType);
+    }
+
+private:
+    int srcType, dstType;
+    Mat kernel;
+    Point anchor;
+    double delta;
+    int borderType;
+};
+
+class SeparableLinearFilterFactory : public FilterEngineFactory
+{
+public:
+    SeparableLinearFilterFactory( int _srcType, int _dstType, const Mat& _kernelX, const Mat& _kernelY,
+                                  Point _anchor, double _delta, int _borderType ) :
+        srcType(_srcType), dstType(_dstType), kernelX(_kernelX), kernelY(_kernelY),
+        anchor(_anchor), delta(_delta), borderType(_borderType) {}
+
+    Ptr<FilterEngine> create() const
+    {
+        return createSeparableLinearFilter(srcType, dstType, kernelX, kernelY,
+                                           anchor, delta, borderType);
+    }
+
+private:
+    int srcType, dstType;
+    Mat kernelX, kernelY;
+    Point anchor;
+    double delta;
+    int borderType;
+};
+
+}
+
 void cv::filter2D( InputArray _src, OutputArray _dst, int ddepth,
                    InputArray _kernel, Point anchor,
                    double delta, int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), kernel = _kernel.getMat();
 
     if( ddepth < 0 )
@@ -3224,9 +3326,9 @@ void cv::filter2D( InputArray _src, OutputArray _dst, int ddepth,
         return;
     }
 
-    Ptr<FilterEngine> f = createLinearFilter(src.type(), dst.type(), kernel,
-                                             anchor, delta, borderType & ~BORDER_ISOLATED );
-    f->apply(src, dst, Rect(0,0,-1,-1), Point(), (borderType & BORDER_ISOLATED) != 0 );
+    LinearFilterFactory factory(src.type(), dst.type(), kernel, anchor,
+                                delta, borderType & ~BORDER_ISOLATED);
+    applyFilterParallel(factory, src, dst, (borderType & BORDER_ISOLATED) != 0);
 }
 
 
@@ -3234,6 +3336,7 @@ void cv::sepFilter2D( InputArray _src, OutputArray _dst, int ddepth,
                       InputArray _kernelX, InputArray _kernelY, Point anchor,
                       double delta, int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), kernelX = _kernelX.getMat(), kernelY = _kernelY.getMat();
 
     if( ddepth < 0 )
@@ -3242,9 +3345,9 @@ void cv::sepFilter2D( InputArray _src, OutputArray _dst, int ddepth,
     _dst.create( src.size(), CV_MAKETYPE(ddepth, src.channels()) );
     Mat dst = _dst.getMat();
 
-    Ptr<FilterEngine> f = createSeparableLinearFilter(src.type(),
-        dst.type(), kernelX, kernelY, anchor, delta, borderType & ~BORDER_ISOLATED );
-    f->apply(src, dst, Rect(0,0,-1,-1), Point(), (borderType & BORDER_ISOLATED) != 0 );
+    SeparableLinearFilterFactory factory(src.type(), dst.type(), kernelX, kernelY,
+                                         anchor, delta, borderType & ~BORDER_ISOLATED);
+    applyFilterParallel(factory, src, dst, (borderType & BORDER_ISOLATED) != 0);
 }
 
 
@@ -1171,6 +1171,7 @@ void cv::calcHist( const Mat* images, int nimages, const int* channels,
                    InputArray _mask, OutputArray _hist, int dims, const int* histSize,
                    const float** ranges, bool uniform, bool accumulate )
 {
+    CV_TRACE_FUNCTION();
     Mat mask = _mask.getMat();
 
     CV_Assert(dims > 0 && histSize);
@@ -3133,6 +3134,7 @@ CV_IMPL void cvEqualizeHist( const CvArr* srcarr, CvArr* dstarr )
 
 void cv::equalizeHist( InputArray _src, OutputArray _dst )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat();
     CV_Assert( src.type() == CV_8UC1 );
 
@@ -1162,7 +1162,7 @@ public:
         VResize vresize;
 
         int bufstep = (int)alignSize(dsize.width, 16);
-        AutoBuffer<WT> _buffer(bufstep*ksize);
+        ScratchBuffer<WT> _buffer(bufstep*ksize);
         const T* srows[MAX_ESIZE]={0};
         WT* rows[MAX_ESIZE]={0};
         int prev_sy[MAX_ESIZE];
@@ -1618,7 +1618,7 @@ public:
         Size dsize = dst->size();
         int cn = dst->channels();
         dsize.width *= cn;
-        AutoBuffer<WT> _buffer(dsize.width*2);
+        ScratchBuffer<WT> _buffer(dsize.width*2);
         const DecimateAlpha* xtab = xtab0;
         int xtab_size = xtab_size0;
         WT *buf = _buffer, *sum = buf + dsize.width;
@@ -1806,6 +1806,7 @@ static int computeResizeAreaTab( int ssize, int dsize, int cn, double scale, Dec
 void cv::resize( InputArray _src, OutputArray _dst, Size dsize,
                  double inv_scale_x, double inv_scale_y, int interpolation )
 {
+    CV_TRACE_FUNCTION();
     static ResizeFunc linear_tab[] =
     {
         resizeGeneric_<
@@ -2910,9 +2911,13 @@ public:
         bool useSIMD = checkHardwareSupport(CV_CPU_SSE2);
     #endif
 
-        Mat _bufxy(brows0, bcols0, CV_16SC2), _bufa;
+        // the tile buffers come from the thread scratch arena, so the steady-state
+        // remap() calls do not touch the heap
+        ScratchBuffer<short> _xybuf(brows0*bcols0*2);
+        ScratchBuffer<ushort> _abuf(nnfunc ? 0 : brows0*bcols0);
+        Mat _bufxy(brows0, bcols0, CV_16SC2, (short*)_xybuf), _bufa;
         if( !nnfunc )
-            _bufa.create(brows0, bcols0, CV_16UC1);
+            _bufa = Mat(brows0, bcols0, CV_16UC1, (ushort*)_abuf);
 
         for( y = range.start; y < range.end; y += brows0 )
         {
@@ -3091,6 +3096,7 @@ void cv::remap( InputArray _src, OutputArray _dst,
                 InputArray _map1, InputArray _map2,
                 int interpolation, int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     static RemapNNFunc nn_tab[] =
     {
         remapNearest<uchar>, remapNearest<schar>, remapNearest<ushort>, remapNearest<short>,
@@ -3455,6 +3461,7 @@ void cv::warpAffine( InputArray _src, OutputArray _dst,
                      InputArray _M0, Size dsize,
                      int flags, int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), M0 = _M0.getMat();
     _dst.create( dsize.area() == 0 ? src.size() : dsize, src.type() );
     Mat dst = _dst.getMat();
@@ -3606,6 +3613,7 @@ private:
 void cv::warpPerspective( InputArray _src, OutputArray _dst, InputArray _M0,
                           Size dsize, int flags, int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), M0 = _M0.getMat();
     _dst.create( dsize.area() == 0 ? src.size() : dsize, src.type() );
     Mat dst = _dst.getMat();
@@ -1081,58 +1081,24 @@ cv::Mat cv::getStructuringElement(int shape, Size ksize, Point anchor)
 namespace cv
 {
 
-class MorphologyRunner
+class MorphologyFilterFactory : public FilterEngineFactory
 {
 public:
-    MorphologyRunner(Mat _src, Mat _dst, int _nStripes, int _iterations,
-                     int _op, Mat _kernel, Point _anchor,
-                     int _rowBorderType, int _columnBorderType, const Scalar& _borderValue) :
-        borderValue(_borderValue)
-    {
-        src = _src;
-        dst = _dst;
-
-        nStripes = _nStripes;
-        iterations = _iterations;
+    MorphologyFilterFactory( int _op, int _type, const Mat& _kernel, Point _anchor,
+                             int _borderType, const Scalar& _borderValue ) :
+        op(_op), type(_type), kernel(_kernel), anchor(_anchor),
+        borderType(_borderType), borderValue(_borderValue) {}
 
-        op = _op;
-        kernel = _kernel;
-        anchor = _anchor;
-        rowBorderType = _rowBorderType;
-        columnBorderType = _columnBorderType;
-    }
-
-    void operator () ( const BlockedRange& range ) const
+    Ptr<FilterEngine> create() const
     {
-        int row0 = std::min(cvRound(range.begin() * src.rows / nStripes), src.rows);
-        int row1 = std::min(cvRound(range.end() * src.rows / nStripes), src.rows);
-
-        /*if(0)
-            printf("Size = (%d, %d), range[%d,%d), row0 = %d, row1 = %d\n",
-                   src.rows, src.cols, range.begin(), range.end(), row0, row1);*/
-
-        Mat srcStripe = src.rowRange(row0, row1);
-        Mat dstStripe = dst.rowRange(row0, row1);
-
-        Ptr<FilterEngine> f = createMorphologyFilter(op, src.type(), kernel, anchor,
-                                                     rowBorderType, columnBorderType, borderValue );
-
-        f->apply( srcStripe, dstStripe );
-        for( int i = 1; i < iterations; i++ )
-            f->apply( dstStripe, dstStripe );
+        return createMorphologyFilter(op, type, kernel, anchor, borderType, borderType, borderValue);
     }
 
 private:
-    Mat src;
-    Mat dst;
-    int nStripes;
-    int iterations;
-
-    int op;
+    int op, type;
     Mat kernel;
     Point anchor;
-    int rowBorderType;
-    int columnBorderType;
+    int borderType;
     Scalar borderValue;
 };
 
@@ -1172,23 +1138,12 @@ static void morphOp( int op, InputArray _src, OutputArray _dst,
         iterations = 1;
     }
 
-    int nStripes = 1;
-#if defined HAVE_TBB && defined HAVE_TEGRA_OPTIMIZATION
-    if (src.data != dst.data && iterations == 1 &&  //NOTE: threads are not used for inplace processing
-        (borderType & BORDER_ISOLATED) == 0 && //TODO: check border types
-        src.rows >= 64 ) //NOTE: just heuristics
-        nStripes = 4;
-#endif
-
-    parallel_for(BlockedRange(0, nStripes),
-                 MorphologyRunner(src, dst, nStripes, iterations, op, kernel, anchor, borderType, borderType, borderValue));
-
-    //Ptr<FilterEngine> f = createMorphologyFilter(op, src.type(),
-    //                                             kernel, anchor, borderType, borderType, borderValue );
-
-    //f->apply( src, dst );
-    //for( int i = 1; i < iterations; i++ )
-    //    f->apply( dst, dst );
+    // the first pass is done in parallel by bands (unless the operation is in-place);
+    // the next passes are in-place, the same as before
+    MorphologyFilterFactory factory(op, src.type(), kernel, anchor, borderType, borderValue);
+    applyFilterParallel(factory, src, dst, false);
+    for( int i = 1; i < iterations; i++ )
+        applyFilterParallel(factory, dst, dst, false);
 }
 
 }
@@ -1197,6 +1152,7 @@ void cv::erode( InputArray src, OutputArray dst, InputArray kernel,
                 Point anchor, int iterations,
                 int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     morphOp( MORPH_ERODE, src, dst, kernel, anchor, iterations, borderType, borderValue );
 }
 
@@ -1205,6 +1161,7 @@ void cv::dilate( InputArray src, OutputArray dst, InputArray kernel,
                  Point anchor, int iterations,
                  int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     morphOp( MORPH_DILATE, src, dst, kernel, anchor, iterations, borderType, borderValue );
 }
 
@@ -1213,6 +1170,7 @@ void cv::morphologyEx( InputArray _src, OutputArray _dst, int op,
                        InputArray kernel, Point anchor, int iterations,
                        int borderType, const Scalar& borderValue )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat(), temp;
     _dst.create(src.size(), src.type());
     Mat dst = _dst.getMat();
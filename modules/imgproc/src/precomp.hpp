@@ -91,6 +91,18 @@ static inline Point normalizeAnchor( Point anchor, Size ksize )
 }
 
 void preprocess2DKernel( const Mat& kernel, std::vector<Point>& coords, std::vector<uchar>& coeffs );
+
+//! creates new instances of the same filter; every band processed by applyFilterParallel gets its own
+class FilterEngineFactory
+{
+public:
+    virtual ~FilterEngineFactory() {}
+    virtual Ptr<FilterEngine> create() const = 0;
+};
+
+//! the equivalent of FilterEngine::apply(src, dst, Rect(0,0,-1,-1), Point(), isolated)
+//! that filters horizontal bands of a large image in parallel
+void applyFilterParallel( const FilterEngineFactory& factory, const Mat& src, Mat& dst, bool isolated );
 void crossCorr( const Mat& src, const Mat& templ, Mat& dst,
                 Size corrsize, int ctype,
                 Point anchor=Point(0,0), double delta=0,
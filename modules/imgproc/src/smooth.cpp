@@ -708,10 +708,55 @@ cv::Ptr<cv::FilterEngine> cv::createBoxFilter( int srcType, int dstType, Size ks
 }
 
 
+namespace cv
+{
+
+class BoxFilterFactory : public FilterEngineFactory
+{
+public:
+    BoxFilterFactory( int _srcType, int _dstType, Size _ksize, Point _anchor,
+                      bool _normalize, int _borderType ) :
+        srcType(_srcType), dstType(_dstType), ksize(_ksize), anchor(_anchor),
+        normalize(_normalize), borderType(_borderType) {}
+
+    Ptr<FilterEngine> create() const
+    {
+        return createBoxFilter(srcType, dstType, ksize, anchor, normalize, borderType);
+    }
+
+private:
+    int srcType, dstType;
+    Size ksize;
+    Point anchor;
+    bool normalize;
+    int borderType;
+};
+
+class GaussianFilterFactory : public FilterEngineFactory
+{
+public:
+    GaussianFilterFactory( int _type, Size _ksize, double _sigma1, double _sigma2, int _borderType ) :
+        type(_type), ksize(_ksize), sigma1(_sigma1), sigma2(_sigma2), borderType(_borderType) {}
+
+    Ptr<FilterEngine> create() const
+    {
+        return createGaussianFilter(type, ksize, sigma1, sigma2, borderType);
+    }
+
+private:
+    int type;
+    Size ksize;
+    double sigma1, sigma2;
+    int borderType;
+};
+
+}
+
 void cv::boxFilter( InputArray _src, OutputArray _dst, int ddepth,
                 Size ksize, Point anchor,
                 bool normalize, int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat();
     int sdepth = src.depth(), cn = src.channels();
     if( ddepth < 0 )
@@ -730,9 +775,8 @@ void cv::boxFilter( InputArray _src, OutputArray _dst, int ddepth,
         return;
 #endif
 
-    Ptr<FilterEngine> f = createBoxFilter( src.type(), dst.type(),
-                        ksize, anchor, normalize, borderType );
-    f->apply( src, dst );
+    BoxFilterFactory factory( src.type(), dst.type(), ksize, anchor, normalize, borderType );
+    applyFilterParallel( factory, src, dst, false );
 }
 
 void cv::blur( InputArray src, OutputArray dst,
@@ -833,6 +877,7 @@ void cv::GaussianBlur( InputArray _src, OutputArray _dst, Size ksize,
                    double sigma1, double sigma2,
                    int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat();
     _dst.create( src.size(), src.type() );
     Mat dst = _dst.getMat();
@@ -856,8 +901,8 @@ void cv::GaussianBlur( InputArray _src, OutputArray _dst, Size ksize,
         return;
 #endif
 
-    Ptr<FilterEngine> f = createGaussianFilter( src.type(), ksize, sigma1, sigma2, borderType );
-    f->apply( src, dst );
+    GaussianFilterFactory factory( src.type(), ksize, sigma1, sigma2, borderType );
+    applyFilterParallel( factory, src, dst, false );
 }
 
 
@@ -936,7 +981,7 @@ static inline void histogram_muladd( int a, const HT x[16],
 }
 
 static void
-medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize )
+medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize, const Range& rows )
 {
 /**
  * HOP is short for Histogram OPeration. This macro makes an operation \a op on
@@ -957,10 +1002,11 @@ medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize )
 
     int STRIPE_SIZE = std::min( _dst.cols, 512/cn );
 
-    std::vector<HT> _h_coarse(1 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
-    std::vector<HT> _h_fine(16 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
-    HT* h_coarse = alignPtr(&_h_coarse[0], 16);
-    HT* h_fine = alignPtr(&_h_fine[0], 16);
+    // the histograms are cleared for every stripe below, no need to initialize them here
+    ScratchBuffer<HT> _h_coarse(1 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
+    ScratchBuffer<HT> _h_fine(16 * 16 * (STRIPE_SIZE + 2*r) * cn + 16);
+    HT* h_coarse = alignPtr((HT*)_h_coarse, 16);
+    HT* h_fine = alignPtr((HT*)_h_fine, 16);
 #if MEDIAN_HAVE_SIMD
     volatile bool useSIMD = checkHardwareSupport(CV_CPU_SSE2);
 #endif
@@ -974,21 +1020,19 @@ medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize )
         memset( h_coarse, 0, 16*n*cn*sizeof(h_coarse[0]) );
         memset( h_fine, 0, 16*16*n*cn*sizeof(h_fine[0]) );
 
-        // First row initialization
+        // First row initialization: the column histograms get the rows
+        // rows.start-r-1 ... rows.start+r-1 (with replicated borders)
         for( c = 0; c < cn; c++ )
         {
-            for( j = 0; j < n; j++ )
-                COP( c, j, src[cn*j+c], += (cv::HT)(r+2) );
-
-            for( i = 1; i < r; i++ )
+            for( i = rows.start - r - 1; i < rows.start + r; i++ )
             {
-                const uchar* p = src + sstep*std::min(i, m-1);
+                const uchar* p = src + sstep*std::min(std::max(i, 0), m-1);
                 for ( j = 0; j < n; j++ )
                     COP( c, j, p[cn*j+c], ++ );
             }
         }
 
-        for( i = 0; i < m; i++ )
+        for( i = rows.start; i < rows.end; i++ )
         {
             const uchar* p0 = src + sstep * std::max( 0, i-r-1 );
             const uchar* p1 = src + sstep * std::min( m-1, i+r );
@@ -1142,6 +1186,236 @@ medianBlur_8u_O1( const Mat& _src, Mat& _dst, int ksize )
 #undef COP
 }
 
+// In the 16-bit histograms both the coarse and the fine levels have 256 bins
+// (the 8 MSBs and the 8 LSBs of the value)
+static inline void histogram_add_256( const HT* x, HT* y, bool useSIMD )
+{
+#if MEDIAN_HAVE_SIMD
+    if( useSIMD )
+    {
+        for( int i = 0; i < 256; i += 16 )
+            histogram_add_simd( x + i, y + i );
+        return;
+    }
+#endif
+    (void)useSIMD;
+    for( int i = 0; i < 256; i += 16 )
+        histogram_add( x + i, y + i );
+}
+
+static inline void histogram_sub_256( const HT* x, HT* y, bool useSIMD )
+{
+#if MEDIAN_HAVE_SIMD
+    if( useSIMD )
+    {
+        for( int i = 0; i < 256; i += 16 )
+            histogram_sub_simd( x + i, y + i );
+        return;
+    }
+#endif
+    (void)useSIMD;
+    for( int i = 0; i < 256; i += 16 )
+        histogram_sub( x + i, y + i );
+}
+
+// Finds the first bin k at which the running count exceeds t; on return sum is the count
+// below bin k. The SIMD branch skips blocks of 16 bins whose total does not reach t
+static inline int histogram_find_256( const HT* h, int& sum, int t, bool useSIMD )
+{
+    int k = 0;
+#if MEDIAN_HAVE_SIMD
+    if( useSIMD )
+    {
+        __m128i z = _mm_setzero_si128();
+        for( ; k < 256; k += 16 )
+        {
+            __m128i v0 = _mm_load_si128((const __m128i*)(h + k));
+            __m128i v1 = _mm_load_si128((const __m128i*)(h + k + 8));
+            __m128i s4 = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi16(v0, z), _mm_unpackhi_epi16(v0, z)),
+                                       _mm_add_epi32(_mm_unpacklo_epi16(v1, z), _mm_unpackhi_epi16(v1, z)));
+            s4 = _mm_add_epi32(s4, _mm_srli_si128(s4, 8));
+            s4 = _mm_add_epi32(s4, _mm_srli_si128(s4, 4));
+            int s = _mm_cvtsi128_si32(s4);
+            if( sum + s > t )
+                break;
+            sum += s;
+        }
+    }
+#endif
+    (void)useSIMD;
+    for( ; k < 256; k++ )
+    {
+        sum += h[k];
+        if( sum > t )
+        {
+            sum -= h[k];
+            break;
+        }
+    }
+    return k;
+}
+
+/**
+ * The constant-time median filter (the same algorithm as medianBlur_8u_O1) for 16-bit images.
+ * The fine column histograms take 128K per column, so the stripes are narrower and the
+ * channels are processed one by one. Instead of clearing the column histograms for every
+ * stripe, the rows that are left in them after the last output row are subtracted back.
+ */
+static void
+medianBlur_16u_O1( const Mat& _src, Mat& _dst, int ksize, const Range& rows )
+{
+    int cn = _dst.channels(), m = _dst.rows, r = (ksize-1)/2;
+    int t = 2*r*r + 2*r;
+    size_t sstep = _src.step/sizeof(ushort), dstep = _dst.step/sizeof(ushort);
+    int STRIPE_SIZE = std::min( _dst.cols, std::max(32, 128 - 2*r) );
+    int nmax = STRIPE_SIZE + 2*r;
+
+    CV_Assert( ksize <= 255 );
+
+    // ~17 MB for the large kernels, too much to be kept in the per-thread scratch arena
+    AutoBuffer<HT> _hist((size_t)nmax*(256 + 65536) + 256 + 65536 + 16);
+    HT* h_coarse = alignPtr((HT*)_hist, 16);
+    HT* h_fine = h_coarse + (size_t)nmax*256;
+    HT* H_coarse = h_fine + (size_t)nmax*65536;
+    HT* H_fine = H_coarse + 256;
+    int luc[256];
+    bool useSIMD = MEDIAN_HAVE_SIMD && checkHardwareSupport(CV_CPU_SSE2);
+
+    memset( h_coarse, 0, (size_t)nmax*(256 + 65536)*sizeof(HT) );
+
+    for( int x = 0; x < _dst.cols; x += STRIPE_SIZE )
+    {
+        int n = std::min(_dst.cols - x, STRIPE_SIZE) + r*2;
+
+        for( int c = 0; c < cn; c++ )
+        {
+            const ushort* src = (const ushort*)_src.data + x*cn + c;
+            ushort* dst = (ushort*)_dst.data + (x - r)*cn + c;
+            int i, j, k;
+
+            for( i = rows.start - r - 1; i < rows.start + r; i++ )
+            {
+                const ushort* p = src + sstep*std::min(std::max(i, 0), m-1);
+                for( j = 0; j < n; j++ )
+                {
+                    int v = p[j*cn];
+                    h_coarse[j*256 + (v >> 8)]++;
+                    h_fine[(size_t)j*65536 + v]++;
+                }
+            }
+
+            for( i = rows.start; i < rows.end; i++ )
+            {
+                const ushort* p0 = src + sstep * std::max( 0, i-r-1 );
+                const ushort* p1 = src + sstep * std::min( m-1, i+r );
+
+                for( j = 0; j < n; j++ )
+                {
+                    int v0 = p0[j*cn], v1 = p1[j*cn];
+                    h_coarse[j*256 + (v0 >> 8)]--;
+                    h_fine[(size_t)j*65536 + v0]--;
+                    h_coarse[j*256 + (v1 >> 8)]++;
+                    h_fine[(size_t)j*65536 + v1]++;
+                }
+
+                // the fine segments are cleared when they are used for the first time
+                memset( H_coarse, 0, 256*sizeof(HT) );
+                for( k = 0; k < 256; k++ )
+                    luc[k] = 0;
+
+                for( j = 0; j < 2*r; j++ )
+                    histogram_add_256( &h_coarse[j*256], H_coarse, useSIMD );
+
+                for( j = r; j < n-r; j++ )
+                {
+                    int b, sum = 0;
+                    histogram_add_256( &h_coarse[(j+r)*256], H_coarse, useSIMD );
+
+                    // Find median at coarse level
+                    k = histogram_find_256( H_coarse, sum, t, useSIMD );
+                    assert( k < 256 );
+
+                    // Update corresponding histogram segment
+                    HT* segment = H_fine + k*256;
+                    if( luc[k] <= j-r )
+                    {
+                        memset( segment, 0, 256*sizeof(HT) );
+                        for( luc[k] = j-r; luc[k] < j+r+1; luc[k]++ )
+                            histogram_add_256( &h_fine[(size_t)luc[k]*65536 + k*256], segment, useSIMD );
+                    }
+                    else
+                    {
+                        for( ; luc[k] < j+r+1; luc[k]++ )
+                        {
+                            histogram_sub_256( &h_fine[(size_t)(luc[k]-2*r-1)*65536 + k*256], segment, useSIMD );
+                            histogram_add_256( &h_fine[(size_t)luc[k]*65536 + k*256], segment, useSIMD );
+                        }
+                    }
+
+                    histogram_sub_256( &h_coarse[(j-r)*256], H_coarse, useSIMD );
+
+                    // Find median in segment
+                    b = histogram_find_256( segment, sum, t, useSIMD );
+                    assert( b < 256 );
+                    dst[dstep*i + cn*j] = (ushort)(k*256 + b);
+                }
+            }
+
+            // leave the column histograms empty for the next stripe/channel
+            for( i = rows.end - r - 1; i < rows.end + r; i++ )
+            {
+                const ushort* p = src + sstep*std::min(std::max(i, 0), m-1);
+                for( j = 0; j < n; j++ )
+                {
+                    int v = p[j*cn];
+                    h_coarse[j*256 + (v >> 8)]--;
+                    h_fine[(size_t)j*65536 + v]--;
+                }
+            }
+        }
+    }
+}
+
+typedef void (*MedianBlurO1Func)( const Mat& src, Mat& dst, int ksize, const Range& rows );
+
+// Runs the constant-time median filter in horizontal bands; every band builds
+// its own column histograms from the rows around it
+class MedianBlurO1Invoker : public ParallelLoopBody
+{
+public:
+    MedianBlurO1Invoker( const Mat& _src, Mat& _dst, int _ksize, MedianBlurO1Func _func ) :
+        ParallelLoopBody(), src(_src), dst(_dst), ksize(_ksize), func(_func)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        func( src, dst, ksize, range );
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    int ksize;
+    MedianBlurO1Func func;
+
+    const MedianBlurO1Invoker& operator= (const MedianBlurO1Invoker&);
+};
+
+static void medianBlur_O1( const Mat& src, Mat& dst, int ksize )
+{
+    // initializing the column histograms costs about ksize rows, so the bands should be
+    // a few times taller than that
+    int minBandRows = std::max(ksize*4, 32);
+    int nbands = std::min(getNumThreads(), dst.rows/minBandRows);
+    MedianBlurO1Func func = src.depth() == CV_8U ? medianBlur_8u_O1 : medianBlur_16u_O1;
+
+    if( nbands < 2 )
+        func( src, dst, ksize, Range(0, dst.rows) );
+    else
+        parallel_for_( Range(0, dst.rows), MedianBlurO1Invoker(src, dst, ksize, func), nbands );
+}
+
 static void
 medianBlur_8u_Om( const Mat& _src, Mat& _dst, int m )
 {
@@ -1636,6 +1910,7 @@ medianBlur_SortNet( const Mat& _src, Mat& _dst, int m )
 
 void cv::medianBlur( InputArray _src0, OutputArray _dst, int ksize )
 {
+    CV_TRACE_FUNCTION();
     Mat src0 = _src0.getMat();
     _dst.create( src0.size(), src0.type() );
     Mat dst = _dst.getMat();
@@ -1685,13 +1960,20 @@ void cv::medianBlur( InputArray _src0, OutputArray _dst, int ksize )
         cv::copyMakeBorder( src0, src, 0, 0, ksize/2, ksize/2, BORDER_REPLICATE );
 
         int cn = src0.channels();
+        if( src.depth() == CV_16U )
+        {
+            CV_Assert( cn <= 4 );
+            medianBlur_O1( src, dst, ksize );
+            return;
+        }
+
         CV_Assert( src.depth() == CV_8U && (cn == 1 || cn == 3 || cn == 4) );
 
         double img_size_mp = (double)(src0.total())/(1 << 20);
         if( ksize <= 3 + (img_size_mp < 1 ? 12 : img_size_mp < 4 ? 6 : 2)*(MEDIAN_HAVE_SIMD && checkHardwareSupport(CV_CPU_SSE2) ? 1 : 3))
             medianBlur_8u_Om( src, dst, ksize );
         else
-            medianBlur_8u_O1( src, dst, ksize );
+            medianBlur_O1( src, dst, ksize );
     }
 }
 
@@ -2200,12 +2482,724 @@ bilateralFilter_32f( const Mat& src, Mat& dst, int d,
     parallel_for_(Range(0, size.height), body, dst.total()/(double)(1<<16));
 }
 
+
+/****************************************************************************************\
+                                  Bilateral Grid Filtering
+\****************************************************************************************/
+
+// The grid has sigmaSpace x sigmaSpace x sigmaColor cells and is blurred by a 5-tap Gaussian,
+// so the cells next to the data are padded by 2 empty ones
+static const int BILATERAL_GRID_PAD = 2;
+// the grid is processed in bands of grid rows of about this size, in floats (128 MB)
+static const size_t BILATERAL_GRID_BAND_SIZE = (size_t)1 << 25;
+
+// The 5-tap Gaussian with the variance of 0.75 cell^2: nearest-cell splatting and trilinear
+// slicing add about 1/12 and 1/6, so the total is close to sigma = 1 cell.
+// s0..s4 are the 5 input rows, the output is dst[0..len)
+static void bilateralGridBlur5( const float* s0, const float* s1, const float* s2,
+                                const float* s3, const float* s4, float* dst, int len )
+{
+    int i = 0;
+    const float k0 = 0.462f, k1 = 0.237f, k2 = 0.032f;
+#if CV_SSE2
+    if( checkHardwareSupport(CV_CPU_SSE2) )
+    {
+        __m128 c0 = _mm_set1_ps(k0), c1 = _mm_set1_ps(k1), c2 = _mm_set1_ps(k2);
+        for( ; i <= len - 4; i += 4 )
+        {
+            __m128 a = _mm_add_ps(_mm_loadu_ps(s0 + i), _mm_loadu_ps(s4 + i));
+            __m128 b = _mm_add_ps(_mm_loadu_ps(s1 + i), _mm_loadu_ps(s3 + i));
+            __m128 c = _mm_loadu_ps(s2 + i);
+            a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, c2), _mm_mul_ps(b, c1)), _mm_mul_ps(c, c0));
+            _mm_storeu_ps(dst + i, a);
+        }
+    }
+#endif
+    for( ; i < len; i++ )
+        dst[i] = (s0[i] + s4[i])*k2 + (s1[i] + s3[i])*k1 + s2[i]*k0;
+}
+
+// Accumulates the pixels of the image rows that fall into the given grid rows. Each cell stores
+// the sum of the pixel values and the pixel count (the homogeneous weight) of its pixels.
+// The grid holds a band of grid rows starting from ybase, filled from the image rows srcRows
+template<typename T> class BilateralGridSplatInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSplatInvoker( const Mat& _src, Mat& _grid, const int* _xidx, const int* _yidx,
+                               Range _srcRows, int _ybase, int _gz, float _gmin, float _inv_sr ) :
+        ParallelLoopBody(), src(_src), grid(_grid), xidx(_xidx), yidx(_yidx),
+        srcRows(_srcRows), ybase(_ybase), gz(_gz), gmin(_gmin), inv_sr(_inv_sr)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        int cn = src.channels(), nc = cn + 1, zmax = gz - BILATERAL_GRID_PAD - 1;
+        for( int gy = range.start; gy < range.end; gy++ )
+            memset( grid.ptr(gy), 0, grid.cols*sizeof(float) );
+
+        for( int i = srcRows.start; i < srcRows.end; i++ )
+        {
+            int gy = yidx[i] - ybase;
+            if( gy < range.start || gy >= range.end )
+                continue;
+
+            const T* S = src.ptr<T>(i);
+            float* G = grid.ptr<float>(gy);
+            for( int j = 0; j < src.cols; j++, S += cn )
+            {
+                float g = (float)S[0];
+                for( int c = 1; c < cn; c++ )
+                    g += (float)S[c];
+                int z = std::min(std::max(cvRound((g - gmin)*inv_sr) + BILATERAL_GRID_PAD,
+                                          BILATERAL_GRID_PAD), zmax);
+                float* cell = G + (xidx[j]*gz + z)*nc;
+                for( int c = 0; c < cn; c++ )
+                    cell[c] += (float)S[c];
+                cell[cn] += 1.f;
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& grid;
+    const int* xidx;
+    const int* yidx;
+    Range srcRows;
+    int ybase, gz;
+    float gmin, inv_sr;
+
+    const BilateralGridSplatInvoker& operator= (const BilateralGridSplatInvoker&);
+};
+
+// Blurs the grid rows in-place along the color (z) axis and then along x
+class BilateralGridBlurRowsInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridBlurRowsInvoker( Mat& _grid, int _nc, int _gz ) :
+        ParallelLoopBody(), grid(_grid), nc(_nc), gz(_gz)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        int len = grid.cols, zstep = nc, xstep = gz*nc;
+        AutoBuffer<float> _buf(len);
+        float* buf = _buf;
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            float* G = grid.ptr<float>(y);
+            memcpy( buf, G, len*sizeof(float) );
+            bilateralGridBlur5( buf, buf + zstep, buf + zstep*2, buf + zstep*3, buf + zstep*4,
+                                G + zstep*2, len - zstep*4 );
+            memcpy( buf, G, len*sizeof(float) );
+            bilateralGridBlur5( buf, buf + xstep, buf + xstep*2, buf + xstep*3, buf + xstep*4,
+                                G + xstep*2, len - xstep*4 );
+        }
+    }
+
+private:
+    Mat& grid;
+    int nc, gz;
+
+    const BilateralGridBlurRowsInvoker& operator= (const BilateralGridBlurRowsInvoker&);
+};
+
+// Blurs the grid in-place along y. The range is split into column chunks; every chunk walks down
+// the grid keeping the original values of the last 3 rows in a ring buffer
+class BilateralGridBlurColsInvoker : public ParallelLoopBody
+{
+public:
+    enum { CHUNK = 1024 };
+
+    BilateralGridBlurColsInvoker( Mat& _grid ) : ParallelLoopBody(), grid(_grid)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        float ring[3][CHUNK];
+        for( int x0 = range.start*CHUNK; x0 < std::min(range.end*CHUNK, grid.cols); x0 += CHUNK )
+        {
+            int len = std::min((int)CHUNK, grid.cols - x0);
+            memcpy( ring[0], grid.ptr<float>(0) + x0, len*sizeof(float) );
+            memcpy( ring[1], grid.ptr<float>(1) + x0, len*sizeof(float) );
+            for( int y = BILATERAL_GRID_PAD; y < grid.rows - BILATERAL_GRID_PAD; y++ )
+            {
+                float* G = grid.ptr<float>(y) + x0;
+                memcpy( ring[y % 3], G, len*sizeof(float) );
+                bilateralGridBlur5( ring[(y-2) % 3], ring[(y-1) % 3], ring[y % 3],
+                                    grid.ptr<float>(y+1) + x0, grid.ptr<float>(y+2) + x0, G, len );
+            }
+        }
+    }
+
+private:
+    Mat& grid;
+
+    const BilateralGridBlurColsInvoker& operator= (const BilateralGridBlurColsInvoker&);
+};
+
+// Interpolates the blurred grid trilinearly at every pixel and divides by the interpolated weight.
+// The grid holds a band of grid rows starting from ybase
+template<typename T> class BilateralGridSliceInvoker : public ParallelLoopBody
+{
+public:
+    BilateralGridSliceInvoker( const Mat& _src, Mat& _dst, const Mat& _grid, const int* _xofs,
+                               const float* _xalpha, const int* _yofs, const float* _yalpha,
+                               int _ybase, int _gz, float _gmin, float _inv_sr ) :
+        ParallelLoopBody(), src(_src), dst(_dst), grid(_grid), xofs(_xofs), xalpha(_xalpha),
+        yofs(_yofs), yalpha(_yalpha), ybase(_ybase), gz(_gz), gmin(_gmin), inv_sr(_inv_sr)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        int cn = src.channels(), nc = cn + 1;
+        float zmax = (float)(gz - BILATERAL_GRID_PAD - 1);
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            float ay = yalpha[i];
+            const float* G0 = grid.ptr<float>(yofs[i] - ybase);
+            const float* G1 = grid.ptr<float>(yofs[i] - ybase + 1);
+            const T* S = src.ptr<T>(i);
+            T* D = dst.ptr<T>(i);
+
+            for( int j = 0; j < src.cols; j++, S += cn, D += cn )
+            {
+                float g = (float)S[0];
+                for( int c = 1; c < cn; c++ )
+                    g += (float)S[c];
+                float fz = std::min(std::max((g - gmin)*inv_sr + BILATERAL_GRID_PAD,
+                                             (float)BILATERAL_GRID_PAD), zmax);
+                int z0 = cvFloor(fz);
+                float az = fz - z0, ax = xalpha[j];
+                int ofs = xofs[j] + z0*nc, xstep = gz*nc;
+                float w[] =
+                {
+                    (1 - ay)*(1 - ax)*(1 - az), (1 - ay)*(1 - ax)*az,
+                    (1 - ay)*ax*(1 - az), (1 - ay)*ax*az,
+                    ay*(1 - ax)*(1 - az), ay*(1 - ax)*az,
+                    ay*ax*(1 - az), ay*ax*az
+                };
+                const float* cells[] =
+                {
+                    G0 + ofs, G0 + ofs + nc, G0 + ofs + xstep, G0 + ofs + xstep + nc,
+                    G1 + ofs, G1 + ofs + nc, G1 + ofs + xstep, G1 + ofs + xstep + nc
+                };
+                float acc[4] = { 0, 0, 0, 0 };
+            #if CV_SSE2
+                if( nc == 4 )
+                {
+                    __m128 a = _mm_setzero_ps();
+                    for( int k = 0; k < 8; k++ )
+                        a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(cells[k]), _mm_set1_ps(w[k])));
+                    _mm_storeu_ps(acc, a);
+                }
+                else
+            #endif
+                {
+                    for( int k = 0; k < 8; k++ )
+                        for( int c = 0; c < nc; c++ )
+                            acc[c] += cells[k][c]*w[k];
+                }
+
+                if( acc[cn] > 0 )
+                {
+                    float scale = 1.f/acc[cn];
+                    for( int c = 0; c < cn; c++ )
+                        D[c] = saturate_cast<T>(acc[c]*scale);
+                }
+                else
+                {
+                    for( int c = 0; c < cn; c++ )
+                        D[c] = S[c];
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    const Mat& grid;
+    const int* xofs;
+    const float* xalpha;
+    const int* yofs;
+    const float* yalpha;
+    int ybase, gz;
+    float gmin, inv_sr;
+
+    const BilateralGridSliceInvoker& operator= (const BilateralGridSliceInvoker&);
+};
+
+template<typename T> static void
+bilateralGridFilter_( const Mat& src, Mat& dst, double sigma_color, double sigma_space )
+{
+    int cn = src.channels(), nc = cn + 1, pad = BILATERAL_GRID_PAD;
+    double minVal = 0, maxVal = 0;
+    minMaxLoc( src.reshape(1), &minVal, &maxVal );
+
+    float gmin = (float)(minVal*cn), inv_ss = (float)(1./sigma_space), inv_sr = (float)(1./sigma_color);
+    int gx = cvFloor((src.cols - 1)*inv_ss) + 2 + pad*2;
+    int gz = cvFloor((maxVal - minVal)*cn*inv_sr) + 2 + pad*2;
+
+    std::vector<int> _xidx(src.cols), _yidx(src.rows), _xofs(src.cols), _yofs(src.rows);
+    std::vector<float> _xalpha(src.cols), _yalpha(src.rows);
+    for( int j = 0; j < src.cols; j++ )
+    {
+        float fx = j*inv_ss;
+        int x0 = cvFloor(fx);
+        _xidx[j] = cvRound(fx) + pad;
+        _xofs[j] = (x0 + pad)*gz*nc;
+        _xalpha[j] = fx - x0;
+    }
+    for( int i = 0; i < src.rows; i++ )
+    {
+        float fy = i*inv_ss;
+        int y0 = cvFloor(fy);
+        _yidx[i] = cvRound(fy) + pad;
+        _yofs[i] = y0 + pad;
+        _yalpha[i] = fy - y0;
+    }
+
+    // The grid is processed in bands of the grid rows, so that its size stays within
+    // BILATERAL_GRID_BAND_SIZE for any sigmas. The image rows that are sliced from the grid rows
+    // [y0, y1) need the blurred rows [y0, y1 + 1), i.e. the splatted rows [y0 - 2, y1 + 3);
+    // the overlapping rows are splatted twice, so the result does not depend on the banding
+    size_t rowSize = (size_t)gx*gz*nc;
+    int bandRows = (int)std::min(std::max(BILATERAL_GRID_BAND_SIZE/rowSize, (size_t)6) - 5,
+                                 (size_t)_yofs[src.rows - 1] - pad + 1);
+    Mat gridBuf(bandRows + 5, (int)rowSize, CV_32F);
+
+    for( int i0 = 0; i0 < src.rows; )
+    {
+        int y0 = _yofs[i0], y1 = y0 + bandRows, i1 = i0;
+        while( i1 < src.rows && _yofs[i1] < y1 )
+            i1++;
+        y1 = _yofs[i1 - 1] + 1;
+
+        Mat grid = gridBuf.rowRange(0, y1 - y0 + 5);
+        int ybase = y0 - 2;
+        Range srcRows((int)(std::lower_bound(_yidx.begin(), _yidx.end(), ybase) - _yidx.begin()),
+                      (int)(std::lower_bound(_yidx.begin(), _yidx.end(), y1 + 3) - _yidx.begin()));
+        double nstripes = grid.total()/(double)(1<<16);
+        int nchunks = (grid.cols + BilateralGridBlurColsInvoker::CHUNK - 1)/BilateralGridBlurColsInvoker::CHUNK;
+
+        parallel_for_( Range(0, grid.rows), BilateralGridSplatInvoker<T>(src, grid, &_xidx[0],
+                       &_yidx[0], srcRows, ybase, gz, gmin, inv_sr), nstripes );
+        parallel_for_( Range(0, grid.rows), BilateralGridBlurRowsInvoker(grid, nc, gz), nstripes );
+        parallel_for_( Range(0, nchunks), BilateralGridBlurColsInvoker(grid), nstripes );
+
+        parallel_for_( Range(i0, i1), BilateralGridSliceInvoker<T>(src, dst, grid, &_xofs[0],
+                       &_xalpha[0], &_yofs[0], &_yalpha[0], ybase, gz, gmin, inv_sr),
+                       (i1 - i0)*(double)src.cols/(1<<16) );
+        i0 = i1;
+    }
+}
+
+// The 3-channel images are filtered on the permutohedral lattice (A. Adams, J. Baek, M. A. Davis,
+// "Fast High-Dimensional Filtering Using the Permutohedral Lattice", 2010) in the 5D space of
+// (x, y)/sigmaSpace and (c0, c1, c2)/sigmaColor, so the colors are compared by the Euclidean
+// distance. Only the lattice points next to the pixels are stored, in a hash table
+class BilateralLattice
+{
+public:
+    enum { D = 5, VD = 4 };
+
+    BilateralLattice() { clear(); }
+
+    void clear()
+    {
+        keys.clear();
+        values.clear();
+        table.assign(64, -1);
+    }
+
+    int size() const { return (int)(keys.size()/D); }
+
+    // returns the index of the point with the given key or -1
+    int find( const int* key ) const
+    {
+        size_t mask = table.size() - 1;
+        for( size_t h = hash(key) & mask;; h = (h + 1) & mask )
+        {
+            int idx = table[h];
+            if( idx < 0 || equal(&keys[idx*D], key) )
+                return idx;
+        }
+    }
+
+    // returns the values of the point with the given key; a missing point is added with zeros
+    float* insert( const int* key )
+    {
+        if( (size() + 1)*2 > (int)table.size() )
+            rehash();
+        size_t mask = table.size() - 1;
+        for( size_t h = hash(key) & mask;; h = (h + 1) & mask )
+        {
+            int idx = table[h];
+            if( idx < 0 )
+            {
+                idx = table[h] = size();
+                keys.insert(keys.end(), key, key + D);
+                values.resize(values.size() + VD, 0.f);
+                return &values[idx*VD];
+            }
+            if( equal(&keys[idx*D], key) )
+                return &values[idx*VD];
+        }
+    }
+
+    // D coordinates per point, the last one is minus their sum
+    std::vector<int> keys;
+    // the sums of the 3 channels and the homogeneous weight per point
+    std::vector<float> values;
+
+private:
+    static size_t hash( const int* key )
+    {
+        size_t h = 0;
+        for( int i = 0; i < D; i++ )
+            h = (h + (unsigned)key[i])*2531011u;
+        return h;
+    }
+
+    static bool equal( const int* a, const int* b )
+    {
+        return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3] && a[4] == b[4];
+    }
+
+    void rehash()
+    {
+        table.assign(table.size()*2, -1);
+        size_t mask = table.size() - 1;
+        for( int i = 0, n = size(); i < n; i++ )
+        {
+            size_t h = hash(&keys[i*D]) & mask;
+            while( table[h] >= 0 )
+                h = (h + 1) & mask;
+            table[h] = i;
+        }
+    }
+
+    // the open-addressing table of the point indices, at most half full
+    std::vector<int> table;
+};
+
+// the points of the lattice that is being blurred, beyond which the image band is finished
+static const int BILATERAL_LATTICE_MAX_POINTS = 1 << 20;
+// the image rows splatted at once; every row gets its own lattice, they are merged in order
+static const int BILATERAL_LATTICE_ROW_GROUP = 32;
+
+// the position scales that make the lattice blur a Gaussian with the given sigmas
+static void bilateralLatticeScale( double sigma_color, double sigma_space, float* scale )
+{
+    const int D = BilateralLattice::D;
+    for( int i = 0; i < D; i++ )
+        scale[i] = (float)((D + 1)*std::sqrt(2./3)/std::sqrt((i + 1.)*(i + 2))/
+                           (i < 2 ? sigma_space : sigma_color));
+}
+
+// Finds the lattice simplex that encloses the position pos = (x, y, c0, c1, c2) and returns
+// the keys of its D+1 vertices and the barycentric weights of the position
+static void bilateralLatticeEmbed( const float* pos, const float* scale, int* keys, float* weights )
+{
+    const int D = BilateralLattice::D;
+    float elevated[D+1], bary[D+2], sm = 0;
+    int greedy[D+1], rank[D+1], sum = 0;
+
+    // the position in the hyperplane x0 + ... + xD = 0
+    for( int i = D; i > 0; i-- )
+    {
+        float cf = pos[i-1]*scale[i-1];
+        elevated[i] = sm - i*cf;
+        sm += cf;
+    }
+    elevated[0] = sm;
+
+    // the closest remainder-0 point and the ranking of the differences from it
+    for( int i = 0; i <= D; i++ )
+    {
+        float v = elevated[i]*(1.f/(D+1));
+        int up = cvCeil(v)*(D+1), down = cvFloor(v)*(D+1);
+        greedy[i] = up - elevated[i] < elevated[i] - down ? up : down;
+        sum += greedy[i];
+        rank[i] = 0;
+    }
+    sum /= D+1;
+
+    for( int i = 0; i < D; i++ )
+        for( int j = i + 1; j <= D; j++ )
+        {
+            if( elevated[i] - greedy[i] < elevated[j] - greedy[j] )
+                rank[i]++;
+            else
+                rank[j]++;
+        }
+
+    // moves the point onto the hyperplane when its coordinates do not sum to zero
+    for( int i = 0; i <= D; i++ )
+    {
+        if( sum > 0 && rank[i] >= D + 1 - sum )
+        {
+            greedy[i] -= D + 1;
+            rank[i] += sum - (D + 1);
+        }
+        else if( sum < 0 && rank[i] < -sum )
+        {
+            greedy[i] += D + 1;
+            rank[i] += sum + (D + 1);
+        }
+        else
+            rank[i] += sum;
+    }
+
+    for( int i = 0; i <= D + 1; i++ )
+        bary[i] = 0;
+    for( int i = 0; i <= D; i++ )
+    {
+        float v = (elevated[i] - greedy[i])*(1.f/(D+1));
+        bary[D - rank[i]] += v;
+        bary[D + 1 - rank[i]] -= v;
+    }
+    bary[0] += 1.f + bary[D+1];
+
+    // the vertex of remainder k is the remainder-0 point plus the k-th canonical simplex vertex
+    for( int k = 0; k <= D; k++ )
+    {
+        for( int i = 0; i < D; i++ )
+            keys[k*D + i] = greedy[i] + (rank[i] <= D - k ? k : k - (D + 1));
+        weights[k] = bary[k];
+    }
+}
+
+// Splats the image rows row0, row0 + 1, ... into the lattices of their own
+template<typename T> class BilateralLatticeSplatInvoker : public ParallelLoopBody
+{
+public:
+    BilateralLatticeSplatInvoker( const Mat& _src, BilateralLattice* _lattices, int _row0,
+                                  const float* _scale ) :
+        ParallelLoopBody(), src(_src), lattices(_lattices), row0(_row0), scale(_scale)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        const int D = BilateralLattice::D;
+        int keys[(D+1)*D];
+        float weights[D+1];
+
+        for( int k = range.start; k < range.end; k++ )
+        {
+            BilateralLattice& lattice = lattices[k];
+            int i = row0 + k;
+            const T* S = src.ptr<T>(i);
+            lattice.clear();
+
+            for( int j = 0; j < src.cols; j++, S += 3 )
+            {
+                float pos[] = { (float)j, (float)i, (float)S[0], (float)S[1], (float)S[2] };
+                bilateralLatticeEmbed( pos, scale, keys, weights );
+                for( int v = 0; v <= D; v++ )
+                {
+                    float* val = lattice.insert(keys + v*D);
+                    float w = weights[v];
+                    val[0] += pos[2]*w;
+                    val[1] += pos[3]*w;
+                    val[2] += pos[4]*w;
+                    val[3] += w;
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    BilateralLattice* lattices;
+    int row0;
+    const float* scale;
+
+    const BilateralLatticeSplatInvoker& operator= (const BilateralLatticeSplatInvoker&);
+};
+
+// Blurs the lattice points by [1 2 1]/4 along one of the D+1 lattice directions
+class BilateralLatticeBlurInvoker : public ParallelLoopBody
+{
+public:
+    BilateralLatticeBlurInvoker( const BilateralLattice& _lattice, const float* _src, float* _dst,
+                                 int _dir ) :
+        ParallelLoopBody(), lattice(_lattice), src(_src), dst(_dst), dir(_dir)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        const int D = BilateralLattice::D, VD = BilateralLattice::VD;
+        const float zeros[VD] = { 0, 0, 0, 0 };
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const int* key = &lattice.keys[i*D];
+            int n1[D], n2[D];
+            for( int k = 0; k < D; k++ )
+            {
+                n1[k] = key[k] + 1;
+                n2[k] = key[k] - 1;
+            }
+            if( dir < D )
+            {
+                n1[dir] = key[dir] - D;
+                n2[dir] = key[dir] + D;
+            }
+            int p1 = lattice.find(n1), p2 = lattice.find(n2);
+            const float* v0 = src + i*VD;
+            const float* v1 = p1 >= 0 ? src + p1*VD : zeros;
+            const float* v2 = p2 >= 0 ? src + p2*VD : zeros;
+            float* d = dst + i*VD;
+            for( int c = 0; c < VD; c++ )
+                d[c] = v0[c]*0.5f + (v1[c] + v2[c])*0.25f;
+        }
+    }
+
+private:
+    const BilateralLattice& lattice;
+    const float* src;
+    float* dst;
+    int dir;
+
+    const BilateralLatticeBlurInvoker& operator= (const BilateralLatticeBlurInvoker&);
+};
+
+// Interpolates the blurred lattice at every pixel and divides by the interpolated weight
+template<typename T> class BilateralLatticeSliceInvoker : public ParallelLoopBody
+{
+public:
+    BilateralLatticeSliceInvoker( const Mat& _src, Mat& _dst, const BilateralLattice& _lattice,
+                                  const float* _scale ) :
+        ParallelLoopBody(), src(_src), dst(_dst), lattice(_lattice), scale(_scale)
+    {
+    }
+
+    virtual void operator()( const Range& range ) const
+    {
+        const int D = BilateralLattice::D, VD = BilateralLattice::VD;
+        int keys[(D+1)*D];
+        float weights[D+1];
+
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const T* S = src.ptr<T>(i);
+            T* Dst = dst.ptr<T>(i);
+            for( int j = 0; j < src.cols; j++, S += 3, Dst += 3 )
+            {
+                float pos[] = { (float)j, (float)i, (float)S[0], (float)S[1], (float)S[2] };
+                float acc[VD] = { 0, 0, 0, 0 };
+                bilateralLatticeEmbed( pos, scale, keys, weights );
+                for( int v = 0; v <= D; v++ )
+                {
+                    // the pixel has splatted into all the vertices of its simplex
+                    const float* val = &lattice.values[lattice.find(keys + v*D)*VD];
+                    for( int c = 0; c < VD; c++ )
+                        acc[c] += val[c]*weights[v];
+                }
+
+                if( acc[3] > 0 )
+                {
+                    float s = 1.f/acc[3];
+                    for( int c = 0; c < 3; c++ )
+                        Dst[c] = saturate_cast<T>(acc[c]*s);
+                }
+                else
+                {
+                    for( int c = 0; c < 3; c++ )
+                        Dst[c] = S[c];
+                }
+            }
+        }
+    }
+
+private:
+    const Mat& src;
+    Mat& dst;
+    const BilateralLattice& lattice;
+    const float* scale;
+
+    const BilateralLatticeSliceInvoker& operator= (const BilateralLatticeSliceInvoker&);
+};
+
+template<typename T> static void
+bilateralLatticeFilter_( const Mat& src, Mat& dst, double sigma_color, double sigma_space )
+{
+    const int D = BilateralLattice::D, VD = BilateralLattice::VD;
+    float scale[D];
+    bilateralLatticeScale( sigma_color, sigma_space, scale );
+
+    // The image is processed in bands of rows, so that the lattice stays within about
+    // BILATERAL_LATTICE_MAX_POINTS points. A pixel reaches the lattice points within 1.5 sigmas
+    // (the simplex diameter) and the blur moves the values by at most 3 sigmas, so the output rows
+    // of a band depend on the rows within 6*sigmaSpace only; these rows are splatted in both bands
+    // and the result does not depend on the banding
+    int halo = cvCeil(sigma_space*6) + 1;
+    std::vector<BilateralLattice> rowLattices(BILATERAL_LATTICE_ROW_GROUP);
+    BilateralLattice lattice;
+    std::vector<float> buf;
+
+    for( int i0 = 0; i0 < src.rows; )
+    {
+        int i1 = src.rows;
+        lattice.clear();
+        for( int row0 = std::max(i0 - halo, 0); row0 < src.rows; )
+        {
+            int nrows = std::min((int)BILATERAL_LATTICE_ROW_GROUP, src.rows - row0);
+            parallel_for_( Range(0, nrows), BilateralLatticeSplatInvoker<T>(src, &rowLattices[0],
+                           row0, scale) );
+            for( int k = 0; k < nrows; k++ )
+            {
+                const BilateralLattice& rowLattice = rowLattices[k];
+                for( int p = 0, n = rowLattice.size(); p < n; p++ )
+                {
+                    float* val = lattice.insert(&rowLattice.keys[p*D]);
+                    const float* rowVal = &rowLattice.values[p*VD];
+                    for( int c = 0; c < VD; c++ )
+                        val[c] += rowVal[c];
+                }
+            }
+            row0 += nrows;
+            if( lattice.size() > BILATERAL_LATTICE_MAX_POINTS && row0 < src.rows &&
+                row0 - i0 >= halo*2 )
+            {
+                i1 = row0 - halo;
+                break;
+            }
+        }
+
+        int npoints = lattice.size();
+        double nstripes = npoints/(double)(1<<12);
+        buf.resize(lattice.values.size());
+        for( int dir = 0; dir <= D; dir += 2 )
+        {
+            parallel_for_( Range(0, npoints), BilateralLatticeBlurInvoker(lattice,
+                           &lattice.values[0], &buf[0], dir), nstripes );
+            parallel_for_( Range(0, npoints), BilateralLatticeBlurInvoker(lattice,
+                           &buf[0], &lattice.values[0], dir + 1), nstripes );
+        }
+
+        parallel_for_( Range(i0, i1), BilateralLatticeSliceInvoker<T>(src, dst, lattice, scale),
+                       (i1 - i0)*(double)src.cols/(1<<14) );
+        i0 = i1;
+    }
+}
 }
 
 void cv::bilateralFilter( InputArray _src, OutputArray _dst, int d,
                       double sigmaColor, double sigmaSpace,
                       int borderType )
 {
+    CV_TRACE_FUNCTION();
     Mat src = _src.getMat();
     _dst.create( src.size(), src.type() );
     Mat dst = _dst.getMat();
@@ -2219,6 +3213,34 @@ void cv::bilateralFilter( InputArray _src, OutputArray _dst, int d,
         "Bilateral filtering is only implemented for 8u and 32f images" );
 }
 
+void cv::bilateralGridFilter( InputArray _src, OutputArray _dst,
+                              double sigmaColor, double sigmaSpace )
+{
+    CV_TRACE_FUNCTION();
+    Mat src = _src.getMat();
+    int type = src.type();
+    CV_Assert( type == CV_8UC1 || type == CV_8UC3 || type == CV_32FC1 || type == CV_32FC3 );
+    _dst.create( src.size(), type );
+    Mat dst = _dst.getMat();
+
+    if( sigmaColor <= 0 )
+        sigmaColor = 1;
+    if( sigmaSpace <= 0 )
+        sigmaSpace = 1;
+    // the image is filtered band by band, and every band reads the source rows of its neighbours
+    if( src.data == dst.data )
+        src = src.clone();
+
+    if( type == CV_8UC1 )
+        bilateralGridFilter_<uchar>( src, dst, sigmaColor, sigmaSpace );
+    else if( type == CV_32FC1 )
+        bilateralGridFilter_<float>( src, dst, sigmaColor, sigmaSpace );
+    else if( type == CV_8UC3 )
+        bilateralLatticeFilter_<uchar>( src, dst, sigmaColor, sigmaSpace );
+    else
+        bilateralLatticeFilter_<float>( src, dst, sigmaColor, sigmaSpace );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 
 CV_IMPL void
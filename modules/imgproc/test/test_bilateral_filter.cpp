@@ -287,4 +287,95 @@ namespace cvtest
         test.safe_run();
     }
 
+    TEST(Imgproc_BilateralGridFilter, accuracy)
+    {
+        // a noisy image with edges; the grid filter should be close to the direct one
+        Mat base(240, 320, CV_8UC3), noise(base.size(), CV_8UC3), img;
+        for( int i = 0; i < base.rows; i++ )
+            for( int j = 0; j < base.cols; j++ )
+                base.at<Vec3b>(i, j) = Vec3b(j < 160 ? 60 : 190, i < 120 ? 80 : 200,
+                                             saturate_cast<uchar>(128 + 100*std::sin(j*0.04)));
+        randn(noise, 0, 12);
+        add(base, noise, img, noArray(), CV_8U);
+
+        const int types[] = { CV_8UC1, CV_8UC3, CV_32FC1, CV_32FC3 };
+        const double minPSNR[] = { 45, 40, 45, 40 };
+        int nthreads0 = getNumThreads();
+
+        for( int t = 0; t < 4; t++ )
+        {
+            Mat src;
+            if( CV_MAT_CN(types[t]) == 1 )
+                cvtColor(img, src, COLOR_BGR2GRAY);
+            else
+                src = img;
+            double sigmaColor = 25, sigmaSpace = 6, maxVal = 255;
+            if( CV_MAT_DEPTH(types[t]) == CV_32F )
+            {
+                src.convertTo(src, CV_32F, 1./255);
+                sigmaColor /= 255;
+                maxVal = 1;
+            }
+
+            Mat ref, dst, dst1, inplace;
+            bilateralFilter(src, ref, -1, sigmaColor, sigmaSpace);
+            bilateralGridFilter(src, dst, sigmaColor, sigmaSpace);
+            ASSERT_EQ(src.type(), dst.type());
+            double rms = cvtest::norm(ref, dst, NORM_L2)/std::sqrt((double)ref.total()*ref.channels());
+            EXPECT_GT(20*std::log10(maxVal/rms), minPSNR[t]) << "type=" << types[t];
+
+            // the result does not depend on the number of threads and the filter works in-place
+            setNumThreads(1);
+            bilateralGridFilter(src, dst1, sigmaColor, sigmaSpace);
+            setNumThreads(nthreads0);
+            src.copyTo(inplace);
+            bilateralGridFilter(inplace, inplace, sigmaColor, sigmaSpace);
+            EXPECT_EQ(0, cvtest::norm(dst, dst1, NORM_INF)) << "type=" << types[t];
+            EXPECT_EQ(0, cvtest::norm(dst, inplace, NORM_INF)) << "type=" << types[t];
+        }
+    }
+
+    TEST(Imgproc_BilateralGridFilter, smallSigmas)
+    {
+        // the whole grid would take about 300 MB, it is processed band by band with the same sigmas
+        Mat src(180, 320, CV_32F, Scalar::all(0.2)), dst;
+        src(Rect(160, 0, 160, 180)).setTo(Scalar::all(0.8));
+        bilateralGridFilter(src, dst, 1e-3, 1);
+        ASSERT_EQ(src.size(), dst.size());
+        EXPECT_LE(cvtest::norm(src, dst, NORM_INF), 1e-3);
+    }
+
+    TEST(Imgproc_BilateralGridFilter, bands)
+    {
+        // The wide image is processed in several bands, the narrow one in a single band. Both have
+        // the same range, so away from the right border of the narrow image the results are the same
+        const int types[] = { CV_32FC1, CV_8UC3 };
+        const double sigmaColor[] = { 0.01, 2 }, sigmaSpace[] = { 1, 1 };
+        for( int t = 0; t < 2; t++ )
+        {
+            RNG& rng = theRNG();
+            Mat src(400, 640, types[t]), narrow, dst, dst1;
+            rng.fill(src, RNG::UNIFORM, 0, CV_MAT_DEPTH(types[t]) == CV_8U ? 256 : 1);
+            if( types[t] == CV_32FC1 )
+            {
+                // the grid is built over the range of the image, it is the same for both images
+                src.at<float>(0, 0) = 0.f;
+                src.at<float>(0, 1) = 1.f;
+            }
+            src.colRange(0, 64).copyTo(narrow);
+            bilateralGridFilter(src, dst, sigmaColor[t], sigmaSpace[t]);
+            bilateralGridFilter(narrow, dst1, sigmaColor[t], sigmaSpace[t]);
+            EXPECT_EQ(0, cvtest::norm(dst.colRange(0, 48), dst1.colRange(0, 48), NORM_INF)) << "type=" << types[t];
+        }
+    }
+
+    TEST(Imgproc_BilateralGridFilter, colorEdges)
+    {
+        // red next to green: the colors have the same sum of the channels, but they are far apart
+        Mat src(64, 64, CV_8UC3, Scalar(0, 0, 255)), dst;
+        src.colRange(32, 64).setTo(Scalar(0, 255, 0));
+        bilateralGridFilter(src, dst, 25, 8);
+        EXPECT_LE(cvtest::norm(src, dst, NORM_INF), 1);
+    }
+
 } // end of namespace cvtest
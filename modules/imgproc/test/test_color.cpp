@@ -2188,3 +2188,174 @@ TEST(ImgProc_Bayer2RGBA, accuracy)
         }
     }
 }
+
+TEST(Imgproc_Color, simdBitExact)
+{
+    // the vectorized conversions must give exactly the same results as the scalar code;
+    // the widths leave scalar tails that are not multiples of 4, 8 or 16 pixels
+    const int codes[] =
+    {
+        COLOR_BGR2RGB, COLOR_BGR2BGRA, COLOR_BGR2RGBA, COLOR_BGRA2BGR, COLOR_BGRA2RGB, COLOR_BGRA2RGBA,
+        COLOR_BGR2GRAY, COLOR_RGBA2GRAY, COLOR_BGR2YCrCb, COLOR_RGB2YCrCb, COLOR_BGR2YUV,
+        COLOR_YCrCb2BGR, COLOR_YCrCb2RGB, COLOR_YUV2BGR, COLOR_BGR2HSV, COLOR_RGB2HSV_FULL,
+        COLOR_BGR2Lab, COLOR_LRGB2Lab, COLOR_BGR2Luv, COLOR_LRGB2Luv
+    };
+    const int scns[] = { 3, 3, 3, 4, 4, 4, 3, 4, 3, 4, 3, 3, 3, 3, 3, 4, 3, 4, 4, 3 };
+    const int dcns[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 0, 0, 0, 0 };
+    const int depths[] = { CV_8U, CV_32F };
+    const Size sizes[] = { Size(203, 13), Size(45, 3), Size(70, 2), Size(7, 2) };
+    // black, white, the primaries, the hues next to red on both sides (they wrap around),
+    // grays next to the threshold of the linear part of Lab and the float values out of [0, 1]
+    const Scalar edges8u[] =
+    {
+        Scalar(0, 0, 0), Scalar(255, 255, 255), Scalar(255, 0, 0), Scalar(0, 255, 0), Scalar(0, 0, 255),
+        Scalar(1, 0, 255), Scalar(0, 1, 255), Scalar(254, 255, 255), Scalar(255, 255, 0), Scalar(2, 2, 3),
+        Scalar(20, 20, 20), Scalar(21, 21, 21), Scalar(0, 1, 0)
+    };
+    const Scalar edges32f[] =
+    {
+        Scalar(0, 0, 0), Scalar(1, 1, 1), Scalar(1, 0, 0), Scalar(0, 1, 0), Scalar(0, 0, 1),
+        Scalar(1e-6, 0, 1), Scalar(0, 1e-6, 1), Scalar(0.0088, 0.0088, 0.0088), Scalar(0.0089, 0.0089, 0.0089),
+        Scalar(0.08, 0.08, 0.08), Scalar(-0.1, 1.1, 0.5), Scalar(1, 1, 1 - 1e-7), Scalar(2, -1, 0)
+    };
+    RNG& rng = theRNG();
+    bool useOptimized0 = useOptimized();
+
+    for( size_t i = 0; i < sizeof(codes)/sizeof(codes[0]); i++ )
+        for( size_t j = 0; j < sizeof(depths)/sizeof(depths[0]); j++ )
+            for( size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); k++ )
+            {
+                Mat src(sizes[k], CV_MAKETYPE(depths[j], scns[i])), ref, dst;
+                const Scalar* edges = depths[j] == CV_8U ? edges8u : edges32f;
+                if( depths[j] == CV_8U )
+                    rng.fill(src, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+                else
+                    rng.fill(src, RNG::UNIFORM, Scalar::all(-0.1), Scalar::all(1.1));
+                // some gray pixels and channels equal to the maximum for the HSV branches
+                src.row(0).setTo(Scalar::all(depths[j] == CV_8U ? 100 : 0.25));
+                for( int x = 0; x < src.cols; x++ )
+                    src.row(1).col(x).setTo(edges[x % 13]);
+
+                setUseOptimized(false);
+                cvtColor(src, ref, codes[i], dcns[i]);
+                setUseOptimized(true);
+                cvtColor(src, dst, codes[i], dcns[i]);
+
+                ASSERT_EQ(ref.type(), dst.type());
+                EXPECT_EQ(0, countNonZero(ref.reshape(1) != dst.reshape(1)))
+                    << "code=" << codes[i] << ", depth=" << depths[j] << ", size=" << sizes[k];
+            }
+
+    // the inverse float conversions, with the input ranges of the HSV, Lab and Luv images
+    const int invCodes[] = { COLOR_HSV2BGR, COLOR_HSV2RGB_FULL, COLOR_Lab2BGR, COLOR_Lab2LRGB, COLOR_Luv2RGB, COLOR_Luv2LBGR };
+    const Scalar invMin[] = { Scalar(-30, 0, 0), Scalar(-30, 0, 0), Scalar(-5, -130, -130),
+                              Scalar(-5, -130, -130), Scalar(0, -130, -130), Scalar(0, -130, -130) };
+    const Scalar invMax[] = { Scalar(400, 1, 1), Scalar(400, 1, 1), Scalar(105, 130, 130),
+                              Scalar(105, 130, 130), Scalar(100, 180, 120), Scalar(100, 180, 120) };
+    // the hues at the sector borders and around the wrap, the saturation at 0 and 1
+    const Scalar hsvEdges[] =
+    {
+        Scalar(0, 1, 1), Scalar(360, 1, 1), Scalar(359.999, 1, 0.5), Scalar(-0.001, 1, 0.5), Scalar(60, 0, 1),
+        Scalar(120, 1, 0), Scalar(180, 0.5, 1), Scalar(240, 1, 1), Scalar(300, 1, 1), Scalar(720, 1, 1)
+    };
+    for( size_t i = 0; i < sizeof(invCodes)/sizeof(invCodes[0]); i++ )
+        for( int dcn = 3; dcn <= 4; dcn++ )
+            for( size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); k++ )
+            {
+                Mat src(sizes[k], CV_32FC3), ref, dst;
+                rng.fill(src, RNG::UNIFORM, invMin[i], invMax[i]);
+                src.row(0).setTo(Scalar(120, 0, 50));
+                if( i < 2 )
+                    for( int x = 0; x < src.cols; x++ )
+                        src.row(1).col(x).setTo(hsvEdges[x % 10]);
+
+                setUseOptimized(false);
+                cvtColor(src, ref, invCodes[i], dcn);
+                setUseOptimized(true);
+                cvtColor(src, dst, invCodes[i], dcn);
+
+                ASSERT_EQ(ref.type(), dst.type());
+                EXPECT_EQ(0, countNonZero(ref.reshape(1) != dst.reshape(1)))
+                    << "code=" << invCodes[i] << ", dcn=" << dcn << ", size=" << sizes[k];
+            }
+
+    const int yuvCodes[] = { COLOR_YUV2BGR_NV12, COLOR_YUV2RGB_NV21, COLOR_YUV2BGRA_NV21, COLOR_YUV2RGBA_NV12,
+                             COLOR_YUV2BGR_I420, COLOR_YUV2RGB_YV12, COLOR_YUV2BGRA_YV12, COLOR_YUV2RGBA_I420 };
+    for( size_t i = 0; i < sizeof(yuvCodes)/sizeof(yuvCodes[0]); i++ )
+    {
+        Mat src(24*3/2, 138, CV_8U), ref, dst;
+        rng.fill(src, RNG::UNIFORM, Scalar::all(0), Scalar::all(256));
+
+        setUseOptimized(false);
+        cvtColor(src, ref, yuvCodes[i]);
+        setUseOptimized(true);
+        cvtColor(src, dst, yuvCodes[i]);
+
+        EXPECT_EQ(0, countNonZero(ref.reshape(1) != dst.reshape(1))) << "code=" << yuvCodes[i];
+    }
+
+    setUseOptimized(useOptimized0);
+}
+
+TEST(Imgproc_Color, resizeToPlanar)
+{
+    struct Case { int code; int type; Size ssize; Size dsize; };
+    const Case cases[] =
+    {
+        { COLOR_YUV2BGR_NV12, CV_8UC1, Size(640, 480), Size(224, 224) },
+        { COLOR_YUV2RGB_NV21, CV_8UC1, Size(320, 180), Size(300, 170) },
+        { COLOR_YUV2RGB_NV12, CV_8UC1, Size(96, 64), Size(227, 150) },
+        { COLOR_BGR2RGB,      CV_8UC3, Size(333, 257), Size(224, 224) },
+        { COLOR_BGRA2RGB,     CV_8UC4, Size(200, 100), Size(77, 301) },
+        { COLOR_GRAY2BGR,     CV_8UC1, Size(101, 99),  Size(64, 48) },
+        { -1,                 CV_8UC3, Size(640, 480), Size(299, 299) },
+        { -1,                 CV_8UC1, Size(31, 17),   Size(100, 3) }
+    };
+    const double scale = 1./58;
+    const Scalar shift(-2.1, -1.9, -1.7);
+    RNG& rng = theRNG();
+
+    for( size_t i = 0; i < sizeof(cases)/sizeof(cases[0]); i++ )
+    {
+        const Case& c = cases[i];
+        bool yuv = c.code >= COLOR_YUV2RGB_NV12 && c.code <= COLOR_YUV2BGR_NV21;
+        Mat src(yuv ? c.ssize.height*3/2 : c.ssize.height, c.ssize.width, c.type);
+        rng.fill(src, RNG::UNIFORM, 0, 256);
+
+        // the four-call chain the fused routine replaces
+        Mat cvt, resized, fl;
+        if( c.code >= 0 )
+            cvtColor(src, cvt, c.code);
+        else
+            cvt = src;
+        resize(cvt, resized, c.dsize, 0, 0, INTER_LINEAR);
+        resized.convertTo(fl, CV_32F, scale);
+        std::vector<Mat> planes;
+        split(fl, planes);
+
+        Mat dst;
+        resizeToPlanar(src, dst, c.dsize, c.code, scale, shift);
+        int cn = cvt.channels();
+        ASSERT_EQ(4, dst.dims);
+        ASSERT_EQ(CV_32F, dst.type());
+        ASSERT_EQ(1, dst.size[0]);
+        ASSERT_EQ(cn, dst.size[1]);
+        ASSERT_EQ(c.dsize.height, dst.size[2]);
+        ASSERT_EQ(c.dsize.width, dst.size[3]);
+
+        // bilinear interpolation is done in floating point, without rounding to 8 bits
+        for( int k = 0; k < cn; k++ )
+        {
+            Mat plane(c.dsize, CV_32F, dst.ptr(0, k));
+            EXPECT_LE(norm(plane, planes[k] + shift[k], NORM_INF), scale*1.01 + 1e-4) << "case=" << i << " plane=" << k;
+        }
+
+        // the result does not depend on the number of threads
+        int nthreads0 = getNumThreads();
+        setNumThreads(1);
+        Mat dst1;
+        resizeToPlanar(src, dst1, c.dsize, c.code, scale, shift);
+        setNumThreads(nthreads0);
+        EXPECT_EQ(0, norm(dst, dst1, NORM_INF)) << "case=" << i;
+    }
+}
@@ -1887,3 +1887,102 @@ protected:
 
 TEST(Imgproc_Filtering, supportedFormats) { CV_FilterSupportedFormatsTest test; test.safe_run(); }
 
+
+TEST(Imgproc_Filtering, parallelBands)
+{
+    // the band-parallel filtering must give the same result as a single pass,
+    // including the rows near the band boundaries, the ROI and the isolated borders
+    Mat big(1000, 420, CV_8UC3), bigf;
+    randu(big, 0, 256);
+    big.convertTo(bigf, CV_32F, 1./255);
+    Mat kernel = (Mat_<float>(3, 5) << 1, 2, -3, 4, 1, 0, 1, -1, 2, 3, -2, 1, 0, 1, 1);
+    Mat elem = getStructuringElement(MORPH_ELLIPSE, Size(5, 7));
+    int borders[] = { BORDER_REFLECT_101, BORDER_CONSTANT, BORDER_REPLICATE|BORDER_ISOLATED };
+    int nthreads0 = getNumThreads();
+
+    for( int k = 0; k < 2; k++ )
+    {
+        Mat src = (k == 0 ? big : bigf)(Rect(3, 5, 400, 990));
+        for( size_t b = 0; b < sizeof(borders)/sizeof(borders[0]); b++ )
+        {
+            int border = borders[b];
+            Mat ref[7], dst[7];
+            for( int pass = 0; pass < 2; pass++ )
+            {
+                Mat* d = pass == 0 ? ref : dst;
+                setNumThreads(pass == 0 ? 1 : 4);
+                filter2D(src, d[0], -1, kernel, Point(-1,-1), 1, border);
+                sepFilter2D(src, d[1], CV_32F, kernel.row(0), kernel.row(1).t(), Point(-1,-1), 0, border);
+                GaussianBlur(src, d[2], Size(5, 5), 1.5, 1.5, border);
+                boxFilter(src, d[3], -1, Size(7, 9), Point(-1,-1), true, border & ~BORDER_ISOLATED);
+                Sobel(src, d[4], CV_32F, 1, 1, 3, 1, 0, border);
+                erode(src, d[5], elem, Point(-1,-1), 2, border & ~BORDER_ISOLATED);
+                morphologyEx(src, d[6], MORPH_GRADIENT, elem, Point(-1,-1), 1, border & ~BORDER_ISOLATED);
+            }
+            setNumThreads(nthreads0);
+
+            for( int i = 0; i < 7; i++ )
+            {
+                // the running column sums of the floating-point box filter depend on the first row
+                double eps = k == 1 && i == 3 ? 1e-5 : 0;
+                EXPECT_LE(cvtest::norm(ref[i], dst[i], NORM_INF), eps) << "filter=" << i << ", depth=" << src.depth() << ", border=" << border;
+            }
+        }
+    }
+}
+
+template<typename T> static void refMedianBlur(const Mat& src, Mat& dst, int ksize)
+{
+    int r = ksize/2, cn = src.channels();
+    Mat ext;
+    copyMakeBorder(src, ext, r, r, r, r, BORDER_REPLICATE);
+    dst.create(src.size(), src.type());
+    std::vector<T> buf(ksize*ksize);
+
+    for( int i = 0; i < src.rows; i++ )
+        for( int j = 0; j < src.cols; j++ )
+            for( int c = 0; c < cn; c++ )
+            {
+                for( int y = 0; y < ksize; y++ )
+                    for( int x = 0; x < ksize; x++ )
+                        buf[y*ksize + x] = ext.ptr<T>(i + y)[(j + x)*cn + c];
+                std::nth_element(buf.begin(), buf.begin() + buf.size()/2, buf.end());
+                dst.ptr<T>(i)[j*cn + c] = buf[buf.size()/2];
+            }
+}
+
+TEST(Imgproc_MedianBlur, largeKernel)
+{
+    // the constant-time median (8-bit kernels above 15 and 16-bit kernels above 5) against
+    // the brute-force median, with one thread and with the horizontal bands. The images are
+    // wider than one 16-bit stripe, so the column histograms are reused across the stripes
+    const int types[] = { CV_8UC1, CV_8UC3, CV_16UC1, CV_16UC3, CV_16UC4 };
+    const int ksizes[] = { 7, 21, 51 };
+    int nthreads0 = getNumThreads();
+    RNG& rng = theRNG();
+
+    for( size_t t = 0; t < sizeof(types)/sizeof(types[0]); t++ )
+        for( size_t k = 0; k < sizeof(ksizes)/sizeof(ksizes[0]); k++ )
+        {
+            int type = types[t], ksize = ksizes[k];
+            if( (CV_MAT_DEPTH(type) == CV_8U && ksize < 17) || (CV_MAT_CN(type) > 1 && ksize > 21) )
+                continue;
+
+            Mat src(430, 300, type), ref, dst1, dst4;
+            // a narrow range gives many equal values
+            rng.fill(src, RNG::UNIFORM, 0, CV_MAT_DEPTH(type) == CV_8U ? 256 : (k % 2 ? 65536 : 700));
+            if( CV_MAT_DEPTH(type) == CV_8U )
+                refMedianBlur<uchar>(src, ref, ksize);
+            else
+                refMedianBlur<ushort>(src, ref, ksize);
+
+            setNumThreads(1);
+            medianBlur(src, dst1, ksize);
+            setNumThreads(4);
+            medianBlur(src, dst4, ksize);
+            setNumThreads(nthreads0);
+
+            EXPECT_EQ(0, cvtest::norm(ref, dst1, NORM_INF)) << "type=" << type << ", ksize=" << ksize;
+            EXPECT_EQ(0, cvtest::norm(ref, dst4, NORM_INF)) << "type=" << type << ", ksize=" << ksize;
+        }
+}
@@ -1027,6 +1027,7 @@ bool CascadeClassifier::detectSingleScale( const Mat& image, int stripCount, Siz
                                            int stripSize, int yStep, double factor, std::vector<Rect>& candidates,
                                            std::vector<int>& levels, std::vector<double>& weights, bool outputRejectLevels )
 {
+    CV_TRACE_REGION("CascadeClassifier::detectSingleScale");
     if( !featureEvaluator->setImage( image, data.origWinSize ) )
         return false;
 
@@ -1092,6 +1093,7 @@ void CascadeClassifier::detectMultiScale( const Mat& image, std::vector<Rect>& o
                                           int flags, Size minObjectSize, Size maxObjectSize,
                                           bool outputRejectLevels )
 {
+    CV_TRACE_REGION("CascadeClassifier::detectMultiScale");
     const double GROUP_EPS = 0.2;
 
     CV_Assert( scaleFactor > 1 && image.depth() == CV_8U );
@@ -1031,6 +1031,7 @@ static inline int gcd(int a, int b)
 void HOGDescriptor::compute(const Mat& img, std::vector<float>& descriptors,
     Size winStride, Size padding, const std::vector<Point>& locations) const
 {
+    CV_TRACE_REGION("HOGDescriptor::compute");
     if( winStride == Size() )
         winStride = cellSize;
     Size cacheStride(gcd(winStride.width, blockStride.width),
@@ -1089,6 +1090,7 @@ void HOGDescriptor::detect(const Mat& img,
     std::vector<Point>& hits, std::vector<double>& weights, double hitThreshold,
     Size winStride, Size padding, const std::vector<Point>& locations) const
 {
+    CV_TRACE_REGION("HOGDescriptor::detect");
     hits.clear();
     if( svmDetector.empty() )
         return;
@@ -1267,6 +1269,7 @@ void HOGDescriptor::detectMultiScale(
     double hitThreshold, Size winStride, Size padding,
     double scale0, double finalThreshold, bool useMeanshiftGrouping) const
 {
+    CV_TRACE_REGION("HOGDescriptor::detectMultiScale");
     double scale = 1.;
     int levels = 0;
 